@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FileSystemFilter.h"
 #include "Importer.h"
 #include "ByteSwapper.h"
+#include "GenericProperty.h"
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -57,6 +58,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <sstream>
 #include <cctype>
+#include <vector>
+#include <algorithm>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <system_error>
+#   include <thread>
+#endif
 
 using namespace Assimp;
 
@@ -462,26 +471,15 @@ namespace Assimp {
 struct Assimp::BatchData {
     BatchData( IOSystem* pIO, bool validate )
     : pIOSystem( pIO )
-    , pImporter( nullptr )
     , next_id(0xffff)
-    , validate( validate ) {
+    , validate( validate )
+    , numThreads( -1 ) {
         ai_assert( NULL != pIO );
-        
-        pImporter = new Importer();
-        pImporter->SetIOHandler( pIO );
-    }
-
-    ~BatchData() {
-        pImporter->SetIOHandler( NULL ); /* get pointer back into our possession */
-        delete pImporter;
     }
 
     // IO system to be used for all imports
     IOSystem* pIOSystem;
 
-    // Importer used to load all meshes
-    Importer* pImporter;
-
     // List of all imports
     std::list<LoadRequest> requests;
 
@@ -493,10 +491,61 @@ struct Assimp::BatchData {
 
     // Validation enabled state
     bool validate;
+
+    // Thread count for LoadAll(), see AI_CONFIG_GLOB_MULTITHREADING
+    int numThreads;
 };
 
 typedef std::list<LoadRequest>::iterator LoadReqIt;
 
+// ------------------------------------------------------------------------------------------------
+// Loads a single request using an importer of its own, so that requests
+// can be loaded concurrently.
+static void LoadSingleRequest( LoadRequest& req, IOSystem* pIO, bool validate, bool nested )
+{
+    // force validation in debug builds
+    unsigned int pp = req.flags;
+    if ( validate ) {
+        pp |= aiProcess_ValidateDataStructure;
+    }
+
+    Importer importer;
+    importer.SetIOHandler( pIO );
+
+    // setup config properties if necessary
+    ImporterPimpl* pimpl = importer.Pimpl();
+    pimpl->mFloatProperties  = req.map.floats;
+    pimpl->mIntProperties    = req.map.ints;
+    pimpl->mStringProperties = req.map.strings;
+    pimpl->mMatrixProperties = req.map.matrices;
+
+    // a batch running on several threads already keeps the cores busy, so
+    // unless told otherwise, files it loads don't spawn threads of their own
+    if ( nested && !HasGenericProperty( pimpl->mIntProperties, AI_CONFIG_GLOB_MULTITHREADING ) ) {
+        SetGenericProperty( pimpl->mIntProperties, AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    }
+
+    if (!DefaultLogger::isNullLogger())
+    {
+        DefaultLogger::get()->info("%%% BEGIN EXTERNAL FILE %%%");
+        DefaultLogger::get()->info("File: " + req.file);
+    }
+    try {
+        importer.ReadFile( req.file, pp );
+        req.scene = importer.GetOrphanedScene();
+    } catch ( const std::exception& e ) {
+        // ReadFile handles import errors itself, this is i.e. out of memory.
+        // It must not escape a worker thread.
+        DefaultLogger::get()->error( std::string( "BatchLoader: " ) + e.what() );
+        req.scene = NULL;
+    }
+    req.loaded = true;
+
+    DefaultLogger::get()->info("%%% END EXTERNAL FILE %%%");
+
+    importer.SetIOHandler( NULL ); /* get pointer back into our possession */
+}
+
 // ------------------------------------------------------------------------------------------------
 BatchLoader::BatchLoader(IOSystem* pIO, bool validate )
 {
@@ -525,6 +574,16 @@ bool BatchLoader::getValidation() const {
     return m_data->validate;
 }
 
+// ------------------------------------------------------------------------------------------------
+void BatchLoader::setNumThreads( int threads ) {
+    m_data->numThreads = threads;
+}
+
+// ------------------------------------------------------------------------------------------------
+int BatchLoader::getNumThreads() const {
+    return m_data->numThreads;
+}
+
 // ------------------------------------------------------------------------------------------------
 unsigned int BatchLoader::AddLoadRequest(const std::string& file,
     unsigned int steps /*= 0*/, const PropertyMap* map /*= NULL*/)
@@ -572,30 +631,56 @@ aiScene* BatchLoader::GetImport( unsigned int which )
 // ------------------------------------------------------------------------------------------------
 void BatchLoader::LoadAll()
 {
-    // no threaded implementation for the moment
+    std::vector<LoadRequest*> pending;
     for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it) {
-        // force validation in debug builds
-        unsigned int pp = (*it).flags;
-        if ( m_data->validate ) {
-            pp |= aiProcess_ValidateDataStructure;
+        if ( !(*it).loaded ) {
+            pending.push_back( &(*it) );
+        }
+    }
+
+    unsigned int threads = 1;
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if ( m_data->numThreads < 0 ) {
+        threads = std::max( 1u, std::thread::hardware_concurrency() );
+    } else if ( m_data->numThreads > 0 ) {
+        threads = static_cast<unsigned int>( m_data->numThreads );
+    }
+    threads = std::min( threads, static_cast<unsigned int>( pending.size() ) );
+#endif
+
+    if ( threads <= 1 ) {
+        for ( size_t i = 0; i < pending.size(); ++i ) {
+            LoadSingleRequest( *pending[ i ], m_data->pIOSystem, m_data->validate, false );
         }
+        return;
+    }
 
-        // setup config properties if necessary
-        ImporterPimpl* pimpl = m_data->pImporter->Pimpl();
-        pimpl->mFloatProperties  = (*it).map.floats;
-        pimpl->mIntProperties    = (*it).map.ints;
-        pimpl->mStringProperties = (*it).map.strings;
-        pimpl->mMatrixProperties = (*it).map.matrices;
-
-        if (!DefaultLogger::isNullLogger())
-        {
-            DefaultLogger::get()->info("%%% BEGIN EXTERNAL FILE %%%");
-            DefaultLogger::get()->info("File: " + (*it).file);
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    // Requests are handed out in order to whichever thread is free. Each
+    // writes only to its own LoadRequest, so the results are the same as
+    // for a serial load.
+    std::atomic<size_t> next( 0 );
+    IOSystem* io = m_data->pIOSystem;
+    const bool validate = m_data->validate;
+    auto worker = [&]() {
+        for ( size_t i = next++; i < pending.size(); i = next++ ) {
+            LoadSingleRequest( *pending[ i ], io, validate, true );
         }
-        m_data->pImporter->ReadFile((*it).file,pp);
-        (*it).scene = m_data->pImporter->GetOrphanedScene();
-        (*it).loaded = true;
+    };
 
-        DefaultLogger::get()->info("%%% END EXTERNAL FILE %%%");
+    std::vector<std::thread> pool;
+    pool.reserve( threads - 1 );
+    for ( unsigned int t = 1; t < threads; ++t ) {
+        try {
+            pool.push_back( std::thread( worker ) );
+        } catch ( const std::system_error& ) {
+            // out of threads, go on with those we have
+            break;
+        }
+    }
+    worker();
+    for ( size_t t = 0; t < pool.size(); ++t ) {
+        pool[ t ].join();
     }
+#endif
 }
@@ -46,15 +46,34 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseProcess.h"
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/ProgressHandler.hpp>
 #include "Importer.h"
+#include <algorithm>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <condition_variable>
+#   include <exception>
+#   include <mutex>
+#   include <system_error>
+#   include <thread>
+#endif
 
 using namespace Assimp;
 
+// Scenes with fewer vertices than this per thread are processed serially
+static const size_t MinVerticesPerThread = 1 << 14;
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 BaseProcess::BaseProcess()
 : shared()
 , progress()
+, meshThreads( 1 )
+, progressStep( -1 )
+, progressSteps( 0 )
 {
 }
 
@@ -73,6 +92,10 @@ void BaseProcess::ExecuteOnScene( Importer* pImp)
     progress = pImp->GetProgressHandler();
     ai_assert(progress);
 
+    meshThreads = 1;
+    if ( pImp->GetPropertyBool( AI_CONFIG_PP_PARALLEL_MESHES, false ) ) {
+        meshThreads = GetThreadCount( pImp );
+    }
     SetupProperties( pImp );
 
     // catch exceptions thrown inside the PostProcess-Step
@@ -104,3 +127,117 @@ bool BaseProcess::RequireVerboseFormat() const
     return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+unsigned int BaseProcess::GetThreadCount( const Importer* pImp )
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    const int threads = pImp->GetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, -1 );
+    if ( threads < 0 ) {
+        return std::max( 1u, std::thread::hardware_concurrency() );
+    }
+    return std::max( 1, threads );
+#else
+    (void)pImp;
+    return 1;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ForEachMesh( aiScene* pScene, const std::function<void(unsigned int)>& func )
+{
+    const unsigned int numMeshes = pScene->mNumMeshes;
+
+    // Progress within the step, as a fraction of the whole pipeline
+    auto report = [&]( unsigned int done ) {
+        if ( progress && progressStep >= 0 ) {
+            progress->UpdatePostProcess( progressStep * numMeshes + done, progressSteps * numMeshes );
+        }
+    };
+
+    size_t numVertices = 0;
+    for ( unsigned int a = 0; a < numMeshes; ++a ) {
+        numVertices += pScene->mMeshes[ a ]->mNumVertices;
+    }
+    unsigned int threads = std::min( meshThreads, numMeshes );
+    threads = static_cast<unsigned int>( std::min<size_t>( threads, numVertices / MinVerticesPerThread + 1 ) );
+
+    if ( threads <= 1 ) {
+        for ( unsigned int a = 0; a < numMeshes; ++a ) {
+            func( a );
+            report( a + 1 );
+        }
+        return;
+    }
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    // Meshes are handed out in order to whichever thread is free. The calling
+    // thread takes its share as well, and does all of the progress reporting.
+    std::atomic<unsigned int> next( 0 );
+    std::mutex mutex;
+    std::condition_variable changed;
+    unsigned int done = 0, reported = 0, running = 0;
+    std::exception_ptr error;
+
+    auto work = [&]( bool caller ) {
+        for ( unsigned int a = next++; a < numMeshes; a = next++ ) {
+            try {
+                func( a );
+            } catch ( ... ) {
+                std::lock_guard<std::mutex> lock( mutex );
+                if ( !error ) {
+                    error = std::current_exception();
+                }
+                next = numMeshes;
+            }
+            std::unique_lock<std::mutex> lock( mutex );
+            ++done;
+            if ( caller ) {
+                reported = done;
+                lock.unlock();
+                report( reported );
+            } else {
+                changed.notify_one();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve( threads - 1 );
+    for ( unsigned int t = 1; t < threads; ++t ) {
+        std::lock_guard<std::mutex> lock( mutex );
+        try {
+            pool.push_back( std::thread( [&]() {
+                work( false );
+                std::lock_guard<std::mutex> lock( mutex );
+                --running;
+                changed.notify_one();
+            } ) );
+            ++running;
+        } catch ( const std::system_error& ) {
+            // out of threads, go on with those we have
+            break;
+        }
+    }
+
+    work( true );
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( running || reported != done ) {
+        if ( reported != done ) {
+            reported = done;
+            lock.unlock();
+            report( reported );
+            lock.lock();
+        } else {
+            changed.wait( lock );
+        }
+    }
+    lock.unlock();
+
+    for ( size_t t = 0; t < pool.size(); ++t ) {
+        pool[ t ].join();
+    }
+    if ( error ) {
+        std::rethrow_exception( error );
+    }
+#endif
+}
@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_BASEPROCESS_H
 
 #include <map>
+#include <functional>
 #include "GenericProperty.h"
 
 struct aiScene;
@@ -280,11 +281,38 @@ public:
 
 protected:
 
+    // -------------------------------------------------------------------
+    /** Calls func for the index of each mesh in the scene.
+     *  For steps that process each mesh on its own. If meshThreads is
+     *  larger than 1, the meshes are handed out to several threads, so
+     *  func may only touch the mesh it is given. Progress is reported
+     *  per mesh, always from the calling thread. The first exception
+     *  thrown by func is passed on once all threads have stopped.
+     * @param pScene The scene whose meshes to process.
+     * @param func Called once for each mesh index.
+     */
+    void ForEachMesh( aiScene* pScene, const std::function<void(unsigned int)>& func );
+
+    // -------------------------------------------------------------------
+    /** Returns the number of threads #AI_CONFIG_GLOB_MULTITHREADING
+     *  allows, or 1 if Assimp was built without threading support.
+     */
+    static unsigned int GetThreadCount( const Importer* pImp );
+
     /** See the doc of #SharedPostProcessInfo for more details */
     SharedPostProcessInfo* shared;
 
     /** Currently active progress handler */
     ProgressHandler* progress;
+
+    /** Number of threads for ForEachMesh(). Set from
+     *  #AI_CONFIG_PP_PARALLEL_MESHES before SetupProperties() is called. */
+    unsigned int meshThreads;
+
+    /** Position of the step in the post processing pipeline, used to
+     *  report progress within the step. -1 if run on its own. */
+    int progressStep;
+    int progressSteps;
 };
 
 
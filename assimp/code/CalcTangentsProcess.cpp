@@ -49,6 +49,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include "TinyFormatter.h"
 #include "qnan.h"
+#include <algorithm>
 
 using namespace Assimp;
 
@@ -96,12 +97,12 @@ void CalcTangentsProcess::Execute( aiScene* pScene)
 
     DefaultLogger::get()->debug("CalcTangentsProcess begin");
 
-    bool bHas = false;
-    for ( unsigned int a = 0; a < pScene->mNumMeshes; a++ ) {
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
-    }
+    std::vector<char> calculated( pScene->mNumMeshes, 0 );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        calculated[ a ] = ProcessMesh( pScene->mMeshes[a], a );
+    } );
 
-    if ( bHas ) {
+    if ( std::count( calculated.begin(), calculated.end(), 1 ) ) {
         DefaultLogger::get()->info("CalcTangentsProcess finished. Tangents have been calculated");
     } else {
         DefaultLogger::get()->debug("CalcTangentsProcess finished");
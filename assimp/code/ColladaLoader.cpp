@@ -94,6 +94,7 @@ ColladaLoader::ColladaLoader()
 	, mAnims()
 	, noSkeletonMesh( false )
     , ignoreUpDirection(false)
+    , configThreads( -1 )
     , mNodeNameCounter( 0 )
 {}
 
@@ -130,6 +131,7 @@ void ColladaLoader::SetupProperties(const Importer* pImp)
 {
     noSkeletonMesh = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_NO_SKELETON_MESHES,0) != 0;
     ignoreUpDirection = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION,0) != 0;
+    configThreads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -157,7 +159,7 @@ void ColladaLoader::InternReadFile( const std::string& pFile, aiScene* pScene, I
     mAnims.clear();
 
     // parse the input file
-    ColladaParser parser( pIOHandler, pFile);
+    ColladaParser parser( pIOHandler, pFile, configThreads);
 
     if( !parser.mRootNode)
         throw DeadlyImportError( "Collada: File came out empty. Something is wrong here.");
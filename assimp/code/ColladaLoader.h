@@ -248,6 +248,9 @@ protected:
     bool noSkeletonMesh;
     bool ignoreUpDirection;
 
+    /** Thread count for parsing long arrays, see AI_CONFIG_GLOB_MULTITHREADING */
+    int configThreads;
+
     /** Used by FindNameForNode() to generate unique node names */
     unsigned int mNodeNameCounter;
 };
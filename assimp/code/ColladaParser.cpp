@@ -58,14 +58,113 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TinyFormatter.h"
 
 #include <memory>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <system_error>
+#   include <thread>
+#endif
 
 using namespace Assimp;
 using namespace Assimp::Collada;
 using namespace Assimp::Formatter;
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+namespace {
+    // Float arrays from MinParallelSize bytes of text on are split into ranges of
+    // about RangeSize bytes, which are parsed in parallel
+    const size_t RangeSize = 1 << 18;
+    const size_t MinParallelSize = 4 * RangeSize;
+
+    // A range of whitespace separated values in the text of a float array
+    struct ValueRange
+    {
+        const char* mBegin;
+        const char* mEnd;
+        size_t mFirst;      // index of the first value of the range in the array
+        size_t mNumValues;
+
+        ValueRange( const char* pBegin, const char* pEnd)
+            : mBegin( pBegin), mEnd( pEnd), mFirst( 0), mNumValues( 0)
+        {}
+    };
+
+    // The characters SkipSpacesAndLineEnd() skips between values
+    inline bool IsValueSeparator( char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // --------------------------------------------------------------------------------------------
+    template <typename Func>
+    void ParallelFor( unsigned int numThreads, size_t count, const Func& func)
+    {
+        std::atomic<size_t> next( 0);
+        auto worker = [&]() {
+            for( size_t i = next++; i < count; i = next++)
+                func( i);
+        };
+
+        std::vector<std::thread> pool;
+        for( unsigned int t = 1; t < numThreads && t < count; ++t)
+        {
+            try {
+                pool.push_back( std::thread( worker));
+            } catch( const std::system_error&) {
+                // out of threads, go on with those we have
+                break;
+            }
+        }
+        worker();
+        for( size_t t = 0; t < pool.size(); ++t)
+            pool[t].join();
+    }
+
+    // --------------------------------------------------------------------------------------------
+    // Counts the values of a range
+    size_t CountValues( const char* pBegin, const char* pEnd)
+    {
+        size_t count = 0;
+        bool inValue = false;
+        for( const char* c = pBegin; c != pEnd; ++c)
+        {
+            const bool separator = IsValueSeparator( *c);
+            count += !separator && !inValue;
+            inValue = !separator;
+        }
+        return count;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    // Parses the values of a range which belong to the first count values of the array into
+    // pOut. Fails for values fast_atoreal_move() does not consume completely, the serial
+    // parser would split them differently.
+    bool ParseValues( const ValueRange& range, size_t count, ai_real* pOut)
+    {
+        const char* cur = range.mBegin;
+        const size_t last = std::min( range.mFirst + range.mNumValues, count);
+        try {
+            for( size_t i = range.mFirst; i < last; ++i)
+            {
+                while( IsValueSeparator( *cur))
+                    ++cur;
+                cur = fast_atoreal_move<ai_real>( cur, pOut[i]);
+                if( cur != range.mEnd && !IsValueSeparator( *cur))
+                    return false;
+            }
+        } catch( const std::invalid_argument&) {
+            return false;
+        }
+        return true;
+    }
+}
+#endif
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
-ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile)
+ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile, int threads)
     : mFileName( pFile )
     , mReader( NULL )
     , mDataLibrary()
@@ -83,6 +182,7 @@ ColladaParser::ColladaParser( IOSystem* pIOHandler, const std::string& pFile)
     , mUnitSize( 1.0f )
     , mUpDirection( UP_Y )
     , mFormat(FV_1_5_n )    // We assume the newest file format by default
+    , mThreads( threads )
 {
     // validate io-handler instance
     if ( NULL == pIOHandler ) {
@@ -1975,7 +2075,7 @@ void ColladaParser::ReadDataArray()
 
                 SkipSpacesAndLineEnd( &content);
             }
-        } else
+        } else if( !ReadFloatArrayParallel( content, count, data.mValues))
         {
             data.mValues.reserve( count);
 
@@ -1999,6 +2099,69 @@ void ColladaParser::ReadDataArray()
     TestClosing( elmName.c_str());
 }
 
+// ------------------------------------------------------------------------------------------------
+// Parses a long float array on several threads
+bool ColladaParser::ReadFloatArrayParallel( const char* pContent, unsigned int count, std::vector<ai_real>& pValues)
+{
+#ifdef ASSIMP_BUILD_SINGLETHREADED
+    (void)pContent;
+    (void)count;
+    (void)pValues;
+    return false;
+#else
+    unsigned int numThreads = 1;
+    if( mThreads < 0)
+        numThreads = std::max( 1u, std::thread::hardware_concurrency());
+    else if( mThreads > 0)
+        numThreads = static_cast<unsigned int>( mThreads);
+
+    if( numThreads < 2 || count == 0)
+        return false;
+    const size_t length = ::strlen( pContent);
+    if( length < MinParallelSize)
+        return false;
+
+    // cut the text into ranges at value separators
+    std::vector<ValueRange> ranges;
+    const char* const end = pContent + length;
+    for( const char* begin = pContent; begin != end; )
+    {
+        const char* cut = begin + std::min( RangeSize, static_cast<size_t>( end - begin));
+        while( cut != end && !IsValueSeparator( *cut))
+            ++cut;
+        ranges.push_back( ValueRange( begin, cut));
+        begin = cut;
+    }
+
+    // the number of values in front of each range tells where its values go
+    ParallelFor( numThreads, ranges.size(), [&]( size_t i) {
+        ranges[i].mNumValues = CountValues( ranges[i].mBegin, ranges[i].mEnd);
+    });
+    size_t numValues = 0;
+    for( std::vector<ValueRange>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+    {
+        it->mFirst = numValues;
+        numValues += it->mNumValues;
+    }
+    if( numValues < count)
+        return false;
+
+    pValues.resize( count);
+    std::atomic<bool> valid( true);
+    ParallelFor( numThreads, ranges.size(), [&]( size_t i) {
+        if( ranges[i].mFirst < count && !ParseValues( ranges[i], count, &pValues[0]))
+            valid = false;
+    });
+    if( !valid)
+    {
+        DefaultLogger::get()->debug( "Collada: values the parallel parser does not handle, parsing the array serially");
+        pValues.clear();
+        return false;
+    }
+    return true;
+#endif
+}
+
 // ------------------------------------------------------------------------------------------------
 // Reads an accessor and stores it in the global library
 void ColladaParser::ReadAccessor( const std::string& pID)
@@ -65,8 +65,9 @@ namespace Assimp
         friend class ColladaLoader;
 
     protected:
-        /** Constructor from XML file */
-        ColladaParser( IOSystem* pIOHandler, const std::string& pFile);
+        /** Constructor from XML file, long float arrays are parsed on up
+         to the given number of threads, see AI_CONFIG_GLOB_MULTITHREADING */
+        ColladaParser( IOSystem* pIOHandler, const std::string& pFile, int threads = 0);
 
         /** Destructor */
         ~ColladaParser();
@@ -171,6 +172,12 @@ namespace Assimp
          */
         void ReadDataArray();
 
+        /** Parses count floats from the contents of a long float array in parallel into
+         * pValues. Returns false if the array is too short or does not consist of plain
+         * numbers, the caller parses it serially then.
+         */
+        bool ReadFloatArrayParallel( const char* pContent, unsigned int count, std::vector<ai_real>& pValues);
+
         /** Reads an accessor and stores it in the global library under the given ID -
          * accessors use the ID of the parent <source> element
          */
@@ -341,6 +348,9 @@ namespace Assimp
 
         /** Collada file format version */
         Collada::FormatVersion mFormat;
+
+        /** Thread count for parsing long float arrays */
+        int mThreads;
     };
 
     // ------------------------------------------------------------------------------------------------
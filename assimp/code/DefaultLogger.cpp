@@ -59,10 +59,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 
 #ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
 #   include <thread>
 #   include <mutex>
 
 std::mutex loggerMutex;
+std::mutex loggerStreamMutex;
 #endif
 
 namespace Assimp    {
@@ -381,6 +383,11 @@ void DefaultLogger::WriteToStreams(const char *message, ErrorSeverity ErrorSev )
 {
     ai_assert(NULL != message);
 
+    // lastMsg and the streams are shared by all threads logging
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    std::lock_guard<std::mutex> lock(loggerStreamMutex);
+#endif
+
     // Check whether this is a repeated message
     if (! ::strncmp( message,lastMsg, lastLen-1))
     {
@@ -415,10 +422,14 @@ void DefaultLogger::WriteToStreams(const char *message, ErrorSeverity ErrorSev )
 //  Returns thread id, if not supported only a zero will be returned.
 unsigned int DefaultLogger::GetThreadID()
 {
-    // fixme: we can get this value via std::threads
-    // std::this_thread::get_id().hash() returns a (big) size_t, not sure if this is useful in this case.
 #ifdef WIN32
     return (unsigned int)::GetCurrentThreadId();
+#elif !defined ASSIMP_BUILD_SINGLETHREADED
+    // std::thread::id has no portable numeric value, so threads are numbered
+    // in the order they first log. The first one to log is T0.
+    static std::atomic<unsigned int> nextId( 0 );
+    static thread_local unsigned int id = nextId++;
+    return id;
 #else
     return 0; // not supported
 #endif
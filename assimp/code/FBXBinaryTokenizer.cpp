@@ -341,7 +341,7 @@ void ReadData(const char*& sbegin_out, const char*& send_out, const char* input,
 
 
 // ------------------------------------------------------------------------------------------------
-bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor, const char* end, bool const is64bits)
+bool ReadScope(TokenArena& output_tokens, const char* input, const char*& cursor, const char* end, bool const is64bits)
 {
     // the first word contains the offset at which this block ends
 	const uint64_t end_offset = is64bits ? ReadDoubleWord(input, cursor, end) : ReadWord(input, cursor, end);
@@ -371,17 +371,17 @@ bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor,
     const char* sbeg, *send;
     ReadString(sbeg, send, input, cursor, end);
 
-    output_tokens.push_back(new_Token(sbeg, send, TokenType_KEY, Offset(input, cursor) ));
+    output_tokens.emplace_back(sbeg, send, TokenType_KEY, Offset(input, cursor) );
 
     // now come the individual properties
     const char* begin_cursor = cursor;
     for (unsigned int i = 0; i < prop_count; ++i) {
         ReadData(sbeg, send, input, cursor, begin_cursor + prop_length);
 
-        output_tokens.push_back(new_Token(sbeg, send, TokenType_DATA, Offset(input, cursor) ));
+        output_tokens.emplace_back(sbeg, send, TokenType_DATA, Offset(input, cursor) );
 
         if(i != prop_count-1) {
-            output_tokens.push_back(new_Token(cursor, cursor + 1, TokenType_COMMA, Offset(input, cursor) ));
+            output_tokens.emplace_back(cursor, cursor + 1, TokenType_COMMA, Offset(input, cursor) );
         }
     }
 
@@ -399,13 +399,13 @@ bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor,
             TokenizeError("insufficient padding bytes at block end",input, cursor);
         }
 
-        output_tokens.push_back(new_Token(cursor, cursor + 1, TokenType_OPEN_BRACKET, Offset(input, cursor) ));
+        output_tokens.emplace_back(cursor, cursor + 1, TokenType_OPEN_BRACKET, Offset(input, cursor) );
 
         // XXX this is vulnerable to stack overflowing ..
         while(Offset(input, cursor) < end_offset - sentinel_block_length) {
 			ReadScope(output_tokens, input, cursor, input + end_offset - sentinel_block_length, is64bits);
         }
-        output_tokens.push_back(new_Token(cursor, cursor + 1, TokenType_CLOSE_BRACKET, Offset(input, cursor) ));
+        output_tokens.emplace_back(cursor, cursor + 1, TokenType_CLOSE_BRACKET, Offset(input, cursor) );
 
         for (unsigned int i = 0; i < sentinel_block_length; ++i) {
             if(cursor[i] != '\0') {
@@ -426,7 +426,7 @@ bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor,
 
 // ------------------------------------------------------------------------------------------------
 // TODO: Test FBX Binary files newer than the 7500 version to check if the 64 bits address behaviour is consistent
-void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length)
+void TokenizeBinary(TokenArena& output_tokens, const char* input, unsigned int length)
 {
     ai_assert(input);
 
@@ -64,6 +64,7 @@ struct ImportSettings
         , preservePivots(true)
         , optimizeEmptyAnimationCurves(true)
 		, searchEmbeddedTextures(false)
+        , threads(-1)
     {}
 
 
@@ -142,6 +143,10 @@ struct ImportSettings
 	/** search for embedded loaded textures, where no embedded texture data is provided.
 	*  The default value is false. */
 	bool searchEmbeddedTextures;
+
+    /** number of threads to inflate compressed geometry arrays with,
+     *  see #AI_CONFIG_GLOB_MULTITHREADING. The default value is -1. */
+    int threads;
 };
 
 
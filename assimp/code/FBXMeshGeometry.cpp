@@ -95,6 +95,9 @@ MeshGeometry::MeshGeometry(uint64_t id, const Element& element, const std::strin
         DOMError("failed to read Geometry object (class: Mesh), no data scope found");
     }
 
+    // all arrays below are read right away, inflate them all at once
+    BinaryArrayPrefetch prefetch(element, doc.Settings().threads);
+
     // must have Mesh elements:
     const Element& Vertices = GetRequiredElement(*sc,"Vertices",&element);
     const Element& PolygonVertexIndex = GetRequiredElement(*sc,"PolygonVertexIndex",&element);
@@ -61,6 +61,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ByteSwapper.h"
 
 #include <iostream>
+#include <algorithm>
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <system_error>
+#   include <thread>
+#endif
 
 using namespace Assimp;
 using namespace Assimp::FBX;
@@ -215,7 +222,7 @@ Scope::~Scope()
 
 
 // ------------------------------------------------------------------------------------------------
-Parser::Parser (const TokenList& tokens, bool is_binary)
+Parser::Parser (const TokenArena& tokens, bool is_binary)
 : tokens(tokens)
 , last()
 , current()
@@ -238,7 +245,7 @@ TokenPtr Parser::AdvanceToNextToken()
     if (cursor == tokens.end()) {
         current = NULL;
     } else {
-        current = *cursor++;
+        current = &*cursor++;
     }
     return current;
 }
@@ -516,11 +523,63 @@ void ReadBinaryDataArrayHead(const char*& data, const char* end, char& type, uin
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// size of a single element of a binary data array, or 0 for unsupported types
+uint32_t BinaryDataArrayStride(char type)
+{
+    switch(type)
+    {
+    case 'f':
+    case 'i':
+        return 4;
+
+    case 'd':
+    case 'l':
+        return 8;
+
+    default:
+        return 0;
+    };
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// inflate zlib compressed data into buff, which must have the size of the uncompressed data
+bool InflateBinaryDataArray(const char* data, uint32_t comp_len, std::vector<char>& buff)
+{
+    // zlib/deflate, next comes ZIP head (0x78 0x01)
+    // see http://www.ietf.org/rfc/rfc1950.txt
+
+    z_stream zstream;
+    zstream.opaque = Z_NULL;
+    zstream.zalloc = Z_NULL;
+    zstream.zfree  = Z_NULL;
+    zstream.data_type = Z_BINARY;
+
+    // http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
+    if(Z_OK != inflateInit(&zstream)) {
+        return false;
+    }
+
+    zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
+    zstream.avail_in  = comp_len;
+
+    zstream.avail_out = static_cast<uInt>(buff.size());
+    zstream.next_out = reinterpret_cast<Bytef*>(buff.data());
+    const int ret = inflate(&zstream, Z_FINISH);
+
+    // terminate zlib
+    inflateEnd(&zstream);
+
+    return ret == Z_STREAM_END || ret == Z_OK;
+}
+
+
 // ------------------------------------------------------------------------------------------------
 // read binary data array, assume cursor points to the 'compression mode' field (i.e. behind the header)
 void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const char* end,
     std::vector<char>& buff,
-    const Element& /*el*/)
+    const Element& el)
 {
     BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data, end);
     AI_SWAP4(encmode);
@@ -534,22 +593,8 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     ai_assert(data + comp_len == end);
 
     // determine the length of the uncompressed data by looking at the type signature
-    uint32_t stride = 0;
-    switch(type)
-    {
-    case 'f':
-    case 'i':
-        stride = 4;
-        break;
-
-    case 'd':
-    case 'l':
-        stride = 8;
-        break;
-
-    default:
-        ai_assert(false);
-    };
+    const uint32_t stride = BinaryDataArrayStride(type);
+    ai_assert(stride);
 
     const uint32_t full_length = stride * count;
     buff.resize(full_length);
@@ -561,33 +606,11 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
         std::copy(data, end, buff.begin());
     }
     else if(encmode == 1) {
-        // zlib/deflate, next comes ZIP head (0x78 0x01)
-        // see http://www.ietf.org/rfc/rfc1950.txt
-
-        z_stream zstream;
-        zstream.opaque = Z_NULL;
-        zstream.zalloc = Z_NULL;
-        zstream.zfree  = Z_NULL;
-        zstream.data_type = Z_BINARY;
-
-        // http://hewgill.com/journal/entries/349-how-to-decompress-gzip-stream-with-zlib
-        if(Z_OK != inflateInit(&zstream)) {
-            ParseError("failure initializing zlib");
-        }
-
-        zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(data) );
-        zstream.avail_in  = comp_len;
-
-        zstream.avail_out = static_cast<uInt>(buff.size());
-        zstream.next_out = reinterpret_cast<Bytef*>(&*buff.begin());
-        const int ret = inflate(&zstream, Z_FINISH);
-
-        if (ret != Z_STREAM_END && ret != Z_OK) {
+        // a BinaryArrayPrefetch may have done the work already
+        if (!BinaryArrayPrefetch::Take(*el.Tokens()[0], buff) &&
+            !InflateBinaryDataArray(data, comp_len, buff)) {
             ParseError("failure decompressing compressed data section");
         }
-
-        // terminate zlib
-        inflateEnd(&zstream);
     }
 #ifdef ASSIMP_BUILD_DEBUG
     else {
@@ -600,9 +623,160 @@ void ReadBinaryDataArray(char type, uint32_t count, const char*& data, const cha
     ai_assert(data == end);
 }
 
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+// innermost BinaryArrayPrefetch alive on this thread
+thread_local BinaryArrayPrefetch* activePrefetch = NULL;
+
+// below this many compressed bytes, inflating on one thread is quicker
+const size_t MinPrefetchBytes = 1 << 18;
+#endif
+
+
+// ------------------------------------------------------------------------------------------------
+// find the zlib compressed arrays below an element
+void CollectCompressedArrays(const Element& el, std::vector<const Token*>& out, size_t& total)
+{
+    const TokenList& tok = el.Tokens();
+    if (!tok.empty() && tok[0]->IsBinary()) {
+        const char* data = tok[0]->begin(), *end = tok[0]->end();
+
+        // type, count, encoding and compressed length take 13 bytes
+        if (static_cast<size_t>(end - data) >= 13 && BinaryDataArrayStride(*data)) {
+            BE_NCONST uint32_t encmode = SafeParse<uint32_t>(data + 5, end);
+            AI_SWAP4(encmode);
+            if (encmode == 1) {
+                out.push_back(tok[0]);
+                total += static_cast<size_t>(end - data);
+            }
+        }
+    }
+
+    if (const Scope* sc = el.Compound()) {
+        for (const ElementMap::value_type& v : sc->Elements()) {
+            CollectCompressedArrays(*v.second, out, total);
+        }
+    }
+}
+
 } // !anon
 
 
+// ------------------------------------------------------------------------------------------------
+BinaryArrayPrefetch::BinaryArrayPrefetch(const Element& element, int threads)
+: previous()
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    previous = activePrefetch;
+    activePrefetch = this;
+
+    unsigned int numThreads = 1;
+    if (threads < 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    } else if (threads > 0) {
+        numThreads = static_cast<unsigned int>(threads);
+    }
+
+    std::vector<const Token*> tokens;
+    size_t total = 0;
+    CollectCompressedArrays(element, tokens, total);
+    numThreads = std::min(numThreads, static_cast<unsigned int>(tokens.size()));
+    if (numThreads <= 1 || total < MinPrefetchBytes) {
+        return;
+    }
+
+    // largest arrays first, so that no thread is left with a big one at the end
+    std::sort(tokens.begin(), tokens.end(), [](const Token* a, const Token* b) {
+        return a->end() - a->begin() > b->end() - b->begin();
+    });
+
+    std::vector<std::vector<char>*> buffers(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        buffers[i] = &arrays[tokens[i]];
+    }
+
+    // Failures are left to ReadBinaryDataArray(), which reports them with
+    // the element they happened in.
+    std::vector<char> failed(tokens.size(), 0);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < tokens.size(); i = next++) {
+            const char* data = tokens[i]->begin(), *end = tokens[i]->end();
+
+            BE_NCONST uint32_t count = SafeParse<uint32_t>(data + 1, end);
+            AI_SWAP4(count);
+            BE_NCONST uint32_t comp_len = SafeParse<uint32_t>(data + 9, end);
+            AI_SWAP4(comp_len);
+
+            try {
+                buffers[i]->resize(static_cast<size_t>(BinaryDataArrayStride(*data)) * count);
+                failed[i] = !InflateBinaryDataArray(data + 13, comp_len, *buffers[i]);
+            } catch (...) {
+                failed[i] = 1;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(numThreads - 1);
+    for (unsigned int t = 1; t < numThreads; ++t) {
+        try {
+            pool.push_back(std::thread(worker));
+        } catch (const std::system_error&) {
+            // out of threads, go on with those we have
+            break;
+        }
+    }
+    worker();
+    for (size_t t = 0; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (failed[i]) {
+            arrays.erase(tokens[i]);
+        }
+    }
+#else
+    (void)element;
+    (void)threads;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+BinaryArrayPrefetch::~BinaryArrayPrefetch()
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    ai_assert(activePrefetch == this);
+    activePrefetch = previous;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+bool BinaryArrayPrefetch::Take(const Token& token, std::vector<char>& buff)
+{
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    if (!activePrefetch) {
+        return false;
+    }
+
+    ArrayMap& arrays = activePrefetch->arrays;
+    ArrayMap::iterator it = arrays.find(&token);
+    if (it == arrays.end() || it->second.size() != buff.size()) {
+        return false;
+    }
+    buff.swap(it->second);
+    arrays.erase(it);
+    return true;
+#else
+    (void)token;
+    (void)buff;
+    return false;
+#endif
+}
+
+
+
 // ------------------------------------------------------------------------------------------------
 // read an array of float3 tuples
 void ParseVectorDataArray(std::vector<aiVector3D>& out, const Element& el)
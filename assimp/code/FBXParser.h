@@ -153,12 +153,12 @@ private:
 
 /** FBX parsing class, takes a list of input tokens and generates a hierarchy
  *  of nested #Scope instances, representing the fbx DOM.*/
-class Parser
+class ASSIMP_API Parser
 {
 public:
     /** Parse given a token list. Does not take ownership of the tokens -
      *  the objects must persist during the entire parser lifetime */
-    Parser (const TokenList& tokens,bool is_binary);
+    Parser (const TokenArena& tokens,bool is_binary);
     ~Parser();
 
     const Scope& GetRootScope() const {
@@ -180,16 +180,44 @@ private:
 
 
 private:
-    const TokenList& tokens;
+    const TokenArena& tokens;
 
     TokenPtr last, current;
-    TokenList::const_iterator cursor;
+    TokenArena::const_iterator cursor;
     std::unique_ptr<Scope> root;
 
     const bool is_binary;
 };
 
 
+/** Inflates the zlib compressed binary arrays below an element on several
+ *  threads at once, for objects that read many large arrays in a row.
+ *
+ *  While an instance is alive, ParseVectorDataArray() calls on the same
+ *  thread take the inflated data from it instead of inflating it again.
+ *  Each array is handed out once and then freed. Instances may nest; the
+ *  innermost one is used. Small or text files are left alone. */
+class BinaryArrayPrefetch
+{
+public:
+    /** @param threads Number of threads, see #AI_CONFIG_GLOB_MULTITHREADING */
+    BinaryArrayPrefetch(const Element& element, int threads);
+    ~BinaryArrayPrefetch();
+
+    /** Moves the inflated data of a binary array token into buff, if the
+     *  active prefetch holds it and buff already has the right size. */
+    static bool Take(const Token& token, std::vector<char>& buff);
+
+private:
+    BinaryArrayPrefetch(const BinaryArrayPrefetch&) = delete;
+    BinaryArrayPrefetch& operator = (const BinaryArrayPrefetch&) = delete;
+
+    typedef std::map<const Token*, std::vector<char> > ArrayMap;
+    ArrayMap arrays;
+    BinaryArrayPrefetch* previous;
+};
+
+
 /* token parsing - this happens when building the DOM out of the parse-tree*/
 uint64_t ParseTokenAsID(const Token& t, const char*& err_out);
 size_t ParseTokenAsDim(const Token& t, const char*& err_out);
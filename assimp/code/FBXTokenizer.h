@@ -47,6 +47,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FBXCompileConfig.h"
 #include <assimp/ai_assert.h>
+#include <assimp/defs.h>
+#include <deque>
 #include <vector>
 #include <string>
 
@@ -82,7 +84,7 @@ enum TokenType
  *  classified by the #TokenType enumerated types.
  *
  *  Offers iterator protocol. Tokens are immutable. */
-class Token
+class ASSIMP_API Token
 {
 private:
     static const unsigned int BINARY_MARKER = static_cast<unsigned int>(-1);
@@ -94,8 +96,6 @@ public:
     /** construct a binary token */
     Token(const char* sbegin, const char* send, TokenType type, unsigned int offset);
 
-    ~Token();
-
 public:
     std::string StringContents() const {
         return std::string(begin(),end());
@@ -152,11 +152,13 @@ private:
     const unsigned int column;
 };
 
-// XXX should use C++11's unique_ptr - but assimp's need to keep working with 03
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
+/** All tokens of a file, held by value in blocks. Tokens only point
+ *  into the input buffer, so the arena is all the tokenizer allocates.
+ *  Appending never moves a token, TokenPtrs stay valid with the arena. */
+typedef std::deque< Token > TokenArena;
 
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
@@ -166,7 +168,7 @@ typedef std::vector< TokenPtr > TokenList;
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+ASSIMP_API void Tokenize(TokenArena& output_tokens, const char* input);
 
 
 /** Tokenizer function for binary FBX files.
@@ -177,7 +179,7 @@ void Tokenize(TokenList& output_tokens, const char* input);
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, unsigned int length);
+ASSIMP_API void TokenizeBinary(TokenArena& output_tokens, const char* input, unsigned int length);
 
 
 } // ! FBX
@@ -85,9 +85,9 @@ void FindDegeneratesProcess::SetupProperties(const Importer* pImp) {
 // Executes the post processing step on the given imported data.
 void FindDegeneratesProcess::Execute( aiScene* pScene) {
     DefaultLogger::get()->debug("FindDegeneratesProcess begin");
-    for (unsigned int i = 0; i < pScene->mNumMeshes;++i){
+    ForEachMesh( pScene, [&]( unsigned int i ) {
         ExecuteOnMesh( pScene->mMeshes[ i ] );
-    }
+    } );
     DefaultLogger::get()->debug("FindDegeneratesProcess finished");
 }
 
@@ -47,10 +47,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FindInstancesProcess.h"
 #include <memory>
+#include <unordered_map>
 #include <stdio.h>
 
 using namespace Assimp;
 
+// Ends a chain of meshes with the same hash
+static const unsigned int NoMesh = 0xffffffff;
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 FindInstancesProcess::FindInstancesProcess()
@@ -77,6 +81,9 @@ void FindInstancesProcess::SetupProperties(const Importer* pImp)
 {
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // hashing only reads the meshes, #AI_CONFIG_PP_PARALLEL_MESHES or not
+    meshThreads = GetThreadCount( pImp );
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -114,6 +121,93 @@ void UpdateMeshIndices(aiNode* node, unsigned int* lookup)
         UpdateMeshIndices(node->mChildren[n],lookup);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Compare two meshes with the same content hash in full
+bool FindInstancesProcess::IsInstance(const aiMesh* orig, const aiMesh* inst) const
+{
+    // check for hash collision .. we needn't check
+    // the vertex format, it *must* match due to the
+    // (brilliant) construction of the hash
+    if (orig->mNumBones       != inst->mNumBones      ||
+        orig->mNumFaces       != inst->mNumFaces      ||
+        orig->mNumVertices    != inst->mNumVertices   ||
+        orig->mMaterialIndex  != inst->mMaterialIndex ||
+        orig->mPrimitiveTypes != inst->mPrimitiveTypes)
+        return false;
+
+    // up to now the meshes are equal. find an appropriate
+    // epsilon to compare position differences against
+    float epsilon = ComputePositionEpsilon(inst);
+    epsilon *= epsilon;
+
+    // now compare vertex positions, normals,
+    // tangents and bitangents using this epsilon.
+    if (orig->HasPositions()) {
+        if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
+            return false;
+    }
+    if (orig->HasNormals()) {
+        if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
+            return false;
+    }
+    if (orig->HasTangentsAndBitangents()) {
+        if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
+            !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
+            return false;
+    }
+
+    // use a constant epsilon for colors and UV coordinates
+    static const float uvEpsilon = 10e-4f;
+    for (unsigned int i = 0, end = orig->GetNumUVChannels(); i < end; ++i) {
+        if (!orig->mTextureCoords[i]) {
+            continue;
+        }
+        if(!CompareArrays(orig->mTextureCoords[i],inst->mTextureCoords[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+    for (unsigned int i = 0, end = orig->GetNumColorChannels(); i < end; ++i) {
+        if (!orig->mColors[i]) {
+            continue;
+        }
+        if(!CompareArrays(orig->mColors[i],inst->mColors[i],orig->mNumVertices,uvEpsilon)) {
+            return false;
+        }
+    }
+
+    // These two checks are actually quite expensive and almost *never* required.
+    // Almost. That's why they're still here. But there's no reason to do them
+    // in speed-targeted imports.
+    if (!configSpeedFlag) {
+
+        // It seems to be strange, but we really need to check whether the
+        // bones are identical too. Although it's extremely unprobable
+        // that they're not if control reaches here, we need to deal
+        // with unprobable cases, too. It could still be that there are
+        // equal shapes which are deformed differently.
+        if (!CompareBones(orig,inst))
+            return false;
+
+        // For completeness ... compare even the index buffers for equality
+        // face order & winding order doesn't care. Input data is in verbose format.
+        std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]());
+        std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]());
+
+        for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
+            aiFace& f = orig->mFaces[tt];
+            for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
+                ftbl_orig[f.mIndices[nn]] = tt;
+
+            aiFace& f2 = inst->mFaces[tt];
+            for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
+                ftbl_inst[f2.mIndices[nn]] = tt;
+        }
+        if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
+            return false;
+    }
+    return true;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void FindInstancesProcess::Execute( aiScene* pScene)
@@ -121,135 +215,54 @@ void FindInstancesProcess::Execute( aiScene* pScene)
     DefaultLogger::get()->debug("FindInstancesProcess begin");
     if (pScene->mNumMeshes) {
 
-        // use a pseudo hash for all meshes in the scene to quickly find
+        // hash the contents of all meshes in the scene to quickly find
         // the ones which are possibly equal. This step is executed early
         // in the pipeline, so we could, depending on the file format,
         // have several thousand small meshes. That's too much for a brute
-        // everyone-against-everyone check involving up to 10 comparisons
-        // each.
+        // everyone-against-everyone check, so only meshes with the same
+        // hash are compared in full.
         std::unique_ptr<uint64_t[]> hashes (new uint64_t[pScene->mNumMeshes]);
         std::unique_ptr<unsigned int[]> remapping (new unsigned int[pScene->mNumMeshes]);
 
+        // the meshes are only read here, so they can be hashed in parallel
+        ForEachMesh( pScene, [&]( unsigned int i ) {
+            hashes[i] = GetMeshContentHash(pScene->mMeshes[i], !configSpeedFlag);
+        } );
+
+        // kept meshes by hash. Meshes with the same hash are chained, the
+        // latest one first, through 'collisions'.
+        std::unordered_map<uint64_t, unsigned int> latest;
+        latest.reserve(pScene->mNumMeshes);
+        std::unique_ptr<unsigned int[]> collisions (new unsigned int[pScene->mNumMeshes]);
+
         unsigned int numMeshesOut = 0;
         for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
 
             aiMesh* inst = pScene->mMeshes[i];
-            hashes[i] = GetMeshHash(inst);
-
-            for (int a = i-1; a >= 0; --a) {
-                if (hashes[i] == hashes[a])
-                {
-                    aiMesh* orig = pScene->mMeshes[a];
-                    if (!orig)
-                        continue;
-
-                    // check for hash collision .. we needn't check
-                    // the vertex format, it *must* match due to the
-                    // (brilliant) construction of the hash
-                    if (orig->mNumBones       != inst->mNumBones      ||
-                        orig->mNumFaces       != inst->mNumFaces      ||
-                        orig->mNumVertices    != inst->mNumVertices   ||
-                        orig->mMaterialIndex  != inst->mMaterialIndex ||
-                        orig->mPrimitiveTypes != inst->mPrimitiveTypes)
-                        continue;
-
-                    // up to now the meshes are equal. find an appropriate
-                    // epsilon to compare position differences against
-                    float epsilon = ComputePositionEpsilon(inst);
-                    epsilon *= epsilon;
-
-                    // now compare vertex positions, normals,
-                    // tangents and bitangents using this epsilon.
-                    if (orig->HasPositions()) {
-                        if(!CompareArrays(orig->mVertices,inst->mVertices,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasNormals()) {
-                        if(!CompareArrays(orig->mNormals,inst->mNormals,orig->mNumVertices,epsilon))
-                            continue;
-                    }
-                    if (orig->HasTangentsAndBitangents()) {
-                        if (!CompareArrays(orig->mTangents,inst->mTangents,orig->mNumVertices,epsilon) ||
-                            !CompareArrays(orig->mBitangents,inst->mBitangents,orig->mNumVertices,epsilon))
-                            continue;
-                    }
+            std::pair<std::unordered_map<uint64_t, unsigned int>::iterator, bool> slot =
+                latest.insert(std::make_pair(hashes[i], i));
 
-                    // use a constant epsilon for colors and UV coordinates
-                    static const float uvEpsilon = 10e-4f;
-                    {
-                        unsigned int i, end = orig->GetNumUVChannels();
-                        for(i = 0; i < end; ++i) {
-                            if (!orig->mTextureCoords[i]) {
-                                continue;
-                            }
-                            if(!CompareArrays(orig->mTextureCoords[i],inst->mTextureCoords[i],orig->mNumVertices,uvEpsilon)) {
-                                break;
-                            }
-                        }
-                        if (i != end) {
-                            continue;
-                        }
-                    }
-                    {
-                        unsigned int i, end = orig->GetNumColorChannels();
-                        for(i = 0; i < end; ++i) {
-                            if (!orig->mColors[i]) {
-                                continue;
-                            }
-                            if(!CompareArrays(orig->mColors[i],inst->mColors[i],orig->mNumVertices,uvEpsilon)) {
-                                break;
-                            }
-                        }
-                        if (i != end) {
-                            continue;
-                        }
-                    }
+            if (!slot.second) {
+                for (unsigned int a = slot.first->second; a != NoMesh; a = collisions[a]) {
+                    if (IsInstance(pScene->mMeshes[a], inst)) {
 
-                    // These two checks are actually quite expensive and almost *never* required.
-                    // Almost. That's why they're still here. But there's no reason to do them
-                    // in speed-targeted imports.
-                    if (!configSpeedFlag) {
-
-                        // It seems to be strange, but we really need to check whether the
-                        // bones are identical too. Although it's extremely unprobable
-                        // that they're not if control reaches here, we need to deal
-                        // with unprobable cases, too. It could still be that there are
-                        // equal shapes which are deformed differently.
-                        if (!CompareBones(orig,inst))
-                            continue;
-
-                        // For completeness ... compare even the index buffers for equality
-                        // face order & winding order doesn't care. Input data is in verbose format.
-                        std::unique_ptr<unsigned int[]> ftbl_orig(new unsigned int[orig->mNumVertices]);
-                        std::unique_ptr<unsigned int[]> ftbl_inst(new unsigned int[orig->mNumVertices]);
-
-                        for (unsigned int tt = 0; tt < orig->mNumFaces;++tt) {
-                            aiFace& f = orig->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f.mNumIndices;++nn)
-                                ftbl_orig[f.mIndices[nn]] = tt;
-
-                            aiFace& f2 = inst->mFaces[tt];
-                            for (unsigned int nn = 0; nn < f2.mNumIndices;++nn)
-                                ftbl_inst[f2.mIndices[nn]] = tt;
-                        }
-                        if (0 != ::memcmp(ftbl_inst.get(),ftbl_orig.get(),orig->mNumVertices*sizeof(unsigned int)))
-                            continue;
-                    }
+                        // 'inst' is an instance of 'orig'. Place a marker in our
+                        // list that we can easily update mesh indices.
+                        remapping[i] = remapping[a];
 
-                    // We're still here. Or in other words: 'inst' is an instance of 'orig'.
-                    // Place a marker in our list that we can easily update mesh indices.
-                    remapping[i] = remapping[a];
-
-                    // Delete the instanced mesh, we don't need it anymore
-                    delete inst;
-                    pScene->mMeshes[i] = NULL;
-                    break;
+                        // Delete the instanced mesh, we don't need it anymore
+                        delete inst;
+                        pScene->mMeshes[i] = NULL;
+                        break;
+                    }
                 }
             }
 
             // If we didn't find a match for the current mesh: keep it
             if (pScene->mMeshes[i]) {
                 remapping[i] = numMeshesOut++;
+                collisions[i] = slot.second ? NoMesh : slot.first->second;
+                slot.first->second = i;
             }
         }
         ai_assert(0 != numMeshesOut);
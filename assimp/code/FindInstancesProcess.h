@@ -73,6 +73,59 @@ inline uint64_t GetMeshHash(aiMesh* in)
         (in->mPrimitiveTypes<<28)) & 0xffffffff );
 }
 
+// -------------------------------------------------------------------------------
+/** @brief Get a hash of the contents of a mesh.
+ *
+ *  Starts from GetMeshHash() and adds all vertex components and, if requested,
+ *  the vertex indices of each face. The order of the indices within a face
+ *  does not change the hash. Meshes with bitwise identical data get the same
+ *  hash; meshes which are only equal within some epsilon usually do not.
+ *  @param in Input mesh
+ *  @param faces Whether to include the faces
+ *  @return Hash.
+ */
+inline uint64_t GetMeshContentHash(const aiMesh* in, bool faces)
+{
+    ai_assert(NULL != in);
+
+    uint64_t h = GetMeshHash(const_cast<aiMesh*>(in));
+    for (unsigned int i = 0; i < in->mNumVertices; ++i) {
+        if (in->HasPositions()) {
+            h = HashVector(h, in->mVertices[i]);
+        }
+        if (in->HasNormals()) {
+            h = HashVector(h, in->mNormals[i]);
+        }
+        if (in->HasTangentsAndBitangents()) {
+            h = HashVector(h, in->mTangents[i]);
+            h = HashVector(h, in->mBitangents[i]);
+        }
+        for (unsigned int c = 0; in->HasTextureCoords(c); ++c) {
+            h = HashVector(h, in->mTextureCoords[c][i]);
+        }
+        for (unsigned int c = 0; in->HasVertexColors(c); ++c) {
+            const aiColor4D& col = in->mColors[c][i];
+            h = HashCombine(h, ComponentBits(col.r));
+            h = HashCombine(h, ComponentBits(col.g));
+            h = HashCombine(h, ComponentBits(col.b));
+            h = HashCombine(h, ComponentBits(col.a));
+        }
+    }
+    if (faces) {
+        for (unsigned int i = 0; i < in->mNumFaces; ++i) {
+            // sum and xor of the indices don't depend on the winding
+            const aiFace& f = in->mFaces[i];
+            uint64_t sum = 0, bits = 0;
+            for (unsigned int n = 0; n < f.mNumIndices; ++n) {
+                sum += f.mIndices[n];
+                bits ^= f.mIndices[n];
+            }
+            h = HashCombine(h, (sum << 32) ^ (bits << 8) ^ f.mNumIndices);
+        }
+    }
+    return h;
+}
+
 // -------------------------------------------------------------------------------
 /** @brief Perform a component-wise comparison of two arrays
  *
@@ -106,7 +159,7 @@ inline bool CompareArrays(const aiColor4D* first, const aiColor4D* second,
 // ---------------------------------------------------------------------------
 /** @brief A post-processing steps to search for instanced meshes
 */
-class FindInstancesProcess : public BaseProcess
+class ASSIMP_API FindInstancesProcess : public BaseProcess
 {
 public:
 
@@ -128,6 +181,10 @@ public:
 
 private:
 
+    // -------------------------------------------------------------------
+    // Compare two meshes with the same content hash in full
+    bool IsInstance(const aiMesh* orig, const aiMesh* inst) const;
+
     bool configSpeedFlag;
 
 }; // ! end class FindInstancesProcess
@@ -124,10 +124,15 @@ void FindInvalidDataProcess::Execute( aiScene* pScene)
     unsigned int real = 0;
 
     // Process meshes
+    std::vector<int> results( pScene->mNumMeshes, 0 );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        results[ a ] = ProcessMesh( pScene->mMeshes[a]);
+    } );
+
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)   {
 
         int result;
-        if ((result = ProcessMesh( pScene->mMeshes[a])))    {
+        if ((result = results[ a ]))    {
             out = true;
 
             if (2 == result)    {
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include "Exceptional.h"
 #include "qnan.h"
+#include <algorithm>
 
 using namespace Assimp;
 
@@ -92,14 +93,12 @@ void GenVertexNormalsProcess::Execute( aiScene* pScene)
     if (pScene->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT)
         throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
 
-    bool bHas = false;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-    {
-        if(GenMeshVertexNormals( pScene->mMeshes[a],a))
-            bHas = true;
-    }
+    std::vector<char> generated( pScene->mNumMeshes, 0 );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        generated[ a ] = GenMeshVertexNormals( pScene->mMeshes[a], a );
+    } );
 
-    if (bHas)   {
+    if (std::count( generated.begin(), generated.end(), 1 ))   {
         DefaultLogger::get()->info("GenVertexNormalsProcess finished. "
             "Vertex normals have been calculated");
     }
@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/IOStream.hpp>
 #include "ParsingUtils.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace Assimp {
@@ -110,6 +111,11 @@ public:
     /// @return true if successful.
     bool getNextBlock( std::vector<T> &buffer );
 
+    /// @brief  Will continue reading at the given file pos, the cached data is dropped.
+    /// @param  pos         The new file pos.
+    /// @return true if successful.
+    bool seek( size_t pos );
+
 private:
     IOStream *m_stream;
     size_t m_filesize;
@@ -335,16 +341,33 @@ inline
 bool IOStreamBuffer<T>::getNextBlock( std::vector<T> &buffer) {
   //just return the last blockvalue if getNextLine was used before
   if ( m_cachePos !=  0) {      
-      buffer = std::vector<T>(m_cache.begin() + m_cachePos, m_cache.end());
+      buffer = std::vector<T>(m_cache.begin() + m_cachePos, m_cache.begin() + m_cacheSize);
       m_cachePos = 0;
   }
   else {
       if ( !readNextBlock() )
           return false;
 
-      buffer = std::vector<T>(m_cache.begin(), m_cache.end());
+      // the last block may be shorter than the cache
+      buffer = std::vector<T>(m_cache.begin(), m_cache.begin() + m_cacheSize);
   }
   return true;
 }
 
+template<class T>
+inline
+bool IOStreamBuffer<T>::seek( size_t pos ) {
+    if ( nullptr == m_stream || pos > m_filesize ) {
+        return false;
+    }
+
+    // readNextBlock() may have shrunk the cache for the last block
+    m_cacheSize = std::min( m_cache.size(), m_filesize );
+    m_blockIdx  = pos / m_cacheSize;
+    m_cachePos  = m_cacheSize;
+    m_filePos   = pos;
+
+    return true;
+}
+
 } // !ns Assimp
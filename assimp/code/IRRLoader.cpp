@@ -89,7 +89,8 @@ static const aiImporterDesc desc = {
 // Constructor to be privately used by Importer
 IRRImporter::IRRImporter()
     : fps(),
-    configSpeedFlag()
+    configSpeedFlag(),
+    configThreads(-1)
 {}
 
 // ------------------------------------------------------------------------------------------------
@@ -140,6 +141,9 @@ void IRRImporter::SetupProperties(const Importer* pImp)
 
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    configThreads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -933,6 +937,7 @@ void IRRImporter::InternReadFile( const std::string& pFile,
 
     // Batch loader used to load external models
     BatchLoader batch(pIOHandler);
+    batch.setNumThreads(configThreads);
 //  batch.SetBasePath(pFile);
 
     cameras.reserve(5);
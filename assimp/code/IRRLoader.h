@@ -307,6 +307,9 @@ private:
 
     /** Configuration option: speed flag was set? */
     bool configSpeedFlag;
+
+    /** Configuration option: threads for loading external files */
+    int configThreads;
 };
 
 } // end of namespace Assimp
@@ -796,7 +796,10 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
                 profiler->BeginRegion("postprocess");
             }
 
+            process->progressStep = static_cast<int>(a);
+            process->progressSteps = static_cast<int>(pimpl->mPostProcessingSteps.size());
             process->ExecuteOnScene ( this );
+            process->progressStep = -1;
 
             if (profiler) {
                 profiler->EndRegion("postprocess");
@@ -131,8 +131,9 @@ struct BatchData;
 /** FOR IMPORTER PLUGINS ONLY: A helper class to the pleasure of importers
  *  that need to load many external meshes recursively.
  *
- *  The class uses several threads to load these meshes (or at least it
- *  could, this has not yet been implemented at the moment).
+ *  The class uses several threads to load these meshes. Every request gets
+ *  its own Importer, so the results do not depend on the number of threads,
+ *  but the IOSystem must be safe to use from several threads at once.
  *
  *  @note The class may not be used by more than one thread*/
 class ASSIMP_API BatchLoader
@@ -185,6 +186,20 @@ public:
      *  @return The current validation step.
      */
     bool getValidation() const;
+
+    // -------------------------------------------------------------------
+    /** Sets the number of threads LoadAll() may use. Same meaning as
+     *  #AI_CONFIG_GLOB_MULTITHREADING: -1 to let the loader decide, 0 to
+     *  load everything on the calling thread.
+     *  @param  threads  The thread count.
+     */
+    void setNumThreads( int threads );
+
+    // -------------------------------------------------------------------
+    /** Returns the number of threads LoadAll() may use.
+     *  @return The thread count, -1 for automatic.
+     */
+    int getNumThreads() const;
     
     // -------------------------------------------------------------------
     /** Add a new file to the list of files to be loaded.
@@ -58,6 +58,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultLogger.hpp>
 #include <stdio.h>
 #include <stack>
+#include <vector>
 
 using namespace Assimp;
 
@@ -100,10 +101,15 @@ void ImproveCacheLocalityProcess::Execute( aiScene* pScene)
 
     DefaultLogger::get()->debug("ImproveCacheLocalityProcess begin");
 
+    std::vector<float> acmr( pScene->mNumMeshes, 0.f );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        acmr[ a ] = ProcessMesh( pScene->mMeshes[a], a );
+    } );
+
     float out = 0.f;
     unsigned int numf = 0, numm = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++){
-        const float res = ProcessMesh( pScene->mMeshes[a],a);
+        const float res = acmr[ a ];
         if (res) {
             numf += pScene->mMeshes[a]->mNumFaces;
             out  += res;
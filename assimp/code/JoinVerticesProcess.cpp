@@ -49,14 +49,210 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "JoinVerticesProcess.h"
 #include "ProcessHelper.h"
-#include "Vertex.h"
 #include "TinyFormatter.h"
+#include "qnan.h"
+#include <assimp/Importer.hpp>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
 
 using namespace Assimp;
+
+namespace {
+
+// Vertex indices never use the most significant bit (see AI_MAX_VERTICES)
+const unsigned int NoIndex = 0xffffffff;
+
+// Tolerance for all vertex components but the position
+const ai_real AttributeEpsilon = ai_real( 1e-5 );
+
+// ------------------------------------------------------------------------------------------------
+// Bitwise equality as seen by ComponentBits()
+inline bool SameBits( const aiVector3D& a, const aiVector3D& b )
+{
+    return ComponentBits( a.x ) == ComponentBits( b.x ) &&
+        ComponentBits( a.y ) == ComponentBits( b.y ) &&
+        ComponentBits( a.z ) == ComponentBits( b.z );
+}
+
+inline bool SameBits( const aiColor4D& a, const aiColor4D& b )
+{
+    return ComponentBits( a.r ) == ComponentBits( b.r ) &&
+        ComponentBits( a.g ) == ComponentBits( b.g ) &&
+        ComponentBits( a.b ) == ComponentBits( b.b ) &&
+        ComponentBits( a.a ) == ComponentBits( b.a );
+}
+
+inline bool IsFinite( const aiVector3D& v )
+{
+    return !is_special_float( v.x ) && !is_special_float( v.y ) && !is_special_float( v.z );
+}
+
+// ------------------------------------------------------------------------------------------------
+// Replaces a vertex component array with the entries at the given indices
+template <typename T>
+void CompactArray( T*& data, const std::vector<unsigned int>& sources )
+{
+    T* compact = new T[ sources.size() ];
+    for ( size_t i = 0; i < sources.size(); ++i ) {
+        compact[ i ] = data[ sources[ i ] ];
+    }
+    delete [] data;
+    data = compact;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Reads the components of a mesh's vertices straight from its arrays. Only the channels
+ *  that are present are looked at, like Vertex(const aiMesh*,unsigned int) does. */
+class VertexRecords
+{
+public:
+    explicit VertexRecords( const aiMesh* mesh )
+        : mPositions( mesh->mVertices )
+        , mNumVectors( 0 )
+        , mNumColors( 0 )
+    {
+        if ( mesh->HasNormals() ) {
+            mVectors[ mNumVectors++ ] = mesh->mNormals;
+        }
+        if ( mesh->HasTangentsAndBitangents() ) {
+            mVectors[ mNumVectors++ ] = mesh->mTangents;
+            mVectors[ mNumVectors++ ] = mesh->mBitangents;
+        }
+        for ( unsigned int i = 0; mesh->HasTextureCoords( i ); ++i ) {
+            mVectors[ mNumVectors++ ] = mesh->mTextureCoords[ i ];
+        }
+        for ( unsigned int i = 0; mesh->HasVertexColors( i ); ++i ) {
+            mColors[ mNumColors++ ] = mesh->mColors[ i ];
+        }
+    }
+
+    const aiVector3D& Position( unsigned int i ) const {
+        return mPositions[ i ];
+    }
+
+    // Hash of the complete vertex
+    uint64_t Hash( unsigned int i ) const {
+        uint64_t h = HashVector( 0, mPositions[ i ] );
+        for ( unsigned int c = 0; c < mNumVectors; ++c ) {
+            h = HashVector( h, mVectors[ c ][ i ] );
+        }
+        for ( unsigned int c = 0; c < mNumColors; ++c ) {
+            const aiColor4D& col = mColors[ c ][ i ];
+            h = HashCombine( h, ComponentBits( col.r ) );
+            h = HashCombine( h, ComponentBits( col.g ) );
+            h = HashCombine( h, ComponentBits( col.b ) );
+            h = HashCombine( h, ComponentBits( col.a ) );
+        }
+        return h;
+    }
+
+    // Whether two vertices are bit-identical
+    bool Identical( unsigned int a, unsigned int b ) const {
+        if ( !SameBits( mPositions[ a ], mPositions[ b ] ) ) {
+            return false;
+        }
+        for ( unsigned int c = 0; c < mNumVectors; ++c ) {
+            if ( !SameBits( mVectors[ c ][ a ], mVectors[ c ][ b ] ) ) {
+                return false;
+            }
+        }
+        for ( unsigned int c = 0; c < mNumColors; ++c ) {
+            if ( !SameBits( mColors[ c ][ a ], mColors[ c ][ b ] ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Whether all components but the position are within AttributeEpsilon.
+    // Written as !(d > e) on purpose - NaNs compare equal, as they always did.
+    bool AttributesMatch( unsigned int a, unsigned int b ) const {
+        static const ai_real squareEpsilon = AttributeEpsilon * AttributeEpsilon;
+        for ( unsigned int c = 0; c < mNumVectors; ++c ) {
+            if ( ( mVectors[ c ][ a ] - mVectors[ c ][ b ] ).SquareLength() > squareEpsilon ) {
+                return false;
+            }
+        }
+        for ( unsigned int c = 0; c < mNumColors; ++c ) {
+            if ( GetColorDifference( mColors[ c ][ a ], mColors[ c ][ b ] ) > squareEpsilon ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const aiVector3D* mPositions;
+    const aiVector3D* mVectors[ 3 + AI_MAX_NUMBER_OF_TEXTURECOORDS ];
+    const aiColor4D* mColors[ AI_MAX_NUMBER_OF_COLOR_SETS ];
+    unsigned int mNumVectors;
+    unsigned int mNumColors;
+};
+
+// ------------------------------------------------------------------------------------------------
+/** Open-addressing hash table of vertex indices with linear probing. The table is sized
+ *  for a fixed number of entries up front and never grows. */
+class IndexTable
+{
+public:
+    struct Slot {
+        uint32_t tag;
+        unsigned int index;
+    };
+
+    explicit IndexTable( unsigned int maxEntries ) {
+        size_t capacity = 16;
+        while ( capacity < 2 * static_cast<size_t>( maxEntries ) ) {
+            capacity <<= 1;
+        }
+        const Slot empty = { 0, NoIndex };
+        mSlots.assign( capacity, empty );
+        mMask = capacity - 1;
+    }
+
+    // Returns the slot whose index satisfies 'match', or the empty slot
+    // where an entry with this hash is to be stored with Fill().
+    template <typename Match>
+    Slot& Find( uint64_t hash, Match match ) {
+        const uint32_t tag = static_cast<uint32_t>( hash >> 32 );
+        for ( size_t i = static_cast<size_t>( hash ) & mMask;; i = ( i + 1 ) & mMask ) {
+            Slot& slot = mSlots[ i ];
+            if ( slot.index == NoIndex || ( slot.tag == tag && match( slot.index ) ) ) {
+                return slot;
+            }
+        }
+    }
+
+    // Stores an entry in an empty slot returned by Find()
+    static void Fill( Slot& slot, uint64_t hash, unsigned int index ) {
+        slot.tag = static_cast<uint32_t>( hash >> 32 );
+        slot.index = index;
+    }
+
+private:
+    std::vector<Slot> mSlots;
+    size_t mMask;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Grid cell of a coordinate. Cells are 'epsilon' wide, so positions closer than
+// epsilon are at most one cell apart on each axis.
+inline int64_t GridCell( ai_real v, double invEpsilon )
+{
+    const double cell = ::floor( v * invEpsilon );
+    return static_cast<int64_t>( std::max( -9.0e18, std::min( 9.0e18, cell ) ) );
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 JoinVerticesProcess::JoinVerticesProcess()
+    : configEpsilon( 0.f )
 {
     // nothing to do here
 }
@@ -74,6 +270,17 @@ bool JoinVerticesProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Setup import configuration
+void JoinVerticesProcess::SetupProperties(const Importer* pImp)
+{
+    configEpsilon = std::max( 0.f, pImp->GetPropertyFloat( AI_CONFIG_PP_JIV_EPSILON, 0.f ) );
+
+    // meshes are always welded in parallel, #AI_CONFIG_PP_PARALLEL_MESHES or not
+    meshThreads = GetThreadCount( pImp );
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void JoinVerticesProcess::Execute( aiScene* pScene)
@@ -82,16 +289,20 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
 
     // get the total number of vertices BEFORE the step is executed
     int iNumOldVertices = 0;
-    if (!DefaultLogger::isNullLogger()) {
-        for( unsigned int a = 0; a < pScene->mNumMeshes; a++)   {
-            iNumOldVertices +=  pScene->mMeshes[a]->mNumVertices;
-        }
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)   {
+        iNumOldVertices +=  pScene->mMeshes[a]->mNumVertices;
     }
 
     // execute the step
+    std::vector<int> numVertices( pScene->mNumMeshes, 0 );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        numVertices[ a ] = ProcessMesh( pScene->mMeshes[ a ], a );
+    } );
+
     int iNumVertices = 0;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+    for( unsigned int a = 0; a < pScene->mNumMeshes; a++) {
+        iNumVertices += numVertices[ a ];
+    }
 
     // if logging is active, print detailed statistics
     if (!DefaultLogger::isNullLogger())
@@ -125,10 +336,6 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         return 0;
     }
 
-    // We'll never have more vertices afterwards.
-    std::vector<Vertex> uniqueVertices;
-    uniqueVertices.reserve( pMesh->mNumVertices);
-
     // For each vertex the index of the vertex it was replaced by.
     // Since the maximal number of vertices is 2^31-1, the most significand bit can be used to mark
     //  whether a new vertex was created for the index (true) or if it was replaced by an existing
@@ -137,141 +344,126 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
     static_assert(AI_MAX_VERTICES == 0x7fffffff, "AI_MAX_VERTICES == 0x7fffffff");
     std::vector<unsigned int> replaceIndex( pMesh->mNumVertices, 0xffffffff);
 
-    // A little helper to find locally close vertices faster.
-    // Try to reuse the lookup table from the last step.
-    const static float epsilon = 1e-5f;
-    // float posEpsilonSqr;
-    SpatialSort* vertexFinder = NULL;
-    SpatialSort _vertexFinder;
-
-    typedef std::pair<SpatialSort,float> SpatPair;
-    if (shared) {
-        std::vector<SpatPair >* avf;
-        shared->GetProperty(AI_SPP_SPATIAL_SORT,avf);
-        if (avf)    {
-            SpatPair& blubb = (*avf)[meshIndex];
-            vertexFinder  = &blubb.first;
-            // posEpsilonSqr = blubb.second;
-        }
-    }
-    if (!vertexFinder)  {
-        // bad, need to compute it.
-        _vertexFinder.Fill(pMesh->mVertices, pMesh->mNumVertices, sizeof( aiVector3D));
-        vertexFinder = &_vertexFinder;
-        // posEpsilonSqr = ComputePositionEpsilon(pMesh);
-    }
+    // For each unique vertex the input vertex it was taken from, and the next unique
+    // vertex in the same position bucket, in ascending order.
+    std::vector<unsigned int> uniqueSource;
+    std::vector<unsigned int> nextInBucket;
+    uniqueSource.reserve( pMesh->mNumVertices );
+    nextInBucket.reserve( pMesh->mNumVertices );
 
-    // Squared because we check against squared length of the vector difference
-    static const float squareEpsilon = epsilon * epsilon;
+    const VertexRecords records( pMesh );
 
-    // Again, better waste some bytes than a realloc ...
-    std::vector<unsigned int> verticesFound;
-    verticesFound.reserve(10);
+    // Bit-identical vertices are found by hashing the whole vertex, which takes care
+    // of nearly all duplicates. The others are compared against the unique vertices
+    // nearby: with the exact position (configEpsilon == 0) or, in the 3x3x3 grid cells
+    // around it, within configEpsilon. An identical vertex maps to whatever its twin
+    // was mapped to, which is the lowest unique vertex matching both.
+    IndexTable identical( pMesh->mNumVertices );
+    IndexTable buckets( pMesh->mNumVertices );
 
-    // Run an optimized code path if we don't have multiple UVs or vertex colors.
-    // This should yield false in more than 99% of all imports ...
-    const bool complex = ( pMesh->GetNumColorChannels() > 0 || pMesh->GetNumUVChannels() > 1);
+    const bool grid = configEpsilon > 0.f;
+    const double invEpsilon = grid ? 1.0 / configEpsilon : 0.0;
+    const ai_real squarePosEpsilon = static_cast<ai_real>( configEpsilon ) * configEpsilon;
 
-    // Now check each vertex if it brings something new to the table
     for( unsigned int a = 0; a < pMesh->mNumVertices; a++)  {
-        // collect the vertex data
-        Vertex v(pMesh,a);
-
-        // collect all vertices that are close enough to the given position
-        vertexFinder->FindIdenticalPositions( v.position, verticesFound);
-        unsigned int matchIndex = 0xffffffff;
-
-        // check all unique vertices close to the position if this vertex is already present among them
-        for( unsigned int b = 0; b < verticesFound.size(); b++) {
-
-            const unsigned int vidx = verticesFound[b];
-            const unsigned int uidx = replaceIndex[ vidx];
-            if( uidx & 0x80000000)
-                continue;
-
-            const Vertex& uv = uniqueVertices[ uidx];
-            // Position mismatch is impossible - the vertex finder already discarded all non-matching positions
-
-            // We just test the other attributes even if they're not present in the mesh.
-            // In this case they're initialized to 0 so the comparison succeeds.
-            // By this method the non-present attributes are effectively ignored in the comparison.
-            if( (uv.normal - v.normal).SquareLength() > squareEpsilon)
-                continue;
-            if( (uv.texcoords[0] - v.texcoords[0]).SquareLength() > squareEpsilon)
-                continue;
-            if( (uv.tangent - v.tangent).SquareLength() > squareEpsilon)
-                continue;
-            if( (uv.bitangent - v.bitangent).SquareLength() > squareEpsilon)
-                continue;
-
-            // Usually we won't have vertex colors or multiple UVs, so we can skip from here
-            // Actually this increases runtime performance slightly, at least if branch
-            // prediction is on our side.
-            if (complex){
-                // manually unrolled because continue wouldn't work as desired in an inner loop,
-                // also because some compilers seem to fail the task. Colors and UV coords
-                // are interleaved since the higher entries are most likely to be
-                // zero and thus useless. By interleaving the arrays, vertices are,
-                // on average, rejected earlier.
-
-                if( (uv.texcoords[1] - v.texcoords[1]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[0], v.colors[0]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[2] - v.texcoords[2]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[1], v.colors[1]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[3] - v.texcoords[3]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[2], v.colors[2]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[4] - v.texcoords[4]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[3], v.colors[3]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[5] - v.texcoords[5]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[4], v.colors[4]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[6] - v.texcoords[6]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[5], v.colors[5]) > squareEpsilon)
-                    continue;
-
-                if( (uv.texcoords[7] - v.texcoords[7]).SquareLength() > squareEpsilon)
-                    continue;
-                if( GetColorDifference( uv.colors[6], v.colors[6]) > squareEpsilon)
-                    continue;
-
-                if( GetColorDifference( uv.colors[7], v.colors[7]) > squareEpsilon)
-                    continue;
-            }
+        const aiVector3D& pos = records.Position( a );
+        const unsigned int newIndex = static_cast<unsigned int>( uniqueSource.size() );
+
+        // Non-finite positions never match anything
+        if ( !IsFinite( pos ) ) {
+            replaceIndex[ a ] = newIndex;
+            uniqueSource.push_back( a );
+            nextInBucket.push_back( NoIndex );
+            continue;
+        }
 
-            // we're still here -> this vertex perfectly matches our given vertex
-            matchIndex = uidx;
-            break;
+        const uint64_t hash = records.Hash( a );
+        IndexTable::Slot& twin = identical.Find( hash, [&]( unsigned int b ) {
+            return records.Identical( a, b );
+        } );
+        if ( twin.index != NoIndex ) {
+            replaceIndex[ a ] = replaceIndex[ twin.index ] | 0x80000000;
+            continue;
+        }
+        IndexTable::Fill( twin, hash, a );
+
+        // The position bucket of this vertex and the end of its list
+        IndexTable::Slot* bucket = NULL;
+        uint64_t bucketHash = 0;
+        unsigned int* link = NULL;
+
+        unsigned int matchIndex = NoIndex;
+        if ( !grid ) {
+            bucketHash = HashVector( 0, pos );
+            bucket = &buckets.Find( bucketHash, [&]( unsigned int u ) {
+                return SameBits( records.Position( uniqueSource[ u ] ), pos );
+            } );
+            link = &bucket->index;
+            while ( *link != NoIndex ) {
+                if ( records.AttributesMatch( uniqueSource[ *link ], a ) ) {
+                    matchIndex = *link;
+                    break;
+                }
+                link = &nextInBucket[ *link ];
+            }
+        } else {
+            const int64_t cx = GridCell( pos.x, invEpsilon );
+            const int64_t cy = GridCell( pos.y, invEpsilon );
+            const int64_t cz = GridCell( pos.z, invEpsilon );
+            for ( int64_t x = cx - 1; x <= cx + 1; ++x ) {
+                for ( int64_t y = cy - 1; y <= cy + 1; ++y ) {
+                    for ( int64_t z = cz - 1; z <= cz + 1; ++z ) {
+                        const uint64_t cellHash = HashCombine( HashCombine( HashCombine( 0, x ), y ), z );
+                        IndexTable::Slot& cell = buckets.Find( cellHash, [&]( unsigned int u ) {
+                            const aiVector3D& p = records.Position( uniqueSource[ u ] );
+                            return GridCell( p.x, invEpsilon ) == x &&
+                                GridCell( p.y, invEpsilon ) == y &&
+                                GridCell( p.z, invEpsilon ) == z;
+                        } );
+
+                        // Buckets are sorted, so stop at the first match or once we're past
+                        // the best match in other buckets.
+                        unsigned int* it = &cell.index;
+                        while ( *it != NoIndex && *it < matchIndex ) {
+                            const unsigned int src = uniqueSource[ *it ];
+                            if ( ( records.Position( src ) - pos ).SquareLength() <= squarePosEpsilon &&
+                                 records.AttributesMatch( src, a ) ) {
+                                matchIndex = *it;
+                                break;
+                            }
+                            it = &nextInBucket[ *it ];
+                        }
+                        if ( x == cx && y == cy && z == cz ) {
+                            bucket = &cell;
+                            bucketHash = cellHash;
+                            link = it;
+                        }
+                    }
+                }
+            }
         }
 
         // found a replacement vertex among the uniques?
-        if( matchIndex != 0xffffffff)
+        if( matchIndex != NoIndex)
         {
             // store where to found the matching unique vertex
             replaceIndex[a] = matchIndex | 0x80000000;
         }
         else
         {
-            // no unique vertex matches it up to now -> so add it
-            replaceIndex[a] = (unsigned int)uniqueVertices.size();
-            uniqueVertices.push_back( v);
+            // no unique vertex matches it up to now -> so add it to the end of its bucket
+            replaceIndex[a] = newIndex;
+            if ( bucket->index == NoIndex ) {
+                IndexTable::Fill( *bucket, bucketHash, newIndex );
+            } else {
+                *link = newIndex;
+            }
+            uniqueSource.push_back( a );
+            nextInBucket.push_back( NoIndex );
         }
     }
 
+    const unsigned int numUnique = static_cast<unsigned int>( uniqueSource.size() );
     if (!DefaultLogger::isNullLogger() && DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE)    {
         DefaultLogger::get()->debug((Formatter::format(),
             "Mesh ",meshIndex,
@@ -279,72 +471,38 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             (pMesh->mName.length ? pMesh->mName.data : "unnamed"),
             ") | Verts in: ",pMesh->mNumVertices,
             " out: ",
-            uniqueVertices.size(),
+            numUnique,
             " | ~",
-            ((pMesh->mNumVertices - uniqueVertices.size()) / (float)pMesh->mNumVertices) * 100.f,
+            ((pMesh->mNumVertices - numUnique) / (float)pMesh->mNumVertices) * 100.f,
             "%"
         ));
     }
 
     // replace vertex data with the unique data sets
-    pMesh->mNumVertices = (unsigned int)uniqueVertices.size();
-
-    // ----------------------------------------------------------------------------
-    // NOTE - we're *not* calling Vertex::SortBack() because it would check for
-    // presence of every single vertex component once PER VERTEX. And our CPU
-    // dislikes branches, even if they're easily predictable.
-    // ----------------------------------------------------------------------------
+    pMesh->mNumVertices = numUnique;
 
     // Position
-    delete [] pMesh->mVertices;
-    pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
-    for( unsigned int a = 0; a < pMesh->mNumVertices; a++)
-        pMesh->mVertices[a] = uniqueVertices[a].position;
+    CompactArray( pMesh->mVertices, uniqueSource );
 
     // Normals, if present
-    if( pMesh->mNormals)
-    {
-        delete [] pMesh->mNormals;
-        pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
-        for( unsigned int a = 0; a < pMesh->mNumVertices; a++) {
-            pMesh->mNormals[a] = uniqueVertices[a].normal;
-        }
+    if( pMesh->mNormals) {
+        CompactArray( pMesh->mNormals, uniqueSource );
     }
     // Tangents, if present
-    if( pMesh->mTangents)
-    {
-        delete [] pMesh->mTangents;
-        pMesh->mTangents = new aiVector3D[pMesh->mNumVertices];
-        for( unsigned int a = 0; a < pMesh->mNumVertices; a++) {
-            pMesh->mTangents[a] = uniqueVertices[a].tangent;
-        }
+    if( pMesh->mTangents) {
+        CompactArray( pMesh->mTangents, uniqueSource );
     }
     // Bitangents as well
-    if( pMesh->mBitangents)
-    {
-        delete [] pMesh->mBitangents;
-        pMesh->mBitangents = new aiVector3D[pMesh->mNumVertices];
-        for( unsigned int a = 0; a < pMesh->mNumVertices; a++) {
-            pMesh->mBitangents[a] = uniqueVertices[a].bitangent;
-        }
+    if( pMesh->mBitangents) {
+        CompactArray( pMesh->mBitangents, uniqueSource );
     }
     // Vertex colors
-    for( unsigned int a = 0; pMesh->HasVertexColors(a); a++)
-    {
-        delete [] pMesh->mColors[a];
-        pMesh->mColors[a] = new aiColor4D[pMesh->mNumVertices];
-        for( unsigned int b = 0; b < pMesh->mNumVertices; b++) {
-            pMesh->mColors[a][b] = uniqueVertices[b].colors[a];
-        }
+    for( unsigned int a = 0; pMesh->HasVertexColors(a); a++) {
+        CompactArray( pMesh->mColors[a], uniqueSource );
     }
     // Texture coords
-    for( unsigned int a = 0; pMesh->HasTextureCoords(a); a++)
-    {
-        delete [] pMesh->mTextureCoords[a];
-        pMesh->mTextureCoords[a] = new aiVector3D[pMesh->mNumVertices];
-        for( unsigned int b = 0; b < pMesh->mNumVertices; b++) {
-            pMesh->mTextureCoords[a][b] = uniqueVertices[b].texcoords[a];
-        }
+    for( unsigned int a = 0; pMesh->HasTextureCoords(a); a++) {
+        CompactArray( pMesh->mTextureCoords[a], uniqueSource );
     }
 
     // adjust the indices in all faces
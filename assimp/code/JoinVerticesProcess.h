@@ -75,6 +75,13 @@ public:
     */
     bool IsActive( unsigned int pFlags) const;
 
+    // -------------------------------------------------------------------
+    /** Called prior to ExecuteOnScene().
+    * The function is a request to the process to update its configuration
+    * basing on the Importer's configuration property list.
+    */
+    void SetupProperties(const Importer* pImp);
+
     // -------------------------------------------------------------------
     /** Executes the post processing step on the given imported data.
     * At the moment a process is not supposed to fail.
@@ -85,12 +92,17 @@ public:
 public:
     // -------------------------------------------------------------------
     /** Unites identical vertices in the given mesh.
+     * Bit-identical vertices are found by hashing, the others by looking
+     * at the vertices with the same position, or within the distance set
+     * by #AI_CONFIG_PP_JIV_EPSILON.
      * @param pMesh The mesh to process.
      * @param meshIndex Index of the mesh to process
      */
     int ProcessMesh( aiMesh* pMesh, unsigned int meshIndex);
 
 private:
+    /** Configures the maximum distance of vertex positions to be joined */
+    float configEpsilon;
 };
 
 } // end of namespace Assimp
@@ -835,10 +835,13 @@ void LWOImporter::CountVertsAndFacesLWO2(unsigned int& verts, unsigned int& face
         verts += numIndices;
         ++faces;
 
+        // indices are 2 or 4 bytes, so cursor stays 16 bit aligned
+        uint8_t* p = reinterpret_cast<uint8_t*>(cursor);
         for(uint16_t i = 0; i < numIndices; i++)
         {
-            ReadVSizedIntLWO2((uint8_t*&)cursor);
+            ReadVSizedIntLWO2(p);
         }
+        cursor = reinterpret_cast<uint16_t*>(p);
     }
 }
 
@@ -858,15 +861,17 @@ void LWOImporter::CopyFaceIndicesLWO2(FaceList::iterator& it,
         if(face.mNumIndices) /* byte swapping has already been done */
         {
             face.mIndices = new unsigned int[face.mNumIndices];
+            uint8_t* p = reinterpret_cast<uint8_t*>(cursor);
             for(unsigned int i = 0; i < face.mNumIndices; i++)
             {
-                face.mIndices[i] = ReadVSizedIntLWO2((uint8_t*&)cursor) + mCurLayer->mPointIDXOfs;
+                face.mIndices[i] = ReadVSizedIntLWO2(p) + mCurLayer->mPointIDXOfs;
                 if(face.mIndices[i] > mCurLayer->mTempPoints.size())
                 {
                     DefaultLogger::get()->warn("LWO2: Failure evaluating face record, index is out of range");
                     face.mIndices[i] = (unsigned int)mCurLayer->mTempPoints.size()-1;
                 }
             }
+            cursor = reinterpret_cast<uint16_t*>(p);
         }
         else throw DeadlyImportError("LWO2: Encountered invalid face record with zero indices");
     }
@@ -131,6 +131,7 @@ void LWS::Element::Parse (const char*& buffer)
 // Constructor to be privately used by Importer
 LWSImporter::LWSImporter()
     : configSpeedFlag(),
+    configThreads(-1),
     io(),
     first(),
     last(),
@@ -192,6 +193,9 @@ void LWSImporter::SetupProperties(const Importer* pImp)
     }
 
     noSkeletonMesh = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_NO_SKELETON_MESHES,0) != 0;
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    configThreads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -529,6 +533,7 @@ void LWSImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
 
     // Construct a Batchimporter to read more files recursively
     BatchLoader batch(pIOHandler);
+    batch.setNumThreads(configThreads);
 //  batch.SetBasePath(pFile);
 
     // Construct an array to receive the flat output graph
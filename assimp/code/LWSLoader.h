@@ -241,6 +241,7 @@ private:
 private:
 
     bool configSpeedFlag;
+    int configThreads;
     IOSystem* io;
 
     double first,last,fps;
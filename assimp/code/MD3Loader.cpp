@@ -356,6 +356,7 @@ void Q3Shader::ConvertShaderToMaterial(aiMaterial* out, const ShaderDataBlock& s
 MD3Importer::MD3Importer()
     : configFrameID  (0)
     , configHandleMP (true)
+    , configThreads  (-1)
     , configSpeedFlag()
     , pcHeader()
     , mBuffer()
@@ -482,6 +483,9 @@ void MD3Importer::SetupProperties(const Importer* pImp)
 
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    configThreads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -586,6 +590,7 @@ bool MD3Importer::ReadMultipartFile()
 
         // now read these three files
         BatchLoader batch(mIOHandler);
+        batch.setNumThreads(configThreads);
         const unsigned int _lower = batch.AddLoadRequest(lower,0,&props);
         const unsigned int _upper = batch.AddLoadRequest(upper,0,&props);
         const unsigned int _head  = batch.AddLoadRequest(head,0,&props);
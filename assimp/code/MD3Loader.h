@@ -293,6 +293,9 @@ protected:
     /** Configuration option: process multi-part files */
     bool configHandleMP;
 
+    /** Configuration option: threads for loading the parts */
+    int configThreads;
+
     /** Configuration option: name of skin file to be read */
     std::string configSkinFile;
 
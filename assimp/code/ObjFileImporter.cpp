@@ -78,7 +78,8 @@ using namespace std;
 ObjFileImporter::ObjFileImporter() :
     m_Buffer(),
     m_pRootObject( NULL ),
-    m_strAbsPath( "" )
+    m_strAbsPath( "" ),
+    configThreads( -1 )
 {
     DefaultIOSystem io;
     m_strAbsPath = io.getOsSeparator();
@@ -107,6 +108,13 @@ bool ObjFileImporter::CanRead( const std::string& pFile, IOSystem*  pIOHandler ,
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void ObjFileImporter::SetupProperties(const Importer* pImp)
+{
+    // AI_CONFIG_GLOB_MULTITHREADING
+    configThreads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc* ObjFileImporter::GetInfo () const
 {
@@ -181,7 +189,7 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
     m_progress->UpdateFileRead(1, 3);
 
     // parse the file into a temporary representation
-    ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file);
+    ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file, configThreads );
 
     // And create the proper return structures out of it
     CreateDataFromImport(parser.GetModel(), pScene);
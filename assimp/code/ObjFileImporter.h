@@ -72,6 +72,9 @@ public:
     /// \remark See BaseImporter::CanRead() for details.
     bool CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const;
 
+    //! \brief  Called prior to ReadFile().
+    void SetupProperties(const Importer* pImp);
+
 private:
     //! \brief  Appends the supported extension.
     const aiImporterDesc* GetInfo () const;
@@ -113,6 +116,8 @@ private:
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Thread count for parsing large files, see AI_CONFIG_GLOB_MULTITHREADING
+    int configThreads;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -51,12 +51,29 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/material.h>
 #include <assimp/Importer.hpp>
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+#   include <atomic>
+#   include <system_error>
+#   include <thread>
+#endif
 
 namespace Assimp {
 
 const std::string ObjFileParser::DEFAULT_MATERIAL = AI_DEFAULT_MATERIAL_NAME;
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+namespace {
+    // Files from MinParallelSize bytes on are parsed in chunks of about
+    // ChunkSize bytes, each thread gets ChunksPerThread of them at once.
+    const size_t ChunkSize = 1 << 20;
+    const size_t ChunksPerThread = 4;
+    const size_t MinParallelSize = 2 * ChunkSize;
+}
+#endif
+
 ObjFileParser::ObjFileParser()
 : m_DataIt()
 , m_DataItEnd()
@@ -64,20 +81,22 @@ ObjFileParser::ObjFileParser()
 , m_uiLine( 0 )
 , m_pIO( nullptr )
 , m_progress( nullptr )
-, m_originalObjFileName() {
+, m_originalObjFileName()
+, m_threads( 0 ) {
     // empty
 }
 
 ObjFileParser::ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName,
                               IOSystem *io, ProgressHandler* progress,
-                              const std::string &originalObjFileName) :
+                              const std::string &originalObjFileName, int threads) :
     m_DataIt(),
     m_DataItEnd(),
     m_pModel(NULL),
     m_uiLine(0),
     m_pIO( io ),
     m_progress(progress),
-    m_originalObjFileName(originalObjFileName)
+    m_originalObjFileName(originalObjFileName),
+    m_threads(threads)
 {
     std::fill_n(m_buffer,Buffersize,0);
 
@@ -119,6 +138,21 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
     unsigned int processed = 0;
     size_t lastFilePos( 0 );
 
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+    unsigned int numThreads = 1;
+    if ( m_threads < 0 ) {
+        numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    } else if ( m_threads > 0 ) {
+        numThreads = static_cast<unsigned int>( m_threads );
+    }
+    if ( numThreads > 1 && streamBuffer.size() >= MinParallelSize ) {
+        if ( parseFileParallel( streamBuffer, numThreads ) ) {
+            return;
+        }
+        DefaultLogger::get()->debug( "OBJ: statements the parallel parser does not handle, going on serially" );
+    }
+#endif
+
     std::vector<char> buffer;
     while ( streamBuffer.getNextDataLine( buffer, '\\' ) ) {
         m_DataIt = buffer.begin();
@@ -133,113 +167,443 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
             m_progress->UpdateFileRead( progressOffset + processed * 2, progressTotal );
         }
 
-        // parse line
-        switch (*m_DataIt) {
-        case 'v': // Parse a vertex texture coordinate
-            {
-                ++m_DataIt;
-                if (*m_DataIt == ' ' || *m_DataIt == '\t') {
-                    size_t numComponents = getNumComponentsInDataDefinition();
-                    if (numComponents == 3) {
-                        // read in vertex definition
-                        getVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 4) {
-                        // read in vertex definition (homogeneous coords)
-                        getHomogeneousVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 6) {
-                        // read vertex and vertex-color
-                        getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
-                    }
-                } else if (*m_DataIt == 't') {
-                    // read in texture coordinate ( 2D or 3D )
-                    ++m_DataIt;
-                    getVector( m_pModel->m_TextureCoord );
-                } else if (*m_DataIt == 'n') {
-                    // Read in normal vector definition
-                    ++m_DataIt;
-                    getVector3( m_pModel->m_Normals );
+        parseLine();
+    }
+}
+
+void ObjFileParser::parseLine() {
+    switch (*m_DataIt) {
+    case 'v': // Parse a vertex texture coordinate
+        {
+            ++m_DataIt;
+            if (*m_DataIt == ' ' || *m_DataIt == '\t') {
+                size_t numComponents = getNumComponentsInDataDefinition();
+                if (numComponents == 3) {
+                    // read in vertex definition
+                    getVector3(m_pModel->m_Vertices);
+                } else if (numComponents == 4) {
+                    // read in vertex definition (homogeneous coords)
+                    getHomogeneousVector3(m_pModel->m_Vertices);
+                } else if (numComponents == 6) {
+                    // read vertex and vertex-color
+                    getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
                 }
+            } else if (*m_DataIt == 't') {
+                // read in texture coordinate ( 2D or 3D )
+                ++m_DataIt;
+                getVector( m_pModel->m_TextureCoord );
+            } else if (*m_DataIt == 'n') {
+                // Read in normal vector definition
+                ++m_DataIt;
+                getVector3( m_pModel->m_Normals );
             }
-            break;
+        }
+        break;
 
-        case 'p': // Parse a face, line or point statement
-        case 'l':
-        case 'f':
+    case 'p': // Parse a face, line or point statement
+    case 'l':
+    case 'f':
+        {
+            getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+        }
+        break;
+
+    case '#': // Parse a comment
+        {
+            getComment();
+        }
+        break;
+
+    case 'u': // Parse a material desc. setter
+        {
+            std::string name;
+
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
+
+            if(name == "usemtl")
             {
-                getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
-                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+                getMaterialDesc();
             }
+        }
+        break;
+
+    case 'm': // Parse a material library or merging group ('mg')
+        {
+            std::string name;
+
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
+
+            if (name == "mg")
+                getGroupNumberAndResolution();
+            else if(name == "mtllib")
+                getMaterialLib();
+				else
+					goto pf_skip_line;
+        }
+        break;
+
+    case 'g': // Parse group name
+        {
+            getGroupName();
+        }
+        break;
+
+    case 's': // Parse group number
+        {
+            getGroupNumber();
+        }
+        break;
+
+    case 'o': // Parse object name
+        {
+            getObjectName();
+        }
+        break;
+
+    default:
+        {
+pf_skip_line:
+            m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+        }
+        break;
+    }
+}
+
+#ifndef ASSIMP_BUILD_SINGLETHREADED
+namespace {
+
+// A line aligned part of the file. Vertex data and faces are parsed on a
+// worker thread, all other statements are kept as text and replayed in
+// order by the serial parser when the chunk is added to the model.
+struct ObjChunk {
+    const char *begin, *end;
+    bool supported;
+    // vertex data in the chunk, and in front of it in the whole file
+    size_t numVertices, numTexCoords, numNormals;
+    size_t baseVertices, baseTexCoords, baseNormals;
+    std::vector<aiVector3D> vertices, colors, texCoords, normals;
+    std::vector<std::unique_ptr<ObjFile::Face> > faces;
+    // statements and the number of faces in front of them
+    std::vector<std::pair<size_t, std::string> > statements;
+
+    ObjChunk( const char *b, const char *e )
+    : begin( b ), end( e ), supported( true )
+    , numVertices( 0 ), numTexCoords( 0 ), numNormals( 0 )
+    , baseVertices( 0 ), baseTexCoords( 0 ), baseNormals( 0 ) {
+        // empty
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+template <typename Func>
+void ParallelFor( unsigned int numThreads, size_t count, const Func &func ) {
+    std::atomic<size_t> next( 0 );
+    auto worker = [&]() {
+        for ( size_t i = next++; i < count; i = next++ ) {
+            func( i );
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for ( unsigned int t = 1; t < numThreads && t < count; ++t ) {
+        try {
+            pool.push_back( std::thread( worker ) );
+        } catch ( const std::system_error& ) {
+            // out of threads, go on with those we have
             break;
+        }
+    }
+    worker();
+    for ( size_t t = 0; t < pool.size(); ++t ) {
+        pool[ t ].join();
+    }
+}
 
-        case '#': // Parse a comment
-            {
-                getComment();
+// ------------------------------------------------------------------------------------------------
+// Counts the vertex data lines of a chunk. Continued lines are left to the serial parser.
+void CountVertexData( ObjChunk &chunk ) {
+    for ( const char *line = chunk.begin; line != chunk.end; ) {
+        const char *eol = line;
+        for ( ; !IsLineEnd( *eol ); ++eol ) {
+            if ( '\\' == *eol ) {
+                chunk.supported = false;
             }
-            break;
+        }
+        if ( 'v' == line[ 0 ] ) {
+            if ( IsSpace( line[ 1 ] ) ) {
+                ++chunk.numVertices;
+            } else if ( 't' == line[ 1 ] ) {
+                ++chunk.numTexCoords;
+            } else if ( 'n' == line[ 1 ] ) {
+                ++chunk.numNormals;
+            }
+        }
+        line = eol + 1;
+    }
+}
 
-        case 'u': // Parse a material desc. setter
-            {
-                std::string name;
+// ------------------------------------------------------------------------------------------------
+// Reads the numbers up to the line end, gives the same values as copyNextWord() and
+// fast_atof(). Returns their count or -1 if there is anything else on the line.
+int ReadNumbers( const char *p, const char *eol, ai_real *out, int max ) {
+    int count = 0;
+    for ( ;; ) {
+        while ( IsSpace( *p ) ) {
+            ++p;
+        }
+        if ( p == eol ) {
+            return count;
+        }
+        if ( count == max || !IsNumeric( *p ) ) {
+            return -1;
+        }
+        p = fast_atoreal_move<ai_real>( p, out[ count++ ] );
+        if ( !IsSpaceOrNewLine( *p ) ) {
+            return -1;
+        }
+    }
+}
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+// ------------------------------------------------------------------------------------------------
+// Reads the vertex references of a face like getFace() does for well formed ones. The
+// sizes are those of the vertex data arrays at this line. Returns false for anything else.
+bool ReadFace( const char *p, const char *eol, const size_t sizes[ 3 ], ObjFile::Face &face ) {
+    ObjFile::Face::IndexArray *slots[ 3 ] = { &face.m_vertices, &face.m_texturCoords, &face.m_normals };
+    const bool vt = sizes[ 1 ] != 0, vn = sizes[ 2 ] != 0;
+
+    unsigned int slot = 0;
+    while ( p != eol ) {
+        if ( '/' == *p ) {
+            // getFace() skips one character for 'v//vn' if there are normals only
+            if ( 0 == slot && !vt && vn ) {
+                if ( '/' != p[ 1 ] ) {
+                    return false;
+                }
+                ++slot;
+                ++p;
+            }
+            ++slot;
+            ++p;
+        } else if ( IsSpace( *p ) ) {
+            slot = 0;
+            ++p;
+        } else {
+            // atoi() and the digit count in getFace() agree for these only
+            const bool negative = '-' == *p;
+            if ( negative ) {
+                ++p;
+            }
+            if ( *p < '1' || *p > '9' || slot > 2 ) {
+                return false;
+            }
+            int value = 0, digits = 0;
+            for ( ; *p >= '0' && *p <= '9'; ++p ) {
+                if ( ++digits > 9 ) {
+                    return false;
+                }
+                value = value * 10 + ( *p - '0' );
+            }
+            const int size = static_cast<int>( sizes[ slot ] );
+            slots[ slot ]->push_back( negative ? size - value : value - 1 );
+        }
+    }
+    return !face.m_vertices.empty();
+}
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+// ------------------------------------------------------------------------------------------------
+void ParseChunk( ObjChunk &chunk ) {
+    ai_real v[ 6 ];
+    for ( const char *line = chunk.begin; line != chunk.end && chunk.supported; ) {
+        const char *eol = line;
+        while ( !IsLineEnd( *eol ) ) {
+            ++eol;
+        }
 
-                if(name == "usemtl")
-                {
-                    getMaterialDesc();
+        switch ( line[ 0 ] ) {
+        case 'v':
+            if ( IsSpace( line[ 1 ] ) ) {
+                const int count = ReadNumbers( line + 1, eol, v, 6 );
+                if ( 3 == count ) {
+                    chunk.vertices.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+                } else if ( 4 == count && v[ 3 ] != 0 ) {
+                    chunk.vertices.push_back( aiVector3D( v[ 0 ] / v[ 3 ], v[ 1 ] / v[ 3 ], v[ 2 ] / v[ 3 ] ) );
+                } else if ( 6 == count ) {
+                    chunk.vertices.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+                    chunk.colors.push_back( aiVector3D( v[ 3 ], v[ 4 ], v[ 5 ] ) );
+                } else {
+                    chunk.supported = false;
+                }
+            } else if ( 't' == line[ 1 ] ) {
+                const int count = IsSpace( line[ 2 ] ) ? ReadNumbers( line + 2, eol, v, 3 ) : -1;
+                if ( 2 == count || 3 == count ) {
+                    chunk.texCoords.push_back( aiVector3D( v[ 0 ], v[ 1 ], 3 == count ? v[ 2 ] : 0 ) );
+                } else {
+                    chunk.supported = false;
+                }
+            } else if ( 'n' == line[ 1 ] ) {
+                const int count = IsSpace( line[ 2 ] ) ? ReadNumbers( line + 2, eol, v, 3 ) : -1;
+                if ( 3 == count ) {
+                    chunk.normals.push_back( aiVector3D( v[ 0 ], v[ 1 ], v[ 2 ] ) );
+                } else {
+                    chunk.supported = false;
                 }
             }
             break;
 
-        case 'm': // Parse a material library or merging group ('mg')
-            {
-                std::string name;
+        case 'f':
+            if ( IsSpace( line[ 1 ] ) ) {
+                const size_t sizes[ 3 ] = {
+                    chunk.baseVertices + chunk.vertices.size(),
+                    chunk.baseTexCoords + chunk.texCoords.size(),
+                    chunk.baseNormals + chunk.normals.size()
+                };
+                std::unique_ptr<ObjFile::Face> face( new ObjFile::Face( aiPrimitiveType_POLYGON ) );
+                if ( ReadFace( line + 2, eol, sizes, *face ) ) {
+                    chunk.faces.push_back( std::move( face ) );
+                    break;
+                }
+            }
+            chunk.supported = false;
+            break;
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+        case 'l':
+        case 'p':
+            chunk.supported = false;
+            break;
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+        case 'u':
+        case 'm':
+        case 'g':
+        case 'o':
+            chunk.statements.push_back( std::make_pair( chunk.faces.size(), std::string( line, eol ) ) );
+            break;
 
-                if (name == "mg")
-                    getGroupNumberAndResolution();
-                else if(name == "mtllib")
-                    getMaterialLib();
-				else
-					goto pf_skip_line;
-            }
+        default: // comments, smoothing groups, empty lines
             break;
+        }
+        line = eol + 1;
+    }
+}
 
-        case 'g': // Parse group name
-            {
-                getGroupName();
+} // Namespace
+
+bool ObjFileParser::parseFileParallel( IOStreamBuffer<char> &streamBuffer, unsigned int numThreads ) {
+    const size_t fileSize = streamBuffer.size();
+    const size_t windowSize = ChunkSize * ChunksPerThread * numThreads;
+
+    std::vector<char> window, block, statement;
+    size_t windowPos = 0;
+    bool more = true;
+    for ( ;; ) {
+        // The window starts with the incomplete last line of the previous one. A last
+        // line without line end is dropped at the end of the file, as getNextDataLine() does.
+        while ( more && window.size() < windowSize ) {
+            more = streamBuffer.getNextBlock( block );
+            if ( more ) {
+                window.insert( window.end(), block.begin(), block.end() );
             }
-            break;
+        }
+        size_t size = window.size();
+        while ( size > 0 && !IsLineEnd( window[ size - 1 ] ) ) {
+            --size;
+        }
+        if ( 0 == size ) {
+            if ( more ) {
+                // a single line longer than the window
+                streamBuffer.seek( windowPos );
+                return false;
+            }
+            return true;
+        }
 
-        case 's': // Parse group number
-            {
-                getGroupNumber();
+        std::vector<ObjChunk> chunks;
+        const char *data = window.data(), *end = data + size;
+        for ( const char *begin = data; begin != end; ) {
+            const char *cut = begin + std::min( ChunkSize, static_cast<size_t>( end - begin ) );
+            while ( !IsLineEnd( cut[ -1 ] ) ) {
+                ++cut;
             }
-            break;
+            chunks.push_back( ObjChunk( begin, cut ) );
+            begin = cut;
+        }
 
-        case 'o': // Parse object name
-            {
-                getObjectName();
+        ParallelFor( numThreads, chunks.size(), [&]( size_t i ) {
+            CountVertexData( chunks[ i ] );
+        } );
+
+        size_t numVertices = m_pModel->m_Vertices.size();
+        size_t numTexCoords = m_pModel->m_TextureCoord.size();
+        size_t numNormals = m_pModel->m_Normals.size();
+        bool supported = true;
+        for ( ObjChunk &chunk : chunks ) {
+            chunk.baseVertices = numVertices;
+            chunk.baseTexCoords = numTexCoords;
+            chunk.baseNormals = numNormals;
+            numVertices += chunk.numVertices;
+            numTexCoords += chunk.numTexCoords;
+            numNormals += chunk.numNormals;
+            supported = supported && chunk.supported;
+        }
+
+        if ( supported ) {
+            ParallelFor( numThreads, chunks.size(), [&]( size_t i ) {
+                try {
+                    ParseChunk( chunks[ i ] );
+                } catch ( ... ) {
+                    // let the serial parser report it
+                    chunks[ i ].supported = false;
+                }
+            } );
+            for ( const ObjChunk &chunk : chunks ) {
+                supported = supported && chunk.supported;
             }
-            break;
+        }
+        if ( !supported ) {
+            streamBuffer.seek( windowPos );
+            return false;
+        }
 
-        default:
-            {
-pf_skip_line:
-                m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+        // Add the chunks in file order, only statements need the serial parser
+        for ( ObjChunk &chunk : chunks ) {
+            m_pModel->m_Vertices.insert( m_pModel->m_Vertices.end(), chunk.vertices.begin(), chunk.vertices.end() );
+            m_pModel->m_VertexColors.insert( m_pModel->m_VertexColors.end(), chunk.colors.begin(), chunk.colors.end() );
+            m_pModel->m_TextureCoord.insert( m_pModel->m_TextureCoord.end(), chunk.texCoords.begin(), chunk.texCoords.end() );
+            m_pModel->m_Normals.insert( m_pModel->m_Normals.end(), chunk.normals.begin(), chunk.normals.end() );
+
+            size_t face = 0;
+            for ( size_t i = 0; i <= chunk.statements.size(); ++i ) {
+                const size_t numFaces = i < chunk.statements.size() ? chunk.statements[ i ].first : chunk.faces.size();
+                for ( ; face < numFaces; ++face ) {
+                    addFace( chunk.faces[ face ].release() );
+                }
+                if ( i < chunk.statements.size() ) {
+                    // the line buffer of getNextDataLine() always goes on after the line end
+                    const std::string &line = chunk.statements[ i ].second;
+                    statement.assign( line.begin(), line.end() );
+                    statement.resize( line.size() + 2, '\n' );
+                    m_DataIt = statement.begin();
+                    m_DataItEnd = statement.end();
+                    parseLine();
+                }
             }
-            break;
         }
+
+        windowPos += size;
+        window.erase( window.begin(), window.begin() + size );
+        m_progress->UpdateFileRead( static_cast<unsigned int>( fileSize + windowPos * 2 ),
+            static_cast<unsigned int>( fileSize * 3 ) );
     }
 }
+#endif
 
 void ObjFileParser::copyNextWord(char *pBuffer, size_t length) {
     size_t index = 0;
@@ -408,7 +772,6 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
     }
 
     ObjFile::Face *face = new ObjFile::Face( type );
-    bool hasNormal = false;
 
     const int vSize = static_cast<unsigned int>(m_pModel->m_Vertices.size());
     const int vtSize = static_cast<unsigned int>(m_pModel->m_TextureCoord.size());
@@ -459,7 +822,6 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
                     face->m_texturCoords.push_back( iVal - 1 );
                 } else if ( 2 == iPos ) {
                     face->m_normals.push_back( iVal - 1 );
-                    hasNormal = true;
                 } else {
                     reportErrorTokenInFace();
                 }
@@ -471,7 +833,6 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
                     face->m_texturCoords.push_back( vtSize + iVal );
                 } else if ( 2 == iPos ) {
                     face->m_normals.push_back( vnSize + iVal );
-                    hasNormal = true;
                 } else {
                     reportErrorTokenInFace();
                 }
@@ -495,6 +856,13 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
         return;
     }
 
+    addFace( face );
+
+    // Skip the rest of the line
+    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+}
+
+void ObjFileParser::addFace( ObjFile::Face *face ) {
     // Set active material, if one set
     if( NULL != m_pModel->m_pCurrentMaterial ) {
         face->m_pMaterial = m_pModel->m_pCurrentMaterial;
@@ -516,11 +884,9 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
     m_pModel->m_pCurrentMesh->m_Faces.push_back( face );
     m_pModel->m_pCurrentMesh->m_uiNumIndices += (unsigned int) face->m_vertices.size();
     m_pModel->m_pCurrentMesh->m_uiUVCoordinates[ 0 ] += (unsigned int) face->m_texturCoords.size();
-    if( !m_pModel->m_pCurrentMesh->m_hasNormals && hasNormal ) {
+    if( !m_pModel->m_pCurrentMesh->m_hasNormals && !face->m_normals.empty() ) {
         m_pModel->m_pCurrentMesh->m_hasNormals = true;
     }
-    // Skip the rest of the line
-    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
 void ObjFileParser::getMaterialDesc() {
@@ -57,6 +57,7 @@ namespace ObjFile {
     struct Material;
     struct Point3;
     struct Point2;
+    struct Face;
 }
 
 class ObjFileImporter;
@@ -75,8 +76,9 @@ public:
 public:
     /// @brief  The default constructor.
     ObjFileParser();
-    /// @brief  Constructor with data array.
-    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName);
+    /// @brief  Constructor with data array. Large files are parsed in chunks on up to
+    ///         threads threads, -1 picks the number of cores, 0 parses serially.
+    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName, int threads = 0 );
     /// @brief  Destructor
     ~ObjFileParser();
     /// @brief  If you want to load in-core data.
@@ -87,6 +89,11 @@ public:
 protected:
     /// Parse the loaded file
     void parseFile( IOStreamBuffer<char> &streamBuffer );
+    /// Parse the file in chunks on several threads, returns false at the first part using
+    /// more than vertex data, faces and statements. The stream is then at the start of that part.
+    bool parseFileParallel( IOStreamBuffer<char> &streamBuffer, unsigned int numThreads );
+    /// Parse the line in the buffer
+    void parseLine();
     /// Method to copy the new delimited word in the current line.
     void copyNextWord(char *pBuffer, size_t length);
     /// Method to copy the new line.
@@ -105,6 +112,8 @@ protected:
     void getVector2(std::vector<aiVector2D> &point2d_array);
     /// Stores the following face.
     void getFace(aiPrimitiveType type);
+    /// Adds a parsed face to the current mesh.
+    void addFace(ObjFile::Face *face);
     /// Reads the material description.
     void getMaterialDesc();
     /// Gets a comment.
@@ -156,6 +165,8 @@ private:
     ProgressHandler* m_progress;
     /// Path to the current model, name of the obj file where the buffer comes from
     const std::string m_originalObjFileName;
+    /// Thread count for large files, see AI_CONFIG_GLOB_MULTITHREADING
+    int m_threads;
 };
 
 }   // Namespace Assimp
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IOStreamBuffer.h"
 #include "Macros.h"
 #include <memory>
+#include <algorithm>
 #include <assimp/IOSystem.hpp>
 #include <assimp/scene.h>
 #include <assimp/importerdesc.h>
@@ -85,6 +86,29 @@ namespace
 
     return props[idx];
   }
+
+  // ------------------------------------------------------------------------------------------------
+  // Decodes one property of count fixed size binary records into every destStride'th
+  // ai_real of dest, using the same conversion as the per vertex code path
+  template <ai_real (*Convert)(PLY::PropertyInstance::ValueUnion, PLY::EDataType)>
+  void UnpackColumn(const char* pCur, unsigned int stride, unsigned int count,
+    PLY::EDataType eType, bool p_bBE, ai_real* dest, unsigned int destStride)
+  {
+    PLY::PropertyInstance::ValueUnion v;
+    for (unsigned int i = 0; i < count; ++i, pCur += stride, dest += destStride) {
+      PLY::PropertyInstance::DecodeValueBinary(pCur, eType, &v, p_bBE);
+      *dest = Convert(v, eType);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------------
+  // Sets every destStride'th ai_real of dest to a constant
+  void FillColumn(ai_real value, unsigned int count, ai_real* dest, unsigned int destStride)
+  {
+    for (unsigned int i = 0; i < count; ++i, dest += destStride) {
+      *dest = value;
+    }
+  }
 }
 
 
@@ -502,6 +526,117 @@ void PLYImporter::LoadVertex(const PLY::Element* pcElement, const PLY::ElementIn
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// Unpack a block of fixed size binary vertex records, column by column
+void PLYImporter::LoadVertices(const PLY::Element* pcElement, const char* pCur, unsigned int stride,
+    unsigned int first, unsigned int count, bool p_bBE) {
+    ai_assert(NULL != pcElement);
+    ai_assert(NULL != pCur);
+
+    // byte offsets of x,y,z, nx,ny,nz, r,g,b,a and u,v in the records, these are
+    // the same semantics LoadVertex() looks for
+    enum { Position = 0, Normal = 3, Color = 6, Texcoord = 10, NumComponents = 12 };
+    unsigned int aiOffsets[NumComponents];
+    PLY::EDataType aiTypes[NumComponents];
+    std::fill(aiOffsets, aiOffsets + NumComponents, 0xFFFFFFFF);
+
+    unsigned int offset( 0 ), cnt( 0 );
+    for ( std::vector<PLY::Property>::const_iterator a = pcElement->alProperties.begin();
+            a != pcElement->alProperties.end(); ++a) {
+        unsigned int c = NumComponents;
+        switch ((*a).Semantic) {
+        case PLY::EST_XCoord: c = Position; break;
+        case PLY::EST_YCoord: c = Position + 1; break;
+        case PLY::EST_ZCoord: c = Position + 2; break;
+        case PLY::EST_XNormal: c = Normal; break;
+        case PLY::EST_YNormal: c = Normal + 1; break;
+        case PLY::EST_ZNormal: c = Normal + 2; break;
+        case PLY::EST_Red: c = Color; break;
+        case PLY::EST_Green: c = Color + 1; break;
+        case PLY::EST_Blue: c = Color + 2; break;
+        case PLY::EST_Alpha: c = Color + 3; break;
+        case PLY::EST_UTextureCoord: c = Texcoord; break;
+        case PLY::EST_VTextureCoord: c = Texcoord + 1; break;
+        default: break;
+        }
+        if (c != NumComponents) {
+            ++cnt;
+            aiOffsets[c] = offset;
+            aiTypes[c] = (*a).eType;
+        }
+        offset += PLY::PropertyInstance::GetValueSize((*a).eType);
+    }
+    ai_assert(offset == stride);
+
+    // check whether we have a valid source for the vertex data
+    if (0 == cnt) {
+        return;
+    }
+
+    //create aiMesh if needed
+    if ( nullptr == mGeneratedMesh ) {
+        mGeneratedMesh = new aiMesh();
+        mGeneratedMesh->mMaterialIndex = 0;
+    }
+
+    if (nullptr == mGeneratedMesh->mVertices) {
+        mGeneratedMesh->mNumVertices = pcElement->NumOccur;
+        mGeneratedMesh->mVertices = new aiVector3D[mGeneratedMesh->mNumVertices];
+    }
+
+    // unpack the components of one vertex array, missing ones get the value
+    // LoadVertex() would have used
+    auto unpack = [&](unsigned int c, unsigned int num, ai_real* dest, unsigned int destStride,
+            const ai_real* defaults, bool color) {
+        for (unsigned int k = 0; k < num; ++k) {
+            if (0xFFFFFFFF == aiOffsets[c + k]) {
+                FillColumn(defaults[k], count, dest + k, destStride);
+            } else if (color) {
+                UnpackColumn<&PLYImporter::NormalizeColorValue>(pCur + aiOffsets[c + k], stride, count,
+                    aiTypes[c + k], p_bBE, dest + k, destStride);
+            } else {
+                UnpackColumn<&PLY::PropertyInstance::ConvertTo<ai_real> >(pCur + aiOffsets[c + k], stride, count,
+                    aiTypes[c + k], p_bBE, dest + k, destStride);
+            }
+        }
+    };
+    auto present = [&](unsigned int c, unsigned int num) {
+        for (unsigned int k = c; k < c + num; ++k) {
+            if (0xFFFFFFFF != aiOffsets[k]) {
+                return true;
+            }
+        }
+        return false;
+    };
+    static const ai_real zero[4] = { 0, 0, 0, 0 };
+
+    unpack(Position, 3, &mGeneratedMesh->mVertices[first].x, 3, zero, false);
+
+    if (present(Normal, 3)) {
+        if (nullptr == mGeneratedMesh->mNormals)
+            mGeneratedMesh->mNormals = new aiVector3D[mGeneratedMesh->mNumVertices];
+        unpack(Normal, 3, &mGeneratedMesh->mNormals[first].x, 3, zero, false);
+    }
+
+    if (present(Color, 4)) {
+        if (nullptr == mGeneratedMesh->mColors[0])
+            mGeneratedMesh->mColors[0] = new aiColor4D[mGeneratedMesh->mNumVertices];
+
+        // assume 1.0 for the alpha channel if it is not set
+        static const ai_real colorDefaults[4] = { 0, 0, 0, 1 };
+        unpack(Color, 4, &mGeneratedMesh->mColors[0][first].r, 4, colorDefaults, true);
+    }
+
+    if (present(Texcoord, 2)) {
+        if (nullptr == mGeneratedMesh->mTextureCoords[0]) {
+            mGeneratedMesh->mNumUVComponents[0] = 2;
+            mGeneratedMesh->mTextureCoords[0] = new aiVector3D[mGeneratedMesh->mNumVertices];
+        }
+        unpack(Texcoord, 2, &mGeneratedMesh->mTextureCoords[0][first].x, 3, zero, false);
+        FillColumn(0, count, &mGeneratedMesh->mTextureCoords[0][first].z, 3);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Convert a color component to [0...1]
 ai_real PLYImporter::NormalizeColorValue(PLY::PropertyInstance::ValueUnion val,
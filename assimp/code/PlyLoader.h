@@ -82,6 +82,13 @@ public:
     */
     void LoadVertex(const PLY::Element* pcElement, const PLY::ElementInstance* instElement, unsigned int pos);
 
+    // -------------------------------------------------------------------
+    /** Extract count vertices from fixed size binary records with the
+     *  given stride, the first one being vertex number first
+    */
+    void LoadVertices(const PLY::Element* pcElement, const char* pCur, unsigned int stride,
+        unsigned int first, unsigned int count, bool p_bBE);
+
     // -------------------------------------------------------------------
     /** Extract a face from the DOM
     */
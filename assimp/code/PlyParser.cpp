@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultLogger.hpp>
 #include "ByteSwapper.h"
 #include "PlyLoader.h"
+#include <algorithm>
 
 using namespace Assimp;
 
@@ -343,6 +344,20 @@ PLY::EElementSemantic PLY::Element::ParseSemantic(std::vector<char> &buffer)
   return eOut;
 }
 
+// ------------------------------------------------------------------------------------------------
+unsigned int PLY::Element::GetRecordSizeBinary() const
+{
+  unsigned int size = 0;
+  for (std::vector<PLY::Property>::const_iterator a = alProperties.begin(); a != alProperties.end(); ++a)
+  {
+    const unsigned int lsize = PLY::PropertyInstance::GetValueSize((*a).eType);
+    if ((*a).bIsList || !lsize)
+      return 0;
+    size += lsize;
+  }
+  return size;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PLY::Element::ParseElement(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer, PLY::Element* pOut)
 {
@@ -735,17 +750,39 @@ bool PLY::ElementInstanceList::ParseInstanceListBinary(
 {
   ai_assert(NULL != pcElement);
 
+  // vertices without list properties are fixed size records, hand all of them
+  // which are in the buffer to the loader at once
+  const unsigned int stride = pcElement->GetRecordSizeBinary();
+  if (!p_pcOut && pcElement->eSemantic == EEST_Vertex && stride)
+  {
+    for (unsigned int i = 0; i < pcElement->NumOccur;)
+    {
+      while (bufferSize < stride)
+      {
+        PLY::PropertyInstance::ReadNextBlockBinary(streamBuffer, buffer, pCur, bufferSize);
+      }
+      const unsigned int count = std::min(pcElement->NumOccur - i, bufferSize / stride);
+      loader->LoadVertices(pcElement, pCur, stride, i, count, p_bBE);
+
+      pCur += count * stride;
+      bufferSize -= count * stride;
+      i += count;
+    }
+    return true;
+  }
+
   // we can add special handling code for unknown element semantics since
   // we can't skip it as a whole block (we don't know its exact size
   // due to the fact that lists could be contained in the property list
   // of the unknown element)
+  ElementInstance elt;
   for (unsigned int i = 0; i < pcElement->NumOccur; ++i)
   {
     if (p_pcOut)
       PLY::ElementInstance::ParseInstanceBinary(streamBuffer, buffer, pCur, bufferSize, pcElement, &p_pcOut->alInstances[i], p_bBE);
     else
     {
-      ElementInstance elt;
+      // the instance is reused for all records to keep the property lists allocated
       PLY::ElementInstance::ParseInstanceBinary(streamBuffer, buffer, pCur, bufferSize, pcElement, &elt, p_bBE);
 
       // Create vertex or face
@@ -816,6 +853,7 @@ bool PLY::ElementInstance::ParseInstanceBinary(
   std::vector<PLY::Property>::const_iterator   a = pcElement->alProperties.begin();
   for (; i != p_pcOut->alProperties.end(); ++i, ++a)
   {
+    (*i).avList.clear();
     if (!(PLY::PropertyInstance::ParseInstanceBinary(streamBuffer, buffer, pCur, bufferSize, &(*a), &(*i), p_bBE)))
     {
       DefaultLogger::get()->warn("Unable to parse binary property instance. "
@@ -980,70 +1018,47 @@ bool PLY::PropertyInstance::ParseValue(const char* &pCur,
 }
 
 // ------------------------------------------------------------------------------------------------
-bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
-  std::vector<char> &buffer,
-  const char* &pCur,
-  unsigned int &bufferSize,
-  PLY::EDataType eType,
-  PLY::PropertyInstance::ValueUnion* out,
-  bool p_bBE)
+unsigned int PLY::PropertyInstance::GetValueSize(PLY::EDataType eType)
 {
-  ai_assert(NULL != out);
-
-  //calc element size
-  unsigned int lsize = 0;
   switch (eType)
   {
   case EDT_Char:
   case EDT_UChar:
-    lsize = 1;
-    break;
+    return 1;
 
   case EDT_UShort:
   case EDT_Short:
-    lsize = 2;
-    break;
+    return 2;
 
   case EDT_UInt:
   case EDT_Int:
   case EDT_Float:
-    lsize = 4;
-    break;
+    return 4;
 
   case EDT_Double:
-    lsize = 8;
-    break;
+    return 8;
 
   case EDT_INVALID:
   default:
-      break;
+    break;
   }
+  return 0;
+}
 
-  //read the next file block if needed
-  if (bufferSize < lsize)
-  {
-    std::vector<char> nbuffer;
-    if (streamBuffer.getNextBlock(nbuffer))
-    {
-      //concat buffer contents
-      buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
-      buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
-      nbuffer.clear();
-      bufferSize = static_cast<unsigned int>(buffer.size());
-      pCur = (char*)&buffer[0];
-    }
-    else
-    {
-      throw DeadlyImportError("Invalid .ply file: File corrupted");
-    }
-  }
+// ------------------------------------------------------------------------------------------------
+bool PLY::PropertyInstance::DecodeValueBinary(const char* pCur,
+  PLY::EDataType eType,
+  PLY::PropertyInstance::ValueUnion* out,
+  bool p_bBE)
+{
+  ai_assert(NULL != pCur);
+  ai_assert(NULL != out);
 
   bool ret = true;
   switch (eType)
   {
   case EDT_UInt:
-    out->iUInt = (uint32_t)*((uint32_t*)pCur);
-    pCur += 4;
+    ::memcpy(&out->iUInt, pCur, 4);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap((int32_t*)&out->iUInt);
@@ -1051,25 +1066,23 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
 
   case EDT_UShort:
   {
-    uint16_t i = *((uint16_t*)pCur);
+    uint16_t i;
+    ::memcpy(&i, pCur, 2);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap(&i);
     out->iUInt = (uint32_t)i;
-    pCur += 2;
     break;
   }
 
   case EDT_UChar:
   {
     out->iUInt = (uint32_t)(*((uint8_t*)pCur));
-    pCur++;
     break;
   }
 
   case EDT_Int:
-    out->iInt = *((int32_t*)pCur);
-    pCur += 4;
+    ::memcpy(&out->iInt, pCur, 4);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap(&out->iInt);
@@ -1077,45 +1090,88 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
 
   case EDT_Short:
   {
-    int16_t i = *((int16_t*)pCur);
+    int16_t i;
+    ::memcpy(&i, pCur, 2);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap(&i);
     out->iInt = (int32_t)i;
-    pCur += 2;
     break;
   }
 
   case EDT_Char:
     out->iInt = (int32_t)*((int8_t*)pCur);
-    pCur++;
     break;
 
   case EDT_Float:
   {
-    out->fFloat = *((float*)pCur);
+    ::memcpy(&out->fFloat, pCur, 4);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap((int32_t*)&out->fFloat);
-    pCur += 4;
     break;
   }
   case EDT_Double:
   {
-    out->fDouble = *((double*)pCur);
+    ::memcpy(&out->fDouble, pCur, 8);
 
     // Swap endianness
     if (p_bBE)ByteSwap::Swap((int64_t*)&out->fDouble);
-    pCur += 8;
     break;
   }
   default:
     ret = false;
   }
+  return ret;
+}
 
+// ------------------------------------------------------------------------------------------------
+bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
+  std::vector<char> &buffer,
+  const char* &pCur,
+  unsigned int &bufferSize,
+  PLY::EDataType eType,
+  PLY::PropertyInstance::ValueUnion* out,
+  bool p_bBE)
+{
+  ai_assert(NULL != out);
+
+  //calc element size
+  const unsigned int lsize = GetValueSize(eType);
+
+  //read the next file block if needed
+  if (bufferSize < lsize)
+  {
+    ReadNextBlockBinary(streamBuffer, buffer, pCur, bufferSize);
+  }
+
+  const bool ret = DecodeValueBinary(pCur, eType, out, p_bBE);
+  pCur += lsize;
   bufferSize -= lsize;
 
   return ret;
 }
 
+// ------------------------------------------------------------------------------------------------
+void PLY::PropertyInstance::ReadNextBlockBinary(IOStreamBuffer<char> &streamBuffer,
+  std::vector<char> &buffer,
+  const char* &pCur,
+  unsigned int &bufferSize)
+{
+  std::vector<char> nbuffer;
+  if (streamBuffer.getNextBlock(nbuffer))
+  {
+    //concat buffer contents
+    buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
+    buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
+    nbuffer.clear();
+    bufferSize = static_cast<unsigned int>(buffer.size());
+    pCur = (char*)&buffer[0];
+  }
+  else
+  {
+    throw DeadlyImportError("Invalid .ply file: File corrupted");
+  }
+}
+
 #endif // !! ASSIMP_BUILD_NO_PLY_IMPORTER
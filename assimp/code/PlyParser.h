@@ -293,6 +293,11 @@ public:
     // -------------------------------------------------------------------
     //! Parse a semantic from a string
     static EElementSemantic ParseSemantic(std::vector<char> &buffer);
+
+    // -------------------------------------------------------------------
+    //! Get the size of a binary instance of the element in bytes, or 0
+    //! if the instances vary in size because the element has lists
+    unsigned int GetRecordSizeBinary() const;
 };
 
 // ---------------------------------------------------------------------------------
@@ -353,6 +358,19 @@ public:
     static bool ParseValueBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
         const char* &pCur, unsigned int &bufferSize, EDataType eType, ValueUnion* out, bool p_bBE);
 
+    // -------------------------------------------------------------------
+    //! Decode a binary value from memory holding at least GetValueSize() bytes
+    static bool DecodeValueBinary(const char* pCur, EDataType eType, ValueUnion* out, bool p_bBE);
+
+    // -------------------------------------------------------------------
+    //! Get the size of a binary value in bytes, 0 for invalid types
+    static unsigned int GetValueSize(EDataType eType);
+
+    // -------------------------------------------------------------------
+    //! Append the next file block to the unread part of the buffer
+    static void ReadNextBlockBinary(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+        const char* &pCur, unsigned int &bufferSize);
+
     // -------------------------------------------------------------------
     //! Convert a property value to a given type TYPE
     template <typename TYPE>
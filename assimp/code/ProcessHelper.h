@@ -54,6 +54,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ParsingUtils.h"
 
 #include <list>
+#include <string.h>
 
 // -------------------------------------------------------------------------------
 // Some extensions to std namespace. Mainly std::min and std::max for all
@@ -238,6 +239,36 @@ inline ai_real GetColorDifference( const aiColor4D& pColor1, const aiColor4D& pC
     return c.r*c.r + c.g*c.g + c.b*c.b + c.a*c.a;
 }
 
+// -------------------------------------------------------------------------------
+/** Bit pattern of a vertex component, for hashing. -0 is folded into +0 so
+ *  that equal patterns and operator== agree for everything but NaNs. */
+inline uint64_t ComponentBits( ai_real f )
+{
+    uint64_t bits = 0;
+    if ( f != ai_real( 0 ) ) {
+        ::memcpy( &bits, &f, sizeof( ai_real ) );
+    }
+    return bits;
+}
+
+// -------------------------------------------------------------------------------
+/** Mixes a 64 bit value into a running hash */
+inline uint64_t HashCombine( uint64_t h, uint64_t v )
+{
+    h ^= v;
+    h *= 0xff51afd7ed558ccdULL;
+    return h ^ ( h >> 32 );
+}
+
+// -------------------------------------------------------------------------------
+/** Mixes the components of a vector into a running hash */
+inline uint64_t HashVector( uint64_t h, const aiVector3D& v )
+{
+    h = HashCombine( h, ComponentBits( v.x ) );
+    h = HashCombine( h, ComponentBits( v.y ) );
+    return HashCombine( h, ComponentBits( v.z ) );
+}
+
 
 // -------------------------------------------------------------------------------
 /** @brief Extract single strings from a list of identifiers
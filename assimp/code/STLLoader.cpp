@@ -49,7 +49,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "STLLoader.h"
 #include "ParsingUtils.h"
 #include "fast_atof.h"
+#include "ByteSwapper.h"
 #include <memory>
+#include <algorithm>
 #include <assimp/IOSystem.hpp>
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
@@ -119,6 +121,26 @@ static bool IsAsciiSTL(const char* buffer, unsigned int fileSize) {
     }
     return isASCII;
 }
+
+// Number of facets read from the stream at once by the binary loader
+static const unsigned int FacetsPerBlock = 1u << 14;
+
+// Size of a facet in a binary STL file: normal, 3 positions and the attribute word
+static const unsigned int FacetSize = 50;
+
+// Read a little endian float from a (possibly unaligned) facet record
+inline ai_real ReadFloat(const unsigned char* sz) {
+    float f;
+    ::memcpy(&f, sz, sizeof(float));
+    AI_SWAP4(f);
+    return static_cast<ai_real>(f);
+}
+
+inline void ReadVector(const unsigned char* sz, aiVector3D& v) {
+    v.x = ReadFloat(sz);
+    v.y = ReadFloat(sz + 4);
+    v.z = ReadFloat(sz + 8);
+}
 } // namespace
 
 // ------------------------------------------------------------------------------------------------
@@ -183,14 +205,25 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
     }
 
     fileSize = (unsigned int)file->FileSize();
+    this->pScene = pScene;
+
+    // binary files are identified by their header and streamed facet by facet, there
+    // is no need to keep a copy of the whole file around for them. The padding keeps
+    // the search for the Materialise color within bounds.
+    char header[96] = {};
+    const bool isBinary = fileSize >= 84 && file->Read(header, 1, 84) == 84 &&
+        IsBinarySTL(header, fileSize);
 
-    // allocate storage and copy the contents of the file to a memory buffer
+    // otherwise allocate storage and copy the contents of the file to a memory buffer
     // (terminate it with zero)
     std::vector<char> mBuffer2;
-    TextFileToBuffer(file.get(),mBuffer2);
-
-    this->pScene = pScene;
-    this->mBuffer = &mBuffer2[0];
+    if (isBinary) {
+        this->mBuffer = header;
+    } else {
+        file->Seek(0, aiOrigin_SET);
+        TextFileToBuffer(file.get(),mBuffer2);
+        this->mBuffer = &mBuffer2[0];
+    }
 
     // the default vertex color is light gray.
     clrColorDefault.r = clrColorDefault.g = clrColorDefault.b = clrColorDefault.a = (ai_real) 0.6;
@@ -200,8 +233,8 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
 
     bool bMatClr = false;
 
-    if (IsBinarySTL(mBuffer, fileSize)) {
-        bMatClr = LoadBinaryFile();
+    if (isBinary) {
+        bMatClr = LoadBinaryFile(file.get());
     } else if (IsAsciiSTL(mBuffer, fileSize)) {
         LoadASCIIFile( pScene->mRootNode );
     } else {
@@ -393,7 +426,7 @@ void STLImporter::LoadASCIIFile( aiNode *root ) {
 
 // ------------------------------------------------------------------------------------------------
 // Read a binary STL file
-bool STLImporter::LoadBinaryFile()
+bool STLImporter::LoadBinaryFile(IOStream* stream)
 {
     // allocate one mesh
     pScene->mNumMeshes = 1;
@@ -431,8 +464,10 @@ bool STLImporter::LoadBinaryFile()
     // now read the number of facets
     pScene->mRootNode->mName.Set("<STL_BINARY>");
 
-    pMesh->mNumFaces = *((uint32_t*)sz);
-    sz += 4;
+    uint32_t numFaces;
+    ::memcpy(&numFaces, sz, sizeof(uint32_t));
+    AI_SWAP4(numFaces);
+    pMesh->mNumFaces = numFaces;
 
     if (fileSize < 84 + pMesh->mNumFaces*50) {
         throw DeadlyImportError("STL: file is too small to hold all facets");
@@ -448,58 +483,64 @@ bool STLImporter::LoadBinaryFile()
     vp = pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
     vn = pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
 
-    for (unsigned int i = 0; i < pMesh->mNumFaces;++i) {
-
-        // NOTE: Blender sometimes writes empty normals ... this is not
-        // our fault ... the RemoveInvalidData helper step should fix that
-        *vn = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
-        *(vn+1) = *vn;
-        *(vn+2) = *vn;
-        vn += 3;
-
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
+    // the facets are fixed size records, read them in blocks and unpack each block
+    // straight into the vertex arrays of the mesh
+    std::vector<unsigned char> block(std::min(pMesh->mNumFaces, FacetsPerBlock) * FacetSize);
+    for (unsigned int first = 0; first < pMesh->mNumFaces; first += FacetsPerBlock) {
+        const unsigned int count = std::min(pMesh->mNumFaces - first, FacetsPerBlock);
+        if (stream->Read(&block[0], FacetSize, count) != count) {
+            throw DeadlyImportError("STL: file is too small to hold all facets");
+        }
+        sz = &block[0];
 
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
+        for (unsigned int i = first; i < first + count; ++i, sz += FacetSize) {
 
-        *vp++ = *((aiVector3D*)sz);
-        sz += sizeof(aiVector3D);
+            // NOTE: Blender sometimes writes empty normals ... this is not
+            // our fault ... the RemoveInvalidData helper step should fix that
+            ReadVector(sz, *vn);
+            *(vn+1) = *vn;
+            *(vn+2) = *vn;
+            vn += 3;
 
-        uint16_t color = *((uint16_t*)sz);
-        sz += 2;
+            ReadVector(sz + 12, *vp++);
+            ReadVector(sz + 24, *vp++);
+            ReadVector(sz + 36, *vp++);
 
-        if (color & (1 << 15))
-        {
-            // seems we need to take the color
-            if (!pMesh->mColors[0])
-            {
-                pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
-                for (unsigned int i = 0; i <pMesh->mNumVertices;++i)
-                    *pMesh->mColors[0]++ = this->clrColorDefault;
-                pMesh->mColors[0] -= pMesh->mNumVertices;
+            uint16_t color;
+            ::memcpy(&color, sz + 48, sizeof(uint16_t));
+            AI_SWAP2(color);
 
-                DefaultLogger::get()->info("STL: Mesh has vertex colors");
-            }
-            aiColor4D* clr = &pMesh->mColors[0][i*3];
-            clr->a = 1.0;
-            const ai_real invVal( (ai_real)1.0 / ( ai_real )31.0 );
-            if (bIsMaterialise) // this is reversed
+            if (color & (1 << 15))
             {
-                clr->r = (color & 0x31u) *invVal;
-                clr->g = ((color & (0x31u<<5))>>5u) *invVal;
-                clr->b = ((color & (0x31u<<10))>>10u) *invVal;
-            }
-            else
-            {
-                clr->b = (color & 0x31u) *invVal;
-                clr->g = ((color & (0x31u<<5))>>5u) *invVal;
-                clr->r = ((color & (0x31u<<10))>>10u) *invVal;
+                // seems we need to take the color
+                if (!pMesh->mColors[0])
+                {
+                    pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
+                    for (unsigned int i = 0; i <pMesh->mNumVertices;++i)
+                        *pMesh->mColors[0]++ = this->clrColorDefault;
+                    pMesh->mColors[0] -= pMesh->mNumVertices;
+
+                    DefaultLogger::get()->info("STL: Mesh has vertex colors");
+                }
+                aiColor4D* clr = &pMesh->mColors[0][i*3];
+                clr->a = 1.0;
+                const ai_real invVal( (ai_real)1.0 / ( ai_real )31.0 );
+                if (bIsMaterialise) // this is reversed
+                {
+                    clr->r = (color & 0x31u) *invVal;
+                    clr->g = ((color & (0x31u<<5))>>5u) *invVal;
+                    clr->b = ((color & (0x31u<<10))>>10u) *invVal;
+                }
+                else
+                {
+                    clr->b = (color & 0x31u) *invVal;
+                    clr->g = ((color & (0x31u<<5))>>5u) *invVal;
+                    clr->r = ((color & (0x31u<<10))>>10u) *invVal;
+                }
+                // assign the color to all vertices of the face
+                *(clr+1) = *clr;
+                *(clr+2) = *clr;
             }
-            // assign the color to all vertices of the face
-            *(clr+1) = *clr;
-            *(clr+2) = *clr;
         }
     }
 
@@ -53,6 +53,8 @@ struct aiNode;
 
 namespace Assimp {
 
+class IOStream;
+
 
 // ---------------------------------------------------------------------------
 /**
@@ -92,10 +94,11 @@ protected:
         IOSystem* pIOHandler);
 
     /**
-     * @brief   Loads a binary .stl file
+     * @brief   Loads a binary .stl file. mBuffer holds the 84 byte header, the
+     *  facets are read from the stream behind it.
      * @return true if the default vertex color must be used as material color
      */
-    bool LoadBinaryFile();
+    bool LoadBinaryFile(IOStream* stream);
 
     /**
      * @brief   Loads a ASCII text .stl file
@@ -106,7 +109,7 @@ protected:
 
 protected:
 
-    /** Buffer to hold the loaded file */
+    /** Buffer to hold the loaded file (just the header for binary files) */
     const char* mBuffer;
 
     /** Size of the file, in bytes */
@@ -63,6 +63,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include "PolyTools.h"
 #include <memory>
+#include <algorithm>
 
 //#define AI_BUILD_TRIANGULATE_COLOR_FACE_WINDING
 //#define AI_BUILD_TRIANGULATE_DEBUG_POLYS
@@ -101,14 +102,11 @@ void TriangulateProcess::Execute( aiScene* pScene)
 {
     DefaultLogger::get()->debug("TriangulateProcess begin");
 
-    bool bHas = false;
-    for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-    {
-        if ( TriangulateMesh( pScene->mMeshes[ a ] ) ) {
-            bHas = true;
-        }
-    }
-    if ( bHas ) {
+    std::vector<char> triangulated( pScene->mNumMeshes, 0 );
+    ForEachMesh( pScene, [&]( unsigned int a ) {
+        triangulated[ a ] = TriangulateMesh( pScene->mMeshes[ a ] );
+    } );
+    if ( std::count( triangulated.begin(), triangulated.end(), 1 ) ) {
         DefaultLogger::get()->info( "TriangulateProcess finished. All polygons have been triangulated." );
     } else {
         DefaultLogger::get()->debug( "TriangulateProcess finished. There was nothing to be done." );
@@ -562,6 +562,7 @@ namespace glTF2
 	private:
 
 		shared_ptr<uint8_t> mData; //!< Pointer to the data
+		size_t mCapacity; //!< Allocated size of mData, grows ahead of byteLength when appending
 		bool mIsSpecial; //!< Set to true for special cases (e.g. the body buffer)
 
 		/// \var EncodedRegion_List
@@ -1104,6 +1105,9 @@ namespace glTF2
         //! Main function
         void Load(const std::string& file, bool isBinary = false);
 
+        //! Reads only the asset metadata, without loading any buffers or scenes
+        void LoadMetadata(const std::string& file, bool isBinary = false);
+
         //! Enables binary encoding on the asset
         void SetAsBinary();
 
@@ -1116,6 +1120,8 @@ namespace glTF2
     private:
         void ReadBinaryHeader(IOStream& stream, std::vector<char>& sceneData);
 
+        void ReadSceneData(IOStream& stream, bool isBinary, std::vector<char>& sceneData);
+
         void ReadExtensionsUsed(Document& doc);
 
         IOStream* OpenFile(std::string path, const char* mode, bool absolute = false);
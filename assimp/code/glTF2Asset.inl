@@ -146,6 +146,86 @@ namespace {
         Value::MemberIterator it = val.FindMember(id);
         return (it != val.MemberEnd() && it->value.IsObject()) ? &it->value : 0;
     }
+
+    //
+    // SAX handler that passes only the top level "asset" member on to a document,
+    // as { "asset": ... }, and stops the parser once that member is complete
+    //
+
+    struct AssetMetadataFilter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, AssetMetadataFilter>
+    {
+        Document& doc;
+        unsigned int depth; //!< Nesting level in the parsed document
+        bool isAsset; //!< The next value belongs to the top level "asset" key
+        bool capturing, done;
+
+        AssetMetadataFilter(Document& d)
+            : doc(d), depth(0), isAsset(false), capturing(false), done(false) {}
+
+        //! Starts a value, returns true if it is passed on
+        bool Begin()
+        {
+            if (!capturing && depth == 1 && isAsset) {
+                capturing = true;
+                doc.StartObject();
+                doc.Key("asset", 5, true);
+            }
+            isAsset = false;
+            return capturing;
+        }
+
+        //! Ends a value, returns false to stop the parser after the "asset" member
+        bool End()
+        {
+            if (capturing && depth == 1) {
+                doc.EndObject(1);
+                done = true;
+                return false;
+            }
+            return true;
+        }
+
+        bool Null()                { return !Begin() || (doc.Null() && End()); }
+        bool Bool(bool b)          { return !Begin() || (doc.Bool(b) && End()); }
+        bool Int(int i)            { return !Begin() || (doc.Int(i) && End()); }
+        bool Uint(unsigned u)      { return !Begin() || (doc.Uint(u) && End()); }
+        bool Int64(int64_t i)      { return !Begin() || (doc.Int64(i) && End()); }
+        bool Uint64(uint64_t u)    { return !Begin() || (doc.Uint64(u) && End()); }
+        bool Double(double d)      { return !Begin() || (doc.Double(d) && End()); }
+
+        // strings are copied, the parsed text does not outlive the document
+        bool String(const char* str, rapidjson::SizeType length, bool)
+            { return !Begin() || (doc.String(str, length, true) && End()); }
+
+        bool Key(const char* str, rapidjson::SizeType length, bool)
+        {
+            if (capturing) {
+                return doc.Key(str, length, true);
+            }
+            isAsset = depth == 1 && length == 5 && strncmp(str, "asset", 5) == 0;
+            return true;
+        }
+
+        bool StartObject()
+        {
+            const bool pass = Begin();
+            ++depth;
+            return !pass || doc.StartObject();
+        }
+
+        bool StartArray()
+        {
+            const bool pass = Begin();
+            ++depth;
+            return !pass || doc.StartArray();
+        }
+
+        bool EndObject(rapidjson::SizeType count)
+            { --depth; return !capturing || (doc.EndObject(count) && End()); }
+
+        bool EndArray(rapidjson::SizeType count)
+            { --depth; return !capturing || (doc.EndArray(count) && End()); }
+    };
 }
 
 //
@@ -324,7 +404,7 @@ Ref<T> LazyDict<T>::Create(const char* id)
 
 
 inline Buffer::Buffer()
-	: byteLength(0), type(Type_arraybuffer), EncodedRegion_Current(nullptr), mIsSpecial(false)
+	: byteLength(0), type(Type_arraybuffer), EncodedRegion_Current(nullptr), mCapacity(0), mIsSpecial(false)
 { }
 
 inline Buffer::~Buffer()
@@ -358,6 +438,7 @@ inline void Buffer::Read(Value& obj, Asset& r)
             uint8_t* data = 0;
             this->byteLength = Util::DecodeBase64(dataURI.data, dataURI.dataLength, data);
             this->mData.reset(data, std::default_delete<uint8_t[]>());
+            this->mCapacity = this->byteLength;
 
             if (statedLength > 0 && this->byteLength != statedLength) {
                 throw DeadlyImportError("GLTF: buffer \"" + id + "\", expected " + to_string(statedLength) +
@@ -371,6 +452,7 @@ inline void Buffer::Read(Value& obj, Asset& r)
             }
 
             this->mData.reset(new uint8_t[dataURI.dataLength], std::default_delete<uint8_t[]>());
+            this->mCapacity = dataURI.dataLength;
             memcpy( this->mData.get(), dataURI.data, dataURI.dataLength );
         }
     }
@@ -402,6 +484,7 @@ inline bool Buffer::LoadFromStream(IOStream& stream, size_t length, size_t baseO
     }
 
     mData.reset(new uint8_t[byteLength], std::default_delete<uint8_t[]>());
+    mCapacity = byteLength;
 
     if (stream.Read(mData.get(), byteLength, 1) != 1) {
         return false;
@@ -477,7 +560,7 @@ uint8_t* new_data;
 	memcpy(&new_data[pBufferData_Offset + pReplace_Count], &mData.get()[pBufferData_Offset + pBufferData_Count], pBufferData_Offset);
 	// Apply new data
 	mData.reset(new_data, std::default_delete<uint8_t[]>());
-	byteLength = new_data_size;
+	mCapacity = byteLength = new_data_size;
 
 	return true;
 }
@@ -493,9 +576,14 @@ inline size_t Buffer::AppendData(uint8_t* data, size_t length)
 inline void Buffer::Grow(size_t amount)
 {
     if (amount <= 0) return;
-    uint8_t* b = new uint8_t[byteLength + amount];
-    if (mData) memcpy(b, mData.get(), byteLength);
-    mData.reset(b, std::default_delete<uint8_t[]>());
+    if (byteLength + amount > mCapacity) {
+        // grow geometrically, so appending many small blocks does not copy the buffer each time
+        const size_t capacity = std::max(byteLength + amount, mCapacity + mCapacity / 2);
+        uint8_t* b = new uint8_t[capacity];
+        if (mData) memcpy(b, mData.get(), byteLength);
+        mData.reset(b, std::default_delete<uint8_t[]>());
+        mCapacity = capacity;
+    }
     byteLength += amount;
 }
 
@@ -653,7 +741,13 @@ T Accessor::Indexer::GetValue(int i)
     ai_assert(data);
     ai_assert(i*stride < accessor.bufferView->byteLength);
     T value = T();
-    memcpy(&value, data + i*stride, elemSize);
+    if (elemSize == sizeof(T)) {
+        // a constant size lets the compiler turn the copy into a plain load
+        memcpy(&value, data + i*stride, sizeof(T));
+    }
+    else {
+        memcpy(&value, data + i*stride, elemSize);
+    }
     //value >>= 8 * (sizeof(T) - elemSize);
     return value;
 }
@@ -1105,25 +1199,14 @@ inline void Asset::ReadBinaryHeader(IOStream& stream, std::vector<char>& sceneDa
     }
 }
 
-inline void Asset::Load(const std::string& pFile, bool isBinary)
+inline void Asset::ReadSceneData(IOStream& stream, bool isBinary, std::vector<char>& sceneData)
 {
-    mCurrentAssetDir.clear();
-    int pos = std::max(int(pFile.rfind('/')), int(pFile.rfind('\\')));
-    if (pos != int(std::string::npos)) mCurrentAssetDir = pFile.substr(0, pos + 1);
-
-    shared_ptr<IOStream> stream(OpenFile(pFile.c_str(), "rb", true));
-    if (!stream) {
-        throw DeadlyImportError("GLTF: Could not open file for reading");
-    }
-
     // is binary? then read the header
-    std::vector<char> sceneData;
     if (isBinary) {
-        SetAsBinary(); // also creates the body buffer
-        ReadBinaryHeader(*stream, sceneData);
+        ReadBinaryHeader(stream, sceneData);
     }
     else {
-        mSceneLength = stream->FileSize();
+        mSceneLength = stream.FileSize();
         mBodyLength = 0;
 
 
@@ -1132,10 +1215,29 @@ inline void Asset::Load(const std::string& pFile, bool isBinary)
         sceneData.resize(mSceneLength + 1);
         sceneData[mSceneLength] = '\0';
 
-        if (stream->Read(&sceneData[0], 1, mSceneLength) != mSceneLength) {
+        if (stream.Read(&sceneData[0], 1, mSceneLength) != mSceneLength) {
             throw DeadlyImportError("GLTF: Could not read the file contents");
         }
     }
+}
+
+inline void Asset::Load(const std::string& pFile, bool isBinary)
+{
+    mCurrentAssetDir.clear();
+    int pos = std::max(int(pFile.rfind('/')), int(pFile.rfind('\\')));
+    if (pos != int(std::string::npos)) mCurrentAssetDir = pFile.substr(0, pos + 1);
+
+    shared_ptr<IOStream> stream(OpenFile(pFile.c_str(), "rb", true));
+    if (!stream) {
+        throw DeadlyImportError("GLTF: Could not open file for reading");
+    }
+
+    if (isBinary) {
+        SetAsBinary(); // also creates the body buffer
+    }
+
+    std::vector<char> sceneData;
+    ReadSceneData(*stream, isBinary, sceneData);
 
 
     // parse the JSON document
@@ -1187,6 +1289,37 @@ inline void Asset::Load(const std::string& pFile, bool isBinary)
     }
 }
 
+inline void Asset::LoadMetadata(const std::string& pFile, bool isBinary)
+{
+    shared_ptr<IOStream> stream(OpenFile(pFile.c_str(), "rb", true));
+    if (!stream) {
+        throw DeadlyImportError("GLTF: Could not open file for reading");
+    }
+
+    // the buffers are left alone, so a .glb body is never read
+    std::vector<char> sceneData;
+    ReadSceneData(*stream, isBinary, sceneData);
+
+    // only the "asset" object is kept, and parsing ends right after it
+    struct Generator {
+        char* json;
+        bool operator()(Document& doc) {
+            AssetMetadataFilter filter(doc);
+            rapidjson::InsituStringStream stream(json);
+            rapidjson::Reader().Parse<rapidjson::kParseInsituFlag>(stream, filter);
+            return filter.done;
+        }
+    } generator = { &sceneData[0] };
+
+    Document doc;
+    doc.Populate(generator);
+    if (!doc.IsObject()) {
+        doc.SetObject();
+    }
+
+    asset.Read(doc);
+}
+
 inline void Asset::SetAsBinary()
 {
     if (!mBodyBuffer) {
@@ -1329,11 +1462,12 @@ namespace Util {
     template<bool B>
     struct DATA
     {
-        static const uint8_t tableDecodeBase64[128];
+        static const uint8_t tableDecodeBase64[256];
     };
 
+    // covers every byte value, so characters outside of ASCII cannot index past the end
     template<bool B>
-    const uint8_t DATA<B>::tableDecodeBase64[128] = {
+    const uint8_t DATA<B>::tableDecodeBase64[256] = {
          0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
          0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
          0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 62,  0,  0,  0, 63,
@@ -1341,7 +1475,15 @@ namespace Util {
          0,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
         15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,  0,  0,  0,  0,  0,
          0, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0,  0
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
     };
 
     inline char EncodeCharBase64(uint8_t b)
@@ -1351,13 +1493,7 @@ namespace Util {
 
     inline uint8_t DecodeCharBase64(char c)
     {
-        return DATA<true>::tableDecodeBase64[size_t(c)]; // TODO faster with lookup table or ifs?
-        /*if (c >= 'A' && c <= 'Z') return c - 'A';
-        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
-        if (c >= '0' && c <= '9') return c - '0' + 52;
-        if (c == '+') return 62;
-        if (c == '/') return 63;
-        return 64; // '-' */
+        return DATA<true>::tableDecodeBase64[uint8_t(c)];
     }
 
     inline size_t DecodeBase64(const char* in, size_t inLength, uint8_t*& out)
@@ -1373,20 +1509,20 @@ namespace Util {
                       int(in[inLength - 2] == '=');
 
         size_t outLength = (inLength * 3) / 4 - nEquals;
+        // every byte is written below, the last block included
         out = new uint8_t[outLength];
-        memset(out, 0, outLength);
 
         size_t i, j = 0;
 
         for (i = 0; i + 4 < inLength; i += 4) {
-            uint8_t b0 = DecodeCharBase64(in[i]);
-            uint8_t b1 = DecodeCharBase64(in[i + 1]);
-            uint8_t b2 = DecodeCharBase64(in[i + 2]);
-            uint8_t b3 = DecodeCharBase64(in[i + 3]);
-
-            out[j++] = (uint8_t)((b0 << 2) | (b1 >> 4));
-            out[j++] = (uint8_t)((b1 << 4) | (b2 >> 2));
-            out[j++] = (uint8_t)((b2 << 6) | b3);
+            const uint32_t bits = (uint32_t(DecodeCharBase64(in[i])) << 18) |
+                                  (uint32_t(DecodeCharBase64(in[i + 1])) << 12) |
+                                  (uint32_t(DecodeCharBase64(in[i + 2])) << 6) |
+                                   uint32_t(DecodeCharBase64(in[i + 3]));
+
+            out[j++] = (uint8_t)(bits >> 16);
+            out[j++] = (uint8_t)(bits >> 8);
+            out[j++] = (uint8_t)bits;
         }
 
         {
@@ -109,7 +109,7 @@ bool glTF2Importer::CanRead(const std::string& pFile, IOSystem* pIOHandler, bool
     if (checkSig && pIOHandler) {
         glTF2::Asset asset(pIOHandler);
         try {
-            asset.Load(pFile, extension == "glb");
+            asset.LoadMetadata(pFile, extension == "glb");
             std::string version = asset.asset.version;
             return !version.empty() && version[0] == '2';
         } catch (...) {
@@ -367,24 +367,24 @@ void glTF2Importer::ImportMeshes(glTF2::Asset& r)
 
                 // only extract tangents if normals are present
                 if (attr.tangent.size() > 0 && attr.tangent[0]) {
-                    // generate bitangents from normals and tangents according to spec
+                    // generate bitangents from normals and tangents according to spec,
+                    // reading the tangents in place instead of copying them out first
                     struct Tangent
                     {
-                        aiVector3D xyz;
-                        ai_real w;
-                    } *tangents = nullptr;
-
-                    attr.tangent[0]->ExtractData(tangents);
-
-                    aim->mTangents = new aiVector3D[aim->mNumVertices];
-                    aim->mBitangents = new aiVector3D[aim->mNumVertices];
-
-                    for (unsigned int i = 0; i < aim->mNumVertices; ++i) {
-                        aim->mTangents[i] = tangents[i].xyz;
-                        aim->mBitangents[i] = (aim->mNormals[i] ^ tangents[i].xyz) * tangents[i].w;
+                        ai_real x, y, z, w;
+                    };
+
+                    Accessor::Indexer tangents = attr.tangent[0]->GetIndexer();
+                    if (tangents.IsValid()) {
+                        aim->mTangents = new aiVector3D[aim->mNumVertices];
+                        aim->mBitangents = new aiVector3D[aim->mNumVertices];
+
+                        for (unsigned int i = 0; i < aim->mNumVertices; ++i) {
+                            const Tangent tangent = tangents.GetValue<Tangent>(i);
+                            aim->mTangents[i] = aiVector3D(tangent.x, tangent.y, tangent.z);
+                            aim->mBitangents[i] = (aim->mNormals[i] ^ aim->mTangents[i]) * tangent.w;
+                        }
                     }
-
-                    delete tangents;
                 }
             }
 
@@ -662,22 +662,24 @@ void glTF2Importer::InternReadFile(const std::string& pFile, aiScene* pScene, IO
 
     this->mScene = pScene;
 
-    // read the asset file
-    glTF2::Asset asset(pIOHandler);
-    asset.Load(pFile, GetExtension(pFile) == "glb");
+    {
+        // read the asset file
+        glTF2::Asset asset(pIOHandler);
+        asset.Load(pFile, GetExtension(pFile) == "glb");
 
-    //
-    // Copy the data out
-    //
+        //
+        // Copy the data out
+        //
 
-    ImportEmbeddedTextures(asset);
-    ImportMaterials(asset);
+        ImportEmbeddedTextures(asset);
+        ImportMaterials(asset);
 
-    ImportMeshes(asset);
+        ImportMeshes(asset);
 
-    ImportCameras(asset);
+        ImportCameras(asset);
 
-    ImportNodes(asset);
+        ImportNodes(asset);
+    } // the file contents are released before the meshes are expanded below
 
     // TODO: it does not split the loaded vertices, should it?
     //pScene->mFlags |= AI_SCENE_FLAGS_NON_VERBOSE_FORMAT;
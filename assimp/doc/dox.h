@@ -1340,7 +1340,23 @@ with 'slow' file formats like X or Collada might scale well with multiple concur
 
 @section automt Internal threading
 
-Internal multi-threading is not currently implemented.
+#Assimp::BatchLoader, which importers use to load the external files a scene references (IRR, LWS,
+multipart MD3), loads them in parallel, each with its own #Assimp::Importer. The number of threads
+follows #AI_CONFIG_GLOB_MULTITHREADING. Results do not depend on the number of threads.
+
+The OBJ importer parses files of a few MB and more in line aligned chunks, one thread each. Vertex
+data and faces are read in parallel, all other statements in file order once the chunks are joined.
+The first part of a file with other statements (lines, points, continued lines) and everything after
+it is parsed serially. The binary FBX importer inflates the compressed arrays of a geometry in parallel.
+The Collada importer parses <tt>float_array</tt> elements of a MB and more in ranges, one thread each.
+
+#aiProcess_JoinIdenticalVertices and #aiProcess_FindInstances always process the meshes of a scene
+in parallel. The steps which work on each mesh on its own (normals, tangents, triangulation,
+degenerate and invalid data removal, bone weight limiting and cache locality optimization) do so
+only if #AI_CONFIG_PP_PARALLEL_MESHES is set. Their output is identical to a serial run; only log messages from different meshes may
+interleave. Progress is still reported from the thread which called ReadFile().
+
+Building with <tt>ASSIMP_BUILD_SINGLETHREADED</tt> removes all internal threading.
 */
 
 /**
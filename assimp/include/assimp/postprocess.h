@@ -89,6 +89,8 @@ enum aiPostProcessSteps
      * indexed geometry, this step is compulsory or you'll just waste rendering
      * time. <b>If this flag is not specified</b>, no vertices are referenced by
      * more than one face and <b>no index buffer is required</b> for rendering.
+     * The importer property <tt>#AI_CONFIG_PP_JIV_EPSILON</tt> allows joining
+     * vertices whose positions are close, but not identical.
      */
     aiProcess_JoinIdenticalVertices = 0x2,
 
@@ -420,7 +422,8 @@ enum aiPostProcessSteps
     /** <hr>This step searches for duplicate meshes and replaces them
      *  with references to the first mesh.
      *
-     *  This step takes a while, so don't use it if speed is a concern.
+     *  Only meshes with bitwise identical vertex data are joined. Meshes
+     *  that differ by rounding errors are kept as they are.
      *  Its main purpose is to workaround the fact that many export
      *  file formats don't support instanced meshes, so exporters need to
      *  duplicate meshes. This step removes the duplicates again. Please
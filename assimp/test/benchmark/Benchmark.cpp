@@ -0,0 +1,705 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  Benchmark.cpp
+ *  @brief Import benchmark over a corpus of models, with timings per import
+ *    phase and per post processing step, peak memory and JSON results.
+ */
+
+#include <assimp/Importer.hpp>
+#include <assimp/Exporter.hpp>
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/LogStream.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <assimp/version.h>
+#include <assimp/config.h>
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#   include <malloc.h>
+#endif
+
+const char* AIBENCH_MSG_HELP =
+"assimp_benchmark [options] [files]\n\n"
+" Imports every model of the corpus and reports the time spent per import\n"
+" phase and per post processing step, plus the peak memory of each import.\n\n"
+" options:\n"
+" \t--corpus <list>      Models to import, one path per line, '#' starts a comment.\n"
+" \t                     Relative paths are looked up in the models directory.\n"
+" \t                     Defaults to the corpus.txt next to this tool's sources.\n"
+" \t--no-corpus          Only import the files given on the command line\n"
+" \t--models-dir <dir>   Directory for relative corpus paths (default: test/models)\n"
+" \t--generate <n>       Also export a grid of n x n quads to every format the\n"
+" \t                     exporters support and import it again (default: 256, 0: off)\n"
+" \t--work-dir <dir>     Where the generated models are written, created if it\n"
+" \t                     does not exist (default: .)\n"
+" \t--steps <preset>     Post processing: none, fast, quality, maxquality or a\n"
+" \t                     hexadecimal aiProcess mask (default: quality)\n"
+" \t--threads <n>        Value for AI_CONFIG_GLOB_MULTITHREADING (default: -1, auto)\n"
+" \t--repeat <n>         Import each model n times and keep the fastest run\n"
+" \t--json <file>        Write the results as JSON\n"
+" \t--compare <file>     Compare against the JSON results of an earlier run\n"
+" \t--max-regression <p> With --compare: fail when a model is more than p percent slower\n\n"
+" The post processing steps are applied one at a time, in the order the\n"
+" importer runs them, so each gets its own timing. Data the steps share\n"
+" within one pass (e.g. the spatial sort) is built again for every step.\n";
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// ------------------------------------------------------------------------------
+// Post processing steps in the order the importer runs them. Both halves of
+// aiProcess_SplitLargeMeshes run together after the vertices are joined.
+struct PostProcessStep {
+    unsigned int flag;
+    const char* name;
+};
+
+const PostProcessStep PostProcessSteps[] = {
+    { aiProcess_ValidateDataStructure,    "ValidateDataStructure" },
+    { aiProcess_MakeLeftHanded,           "MakeLeftHanded" },
+    { aiProcess_FlipUVs,                  "FlipUVs" },
+    { aiProcess_FlipWindingOrder,         "FlipWindingOrder" },
+    { aiProcess_RemoveComponent,          "RemoveComponent" },
+    { aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials" },
+    { aiProcess_FindInstances,            "FindInstances" },
+    { aiProcess_OptimizeGraph,            "OptimizeGraph" },
+    { aiProcess_FindDegenerates,          "FindDegenerates" },
+    { aiProcess_GenUVCoords,              "GenUVCoords" },
+    { aiProcess_TransformUVCoords,        "TransformUVCoords" },
+    { aiProcess_PreTransformVertices,     "PreTransformVertices" },
+    { aiProcess_Triangulate,              "Triangulate" },
+    { aiProcess_SortByPType,              "SortByPType" },
+    { aiProcess_FindInvalidData,          "FindInvalidData" },
+    { aiProcess_OptimizeMeshes,           "OptimizeMeshes" },
+    { aiProcess_FixInfacingNormals,       "FixInfacingNormals" },
+    { aiProcess_SplitByBoneCount,         "SplitByBoneCount" },
+    { aiProcess_GenNormals,               "GenNormals" },
+    { aiProcess_GenSmoothNormals,         "GenSmoothNormals" },
+    { aiProcess_CalcTangentSpace,         "CalcTangentSpace" },
+    { aiProcess_JoinIdenticalVertices,    "JoinIdenticalVertices" },
+    { aiProcess_SplitLargeMeshes,         "SplitLargeMeshes" },
+    { aiProcess_Debone,                   "Debone" },
+    { aiProcess_LimitBoneWeights,         "LimitBoneWeights" },
+    { aiProcess_ImproveCacheLocality,     "ImproveCacheLocality" },
+};
+
+// ------------------------------------------------------------------------------
+// Formats the grid is exported to, with the extension their importer expects
+struct GeneratedFormat {
+    const char* exporter;
+    const char* extension;
+};
+
+const GeneratedFormat GeneratedFormats[] = {
+    { "obj",     "obj" },
+    { "ply",     "ply" },
+    { "plyb",    "ply" },
+    { "stl",     "stl" },
+    { "stlb",    "stl" },
+    { "collada", "dae" },
+    { "x",       "x" },
+    { "3ds",     "3ds" },
+    { "gltf2",   "gltf" },
+    { "assbin",  "assbin" },
+};
+
+// ------------------------------------------------------------------------------
+struct Result {
+    std::string name;   //!< Corpus entry or generated model, used to match runs
+    std::string path;
+    std::string importer;
+    std::string error;
+    unsigned long long size;
+    bool ok;
+
+    // seconds
+    double total, detect, import, preprocess;
+    std::vector<std::pair<std::string, double> > steps;
+
+    double peakMemory;  //!< MB above the resident size before the import, < 0 if unknown
+    unsigned int meshes, vertices, faces;
+
+    Result() : size(0), ok(false), total(0), detect(0), import(0), preprocess(0),
+        peakMemory(-1), meshes(0), vertices(0), faces(0) {}
+};
+
+// ------------------------------------------------------------------------------
+// Collects the regions the importer's profiler writes to the log when
+// AI_CONFIG_GLOB_MEASURE_TIME is set: "END   `import`, dt= 0.5 s", and the
+// name of the importer ReadFile picked.
+class ProfilerStream : public Assimp::LogStream {
+public:
+    std::map<std::string, double> regions;
+    std::string importer;
+
+    void write(const char* message) {
+        static const char* found = "Found a matching importer for this file format: ";
+        if (const char* name = strstr(message, found)) {
+            name += strlen(found);
+            importer = std::string(name, name + strcspn(name, "\r\n"));
+            if (!importer.empty() && importer[importer.size() - 1] == '.') {
+                importer.erase(importer.size() - 1);
+            }
+            return;
+        }
+
+        const char* region = strstr(message, "END   `");
+        if (!region) {
+            return;
+        }
+        region += 7;
+        const char* end = strchr(region, '`');
+        const char* dt = end ? strstr(end, "dt= ") : NULL;
+        if (dt) {
+            regions[std::string(region, end)] = atof(dt + 4);
+        }
+    }
+};
+
+// ------------------------------------------------------------------------------
+// Remembers every file the exporters write, so companions (.mtl, .bin) are removed too
+class RecordingIOSystem : public Assimp::DefaultIOSystem {
+public:
+    std::vector<std::string>* written;
+
+    explicit RecordingIOSystem(std::vector<std::string>* w) : written(w) {}
+
+    Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") {
+        Assimp::IOStream* stream = DefaultIOSystem::Open(pFile, pMode);
+        if (stream && strchr(pMode, 'w')) {
+            written->push_back(pFile);
+        }
+        return stream;
+    }
+};
+
+#ifdef __linux__
+// ------------------------------------------------------------------------------
+// Resets the peak resident set size of the process
+void ResetPeakMemory() {
+#ifdef __GLIBC__
+    // hand freed memory back first, or the next import reuses it without
+    // the resident size growing
+    malloc_trim(0);
+#endif
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// ------------------------------------------------------------------------------
+// Peak resident set size in MB since the last reset
+double PeakMemoryMB() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return atof(line.c_str() + 6) / 1024.0;
+        }
+    }
+    return -1.0;
+}
+#else
+void ResetPeakMemory() {}
+double PeakMemoryMB() { return -1.0; }
+#endif
+
+// ------------------------------------------------------------------------------
+double Seconds(const Clock::time_point& start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// ------------------------------------------------------------------------------
+// Creates the work dir if it does not exist and checks that files can be written there
+bool PrepareWorkDir(const std::string& dir) {
+    Assimp::DefaultIOSystem io;
+    if (!io.Exists(dir.c_str())) {
+        io.CreateDirectory(dir);
+    }
+    const std::string probe = dir + "/assimp_benchmark.tmp";
+    Assimp::IOStream* stream = io.Open(probe.c_str(), "wb");
+    if (!stream) {
+        return false;
+    }
+    io.Close(stream);
+    remove(probe.c_str());
+    return true;
+}
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+// ------------------------------------------------------------------------------
+bool IsExporterAvailable(const Assimp::Exporter& exporter, const char* id) {
+    for (size_t i = 0; i < exporter.GetExportFormatCount(); ++i) {
+        if (!strcmp(exporter.GetExportFormatDescription(i)->id, id)) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// ------------------------------------------------------------------------------
+bool ParseSteps(const std::string& preset, unsigned int& flags) {
+    if (preset == "none") {
+        flags = 0;
+    } else if (preset == "fast") {
+        flags = aiProcessPreset_TargetRealtime_Fast;
+    } else if (preset == "quality") {
+        flags = aiProcessPreset_TargetRealtime_Quality;
+    } else if (preset == "maxquality") {
+        flags = aiProcessPreset_TargetRealtime_MaxQuality;
+    } else {
+        char* end = NULL;
+        flags = static_cast<unsigned int>(strtoul(preset.c_str(), &end, 16));
+        return end && !*end && !preset.empty();
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// Reads a corpus list, relative entries are resolved against modelsDir
+bool ReadCorpus(const std::string& list, const std::string& modelsDir,
+        std::vector<std::pair<std::string, std::string> >& files) {
+    std::ifstream in(list.c_str());
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        const std::string::size_type first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+        const bool absolute = line[0] == '/' || line[0] == '\\' || (line.size() > 1 && line[1] == ':');
+        files.push_back(std::make_pair(line, absolute ? line : modelsDir + "/" + line));
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------
+// A wavy grid of size x size quads, split into triangles, with texture
+// coordinates but without normals, so the pipeline has to generate them.
+aiScene* CreateGrid(unsigned int size) {
+    aiScene* scene = new aiScene();
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial*[1];
+    scene->mMaterials[0] = new aiMaterial();
+
+    aiMesh* mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = (size + 1) * (size + 1);
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    mesh->mNumUVComponents[0] = 2;
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const float x = static_cast<float>(i % (size + 1)), y = static_cast<float>(i / (size + 1));
+        mesh->mVertices[i] = aiVector3D(x, y, std::sin(x * 0.1f) * std::cos(y * 0.1f));
+        mesh->mTextureCoords[0][i] = aiVector3D(x / size, y / size, 0.f);
+    }
+
+    mesh->mNumFaces = size * size * 2;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    for (unsigned int q = 0; q < size * size; ++q) {
+        const unsigned int v = q / size * (size + 1) + q % size;
+        const unsigned int indices[] = { v, v + 1, v + size + 2, v, v + size + 2, v + size + 1 };
+        for (unsigned int f = 0; f < 2; ++f) {
+            aiFace& face = mesh->mFaces[q * 2 + f];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3];
+            std::copy(indices + f * 3, indices + f * 3 + 3, face.mIndices);
+        }
+    }
+
+    scene->mNumMeshes = 1;
+    scene->mMeshes = new aiMesh*[1];
+    scene->mMeshes[0] = mesh;
+
+    scene->mRootNode = new aiNode("grid");
+    scene->mRootNode->mNumMeshes = 1;
+    scene->mRootNode->mMeshes = new unsigned int[1];
+    scene->mRootNode->mMeshes[0] = 0;
+    return scene;
+}
+
+// ------------------------------------------------------------------------------
+// Imports one model and applies the post processing steps one at a time
+Result Run(const std::string& name, const std::string& path, unsigned int flags, int threads,
+        ProfilerStream& profiler) {
+    Result result;
+    result.name = name;
+    result.path = path;
+    {
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        result.size = file ? static_cast<unsigned long long>(file.tellg()) : 0;
+    }
+
+    ResetPeakMemory();
+    const double baseMemory = PeakMemoryMB();
+    {
+        Assimp::Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME, 1);
+        importer.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, threads);
+
+        profiler.regions.clear();
+        profiler.importer = "unknown";
+        Clock::time_point start = Clock::now();
+        const aiScene* scene = importer.ReadFile(path, 0);
+        result.total = Seconds(start);
+        result.importer = profiler.importer;
+        if (!scene) {
+            result.error = importer.GetErrorString();
+            return result;
+        }
+
+        // what ReadFile spends outside of the importer and the preprocessor is
+        // mostly the search for a matching importer
+        result.import = profiler.regions["import"];
+        result.preprocess = profiler.regions["preprocess"];
+        result.detect = std::max(0.0, profiler.regions["total"] - result.import - result.preprocess);
+
+        unsigned int remaining = flags;
+        for (size_t i = 0; i < sizeof(PostProcessSteps) / sizeof(PostProcessSteps[0]) && scene; ++i) {
+            const PostProcessStep& step = PostProcessSteps[i];
+            if (flags & step.flag) {
+                start = Clock::now();
+                scene = importer.ApplyPostProcessing(step.flag);
+                result.steps.push_back(std::make_pair(std::string(step.name), Seconds(start)));
+                remaining &= ~step.flag;
+            }
+        }
+        if (remaining && scene) {
+            start = Clock::now();
+            scene = importer.ApplyPostProcessing(remaining);
+            result.steps.push_back(std::make_pair(std::string("Other"), Seconds(start)));
+        }
+        for (size_t i = 0; i < result.steps.size(); ++i) {
+            result.total += result.steps[i].second;
+        }
+        if (!scene) {
+            result.error = importer.GetErrorString();
+            return result;
+        }
+
+        result.meshes = scene->mNumMeshes;
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            result.vertices += scene->mMeshes[i]->mNumVertices;
+            result.faces += scene->mMeshes[i]->mNumFaces;
+        }
+        result.ok = true;
+    }
+    const double peakMemory = PeakMemoryMB();
+    result.peakMemory = peakMemory < 0.0 ? -1.0 : peakMemory - baseMemory;
+    return result;
+}
+
+// ------------------------------------------------------------------------------
+std::string JsonString(const std::string& in) {
+    std::string out = "\"";
+    for (size_t i = 0; i < in.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(in[i]);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += in[i];
+        } else if (c < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            out += buffer;
+        } else {
+            out += in[i];
+        }
+    }
+    return out + "\"";
+}
+
+// ------------------------------------------------------------------------------
+bool WriteJson(const std::string& path, const std::vector<Result>& results, unsigned int flags, int threads) {
+    std::ofstream out(path.c_str());
+    if (!out) {
+        return false;
+    }
+
+    out.precision(6);
+    out << "{\n  \"assimp\": \"" << aiGetVersionMajor() << "." << aiGetVersionMinor() << "."
+        << aiGetVersionRevision() << "\",\n  \"postprocess\": " << flags << ",\n  \"threads\": " << threads
+        << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n") << "    { \"name\": " << JsonString(r.name) << ", \"importer\": " << JsonString(r.importer)
+            << ", \"size\": " << r.size << ", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.ok) {
+            out << ", \"error\": " << JsonString(r.error);
+        }
+        out << ",\n      \"total\": " << r.total << ", \"detect\": " << r.detect << ", \"import\": " << r.import
+            << ", \"preprocess\": " << r.preprocess << ", \"peak_memory_mb\": " << r.peakMemory
+            << ",\n      \"meshes\": " << r.meshes << ", \"vertices\": " << r.vertices << ", \"faces\": " << r.faces
+            << ",\n      \"steps\": {";
+        for (size_t s = 0; s < r.steps.size(); ++s) {
+            out << (s ? ", " : " ") << JsonString(r.steps[s].first) << ": " << r.steps[s].second;
+        }
+        out << (r.steps.empty() ? "} }" : " } }");
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
+
+// ------------------------------------------------------------------------------
+// Prints the change against an earlier run, returns false if a model got slower
+// than maxRegression percent allows
+bool Compare(const std::string& path, const std::vector<Result>& results, double maxRegression) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        printf("assimp_benchmark: unable to open %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    rapidjson::Document doc;
+    doc.Parse(text.str().c_str());
+    if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("results") || !doc["results"].IsArray()) {
+        printf("assimp_benchmark: %s does not hold benchmark results\n", path.c_str());
+        return false;
+    }
+
+    std::map<std::string, std::pair<double, double> > baseline;
+    const rapidjson::Value& list = doc["results"];
+    for (rapidjson::SizeType i = 0; i < list.Size(); ++i) {
+        const rapidjson::Value& r = list[i];
+        if (r.IsObject() && r.HasMember("name") && r["name"].IsString() && r.HasMember("ok") && r["ok"].IsTrue() &&
+                r.HasMember("total") && r["total"].IsNumber() && r.HasMember("peak_memory_mb") && r["peak_memory_mb"].IsNumber()) {
+            baseline[r["name"].GetString()] = std::make_pair(r["total"].GetDouble(), r["peak_memory_mb"].GetDouble());
+        }
+    }
+
+    printf("\n%-56s %10s %10s %8s %12s\n", "compared to baseline", "before", "after", "change", "memory");
+    bool passed = true;
+    double logSum = 0.0;
+    unsigned int count = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::map<std::string, std::pair<double, double> >::const_iterator it = baseline.find(r.name);
+        if (!r.ok || it == baseline.end() || it->second.first <= 0.0 || r.total <= 0.0) {
+            continue;
+        }
+
+        const double change = (r.total / it->second.first - 1.0) * 100.0;
+        const bool regressed = maxRegression >= 0.0 && change > maxRegression;
+        printf("%-56s %9.3fs %9.3fs %+7.1f%% %+10.1fMB%s\n", r.name.c_str(), it->second.first, r.total, change,
+            r.peakMemory - it->second.second, regressed ? "  REGRESSION" : "");
+        passed = passed && !regressed;
+        logSum += std::log(r.total / it->second.first);
+        ++count;
+    }
+    if (count) {
+        printf("geometric mean of %u models: %+.1f%%\n", count, (std::exp(logSum / count) - 1.0) * 100.0);
+    }
+    return passed;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------
+// Application entry point
+int main(int argc, char* argv[]) {
+    std::string corpus = ASSIMP_BENCHMARK_CORPUS, modelsDir = ASSIMP_TEST_MODELS_DIR, workDir = ".";
+    std::string jsonFile, compareFile;
+    std::vector<std::pair<std::string, std::string> > files;
+    unsigned int flags = aiProcessPreset_TargetRealtime_Quality, gridSize = 256, repeat = 1;
+    int threads = -1;
+    double maxRegression = -1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") {
+            printf("%s", AIBENCH_MSG_HELP);
+            return 0;
+        } else if (arg == "--no-corpus") {
+            corpus.clear();
+        } else if (arg == "--corpus" && hasValue) {
+            corpus = argv[++i];
+        } else if (arg == "--models-dir" && hasValue) {
+            modelsDir = argv[++i];
+        } else if (arg == "--generate" && hasValue) {
+            gridSize = static_cast<unsigned int>(atoi(argv[++i]));
+        } else if (arg == "--work-dir" && hasValue) {
+            workDir = argv[++i];
+        } else if (arg == "--steps" && hasValue) {
+            if (!ParseSteps(argv[++i], flags)) {
+                printf("assimp_benchmark: unknown post processing preset %s\n", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--threads" && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            jsonFile = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            compareFile = argv[++i];
+        } else if (arg == "--max-regression" && hasValue) {
+            maxRegression = atof(argv[++i]);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            printf("assimp_benchmark: unknown option %s, see --help\n", arg.c_str());
+            return 1;
+        } else {
+            files.push_back(std::make_pair(arg, arg));
+        }
+    }
+
+    if (!corpus.empty() && !ReadCorpus(corpus, modelsDir, files)) {
+        printf("assimp_benchmark: unable to read the corpus list %s\n", corpus.c_str());
+        return 1;
+    }
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+    if (gridSize > 0 && !PrepareWorkDir(workDir)) {
+        printf("assimp_benchmark: unable to write to the work directory %s\n", workDir.c_str());
+        return 1;
+    }
+#endif
+
+    // only the profiler output is collected, nothing goes to the console or a file
+    ProfilerStream* profiler = new ProfilerStream();
+    Assimp::DefaultLogger::create("", Assimp::Logger::VERBOSE, 0);
+    Assimp::DefaultLogger::get()->attachStream(profiler, Assimp::Logger::Debugging | Assimp::Logger::Info);
+
+    // export the grid to every generated format up front
+    std::vector<std::string> written;
+    bool ok = true;
+#ifndef ASSIMP_BUILD_NO_EXPORT
+    if (gridSize > 0) {
+        aiScene* grid = CreateGrid(gridSize);
+        Assimp::Exporter exporter;
+        exporter.SetIOHandler(new RecordingIOSystem(&written));
+        for (size_t i = 0; i < sizeof(GeneratedFormats) / sizeof(GeneratedFormats[0]); ++i) {
+            const GeneratedFormat& format = GeneratedFormats[i];
+            std::ostringstream name;
+            name << "grid" << gridSize << "_" << format.exporter << "." << format.extension;
+            const std::string path = workDir + "/" + name.str();
+            if (exporter.Export(grid, format.exporter, path) == AI_SUCCESS) {
+                files.push_back(std::make_pair("generated/" + name.str(), path));
+            } else {
+                // an exporter that is not built in is expected, anything else is an error
+                const bool available = IsExporterAvailable(exporter, format.exporter);
+                printf("assimp_benchmark: %s %s, %s\n", available ? "unable to export" : "skipping",
+                    name.str().c_str(), exporter.GetErrorString());
+                ok = ok && !available;
+            }
+        }
+        delete grid;
+    }
+#endif
+
+    printf("%-56s %-12s %9s %8s %8s %8s %8s %8s %8s\n", "model", "importer", "KB", "total", "detect", "import",
+        "preproc", "steps", "peak MB");
+
+    std::vector<Result> results;
+    std::map<std::string, double> stepTotals;
+    for (size_t i = 0; i < files.size(); ++i) {
+        Result best;
+        for (unsigned int run = 0; run < repeat; ++run) {
+            Result result = Run(files[i].first, files[i].second, flags, threads, *profiler);
+            if (run == 0 || (result.ok && (!best.ok || result.total < best.total))) {
+                best = result;
+            }
+        }
+
+        const Result& r = best;
+        if (r.ok) {
+            double steps = 0.0;
+            for (size_t s = 0; s < r.steps.size(); ++s) {
+                steps += r.steps[s].second;
+                stepTotals[r.steps[s].first] += r.steps[s].second;
+            }
+            printf("%-56s %-12.12s %9.0f %8.3f %8.3f %8.3f %8.3f %8.3f %8.1f\n", r.name.c_str(), r.importer.c_str(),
+                r.size / 1024.0, r.total, r.detect, r.import, r.preprocess, steps, r.peakMemory);
+        } else {
+            printf("%-56s %-12.12s failed: %s\n", r.name.c_str(), r.importer.c_str(), r.error.c_str());
+            ok = false;
+        }
+        results.push_back(best);
+    }
+
+    if (!stepTotals.empty()) {
+        printf("\n%-56s %8s\n", "post processing step", "total");
+        for (size_t i = 0; i < sizeof(PostProcessSteps) / sizeof(PostProcessSteps[0]); ++i) {
+            std::map<std::string, double>::const_iterator it = stepTotals.find(PostProcessSteps[i].name);
+            if (it != stepTotals.end()) {
+                printf("%-56s %8.3f\n", it->first.c_str(), it->second);
+            }
+        }
+    }
+
+    Assimp::DefaultLogger::kill();
+    for (size_t i = 0; i < written.size(); ++i) {
+        remove(written[i].c_str());
+    }
+
+    if (!jsonFile.empty() && !WriteJson(jsonFile, results, flags, threads)) {
+        printf("assimp_benchmark: unable to write %s\n", jsonFile.c_str());
+        return 1;
+    }
+    if (!compareFile.empty() && !Compare(compareFile, results, maxRegression)) {
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
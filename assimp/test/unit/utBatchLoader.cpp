@@ -42,6 +42,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 #include "Importer.h"
 #include "TestIOSystem.h"
+#include "SceneDiffer.h"
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
 
 using namespace ::Assimp;
 
@@ -78,3 +83,84 @@ TEST_F( BatchLoaderTest, validateAccessTest ) {
     BatchLoader loader2( m_io, true );
     EXPECT_TRUE( loader2.getValidation() );
 }
+
+TEST_F( BatchLoaderTest, numThreadsAccessTest ) {
+    BatchLoader loader( m_io );
+    EXPECT_EQ( -1, loader.getNumThreads() );
+    loader.setNumThreads( 4 );
+    EXPECT_EQ( 4, loader.getNumThreads() );
+}
+
+static const char *BatchFiles[] = {
+    ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj",
+    ASSIMP_TEST_MODELS_DIR "/PLY/cube.ply",
+    ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl",
+    ASSIMP_TEST_MODELS_DIR "/AC/Wuson.ac",
+    ASSIMP_TEST_MODELS_DIR "/Collada/duck.dae",
+    ASSIMP_TEST_MODELS_DIR "/3DS/fels.3ds",
+    ASSIMP_TEST_MODELS_DIR "/OBJ/box.obj",
+    ASSIMP_TEST_MODELS_DIR "/PLY/Wuson.ply",
+};
+static const size_t NumBatchFiles = sizeof( BatchFiles ) / sizeof( BatchFiles[ 0 ] );
+
+static void loadBatch( IOSystem *io, int threads, std::vector<aiScene*> &scenes ) {
+    BatchLoader loader( io, true );
+    loader.setNumThreads( threads );
+
+    std::vector<unsigned int> ids;
+    for ( size_t i = 0; i < NumBatchFiles; ++i ) {
+        ids.push_back( loader.AddLoadRequest( BatchFiles[ i ], aiProcess_Triangulate | aiProcess_JoinIdenticalVertices ) );
+    }
+    loader.LoadAll();
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        scenes.push_back( loader.GetImport( ids[ i ] ) );
+    }
+}
+
+TEST_F( BatchLoaderTest, parallelMatchesSerialTest ) {
+    DefaultIOSystem io;
+    std::vector<aiScene*> serial, parallel;
+    loadBatch( &io, 0, serial );
+    loadBatch( &io, 4, parallel );
+
+    ASSERT_EQ( NumBatchFiles, serial.size() );
+    ASSERT_EQ( NumBatchFiles, parallel.size() );
+    for ( size_t i = 0; i < NumBatchFiles; ++i ) {
+        ASSERT_NE( nullptr, serial[ i ] ) << BatchFiles[ i ];
+        ASSERT_NE( nullptr, parallel[ i ] ) << BatchFiles[ i ];
+
+        SceneDiffer differ;
+        EXPECT_TRUE( differ.isEqual( serial[ i ], parallel[ i ] ) ) << BatchFiles[ i ];
+        differ.showReport();
+    }
+
+    // and every request got its own file
+    Importer importer;
+    const aiScene *direct = importer.ReadFile( BatchFiles[ 1 ], aiProcess_Triangulate | aiProcess_JoinIdenticalVertices );
+    ASSERT_NE( nullptr, direct );
+    SceneDiffer differ;
+    EXPECT_TRUE( differ.isEqual( direct, parallel[ 1 ] ) );
+
+    for ( size_t i = 0; i < NumBatchFiles; ++i ) {
+        delete serial[ i ];
+        delete parallel[ i ];
+    }
+}
+
+TEST_F( BatchLoaderTest, irrExternalFilesParallelTest ) {
+    const char *file = ASSIMP_TEST_MODELS_DIR "/IRR/dawfInCellar_SameHierarchy.irr";
+
+    Importer serialImporter;
+    serialImporter.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    const aiScene *serial = serialImporter.ReadFile( file, aiProcess_ValidateDataStructure );
+    ASSERT_NE( nullptr, serial );
+
+    Importer parallelImporter;
+    parallelImporter.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    const aiScene *parallel = parallelImporter.ReadFile( file, aiProcess_ValidateDataStructure );
+    ASSERT_NE( nullptr, parallel );
+
+    SceneDiffer differ;
+    EXPECT_TRUE( differ.isEqual( serial, parallel ) );
+    differ.showReport();
+}
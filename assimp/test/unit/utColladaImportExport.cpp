@@ -44,9 +44,67 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <fast_atof.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
 
 using namespace Assimp;
 
+namespace {
+
+// Numerals the float array parser has to read exactly like fast_atof
+const char *Numerals[] = {
+    "0", "-0", "+1.5", ".25", "-.75", "7", "3,5", "1e-3", "1E+10", "-2.5e2", "4.2E-05",
+    "123456789.123456789", "0.000001", "1e-30", "-98765.4321", "inf", "-Infinity"
+};
+const size_t NumNumerals = sizeof( Numerals ) / sizeof( Numerals[ 0 ] );
+const char *Separators[] = { " ", "\n", "\t", "  ", "\r\n" };
+
+// A single triangle list whose positions cycle through Numerals, numVertices
+// has to be a multiple of three. insert is placed in front of the values.
+std::string CreateColladaTriangles( unsigned int numVertices, const std::string &insert = std::string() ) {
+    std::string values = insert;
+    size_t numValues = std::count( insert.begin(), insert.end(), ' ' );
+    for ( unsigned int i = 0; numValues < numVertices * 3; ++i, ++numValues ) {
+        values += Numerals[ i % NumNumerals ];
+        values += Separators[ i % 5 ];
+    }
+
+    std::string indices;
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        indices += std::to_string( i ) + " ";
+    }
+
+    return "<?xml version=\"1.0\"?>\n"
+        "<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+        "<library_geometries><geometry id=\"mesh\"><mesh>\n"
+        "<source id=\"positions\"><float_array id=\"positions-array\" count=\"" + std::to_string( numVertices * 3 ) + "\">" +
+        values + "</float_array>\n"
+        "<technique_common><accessor source=\"#positions-array\" count=\"" + std::to_string( numVertices ) + "\" stride=\"3\">"
+        "<param name=\"X\" type=\"float\"/><param name=\"Y\" type=\"float\"/><param name=\"Z\" type=\"float\"/>"
+        "</accessor></technique_common></source>\n"
+        "<vertices id=\"vertices\"><input semantic=\"POSITION\" source=\"#positions\"/></vertices>\n"
+        "<triangles count=\"" + std::to_string( numVertices / 3 ) + "\"><input semantic=\"VERTEX\" source=\"#vertices\" offset=\"0\"/>"
+        "<p>" + indices + "</p></triangles>\n"
+        "</mesh></geometry></library_geometries>\n"
+        "<library_visual_scenes><visual_scene id=\"scene\"><node id=\"node\"><instance_geometry url=\"#mesh\"/></node>"
+        "</visual_scene></library_visual_scenes>\n"
+        "<scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+        "</COLLADA>\n";
+}
+
+const aiMesh *ImportColladaMesh( Assimp::Importer &importer, const std::string &dae, int threads ) {
+    importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, threads );
+    const aiScene *scene = importer.ReadFileFromMemory( dae.c_str(), dae.size(), 0, "dae" );
+    return scene && scene->mNumMeshes == 1 ? scene->mMeshes[ 0 ] : nullptr;
+}
+
+} // namespace
+
 class utColladaImportExport : public AbstractImportExportBase {
 public:
     virtual bool importerTest() {
@@ -59,3 +117,61 @@ public:
 TEST_F( utColladaImportExport, importBlenFromFileTest ) {
     EXPECT_TRUE( importerTest() );
 }
+
+TEST_F( utColladaImportExport, parallelFloatArrayTest ) {
+    // several MB of text to have the float array parsed in ranges
+    const unsigned int numVertices = 3 * 60000;
+    const std::string dae = CreateColladaTriangles( numVertices );
+
+    Assimp::Importer serialImporter, parallelImporter;
+    const aiMesh *serial = ImportColladaMesh( serialImporter, dae, 0 );
+    const aiMesh *parallel = ImportColladaMesh( parallelImporter, dae, 4 );
+    ASSERT_NE( nullptr, serial );
+    ASSERT_NE( nullptr, parallel );
+    ASSERT_EQ( numVertices, serial->mNumVertices );
+    ASSERT_EQ( numVertices, parallel->mNumVertices );
+
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        for ( unsigned int k = 0; k < 3; ++k ) {
+            const ai_real expected = fast_atof( Numerals[ ( i * 3 + k ) % NumNumerals ] );
+            ASSERT_EQ( expected, serial->mVertices[ i ][ k ] );
+            ASSERT_EQ( expected, parallel->mVertices[ i ][ k ] );
+        }
+    }
+}
+
+TEST_F( utColladaImportExport, parallelFloatArrayFallbackTest ) {
+    // the serial parser reads two values from "1.5-2", the parallel one leaves such arrays to it
+    const unsigned int numVertices = 3 * 60000;
+    const std::string dae = CreateColladaTriangles( numVertices, "1.5-2 " );
+
+    Assimp::Importer serialImporter, parallelImporter;
+    const aiMesh *serial = ImportColladaMesh( serialImporter, dae, 0 );
+    const aiMesh *parallel = ImportColladaMesh( parallelImporter, dae, 4 );
+    ASSERT_NE( nullptr, serial );
+    ASSERT_NE( nullptr, parallel );
+    ASSERT_EQ( serial->mNumVertices, parallel->mNumVertices );
+    EXPECT_EQ( ai_real( 1.5 ), parallel->mVertices[ 0 ].x );
+    EXPECT_EQ( ai_real( -2 ), parallel->mVertices[ 0 ].y );
+    for ( unsigned int i = 0; i < serial->mNumVertices; ++i ) {
+        ASSERT_EQ( serial->mVertices[ i ], parallel->mVertices[ i ] );
+    }
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utColladaImportExport, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+    const unsigned int numVertices = 3 * 1000000;
+    const std::string dae = CreateColladaTriangles( numVertices );
+
+    double seconds[ 2 ];
+    for ( int parallel = 0; parallel < 2; ++parallel ) {
+        Assimp::Importer importer;
+        const Clock::time_point start = Clock::now();
+        ASSERT_NE( nullptr, ImportColladaMesh( importer, dae, parallel ? -1 : 0 ) );
+        seconds[ parallel ] = std::chrono::duration<double>( Clock::now() - start ).count();
+    }
+    printf( "%.1f MB, %u floats: serial %.3fs, parallel on %u threads %.3fs\n",
+        dae.size() / ( 1024.0 * 1024.0 ), numVertices * 3, seconds[ 0 ],
+        std::max( 1u, std::thread::hardware_concurrency() ), seconds[ 1 ] );
+}
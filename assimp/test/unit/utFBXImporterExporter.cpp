@@ -46,6 +46,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <FBXTokenizer.h>
+#include <FBXParser.h>
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+#ifdef __linux__
+#   include <sys/resource.h>
+#endif
 
 using namespace Assimp;
 
@@ -61,3 +74,343 @@ public:
 TEST_F( utFBXImporterExporter, importXFromFileTest ) {
     EXPECT_TRUE( importerTest() );
 }
+
+// ------------------------------------------------------------------------------------------------
+// Writes binary FBX 7.4 records, just enough for a document with meshes
+class BinaryFbxWriter {
+public:
+    BinaryFbxWriter() {
+        static const char Magic[] = "Kaydara FBX Binary  \0\x1a\0";
+        data.insert( data.end(), Magic, Magic + sizeof( Magic ) - 1 );
+        put32( 7400 );
+    }
+
+    void begin( const char* name ) {
+        if ( !nodes.empty() && !nodes.back().children ) {
+            endProperties( nodes.back() );
+        }
+        Node node = { data.size(), 0, 0, false };
+        put32( 0 );
+        put32( 0 );
+        put32( 0 );
+        data.push_back( static_cast<char>( strlen( name ) ) );
+        data.insert( data.end(), name, name + strlen( name ) );
+        node.props = data.size();
+        nodes.push_back( node );
+    }
+
+    void end() {
+        Node& node = nodes.back();
+        if ( node.children ) {
+            data.insert( data.end(), 13, '\0' );
+        } else {
+            endProperties( node );
+        }
+        patch32( node.start, static_cast<uint32_t>( data.size() ) );
+        nodes.pop_back();
+    }
+
+    void int32( int32_t v ) {
+        data.push_back( 'I' );
+        put32( static_cast<uint32_t>( v ) );
+        ++nodes.back().count;
+    }
+
+    void int64( int64_t v ) {
+        data.push_back( 'L' );
+        put32( static_cast<uint32_t>( v ) );
+        put32( static_cast<uint32_t>( static_cast<uint64_t>( v ) >> 32 ) );
+        ++nodes.back().count;
+    }
+
+    void float64( double v ) {
+        uint64_t bits;
+        memcpy( &bits, &v, sizeof( bits ) );
+        data.push_back( 'D' );
+        put32( static_cast<uint32_t>( bits ) );
+        put32( static_cast<uint32_t>( bits >> 32 ) );
+        ++nodes.back().count;
+    }
+
+    void string( const std::string& s ) {
+        data.push_back( 'S' );
+        put32( static_cast<uint32_t>( s.size() ) );
+        data.insert( data.end(), s.begin(), s.end() );
+        ++nodes.back().count;
+    }
+
+    template <typename T>
+    void array( char type, const std::vector<T>& values ) {
+        uLongf length = compressBound( static_cast<uLong>( values.size() * sizeof( T ) ) );
+        std::vector<Bytef> packed( length );
+        compress( packed.data(), &length, reinterpret_cast<const Bytef*>( values.data() ),
+            static_cast<uLong>( values.size() * sizeof( T ) ) );
+        data.push_back( type );
+        put32( static_cast<uint32_t>( values.size() ) );
+        put32( 1 );
+        put32( static_cast<uint32_t>( length ) );
+        data.insert( data.end(), packed.begin(), packed.begin() + length );
+        ++nodes.back().count;
+    }
+
+    // an element with a single string or integer value
+    void element( const char* name, const std::string& value ) {
+        begin( name );
+        string( value );
+        end();
+    }
+
+    void element( const char* name, int32_t value ) {
+        begin( name );
+        int32( value );
+        end();
+    }
+
+    std::vector<char>& finish() {
+        data.insert( data.end(), 13, '\0' );
+        return data;
+    }
+
+private:
+    struct Node {
+        size_t start, props;
+        uint32_t count;
+        bool children;
+    };
+
+    void endProperties( Node& node ) {
+        patch32( node.start + 4, node.count );
+        patch32( node.start + 8, static_cast<uint32_t>( data.size() - node.props ) );
+        node.children = true;
+    }
+
+    void put32( uint32_t v ) {
+        for ( int i = 0; i < 4; ++i ) {
+            data.push_back( static_cast<char>( v >> ( i * 8 ) ) );
+        }
+    }
+
+    void patch32( size_t at, uint32_t v ) {
+        for ( int i = 0; i < 4; ++i ) {
+            data[ at + i ] = static_cast<char>( v >> ( i * 8 ) );
+        }
+    }
+
+    std::vector<char> data;
+    std::vector<Node> nodes;
+};
+
+// ------------------------------------------------------------------------------------------------
+// A binary FBX file with 'meshes' wavy grids of size x size quads, each with
+// per polygon vertex normals and indexed UVs. All arrays are compressed. There
+// are 'nodes' more models without geometry, each with a few properties, for
+// lots of small tokens.
+static std::vector<char> CreateBinaryFbx( unsigned int meshes, unsigned int size, unsigned int nodes = 0 ) {
+    BinaryFbxWriter fbx;
+    fbx.begin( "FBXHeaderExtension" );
+    fbx.element( "FBXVersion", 7400 );
+    fbx.end();
+
+    fbx.begin( "Objects" );
+    for ( unsigned int m = 0; m < meshes; ++m ) {
+        const std::string name = "Grid" + std::to_string( m );
+        const unsigned int row = size + 1;
+        std::vector<double> vertices, normals, uvs;
+        std::vector<int32_t> indices, uvIndices;
+        for ( unsigned int y = 0; y <= size; ++y ) {
+            for ( unsigned int x = 0; x <= size; ++x ) {
+                const double h = sin( x * 0.1 + m ) * cos( y * 0.07 );
+                const double v[] = { double( x ), double( y ), h };
+                const double uv[] = { x / double( size ), y / double( size ) };
+                vertices.insert( vertices.end(), v, v + 3 );
+                uvs.insert( uvs.end(), uv, uv + 2 );
+            }
+        }
+        for ( unsigned int y = 0; y < size; ++y ) {
+            for ( unsigned int x = 0; x < size; ++x ) {
+                const int32_t i = y * row + x;
+                const int32_t quad[] = { i, i + 1, i + 1 + static_cast<int32_t>( row ), i + static_cast<int32_t>( row ) };
+                for ( int c = 0; c < 4; ++c ) {
+                    indices.push_back( c == 3 ? -quad[ c ] - 1 : quad[ c ] );
+                    uvIndices.push_back( quad[ c ] );
+                    const double dx = -cos( x * 0.1 + m ) * 0.1 * cos( y * 0.07 );
+                    const double dy = sin( x * 0.1 + m ) * sin( y * 0.07 ) * 0.07;
+                    const double len = sqrt( dx * dx + dy * dy + 1.0 );
+                    const double n[] = { dx / len, dy / len, 1.0 / len };
+                    normals.insert( normals.end(), n, n + 3 );
+                }
+            }
+        }
+
+        fbx.begin( "Geometry" );
+        fbx.int64( 1000 + m );
+        fbx.string( name + std::string( "\0\1Geometry", 10 ) );
+        fbx.string( "Mesh" );
+        fbx.begin( "Vertices" );
+        fbx.array( 'd', vertices );
+        fbx.end();
+        fbx.begin( "PolygonVertexIndex" );
+        fbx.array( 'i', indices );
+        fbx.end();
+        fbx.begin( "LayerElementNormal" );
+        fbx.int32( 0 );
+        fbx.element( "MappingInformationType", "ByPolygonVertex" );
+        fbx.element( "ReferenceInformationType", "Direct" );
+        fbx.begin( "Normals" );
+        fbx.array( 'd', normals );
+        fbx.end();
+        fbx.end();
+        fbx.begin( "LayerElementUV" );
+        fbx.int32( 0 );
+        fbx.element( "MappingInformationType", "ByPolygonVertex" );
+        fbx.element( "ReferenceInformationType", "IndexToDirect" );
+        fbx.begin( "UV" );
+        fbx.array( 'd', uvs );
+        fbx.end();
+        fbx.begin( "UVIndex" );
+        fbx.array( 'i', uvIndices );
+        fbx.end();
+        fbx.end();
+        fbx.begin( "Layer" );
+        fbx.int32( 0 );
+        fbx.begin( "LayerElement" );
+        fbx.element( "Type", "LayerElementNormal" );
+        fbx.element( "TypedIndex", 0 );
+        fbx.end();
+        fbx.begin( "LayerElement" );
+        fbx.element( "Type", "LayerElementUV" );
+        fbx.element( "TypedIndex", 0 );
+        fbx.end();
+        fbx.end();
+        fbx.end();
+
+        fbx.begin( "Model" );
+        fbx.int64( 2000 + m );
+        fbx.string( name + std::string( "\0\1Model", 7 ) );
+        fbx.string( "Mesh" );
+        fbx.element( "Version", 232 );
+        fbx.end();
+    }
+    for ( unsigned int n = 0; n < nodes; ++n ) {
+        static const char* Properties[] = {
+            "Lcl Translation", "Lcl Rotation", "Lcl Scaling", "RotationPivot", "ScalingPivot"
+        };
+        fbx.begin( "Model" );
+        fbx.int64( 3000 + n );
+        fbx.string( "Node" + std::to_string( n ) + std::string( "\0\1Model", 7 ) );
+        fbx.string( "Null" );
+        fbx.element( "Version", 232 );
+        fbx.begin( "Properties70" );
+        for ( unsigned int p = 0; p < 5; ++p ) {
+            fbx.begin( "P" );
+            fbx.string( Properties[ p ] );
+            fbx.string( Properties[ p ] );
+            fbx.string( "" );
+            fbx.string( "A" );
+            fbx.float64( p == 2 ? 1.0 : n * 0.5 );
+            fbx.float64( p == 2 ? 1.0 : p );
+            fbx.float64( p == 2 ? 1.0 : 0.0 );
+            fbx.end();
+        }
+        fbx.end();
+        fbx.end();
+    }
+    fbx.end();
+
+    fbx.begin( "Connections" );
+    for ( unsigned int m = 0; m < meshes; ++m ) {
+        fbx.begin( "C" );
+        fbx.string( "OO" );
+        fbx.int64( 1000 + m );
+        fbx.int64( 2000 + m );
+        fbx.end();
+        fbx.begin( "C" );
+        fbx.string( "OO" );
+        fbx.int64( 2000 + m );
+        fbx.int64( 0 );
+        fbx.end();
+    }
+    for ( unsigned int n = 0; n < nodes; ++n ) {
+        fbx.begin( "C" );
+        fbx.string( "OO" );
+        fbx.int64( 3000 + n );
+        fbx.int64( n ? 3000 + ( n - 1 ) / 4 : 0 );
+        fbx.end();
+    }
+    fbx.end();
+    return fbx.finish();
+}
+
+TEST_F( utFBXImporterExporter, importBinaryParallelTest ) {
+    const std::vector<char> fbx = CreateBinaryFbx( 3, 128, 100 );
+    Importer serial, parallel;
+    serial.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    parallel.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    const aiScene *expected = serial.ReadFileFromMemory( fbx.data(), fbx.size(), aiProcess_ValidateDataStructure, "fbx" );
+    const aiScene *actual = parallel.ReadFileFromMemory( fbx.data(), fbx.size(), aiProcess_ValidateDataStructure, "fbx" );
+    ASSERT_NE( nullptr, expected );
+    ASSERT_NE( nullptr, actual );
+
+    ASSERT_EQ( 3u, actual->mNumMeshes );
+    const aiMesh *mesh = actual->mMeshes[ 0 ];
+    EXPECT_EQ( 128u * 128u * 4u, mesh->mNumVertices );
+    ASSERT_TRUE( mesh->HasNormals() );
+    ASSERT_TRUE( mesh->HasTextureCoords( 0 ) );
+    EXPECT_FLOAT_EQ( 1.f, mesh->mTextureCoords[ 0 ][ mesh->mNumVertices - 2 ].x );
+
+    SceneDiffer differ;
+    EXPECT_TRUE( differ.isEqual( expected, actual ) );
+    differ.showReport();
+
+    Importer spider;
+    spider.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    expected = serial.ReadFile( ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx", aiProcess_ValidateDataStructure );
+    actual = spider.ReadFile( ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx", aiProcess_ValidateDataStructure );
+    ASSERT_NE( nullptr, expected );
+    ASSERT_NE( nullptr, actual );
+    EXPECT_TRUE( differ.isEqual( expected, actual ) );
+}
+
+// ------------------------------------------------------------------------------------------------
+// Timing of the FBX importer on a generated binary file of a few hundred MB.
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utFBXImporterExporter, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+    const std::vector<char> fbx = CreateBinaryFbx( 32, 320, 100000 );
+
+    // best of three runs each
+    double tokenize = 1e9, parse = 1e9;
+    size_t numTokens = 0;
+    Clock::time_point start;
+    for ( int run = 0; run < 3; ++run ) {
+        start = Clock::now();
+        FBX::TokenArena tokens;
+        FBX::TokenizeBinary( tokens, fbx.data(), static_cast<unsigned int>( fbx.size() ) );
+        tokenize = std::min( tokenize, std::chrono::duration<double>( Clock::now() - start ).count() );
+
+        start = Clock::now();
+        {
+            FBX::Parser parser( tokens, true );
+        }
+        parse = std::min( parse, std::chrono::duration<double>( Clock::now() - start ).count() );
+        numTokens = tokens.size();
+    }
+
+    double import[ 2 ];
+    for ( int parallel = 0; parallel < 2; ++parallel ) {
+        Importer importer;
+        importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, parallel ? -1 : 0 );
+        start = Clock::now();
+        ASSERT_NE( nullptr, importer.ReadFileFromMemory( fbx.data(), fbx.size(), 0, "fbx" ) );
+        import[ parallel ] = std::chrono::duration<double>( Clock::now() - start ).count();
+    }
+
+    printf( "%.1f MB, %u tokens: tokenize %.3fs, parse %.3fs, import serial %.3fs, parallel on %u threads %.3fs\n",
+        fbx.size() / 1048576.0, static_cast<unsigned int>( numTokens ), tokenize, parse,
+        import[ 0 ], std::thread::hardware_concurrency(), import[ 1 ] );
+#ifdef __linux__
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    printf( "peak RSS %.1f MB\n", usage.ru_maxrss / 1024.0 );
+#endif
+}
@@ -0,0 +1,189 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include <assimp/scene.h>
+#include <FindInstancesProcess.h>
+#include <chrono>
+#include <thread>
+
+using namespace Assimp;
+
+class FindInstancesTest : public ::testing::Test
+{
+public:
+    virtual void SetUp();
+    virtual void TearDown();
+
+protected:
+    FindInstancesProcess* piProcess;
+};
+
+// ------------------------------------------------------------------------------------------------
+void FindInstancesTest::SetUp()
+{
+    piProcess = new FindInstancesProcess();
+}
+
+// ------------------------------------------------------------------------------------------------
+void FindInstancesTest::TearDown()
+{
+    delete piProcess;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A box of 12 triangles in verbose format, with normals and UVs. Boxes of
+// different shapes differ in size.
+static aiMesh* CreateBox( unsigned int shape )
+{
+    static const float Corners[ 8 ][ 3 ] = {
+        { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+        { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 }
+    };
+    static const unsigned int Triangles[ 12 ][ 3 ] = {
+        { 0, 2, 1 }, { 0, 3, 2 }, { 4, 5, 6 }, { 4, 6, 7 },
+        { 0, 1, 5 }, { 0, 5, 4 }, { 3, 6, 2 }, { 3, 7, 6 },
+        { 0, 4, 7 }, { 0, 7, 3 }, { 1, 2, 6 }, { 1, 6, 5 }
+    };
+    const aiVector3D size( 1.f + shape, 1.f + shape * 0.5f, 1.f );
+
+    aiMesh* mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = 36;
+    mesh->mVertices = new aiVector3D[ 36 ];
+    mesh->mNormals = new aiVector3D[ 36 ];
+    mesh->mTextureCoords[ 0 ] = new aiVector3D[ 36 ];
+    mesh->mNumUVComponents[ 0 ] = 2;
+    mesh->mNumFaces = 12;
+    mesh->mFaces = new aiFace[ 12 ];
+    for ( unsigned int f = 0, p = 0; f < 12; ++f ) {
+        aiFace& face = mesh->mFaces[ f ];
+        face.mIndices = new unsigned int[ face.mNumIndices = 3 ];
+        for ( unsigned int a = 0; a < 3; ++a, ++p ) {
+            const float* c = Corners[ Triangles[ f ][ a ] ];
+            mesh->mVertices[ p ] = aiVector3D( c[ 0 ] * size.x, c[ 1 ] * size.y, c[ 2 ] * size.z );
+            mesh->mNormals[ p ] = aiVector3D( 0.f, 0.f, f < 2 ? -1.f : 1.f );
+            mesh->mTextureCoords[ 0 ][ p ] = aiVector3D( c[ 0 ], c[ 1 ], 0.f );
+            face.mIndices[ a ] = p;
+        }
+    }
+    return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A scene with one node per mesh, where mesh i is a box of shape i % numShapes
+static aiScene* CreateScene( unsigned int numMeshes, unsigned int numShapes )
+{
+    aiScene* scene = new aiScene();
+    scene->mNumMeshes = numMeshes;
+    scene->mMeshes = new aiMesh*[ numMeshes ];
+    scene->mRootNode = new aiNode();
+    scene->mRootNode->mNumChildren = numMeshes;
+    scene->mRootNode->mChildren = new aiNode*[ numMeshes ];
+    for ( unsigned int i = 0; i < numMeshes; ++i ) {
+        scene->mMeshes[ i ] = CreateBox( i % numShapes );
+        aiNode* node = scene->mRootNode->mChildren[ i ] = new aiNode();
+        node->mParent = scene->mRootNode;
+        node->mNumMeshes = 1;
+        node->mMeshes = new unsigned int[ 1 ];
+        node->mMeshes[ 0 ] = i;
+    }
+    return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(FindInstancesTest, testInstancesFound)
+{
+    std::unique_ptr<aiScene> scene( CreateScene( 12, 3 ) );
+    piProcess->Execute( scene.get() );
+
+    ASSERT_EQ( 3U, scene->mNumMeshes );
+    for ( unsigned int i = 0; i < 12; ++i ) {
+        EXPECT_EQ( i % 3, scene->mRootNode->mChildren[ i ]->mMeshes[ 0 ] );
+    }
+    for ( unsigned int i = 0; i < 3; ++i ) {
+        std::unique_ptr<aiMesh> box( CreateBox( i ) );
+        EXPECT_EQ( box->mVertices[ 35 ], scene->mMeshes[ i ]->mVertices[ 35 ] );
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(FindInstancesTest, testWindingIgnored)
+{
+    std::unique_ptr<aiScene> scene( CreateScene( 2, 1 ) );
+    for ( unsigned int f = 0; f < 12; ++f ) {
+        std::swap( scene->mMeshes[ 1 ]->mFaces[ f ].mIndices[ 0 ], scene->mMeshes[ 1 ]->mFaces[ f ].mIndices[ 2 ] );
+    }
+    piProcess->Execute( scene.get() );
+    EXPECT_EQ( 1U, scene->mNumMeshes );
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(FindInstancesTest, testDifferentMeshesKept)
+{
+    std::unique_ptr<aiScene> scene( CreateScene( 4, 1 ) );
+    scene->mMeshes[ 1 ]->mVertices[ 7 ].z += 0.5f;
+    scene->mMeshes[ 2 ]->mNormals[ 30 ].x = 1.f;
+    scene->mMeshes[ 3 ]->mMaterialIndex = 1;
+    piProcess->Execute( scene.get() );
+
+    ASSERT_EQ( 4U, scene->mNumMeshes );
+    for ( unsigned int i = 0; i < 4; ++i ) {
+        EXPECT_EQ( i, scene->mRootNode->mChildren[ i ]->mMeshes[ 0 ] );
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Timing of the step on 50k small meshes, which are instances of 500 shapes.
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F(FindInstancesTest, DISABLED_Benchmark)
+{
+    typedef std::chrono::steady_clock Clock;
+    std::unique_ptr<aiScene> scene( CreateScene( 50000, 500 ) );
+
+    const Clock::time_point start = Clock::now();
+    piProcess->Execute( scene.get() );
+    const double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    EXPECT_EQ( 500U, scene->mNumMeshes );
+
+    printf( "50000 meshes, 500 shapes: %.3fs on %u threads\n", seconds, std::thread::hardware_concurrency() );
+}
@@ -42,7 +42,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 
 #include <assimp/scene.h>
+#include <assimp/Importer.hpp>
 #include <JoinVerticesProcess.h>
+#include <ProcessHelper.h>
+#include <SpatialSort.h>
+#include <Vertex.h>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 
 using namespace std;
@@ -142,3 +149,228 @@ TEST_F(JoinVerticesTest, testProcess)
     EXPECT_EQ(150.f*299.f*3.f, fSum); // gaussian sum equation
 }
 
+// ------------------------------------------------------------------------------------------------
+// The SpatialSort based implementation the step used before, as a reference.
+// Returns for each vertex the index of the unique vertex it is replaced by and
+// fills 'sources' with the vertex each unique vertex was taken from.
+static std::vector<unsigned int> ReferenceJoin( const aiMesh* mesh, std::vector<unsigned int>& sources )
+{
+    const ai_real squareEpsilon = ai_real( 1e-5 ) * ai_real( 1e-5 );
+    SpatialSort finder( mesh->mVertices, mesh->mNumVertices, sizeof( aiVector3D ) );
+    std::vector<Vertex> uniques;
+    std::vector<unsigned int> replace( mesh->mNumVertices, 0xffffffff );
+    std::vector<unsigned int> found;
+    std::vector<unsigned int> remap( mesh->mNumVertices );
+    sources.clear();
+    for ( unsigned int a = 0; a < mesh->mNumVertices; ++a ) {
+        const Vertex v( mesh, a );
+        finder.FindIdenticalPositions( v.position, found );
+        unsigned int match = 0xffffffff;
+        for ( size_t b = 0; b < found.size() && match == 0xffffffff; ++b ) {
+            const unsigned int uidx = replace[ found[ b ] ];
+            if ( uidx & 0x80000000 ) {
+                continue;
+            }
+            const Vertex& uv = uniques[ uidx ];
+            bool same = !( ( uv.normal - v.normal ).SquareLength() > squareEpsilon ) &&
+                !( ( uv.tangent - v.tangent ).SquareLength() > squareEpsilon ) &&
+                !( ( uv.bitangent - v.bitangent ).SquareLength() > squareEpsilon );
+            for ( unsigned int i = 0; same && i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i ) {
+                same = !( ( uv.texcoords[ i ] - v.texcoords[ i ] ).SquareLength() > squareEpsilon );
+            }
+            for ( unsigned int i = 0; same && i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i ) {
+                same = !( GetColorDifference( uv.colors[ i ], v.colors[ i ] ) > squareEpsilon );
+            }
+            if ( same ) {
+                match = uidx;
+            }
+        }
+        if ( match != 0xffffffff ) {
+            replace[ a ] = match | 0x80000000;
+            remap[ a ] = match;
+        } else {
+            replace[ a ] = remap[ a ] = (unsigned int)uniques.size();
+            uniques.push_back( v );
+            sources.push_back( a );
+        }
+    }
+    return remap;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A mesh in verbose format with 'copies' copies of each of 'count' vertices in random
+// order. Every fourth copy has its normal moved by less than the step's tolerance, and
+// groups of four vertices share their position but not their normal.
+static aiMesh* CreateRedundantMesh( unsigned int count, unsigned int copies )
+{
+    unsigned int seed = 12345;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return ( seed >> 8 ) / (float)( 1 << 24 );
+    };
+
+    std::vector<aiVector3D> positions( count ), normals( count ), uvs( count );
+    for ( unsigned int i = 0; i < count; ++i ) {
+        if ( i % 4 == 0 ) {
+            positions[ i ] = aiVector3D( random(), random(), random() ) * 100.f;
+        } else {
+            positions[ i ] = positions[ i - 1 ];
+        }
+        normals[ i ] = aiVector3D( (float)( i % 4 ), random(), 1.f ).Normalize();
+        uvs[ i ] = aiVector3D( random(), random(), 0.f );
+    }
+
+    const unsigned int numVertices = ( count * copies + 2 ) / 3 * 3;
+    std::vector<unsigned int> order( numVertices );
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        order[ i ] = i % count;
+    }
+    for ( unsigned int i = numVertices - 1; i > 0; --i ) {
+        std::swap( order[ i ], order[ (unsigned int)( random() * i ) ] );
+    }
+
+    aiMesh* mesh = new aiMesh();
+    mesh->mNumVertices = numVertices;
+    mesh->mVertices = new aiVector3D[ numVertices ];
+    mesh->mNormals = new aiVector3D[ numVertices ];
+    mesh->mTextureCoords[ 0 ] = new aiVector3D[ numVertices ];
+    mesh->mNumUVComponents[ 0 ] = 2;
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        mesh->mVertices[ i ] = positions[ order[ i ] ];
+        mesh->mNormals[ i ] = normals[ order[ i ] ];
+        if ( i % 4 == 3 ) {
+            mesh->mNormals[ i ].y += 1e-7f;
+        }
+        mesh->mTextureCoords[ 0 ][ i ] = uvs[ order[ i ] ];
+    }
+
+    mesh->mNumFaces = numVertices / 3;
+    mesh->mFaces = new aiFace[ mesh->mNumFaces ];
+    for ( unsigned int i = 0, p = 0; i < mesh->mNumFaces; ++i ) {
+        aiFace& face = mesh->mFaces[ i ];
+        face.mIndices = new unsigned int[ face.mNumIndices = 3 ];
+        for ( unsigned int a = 0; a < 3; ++a ) {
+            face.mIndices[ a ] = p++;
+        }
+    }
+    return mesh;
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(JoinVerticesTest, testMatchesReference)
+{
+    std::unique_ptr<aiMesh> mesh( CreateRedundantMesh( 5000, 4 ) );
+    std::vector<unsigned int> sources;
+    const std::vector<unsigned int> remap = ReferenceJoin( mesh.get(), sources );
+    ASSERT_EQ( 5000U, sources.size() );
+
+    std::unique_ptr<aiMesh> original( CreateRedundantMesh( 5000, 4 ) );
+    piProcess->ProcessMesh( mesh.get(), 0 );
+
+    ASSERT_EQ( sources.size(), mesh->mNumVertices );
+    for ( unsigned int i = 0; i < mesh->mNumVertices; ++i ) {
+        EXPECT_EQ( original->mVertices[ sources[ i ] ], mesh->mVertices[ i ] );
+        EXPECT_EQ( original->mNormals[ sources[ i ] ], mesh->mNormals[ i ] );
+        EXPECT_EQ( original->mTextureCoords[ 0 ][ sources[ i ] ], mesh->mTextureCoords[ 0 ][ i ] );
+    }
+    for ( unsigned int i = 0; i < mesh->mNumFaces; ++i ) {
+        for ( unsigned int a = 0; a < 3; ++a ) {
+            EXPECT_EQ( remap[ original->mFaces[ i ].mIndices[ a ] ], mesh->mFaces[ i ].mIndices[ a ] );
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(JoinVerticesTest, testPositionEpsilon)
+{
+    // move the copies of the first 100 vertices a bit
+    for ( unsigned int i = 300; i < 400; ++i ) {
+        pcMesh->mVertices[ i ].x += 0.001f;
+    }
+    Importer importer;
+    importer.SetPropertyFloat( AI_CONFIG_PP_JIV_EPSILON, 0.01f );
+    piProcess->SetupProperties( &importer );
+    piProcess->ProcessMesh( pcMesh, 0 );
+
+    // vertices 1 apart are still distinct
+    ASSERT_EQ( 300U, pcMesh->mNumVertices );
+    for ( unsigned int i = 0; i < 300; ++i ) {
+        EXPECT_EQ( aiVector3D( (float)i ), pcMesh->mVertices[ i ] );
+    }
+    EXPECT_EQ( 0U, pcMesh->mFaces[ 100 ].mIndices[ 0 ] );
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(JoinVerticesTest, testExecuteParallel)
+{
+    aiScene serial, parallel;
+    serial.mNumMeshes = parallel.mNumMeshes = 8;
+    serial.mMeshes = new aiMesh*[ 8 ];
+    parallel.mMeshes = new aiMesh*[ 8 ];
+    for ( unsigned int i = 0; i < 8; ++i ) {
+        serial.mMeshes[ i ] = CreateRedundantMesh( 4000 + i * 1000, 3 );
+        parallel.mMeshes[ i ] = CreateRedundantMesh( 4000 + i * 1000, 3 );
+    }
+
+    Importer importer;
+    importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    piProcess->SetupProperties( &importer );
+    piProcess->Execute( &serial );
+    importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    piProcess->SetupProperties( &importer );
+    piProcess->Execute( &parallel );
+
+    for ( unsigned int i = 0; i < 8; ++i ) {
+        const aiMesh* a = serial.mMeshes[ i ];
+        const aiMesh* b = parallel.mMeshes[ i ];
+        ASSERT_EQ( a->mNumVertices, b->mNumVertices );
+        EXPECT_EQ( 0, memcmp( a->mVertices, b->mVertices, a->mNumVertices * sizeof( aiVector3D ) ) );
+        EXPECT_EQ( 0, memcmp( a->mNormals, b->mNormals, a->mNumVertices * sizeof( aiVector3D ) ) );
+        for ( unsigned int f = 0; f < a->mNumFaces; ++f ) {
+            EXPECT_EQ( 0, memcmp( a->mFaces[ f ].mIndices, b->mFaces[ f ].mIndices, 3 * sizeof( unsigned int ) ) );
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Timing of the step against the reference on a million vertices. Disabled by
+// default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F(JoinVerticesTest, DISABLED_Benchmark)
+{
+    typedef std::chrono::steady_clock Clock;
+    const unsigned int count = 1000000 / 3;
+
+    std::unique_ptr<aiMesh> mesh( CreateRedundantMesh( count, 3 ) );
+    std::vector<unsigned int> sources;
+    Clock::time_point start = Clock::now();
+    ReferenceJoin( mesh.get(), sources );
+    const double reference = std::chrono::duration<double>( Clock::now() - start ).count();
+
+    start = Clock::now();
+    piProcess->ProcessMesh( mesh.get(), 0 );
+    const double hashed = std::chrono::duration<double>( Clock::now() - start ).count();
+    EXPECT_EQ( sources.size(), mesh->mNumVertices );
+
+    mesh.reset( CreateRedundantMesh( count, 3 ) );
+    Importer importer;
+    importer.SetPropertyFloat( AI_CONFIG_PP_JIV_EPSILON, 1e-4f );
+    piProcess->SetupProperties( &importer );
+    start = Clock::now();
+    piProcess->ProcessMesh( mesh.get(), 0 );
+    const double grid = std::chrono::duration<double>( Clock::now() - start ).count();
+
+    aiScene scene;
+    scene.mNumMeshes = 4;
+    scene.mMeshes = new aiMesh*[ 4 ];
+    for ( unsigned int i = 0; i < 4; ++i ) {
+        scene.mMeshes[ i ] = CreateRedundantMesh( count, 3 );
+    }
+    importer.SetPropertyFloat( AI_CONFIG_PP_JIV_EPSILON, 0.f );
+    piProcess->SetupProperties( &importer );
+    start = Clock::now();
+    piProcess->Execute( &scene );
+    const double scene4 = std::chrono::duration<double>( Clock::now() - start ).count();
+
+    printf( "%u vertices: SpatialSort %.3fs, hashed %.3fs, grid %.3fs, 4 meshes on %u threads %.3fs\n",
+        mesh->mNumFaces * 3, reference, hashed, grid, std::thread::hardware_concurrency(), scene4 );
+}
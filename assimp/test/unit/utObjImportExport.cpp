@@ -47,6 +47,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Importer.hpp>
 #include <assimp/Exporter.hpp>
 #include <assimp/postprocess.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
 
 using namespace Assimp;
 
@@ -341,3 +345,175 @@ TEST_F(utObjImportExport, 0based_array_Test) {
     const aiScene *scene = myimporter.ReadFileFromMemory(ObjModel.c_str(), ObjModel.size(), 0);
     EXPECT_EQ(nullptr, scene);
 }
+
+// ------------------------------------------------------------------------------------------------
+// An OBJ file with 'groups' grids of size x size quads. The groups switch between the
+// face formats, relative and absolute indices, homogeneous vertices, materials and line
+// ends. The importer expects vertex colors for all vertices or for none.
+static std::string CreateLargeObj( unsigned int groups, unsigned int size, bool colors = false ) {
+    std::string obj = "# generated\nmtllib missing.mtl\n";
+    char line[ 256 ];
+    for ( unsigned int g = 0; g < groups; ++g ) {
+        const char *eol = g % 3 == 2 ? "\r\n" : "\n";
+        snprintf( line, sizeof( line ), "%sg grid%u%so object%u%s", eol, g, eol, g / 2, eol );
+        obj += line;
+        for ( unsigned int y = 0; y <= size; ++y ) {
+            for ( unsigned int x = 0; x <= size; ++x ) {
+                const float h = 0.125f * static_cast<float>( ( x * 7 + y * 3 + g ) % 16 );
+                if ( colors ) {
+                    snprintf( line, sizeof( line ), "v %u.5 %g -%u.25 %g 0.5 1%s", x, h, y, h / 2, eol );
+                } else if ( g % 4 == 1 ) {
+                    snprintf( line, sizeof( line ), "v %u %g %u 0.5%s", x, h, y, eol );
+                } else {
+                    snprintf( line, sizeof( line ), "v\t%u %g %ue-1%s", x, h, y, eol );
+                }
+                obj += line;
+                snprintf( line, sizeof( line ), "vt %g %g%s", x / static_cast<float>( size ), y / static_cast<float>( size ), eol );
+                obj += line;
+                snprintf( line, sizeof( line ), "vn 0 1 %g%s", h, eol );
+                obj += line;
+            }
+        }
+        snprintf( line, sizeof( line ), "usemtl material%u%ss %u%s", g % 3, eol, g % 2, eol );
+        obj += line;
+        const int n = ( size + 1 ) * ( size + 1 );
+        for ( unsigned int y = 0; y < size; ++y ) {
+            if ( y == size / 2 ) {
+                snprintf( line, sizeof( line ), "# half of grid %u%s%susemtl material%u%s", g, eol, eol, ( g + 1 ) % 3, eol );
+                obj += line;
+            }
+            for ( unsigned int x = 0; x < size; ++x ) {
+                const int a = y * ( size + 1 ) + x, b = a + 1, c = a + size + 2, d = a + size + 1;
+                switch ( g % 4 ) {
+                case 0:
+                    snprintf( line, sizeof( line ), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d%s",
+                        -n + a, -n + a, -n + a, -n + b, -n + b, -n + b, -n + c, -n + c, -n + c, -n + d, -n + d, -n + d, eol );
+                    break;
+                case 1:
+                    snprintf( line, sizeof( line ), "f %d//%d %d//%d %d//%d%s", -n + a, -n + a, -n + b, -n + b, -n + c, -n + c, eol );
+                    break;
+                case 2:
+                    snprintf( line, sizeof( line ), "f  %d/%d %d/%d\t%d/%d %s", -n + a, -n + a, -n + c, -n + c, -n + d, -n + d, eol );
+                    break;
+                default: {
+                    const int base = g * n + 1;
+                    snprintf( line, sizeof( line ), "f %d %d %d %d%s", base + a, base + b, base + c, base + d, eol );
+                    break;
+                }
+                }
+                obj += line;
+            }
+        }
+    }
+    // without line end, this one is dropped
+    obj += "f 1 2 3";
+    return obj;
+}
+
+// ------------------------------------------------------------------------------------------------
+static void ExpectSameNodes( const aiNode *expected, const aiNode *actual ) {
+    EXPECT_STREQ( expected->mName.C_Str(), actual->mName.C_Str() );
+    ASSERT_EQ( expected->mNumMeshes, actual->mNumMeshes );
+    for ( unsigned int i = 0; i < expected->mNumMeshes; ++i ) {
+        EXPECT_EQ( expected->mMeshes[ i ], actual->mMeshes[ i ] );
+    }
+    ASSERT_EQ( expected->mNumChildren, actual->mNumChildren );
+    for ( unsigned int i = 0; i < expected->mNumChildren; ++i ) {
+        ExpectSameNodes( expected->mChildren[ i ], actual->mChildren[ i ] );
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+static void ExpectSameScene( const aiScene *expected, const aiScene *actual ) {
+    ASSERT_NE( nullptr, expected );
+    ASSERT_NE( nullptr, actual );
+    ExpectSameNodes( expected->mRootNode, actual->mRootNode );
+
+    ASSERT_EQ( expected->mNumMaterials, actual->mNumMaterials );
+    for ( unsigned int i = 0; i < expected->mNumMaterials; ++i ) {
+        aiString a, b;
+        expected->mMaterials[ i ]->Get( AI_MATKEY_NAME, a );
+        actual->mMaterials[ i ]->Get( AI_MATKEY_NAME, b );
+        EXPECT_STREQ( a.C_Str(), b.C_Str() );
+    }
+
+    ASSERT_EQ( expected->mNumMeshes, actual->mNumMeshes );
+    for ( unsigned int i = 0; i < expected->mNumMeshes; ++i ) {
+        const aiMesh *a = expected->mMeshes[ i ], *b = actual->mMeshes[ i ];
+        EXPECT_STREQ( a->mName.C_Str(), b->mName.C_Str() );
+        EXPECT_EQ( a->mMaterialIndex, b->mMaterialIndex );
+        EXPECT_EQ( a->mPrimitiveTypes, b->mPrimitiveTypes );
+        ASSERT_EQ( a->mNumVertices, b->mNumVertices );
+        const size_t size = a->mNumVertices * sizeof( aiVector3D );
+        EXPECT_EQ( 0, memcmp( a->mVertices, b->mVertices, size ) );
+        ASSERT_EQ( a->HasNormals(), b->HasNormals() );
+        if ( a->HasNormals() ) {
+            EXPECT_EQ( 0, memcmp( a->mNormals, b->mNormals, size ) );
+        }
+        ASSERT_EQ( a->HasTextureCoords( 0 ), b->HasTextureCoords( 0 ) );
+        if ( a->HasTextureCoords( 0 ) ) {
+            EXPECT_EQ( 0, memcmp( a->mTextureCoords[ 0 ], b->mTextureCoords[ 0 ], size ) );
+        }
+        ASSERT_EQ( a->HasVertexColors( 0 ), b->HasVertexColors( 0 ) );
+        if ( a->HasVertexColors( 0 ) ) {
+            EXPECT_EQ( 0, memcmp( a->mColors[ 0 ], b->mColors[ 0 ], a->mNumVertices * sizeof( aiColor4D ) ) );
+        }
+        ASSERT_EQ( a->mNumFaces, b->mNumFaces );
+        for ( unsigned int f = 0; f < a->mNumFaces; ++f ) {
+            ASSERT_EQ( a->mFaces[ f ].mNumIndices, b->mFaces[ f ].mNumIndices );
+            EXPECT_EQ( 0, memcmp( a->mFaces[ f ].mIndices, b->mFaces[ f ].mIndices, a->mFaces[ f ].mNumIndices * sizeof( unsigned int ) ) );
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F( utObjImportExport, parallelParsingTest ) {
+    // about 31MB, two windows with four threads
+    const std::string obj = CreateLargeObj( 8, 200 );
+
+    Assimp::Importer serial, parallel;
+    serial.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    parallel.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    const aiScene *expected = serial.ReadFileFromMemory( obj.c_str(), obj.size(), aiProcess_ValidateDataStructure );
+    const aiScene *actual = parallel.ReadFileFromMemory( obj.c_str(), obj.size(), aiProcess_ValidateDataStructure );
+    ASSERT_NE( nullptr, expected );
+    EXPECT_EQ( 16U, expected->mNumMeshes );
+    ExpectSameScene( expected, actual );
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F( utObjImportExport, parallelParsingFallbackTest ) {
+    // lines and continued lines are left to the serial parser, from where they are on
+    std::string obj = CreateLargeObj( 8, 200, true );
+    const size_t pos = obj.find( "\ng grid6\n" );
+    ASSERT_NE( std::string::npos, pos );
+    obj.insert( pos, "\nl 1 2 3\nv 1 \\\n 2 3 4 5 6\nf 1 2 -1" );
+
+    Assimp::Importer serial, parallel;
+    serial.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 0 );
+    parallel.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+    const aiScene *expected = serial.ReadFileFromMemory( obj.c_str(), obj.size(), aiProcess_ValidateDataStructure );
+    const aiScene *actual = parallel.ReadFileFromMemory( obj.c_str(), obj.size(), aiProcess_ValidateDataStructure );
+    ASSERT_NE( nullptr, expected );
+    ExpectSameScene( expected, actual );
+}
+
+// ------------------------------------------------------------------------------------------------
+// Timing of the OBJ importer on a generated file with a few million vertices.
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utObjImportExport, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+    const std::string obj = CreateLargeObj( 16, 500 );
+
+    double seconds[ 2 ];
+    for ( int parallel = 0; parallel < 2; ++parallel ) {
+        Assimp::Importer importer;
+        importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, parallel ? -1 : 0 );
+        const Clock::time_point start = Clock::now();
+        ASSERT_NE( nullptr, importer.ReadFileFromMemory( obj.c_str(), obj.size(), 0 ) );
+        seconds[ parallel ] = std::chrono::duration<double>( Clock::now() - start ).count();
+    }
+    printf( "%.1f MB, %u vertices: serial %.3fs, parallel on %u threads %.3fs\n",
+        obj.size() / ( 1024.0 * 1024.0 ), 16 * 501 * 501, seconds[ 0 ],
+        std::max( 1u, std::thread::hardware_concurrency() ), seconds[ 1 ] );
+}
@@ -45,8 +45,120 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include "AbstractImportExportBase.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
 using namespace ::Assimp;
 
+namespace {
+
+enum PlyFormat {
+    PlyAscii,
+    PlyBinaryLittleEndian,
+    PlyBinaryBigEndian
+};
+
+// Appends a binary value in the requested byte order
+template <typename T>
+void AppendBinary( std::string &out, T value, PlyFormat format ) {
+    char bytes[ sizeof( T ) ];
+    ::memcpy( bytes, &value, sizeof( T ) );
+    if ( format == PlyBinaryBigEndian ) {
+        std::reverse( bytes, bytes + sizeof( T ) );
+    }
+    out.append( bytes, sizeof( T ) );
+}
+
+// A grid of size x size quads split into triangles. The vertices carry normals,
+// colors, texture coordinates and a property the importer ignores, all of them
+// with values which survive the round trip through text.
+std::string CreatePly( unsigned int size, PlyFormat format ) {
+    const unsigned int numVertices = ( size + 1 ) * ( size + 1 );
+    const unsigned int numFaces = size * size * 2;
+
+    std::string out = "ply\nformat ";
+    out += format == PlyAscii ? "ascii" : format == PlyBinaryLittleEndian ? "binary_little_endian" : "binary_big_endian";
+    out += " 1.0\nelement vertex " + std::to_string( numVertices ) + "\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "property float nx\nproperty float ny\nproperty float nz\n"
+        "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+        "property int flags\n"
+        "property float s\nproperty float t\n"
+        "element face " + std::to_string( numFaces ) + "\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n";
+
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        const float x = static_cast<float>( i % ( size + 1 ) ) * 0.25f, y = static_cast<float>( i / ( size + 1 ) ) * 0.5f;
+        const float values[] = { x, y, -x, 0.f, 0.f, 1.f };
+        const unsigned char colors[] = { static_cast<unsigned char>( i ), static_cast<unsigned char>( i >> 8 ), 255 };
+        const float uv[] = { x * 0.125f, y * 0.0625f };
+        if ( format == PlyAscii ) {
+            char line[ 256 ];
+            ::snprintf( line, sizeof( line ), "%g %g %g %g %g %g %u %u %u %d %g %g\n", values[ 0 ], values[ 1 ], values[ 2 ],
+                values[ 3 ], values[ 4 ], values[ 5 ], colors[ 0 ], colors[ 1 ], colors[ 2 ], -static_cast<int>( i ), uv[ 0 ], uv[ 1 ] );
+            out += line;
+            continue;
+        }
+        for ( float v : values ) {
+            AppendBinary( out, v, format );
+        }
+        out.append( reinterpret_cast<const char*>( colors ), 3 );
+        AppendBinary( out, -static_cast<int32_t>( i ), format );
+        AppendBinary( out, uv[ 0 ], format );
+        AppendBinary( out, uv[ 1 ], format );
+    }
+
+    for ( unsigned int i = 0; i < numFaces; ++i ) {
+        const unsigned int quad = i / 2, v = quad / size * ( size + 1 ) + quad % size;
+        const int32_t indices[ 2 ][ 3 ] = { { int32_t( v ), int32_t( v + 1 ), int32_t( v + size + 2 ) },
+            { int32_t( v ), int32_t( v + size + 2 ), int32_t( v + size + 1 ) } };
+        const int32_t *face = indices[ i % 2 ];
+        if ( format == PlyAscii ) {
+            out += "3 " + std::to_string( face[ 0 ] ) + " " + std::to_string( face[ 1 ] ) + " " + std::to_string( face[ 2 ] ) + "\n";
+            continue;
+        }
+        out += static_cast<char>( 3 );
+        for ( unsigned int j = 0; j < 3; ++j ) {
+            AppendBinary( out, face[ j ], format );
+        }
+    }
+    return out;
+}
+
+void ExpectSameMesh( const aiMesh *expected, const aiMesh *actual ) {
+    ASSERT_EQ( expected->mNumVertices, actual->mNumVertices );
+    ASSERT_EQ( expected->mNumFaces, actual->mNumFaces );
+    ASSERT_EQ( expected->HasNormals(), actual->HasNormals() );
+    ASSERT_EQ( expected->HasVertexColors( 0 ), actual->HasVertexColors( 0 ) );
+    ASSERT_EQ( expected->HasTextureCoords( 0 ), actual->HasTextureCoords( 0 ) );
+    EXPECT_EQ( expected->mNumUVComponents[ 0 ], actual->mNumUVComponents[ 0 ] );
+    for ( unsigned int i = 0; i < expected->mNumVertices; ++i ) {
+        ASSERT_EQ( expected->mVertices[ i ], actual->mVertices[ i ] );
+        if ( expected->HasNormals() ) {
+            ASSERT_EQ( expected->mNormals[ i ], actual->mNormals[ i ] );
+        }
+        if ( expected->HasVertexColors( 0 ) ) {
+            ASSERT_EQ( expected->mColors[ 0 ][ i ], actual->mColors[ 0 ][ i ] );
+        }
+        if ( expected->HasTextureCoords( 0 ) ) {
+            ASSERT_EQ( expected->mTextureCoords[ 0 ][ i ], actual->mTextureCoords[ 0 ][ i ] );
+        }
+    }
+    for ( unsigned int i = 0; i < expected->mNumFaces; ++i ) {
+        ASSERT_EQ( expected->mFaces[ i ].mNumIndices, actual->mFaces[ i ].mNumIndices );
+        for ( unsigned int j = 0; j < expected->mFaces[ i ].mNumIndices; ++j ) {
+            ASSERT_EQ( expected->mFaces[ i ].mIndices[ j ], actual->mFaces[ i ].mIndices[ j ] );
+        }
+    }
+}
+
+} // namespace
+
 class utPLYImportExport : public AbstractImportExportBase {
 public:
     virtual bool importerTest() {
@@ -90,3 +202,49 @@ TEST_F( utPLYImportExport, vertexColorTest ) {
     const aiScene *scene = importer.ReadFile( ASSIMP_TEST_MODELS_DIR "/PLY/float-color.ply", 0 );
     EXPECT_NE( nullptr, scene );
 }
+
+TEST_F( utPLYImportExport, binaryMatchesAsciiTest ) {
+    // the vertex records are 39 bytes wide, a grid of this size spans several
+    // stream blocks with records crossing the block boundaries
+    const unsigned int size = 200;
+    const std::string ascii = CreatePly( size, PlyAscii );
+    Assimp::Importer asciiImporter;
+    const aiScene *expected = asciiImporter.ReadFileFromMemory( ascii.c_str(), ascii.size(), 0, "ply" );
+    ASSERT_NE( nullptr, expected );
+    ASSERT_EQ( 1u, expected->mNumMeshes );
+    EXPECT_EQ( ( size + 1 ) * ( size + 1 ), expected->mMeshes[ 0 ]->mNumVertices );
+    EXPECT_EQ( 2u * size * size, expected->mMeshes[ 0 ]->mNumFaces );
+
+    for ( PlyFormat format : { PlyBinaryLittleEndian, PlyBinaryBigEndian } ) {
+        const std::string binary = CreatePly( size, format );
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFileFromMemory( binary.c_str(), binary.size(), 0, "ply" );
+        ASSERT_NE( nullptr, scene );
+        ASSERT_EQ( 1u, scene->mNumMeshes );
+        ExpectSameMesh( expected->mMeshes[ 0 ], scene->mMeshes[ 0 ] );
+    }
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utPLYImportExport, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+
+    // 10M triangles, the file goes to disk to include the reads in the timing
+    const unsigned int size = 2237;
+    const std::string path = ASSIMP_TEST_MODELS_DIR "/PLY/benchmark.ply";
+    size_t fileSize = 0;
+    {
+        const std::string binary = CreatePly( size, PlyBinaryLittleEndian );
+        fileSize = binary.size();
+        std::ofstream( path.c_str(), std::ios::binary ).write( binary.c_str(), binary.size() );
+    }
+
+    Assimp::Importer importer;
+    const Clock::time_point start = Clock::now();
+    const aiScene *scene = importer.ReadFile( path, 0 );
+    const double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    std::remove( path.c_str() );
+
+    ASSERT_NE( nullptr, scene );
+    printf( "%.1f MB, %u triangles: %.3fs\n", fileSize / ( 1024.0 * 1024.0 ), scene->mMeshes[ 0 ]->mNumFaces, seconds );
+}
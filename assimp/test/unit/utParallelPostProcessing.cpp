@@ -0,0 +1,194 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2017, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+#include "SceneDiffer.h"
+#include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <chrono>
+#include <math.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace ::Assimp;
+
+class ParallelPostProcessingTest : public ::testing::Test {
+    // empty
+};
+
+// All steps which follow #AI_CONFIG_PP_PARALLEL_MESHES
+static const unsigned int PerMeshSteps = aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace |
+    aiProcess_Triangulate | aiProcess_FindDegenerates | aiProcess_FindInvalidData |
+    aiProcess_LimitBoneWeights | aiProcess_ImproveCacheLocality;
+
+// OBJ with one wavy grid of quads per object, plus one degenerate triangle
+// per object. Large enough to be split across threads.
+static std::string CreateObj( unsigned int objects, unsigned int size ) {
+    std::ostringstream obj;
+    unsigned int base = 1;
+    for ( unsigned int o = 0; o < objects; ++o ) {
+        obj << "o grid" << o << "\n";
+        for ( unsigned int y = 0; y <= size; ++y ) {
+            for ( unsigned int x = 0; x <= size; ++x ) {
+                const float z = sinf( x * 0.3f + o ) * cosf( y * 0.2f );
+                obj << "v " << x + o * ( size + 2 ) << " " << y << " " << z << "\n";
+                obj << "vt " << x / float( size ) << " " << y / float( size ) << "\n";
+            }
+        }
+        for ( unsigned int y = 0; y < size; ++y ) {
+            for ( unsigned int x = 0; x < size; ++x ) {
+                const unsigned int i = base + y * ( size + 1 ) + x;
+                const unsigned int j = i + size + 1;
+                obj << "f " << i << "/" << i << " " << i + 1 << "/" << i + 1 << " "
+                    << j + 1 << "/" << j + 1 << " " << j << "/" << j << "\n";
+            }
+        }
+        obj << "f " << base << "/" << base << " " << base << "/" << base << " " << base + 1 << "/" << base + 1 << "\n";
+        base += ( size + 1 ) * ( size + 1 );
+    }
+    return obj.str();
+}
+
+static void setParallel( Importer &importer, bool parallel ) {
+    importer.SetPropertyBool( AI_CONFIG_PP_PARALLEL_MESHES, parallel );
+    importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, 4 );
+}
+
+static void expectSameBones( const aiScene *expected, const aiScene *actual ) {
+    for ( unsigned int m = 0; m < expected->mNumMeshes; ++m ) {
+        const aiMesh *a = expected->mMeshes[ m ], *b = actual->mMeshes[ m ];
+        ASSERT_EQ( a->mNumBones, b->mNumBones );
+        for ( unsigned int i = 0; i < a->mNumBones; ++i ) {
+            ASSERT_EQ( a->mBones[ i ]->mNumWeights, b->mBones[ i ]->mNumWeights );
+            for ( unsigned int w = 0; w < a->mBones[ i ]->mNumWeights; ++w ) {
+                EXPECT_EQ( a->mBones[ i ]->mWeights[ w ].mVertexId, b->mBones[ i ]->mWeights[ w ].mVertexId );
+                EXPECT_EQ( a->mBones[ i ]->mWeights[ w ].mWeight, b->mBones[ i ]->mWeights[ w ].mWeight );
+            }
+        }
+    }
+}
+
+TEST_F( ParallelPostProcessingTest, parallelMatchesSerialTest ) {
+    static const char *Files[] = {
+        ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj",
+        ASSIMP_TEST_MODELS_DIR "/OBJ/concave_polygon.obj",
+        ASSIMP_TEST_MODELS_DIR "/Collada/duck.dae",
+        ASSIMP_TEST_MODELS_DIR "/Collada/library_animation_clips.dae",
+        ASSIMP_TEST_MODELS_DIR "/3DS/fels.3ds",
+    };
+
+    for ( size_t i = 0; i < sizeof( Files ) / sizeof( Files[ 0 ] ); ++i ) {
+        Importer serial, parallel;
+        setParallel( parallel, true );
+        const aiScene *expected = serial.ReadFile( Files[ i ], PerMeshSteps );
+        const aiScene *actual = parallel.ReadFile( Files[ i ], PerMeshSteps );
+        ASSERT_NE( nullptr, expected ) << Files[ i ];
+        ASSERT_NE( nullptr, actual ) << Files[ i ];
+
+        SceneDiffer differ;
+        EXPECT_TRUE( differ.isEqual( expected, actual ) ) << Files[ i ];
+        differ.showReport();
+        expectSameBones( expected, actual );
+    }
+}
+
+TEST_F( ParallelPostProcessingTest, parallelMatchesSerialLargeTest ) {
+    const std::string obj = CreateObj( 8, 64 );
+    Importer serial, parallel;
+    setParallel( parallel, true );
+    const aiScene *expected = serial.ReadFileFromMemory( obj.c_str(), obj.size(), PerMeshSteps, "obj" );
+    const aiScene *actual = parallel.ReadFileFromMemory( obj.c_str(), obj.size(), PerMeshSteps, "obj" );
+    ASSERT_NE( nullptr, expected );
+    ASSERT_NE( nullptr, actual );
+    ASSERT_EQ( 8u, actual->mNumMeshes );
+    EXPECT_TRUE( actual->mMeshes[ 0 ]->HasTangentsAndBitangents() );
+
+    SceneDiffer differ;
+    EXPECT_TRUE( differ.isEqual( expected, actual ) );
+    differ.showReport();
+}
+
+class RecordingProgressHandler : public ProgressHandler {
+public:
+    virtual bool Update( float percentage ) {
+        values.push_back( percentage );
+        return true;
+    }
+
+    std::vector<float> values;
+};
+
+TEST_F( ParallelPostProcessingTest, progressIsMonotoneTest ) {
+    const std::string obj = CreateObj( 8, 64 );
+    Importer importer;
+    setParallel( importer, true );
+    RecordingProgressHandler *progress = new RecordingProgressHandler();
+    importer.SetProgressHandler( progress );
+    ASSERT_NE( nullptr, importer.ReadFileFromMemory( obj.c_str(), obj.size(), PerMeshSteps, "obj" ) );
+
+    // at least one report per mesh and step, never going back
+    ASSERT_GE( progress->values.size(), 8u * 7u );
+    for ( size_t i = 1; i < progress->values.size(); ++i ) {
+        EXPECT_LE( progress->values[ i - 1 ], progress->values[ i ] ) << i;
+    }
+    EXPECT_FLOAT_EQ( 1.f, progress->values.back() );
+}
+
+TEST_F( ParallelPostProcessingTest, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+    const std::string obj = CreateObj( 64, 96 );
+
+    double seconds[ 2 ];
+    for ( int parallel = 0; parallel < 2; ++parallel ) {
+        Importer importer;
+        setParallel( importer, parallel != 0 );
+        importer.SetPropertyInteger( AI_CONFIG_GLOB_MULTITHREADING, -1 );
+        ASSERT_NE( nullptr, importer.ReadFileFromMemory( obj.c_str(), obj.size(), 0, "obj" ) );
+        const Clock::time_point start = Clock::now();
+        ASSERT_NE( nullptr, importer.ApplyPostProcessing( PerMeshSteps ) );
+        seconds[ parallel ] = std::chrono::duration<double>( Clock::now() - start ).count();
+    }
+    printf( "64 meshes, %u vertices: serial %.3fs, parallel on %u threads %.3fs\n",
+        64u * 96u * 96u * 4u, seconds[ 0 ], std::thread::hardware_concurrency(), seconds[ 1 ] );
+}
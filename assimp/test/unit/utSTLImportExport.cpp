@@ -46,9 +46,47 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
 
 using namespace Assimp;
 
+namespace {
+
+// Position k of facet i in the files written by CreateBinarySTL
+aiVector3D FacetVertex( unsigned int i, unsigned int k ) {
+    return aiVector3D( static_cast<ai_real>( i % 1000 ), static_cast<ai_real>( i / 1000 ) + k * 0.5f, -static_cast<ai_real>( k ) );
+}
+
+// A binary STL with numFaces facets, every seventh one carrying a color
+std::string CreateBinarySTL( unsigned int numFaces ) {
+    std::string out( 80, ' ' );
+    out.replace( 0, 6, "binary" );
+    const uint32_t count = numFaces;
+    out.append( reinterpret_cast<const char*>( &count ), 4 );
+
+    for ( unsigned int i = 0; i < numFaces; ++i ) {
+        float values[ 12 ] = { 0.f, 0.f, 1.f };
+        for ( unsigned int k = 0; k < 3; ++k ) {
+            const aiVector3D v = FacetVertex( i, k );
+            values[ 3 + k * 3 ] = static_cast<float>( v.x );
+            values[ 4 + k * 3 ] = static_cast<float>( v.y );
+            values[ 5 + k * 3 ] = static_cast<float>( v.z );
+        }
+        out.append( reinterpret_cast<const char*>( values ), sizeof( values ) );
+        const uint16_t color = i % 7 ? 0 : 0x8000 | ( 1 << 5 );
+        out.append( reinterpret_cast<const char*>( &color ), 2 );
+    }
+    return out;
+}
+
+} // namespace
+
 class utSTLImporterExporter : public AbstractImportExportBase {
 public:
     virtual bool importerTest() {
@@ -67,3 +105,60 @@ TEST_F( utSTLImporterExporter, test_with_two_solids ) {
     const aiScene *scene = importer.ReadFile( ASSIMP_TEST_MODELS_DIR "/STL/triangle_with_two_solids.stl", aiProcess_ValidateDataStructure );
     EXPECT_NE( nullptr, scene );
 }
+
+TEST_F( utSTLImporterExporter, importBinaryTest ) {
+    // spans several of the blocks the facets are read in
+    const unsigned int numFaces = 40000;
+    const std::string stl = CreateBinarySTL( numFaces );
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFileFromMemory( stl.c_str(), stl.size(), aiProcess_ValidateDataStructure, "stl" );
+    ASSERT_NE( nullptr, scene );
+    ASSERT_EQ( 1u, scene->mNumMeshes );
+
+    const aiMesh *mesh = scene->mMeshes[ 0 ];
+    ASSERT_EQ( numFaces, mesh->mNumFaces );
+    ASSERT_EQ( numFaces * 3, mesh->mNumVertices );
+    ASSERT_TRUE( mesh->HasNormals() );
+    ASSERT_TRUE( mesh->HasVertexColors( 0 ) );
+    for ( unsigned int i = 0; i < numFaces; ++i ) {
+        for ( unsigned int k = 0; k < 3; ++k ) {
+            ASSERT_EQ( FacetVertex( i, k ), mesh->mVertices[ i * 3 + k ] );
+            ASSERT_EQ( aiVector3D( 0, 0, 1 ), mesh->mNormals[ i * 3 + k ] );
+            const aiColor4D &color = mesh->mColors[ 0 ][ i * 3 + k ];
+            if ( i % 7 ) {
+                // the default color
+                ASSERT_FLOAT_EQ( 0.6f, color.g );
+                ASSERT_FLOAT_EQ( 0.6f, color.a );
+            } else {
+                ASSERT_FLOAT_EQ( 1.f / 31.f, color.g );
+                ASSERT_FLOAT_EQ( 1.f, color.a );
+            }
+        }
+    }
+}
+
+TEST_F( utSTLImporterExporter, importTruncatedBinaryTest ) {
+    std::string stl = CreateBinarySTL( 100 );
+    stl.resize( stl.size() - 25 );
+    Assimp::Importer importer;
+    EXPECT_EQ( nullptr, importer.ReadFileFromMemory( stl.c_str(), stl.size(), 0, "stl" ) );
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utSTLImporterExporter, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+
+    // 10M triangles, the file goes to disk to include the reads in the timing
+    const unsigned int numFaces = 10000000;
+    const std::string path = ASSIMP_TEST_MODELS_DIR "/STL/benchmark.stl";
+    std::ofstream( path.c_str(), std::ios::binary ) << CreateBinarySTL( numFaces );
+
+    Assimp::Importer importer;
+    const Clock::time_point start = Clock::now();
+    const aiScene *scene = importer.ReadFile( path, 0 );
+    const double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    std::remove( path.c_str() );
+
+    ASSERT_NE( nullptr, scene );
+    printf( "%.1f MB, %u triangles: %.3fs\n", ( 84 + numFaces * 50.0 ) / ( 1024.0 * 1024.0 ), scene->mMeshes[ 0 ]->mNumFaces, seconds );
+}
@@ -45,9 +45,160 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Importer.hpp>
 #include <assimp/Exporter.hpp>
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 
 using namespace Assimp;
 
+namespace {
+
+template <typename T>
+void AppendBytes( std::string &out, const T &value ) {
+    out.append( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+std::string EncodeBase64( const std::string &in ) {
+    static const char *chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve( ( in.size() + 2 ) / 3 * 4 );
+    for ( size_t i = 0; i < in.size(); i += 3 ) {
+        const size_t n = std::min<size_t>( 3, in.size() - i );
+        uint32_t bits = 0;
+        for ( size_t k = 0; k < 3; ++k ) {
+            bits = ( bits << 8 ) | ( k < n ? static_cast<uint8_t>( in[ i + k ] ) : 0 );
+        }
+        for ( size_t k = 0; k < 4; ++k ) {
+            out += k <= n ? chars[ ( bits >> ( 18 - 6 * k ) ) & 63 ] : '=';
+        }
+    }
+    return out;
+}
+
+// A grid of size x size quads. Positions, normals and tangents are interleaved in
+// one buffer view, texture coordinates and 32 bit indices follow in two more.
+// padding extra bytes at the end of the buffer vary the base64 padding.
+std::string CreateGltf2( unsigned int size, bool binary, unsigned int padding = 0 ) {
+    const unsigned int numVertices = ( size + 1 ) * ( size + 1 );
+    const unsigned int numIndices = size * size * 6;
+
+    std::string buffer;
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        const float x = static_cast<float>( i % ( size + 1 ) ), y = static_cast<float>( i / ( size + 1 ) );
+        const float vertex[] = { x, y, 0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, i % 2 ? 1.f : -1.f };
+        AppendBytes( buffer, vertex );
+    }
+    const size_t uvOffset = buffer.size();
+    for ( unsigned int i = 0; i < numVertices; ++i ) {
+        const float uv[] = { static_cast<float>( i % ( size + 1 ) ) / size, static_cast<float>( i / ( size + 1 ) ) / size };
+        AppendBytes( buffer, uv );
+    }
+    const size_t indexOffset = buffer.size();
+    for ( unsigned int q = 0; q < size * size; ++q ) {
+        const uint32_t v = q / size * ( size + 1 ) + q % size;
+        const uint32_t indices[] = { v, v + 1, v + size + 2, v, v + size + 2, v + size + 1 };
+        AppendBytes( buffer, indices );
+    }
+    buffer.append( padding, '\0' );
+
+    const std::string vertices = std::to_string( numVertices );
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+        "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TANGENT\":2,\"TEXCOORD_0\":3},\"indices\":4,\"material\":0,\"mode\":4}]}],\"materials\":[{}],"
+        "\"buffers\":[{\"byteLength\":" + std::to_string( buffer.size() );
+    if ( !binary ) {
+        json += ",\"uri\":\"data:application/octet-stream;base64," + EncodeBase64( buffer ) + "\"";
+    }
+    json += "}],\"bufferViews\":["
+        "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string( uvOffset ) + ",\"byteStride\":40,\"target\":34962},"
+        "{\"buffer\":0,\"byteOffset\":" + std::to_string( uvOffset ) + ",\"byteLength\":" + std::to_string( indexOffset - uvOffset ) + ",\"target\":34962},"
+        "{\"buffer\":0,\"byteOffset\":" + std::to_string( indexOffset ) + ",\"byteLength\":" + std::to_string( numIndices * 4 ) + ",\"target\":34963}],"
+        "\"accessors\":["
+        "{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":" + vertices + ",\"type\":\"VEC3\"},"
+        "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" + vertices + ",\"type\":\"VEC3\"},"
+        "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":" + vertices + ",\"type\":\"VEC4\"},"
+        "{\"bufferView\":1,\"byteOffset\":0,\"componentType\":5126,\"count\":" + vertices + ",\"type\":\"VEC2\"},"
+        "{\"bufferView\":2,\"byteOffset\":0,\"componentType\":5125,\"count\":" + std::to_string( numIndices ) + ",\"type\":\"SCALAR\"}]}";
+    if ( !binary ) {
+        return json;
+    }
+
+    // GLB container, both chunks padded to four bytes
+    json.append( ( 4 - json.size() % 4 ) % 4, ' ' );
+    buffer.append( ( 4 - buffer.size() % 4 ) % 4, '\0' );
+    std::string glb = "glTF";
+    AppendBytes( glb, uint32_t( 2 ) );
+    AppendBytes( glb, uint32_t( 12 + 8 + json.size() + 8 + buffer.size() ) );
+    AppendBytes( glb, uint32_t( json.size() ) );
+    glb += "JSON";
+    glb += json;
+    AppendBytes( glb, uint32_t( buffer.size() ) );
+    glb.append( "BIN\0", 4 );
+    glb += buffer;
+    return glb;
+}
+
+// The importer hands out meshes in verbose format, so every face corner is checked
+// against the grid vertex its position belongs to.
+void ExpectGridMesh( const aiScene *scene, unsigned int size ) {
+    ASSERT_NE( nullptr, scene );
+    ASSERT_EQ( 1u, scene->mNumMeshes );
+    const aiMesh *mesh = scene->mMeshes[ 0 ];
+    ASSERT_EQ( size * size * 2, mesh->mNumFaces );
+    ASSERT_EQ( size * size * 6, mesh->mNumVertices );
+    ASSERT_TRUE( mesh->HasNormals() );
+    ASSERT_TRUE( mesh->HasTangentsAndBitangents() );
+    ASSERT_TRUE( mesh->HasTextureCoords( 0 ) );
+    EXPECT_EQ( 2u, mesh->mNumUVComponents[ 0 ] );
+
+    for ( unsigned int q = 0; q < size * size; ++q ) {
+        const unsigned int v = q / size * ( size + 1 ) + q % size;
+        const unsigned int expected[] = { v, v + 1, v + size + 2, v, v + size + 2, v + size + 1 };
+        for ( unsigned int k = 0; k < 6; ++k ) {
+            const aiFace &face = mesh->mFaces[ q * 2 + k / 3 ];
+            ASSERT_EQ( 3u, face.mNumIndices );
+            const unsigned int n = face.mIndices[ k % 3 ];
+            const unsigned int i = expected[ k ];
+            const ai_real x = static_cast<ai_real>( i % ( size + 1 ) ), y = static_cast<ai_real>( i / ( size + 1 ) );
+            ASSERT_EQ( aiVector3D( x, y, 0 ), mesh->mVertices[ n ] );
+            ASSERT_EQ( aiVector3D( 0, 0, 1 ), mesh->mNormals[ n ] );
+            ASSERT_EQ( aiVector3D( 1, 0, 0 ), mesh->mTangents[ n ] );
+            // normal x tangent scaled by w
+            ASSERT_EQ( aiVector3D( 0, i % 2 ? 1.f : -1.f, 0 ), mesh->mBitangents[ n ] );
+            const float tu = static_cast<float>( i % ( size + 1 ) ) / size, tv = static_cast<float>( i / ( size + 1 ) ) / size;
+            ASSERT_EQ( aiVector3D( tu, 1 - tv, 0 ), mesh->mTextureCoords[ 0 ][ n ] );
+        }
+    }
+}
+
+#ifdef __linux__
+// Resets the peak resident set size of the process
+void ResetPeakMemory() {
+    std::ofstream( "/proc/self/clear_refs" ) << "5";
+}
+
+// Peak resident set size in MB since the last reset
+double PeakMemoryMB() {
+    std::ifstream status( "/proc/self/status" );
+    std::string line;
+    while ( std::getline( status, line ) ) {
+        if ( line.compare( 0, 6, "VmHWM:" ) == 0 ) {
+            return std::stod( line.substr( 6 ) ) / 1024.0;
+        }
+    }
+    return 0.0;
+}
+#else
+void ResetPeakMemory() {}
+double PeakMemoryMB() { return 0.0; }
+#endif
+
+} // namespace
+
 class utglTF2ImportExport : public AbstractImportExportBase {
 public:
     virtual bool importerTest() {
@@ -89,3 +240,58 @@ TEST_F( utglTF2ImportExport, exportglTF2FromFileTest ) {
     EXPECT_TRUE( exporterTest() );
 }
 #endif // ASSIMP_BUILD_NO_EXPORT
+
+TEST_F( utglTF2ImportExport, importEmbeddedBuffersTest ) {
+    // the extra bytes give buffers of all three base64 padding lengths
+    for ( unsigned int padding = 0; padding < 3; ++padding ) {
+        const std::string gltf = CreateGltf2( 20, false, padding );
+        Assimp::Importer importer;
+        ExpectGridMesh( importer.ReadFileFromMemory( gltf.c_str(), gltf.size(), aiProcess_ValidateDataStructure, "gltf" ), 20 );
+    }
+}
+
+TEST_F( utglTF2ImportExport, importAssetLastTest ) {
+    // the version check has to find the asset metadata behind all the other objects
+    std::string gltf = CreateGltf2( 4, false );
+    const std::string asset = "\"asset\":{\"version\":\"2.0\"},";
+    gltf.erase( gltf.find( asset ), asset.size() );
+    gltf.insert( gltf.size() - 1, "," + asset.substr( 0, asset.size() - 1 ) );
+    Assimp::Importer importer;
+    ExpectGridMesh( importer.ReadFileFromMemory( gltf.c_str(), gltf.size(), aiProcess_ValidateDataStructure, "gltf" ), 4 );
+}
+
+TEST_F( utglTF2ImportExport, importBinaryBuffersTest ) {
+    const std::string glb = CreateGltf2( 20, true );
+    Assimp::Importer importer;
+    ExpectGridMesh( importer.ReadFileFromMemory( glb.c_str(), glb.size(), aiProcess_ValidateDataStructure, "glb" ), 20 );
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F( utglTF2ImportExport, DISABLED_Benchmark ) {
+    typedef std::chrono::steady_clock Clock;
+    const unsigned int size = 1000;
+
+    for ( int binary = 0; binary < 2; ++binary ) {
+        // the file goes to disk to include the reads in the timing
+        const std::string path = ASSIMP_TEST_MODELS_DIR "/glTF2/benchmark." + std::string( binary ? "glb" : "gltf" );
+        size_t fileSize = 0;
+        {
+            const std::string data = CreateGltf2( size, binary != 0 );
+            fileSize = data.size();
+            std::ofstream( path.c_str(), std::ios::binary ).write( data.c_str(), data.size() );
+        }
+
+        ResetPeakMemory();
+        const double baseMB = PeakMemoryMB();
+        const Clock::time_point start = Clock::now();
+        {
+            Assimp::Importer importer;
+            ASSERT_NE( nullptr, importer.ReadFile( path, 0 ) );
+        }
+        const double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+        std::remove( path.c_str() );
+
+        printf( "%s %.1f MB, %u vertices: %.3fs, peak %.0f MB above the %.0f MB before\n", binary ? "glb" : "gltf",
+            fileSize / ( 1024.0 * 1024.0 ), ( size + 1 ) * ( size + 1 ), seconds, PeakMemoryMB() - baseMB, baseMB );
+    }
+}
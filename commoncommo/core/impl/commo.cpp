@@ -12,6 +12,7 @@
 #include "simplefileiomanager.h"
 #include "cloudiomanager.h"
 #include "cryptoutil.h"
+#include "ingestfilter.h"
 
 #include <string.h>
 #include <Mutex.h>
@@ -304,6 +305,7 @@ struct CommoImpl
             const char *ourCallsign, netinterfaceenums::NetInterfaceAddressMode addrMode) :
                 logger(logger), ourUID(NULL), ourCallsign(ourCallsign),
                 scanner(NULL),
+                ingestFilter(NULL),
                 dgMgmt(NULL), tcpMgmt(NULL), streamMgmt(NULL),
                 contactMgmt(NULL), listenerMgmt(NULL),
                 mpMutex(),
@@ -316,11 +318,13 @@ struct CommoImpl
     {
         this->ourUID = new InternalContactUID(ourUID);
         scanner = new HWIFScanner(logger, addrMode);
-        dgMgmt = new DatagramSocketManagement(logger, this->ourUID, scanner);
-        tcpMgmt = new TcpSocketManagement(logger, this->ourUID);
+        ingestFilter = new IngestFilter(logger);
+        dgMgmt = new DatagramSocketManagement(logger, this->ourUID, scanner,
+                                              ingestFilter);
+        tcpMgmt = new TcpSocketManagement(logger, this->ourUID, ingestFilter);
         streamMgmt = new StreamingSocketManagement(logger,
                 std::string((const char *)ourUID->contactUID,
-                            ourUID->contactUIDLen));
+                            ourUID->contactUIDLen), ingestFilter);
         contactMgmt = new ContactManager(logger, dgMgmt, tcpMgmt, streamMgmt);
         listenerMgmt = new CoTListenerManagement(logger);
         crypto = new CryptoUtil(logger);
@@ -363,6 +367,7 @@ struct CommoImpl
         delete dgMgmt;
         delete tcpMgmt;
         delete streamMgmt;
+        delete ingestFilter;
         delete scanner;
         delete ourUID;
     };
@@ -419,6 +424,7 @@ struct CommoImpl
     InternalContactUID *ourUID;
     std::string ourCallsign;
     HWIFScanner *scanner;
+    IngestFilter *ingestFilter;
     DatagramSocketManagement *dgMgmt;
     TcpSocketManagement *tcpMgmt;
     StreamingSocketManagement *streamMgmt;
@@ -629,6 +635,60 @@ int Commo::getBroadcastProto()
     return impl->contactMgmt->getProtoVersion();
 }
 
+void Commo::setIngestFilterEnabled(bool enable)
+{
+    impl->ingestFilter->setEnabled(enable);
+}
+
+CommoResult Commo::setIngestTypePolicy(const char *typePrefix,
+                                       bool dropDuplicates,
+                                       int minIntervalMillis)
+{
+    if (!typePrefix || minIntervalMillis < 0)
+        return COMMO_ILLEGAL_ARGUMENT;
+    IngestPolicy policy(dropDuplicates, minIntervalMillis);
+    if (!typePrefix[0])
+        impl->ingestFilter->setDefaultPolicy(policy);
+    else
+        impl->ingestFilter->setTypePolicy(typePrefix, policy);
+    return COMMO_SUCCESS;
+}
+
+CommoResult Commo::clearIngestTypePolicy(const char *typePrefix)
+{
+    if (!typePrefix)
+        return COMMO_ILLEGAL_ARGUMENT;
+    if (!typePrefix[0]) {
+        impl->ingestFilter->setDefaultPolicy(IngestPolicy());
+        return COMMO_SUCCESS;
+    }
+    return impl->ingestFilter->clearTypePolicy(typePrefix) ?
+                COMMO_SUCCESS : COMMO_ILLEGAL_ARGUMENT;
+}
+
+CommoResult Commo::setIngestUidPolicy(const char *uid, bool dropDuplicates,
+                                      int minIntervalMillis)
+{
+    if (!uid || !uid[0] || minIntervalMillis < 0)
+        return COMMO_ILLEGAL_ARGUMENT;
+    impl->ingestFilter->setUidPolicy(uid,
+            IngestPolicy(dropDuplicates, minIntervalMillis));
+    return COMMO_SUCCESS;
+}
+
+CommoResult Commo::clearIngestUidPolicy(const char *uid)
+{
+    if (!uid)
+        return COMMO_ILLEGAL_ARGUMENT;
+    return impl->ingestFilter->clearUidPolicy(uid) ?
+                COMMO_SUCCESS : COMMO_ILLEGAL_ARGUMENT;
+}
+
+void Commo::getIngestFilterStats(IngestFilterStats *stats)
+{
+    impl->ingestFilter->getStats(stats);
+}
+
 
 CommoResult Commo::setMissionPackageLocalPort(int localWebPort)
 {
@@ -43,9 +43,11 @@ namespace {
 
 DatagramSocketManagement::DatagramSocketManagement(CommoLogger *logger,
         ContactUID *ourUid,
-        HWIFScanner *scanner) :
+        HWIFScanner *scanner,
+        IngestFilter *ingestFilter) :
         HWIFScannerListener(), ThreadedHandler(3, THREAD_NAMES),
         logger(logger),
+        ingestFilter(ingestFilter),
         ourUid(ourUid),
         scanner(scanner),
         unicastBroadcastContexts(),
@@ -871,13 +873,15 @@ void DatagramSocketManagement::recvQueueThreadProcess()
                     if (!decrypted)
                         throw std::invalid_argument("Decryption failed");
                 }
-                TakMessage msg(logger, data, dataLen, true, true);
-                PGSC::Thread::LockPtr listenerLock(NULL, NULL);
-                PGSC::Thread::Lock_create(listenerLock, listenerMutex);
-                std::set<DatagramListener *>::iterator iter;
-                for (iter = listeners.begin(); iter != listeners.end(); ++iter) {
-                    DatagramListener *l = *iter;
-                    l->datagramReceived(&qItem.endpointId, qItem.sender, &msg);
+                if (!ingestFilter || ingestFilter->accept(data, dataLen)) {
+                    TakMessage msg(logger, data, dataLen, true, true);
+                    PGSC::Thread::LockPtr listenerLock(NULL, NULL);
+                    PGSC::Thread::Lock_create(listenerLock, listenerMutex);
+                    std::set<DatagramListener *>::iterator iter;
+                    for (iter = listeners.begin(); iter != listeners.end(); ++iter) {
+                        DatagramListener *l = *iter;
+                        l->datagramReceived(&qItem.endpointId, qItem.sender, &msg);
+                    }
                 }
             } catch (std::invalid_argument &e) {
                 // Drop this item
@@ -10,6 +10,7 @@
 #include "commoresult.h"
 #include "commotime.h"
 #include "cryptoutil.h"
+#include "ingestfilter.h"
 #include <set>
 #include <map>
 #include <deque>
@@ -42,7 +43,9 @@ class DatagramSocketManagement : public HWIFScannerListener,
                                  public ThreadedHandler
 {
 public:
-    DatagramSocketManagement(CommoLogger *logger, ContactUID *ourUid, HWIFScanner *scanner);
+    // ingestFilter is optional (may be NULL) and must outlive this object
+    DatagramSocketManagement(CommoLogger *logger, ContactUID *ourUid, HWIFScanner *scanner,
+                             IngestFilter *ingestFilter = NULL);
     virtual ~DatagramSocketManagement();
 
 
@@ -205,6 +208,7 @@ private:
     };
 
     CommoLogger *logger;
+    IngestFilter *ingestFilter;
     ContactUID *ourUid;
     HWIFScanner *scanner;
 
@@ -0,0 +1,475 @@
+#include "ingestfilter.h"
+#include "takmessage.h"
+#include <Lock.h>
+
+#include <string.h>
+
+using namespace atakmap::commoncommo;
+using namespace atakmap::commoncommo::impl;
+
+
+namespace {
+    // Per-uid state is kept for at most this many uids. When exceeded,
+    // state older than UID_STATE_EXPIRY_SECS is dropped, and failing that,
+    // everything is.
+    const size_t MAX_TRACKED_UIDS = 20000;
+    const float UID_STATE_EXPIRY_SECS = 300.0f;
+
+    // TAK control/ping traffic is never filtered
+    const char CONTROL_TYPE_PREFIX[] = "t-x-";
+
+    // Protobuf field numbers; see takmessage.proto and cotevent.proto
+    const uint64_t TAKMESSAGE_COTEVENT_FIELD = 2;
+    const uint64_t COTEVENT_TYPE_FIELD = 1;
+    const uint64_t COTEVENT_UID_FIELD = 5;
+    const uint64_t COTEVENT_SENDTIME_FIELD = 6;
+
+    enum {
+        WIRE_VARINT = 0,
+        WIRE_FIXED64 = 1,
+        WIRE_LENGTH = 2,
+        WIRE_FIXED32 = 5
+    };
+
+    bool isXmlSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    void appendUtf8(std::string *out, uint32_t c)
+    {
+        if (c < 0x80) {
+            *out += (char)c;
+        } else if (c < 0x800) {
+            *out += (char)(0xC0 | (c >> 6));
+            *out += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            *out += (char)(0xE0 | (c >> 12));
+            *out += (char)(0x80 | ((c >> 6) & 0x3F));
+            *out += (char)(0x80 | (c & 0x3F));
+        } else {
+            *out += (char)(0xF0 | (c >> 18));
+            *out += (char)(0x80 | ((c >> 12) & 0x3F));
+            *out += (char)(0x80 | ((c >> 6) & 0x3F));
+            *out += (char)(0x80 | (c & 0x3F));
+        }
+    }
+
+    // Decodes the predefined XML entities and character references in
+    // an attribute value, so that values match what the DOM parser
+    // and the TAK protocol path would yield.
+    // False on a malformed or unknown reference.
+    bool decodeXmlValue(std::string *out, const char *v, size_t len)
+    {
+        const char *end = v + len;
+        const char *amp = (const char *)memchr(v, '&', len);
+        if (!amp) {
+            out->assign(v, len);
+            return true;
+        }
+
+        out->assign(v, amp - v);
+        v = amp;
+        while (v < end) {
+            if (*v != '&') {
+                *out += *v++;
+                continue;
+            }
+            const char *semi = (const char *)memchr(v, ';', end - v);
+            if (!semi)
+                return false;
+            const char *ent = v + 1;
+            size_t entLen = semi - ent;
+            if (entLen == 3 && memcmp(ent, "amp", 3) == 0)
+                *out += '&';
+            else if (entLen == 2 && memcmp(ent, "lt", 2) == 0)
+                *out += '<';
+            else if (entLen == 2 && memcmp(ent, "gt", 2) == 0)
+                *out += '>';
+            else if (entLen == 4 && memcmp(ent, "quot", 4) == 0)
+                *out += '"';
+            else if (entLen == 4 && memcmp(ent, "apos", 4) == 0)
+                *out += '\'';
+            else if (entLen >= 2 && ent[0] == '#') {
+                bool hex = (ent[1] == 'x' || ent[1] == 'X');
+                const char *d = ent + (hex ? 2 : 1);
+                if (d == semi)
+                    return false;
+                uint32_t c = 0;
+                for (; d < semi; ++d) {
+                    int digit;
+                    if (*d >= '0' && *d <= '9')
+                        digit = *d - '0';
+                    else if (hex && *d >= 'a' && *d <= 'f')
+                        digit = *d - 'a' + 10;
+                    else if (hex && *d >= 'A' && *d <= 'F')
+                        digit = *d - 'A' + 10;
+                    else
+                        return false;
+                    c = c * (hex ? 16 : 10) + digit;
+                    if (c > 0x10FFFF)
+                        return false;
+                }
+                appendUtf8(out, c);
+            } else {
+                return false;
+            }
+            v = semi + 1;
+        }
+        return true;
+    }
+
+    // False if input is exhausted or the value is too long
+    bool readVarint(const uint8_t **p, const uint8_t *end, uint64_t *v)
+    {
+        uint64_t r = 0;
+        for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+            uint8_t b = *(*p)++;
+            r |= (uint64_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                *v = r;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Walks the fields of one protobuf message.  For each field, the
+    // visitor gets the field number, wire type, and either the varint
+    // value or the bounds of the length-delimited payload.
+    // False on malformed input.
+    template<typename Visitor>
+    bool walkFields(const uint8_t *p, const uint8_t *end, Visitor &visitor)
+    {
+        while (p < end) {
+            uint64_t tag;
+            if (!readVarint(&p, end, &tag))
+                return false;
+            uint64_t field = tag >> 3;
+            uint64_t v = 0;
+            switch (tag & 0x7) {
+            case WIRE_VARINT:
+                if (!readVarint(&p, end, &v))
+                    return false;
+                visitor.varint(field, v);
+                break;
+            case WIRE_FIXED64:
+                if (end - p < 8)
+                    return false;
+                p += 8;
+                break;
+            case WIRE_LENGTH:
+                if (!readVarint(&p, end, &v) || v > (uint64_t)(end - p))
+                    return false;
+                if (!visitor.bytes(field, p, p + v))
+                    return false;
+                p += v;
+                break;
+            case WIRE_FIXED32:
+                if (end - p < 4)
+                    return false;
+                p += 4;
+                break;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct CotEventVisitor
+    {
+        IngestFilter::ScanResult *result;
+
+        void varint(uint64_t field, uint64_t v)
+        {
+            if (field == COTEVENT_SENDTIME_FIELD)
+                result->time = InternalUtils::uint64ToString(v);
+        }
+        bool bytes(uint64_t field, const uint8_t *b, const uint8_t *e)
+        {
+            if (field == COTEVENT_TYPE_FIELD)
+                result->type.assign((const char *)b, e - b);
+            else if (field == COTEVENT_UID_FIELD)
+                result->uid.assign((const char *)b, e - b);
+            return true;
+        }
+    };
+
+    struct TakMessageVisitor
+    {
+        IngestFilter::ScanResult *result;
+        bool foundEvent;
+
+        void varint(uint64_t field, uint64_t v)
+        {
+        }
+        bool bytes(uint64_t field, const uint8_t *b, const uint8_t *e)
+        {
+            if (field != TAKMESSAGE_COTEVENT_FIELD)
+                return true;
+            CotEventVisitor ev = { result };
+            foundEvent = true;
+            return walkFields(b, e, ev);
+        }
+    };
+}
+
+
+IngestFilter::IngestFilter(CommoLogger *logger) :
+        logger(logger),
+        enabled(false),
+        defaultPolicy(),
+        typePolicies(),
+        uidPolicies(),
+        uidStates(),
+        stats(),
+        mutex()
+{
+}
+
+IngestFilter::~IngestFilter()
+{
+}
+
+void IngestFilter::setEnabled(bool enabled)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    this->enabled = enabled;
+    if (!enabled)
+        uidStates.clear();
+}
+
+void IngestFilter::setDefaultPolicy(const IngestPolicy &policy)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    defaultPolicy = policy;
+}
+
+void IngestFilter::setTypePolicy(const std::string &typePrefix,
+                                 const IngestPolicy &policy)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    typePolicies[typePrefix] = policy;
+}
+
+bool IngestFilter::clearTypePolicy(const std::string &typePrefix)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    return typePolicies.erase(typePrefix) == 1;
+}
+
+void IngestFilter::setUidPolicy(const std::string &uid,
+                                const IngestPolicy &policy)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    uidPolicies[uid] = policy;
+}
+
+bool IngestFilter::clearUidPolicy(const std::string &uid)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    return uidPolicies.erase(uid) == 1;
+}
+
+void IngestFilter::getStats(IngestFilterStats *stats)
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    *stats = this->stats;
+}
+
+void IngestFilter::resetStats()
+{
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    stats = IngestFilterStats();
+}
+
+bool IngestFilter::accept(const uint8_t *data, size_t len, bool tryXml,
+                          bool tryProto)
+{
+    {
+        PGSC::Thread::LockPtr lock(NULL, NULL);
+        Lock_create(lock, mutex);
+        if (!enabled)
+            return true;
+    }
+
+    // Scan outside the lock
+    ScanResult scan;
+    bool scanned = false;
+    if (tryXml && tryProto) {
+        size_t hdrLen = TakMessage::getTakProtoHeaderLength(data, len);
+        if (hdrLen)
+            scanned = scanProtobuf(data + hdrLen, len - hdrLen, &scan);
+        else
+            scanned = scanXml(data, len, &scan);
+    } else if (tryXml) {
+        scanned = scanXml(data, len, &scan);
+    } else if (tryProto) {
+        scanned = scanProtobuf(data, len, &scan);
+    }
+
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, mutex);
+    if (!scanned || scan.type.compare(0, sizeof(CONTROL_TYPE_PREFIX) - 1,
+                                      CONTROL_TYPE_PREFIX) == 0) {
+        stats.unscanned++;
+        return true;
+    }
+
+    const IngestPolicy &policy = lookupPolicy(scan);
+    CommoTime now = CommoTime::now();
+    UidStateMap::iterator iter = uidStates.find(scan.uid);
+    if (iter != uidStates.end()) {
+        UidState &state = iter->second;
+        if (policy.dropDuplicates && state.time == scan.time &&
+                                     state.type == scan.type) {
+            stats.droppedDuplicate++;
+            return false;
+        }
+        if (policy.minIntervalMillis > 0 &&
+                now.minus(state.lastAccept) * 1000.0f <
+                                         policy.minIntervalMillis) {
+            stats.droppedRate++;
+            return false;
+        }
+    } else {
+        if (uidStates.size() >= MAX_TRACKED_UIDS)
+            pruneStates(now);
+        iter = uidStates.insert(UidStateMap::value_type(scan.uid,
+                                                        UidState())).first;
+    }
+
+    UidState &state = iter->second;
+    state.type.swap(scan.type);
+    state.time.swap(scan.time);
+    state.lastAccept = now;
+    stats.accepted++;
+    return true;
+}
+
+// Assumes holding of mutex
+const IngestPolicy &IngestFilter::lookupPolicy(const ScanResult &scan) const
+{
+    PolicyMap::const_iterator iter = uidPolicies.find(scan.uid);
+    if (iter != uidPolicies.end())
+        return iter->second;
+
+    const IngestPolicy *ret = &defaultPolicy;
+    size_t bestLen = 0;
+    for (iter = typePolicies.begin(); iter != typePolicies.end(); ++iter) {
+        const std::string &prefix = iter->first;
+        if (prefix.length() >= bestLen &&
+                scan.type.compare(0, prefix.length(), prefix) == 0) {
+            bestLen = prefix.length();
+            ret = &iter->second;
+        }
+    }
+    return *ret;
+}
+
+// Assumes holding of mutex
+void IngestFilter::pruneStates(const CommoTime &now)
+{
+    UidStateMap::iterator iter = uidStates.begin();
+    while (iter != uidStates.end()) {
+        if (now.minus(iter->second.lastAccept) > UID_STATE_EXPIRY_SECS)
+            uidStates.erase(iter++);
+        else
+            ++iter;
+    }
+    if (uidStates.size() >= MAX_TRACKED_UIDS) {
+        InternalUtils::logprintf(logger, CommoLogger::LEVEL_WARNING,
+                "Ingest filter tracking too many uids (%u) - resetting",
+                (unsigned)uidStates.size());
+        uidStates.clear();
+    }
+}
+
+// Pulls attributes from the <event> start tag only
+bool IngestFilter::scanXml(const uint8_t *data, size_t len,
+                           ScanResult *result)
+{
+    const char *p = (const char *)data;
+    const char *end = p + len;
+    const size_t evLen = 6; // "<event"
+
+    while (true) {
+        p = (const char *)memchr(p, '<', end - p);
+        if (!p || (size_t)(end - p) <= evLen)
+            return false;
+        if (memcmp(p, "<event", evLen) == 0 && isXmlSpace(p[evLen]))
+            break;
+        p++;
+    }
+    p += evLen;
+
+    while (p < end) {
+        while (p < end && isXmlSpace(*p))
+            p++;
+        if (p == end || *p == '>' || *p == '/')
+            break;
+
+        const char *name = p;
+        while (p < end && !isXmlSpace(*p) && *p != '=' && *p != '>')
+            p++;
+        size_t nameLen = p - name;
+        while (p < end && isXmlSpace(*p))
+            p++;
+        if (p == end || *p != '=')
+            return false;
+        p++;
+        while (p < end && isXmlSpace(*p))
+            p++;
+        if (p == end || (*p != '"' && *p != '\''))
+            return false;
+        const char *value = p + 1;
+        p = (const char *)memchr(value, *p, end - value);
+        if (!p)
+            return false;
+        size_t valueLen = p - value;
+        p++;
+
+        std::string *dest = NULL;
+        if (nameLen == 3 && memcmp(name, "uid", 3) == 0)
+            dest = &result->uid;
+        else if (nameLen == 4 && memcmp(name, "type", 4) == 0)
+            dest = &result->type;
+        else if (nameLen == 4 && memcmp(name, "time", 4) == 0)
+            dest = &result->time;
+        if (dest && !decodeXmlValue(dest, value, valueLen))
+            return false;
+    }
+    if (result->uid.empty() || result->type.empty())
+        return false;
+
+    // Key on the same posix millis the TAK protocol path uses, so a
+    // message seen in both encodings is recognized as a duplicate
+    if (!result->time.empty()) {
+        try {
+            uint64_t millis = CommoTime::fromUTCString(result->time).getPosixMillis();
+            result->time = InternalUtils::uint64ToString(millis);
+        } catch (std::invalid_argument &) {
+            // keep the raw value; it still identifies repeats of this message
+        }
+    }
+    return true;
+}
+
+// data is a bare TakMessage (no header)
+bool IngestFilter::scanProtobuf(const uint8_t *data, size_t len,
+                                ScanResult *result)
+{
+    TakMessageVisitor visitor = { result, false };
+    if (!walkFields(data, data + len, visitor) || !visitor.foundEvent)
+        return false;
+    return !result->uid.empty() && !result->type.empty();
+}
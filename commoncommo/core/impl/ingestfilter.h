@@ -0,0 +1,114 @@
+#ifndef IMPL_INGESTFILTER_H_
+#define IMPL_INGESTFILTER_H_
+
+#include "commologger.h"
+#include "cotmessageio.h"
+#include "commotime.h"
+#include "internalutils.h"
+#include <Mutex.h>
+#include <map>
+#include <string>
+
+namespace atakmap {
+namespace commoncommo {
+namespace impl
+{
+
+
+struct IngestPolicy
+{
+    // Drop messages repeating the uid, type and time of the last
+    // message accepted from that uid (same message arriving via
+    // multiple paths or re-sent)
+    bool dropDuplicates;
+    // Drop messages from a uid arriving sooner than this many
+    // milliseconds after the last one accepted from it. 0 to disable.
+    int minIntervalMillis;
+
+    IngestPolicy(bool dropDuplicates = true, int minIntervalMillis = 0) :
+            dropDuplicates(dropDuplicates),
+            minIntervalMillis(minIntervalMillis)
+    {
+    }
+};
+
+
+// Cheap pre-parse gate for received CoT.  Pulls uid, type and time from
+// the raw XML or TAK protocol bytes without building a DOM and decides
+// if the message is worth a full parse.  Anything that cannot be scanned,
+// and TAK control messages, always pass.
+// Disabled (accept everything) until enabled.  Safe for use from
+// multiple rx threads at once.
+class IngestFilter
+{
+public:
+    struct ScanResult
+    {
+        std::string uid;
+        std::string type;
+        // Raw time attribute for xml, decimal send time millis for proto
+        std::string time;
+    };
+
+    IngestFilter(CommoLogger *logger);
+    ~IngestFilter();
+
+    void setEnabled(bool enabled);
+
+    // Policy applied to types not matching any type policy
+    void setDefaultPolicy(const IngestPolicy &policy);
+    // Policies apply to types beginning with typePrefix; the longest
+    // matching prefix wins. Uid policies take precedence over type policies.
+    void setTypePolicy(const std::string &typePrefix,
+                       const IngestPolicy &policy);
+    bool clearTypePolicy(const std::string &typePrefix);
+    void setUidPolicy(const std::string &uid, const IngestPolicy &policy);
+    bool clearUidPolicy(const std::string &uid);
+
+    // Same conventions as TakMessage's deserializing constructor:
+    // with tryXml and tryProto both true, TAK protocol is assumed if the
+    // data starts with a TAK protocol header, else xml.  For tryProto
+    // alone the data is a bare TakMessage.
+    // Returns true if the message should be parsed and delivered.
+    bool accept(const uint8_t *data, size_t len, bool tryXml = true,
+                bool tryProto = true);
+
+    void getStats(IngestFilterStats *stats);
+    void resetStats();
+
+    static bool scanXml(const uint8_t *data, size_t len, ScanResult *result);
+    static bool scanProtobuf(const uint8_t *data, size_t len,
+                             ScanResult *result);
+
+private:
+    COMMO_DISALLOW_COPY(IngestFilter);
+
+    struct UidState
+    {
+        std::string type;
+        std::string time;
+        CommoTime lastAccept;
+
+        UidState() : type(), time(), lastAccept(CommoTime::ZERO_TIME) {}
+    };
+    typedef std::map<std::string, IngestPolicy> PolicyMap;
+    typedef std::map<std::string, UidState> UidStateMap;
+
+    const IngestPolicy &lookupPolicy(const ScanResult &scan) const;
+    void pruneStates(const CommoTime &now);
+
+    CommoLogger *logger;
+    bool enabled;
+    IngestPolicy defaultPolicy;
+    PolicyMap typePolicies;
+    PolicyMap uidPolicies;
+    UidStateMap uidStates;
+    IngestFilterStats stats;
+    PGSC::Thread::Mutex mutex;
+};
+
+}
+}
+}
+
+#endif
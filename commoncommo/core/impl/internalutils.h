@@ -7,6 +7,7 @@
 #include "commoresult.h"
 #include <string>
 #include <stdexcept>
+#include <atomic>
 #include <curl/curl.h>
 #include "openssl/ssl.h"
 #include "openssl/pkcs12.h"
@@ -145,6 +146,64 @@ private:
     InternalUtils() {};
 };
 
+// Bounded, lock-free queue for exactly one producer thread and exactly
+// one consumer thread.  Capacity is rounded up to a power of 2.
+// T must be default constructible and assignable; slots are reused
+// and never destructed until the ring itself is.
+template<typename T> class SpscRing
+{
+public:
+    explicit SpscRing(size_t minCapacity) : slots(NULL), mask(0),
+                                            head(0), tail(0)
+    {
+        size_t n = 2;
+        while (n < minCapacity)
+            n <<= 1;
+        slots = new T[n];
+        mask = n - 1;
+    }
+    ~SpscRing()
+    {
+        delete[] slots;
+    }
+
+    // Producer only. False if the ring is full.
+    bool push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask)
+            return false;
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Consumer only. False if the ring is empty.
+    bool pop(T *item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        *item = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; only a snapshot.
+    bool empty() const
+    {
+        return head.load(std::memory_order_seq_cst) ==
+               tail.load(std::memory_order_seq_cst);
+    }
+
+private:
+    COMMO_DISALLOW_COPY(SpscRing);
+    T *slots;
+    size_t mask;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+};
+
 struct InternalContactUID : public ContactUID
 {
     InternalContactUID(const uint8_t *uid, size_t len);
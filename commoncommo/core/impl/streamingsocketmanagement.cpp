@@ -51,8 +51,10 @@ namespace {
 
 
 StreamingSocketManagement::StreamingSocketManagement(CommoLogger *logger,
-                                                const std::string &myuid) :
+                                                const std::string &myuid,
+                                                IngestFilter *ingestFilter) :
         ThreadedHandler(3, THREAD_NAMES), logger(logger),
+        ingestFilter(ingestFilter),
         resolver(new ResolverQueue(logger, this, RESOLVE_RETRY_SECONDS, RESQ_INFINITE_TRIES)),
         connTimeoutSec(DEFAULT_CONN_TIMEOUT_SECONDS),
         monitor(true),
@@ -1316,6 +1318,11 @@ bool StreamingSocketManagement::dispatchRxMessage(ConnectionContext *ctx,
 {
     bool ret = false;
 
+    // Drop early if filtered; control traffic always passes the filter
+    if (ingestFilter && !ingestFilter->accept(ctx->rxBuf + ctx->rxBufStart,
+                                              len, isXml, !isXml))
+        return ret;
+
     // Convert the data to a CoTMessage
     try {
         TakMessage takmsg(logger, ctx->rxBuf + ctx->rxBufStart,
@@ -13,6 +13,7 @@
 #include "cotmessage.h"
 #include "resolverqueue.h"
 #include "internalutils.h"
+#include "ingestfilter.h"
 
 #include <Mutex.h>
 #include <RWMutex.h>
@@ -49,7 +50,9 @@ private:
 class StreamingSocketManagement : public ThreadedHandler, public ResolverListener
 {
 public:
-    StreamingSocketManagement(CommoLogger *logger, const std::string &myuid);
+    // ingestFilter is optional (may be NULL) and must outlive this object
+    StreamingSocketManagement(CommoLogger *logger, const std::string &myuid,
+                              IngestFilter *ingestFilter = NULL);
     virtual ~StreamingSocketManagement();
 
     void setMonitor(bool enable);
@@ -299,6 +302,7 @@ private:
     };
 
     CommoLogger *logger;
+    IngestFilter *ingestFilter;
     ResolverQueue *resolver;
     float connTimeoutSec;
     bool monitor;
@@ -127,6 +127,11 @@ TakMessage::TakMessage(CommoLogger *logger, const uint8_t *data, size_t len,
         throw std::invalid_argument("No decode mode given");
 }
 
+size_t TakMessage::getTakProtoHeaderLength(const uint8_t *data, size_t len)
+{
+    return isTAKProtoHeader(data, len);
+}
+
 TakMessage::~TakMessage()
 {
     delete protoInfo;
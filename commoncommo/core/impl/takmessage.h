@@ -107,6 +107,10 @@ public:
     // If not supported, return 0. Else return the supplied number
     static int checkProtoVersion(int protoVersion);
 
+    // If data begins with a supported TAK protocol header, returns the
+    // length of that header. Else returns 0.
+    static size_t getTakProtoHeaderLength(const uint8_t *data, size_t len);
+
 private:
     COMMO_DISALLOW_COPY(TakMessage);
     void initFromXml(const uint8_t *data, size_t len) 
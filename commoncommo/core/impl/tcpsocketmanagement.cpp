@@ -14,6 +14,12 @@ using namespace atakmap::commoncommo::impl;
 namespace {
     const int LISTEN_BACKLOG = 15;
     const size_t RX_CLIENT_MAX_DATA_LEN = 500 * 1024;
+    const size_t RX_BUFFER_INITIAL_LEN = 5 * 1024;
+    // Framing buffers larger than this are freed rather than reused
+    const size_t RX_BUFFER_POOL_MAX_LEN = 64 * 1024;
+    const size_t RX_BUFFER_POOL_MAX_COUNT = 64;
+    const size_t CLIENT_POOL_MAX_COUNT = 64;
+    const size_t RX_RING_CAPACITY = 1024;
     const float INBOUND_RETRY_SECS = 60.0f;
     const float DEFAULT_CONN_TIMEOUT_SEC = 20.0f;
 
@@ -26,25 +32,37 @@ namespace {
 
 
 TcpSocketManagement::TcpSocketManagement(CommoLogger *logger, 
-                                         ContactUID *ourUid) :
+                                         ContactUID *ourUid,
+                                         IngestFilter *ingestFilter) :
         ThreadedHandler(3, THREAD_NAMES),
         logger(logger),
+        ingestFilter(ingestFilter),
         ourUid(ourUid),
         resolver(NULL),
         connTimeoutSec(DEFAULT_CONN_TIMEOUT_SEC),
         rxCrypto(NULL),
+        rxCryptoMutex(),
         txCrypto(NULL),
         inboundContexts(),
+        inboundChanges(),
+        inboundChangesPending(false),
+        inboundMutex(),
+        ioInboundContexts(),
         inboundNeedsRebuild(false),
         clientContexts(),
+        freeClientContexts(),
+        freeRxBuffers(),
+        rxOverflow(),
         txContexts(),
         txNeedsRebuild(false),
         txMutex(),
         resolverContexts(),
         resolverContextsMutex(),
-        rxQueue(),
-        rxQueueMutex(),
-        rxQueueMonitor(),
+        rxRing(RX_RING_CAPACITY),
+        rxBufferReturn(RX_RING_CAPACITY),
+        rxThreadWaiting(false),
+        rxWakeMutex(),
+        rxWakeMonitor(),
         txErrQueue(),
         txErrQueueMutex(),
         txErrQueueMonitor(),
@@ -54,7 +72,6 @@ TcpSocketManagement::TcpSocketManagement(CommoLogger *logger,
         txErrListenerMutex(),
         ifaceListeners(),
         ifaceListenerMutex(),
-        globalIOMutex(PGSC::Thread::TERW_Fair),
         selector()
 {
     resolver = new ResolverQueue(logger, this, 5.0f, 1);
@@ -68,15 +85,22 @@ TcpSocketManagement::~TcpSocketManagement()
 
     // With the threads all joined, we can remove everything safely
     // Clean the queues first
-    while (!rxQueue.empty()) {
-        RxQueueItem rxi = rxQueue.back();
-        rxQueue.pop_back();
+    RxQueueItem rxi;
+    while (rxRing.pop(&rxi))
         rxi.implode();
+    while (!rxOverflow.empty()) {
+        rxOverflow.front().implode();
+        rxOverflow.pop_front();
     }
+    ioThreadReclaimBuffers();
+    for (size_t i = 0; i < freeRxBuffers.size(); ++i)
+        delete[] freeRxBuffers[i].data;
     
+    // Pick up any interface changes the io thread never saw
+    ioThreadApplyInboundChanges();
     InboundCtxSet::iterator inbIter;
-    for (inbIter = inboundContexts.begin(); 
-                inbIter != inboundContexts.end(); ++inbIter) {
+    for (inbIter = ioInboundContexts.begin(); 
+                inbIter != ioInboundContexts.end(); ++inbIter) {
         delete *inbIter;
     }
 
@@ -85,6 +109,8 @@ TcpSocketManagement::~TcpSocketManagement()
                 clIter != clientContexts.end(); ++clIter) {
         delete *clIter;
     }
+    for (size_t i = 0; i < freeClientContexts.size(); ++i)
+        delete freeClientContexts[i];
 
     TxCtxSet::iterator txIter;
     for (txIter = txContexts.begin(); 
@@ -121,8 +147,8 @@ void TcpSocketManagement::threadStopSignal(size_t threadNum)
     case RX_QUEUE_THREADID:
         {
             PGSC::Thread::LockPtr lock(NULL, NULL);
-            Lock_create(lock, rxQueueMutex);
-            rxQueueMonitor.broadcast(*lock);
+            Lock_create(lock, rxWakeMutex);
+            rxWakeMonitor.broadcast(*lock);
             break;
         }
     }
@@ -131,16 +157,18 @@ void TcpSocketManagement::threadStopSignal(size_t threadNum)
 
 TcpInboundNetInterface *TcpSocketManagement::addInboundInterface(int port)
 {
-    PGSC::Thread::WriteLockPtr lock(NULL, NULL);
-    WriteLock_create(lock, globalIOMutex);
-    
     if (port > UINT16_MAX || port < 0)
         return NULL;
     uint16_t sport = (uint16_t)port;
 
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, inboundMutex);
+    
     InboundContext *newCtx = new InboundContext(sport);
-    if (inboundContexts.find(newCtx) != inboundContexts.end())
+    if (inboundContexts.find(newCtx) != inboundContexts.end()) {
+        delete newCtx;
         return NULL;
+    }
     
     try {
         newCtx->initSocket();
@@ -150,24 +178,32 @@ TcpInboundNetInterface *TcpSocketManagement::addInboundInterface(int port)
     }
     
     inboundContexts.insert(newCtx);
-    inboundNeedsRebuild = true;
+    InboundChange change = { newCtx, true };
+    inboundChanges.push_back(change);
+    inboundChangesPending = true;
     return newCtx;
 }
 
 CommoResult TcpSocketManagement::removeInboundInterface(
                                        TcpInboundNetInterface *iface)
 {
-    PGSC::Thread::WriteLockPtr lock(NULL, NULL);
-    WriteLock_create(lock, globalIOMutex);
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, inboundMutex);
     
+    // Compare by identity; the set itself is ordered by port
     InboundContext *ctx = (InboundContext *)iface;
     InboundCtxSet::iterator iter = inboundContexts.find(ctx);
-    if (iter == inboundContexts.end())
+    if (iter == inboundContexts.end() || *iter != ctx)
         return COMMO_ILLEGAL_ARGUMENT;
     
-    inboundContexts.erase(ctx);
-    delete ctx;
-    inboundNeedsRebuild = true;
+    // Release the port now; the io thread drops the context from its
+    // select set and deletes it
+    inboundContexts.erase(iter);
+    delete ctx->socket;
+    ctx->socket = NULL;
+    InboundChange change = { ctx, false };
+    inboundChanges.push_back(change);
+    inboundChangesPending = true;
     return COMMO_SUCCESS;
 }
 
@@ -181,7 +217,7 @@ void TcpSocketManagement::setCryptoKeys(const uint8_t *authKey,
 {
     {
         PGSC::Thread::LockPtr lock(NULL, NULL);
-        PGSC::Thread::Lock_create(lock, rxQueueMutex);
+        PGSC::Thread::Lock_create(lock, rxCryptoMutex);
         
         if (rxCrypto) {
             delete rxCrypto;
@@ -319,10 +355,12 @@ void TcpSocketManagement::removeInterfaceStatusListener(
     ifaceListeners.erase(listener);
 }
 
-// Assumes holding of global IO mutex
+// Invoked on io thread only
 void TcpSocketManagement::fireIfaceStatus(TcpInboundNetInterface *iface,
                                           bool up)
 {
+    PGSC::Thread::LockPtr lock(NULL, NULL);
+    Lock_create(lock, ifaceListenerMutex);
     std::set<InterfaceStatusListener *>::iterator iter;
     for (iter = ifaceListeners.begin(); iter != ifaceListeners.end(); ++iter) {
         InterfaceStatusListener *listener = *iter;
@@ -359,9 +397,12 @@ void TcpSocketManagement::ioThreadProcess()
     TxCtxSet curTxSet;
 
     while (!threadShouldStop(IO_THREADID)) {
-        PGSC::Thread::ReadLockPtr lock(NULL, NULL);
-        ReadLock_create(lock, globalIOMutex);
         bool resetSelect = false;
+
+        if (inboundChangesPending)
+            ioThreadApplyInboundChanges();
+        ioThreadReclaimBuffers();
+        ioThreadFlushRx();
         
         if (!inboundNeedsRebuild && 
                     !inboundErroredCtxs.empty() &&
@@ -373,9 +414,11 @@ void TcpSocketManagement::ioThreadProcess()
             resetSelect = true;
             inboundErroredCtxs.clear();
             readSocks.clear();
+            PGSC::Thread::LockPtr inboundLock(NULL, NULL);
+            Lock_create(inboundLock, inboundMutex);
             InboundCtxSet::iterator inbIter;
-            for (inbIter = inboundContexts.begin(); 
-                         inbIter != inboundContexts.end(); ++inbIter) {
+            for (inbIter = ioInboundContexts.begin(); 
+                         inbIter != ioInboundContexts.end(); ++inbIter) {
                 InboundContext *ctx = *inbIter;
                 if (!ctx->socket && nowTime > ctx->retryTime) {
                     try {
@@ -457,7 +500,8 @@ void TcpSocketManagement::ioThreadProcess()
 
         bool killAllSockets = false;
         try {
-            if (!selector.doSelect(250)) {
+            // Come back quickly to retry a backed up hand off
+            if (!selector.doSelect(rxOverflow.empty() ? 250 : 5)) {
                 // Timeout
                 CommoTime nowTime = CommoTime::now();
                 TxCtxSet::iterator txIter;
@@ -474,6 +518,10 @@ void TcpSocketManagement::ioThreadProcess()
             }
 
         } catch (SocketException &) {
+            // A removed interface's listening socket may have been closed
+            // out from under the select set; just rebuild without it
+            if (inboundChangesPending)
+                continue;
             // odd. Force a rebuild
             logger->log(CommoLogger::LEVEL_ERROR, "tcp main io select failed");
             killAllSockets = true;
@@ -491,7 +539,7 @@ void TcpSocketManagement::ioThreadProcess()
             clientIter++;
 
             if (killAllSockets) {
-                delete ctx;
+                ioThreadRecycleClient(ctx);
                 clientContexts.erase(curIter);
                 inboundNeedsRebuild = true;
 
@@ -506,8 +554,9 @@ void TcpSocketManagement::ioThreadProcess()
                                 throw SocketException(netinterfaceenums::ERR_OTHER,
                                                       "Client sent excessive amount of data");
                             }
-                            n = 5 * 1024;
-                            ctx->growCapacity(n);
+                            ctx->growCapacity(RX_BUFFER_INITIAL_LEN,
+                                    RX_CLIENT_MAX_DATA_LEN + RX_BUFFER_INITIAL_LEN);
+                            n = ctx->bufLen - ctx->len;
                         }
                         n = ctx->socket->read(ctx->data + ctx->len, n);
                         if (!n)
@@ -519,15 +568,17 @@ void TcpSocketManagement::ioThreadProcess()
                     // If we got any data, pass it on
                     if (!abort)
                         ioThreadQueueRx(ctx);
-                    delete ctx;
+                    ioThreadRecycleClient(ctx);
                     clientContexts.erase(curIter);
                     inboundNeedsRebuild = true;
                 }
             }
         }
 
-        for (InboundCtxSet::iterator inbIter = inboundContexts.begin(); 
-                     inbIter != inboundContexts.end(); ++inbIter) {
+        PGSC::Thread::LockPtr inboundLock(NULL, NULL);
+        Lock_create(inboundLock, inboundMutex);
+        for (InboundCtxSet::iterator inbIter = ioInboundContexts.begin(); 
+                     inbIter != ioInboundContexts.end(); ++inbIter) {
             InboundContext *ctx = *inbIter;
             bool ctxErr = killAllSockets;
             if (!ctxErr && ctx->socket && selector.getLastReadState(ctx->socket) == NetSelector::READABLE) {
@@ -538,9 +589,9 @@ void TcpSocketManagement::ioThreadProcess()
                         if (!clientSock)
                             break;
 
-                        ClientContext *cctx = new ClientContext(clientSock,
-                                                                clientAddr,
-                                                                ctx->endpoint);
+                        ClientContext *cctx = ioThreadObtainClient(clientSock,
+                                                                   clientAddr,
+                                                                   ctx->endpoint);
                         clientContexts.insert(cctx);
                         inboundNeedsRebuild = true;
                     }
@@ -551,6 +602,7 @@ void TcpSocketManagement::ioThreadProcess()
             if (ctxErr)
                 ioThreadResetInboundCtx(ctx, true);
         }
+        inboundLock.reset();
 
 
         TxCtxSet::iterator txIter;
@@ -611,35 +663,45 @@ void TcpSocketManagement::ioThreadProcess()
 
 void TcpSocketManagement::recvQueueThreadProcess()
 {
+    RxQueueItem qItem;
     while (!threadShouldStop(RX_QUEUE_THREADID)) {
-        PGSC::Thread::LockPtr qLock(NULL, NULL);
-        Lock_create(qLock, rxQueueMutex);
-        if (rxQueue.empty()) {
-            rxQueueMonitor.wait(*qLock);
+        if (!rxRing.pop(&qItem)) {
+            // Only sleep if the io thread has not slipped something in
+            // since we checked; it signals under rxWakeMutex
+            PGSC::Thread::LockPtr wakeLock(NULL, NULL);
+            Lock_create(wakeLock, rxWakeMutex);
+            rxThreadWaiting = true;
+            if (rxRing.empty() && !threadShouldStop(RX_QUEUE_THREADID))
+                rxWakeMonitor.wait(*wakeLock);
+            rxThreadWaiting = false;
             continue;
         }
 
-        RxQueueItem qItem = rxQueue.back();
-        rxQueue.pop_back();
         uint8_t *data = qItem.data;
         size_t dataLen = qItem.dataLen;
         bool decrypted = false;
         try {
-            if (rxCrypto) {
-                decrypted = rxCrypto->decrypt(&data, &dataLen);
-                if (!decrypted)
-                    throw std::invalid_argument("Unable to decrypt");
+            {
+                PGSC::Thread::LockPtr cryptoLock(NULL, NULL);
+                Lock_create(cryptoLock, rxCryptoMutex);
+                if (rxCrypto) {
+                    decrypted = rxCrypto->decrypt(&data, &dataLen);
+                    if (!decrypted)
+                        throw std::invalid_argument("Unable to decrypt");
+                }
             }
-            TakMessage takmsg(logger, data, dataLen, true, true);
-            const CoTMessage *msg = takmsg.getCoTMessage();
-            if (msg) {
-                PGSC::Thread::LockPtr listenerLock(NULL, NULL);
-                Lock_create(listenerLock, listenerMutex);
-                std::set<TcpMessageListener *>::iterator iter;
-                for (iter = listeners.begin(); iter != listeners.end(); 
-                                                                 ++iter) {
-                    TcpMessageListener *l = *iter;
-                    l->tcpMessageReceived(qItem.sender, &qItem.endpoint, msg);
+            if (!ingestFilter || ingestFilter->accept(data, dataLen)) {
+                TakMessage takmsg(logger, data, dataLen, true, true);
+                const CoTMessage *msg = takmsg.getCoTMessage();
+                if (msg) {
+                    PGSC::Thread::LockPtr listenerLock(NULL, NULL);
+                    Lock_create(listenerLock, listenerMutex);
+                    std::set<TcpMessageListener *>::iterator iter;
+                    for (iter = listeners.begin(); iter != listeners.end(); 
+                                                                     ++iter) {
+                        TcpMessageListener *l = *iter;
+                        l->tcpMessageReceived(qItem.sender, &qItem.endpoint, msg);
+                    }
                 }
             }
         } catch (std::invalid_argument &e) {
@@ -648,6 +710,11 @@ void TcpSocketManagement::recvQueueThreadProcess()
         }
         if (decrypted)
             delete[] data;
+
+        // Hand the framing buffer back for reuse by a future connection
+        if (qItem.bufLen <= RX_BUFFER_POOL_MAX_LEN &&
+                rxBufferReturn.push(RxBuffer(qItem.data, qItem.bufLen)))
+            qItem.data = NULL;
         qItem.implode();
     }
 }
@@ -710,7 +777,7 @@ void TcpSocketManagement::killTxCtx(TxContext *ctx, bool removeFromCtxSet)
 
 // Close socket if non-null.
 // Set retry time. flag inbound rebuild if flagReset true
-// Assumes holding of globalIOMutex
+// Invoked on io thread only
 void TcpSocketManagement::ioThreadResetInboundCtx(InboundContext *ctx,
                                                   bool flagReset)
 {
@@ -727,6 +794,81 @@ void TcpSocketManagement::ioThreadResetInboundCtx(InboundContext *ctx,
         inboundNeedsRebuild = true;
 }
 
+// Pick up interface additions and removals posted by other threads
+void TcpSocketManagement::ioThreadApplyInboundChanges()
+{
+    std::vector<InboundChange> changes;
+    {
+        PGSC::Thread::LockPtr lock(NULL, NULL);
+        Lock_create(lock, inboundMutex);
+        changes.swap(inboundChanges);
+        inboundChangesPending = false;
+    }
+
+    // Apply in posting order; the set is keyed on port, so a removal
+    // must take effect before a later addition on the same port
+    for (size_t i = 0; i < changes.size(); ++i) {
+        InboundContext *ctx = changes[i].ctx;
+        if (changes[i].add) {
+            ioInboundContexts.insert(ctx);
+        } else {
+            InboundCtxSet::iterator iter = ioInboundContexts.find(ctx);
+            if (iter != ioInboundContexts.end() && *iter == ctx)
+                ioInboundContexts.erase(iter);
+            delete ctx;
+        }
+    }
+    if (!changes.empty())
+        inboundNeedsRebuild = true;
+}
+
+TcpSocketManagement::ClientContext *TcpSocketManagement::ioThreadObtainClient(
+        TcpSocket *socket, NetAddress *clientAddr, const std::string &endpoint)
+{
+    ClientContext *ctx;
+    if (freeClientContexts.empty()) {
+        ctx = new ClientContext();
+    } else {
+        ctx = freeClientContexts.back();
+        freeClientContexts.pop_back();
+    }
+    ctx->reset(socket, clientAddr, endpoint);
+    if (!ctx->data && !freeRxBuffers.empty()) {
+        ctx->data = freeRxBuffers.back().data;
+        ctx->bufLen = freeRxBuffers.back().bufLen;
+        freeRxBuffers.pop_back();
+    }
+    return ctx;
+}
+
+// Close out the connection, keeping the context and its buffer for
+// reuse if the pool has room and the buffer is not oversized
+void TcpSocketManagement::ioThreadRecycleClient(ClientContext *ctx)
+{
+    if (freeClientContexts.size() >= CLIENT_POOL_MAX_COUNT) {
+        delete ctx;
+        return;
+    }
+    ctx->reset(NULL, NULL, std::string());
+    if (ctx->bufLen > RX_BUFFER_POOL_MAX_LEN) {
+        delete[] ctx->data;
+        ctx->clearBuffers();
+    }
+    freeClientContexts.push_back(ctx);
+}
+
+// Take back buffers the rx thread is done with
+void TcpSocketManagement::ioThreadReclaimBuffers()
+{
+    RxBuffer buf;
+    while (rxBufferReturn.pop(&buf)) {
+        if (freeRxBuffers.size() < RX_BUFFER_POOL_MAX_COUNT)
+            freeRxBuffers.push_back(buf);
+        else
+            delete[] buf.data;
+    }
+}
+
 // Move any received data to rx queue; if nothing there, just
 // no-op
 void TcpSocketManagement::ioThreadQueueRx(ClientContext *ctx)
@@ -734,13 +876,34 @@ void TcpSocketManagement::ioThreadQueueRx(ClientContext *ctx)
     if (ctx->len == 0)
         return;
 
-    {
+    RxQueueItem rx(ctx->clientAddr, ctx->endpoint, ctx->data, ctx->len,
+                   ctx->bufLen);
+    ctx->clearBuffers();
+    // Preserve ordering behind anything already backed up
+    if (!rxOverflow.empty() || !rxRing.push(rx))
+        rxOverflow.push_back(rx);
+    else
+        wakeRxThread();
+}
+
+// Retry hand off of items that did not fit in the ring
+void TcpSocketManagement::ioThreadFlushRx()
+{
+    bool pushed = false;
+    while (!rxOverflow.empty() && rxRing.push(rxOverflow.front())) {
+        rxOverflow.pop_front();
+        pushed = true;
+    }
+    if (pushed)
+        wakeRxThread();
+}
+
+void TcpSocketManagement::wakeRxThread()
+{
+    if (rxThreadWaiting) {
         PGSC::Thread::LockPtr lock(NULL, NULL);
-        Lock_create(lock, rxQueueMutex);
-        RxQueueItem rx(ctx->clientAddr, ctx->endpoint, ctx->data, ctx->len);
-        ctx->clearBuffers();
-        rxQueue.push_front(rx);
-        rxQueueMonitor.broadcast(*lock);
+        Lock_create(lock, rxWakeMutex);
+        rxWakeMonitor.broadcast(*lock);
     }
 }
 
@@ -750,13 +913,24 @@ void TcpSocketManagement::ioThreadQueueRx(ClientContext *ctx)
 
 
 
+TcpSocketManagement::RxQueueItem::RxQueueItem() :
+                          sender(NULL),
+                          endpoint(),
+                          data(NULL),
+                          dataLen(0),
+                          bufLen(0)
+{
+}
+
 TcpSocketManagement::RxQueueItem::RxQueueItem(
         NetAddress *sender, const std::string &endpoint,
         uint8_t *data,
-        size_t nData) :   sender(sender),
+        size_t nData,
+        size_t bufLen) :  sender(sender),
                           endpoint(endpoint),
                           data(data),
-                          dataLen(nData)
+                          dataLen(nData),
+                          bufLen(bufLen)
 {
 }
 
@@ -768,6 +942,8 @@ void TcpSocketManagement::RxQueueItem::implode()
 {
     delete sender;
     delete[] data;
+    sender = NULL;
+    data = NULL;
 }
 
 
@@ -823,12 +999,10 @@ void TcpSocketManagement::InboundContext::initSocket() COMMO_THROW (SocketExcept
 }
 
 
-TcpSocketManagement::ClientContext::ClientContext(TcpSocket *socket,
-                                                  NetAddress *clientAddr,
-                                                  const std::string &endpoint) :
-        clientAddr(clientAddr),
-        endpoint(endpoint),
-        socket(socket),
+TcpSocketManagement::ClientContext::ClientContext() :
+        clientAddr(NULL),
+        endpoint(),
+        socket(NULL),
         data(NULL),
         len(0),
         bufLen(0)
@@ -842,9 +1016,28 @@ TcpSocketManagement::ClientContext::~ClientContext()
     delete clientAddr;
 }
 
-void TcpSocketManagement::ClientContext::growCapacity(size_t n)
+// Close out any prior connection and take on a new one.
+// Existing buffer is kept but emptied.
+void TcpSocketManagement::ClientContext::reset(TcpSocket *socket,
+                                               NetAddress *clientAddr,
+                                               const std::string &endpoint)
+{
+    delete this->socket;
+    delete this->clientAddr;
+    this->socket = socket;
+    this->clientAddr = clientAddr;
+    this->endpoint = endpoint;
+    len = 0;
+}
+
+void TcpSocketManagement::ClientContext::growCapacity(size_t n, size_t maxLen)
 {
-    size_t newLen = bufLen + n;
+    // Double to keep the number of copies logarithmic in message size
+    size_t newLen = bufLen * 2;
+    if (newLen < bufLen + n)
+        newLen = bufLen + n;
+    if (newLen > maxLen && maxLen > bufLen)
+        newLen = maxLen;
     uint8_t *newBuf = new uint8_t[newLen];
     if (data) {
         memcpy(newBuf, data, len);
@@ -854,7 +1047,7 @@ void TcpSocketManagement::ClientContext::growCapacity(size_t n)
     bufLen = newLen;
 }
 
-// wipe buffer data so it isn't free'd
+// wipe buffer data and client address so they aren't free'd
 void TcpSocketManagement::ClientContext::clearBuffers()
 {
     data = NULL;
@@ -9,10 +9,14 @@
 #include "commotime.h"
 #include "resolverqueue.h"
 #include "cryptoutil.h"
+#include "ingestfilter.h"
 #include <set>
 #include <map>
 #include <deque>
-#include <RWMutex.h>
+#include <vector>
+#include <atomic>
+#include <Mutex.h>
+#include <Cond.h>
 
 namespace atakmap {
 namespace commoncommo {
@@ -39,7 +43,9 @@ private:
 class TcpSocketManagement : public ThreadedHandler, public ResolverListener
 {
 public:
-    TcpSocketManagement(CommoLogger *logger, ContactUID *ourUid);
+    // ingestFilter is optional (may be NULL) and must outlive this object
+    TcpSocketManagement(CommoLogger *logger, ContactUID *ourUid,
+                        IngestFilter *ingestFilter = NULL);
     virtual ~TcpSocketManagement();
 
 
@@ -110,6 +116,9 @@ private:
         COMMO_DISALLOW_COPY(InboundContext);
     };
     
+    // Pooled on the io thread; socket and clientAddr are only valid
+    // while the context is in use, but the framing buffer is kept
+    // for the next connection when the data was not handed off
     struct ClientContext
     {
         NetAddress *clientAddr;
@@ -120,16 +129,29 @@ private:
         size_t len;
         size_t bufLen;
         
-        ClientContext(TcpSocket *socket, NetAddress *clientAddr,
-                      const std::string &endpoint);
+        ClientContext();
         ~ClientContext();
         
-        void growCapacity(size_t n);
+        void reset(TcpSocket *socket, NetAddress *clientAddr,
+                   const std::string &endpoint);
+        // Grows buffer to hold at least n more bytes than the current
+        // capacity, never exceeding maxLen total
+        void growCapacity(size_t n, size_t maxLen);
         void clearBuffers();
     private:
         COMMO_DISALLOW_COPY(ClientContext);
     };
 
+    // Emptied framing buffer on its way back to the io thread for reuse
+    struct RxBuffer
+    {
+        uint8_t *data;
+        size_t bufLen;
+
+        RxBuffer() : data(NULL), bufLen(0) {};
+        RxBuffer(uint8_t *data, size_t bufLen) : data(data), bufLen(bufLen) {};
+    };
+
 
     struct TxContext
     {
@@ -171,9 +193,11 @@ private:
         std::string endpoint;
         uint8_t *data;
         size_t dataLen;
+        size_t bufLen;
 
+        RxQueueItem();
         RxQueueItem(NetAddress *sender, const std::string &endpoint,
-                    uint8_t *data, size_t dataLen);
+                    uint8_t *data, size_t dataLen, size_t bufLen);
         // Copy is ok
         ~RxQueueItem();
         void implode();
@@ -197,18 +221,41 @@ private:
 
 
     CommoLogger *logger;
+    IngestFilter *ingestFilter;
     ContactUID *ourUid;
     ResolverQueue *resolver;
     float connTimeoutSec;
     
-    MeshNetCrypto *rxCrypto;   // lock on rxQueueMutex 
+    MeshNetCrypto *rxCrypto;   // lock on rxCryptoMutex
+    PGSC::Thread::Mutex rxCryptoMutex;
     MeshNetCrypto *txCrypto;   // lock on txMutex
 
-    // Next 2 protected by globalIOMutex
+    // An interface addition or removal, kept in posting order
+    struct InboundChange
+    {
+        InboundContext *ctx;
+        bool add;
+    };
+
+    // Registered inbound interfaces and changes to them that the io
+    // thread has yet to pick up; all protected by inboundMutex.
+    // inboundMutex also guards the listening socket of every inbound
+    // context; removal closes it right away so the port can be reused,
+    // and the io thread holds the mutex whenever it touches one.
+    // Callers never wait on the io thread's select.
     InboundCtxSet inboundContexts;
-    bool inboundNeedsRebuild;
+    std::vector<InboundChange> inboundChanges;
+    std::atomic<bool> inboundChangesPending;
+    PGSC::Thread::Mutex inboundMutex;
 
-    ClientCtxSet clientContexts;  // access only on io thread
+    // Access only on io thread
+    InboundCtxSet ioInboundContexts;
+    bool inboundNeedsRebuild;
+    ClientCtxSet clientContexts;
+    std::vector<ClientContext *> freeClientContexts;
+    std::vector<RxBuffer> freeRxBuffers;
+    // Received items that did not fit in rxRing
+    std::deque<RxQueueItem> rxOverflow;
 
     TxCtxSet txContexts;
     bool txNeedsRebuild;
@@ -218,10 +265,15 @@ private:
     PGSC::Thread::Mutex resolverContextsMutex;
 
 
-    // RX Queue - new items on front
-    std::deque<RxQueueItem> rxQueue;
-    PGSC::Thread::Mutex rxQueueMutex;
-    PGSC::Thread::CondVar rxQueueMonitor;
+    // RX hand off from io thread to rx queue thread. rxBufferReturn
+    // gives emptied buffers back to the io thread.  The rx thread only
+    // sleeps on rxWakeMonitor when rxRing is empty, flagging
+    // rxThreadWaiting so the io thread knows to signal it.
+    SpscRing<RxQueueItem> rxRing;
+    SpscRing<RxBuffer> rxBufferReturn;
+    std::atomic<bool> rxThreadWaiting;
+    PGSC::Thread::Mutex rxWakeMutex;
+    PGSC::Thread::CondVar rxWakeMonitor;
 
     // TX Error Queue - new items on front
     std::deque<TxErrQueueItem> txErrQueue;
@@ -240,21 +292,7 @@ private:
     std::set<InterfaceStatusListener *> ifaceListeners;
     PGSC::Thread::Mutex ifaceListenerMutex;
 
-
-    // Protects all IO sockets across all contexts (aka the big select() mutex)
-    // While this is a RW Mutex, the internal use of it is rather
-    // non-traditional.  There is only ever one reader; this reader
-    // holds the lock quite often while doing some long-running tasks, but
-    // frequently and briefly relinquishes the lock to allow a writer to
-    // interject and perform an exclusive operation.
-    // Thus it is used basically like a regular Mutex but uses the reader
-    // writer paradigm to allow prioritization to writers.  With a normal
-    // Mutex, lock starvation of the "writing" calls was seen with the "read"
-    // portion never giving up the mutex effectively (on some platforms,
-    // notably Linux)
-    PGSC::Thread::RWMutex globalIOMutex;
-
-    NetSelector selector;
+    NetSelector selector;  // access only on io thread
 
 
 
@@ -266,8 +304,16 @@ private:
     void queueTxErr(TxContext *ctx, const std::string &reason, 
                                     bool removeFromCtxSet);
     void killTxCtx(TxContext *ctx, bool removeFromCtxSet);
+    void ioThreadApplyInboundChanges();
     void ioThreadResetInboundCtx(InboundContext *ctx, bool flagReset);
+    ClientContext *ioThreadObtainClient(TcpSocket *socket,
+                                        NetAddress *clientAddr,
+                                        const std::string &endpoint);
+    void ioThreadRecycleClient(ClientContext *ctx);
+    void ioThreadReclaimBuffers();
     void ioThreadQueueRx(ClientContext *ctx);
+    void ioThreadFlushRx();
+    void wakeRxThread();
 
     void fireIfaceStatus(TcpInboundNetInterface *iface, bool up);
 
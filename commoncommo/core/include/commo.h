@@ -112,6 +112,40 @@ public:
     // Get protocol version in use by broadcast system
     int getBroadcastProto();
 
+    // Enables or disables the inbound ingest filter. When enabled, CoT
+    // received on any interface is quickly scanned for uid, type and time
+    // before being fully parsed, and is dropped without parsing if the
+    // policy for it says so (see below).  TAK control messages and
+    // anything that cannot be scanned are never dropped.
+    // Default is disabled.
+    void setIngestFilterEnabled(bool enable);
+
+    // Sets the ingest policy for CoT types beginning with typePrefix.
+    // The longest matching prefix is used; empty string sets the policy
+    // used for types not matching any prefix. dropDuplicates drops a message
+    // repeating the type and time of the last one accepted from its uid.
+    // minIntervalMillis, if non-zero, drops messages arriving sooner than
+    // that after the last one accepted from the same uid.
+    // The initial default policy drops duplicates only.
+    // Returns ILLEGAL_ARGUMENT if typePrefix is NULL or
+    // minIntervalMillis is negative.
+    CommoResult setIngestTypePolicy(const char *typePrefix,
+                                    bool dropDuplicates,
+                                    int minIntervalMillis);
+    // Removes a policy set with setIngestTypePolicy. Empty string restores
+    // the initial default policy.  Returns ILLEGAL_ARGUMENT if no
+    // such policy exists.
+    CommoResult clearIngestTypePolicy(const char *typePrefix);
+
+    // As setIngestTypePolicy, but for messages from one uid. Takes
+    // precedence over all type policies.
+    CommoResult setIngestUidPolicy(const char *uid, bool dropDuplicates,
+                                   int minIntervalMillis);
+    CommoResult clearIngestUidPolicy(const char *uid);
+
+    // Copies the ingest filter's counters into stats
+    void getIngestFilterStats(IngestFilterStats *stats);
+
 
     // Sets the local web server port for peer-to-peer transfers,
     // or disables the function if passed MP_LOCAL_PORT_DISABLE.
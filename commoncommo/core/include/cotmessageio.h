@@ -38,6 +38,26 @@ enum CoTMessageType {
 };
 
 
+// Counters kept by the optional inbound CoT ingest filter
+// (see Commo::setIngestFilterEnabled())
+struct COMMONCOMMO_API IngestFilterStats {
+    // Passed on for full parsing
+    uint64_t accepted;
+    // Dropped as a repeat of the last message from the same uid
+    uint64_t droppedDuplicate;
+    // Dropped for arriving too soon after the last one from the same uid
+    uint64_t droppedRate;
+    // Passed without evaluation: uid/type could not be found with the
+    // quick scan, or a TAK control message
+    uint64_t unscanned;
+
+    IngestFilterStats() : accepted(0), droppedDuplicate(0), droppedRate(0),
+                          unscanned(0)
+    {
+    };
+};
+
+
 class COMMONCOMMO_API CoTMessageListener
 {
 public:
@@ -562,6 +562,103 @@ public class Commo {
     {
         return getBroadcastProtoNative(nativePtr);
     }
+
+    /**
+     * Enables or disables the inbound ingest filter. When enabled, CoT
+     * received on any interface is quickly scanned for uid, type and time
+     * before being fully parsed, and is dropped without parsing if the
+     * policy for it says so.  TAK control messages and
+     * anything that cannot be scanned are never dropped.
+     * Default is disabled.
+     * @param en true to enable the filter, false to disable it
+     */
+    public void setIngestFilterEnabled(boolean en)
+    {
+        setIngestFilterEnabledNative(nativePtr, en);
+    }
+
+    /**
+     * Sets the ingest policy for CoT types beginning with typePrefix.
+     * The longest matching prefix is used; empty string sets the policy
+     * used for types not matching any prefix.
+     * The initial default policy drops duplicates only.
+     * @param typePrefix the CoT type prefix the policy applies to
+     * @param dropDuplicates true to drop a message repeating the type and
+     *                       time of the last one accepted from its uid
+     * @param minIntervalMillis if non-zero, messages arriving sooner than
+     *                          this after the last one accepted from the
+     *                          same uid are dropped
+     * @throws CommoException if typePrefix is null or minIntervalMillis
+     *                        is negative
+     */
+    public void setIngestTypePolicy(String typePrefix, boolean dropDuplicates,
+                                    int minIntervalMillis)
+                                    throws CommoException
+    {
+        if (typePrefix == null)
+            throw new CommoException("typePrefix cannot be null");
+        if (minIntervalMillis < 0)
+            throw new CommoException("minIntervalMillis cannot be negative");
+        if (!setIngestTypePolicyNative(nativePtr, typePrefix, dropDuplicates,
+                                       minIntervalMillis))
+            throw new CommoException("Failed to set the ingest type policy");
+    }
+
+    /**
+     * Removes a policy set with setIngestTypePolicy. Empty string restores
+     * the initial default policy.
+     * @param typePrefix the CoT type prefix of the policy to remove
+     * @throws CommoException if no such policy exists
+     */
+    public void clearIngestTypePolicy(String typePrefix) throws CommoException
+    {
+        if (typePrefix == null ||
+                !clearIngestTypePolicyNative(nativePtr, typePrefix))
+            throw new CommoException("No policy for the given type prefix");
+    }
+
+    /**
+     * As setIngestTypePolicy, but for messages from one uid. Takes
+     * precedence over all type policies.
+     * @throws CommoException if uid is null or empty or minIntervalMillis
+     *                        is negative
+     */
+    public void setIngestUidPolicy(String uid, boolean dropDuplicates,
+                                   int minIntervalMillis)
+                                   throws CommoException
+    {
+        if (uid == null)
+            throw new CommoException("uid cannot be null");
+        if (uid.isEmpty())
+            throw new CommoException("uid cannot be empty");
+        if (minIntervalMillis < 0)
+            throw new CommoException("minIntervalMillis cannot be negative");
+        if (!setIngestUidPolicyNative(nativePtr, uid, dropDuplicates,
+                                      minIntervalMillis))
+            throw new CommoException("Failed to set the ingest uid policy");
+    }
+
+    /**
+     * Removes a policy set with setIngestUidPolicy.
+     * @param uid the uid of the policy to remove
+     * @throws CommoException if no such policy exists
+     */
+    public void clearIngestUidPolicy(String uid) throws CommoException
+    {
+        if (uid == null || !clearIngestUidPolicyNative(nativePtr, uid))
+            throw new CommoException("No policy for the given uid");
+    }
+
+    /**
+     * Obtains a snapshot of the ingest filter's counters.
+     * @return the current counters
+     */
+    public IngestFilterStats getIngestFilterStats()
+    {
+        long[] stats = new long[4];
+        getIngestFilterStatsNative(nativePtr, stats);
+        return new IngestFilterStats(stats[0], stats[1], stats[2], stats[3]);
+    }
     
     
     /**
@@ -1867,6 +1964,22 @@ public class Commo {
                                    int seconds);
     static native void setStreamMonitorEnabledNative(long nativePtr, boolean en);
     static native int getBroadcastProtoNative(long nativePtr);
+    static native void setIngestFilterEnabledNative(long nativePtr,
+                                   boolean en);
+    static native boolean setIngestTypePolicyNative(long nativePtr,
+                                   String typePrefix,
+                                   boolean dropDuplicates,
+                                   int minIntervalMillis);
+    static native boolean clearIngestTypePolicyNative(long nativePtr,
+                                   String typePrefix);
+    static native boolean setIngestUidPolicyNative(long nativePtr,
+                                   String uid,
+                                   boolean dropDuplicates,
+                                   int minIntervalMillis);
+    static native boolean clearIngestUidPolicyNative(long nativePtr,
+                                   String uid);
+    static native void getIngestFilterStatsNative(long nativePtr,
+                                   long[] stats);
     static native PhysicalNetInterface addBroadcastNative(long nativePtr,
                                    byte[] hwAddress,
                                    int hwAddressLen,
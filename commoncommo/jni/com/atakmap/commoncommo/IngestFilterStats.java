@@ -0,0 +1,28 @@
+package com.atakmap.commoncommo;
+
+/**
+ * Counters kept by the optional inbound CoT ingest filter.
+ * See Commo.setIngestFilterEnabled()
+ */
+public class IngestFilterStats {
+    /** Passed on for full parsing */
+    public final long accepted;
+    /** Dropped as a repeat of the last message from the same uid */
+    public final long droppedDuplicate;
+    /** Dropped for arriving too soon after the last one from the same uid */
+    public final long droppedRate;
+    /**
+     * Passed without evaluation: uid/type could not be found with the
+     * quick scan, or a TAK control message
+     */
+    public final long unscanned;
+
+    IngestFilterStats(long accepted, long droppedDuplicate, long droppedRate,
+                      long unscanned)
+    {
+        this.accepted = accepted;
+        this.droppedDuplicate = droppedDuplicate;
+        this.droppedRate = droppedRate;
+        this.unscanned = unscanned;
+    }
+}
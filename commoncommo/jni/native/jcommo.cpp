@@ -2032,6 +2032,94 @@ Java_com_atakmap_commoncommo_Commo_getBroadcastProtoNative
 }
 
 
+JNIEXPORT void JNICALL
+Java_com_atakmap_commoncommo_Commo_setIngestFilterEnabledNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jboolean en)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    c->commo->setIngestFilterEnabled(en == JNI_TRUE);
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_atakmap_commoncommo_Commo_setIngestTypePolicyNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jstring jtypePrefix,
+     jboolean dropDuplicates, jint minIntervalMillis)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    const char *typePrefix = env->GetStringUTFChars(jtypePrefix, NULL);
+    if (!typePrefix)
+        return JNI_FALSE;
+    CommoResult r = c->commo->setIngestTypePolicy(typePrefix,
+                                                  dropDuplicates == JNI_TRUE,
+                                                  minIntervalMillis);
+    env->ReleaseStringUTFChars(jtypePrefix, typePrefix);
+    return r == COMMO_SUCCESS ? JNI_TRUE : JNI_FALSE;
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_atakmap_commoncommo_Commo_clearIngestTypePolicyNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jstring jtypePrefix)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    const char *typePrefix = env->GetStringUTFChars(jtypePrefix, NULL);
+    if (!typePrefix)
+        return JNI_FALSE;
+    CommoResult r = c->commo->clearIngestTypePolicy(typePrefix);
+    env->ReleaseStringUTFChars(jtypePrefix, typePrefix);
+    return r == COMMO_SUCCESS ? JNI_TRUE : JNI_FALSE;
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_atakmap_commoncommo_Commo_setIngestUidPolicyNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jstring juid,
+     jboolean dropDuplicates, jint minIntervalMillis)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    const char *uid = env->GetStringUTFChars(juid, NULL);
+    if (!uid)
+        return JNI_FALSE;
+    CommoResult r = c->commo->setIngestUidPolicy(uid,
+                                                 dropDuplicates == JNI_TRUE,
+                                                 minIntervalMillis);
+    env->ReleaseStringUTFChars(juid, uid);
+    return r == COMMO_SUCCESS ? JNI_TRUE : JNI_FALSE;
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_atakmap_commoncommo_Commo_clearIngestUidPolicyNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jstring juid)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    const char *uid = env->GetStringUTFChars(juid, NULL);
+    if (!uid)
+        return JNI_FALSE;
+    CommoResult r = c->commo->clearIngestUidPolicy(uid);
+    env->ReleaseStringUTFChars(juid, uid);
+    return r == COMMO_SUCCESS ? JNI_TRUE : JNI_FALSE;
+}
+
+
+JNIEXPORT void JNICALL
+Java_com_atakmap_commoncommo_Commo_getIngestFilterStatsNative
+    (JNIEnv *env, jclass selfCls, jlong nativePtr, jlongArray jstats)
+{
+    CommoJNI *c = JLONG_TO_PTR(CommoJNI, nativePtr);
+    IngestFilterStats stats;
+    c->commo->getIngestFilterStats(&stats);
+    jlong values[4] = {
+        (jlong)stats.accepted,
+        (jlong)stats.droppedDuplicate,
+        (jlong)stats.droppedRate,
+        (jlong)stats.unscanned
+    };
+    env->SetLongArrayRegion(jstats, 0, 4, values);
+}
+
+
 JNIEXPORT jboolean JNICALL
 Java_com_atakmap_commoncommo_Commo_setMPLocalPortNative
     (JNIEnv *env, jclass selfCls, jlong nativePtr, jint jlocalPort)
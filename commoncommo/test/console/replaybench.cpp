@@ -0,0 +1,784 @@
+// Offline ingest replay benchmark for commo.
+//
+// Replays a recorded (file) or synthetic stream of CoT events into a
+// Commo instance over loopback UDP, TCP or a fake TAK server stream,
+// optionally as TAK protocol (protobuf) payloads, at a configurable rate
+// and sender fan-in.  Reports sustained throughput, drop rate and latency
+// percentiles for each stage of the ingest pipeline that can be observed
+// from outside the library:
+//   parse   - in-process decode of each payload via TakMessage (no sockets)
+//   send    - time for the sender to put one message on the wire
+//             (includes connect for TCP)
+//   deliver - send start to CoTMessageListener callback
+//             (socket -> parse -> ContactManager -> listener)
+//   contact - first send from a uid to ContactPresenceListener callback
+// Each message can be sent several times (-D) to model the same event
+// arriving over multiple paths, and the ingest filter can be enabled (-F)
+// to measure how much parsing it saves.
+//
+// Linux only; runs entirely on the loopback interface.
+
+#include <commo.h>
+#include "takmessage.h"
+
+#include "libxml/tree.h"
+#include "libxml/xmlerror.h"
+#include <Thread.h>
+#include <Mutex.h>
+#include <Lock.h>
+#include "openssl/ssl.h"
+#include "openssl/crypto.h"
+#include "curl/curl.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace atakmap::commoncommo;
+
+
+namespace {
+    const char SEQ_TAG[] = "<__replay seq=\"";
+    const char *LEVEL_STRINGS[] = {
+            "VERBOSE",
+            "DEBUG",
+            "WARNING",
+            "INFO",
+            "ERROR"
+    };
+
+    typedef enum {
+        TRANSPORT_UDP,
+        TRANSPORT_TCP,
+        TRANSPORT_STREAM
+    } Transport;
+
+    uint64_t nowNanos()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    }
+
+    void sleepUntil(uint64_t nanos)
+    {
+        struct timespec ts;
+        ts.tv_sec = (time_t)(nanos / 1000000000ULL);
+        ts.tv_nsec = (long)(nanos % 1000000000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+    }
+
+    std::string timeString(time_t t, unsigned millis = 0)
+    {
+        struct tm tm;
+        t += millis / 1000;
+        gmtime_r(&t, &tm);
+        char buf[64];
+        size_t n = strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+        snprintf(buf + n, sizeof(buf) - n, ".%03uZ", millis % 1000);
+        return std::string(buf);
+    }
+
+    std::string senderUid(size_t sender)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "replay-%u", (unsigned)sender);
+        return std::string(buf);
+    }
+
+    // Each message from a sender gets its own time so that only
+    // deliberate copies (-D) look like duplicates to the ingest filter
+    std::string syntheticEvent(time_t now, size_t sender, size_t i)
+    {
+        std::string uid = senderUid(sender);
+        std::string t = timeString(now, (unsigned)i);
+        std::string ret = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                "<event version=\"2.0\" uid=\"";
+        ret += uid;
+        ret += "\" type=\"a-f-G-U-C\" how=\"h-e\" time=\"";
+        ret += t;
+        ret += "\" start=\"";
+        ret += t;
+        ret += "\" stale=\"";
+        ret += timeString(now + 3600);
+        ret += "\"><point lat=\"36.5261810013514\" lon=\"-77.3862509255614\""
+               " hae=\"9999999.0\" ce=\"9999999\" le=\"9999999\"/>"
+               "<detail><contact endpoint=\"*:-1:stcp\" callsign=\"";
+        ret += uid;
+        ret += "\"/><__group name=\"Cyan\" role=\"Team Member\"/>"
+               "<status battery=\"100\"/>"
+               "<track speed=\"0.0\" course=\"56.23885995781046\"/>"
+               "</detail></event>";
+        return ret;
+    }
+
+    // Splits a capture of back-to-back events on closing event tags.
+    std::vector<std::string> readCorpus(const char *fileName)
+    {
+        std::vector<std::string> ret;
+        FILE *f = fopen(fileName, "rb");
+        if (!f)
+            return ret;
+        std::string all;
+        char buf[8192];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            all.append(buf, n);
+        fclose(f);
+
+        const std::string endTag("</event>");
+        size_t start = 0;
+        while (true) {
+            size_t end = all.find(endTag, start);
+            if (end == std::string::npos)
+                break;
+            end += endTag.length();
+            size_t evStart = all.find('<', start);
+            if (evStart < end)
+                ret.push_back(all.substr(evStart, end - evStart));
+            start = end;
+        }
+        return ret;
+    }
+
+    // Tags the event with a sequence number that survives commo's
+    // reserialization (unknown detail children are preserved).
+    std::string tagEvent(const std::string &ev, size_t seq)
+    {
+        char tag[64];
+        snprintf(tag, sizeof(tag), "%s%u\"/>", SEQ_TAG, (unsigned)seq);
+        std::string ret(ev);
+        size_t loc;
+        if ((loc = ret.find("<detail>")) != std::string::npos) {
+            ret.insert(loc + 8, tag);
+        } else if ((loc = ret.find("<detail/>")) != std::string::npos) {
+            ret.replace(loc, 9, std::string("<detail>") + tag + "</detail>");
+        } else if ((loc = ret.rfind("</event>")) != std::string::npos) {
+            ret.insert(loc, std::string("<detail>") + tag + "</detail>");
+        }
+        return ret;
+    }
+
+    double percentile(std::vector<uint64_t> &v, double p)
+    {
+        if (v.empty())
+            return 0.0;
+        size_t idx = (size_t)(p / 100.0 * (v.size() - 1) + 0.5);
+        return v[idx] / 1000.0;
+    }
+
+    void printStage(const char *name, std::vector<uint64_t> &v)
+    {
+        std::sort(v.begin(), v.end());
+        printf("  %-8s n=%-8u p50=%10.1f p90=%10.1f p99=%10.1f max=%10.1f us\n",
+               name, (unsigned)v.size(),
+               percentile(v, 50.0), percentile(v, 90.0),
+               percentile(v, 99.0), percentile(v, 100.0));
+    }
+
+
+    class Bench : public CoTMessageListener, public ContactPresenceListener,
+                  public CommoLogger
+    {
+    public:
+        Transport transport;
+        bool useProto;
+        size_t nSenders;
+        size_t perSender;
+        double rate;
+        int basePort;
+        int drainSecs;
+        bool verbose;
+        size_t copies;
+        bool filter;
+        int filterIntervalMillis;
+
+        std::vector<std::string> corpus;
+
+        // Indexed by global sequence number
+        std::vector<std::string> payloads;
+        std::vector<uint64_t> sendStart;
+        std::vector<uint64_t> sendEnd;
+        std::vector<uint64_t> recvTime;
+        std::vector<uint64_t> parseTime;
+        size_t dupCount;
+        size_t unknownCount;
+        size_t sendErrors;
+        IngestFilterStats filterStats;
+
+        std::map<std::string, uint64_t> contactTime;
+
+        PGSC::Thread::Mutex rxMutex;
+        PGSC::Thread::Mutex loggerMutex;
+
+        Commo *commo;
+        uint64_t runStart;
+
+
+        Bench() : transport(TRANSPORT_UDP), useProto(false), nSenders(1),
+                  perSender(10000), rate(0.0), basePort(17555), drainSecs(5),
+                  verbose(false), copies(1), filter(false),
+                  filterIntervalMillis(0),
+                  corpus(), payloads(), sendStart(), sendEnd(), recvTime(),
+                  parseTime(), dupCount(0), unknownCount(0), sendErrors(0),
+                  filterStats(), contactTime(),
+                  rxMutex(), loggerMutex(), commo(NULL), runStart(0)
+        {
+        }
+
+        virtual ~Bench()
+        {
+            delete commo;
+        }
+
+        virtual void log(Level level, const char *message)
+        {
+            if (!verbose && level < LEVEL_ERROR)
+                return;
+            PGSC::Thread::LockPtr lock(NULL, NULL);
+            PGSC::Thread::Lock_create(lock, loggerMutex);
+            fprintf(stderr, "[%s]: %s\n", LEVEL_STRINGS[level], message);
+        }
+
+        virtual void cotMessageReceived(const char *msg,
+                                        const char *rxIfaceEndpointId)
+        {
+            uint64_t t = nowNanos();
+            const char *s = strstr(msg, SEQ_TAG);
+            PGSC::Thread::LockPtr lock(NULL, NULL);
+            PGSC::Thread::Lock_create(lock, rxMutex);
+            if (!s) {
+                unknownCount++;
+                return;
+            }
+            size_t seq = strtoul(s + sizeof(SEQ_TAG) - 1, NULL, 10);
+            if (seq >= recvTime.size()) {
+                unknownCount++;
+            } else if (recvTime[seq]) {
+                dupCount++;
+            } else {
+                recvTime[seq] = t;
+            }
+        }
+
+        virtual void contactAdded(const ContactUID *c)
+        {
+            uint64_t t = nowNanos();
+            std::string uid((const char *)c->contactUID, c->contactUIDLen);
+            PGSC::Thread::LockPtr lock(NULL, NULL);
+            PGSC::Thread::Lock_create(lock, rxMutex);
+            if (contactTime.find(uid) == contactTime.end())
+                contactTime[uid] = t;
+        }
+
+        virtual void contactRemoved(const ContactUID *c)
+        {
+        }
+
+        bool buildPayloads()
+        {
+            size_t total = nSenders * perSender;
+            payloads.resize(total);
+            sendStart.assign(total, 0);
+            sendEnd.assign(total, 0);
+            recvTime.assign(total, 0);
+            parseTime.reserve(total);
+
+            time_t now = time(NULL);
+            for (size_t s = 0; s < nSenders; ++s) {
+                for (size_t i = 0; i < perSender; ++i) {
+                    size_t seq = s * perSender + i;
+                    std::string tagged = tagEvent(corpus.empty() ?
+                            syntheticEvent(now, s, i) :
+                            corpus[seq % corpus.size()], seq);
+                    if (!useProto) {
+                        payloads[seq] = tagged;
+                        continue;
+                    }
+                    char *proto = NULL;
+                    size_t protoLen = 0;
+                    if (commo->cotXmlToTakproto(&proto, &protoLen,
+                            tagged.c_str(), 1) != COMMO_SUCCESS) {
+                        fprintf(stderr, "Event %u could not be converted to takproto\n",
+                                (unsigned)seq);
+                        return false;
+                    }
+                    payloads[seq].assign(proto, protoLen);
+                    commo->takmessageFree(proto);
+                }
+            }
+            return true;
+        }
+
+        void measureParse()
+        {
+            for (size_t i = 0; i < payloads.size(); ++i) {
+                const std::string &p = payloads[i];
+                uint64_t t0 = nowNanos();
+                try {
+                    impl::TakMessage msg(this, (const uint8_t *)p.data(),
+                                         p.length(), true, true);
+                } catch (std::invalid_argument &) {
+                    continue;
+                }
+                parseTime.push_back(nowNanos() - t0);
+            }
+        }
+
+        bool setupInterfaces()
+        {
+            if (filter) {
+                commo->setIngestFilterEnabled(true);
+                commo->setIngestTypePolicy("", true, filterIntervalMillis);
+            }
+            if (transport == TRANSPORT_UDP) {
+                const char *lo = "lo";
+                HwAddress hwAddr((const uint8_t *)lo, strlen(lo));
+                if (!commo->addInboundInterface(&hwAddr, basePort, NULL, 0,
+                                                false)) {
+                    fprintf(stderr, "Unable to add UDP inbound on port %d\n",
+                            basePort);
+                    return false;
+                }
+            } else if (transport == TRANSPORT_TCP) {
+                if (!commo->addTcpInboundInterface(basePort)) {
+                    fprintf(stderr, "Unable to add TCP inbound on port %d\n",
+                            basePort);
+                    return false;
+                }
+            }
+            // Streams are set up per-sender once their server sockets listen
+            return true;
+        }
+
+        void report(uint64_t sendDone, uint64_t end);
+    };
+
+
+    struct SenderCtx {
+        Bench *bench;
+        size_t id;
+        int listenFd;
+    };
+
+    int openLoopback(int type)
+    {
+        int fd = socket(AF_INET, type, 0);
+        return fd;
+    }
+
+    struct sockaddr_in loopbackAddr(int port)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return addr;
+    }
+
+    bool writeAll(int fd, const char *data, size_t len)
+    {
+        while (len > 0) {
+            ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += n;
+            len -= (size_t)n;
+        }
+        return true;
+    }
+
+    bool sendPayload(Transport transport, int fd,
+                     const struct sockaddr_in &dest, const std::string &p)
+    {
+        bool ok = false;
+        switch (transport) {
+        case TRANSPORT_UDP:
+            ok = sendto(fd, p.data(), p.length(), 0,
+                        (const struct sockaddr *)&dest, sizeof(dest)) ==
+                                (ssize_t)p.length();
+            break;
+        case TRANSPORT_TCP:
+            {
+                // commo's tcp inbound takes one message per connection
+                int cfd = openLoopback(SOCK_STREAM);
+                ok = cfd >= 0 && connect(cfd, (const struct sockaddr *)&dest,
+                                         sizeof(dest)) == 0 &&
+                     writeAll(cfd, p.data(), p.length());
+                if (cfd >= 0)
+                    close(cfd);
+                break;
+            }
+        case TRANSPORT_STREAM:
+            ok = writeAll(fd, p.data(), p.length());
+            break;
+        }
+        return ok;
+    }
+
+    void *senderEntry(void *opaque)
+    {
+        SenderCtx *ctx = (SenderCtx *)opaque;
+        Bench *b = ctx->bench;
+        struct sockaddr_in dest = loopbackAddr(b->basePort);
+
+        int fd = -1;
+        if (b->transport == TRANSPORT_UDP) {
+            fd = openLoopback(SOCK_DGRAM);
+        } else if (b->transport == TRANSPORT_STREAM) {
+            // Wait for commo to connect to our fake server
+            fd = accept(ctx->listenFd, NULL, NULL);
+            if (fd >= 0) {
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            }
+        }
+        if (b->transport != TRANSPORT_TCP && fd < 0) {
+            fprintf(stderr, "Sender %u failed to set up its socket\n",
+                    (unsigned)ctx->id);
+            return NULL;
+        }
+
+        uint64_t intervalNs = 0;
+        if (b->rate > 0.0)
+            intervalNs = (uint64_t)(1e9 * b->nSenders / b->rate);
+        uint64_t next = nowNanos();
+        size_t errors = 0;
+
+        for (size_t i = 0; i < b->perSender; ++i) {
+            size_t seq = ctx->id * b->perSender + i;
+            const std::string &p = b->payloads[seq];
+            if (intervalNs) {
+                sleepUntil(next);
+                next += intervalNs;
+            }
+
+            uint64_t t0 = nowNanos();
+            b->sendStart[seq] = t0;
+            for (size_t c = 0; c < b->copies; ++c) {
+                if (!sendPayload(b->transport, fd, dest, p))
+                    errors++;
+            }
+            b->sendEnd[seq] = nowNanos();
+        }
+
+        {
+            PGSC::Thread::LockPtr lock(NULL, NULL);
+            PGSC::Thread::Lock_create(lock, b->rxMutex);
+            b->sendErrors += errors;
+        }
+
+        if (fd >= 0) {
+            if (b->transport == TRANSPORT_STREAM) {
+                // Keep the stream open until commo has drained it
+                sleepUntil(nowNanos() + (uint64_t)b->drainSecs * 1000000000ULL);
+            }
+            close(fd);
+        }
+        return NULL;
+    }
+
+    void Bench::report(uint64_t sendDone, uint64_t end)
+    {
+        size_t total = payloads.size();
+        std::vector<uint64_t> sendLat;
+        std::vector<uint64_t> deliverLat;
+        std::vector<uint64_t> contactLat;
+        uint64_t lastRecv = 0;
+        size_t received = 0;
+        sendLat.reserve(total);
+        deliverLat.reserve(total);
+
+        for (size_t i = 0; i < total; ++i) {
+            if (sendStart[i])
+                sendLat.push_back(sendEnd[i] - sendStart[i]);
+            if (!recvTime[i])
+                continue;
+            received++;
+            deliverLat.push_back(recvTime[i] - sendStart[i]);
+            if (recvTime[i] > lastRecv)
+                lastRecv = recvTime[i];
+        }
+        for (size_t s = 0; s < nSenders; ++s) {
+            std::string uid = senderUid(s);
+            std::map<std::string, uint64_t>::iterator iter =
+                    contactTime.find(uid);
+            if (iter == contactTime.end())
+                continue;
+            uint64_t first = sendStart[s * perSender];
+            if (iter->second > first)
+                contactLat.push_back(iter->second - first);
+        }
+
+        double sendSecs = (sendDone - runStart) / 1e9;
+        double rxSecs = ((lastRecv ? lastRecv : end) - runStart) / 1e9;
+        size_t dropped = total - received;
+
+        static const char *TRANSPORT_NAMES[] = { "udp", "tcp", "stream" };
+        printf("transport=%s format=%s senders=%u per-sender=%u copies=%u "
+               "rate=%s filter=%s\n",
+               TRANSPORT_NAMES[transport], useProto ? "proto" : "xml",
+               (unsigned)nSenders, (unsigned)perSender, (unsigned)copies,
+               rate > 0.0 ? "fixed" : "unthrottled", filter ? "on" : "off");
+        if (rate > 0.0)
+            printf("target rate: %.0f msg/s\n", rate);
+        printf("sent: %u in %.3f s (%.0f msg/s), send errors %u\n",
+               (unsigned)total, sendSecs,
+               sendSecs > 0.0 ? total / sendSecs : 0.0, (unsigned)sendErrors);
+        if (transport == TRANSPORT_TCP)
+            // One short-lived connection per message
+            printf("connections: %u (%.0f conn/s)\n", (unsigned)total,
+                   sendSecs > 0.0 ? total / sendSecs : 0.0);
+        printf("received: %u in %.3f s (%.0f msg/s sustained)\n",
+               (unsigned)received, rxSecs,
+               rxSecs > 0.0 ? received / rxSecs : 0.0);
+        printf("dropped: %u (%.2f%%), duplicates %u, untagged %u\n",
+               (unsigned)dropped,
+               total ? 100.0 * dropped / total : 0.0,
+               (unsigned)dupCount, (unsigned)unknownCount);
+        if (filter) {
+            uint64_t dropped = filterStats.droppedDuplicate +
+                               filterStats.droppedRate;
+            double meanParse = 0.0;
+            for (size_t i = 0; i < parseTime.size(); ++i)
+                meanParse += parseTime[i];
+            if (!parseTime.empty())
+                meanParse /= parseTime.size();
+            printf("filter: accepted %" PRIu64 ", dropped duplicate %" PRIu64
+                   ", dropped rate %" PRIu64 ", unscanned %" PRIu64 "\n",
+                   filterStats.accepted, filterStats.droppedDuplicate,
+                   filterStats.droppedRate, filterStats.unscanned);
+            printf("filter: ~%.1f ms of parsing avoided (%.1f us mean parse)\n",
+                   dropped * meanParse / 1e6, meanParse / 1000.0);
+        }
+        printf("contacts: %u of %u senders seen\n",
+               (unsigned)contactTime.size(), (unsigned)nSenders);
+        printf("stage latency:\n");
+        printStage("parse", parseTime);
+        printStage("send", sendLat);
+        printStage("deliver", deliverLat);
+        printStage("contact", contactLat);
+    }
+
+
+    void usage(const char *name)
+    {
+        fprintf(stderr, "Usage: %s [options]\n", name);
+        fprintf(stderr,
+"  -t udp|tcp|stream  Transport to replay over (default udp)\n"
+"                     stream acts as a TAK server that commo connects to\n"
+"  -P                 Send TAK protocol (protobuf) payloads (udp/tcp only)\n"
+"  -i <file>          Replay events captured in <file> (back to back XML\n"
+"                     events) instead of synthetic SA messages\n"
+"  -s <senders>       Number of concurrent senders (fan-in; default 1)\n"
+"  -n <count>         Messages per sender (default 10000)\n"
+"  -r <msgs/sec>      Aggregate send rate; 0 for unthrottled (default 0)\n"
+"  -p <port>          Base port; stream senders use port+0..port+n-1\n"
+"                     (default 17555)\n"
+"  -d <secs>          Seconds to wait for delivery after sending (default 5)\n"
+"  -D <copies>        Send each message this many times (default 1)\n"
+"  -F                 Enable the ingest filter (drops duplicates)\n"
+"  -R <millis>        With -F, also drop messages from a uid arriving\n"
+"                     within <millis> of the last accepted one\n"
+"  -v                 Show commo log output below ERROR level\n");
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Ignore sigpipe resulting from network I/O that writes to disconnected
+    // remote tcp pipes
+    struct sigaction action;
+    struct sigaction oldaction;
+    memset(&oldaction, 0, sizeof(struct sigaction));
+    sigaction(SIGPIPE, NULL, &oldaction);
+    action = oldaction;
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+
+    Bench bench;
+    const char *corpusFile = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:Pi:s:n:r:p:d:D:FR:vh")) != -1) {
+        switch (opt) {
+        case 't':
+            if (!strcmp(optarg, "udp"))
+                bench.transport = TRANSPORT_UDP;
+            else if (!strcmp(optarg, "tcp"))
+                bench.transport = TRANSPORT_TCP;
+            else if (!strcmp(optarg, "stream"))
+                bench.transport = TRANSPORT_STREAM;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'P':
+            bench.useProto = true;
+            break;
+        case 'i':
+            corpusFile = optarg;
+            break;
+        case 's':
+            bench.nSenders = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            bench.perSender = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            bench.rate = atof(optarg);
+            break;
+        case 'p':
+            bench.basePort = atoi(optarg);
+            break;
+        case 'd':
+            bench.drainSecs = atoi(optarg);
+            break;
+        case 'D':
+            bench.copies = strtoul(optarg, NULL, 10);
+            break;
+        case 'F':
+            bench.filter = true;
+            break;
+        case 'R':
+            bench.filterIntervalMillis = atoi(optarg);
+            break;
+        case 'v':
+            bench.verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (bench.nSenders == 0 || bench.perSender == 0 || bench.copies == 0 ||
+            bench.filterIntervalMillis < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (bench.useProto && bench.transport == TRANSPORT_STREAM) {
+        // Streams only switch to protobuf after server negotiation
+        fprintf(stderr, "Protobuf payloads are not supported on streams\n");
+        return 1;
+    }
+
+    xmlInitParser();
+    OPENSSL_init_ssl(0, NULL);
+    SSL_load_error_strings();
+    curl_global_init(CURL_GLOBAL_NOTHING);
+
+    if (corpusFile) {
+        bench.corpus = readCorpus(corpusFile);
+        if (bench.corpus.empty()) {
+            fprintf(stderr, "No events found in %s\n", corpusFile);
+            return 1;
+        }
+    }
+
+    const char *uidstr = "replaybench";
+    ContactUID uid((const uint8_t *)uidstr, strlen(uidstr));
+    bench.commo = new Commo(&bench, &uid, "replaybench",
+                            netinterfaceenums::MODE_NAME);
+    bench.commo->addCoTMessageListener(&bench);
+    bench.commo->addContactPresenceListener(&bench);
+
+    if (!bench.buildPayloads())
+        return 1;
+    bench.measureParse();
+    if (!bench.setupInterfaces())
+        return 1;
+
+    std::vector<SenderCtx> ctxs(bench.nSenders);
+    for (size_t i = 0; i < bench.nSenders; ++i) {
+        ctxs[i].bench = &bench;
+        ctxs[i].id = i;
+        ctxs[i].listenFd = -1;
+        if (bench.transport != TRANSPORT_STREAM)
+            continue;
+
+        int port = bench.basePort + (int)i;
+        int fd = openLoopback(SOCK_STREAM);
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = loopbackAddr(port);
+        if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+                listen(fd, 1) != 0) {
+            fprintf(stderr, "Unable to listen for stream on port %d\n", port);
+            return 1;
+        }
+        ctxs[i].listenFd = fd;
+        static const CoTMessageType allTypes[2] = {
+                CHAT,
+                SITUATIONAL_AWARENESS
+        };
+        if (!bench.commo->addStreamingInterface("127.0.0.1", port, allTypes,
+                2, NULL, 0, NULL, 0, NULL, NULL, NULL, NULL)) {
+            fprintf(stderr, "Unable to add stream to port %d\n", port);
+            return 1;
+        }
+    }
+
+    // Let inbound sockets come up before the clock starts
+    sleepUntil(nowNanos() + 1000000000ULL);
+
+    bench.runStart = nowNanos();
+    std::vector<PGSC::Thread::ThreadPtr> threads;
+    for (size_t i = 0; i < bench.nSenders; ++i) {
+        threads.push_back(PGSC::Thread::ThreadPtr(NULL, NULL));
+        PGSC::Thread::ThreadCreateParams params;
+        params.name = "replay.send";
+        PGSC::Thread::Thread_start(threads.back(), senderEntry, &ctxs[i],
+                                   params);
+    }
+
+    // Wait for all data to be sent and then for delivery to drain.
+    // Stream senders hold their connection for the drain period themselves.
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i]->join();
+    threads.clear();
+    uint64_t sendDone = 0;
+    for (size_t i = 0; i < bench.sendEnd.size(); ++i)
+        sendDone = std::max(sendDone, bench.sendEnd[i]);
+    if (bench.transport != TRANSPORT_STREAM)
+        sleepUntil(nowNanos() + (uint64_t)bench.drainSecs * 1000000000ULL);
+    uint64_t end = nowNanos();
+
+    bench.commo->removeCoTMessageListener(&bench);
+    bench.commo->removeContactPresenceListener(&bench);
+    bench.commo->getIngestFilterStats(&bench.filterStats);
+    bench.commo->shutdown();
+
+    {
+        PGSC::Thread::LockPtr lock(NULL, NULL);
+        PGSC::Thread::Lock_create(lock, bench.rxMutex);
+        bench.report(sendDone, end);
+    }
+
+    for (size_t i = 0; i < ctxs.size(); ++i) {
+        if (ctxs[i].listenFd >= 0)
+            close(ctxs[i].listenFd);
+    }
+
+    xmlCleanupParser();
+    return 0;
+}
@@ -327,6 +327,60 @@ int Commo::GetBroadcastProto()
     return impl->commo->getBroadcastProto();
 }
 
+void Commo::SetIngestFilterEnabled(bool enable)
+{
+    impl->commo->setIngestFilterEnabled(enable);
+}
+
+CommoResult Commo::SetIngestTypePolicy(System::String ^typePrefix,
+    bool dropDuplicates, int minIntervalMillis)
+{
+    if (typePrefix == nullptr)
+        return CommoResult::CommoIllegalArgument;
+    msclr::interop::marshal_context mctx;
+    const char *typePrefixNative = mctx.marshal_as<const char *>(typePrefix);
+    return impl::nativeToCLI(impl->commo->setIngestTypePolicy(
+        typePrefixNative, dropDuplicates, minIntervalMillis));
+}
+
+CommoResult Commo::ClearIngestTypePolicy(System::String ^typePrefix)
+{
+    if (typePrefix == nullptr)
+        return CommoResult::CommoIllegalArgument;
+    msclr::interop::marshal_context mctx;
+    const char *typePrefixNative = mctx.marshal_as<const char *>(typePrefix);
+    return impl::nativeToCLI(impl->commo->clearIngestTypePolicy(
+        typePrefixNative));
+}
+
+CommoResult Commo::SetIngestUidPolicy(System::String ^uid,
+    bool dropDuplicates, int minIntervalMillis)
+{
+    if (uid == nullptr)
+        return CommoResult::CommoIllegalArgument;
+    msclr::interop::marshal_context mctx;
+    const char *uidNative = mctx.marshal_as<const char *>(uid);
+    return impl::nativeToCLI(impl->commo->setIngestUidPolicy(
+        uidNative, dropDuplicates, minIntervalMillis));
+}
+
+CommoResult Commo::ClearIngestUidPolicy(System::String ^uid)
+{
+    if (uid == nullptr)
+        return CommoResult::CommoIllegalArgument;
+    msclr::interop::marshal_context mctx;
+    const char *uidNative = mctx.marshal_as<const char *>(uid);
+    return impl::nativeToCLI(impl->commo->clearIngestUidPolicy(uidNative));
+}
+
+IngestFilterStats Commo::GetIngestFilterStats()
+{
+    atakmap::commoncommo::IngestFilterStats stats;
+    impl->commo->getIngestFilterStats(&stats);
+    return IngestFilterStats(stats.accepted, stats.droppedDuplicate,
+                             stats.droppedRate, stats.unscanned);
+}
+
 PhysicalNetInterface ^Commo::AddBroadcastInterface(System::String ^ifaceName, array<CoTMessageType> ^types, System::String ^mcastAddr, int destPort)
 {
     msclr::interop::marshal_context mctx;
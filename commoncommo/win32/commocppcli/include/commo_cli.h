@@ -306,6 +306,73 @@ namespace TAK {
              */
             int GetBroadcastProto();
 
+            /**
+             * <summary>
+             * Enables or disables the inbound ingest filter. When enabled,
+             * CoT received on any interface is quickly scanned for uid, type
+             * and time before being fully parsed, and is dropped without
+             * parsing if the policy for it says so.  TAK control messages
+             * and anything that cannot be scanned are never dropped.
+             * Default is disabled.
+             * </summary>
+             * <param name="enable">true to enable the filter</param>
+             */
+            void SetIngestFilterEnabled(bool enable);
+
+            /**
+             * <summary>
+             * Sets the ingest policy for CoT types beginning with typePrefix.
+             * The longest matching prefix is used; empty string sets the
+             * policy used for types not matching any prefix.
+             * Returns IllegalArgument if typePrefix is nullptr or
+             * minIntervalMillis is negative.
+             * </summary>
+             * <param name="typePrefix">CoT type prefix</param>
+             * <param name="dropDuplicates">drop a message repeating the
+             *        type and time of the last one accepted from its
+             *        uid</param>
+             * <param name="minIntervalMillis">if non-zero, drop messages
+             *        arriving sooner than this after the last one accepted
+             *        from the same uid</param>
+             */
+            CommoResult SetIngestTypePolicy(System::String ^typePrefix,
+                                            bool dropDuplicates,
+                                            int minIntervalMillis);
+
+            /**
+             * <summary>
+             * Removes a policy set with SetIngestTypePolicy. Empty string
+             * restores the initial default policy.  Returns IllegalArgument
+             * if no such policy exists.
+             * </summary>
+             * <param name="typePrefix">CoT type prefix</param>
+             */
+            CommoResult ClearIngestTypePolicy(System::String ^typePrefix);
+
+            /**
+             * <summary>
+             * As SetIngestTypePolicy, but for messages from one uid. Takes
+             * precedence over all type policies.
+             * </summary>
+             */
+            CommoResult SetIngestUidPolicy(System::String ^uid,
+                                           bool dropDuplicates,
+                                           int minIntervalMillis);
+
+            /**
+             * <summary>
+             * Removes a policy set with SetIngestUidPolicy.
+             * </summary>
+             */
+            CommoResult ClearIngestUidPolicy(System::String ^uid);
+
+            /**
+             * <summary>
+             * Gets the ingest filter's counters
+             * </summary>
+             */
+            IngestFilterStats GetIngestFilterStats();
+
             /**
              * <summary>
              * Set number of attempts to receive a mission package.
@@ -30,6 +30,32 @@ namespace TAK {
         };
 
 
+        // Counters kept by the optional inbound CoT ingest filter
+        // (see Commo::SetIngestFilterEnabled())
+        public value class IngestFilterStats {
+        public:
+            IngestFilterStats(System::UInt64 accepted,
+                              System::UInt64 droppedDuplicate,
+                              System::UInt64 droppedRate,
+                              System::UInt64 unscanned) :
+                                  accepted(accepted),
+                                  droppedDuplicate(droppedDuplicate),
+                                  droppedRate(droppedRate),
+                                  unscanned(unscanned)
+            {
+            };
+
+            // Passed on for full parsing
+            initonly System::UInt64 accepted;
+            // Dropped as a repeat of the last message from the same uid
+            initonly System::UInt64 droppedDuplicate;
+            // Dropped for arriving too soon after the last one from the same uid
+            initonly System::UInt64 droppedRate;
+            // Passed without evaluation
+            initonly System::UInt64 unscanned;
+        };
+
+
         public enum class CoTMessageType {
             SituationalAwareness,
             Chat,
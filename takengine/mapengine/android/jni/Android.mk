@@ -156,6 +156,7 @@ LOCAL_SRC_FILES += $(SRCDIR)/raster/DatasetProjection.cpp \
                    $(SRCDIR)/raster/DefaultDatasetProjection.cpp \
                    $(SRCDIR)/raster/ImageInfo.cpp \
                    $(SRCDIR)/raster/osm/OSMUtils.cpp \
+                   $(SRCDIR)/raster/mosaic/ATAKMosaicDatabase3.cpp \
                    $(SRCDIR)/raster/mosaic/FilterMosaicDatabaseCursor2.cpp \
                    $(SRCDIR)/raster/mosaic/MosaicDatabase2.cpp \
                    $(SRCDIR)/raster/mosaic/MultiplexingMosaicDatabaseCursor2.cpp
@@ -181,9 +182,11 @@ LOCAL_SRC_FILES += $(SRCDIR)/renderer/AsyncBitmapLoader2.cpp \
                    $(SRCDIR)/renderer/Skirt.cpp \
                    $(SRCDIR)/renderer/Tessellate.cpp \
                    $(SRCDIR)/renderer/core/GLAntiMeridianHelper.cpp \
+                   $(SRCDIR)/renderer/core/GLFrameStatistics.cpp \
                    $(SRCDIR)/renderer/core/GLLayer2.cpp \
                    $(SRCDIR)/renderer/core/GLLayerFactory2.cpp \
                    $(SRCDIR)/renderer/core/GLLayerSpi2.cpp \
+                   $(SRCDIR)/renderer/core/GLMapBatchable2.cpp \
                    $(SRCDIR)/renderer/core/GLMapRenderGlobals.cpp \
                    $(SRCDIR)/renderer/core/GLMapRenderable2.cpp \
                    $(SRCDIR)/renderer/core/GLMapView2.cpp \
@@ -223,8 +226,10 @@ LOCAL_SRC_FILES += $(SRCDIR)/util/AtomicCounter_NDK.cpp \
 				   $(SRCDIR)/util/Memory.cpp \
                    $(SRCDIR)/util/MemBuffer.cpp \
                    $(SRCDIR)/util/MemBuffer2.cpp \
+                   $(SRCDIR)/util/MemoryAccounting.cpp \
 				   $(SRCDIR)/util/ProcessingCallback.cpp \
 				   $(SRCDIR)/util/ProtocolHandler.cpp \
+                   $(SRCDIR)/util/Tracing.cpp \
 				   $(SRCDIR)/util/Work.cpp \
 				   $(SRCDIR)/util/ZipFile.cpp
 
@@ -257,4 +262,295 @@ LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
 LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
 LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
 
+TAKENGINE_SRC_FILES := $(LOCAL_SRC_FILES)
+TAKENGINE_C_INCLUDES := $(LOCAL_C_INCLUDES)
+
 include $(BUILD_SHARED_LIBRARY)
+
+### HEADLESS FRAME BENCHMARK ###
+
+# Built only with TAKENGINE_FRAMEBENCH=1. Links the engine against the
+# recording GL backend instead of libGLESv3; see sdk/test/framebench.
+ifeq ($(TAKENGINE_FRAMEBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-framebench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/gl/HeadlessRenderContext.cpp \
+                   ../../sdk/test/gl/RecordingGL.cpp \
+                   ../../sdk/test/framebench/framebench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/gl
+LOCAL_LDLIBS := -llog
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### MOSAIC QUERY BENCHMARK ###
+
+# Built only with TAKENGINE_MOSAICBENCH=1; see sdk/test/mosaicbench.
+ifeq ($(TAKENGINE_MOSAICBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-mosaicbench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/mosaicbench/mosaicbench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### MATRIX BENCHMARK ###
+
+# Built only with TAKENGINE_MATRIXBENCH=1; see sdk/test/matrixbench.
+ifeq ($(TAKENGINE_MATRIXBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-matrixbench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/math/Matrix2Reference.cpp \
+                   ../../sdk/test/matrixbench/matrixbench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/math
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### SCENE MODEL BENCHMARK ###
+
+# Built only with TAKENGINE_SCENEBENCH=1; see sdk/test/scenebench.
+ifeq ($(TAKENGINE_SCENEBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-scenebench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/scenebench/scenebench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### TILE-MATRIX BENCHMARK ###
+
+# The tile-matrix renderer, which is not part of the engine library; linked by
+# the tile-matrix benchmark and test.
+TAKENGINE_TILEMATRIX_SRC_FILES := $(SRCDIR)/raster/tilematrix/TileMatrix.cpp \
+                                  $(SRCDIR)/renderer/core/GLResolvable.cpp \
+                                  $(SRCDIR)/renderer/raster/tilematrix/GLResidentTileIndex.cpp \
+                                  $(SRCDIR)/renderer/raster/tilematrix/GLTile.cpp \
+                                  $(SRCDIR)/renderer/raster/tilematrix/GLTilePatch.cpp \
+                                  $(SRCDIR)/renderer/raster/tilematrix/GLTiledLayerCore.cpp \
+                                  $(SRCDIR)/renderer/raster/tilematrix/GLZoomLevel.cpp \
+                                  $(SRCDIR)/renderer/raster/tilereader/GLTileMesh.cpp
+
+# Built only with TAKENGINE_TILEBENCH=1. Links the engine and the tile-matrix
+# renderer against the recording GL backend; see sdk/test/tilebench.
+ifeq ($(TAKENGINE_TILEBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-tilebench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += $(TAKENGINE_TILEMATRIX_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/gl/HeadlessRenderContext.cpp \
+                   ../../sdk/test/gl/RecordingGL.cpp \
+                   ../../sdk/test/tilebench/tilebench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/gl
+LOCAL_LDLIBS := -llog
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### CATALOG VALIDATION BENCHMARK ###
+
+# Built only with TAKENGINE_CATALOGBENCH=1; see sdk/test/catalogbench.
+ifeq ($(TAKENGINE_CATALOGBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-catalogbench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/catalogbench/catalogbench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### ELEVATION SOURCE CONTENTION BENCHMARK ###
+
+# Built only with TAKENGINE_ELEVATIONBENCH=1; see sdk/test/elevationbench.
+ifeq ($(TAKENGINE_ELEVATIONBENCH),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-elevationbench
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/elevationbench/elevationbench.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
+
+### TESTS ###
+
+# Built only with TAKENGINE_TESTS=1. Each test links the engine, against the
+# recording GL backend where it draws, and exits non-zero on failure.
+ifeq ($(TAKENGINE_TESTS),1)
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-test-memoryaccounting
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/gl/RecordingGL.cpp \
+                   ../../sdk/test/util/MemoryAccountingTest.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/gl
+LOCAL_LDLIBS := -llog
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+
+# The Matrix2 precision test is built with the default kernels and with
+# TE_MATRIX2_NO_SIMD; both must pass for the kernels to be bit-identical.
+# Multiply-add contraction is disabled, as it changes the rounding.
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__ -ffp-contract=off
+LOCAL_MODULE := takengine-test-matrix2
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/math/Matrix2Reference.cpp \
+                   ../../sdk/test/math/Matrix2Test.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/math
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__ -ffp-contract=off
+LOCAL_MODULE := takengine-test-matrix2-scalar
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/math/Matrix2Reference.cpp \
+                   ../../sdk/test/math/Matrix2Test.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/math
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3 -DTE_MATRIX2_NO_SIMD
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-test-work
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/util/WorkTest.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-test-tilefallback
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += $(TAKENGINE_TILEMATRIX_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/gl/HeadlessRenderContext.cpp \
+                   ../../sdk/test/gl/RecordingGL.cpp \
+                   ../../sdk/test/renderer/GLTileFallbackTest.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/gl
+LOCAL_LDLIBS := -llog
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-test-fixedpipeline
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/gl/RecordingGL.cpp \
+                   ../../sdk/test/renderer/GLES20FixedPipelineTest.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../sdk/test/gl
+LOCAL_LDLIBS := -llog
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHORT_COMMANDS := true
+LOCAL_CFLAGS=-O3 -std=c++11 -D__GXX_EXPERIMENTAL_CXX0X__
+LOCAL_MODULE := takengine-test-tracing
+LOCAL_SRC_FILES := $(TAKENGINE_SRC_FILES)
+LOCAL_SRC_FILES += ../../sdk/test/util/TracingTest.cpp
+LOCAL_C_INCLUDES := $(TAKENGINE_C_INCLUDES)
+LOCAL_LDLIBS := -llog -lGLESv3
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libgdal
+LOCAL_SHARED_LIBRARIES += ttp-prebuilt-libspatialite
+LOCAL_CPPFLAGS := -DRTTI_ENABLED -DTE_GLES_VERSION=3
+
+include $(BUILD_EXECUTABLE)
+endif
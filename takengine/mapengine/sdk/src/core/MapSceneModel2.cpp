@@ -70,6 +70,9 @@ namespace
     TAKErr rotateAboutImpl(MapSceneModel2Ptr &value, const MapSceneModel2 &scene, const GeoPoint2 &point, const double theta, const double ax, const double ay, const double az) NOTHROWS;
     TAKErr createTargetTransform(Matrix2 *xformTarget, const GeoPoint2 &focusGeo, Projection2 &mapProjection, const double mapRotation, const double mapTilt) NOTHROWS;
     MapCamera2::Mode &defaultCameraMode() NOTHROWS;
+
+    TAKErr intersectRay(GeoPoint2 *value, const Projection2 &proj, const GeometryModel2 &model, const Point2<double> &org, const Point2<double> &tgt, const Vector4<double> &dir, const bool nearestIfOffWorld) NOTHROWS;
+    void setInvalid(Point2<double> *value) NOTHROWS;
 }
 
 MapSceneModel2::MapSceneModel2() NOTHROWS :
@@ -126,6 +129,61 @@ TAKErr MapSceneModel2::forward(Point2<double> *point, const GeoPoint2& geo) cons
     return code;
 }
 
+TAKErr MapSceneModel2::forward(Point2<float> *value, const GeoPoint2 *geos, const std::size_t count) const NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!projection)
+        return TE_IllegalState;
+    if (count && (!value || !geos))
+        return TE_InvalidArg;
+
+    // stage through doubles in fixed blocks to keep the bulk transform
+    // without a heap allocation
+    const std::size_t blockSize = 64u;
+    Point2<double> scratch[blockSize];
+    for (std::size_t off = 0u; off < count; off += blockSize) {
+        const std::size_t n = std::min(blockSize, count - off);
+        if (this->forward(scratch, geos + off, n) != TE_Ok)
+            code = TE_Err;
+        for (std::size_t i = 0u; i < n; i++) {
+            value[off + i].x = (float)scratch[i].x;
+            value[off + i].y = (float)scratch[i].y;
+            value[off + i].z = (float)scratch[i].z;
+        }
+    }
+    return code;
+}
+
+TAKErr MapSceneModel2::forward(Point2<double> *value, const GeoPoint2 *geos, const std::size_t count) const NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!projection)
+        return TE_IllegalState;
+    if (count && (!value || !geos))
+        return TE_InvalidArg;
+
+    for (std::size_t i = 0u; i < count; i++) {
+        if (projection->forward(&value[i], geos[i]) != TE_Ok) {
+            setInvalid(&value[i]);
+            code = TE_Err;
+        }
+    }
+    if (forwardTransform.transform(value, value, count) == TE_Ok)
+        return code;
+
+    // some point hit w == 0 and was left in projected coordinates; redo
+    // point by point to find out which. Only reached for points on the
+    // camera plane of a perspective camera.
+    for (std::size_t i = 0u; i < count; i++) {
+        if (projection->forward(&value[i], geos[i]) != TE_Ok ||
+            forwardTransform.transform(&value[i], value[i]) != TE_Ok) {
+
+            setInvalid(&value[i]);
+        }
+    }
+    return TE_Err;
+}
+
 TAKErr MapSceneModel2::inverse(GeoPoint2 *value, const Point2<float> &point) const NOTHROWS
 {
     return this->inverse(value, point, false);
@@ -169,24 +227,60 @@ TAKErr MapSceneModel2::inverse(GeoPoint2 *value, const Point2<float> &point,
     Vector4<double> dir(tgt.x - org.x, tgt.y - org.y, tgt.z - org.z);
     dir.normalize(&dir);
 
-    Point2<double> pt;
+    return intersectRay(value, *projection, model, org, tgt, dir, nearestIfOffWorld);
+}
 
-    Ray2<double> onWorld(org, dir);
-    bool isect = model.intersect(&pt, onWorld);
-    if (!isect && nearestIfOffWorld)
-    {
-        Vector4<double> owv(-tgt.x, -tgt.y, -tgt.z);
-        owv.normalize(&owv);
-        Ray2<double> offWorld(tgt, owv);
-        isect = model.intersect(&pt, offWorld);
-    }
-    if (isect)
-    {
-        projection->inverse(value, pt);
-        return TE_Ok;
+TAKErr MapSceneModel2::inverse(GeoPoint2 *value, const Point2<float> *points, const std::size_t count, const bool nearestIfOffWorld) const NOTHROWS
+{
+    if (!earth)
+        return TE_IllegalState;
+    return this->inverse(value, points, count, *this->earth, nearestIfOffWorld);
+}
+
+TAKErr MapSceneModel2::inverse(GeoPoint2 *value, const Point2<float> *points, const std::size_t count, const GeometryModel2 &model, const bool nearestIfOffWorld) const NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!projection)
+        return TE_IllegalState;
+    if (count && (!value || !points))
+        return TE_InvalidArg;
+
+    double m[16];
+    code = inverseTransform.get(m, Matrix2::COLUMN_MAJOR);
+    TE_CHECKRETURN_CODE(code);
+
+    // An orthographic camera yields an affine inverse. All pick rays are then
+    // parallel, and a ray's origin on the near plane is linear in screen x,y.
+    // That lets the direction and the origin at screen 0,0 be computed once
+    // for the whole batch. This is not kept on the model, because owners such
+    // as GLMapView2 adjust the public transforms in place.
+    const bool affine = (m[3] == 0.0 && m[7] == 0.0 && m[11] == 0.0 && m[15] == 1.0);
+    const Point2<double> nearOrigin(m[12] - m[8], m[13] - m[9], m[14] - m[10]);
+    Vector4<double> affineDir(m[8], m[9], m[10]);
+    if (affine)
+        affineDir.normalize(&affineDir);
+
+    for (std::size_t i = 0u; i < count; i++) {
+        const double x = points[i].x;
+        const double y = points[i].y;
+
+        TAKErr pointCode;
+        if (affine) {
+            const Point2<double> org(nearOrigin.x + (x*m[0]) + (y*m[4]),
+                                     nearOrigin.y + (x*m[1]) + (y*m[5]),
+                                     nearOrigin.z + (x*m[2]) + (y*m[6]));
+            const Point2<double> tgt(org.x + 2.0*m[8], org.y + 2.0*m[9], org.z + 2.0*m[10]);
+            pointCode = intersectRay(&value[i], *projection, model, org, tgt, affineDir, nearestIfOffWorld);
+        } else {
+            pointCode = this->inverse(&value[i], points[i], model, nearestIfOffWorld);
+        }
+        if (pointCode != TE_Ok) {
+            value[i] = GeoPoint2();
+            code = TE_Err;
+        }
     }
 
-    return TE_Err;
+    return code;
 }
 
 TAKErr MapSceneModel2::init(double display_dpi, std::size_t map_width, std::size_t map_height, int srid, const GeoPoint2 &focusGeo, float focus_x,
@@ -194,11 +288,14 @@ TAKErr MapSceneModel2::init(double display_dpi, std::size_t map_width, std::size
 {
     TAKErr code(TE_Ok);
 
-    // obtain the projection
-    code = ProjectionFactory3_create(this->projection, srid);
-    TE_CHECKRETURN_CODE(code);
+    // obtain the projection. A scene that is repeatedly 'set' generally
+    // keeps its SRID, so skip the factory and display model lookups then.
+    if (!this->projection || !this->displayModel || this->projection->getSpatialReferenceID() != srid) {
+        code = ProjectionFactory3_create(this->projection, srid);
+        TE_CHECKRETURN_CODE(code);
 
-    this->displayModel = getDisplayModel(*this->projection);
+        this->displayModel = getDisplayModel(*this->projection);
+    }
 
     this->displayDpi = display_dpi;
     this->width = map_width;
@@ -250,16 +347,23 @@ TAKErr MapSceneModel2::set(const double display_dpi, const std::size_t map_width
 
 MapSceneModel2 &MapSceneModel2::operator=(const MapSceneModel2 &other) NOTHROWS
 {
-    // clone the projection and display model
-    if (other.projection.get()) {
-        ProjectionFactory3_create(this->projection, other.projection->getSpatialReferenceID());
-        this->displayModel = getDisplayModel(*this->projection);
-    } else {
+    if (this == &other)
+        return *this;
+
+    // clone the projection and share the display model. The SDK
+    // projections are static instances handed out with a leaker, so those
+    // can be shared directly without going through the factory lock.
+    if (!other.projection.get()) {
         this->projection.reset();
-        this->displayModel.reset();
+    } else if (other.projection.get_deleter() == Memory_leaker_const<Projection2>) {
+        this->projection = Projection2Ptr(other.projection.get(), Memory_leaker_const<Projection2>);
+    } else if (!this->projection.get() || this->projection->getSpatialReferenceID() != other.projection->getSpatialReferenceID()) {
+        ProjectionFactory3_create(this->projection, other.projection->getSpatialReferenceID());
     }
+    this->displayModel = other.displayModel;
 
     // copy the dimensions
+    this->displayDpi = other.displayDpi;
     this->width = other.width;
     this->height = other.height;
     this->focusX = other.focusX;
@@ -268,7 +372,10 @@ MapSceneModel2 &MapSceneModel2::operator=(const MapSceneModel2 &other) NOTHROWS
 
     // assign the publicly visible 'earth' pointer. we'll use a "leaker" here
     // because the actual memory is owned by 'displayModel'
-    this->earth = GeometryModel2Ptr(this->displayModel->earth.get(), Memory_leaker_const<GeometryModel2>);
+    if (this->displayModel.get())
+        this->earth = GeometryModel2Ptr(this->displayModel->earth.get(), Memory_leaker_const<GeometryModel2>);
+    else
+        this->earth.reset();
 
     // copy the forward and inverse transforms
     this->forwardTransform = other.forwardTransform;
@@ -516,9 +623,14 @@ namespace
     {
         TAKErr code(TE_Ok);
 
+        // the map projection generally is ECEF already
         Projection2Ptr ecef(nullptr, nullptr);
-        code = ProjectionFactory3_create(ecef, 4978);
-        TE_CHECKRETURN_CODE(code);
+        if (proj.getSpatialReferenceID() == 4978) {
+            ecef = Projection2Ptr(&proj, Memory_leaker_const<Projection2>);
+        } else {
+            code = ProjectionFactory3_create(ecef, 4978);
+            TE_CHECKRETURN_CODE(code);
+        }
 
         Point2<double> scratch;
         code = ecef->forward(&scratch, focus);
@@ -1340,4 +1452,33 @@ namespace
         static MapCamera2::Mode m = MapCamera2::Scale;
         return m;
     }
+
+    TAKErr intersectRay(GeoPoint2 *value, const Projection2 &proj, const GeometryModel2 &model, const Point2<double> &org, const Point2<double> &tgt, const Vector4<double> &dir, const bool nearestIfOffWorld) NOTHROWS
+    {
+        Point2<double> pt;
+
+        Ray2<double> onWorld(org, dir);
+        bool isect = model.intersect(&pt, onWorld);
+        if (!isect && nearestIfOffWorld)
+        {
+            Vector4<double> owv(-tgt.x, -tgt.y, -tgt.z);
+            owv.normalize(&owv);
+            Ray2<double> offWorld(tgt, owv);
+            isect = model.intersect(&pt, offWorld);
+        }
+        if (isect)
+        {
+            proj.inverse(value, pt);
+            return TE_Ok;
+        }
+
+        return TE_Err;
+    }
+
+    void setInvalid(Point2<double> *value) NOTHROWS
+    {
+        value->x = NAN;
+        value->y = NAN;
+        value->z = NAN;
+    }
 }
@@ -34,6 +34,21 @@ namespace TAK {
                 Util::TAKErr inverse(GeoPoint2 *geo, const Math::Point2<float> &point) const NOTHROWS;
                 Util::TAKErr inverse(GeoPoint2 *geo, const Math::Point2<float> &point, const bool nearestIfOffWorld) const NOTHROWS;
                 Util::TAKErr inverse(GeoPoint2  *geo, const Math::Point2<float> &point, const Math::GeometryModel2& model) const NOTHROWS;
+            public:
+                /**
+                 * Bulk forms of forward and inverse, for callers that hit
+                 * test or place many points against the same scene.
+                 * Results match invoking the single point form for each
+                 * element, to within rounding.
+                 *
+                 * @return  TE_Ok, or TE_Err if any point could not be
+                 *          transformed; those elements are set to NAN, all
+                 *          others hold valid results
+                 */
+                Util::TAKErr forward(TAK::Engine::Math::Point2<float> *points, const GeoPoint2 *geos, const std::size_t count) const NOTHROWS;
+                Util::TAKErr forward(TAK::Engine::Math::Point2<double> *points, const GeoPoint2 *geos, const std::size_t count) const NOTHROWS;
+                Util::TAKErr inverse(GeoPoint2 *geos, const Math::Point2<float> *points, const std::size_t count, const bool nearestIfOffWorld) const NOTHROWS;
+                Util::TAKErr inverse(GeoPoint2 *geos, const Math::Point2<float> *points, const std::size_t count, const Math::GeometryModel2 &model, const bool nearestIfOffWorld) const NOTHROWS;
             public:
                 MapSceneModel2 &operator=(const MapSceneModel2 &other) NOTHROWS;
             private:
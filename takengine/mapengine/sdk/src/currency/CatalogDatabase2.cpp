@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "currency/Currency2.h"
 #include "currency/CurrencyRegistry2.h"
@@ -12,6 +14,8 @@
 #include "util/IO.h"
 #include "util/IO2.h"
 #include "util/Logging.h"
+#include "util/Tasking.h"
+#include "util/Work.h"
 
 using namespace TAK::Engine::Currency;
 
@@ -37,7 +41,8 @@ using namespace atakmap::util;
 #define COL_CATALOG_METADATA_VALUE   "value"
 
 #define DEFAULT_PATH_CATALOG_CURSOR_QUERY \
-    "SELECT " COL_CATALOG_PATH ", " \
+    "SELECT " COL_CATALOG_ID ", " \
+    COL_CATALOG_PATH ", " \
     COL_CATALOG_SYNC ", " \
     COL_CATALOG_APP_VERSION ", " \
     COL_CATALOG_APP_DATA ", " \
@@ -45,7 +50,8 @@ using namespace atakmap::util;
     TBL_CATALOG " WHERE " COL_CATALOG_PATH " = ?"
 
 #define DEFAULT_CURRENCY_CATALOG_CURSOR_QUERY \
-    "SELECT " COL_CATALOG_PATH ", " \
+    "SELECT " COL_CATALOG_ID ", " \
+    COL_CATALOG_PATH ", " \
     COL_CATALOG_SYNC ", " \
     COL_CATALOG_APP_VERSION ", " \
     COL_CATALOG_APP_DATA ", " \
@@ -67,7 +73,25 @@ const char * const CatalogDatabase2::COLUMN_CATALOG_METADATA_VALUE = COL_CATALOG
 
 namespace
 {
+    // rows checked per validation task; catalogs smaller than this are validated on the calling thread
+    const std::size_t MIN_ROWS_PER_VALIDATION_TASK = 256u;
+    const std::size_t MAX_VALIDATION_TASKS = 8u;
+    // bound parameters per batched delete; well under SQLITE_MAX_VARIABLE_NUMBER
+    const std::size_t MAX_DELETE_BATCH_SIZE = 500u;
+
+    struct CatalogValidationRow
+    {
+        int64_t id;
+        std::string path;
+        CatalogCurrency2 *currency;
+        int appVersion;
+        std::vector<uint8_t> appData;
+        bool valid;
+    };
+
     TAKErr isValidApp(bool *value, CatalogDatabase2::CatalogCursor &result, CatalogCurrency2 *currency);
+    TAKErr isValidApp(bool *value, const CatalogValidationRow &row);
+    TAKErr validateCatalogRows(std::size_t &numInvalid, CatalogValidationRow *rows, const std::size_t count);
     
     // Transforms the COLUM_CATALOG_PATH value into the runtime path version (used for TE_SHOULD_ADAPT_STORAGE_PATH == 1)
     class StoragePathAdapterCatalogCursor : public CatalogDatabase2::CatalogCursor
@@ -104,7 +128,8 @@ CatalogDatabase2::CatalogDatabase2(CatalogCurrencyRegistry2 &currencyRegistry_)
     database(nullptr, nullptr),
     currencyRegistry(currencyRegistry_),
     updateCatalogEntrySyncStmt(nullptr, nullptr),
-    mutex(TEMT_Recursive)
+    mutex(TEMT_Recursive),
+    modCount(0u)
 {}
 
 CatalogDatabase2::~CatalogDatabase2() NOTHROWS
@@ -225,6 +250,11 @@ TAKErr CatalogDatabase2::onCatalogEntryAdded(int64_t catalogId) NOTHROWS
     return TE_Ok;
 }
 
+TAKErr CatalogDatabase2::onCatalogValidated() NOTHROWS
+{
+    return TE_Ok;
+}
+
 TAKErr CatalogDatabase2::addCatalogEntry(int64_t *rowId, const char *derivedFrom, CatalogCurrency2 &currency) NOTHROWS
 {
     TAKErr code(TE_Ok);
@@ -270,6 +300,8 @@ TAKErr CatalogDatabase2::addCatalogEntryNoSync(int64_t *rowId, const char *deriv
     TE_CHECKRETURN_CODE(code);
     stmt.reset();
 
+    this->modCount++;
+
     code = Databases_lastInsertRowID(rowId, *this->database);
     TE_CHECKRETURN_CODE(code);
 
@@ -317,33 +349,21 @@ TAKErr CatalogDatabase2::updateCatalogEntryNoSync(const int64_t rowId, const cha
     TE_CHECKRETURN_CODE(code);
     stmt.reset();
 
+    this->modCount++;
+
     return code;
 }
 
 TAKErr CatalogDatabase2::validateCatalog() NOTHROWS
 {
-    TAKErr code(TE_Ok);
-    Lock lock(mutex);
-    code = lock.status;
-    TE_CHECKRETURN_CODE(code);
-
-    CatalogCursorPtr result(nullptr, nullptr);
-    code = this->queryCatalog(result);
-    TE_CHECKRETURN_CODE(code);
-    return this->validateCatalogNoSync(*result);
+    return this->validateCatalogImpl(nullptr);
 }
 
 TAKErr CatalogDatabase2::validateCatalogApp(const char *appName) NOTHROWS
 {
-    TAKErr code(TE_Ok);
-    Lock lock(mutex);
-    code = lock.status;
-    TE_CHECKRETURN_CODE(code);
-
-    CatalogCursorPtr result(nullptr, nullptr);
-    code = this->queryCatalogApp(result, appName);
-    TE_CHECKRETURN_CODE(code);
-    return this->validateCatalogNoSync(*result);
+    if (!appName)
+        return TE_InvalidArg;
+    return this->validateCatalogImpl(appName);
 }
 
 TAKErr CatalogDatabase2::validateCatalogPath(const char *file) NOTHROWS
@@ -409,8 +429,162 @@ TAKErr CatalogDatabase2::validateCatalogNoSync(CatalogCursor &result) NOTHROWS
         code = this->database->setTransactionSuccessful();
         TE_CHECKRETURN_CODE(code);
     }
+    transaction.reset();
 
-    return code;
+    return this->onCatalogValidated();
+}
+
+TAKErr CatalogDatabase2::validateCatalogImpl(const char *appName) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+
+    // capture the rows while the catalog is locked; the currency checks may
+    // touch the filesystem and are made with the lock released
+    std::vector<CatalogValidationRow> rows;
+    std::size_t snapshotModCount;
+    {
+        Lock lock(mutex);
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+
+        CatalogCursorPtr result(nullptr, nullptr);
+        if (appName)
+            code = this->queryCatalogApp(result, appName);
+        else
+            code = this->queryCatalog(result);
+        TE_CHECKRETURN_CODE(code);
+
+        do {
+            code = result->moveToNext();
+            TE_CHECKBREAK_CODE(code);
+
+            CatalogValidationRow row;
+            row.currency = nullptr;
+            row.appVersion = 0;
+
+            code = result->getId(&row.id);
+            TE_CHECKBREAK_CODE(code);
+            const char *path;
+            code = result->getPath(&path);
+            TE_CHECKBREAK_CODE(code);
+            if (path)
+                row.path = path;
+
+            code = this->prevalidateCatalogRowNoSync(&row.valid, *result);
+            TE_CHECKBREAK_CODE(code);
+
+            const char *rowAppName;
+            if (row.valid && result->getAppName(&rowAppName) == TE_Ok && rowAppName)
+                row.currency = this->currencyRegistry.getCurrency(rowAppName);
+            if (row.currency) {
+                code = result->getAppVersion(&row.appVersion);
+                TE_CHECKBREAK_CODE(code);
+
+                const uint8_t *appData;
+                std::size_t appDataLen;
+                code = result->getAppData(&appData, &appDataLen);
+                TE_CHECKBREAK_CODE(code);
+                if (appData)
+                    row.appData.assign(appData, appData + appDataLen);
+            } else {
+                row.valid = false;
+            }
+
+            rows.push_back(std::move(row));
+        } while (true);
+        if (code == TE_Done)
+            code = TE_Ok;
+        TE_CHECKRETURN_CODE(code);
+
+        snapshotModCount = this->modCount;
+    }
+
+    // check the rows against their currencies
+    std::size_t numInvalid = 0u;
+    const std::size_t numTasks = std::min(rows.size() / MIN_ROWS_PER_VALIDATION_TASK, MAX_VALIDATION_TASKS);
+    if (numTasks <= 1u) {
+        code = validateCatalogRows(numInvalid, rows.data(), rows.size());
+        TE_CHECKRETURN_CODE(code);
+    } else {
+        SharedWorkerPtr worker(GeneralWorkers_flex());
+        const std::size_t rowsPerTask = (rows.size() + numTasks - 1u) / numTasks;
+
+        std::vector<FutureTask<std::size_t>> tasks;
+        tasks.reserve(numTasks);
+        for (std::size_t i = 0u; i < rows.size(); i += rowsPerTask) {
+            CatalogValidationRow *taskRows = rows.data() + i;
+            const std::size_t taskRowCount = std::min(rowsPerTask, rows.size() - i);
+            tasks.push_back(Task_begin(worker, validateCatalogRows, taskRows, taskRowCount));
+        }
+
+        // every task must complete before the rows go out of scope
+        for (std::size_t i = 0u; i < tasks.size(); i++) {
+            std::size_t taskInvalid = 0u;
+            TAKErr taskCode(TE_Ok);
+            TAKErr awaitCode = tasks[i].await(taskInvalid, taskCode);
+            if (awaitCode == TE_Ok)
+                awaitCode = taskCode;
+            if (awaitCode != TE_Ok && code == TE_Ok)
+                code = awaitCode;
+            numInvalid += taskInvalid;
+        }
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    Lock lock(mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    std::vector<int64_t> invalidIds;
+    invalidIds.reserve(numInvalid);
+
+    const bool modified = (this->modCount != snapshotModCount);
+    for (std::size_t i = 0u; i < rows.size(); i++) {
+        CatalogValidationRow &row = rows[i];
+        if (row.valid)
+            continue;
+
+        if (modified) {
+            // the entry may have been updated while it was being checked
+            CatalogCursorPtr result(nullptr, nullptr);
+            code = this->queryCatalogPath(result, row.path.c_str());
+            TE_CHECKBREAK_CODE(code);
+            if (result->moveToNext() != TE_Ok)
+                continue;
+            code = this->validateCatalogRowNoSync(&row.valid, *result);
+            TE_CHECKBREAK_CODE(code);
+            if (row.valid)
+                continue;
+            code = result->getId(&row.id);
+            TE_CHECKBREAK_CODE(code);
+        }
+
+        invalidIds.push_back(row.id);
+    }
+    TE_CHECKRETURN_CODE(code);
+
+    if (!invalidIds.empty()) {
+        bool inTrans;
+        code = this->database->inTransaction(&inTrans);
+        TE_CHECKRETURN_CODE(code);
+
+        std::unique_ptr<Database2::Transaction> transaction(nullptr);
+        if (!inTrans) {
+            transaction.reset(new Database2::Transaction(*this->database.get()));
+            if (!transaction->isValid())
+                return TE_Err;
+        }
+
+        code = this->deleteCatalogEntriesNoSync(invalidIds.data(), invalidIds.size());
+        TE_CHECKRETURN_CODE(code);
+
+        if (transaction.get()) {
+            code = this->database->setTransactionSuccessful();
+            TE_CHECKRETURN_CODE(code);
+        }
+    }
+
+    return this->onCatalogValidated();
 }
 
 TAKErr CatalogDatabase2::validateCatalogRowNoSync(bool *value, CatalogCursor &row) NOTHROWS
@@ -418,6 +592,11 @@ TAKErr CatalogDatabase2::validateCatalogRowNoSync(bool *value, CatalogCursor &ro
     CatalogCurrency2 *currency = nullptr;
     TAKErr code;
 
+    code = this->prevalidateCatalogRowNoSync(value, row);
+    TE_CHECKRETURN_CODE(code);
+    if (!*value)
+        return code;
+
     const char *appName;
     code = row.getAppName(&appName);
     if (code == TE_Ok)
@@ -431,6 +610,12 @@ TAKErr CatalogDatabase2::validateCatalogRowNoSync(bool *value, CatalogCursor &ro
     return code;
 }
 
+TAKErr CatalogDatabase2::prevalidateCatalogRowNoSync(bool *value, CatalogCursor &row) NOTHROWS
+{
+    *value = true;
+    return TE_Ok;
+}
+
 TAKErr CatalogDatabase2::markCatalogEntryValid(const char *file) NOTHROWS
 {
     TAKErr code(TE_Ok);
@@ -456,6 +641,8 @@ TAKErr CatalogDatabase2::markCatalogEntryValid(const char *file) NOTHROWS
     code = this->updateCatalogEntrySyncStmt->clearBindings();
     TE_CHECKRETURN_CODE(code);
 
+    this->modCount++;
+
     code = this->onCatalogEntryMarkedValid(-1);
     TE_CHECKRETURN_CODE(code);
 
@@ -600,12 +787,60 @@ TAKErr CatalogDatabase2::deleteCatalogPath(const char *path, bool automated) NOT
     TE_CHECKRETURN_CODE(code);
     stmt.reset();
 
+    this->modCount++;
+
     code = this->onCatalogEntryRemoved(catalogId, automated);
     TE_CHECKRETURN_CODE(code);
 
     return code;
 }
 
+TAKErr CatalogDatabase2::deleteCatalogEntriesNoSync(const int64_t *catalogIds, const std::size_t count) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+
+    StatementPtr stmt(nullptr, nullptr);
+    std::size_t stmtBatchSize = 0u;
+    for (std::size_t i = 0u; i < count; i += MAX_DELETE_BATCH_SIZE) {
+        const std::size_t batchSize = std::min(count - i, MAX_DELETE_BATCH_SIZE);
+        // all full batches share one statement; only a trailing partial batch needs another
+        if (batchSize != stmtBatchSize) {
+            stmt.reset();
+
+            std::ostringstream sql;
+            sql << "DELETE FROM " TBL_CATALOG " WHERE " COL_CATALOG_ID " IN (?";
+            for (std::size_t j = 1u; j < batchSize; j++)
+                sql << ", ?";
+            sql << ")";
+
+            code = this->database->compileStatement(stmt, sql.str().c_str());
+            TE_CHECKRETURN_CODE(code);
+            stmtBatchSize = batchSize;
+        } else {
+            code = stmt->clearBindings();
+            TE_CHECKRETURN_CODE(code);
+        }
+
+        for (std::size_t j = 0u; j < batchSize; j++) {
+            code = stmt->bindLong(j + 1u, catalogIds[i + j]);
+            TE_CHECKBREAK_CODE(code);
+        }
+        TE_CHECKRETURN_CODE(code);
+        code = stmt->execute();
+        TE_CHECKRETURN_CODE(code);
+    }
+    stmt.reset();
+
+    this->modCount++;
+
+    for (std::size_t i = 0u; i < count; i++) {
+        code = this->onCatalogEntryRemoved(catalogIds[i], true);
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    return code;
+}
+
 TAKErr CatalogDatabase2::deleteCatalogApp(const char *appName) NOTHROWS
 {
     TAKErr code;
@@ -624,6 +859,7 @@ TAKErr CatalogDatabase2::deleteCatalogApp(const char *appName) NOTHROWS
     code = Databases_lastChangeCount(&numDeleted, *this->database);
     TE_CHECKRETURN_CODE(code);
     if (numDeleted > 0) {
+        this->modCount++;
         code = this->onCatalogEntryRemoved(-1, true);
         TE_CHECKRETURN_CODE(code);
     }
@@ -728,6 +964,16 @@ TAKErr CatalogDatabase2::CatalogCursor::getSyncVersion(int *value) NOTHROWS
     return this->getInt(value, idx);
 }
 
+TAKErr CatalogDatabase2::CatalogCursor::getId(int64_t *value) NOTHROWS
+{
+    std::size_t idx;
+    TAKErr code;
+
+    code = this->getColumnIndex(&idx, COLUMN_CATALOG_ID);
+    TE_CHECKRETURN_CODE(code);
+    return this->getLong(value, idx);
+}
+
 namespace
 {
     TAKErr isValidApp(bool *value, CatalogDatabase2::CatalogCursor &result, CatalogCurrency2 *currency)
@@ -760,6 +1006,37 @@ namespace
             appVersion,
             CatalogCurrency2::AppData{ appData, appDataLen });
     }
+
+    TAKErr isValidApp(bool *value, const CatalogValidationRow &row)
+    {
+        *value = false;
+
+        if (!row.currency)
+            return TE_Ok;
+
+        if (!atakmap::util::pathExists(row.path.c_str()))
+            return TE_Ok;
+
+        return row.currency->isValidApp(value,
+            row.path.c_str(),
+            row.appVersion,
+            CatalogCurrency2::AppData{ row.appData.data(), row.appData.size() });
+    }
+
+    TAKErr validateCatalogRows(std::size_t &numInvalid, CatalogValidationRow *rows, const std::size_t count)
+    {
+        TAKErr code(TE_Ok);
+        numInvalid = 0u;
+        for (std::size_t i = 0u; i < count; i++) {
+            if (rows[i].valid) {
+                code = isValidApp(&rows[i].valid, rows[i]);
+                TE_CHECKBREAK_CODE(code);
+            }
+            if (!rows[i].valid)
+                numInvalid++;
+        }
+        return code;
+    }
     
     StoragePathAdapterCatalogCursor::StoragePathAdapterCatalogCursor(TAK::Engine::DB::QueryPtr &&cursor) NOTHROWS :
     CatalogDatabase2::CatalogCursor(std::move(cursor)),
@@ -79,6 +79,12 @@ namespace TAK {
 
                 virtual TAK::Engine::Util::TAKErr onCatalogEntryAdded(int64_t catalogId) NOTHROWS;
 
+                /**
+                * Invoked once a validation pass has completed and any invalid entries have been
+                * removed. The default implementation does nothing.
+                */
+                virtual TAK::Engine::Util::TAKErr onCatalogValidated() NOTHROWS;
+
             public :
                 virtual TAK::Engine::Util::TAKErr addCatalogEntry(int64_t *rowId, const char *derivedFrom, CatalogCurrency2 &currency) NOTHROWS;
                 virtual TAK::Engine::Util::TAKErr updateCatalogEntry(const int64_t rowId, const char *derivedFrom, CatalogCurrency2 &currency) NOTHROWS;
@@ -86,12 +92,37 @@ namespace TAK {
                 virtual TAK::Engine::Util::TAKErr addCatalogEntryNoSync(int64_t *rowId, const char *derivedFrom, CatalogCurrency2 &currency) NOTHROWS;
                 virtual TAK::Engine::Util::TAKErr updateCatalogEntryNoSync(const int64_t rowId, const char *derivedFrom, CatalogCurrency2 &currency) NOTHROWS;
             public :
+                /**
+                * Validates all entries in the catalog, removing those that are no longer valid.
+                * <P>
+                * The rows are read while the catalog is locked, then checked against their
+                * currency on a worker pool with the lock released; the invalid entries are
+                * removed in batches within a single transaction once the lock is reacquired.
+                * Entries that were modified while the checks were running are checked again
+                * under the lock before they are removed.
+                */
                 virtual TAK::Engine::Util::TAKErr validateCatalog() NOTHROWS;
+                /**
+                * Validates the entries for the specified application, as with
+                * {@link #validateCatalog()}.
+                */
                 virtual TAK::Engine::Util::TAKErr validateCatalogApp(const char *appName) NOTHROWS;
                 virtual TAK::Engine::Util::TAKErr validateCatalogPath(const char *file) NOTHROWS;
             protected :
                 virtual TAK::Engine::Util::TAKErr validateCatalogNoSync(CatalogCursor &result) NOTHROWS;
                 virtual TAK::Engine::Util::TAKErr validateCatalogRowNoSync(bool *value, CatalogCursor &row) NOTHROWS;
+                /**
+                * Performs any checks on the row that must be made against the cursor, prior to
+                * the row being checked against its currency. This method is invoked while the
+                * catalog is locked; the currency check may be made on another thread after the
+                * lock has been released.
+                * <P>
+                * The default implementation accepts all rows.
+                */
+                virtual TAK::Engine::Util::TAKErr prevalidateCatalogRowNoSync(bool *value, CatalogCursor &row) NOTHROWS;
+            private :
+                TAK::Engine::Util::TAKErr validateCatalogImpl(const char *appName) NOTHROWS;
+                TAK::Engine::Util::TAKErr deleteCatalogEntriesNoSync(const int64_t *catalogIds, const std::size_t count) NOTHROWS;
             public :
                 virtual TAK::Engine::Util::TAKErr markCatalogEntryValid(const char *file) NOTHROWS;
                 virtual TAK::Engine::Util::TAKErr queryCatalog(CatalogCursorPtr &cursor) NOTHROWS;
@@ -162,6 +193,9 @@ namespace TAK {
 
                 TAK::Engine::DB::StatementPtr updateCatalogEntrySyncStmt;
                 Thread::Mutex mutex;
+            private :
+                /** incremented on every modification of the catalog table; guarded by <code>mutex</code> */
+                std::size_t modCount;
             };
 
             class CatalogDatabase2::CatalogCursor : public TAK::Engine::DB::CursorWrapper2
@@ -176,6 +210,7 @@ namespace TAK {
                 TAK::Engine::Util::TAKErr getAppName(const char **value) NOTHROWS;
                 TAK::Engine::Util::TAKErr getAppData(const uint8_t **value, std::size_t *valLen) NOTHROWS;
                 TAK::Engine::Util::TAKErr getSyncVersion(int *value) NOTHROWS;
+                TAK::Engine::Util::TAKErr getId(int64_t *value) NOTHROWS;
 
                 friend class CatalogDatabase2;
             };
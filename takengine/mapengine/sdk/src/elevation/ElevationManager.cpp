@@ -258,7 +258,14 @@ TAKErr TAK::Engine::Elevation::ElevationManager_queryElevationSources(ElevationC
 
     std::list<std::shared_ptr<ElevationSource>> sources;
     TAK::Engine::Port::STLListAdapter<std::shared_ptr<ElevationSource>> sources_w(sources);
-    code = ElevationSourceManager_getSources(sources_w);
+    if (params.spatialFilter.get()) {
+        Feature::Envelope2 region;
+        code = params.spatialFilter->getEnvelope(&region);
+        TE_CHECKRETURN_CODE(code);
+        code = ElevationSourceManager_getSources(sources_w, region);
+    } else {
+        code = ElevationSourceManager_getSources(sources_w);
+    }
     TE_CHECKRETURN_CODE(code);
 
     std::list<std::shared_ptr<ElevationChunkCursor>> cursors;
@@ -1,32 +1,90 @@
 #include "elevation/ElevationSourceManager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <set>
+#include <vector>
 
+#include "math/Rectangle.h"
 #include "thread/Mutex.h"
 #include "thread/Lock.h"
 
 using namespace TAK::Engine::Elevation;
 
+using namespace TAK::Engine::Feature;
 using namespace TAK::Engine::Thread;
 using namespace TAK::Engine::Util;
 
+#define INDEX_CELL_DEGREES 10.0
+#define INDEX_COLUMNS 36
+#define INDEX_ROWS 18
+
 namespace
 {
+    /**
+     * Immutable view of the attached sources. A new snapshot is published
+     * whenever a source is attached or detached, or its bounds change;
+     * readers load the current snapshot without locking.
+     */
+    struct SourceSnapshot
+    {
+        /** the sources, in attach order */
+        std::vector<std::shared_ptr<ElevationSource>> sources;
+        /** the bounds of each source, as of when the snapshot was published */
+        std::vector<Envelope2> bounds;
+        /** indices of the sources without usable bounds; always candidates */
+        std::vector<std::size_t> unbounded;
+        /** INDEX_COLUMNS x INDEX_ROWS grid of the indices of the sources intersecting each cell */
+        std::vector<std::vector<std::size_t>> cells;
+    };
+
+    class BoundsMonitor : public ElevationSource::OnContentChangedListener
+    {
+    public :
+        ~BoundsMonitor() NOTHROWS override;
+    public :
+        TAKErr onContentChanged(const ElevationSource &source) NOTHROWS override;
+    };
+
     Mutex &mutex() NOTHROWS
     {
         static Mutex m;
         return m;
     }
+    /**
+     * Serializes attach and detach, including the subscription to the
+     * source's content changes. Never acquired while holding
+     * <code>mutex()</code>, nor by content change notifications, so that it may
+     * be held while calling into a source.
+     */
+    Mutex &attachMutex() NOTHROWS
+    {
+        static Mutex m;
+        return m;
+    }
     std::set<ElevationSourcesChangedListener *> &listeners() NOTHROWS
     {
         static std::set<ElevationSourcesChangedListener *> l;
         return l;
     }
-    std::set<std::shared_ptr<ElevationSource>> &sources() NOTHROWS
+    std::shared_ptr<const SourceSnapshot> &snapshot() NOTHROWS
     {
-        static std::set<std::shared_ptr<ElevationSource>> s;
+        static std::shared_ptr<const SourceSnapshot> s(std::make_shared<SourceSnapshot>());
         return s;
     }
+    BoundsMonitor &boundsMonitor() NOTHROWS
+    {
+        static BoundsMonitor m;
+        return m;
+    }
+
+    std::shared_ptr<const SourceSnapshot> loadSnapshot() NOTHROWS;
+    TAKErr publishSnapshot(std::vector<std::shared_ptr<ElevationSource>> &&sources, std::vector<Envelope2> &&bounds) NOTHROWS;
+    TAKErr updateBounds(const ElevationSource &source, const Envelope2 &bounds) NOTHROWS;
+    bool equals(const double a, const double b) NOTHROWS;
+    bool equals(const Envelope2 &a, const Envelope2 &b) NOTHROWS;
+    bool clampBounds(Envelope2 &value) NOTHROWS;
+    std::size_t indexOf(const SourceSnapshot &snapshot, const ElevationSource *source) NOTHROWS;
 }
 
 ElevationSourcesChangedListener::~ElevationSourcesChangedListener() NOTHROWS
@@ -53,62 +111,107 @@ TAKErr TAK::Engine::Elevation::ElevationSourceManager_removeOnSourcesChangedList
 TAKErr TAK::Engine::Elevation::ElevationSourceManager_attach(const std::shared_ptr<ElevationSource> &source) NOTHROWS
 {
     TAKErr code(TE_Ok);
-    Lock lock(mutex());
-    code = lock.status;
+    if (!source.get())
+        return TE_InvalidArg;
+
+    Lock attachLock(attachMutex());
+    code = attachLock.status;
     TE_CHECKRETURN_CODE(code);
 
-    sources().insert(source);
+    // membership only changes under the attach lock. The source is subscribed
+    // before its bounds are read, so that no change is missed, and both are
+    // done outside of the registry lock as the source may notify its
+    // listeners while holding its own lock.
+    const bool attaching = (indexOf(*loadSnapshot(), source.get()) == SIZE_MAX);
+    Envelope2 bounds;
+    if (attaching) {
+        source->addOnContentChangedListener(&boundsMonitor());
+        bounds = source->getBounds();
+    }
 
-    std::set<ElevationSourcesChangedListener *> &l = listeners();
-    auto it = l.begin();
-    while (it != l.end()) {
-        if ((*it)->onSourceAttached(source) == TE_Done)
-            it = l.erase(it);
-        else
-            it++;
+    {
+        Lock lock(mutex());
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+
+        if (attaching) {
+            std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+            std::vector<std::shared_ptr<ElevationSource>> s(current->sources);
+            std::vector<Envelope2> b(current->bounds);
+            s.push_back(source);
+            b.push_back(bounds);
+            code = publishSnapshot(std::move(s), std::move(b));
+            TE_CHECKRETURN_CODE(code);
+        }
+
+        std::set<ElevationSourcesChangedListener *> &l = listeners();
+        auto it = l.begin();
+        while (it != l.end()) {
+            if ((*it)->onSourceAttached(source) == TE_Done)
+                it = l.erase(it);
+            else
+                it++;
+        }
     }
 
+    // a change made after the bounds were read but before the source was
+    // published was not applied by the monitor
+    if (attaching)
+        code = updateBounds(*source, source->getBounds());
+
     return code;
 }
 TAKErr TAK::Engine::Elevation::ElevationSourceManager_detach(const ElevationSource &source) NOTHROWS
 {
     TAKErr code(TE_Ok);
+
+    Lock attachLock(attachMutex());
+    code = attachLock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    std::shared_ptr<ElevationSource> detached;
+    {
+        std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+        const std::size_t idx = indexOf(*current, &source);
+        if (idx == SIZE_MAX)
+            return TE_InvalidArg;
+        detached = current->sources[idx];
+    }
+
+    // unsubscribe before the source is removed, outside of the registry lock;
+    // a change reported in between is for a source that is going away
+    detached->removeOnContentChangedListener(&boundsMonitor());
+
     Lock lock(mutex());
     code = lock.status;
     TE_CHECKRETURN_CODE(code);
-    
-    std::set<std::shared_ptr<ElevationSource>> &s = sources();
-    std::set<std::shared_ptr<ElevationSource>>::iterator sourceIter;
-    for (sourceIter = s.begin(); sourceIter != s.end(); sourceIter++) {
-        if (&source == (*sourceIter).get()) {
-            std::shared_ptr<ElevationSource> detached(*sourceIter);
-            s.erase(sourceIter);
-
-            std::set<ElevationSourcesChangedListener *> &l = listeners();
-            auto it = l.begin();
-            while (it != l.end()) {
-                if ((*it)->onSourceDetached(*detached) == TE_Done)
-                    it = l.erase(it);
-                else
-                    it++;
-            }
 
-            return TE_Ok;
-        }
+    std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+    const std::size_t idx = indexOf(*current, &source);
+    std::vector<std::shared_ptr<ElevationSource>> s(current->sources);
+    std::vector<Envelope2> b(current->bounds);
+    s.erase(s.begin() + idx);
+    b.erase(b.begin() + idx);
+    code = publishSnapshot(std::move(s), std::move(b));
+    TE_CHECKRETURN_CODE(code);
+
+    std::set<ElevationSourcesChangedListener *> &l = listeners();
+    auto it = l.begin();
+    while (it != l.end()) {
+        if ((*it)->onSourceDetached(*detached) == TE_Done)
+            it = l.erase(it);
+        else
+            it++;
     }
 
-    return TE_InvalidArg;
+    return code;
 }
 TAKErr TAK::Engine::Elevation::ElevationSourceManager_findSource(std::shared_ptr<ElevationSource> &value, const char *name) NOTHROWS
 {
-    TAKErr code(TE_Ok);
-    Lock lock(mutex());
-    code = lock.status;
-    TE_CHECKRETURN_CODE(code);
+    std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
 
-    std::set<std::shared_ptr<ElevationSource>> &s = sources();
-    std::set<std::shared_ptr<ElevationSource>>::iterator it;
-    for (it = s.begin(); it != s.end(); it++) {
+    const std::vector<std::shared_ptr<ElevationSource>> &s = current->sources;
+    for (auto it = s.begin(); it != s.end(); it++) {
         const char *srcName = (*it)->getName();
         if (!srcName ^ !name)
             continue;
@@ -123,13 +226,10 @@ TAKErr TAK::Engine::Elevation::ElevationSourceManager_findSource(std::shared_ptr
 TAKErr TAK::Engine::Elevation::ElevationSourceManager_getSources(TAK::Engine::Port::Collection<std::shared_ptr<ElevationSource>> &value) NOTHROWS
 {
     TAKErr code(TE_Ok);
-    Lock lock(mutex());
-    code = lock.status;
-    TE_CHECKRETURN_CODE(code);
+    std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
 
-    std::set<std::shared_ptr<ElevationSource>> &s = sources();
-    std::set<std::shared_ptr<ElevationSource>>::iterator it;
-    for (it = s.begin(); it != s.end(); it++) {
+    const std::vector<std::shared_ptr<ElevationSource>> &s = current->sources;
+    for (auto it = s.begin(); it != s.end(); it++) {
         code = value.add(*it);
         TE_CHECKBREAK_CODE(code);
     }
@@ -137,16 +237,51 @@ TAKErr TAK::Engine::Elevation::ElevationSourceManager_getSources(TAK::Engine::Po
 
     return code;
 }
-TAKErr TAK::Engine::Elevation::ElevationSourceManager_visitSources(TAKErr(*visitor)(void *opaque, ElevationSource &src) NOTHROWS, void *opaque) NOTHROWS
+TAKErr TAK::Engine::Elevation::ElevationSourceManager_getSources(TAK::Engine::Port::Collection<std::shared_ptr<ElevationSource>> &value, const Envelope2 &region) NOTHROWS
 {
     TAKErr code(TE_Ok);
-    LockPtr lock(nullptr, nullptr);
-    code = Lock_create(lock, mutex());
+
+    Envelope2 roi(region);
+    if (!clampBounds(roi))
+        return ElevationSourceManager_getSources(value);
+
+    std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+
+    std::vector<std::size_t> candidates(current->unbounded);
+    const int minCol = std::min((int)((roi.minX + 180.0) / INDEX_CELL_DEGREES), INDEX_COLUMNS - 1);
+    const int maxCol = std::min((int)((roi.maxX + 180.0) / INDEX_CELL_DEGREES), INDEX_COLUMNS - 1);
+    const int minRow = std::min((int)((roi.minY + 90.0) / INDEX_CELL_DEGREES), INDEX_ROWS - 1);
+    const int maxRow = std::min((int)((roi.maxY + 90.0) / INDEX_CELL_DEGREES), INDEX_ROWS - 1);
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            const std::vector<std::size_t> &cell = current->cells[row * INDEX_COLUMNS + col];
+            for (auto it = cell.begin(); it != cell.end(); it++) {
+                const Envelope2 &b = current->bounds[*it];
+                if (atakmap::math::Rectangle<double>::intersects(roi.minX, roi.minY, roi.maxX, roi.maxY, b.minX, b.minY, b.maxX, b.maxY))
+                    candidates.push_back(*it);
+            }
+        }
+    }
+
+    // a source spanning several cells is visited once per cell; report each
+    // source once, in attach order
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    for (auto it = candidates.begin(); it != candidates.end(); it++) {
+        code = value.add(current->sources[*it]);
+        TE_CHECKBREAK_CODE(code);
+    }
     TE_CHECKRETURN_CODE(code);
 
-    std::set<std::shared_ptr<ElevationSource>> &s = sources();
-    std::set<std::shared_ptr<ElevationSource>>::iterator it;
-    for (it = s.begin(); it != s.end(); it++) {
+    return code;
+}
+TAKErr TAK::Engine::Elevation::ElevationSourceManager_visitSources(TAKErr(*visitor)(void *opaque, ElevationSource &src) NOTHROWS, void *opaque) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+
+    const std::vector<std::shared_ptr<ElevationSource>> &s = current->sources;
+    for (auto it = s.begin(); it != s.end(); it++) {
         code = visitor(opaque, **it);
         TE_CHECKBREAK_CODE(code);
     }
@@ -154,3 +289,112 @@ TAKErr TAK::Engine::Elevation::ElevationSourceManager_visitSources(TAKErr(*visit
 
     return code;
 }
+
+namespace
+{
+    BoundsMonitor::~BoundsMonitor() NOTHROWS
+    {}
+    TAKErr BoundsMonitor::onContentChanged(const ElevationSource &source) NOTHROWS
+    {
+        // the source may be holding its own lock; read its bounds before
+        // taking the registry lock
+        return updateBounds(source, source.getBounds());
+    }
+
+    std::shared_ptr<const SourceSnapshot> loadSnapshot() NOTHROWS
+    {
+        return std::atomic_load(&snapshot());
+    }
+    TAKErr publishSnapshot(std::vector<std::shared_ptr<ElevationSource>> &&sources, std::vector<Envelope2> &&bounds) NOTHROWS
+    {
+        std::shared_ptr<SourceSnapshot> next(std::make_shared<SourceSnapshot>());
+        next->sources = std::move(sources);
+        next->bounds = std::move(bounds);
+        next->cells.resize(INDEX_COLUMNS * INDEX_ROWS);
+
+        for (std::size_t i = 0u; i < next->bounds.size(); i++) {
+            Envelope2 b(next->bounds[i]);
+            if (!clampBounds(b)) {
+                next->unbounded.push_back(i);
+                continue;
+            }
+            const int minCol = std::min((int)((b.minX + 180.0) / INDEX_CELL_DEGREES), INDEX_COLUMNS - 1);
+            const int maxCol = std::min((int)((b.maxX + 180.0) / INDEX_CELL_DEGREES), INDEX_COLUMNS - 1);
+            const int minRow = std::min((int)((b.minY + 90.0) / INDEX_CELL_DEGREES), INDEX_ROWS - 1);
+            const int maxRow = std::min((int)((b.maxY + 90.0) / INDEX_CELL_DEGREES), INDEX_ROWS - 1);
+            for (int row = minRow; row <= maxRow; row++)
+                for (int col = minCol; col <= maxCol; col++)
+                    next->cells[row * INDEX_COLUMNS + col].push_back(i);
+        }
+
+        std::shared_ptr<const SourceSnapshot> published(next);
+        std::atomic_store(&snapshot(), published);
+        return TE_Ok;
+    }
+    TAKErr updateBounds(const ElevationSource &source, const Envelope2 &bounds) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        Envelope2 update(bounds);
+        while (true) {
+            {
+                Lock lock(mutex());
+                code = lock.status;
+                TE_CHECKRETURN_CODE(code);
+
+                std::shared_ptr<const SourceSnapshot> current(loadSnapshot());
+                const std::size_t idx = indexOf(*current, &source);
+                // the source is being attached or has been detached
+                if (idx == SIZE_MAX)
+                    return TE_Ok;
+                if (equals(current->bounds[idx], update))
+                    return TE_Ok;
+
+                std::vector<std::shared_ptr<ElevationSource>> s(current->sources);
+                std::vector<Envelope2> b(current->bounds);
+                b[idx] = update;
+                code = publishSnapshot(std::move(s), std::move(b));
+                TE_CHECKRETURN_CODE(code);
+            }
+
+            // the bounds were read outside of the lock; a later change may
+            // already have been published and been overwritten. Re-read until
+            // the published bounds are current.
+            update = source.getBounds();
+        }
+    }
+    bool equals(const double a, const double b) NOTHROWS
+    {
+        return (a == b) || (std::isnan(a) && std::isnan(b));
+    }
+    /** compares the bounds, treating NaN as equal to NaN */
+    bool equals(const Envelope2 &a, const Envelope2 &b) NOTHROWS
+    {
+        return equals(a.minX, b.minX) && equals(a.minY, b.minY) && equals(a.minZ, b.minZ) &&
+               equals(a.maxX, b.maxX) && equals(a.maxY, b.maxY) && equals(a.maxZ, b.maxZ);
+    }
+    /**
+     * Clamps the bounds to the valid range of longitude and latitude. Returns
+     * <code>false</code> if the bounds are not usable for indexing, e.g. NaN
+     * or crossing the anti-meridian.
+     */
+    bool clampBounds(Envelope2 &value) NOTHROWS
+    {
+        if (std::isnan(value.minX) || std::isnan(value.minY) || std::isnan(value.maxX) || std::isnan(value.maxY))
+            return false;
+        if (value.minX > value.maxX || value.minY > value.maxY)
+            return false;
+        value.minX = std::max(value.minX, -180.0);
+        value.minY = std::max(value.minY, -90.0);
+        value.maxX = std::min(value.maxX, 180.0);
+        value.maxY = std::min(value.maxY, 90.0);
+        return (value.minX <= value.maxX && value.minY <= value.maxY);
+    }
+    std::size_t indexOf(const SourceSnapshot &snapshot, const ElevationSource *source) NOTHROWS
+    {
+        for (std::size_t i = 0u; i < snapshot.sources.size(); i++) {
+            if (snapshot.sources[i].get() == source)
+                return i;
+        }
+        return SIZE_MAX;
+    }
+}
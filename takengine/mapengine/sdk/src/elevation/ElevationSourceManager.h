@@ -24,6 +24,12 @@ namespace TAK {
             Util::TAKErr ElevationSourceManager_detach(const ElevationSource &source) NOTHROWS;
             Util::TAKErr ElevationSourceManager_findSource(std::shared_ptr<ElevationSource> &value, const char *name) NOTHROWS;
             Util::TAKErr ElevationSourceManager_getSources(Port::Collection<std::shared_ptr<ElevationSource>> &value) NOTHROWS;
+            /**
+             * Returns the attached sources whose bounds intersect the specified
+             * region. Sources that do not report usable bounds are always
+             * returned.
+             */
+            Util::TAKErr ElevationSourceManager_getSources(Port::Collection<std::shared_ptr<ElevationSource>> &value, const Feature::Envelope2 &region) NOTHROWS;
             Util::TAKErr ElevationSourceManager_visitSources(Util::TAKErr(*visitor)(void *opaque, ElevationSource &src) NOTHROWS, void *opaque) NOTHROWS;
         }
     }
@@ -21,6 +21,7 @@
 #include "util/MathUtils.h"
 #include "util/Memory.h"
 #include "util/NonHeapAllocatable.h"
+#include "util/Tracing.h"
 
 using namespace TAK::Engine::Feature;
 
@@ -773,6 +774,7 @@ TAKErr FDB::getFeature(FeaturePtr_const &feature, const int64_t fid) NOTHROWS
 TAKErr FDB::queryFeatures(FeatureCursorPtr &result) NOTHROWS
 {
     TAKErr code(TE_Ok);
+    TE_TRACE_SPAN("FDB::queryFeatures");
     Lock lock(mutex_);
     code = lock.status;
     TE_CHECKRETURN_CODE(code);
@@ -831,6 +833,7 @@ TAKErr FDB::queryFeatures(FeatureCursorPtr &result) NOTHROWS
 TAKErr FDB::queryFeatures(FeatureCursorPtr &result, const FeatureQueryParameters &params) NOTHROWS
 {
     TAKErr code(TE_Ok);
+    TE_TRACE_SPAN("FDB::queryFeatures");
     Lock lock(mutex_);
     code = lock.status;
     TE_CHECKRETURN_CODE(code);
@@ -1147,6 +1150,7 @@ TAKErr FDB::queryFeatures(FeatureCursorPtr &result, const FeatureQueryParameters
 TAKErr FDB::queryFeaturesCount(int *value) NOTHROWS
 {
     TAKErr code(TE_Ok);
+    TE_TRACE_SPAN("FDB::queryFeaturesCount");
     Lock lock(mutex_);
     code = lock.status;
     TE_CHECKRETURN_CODE(code);
@@ -1174,6 +1178,7 @@ TAKErr FDB::queryFeaturesCount(int *value) NOTHROWS
 TAKErr FDB::queryFeaturesCount(int *value, const FeatureQueryParameters &params) NOTHROWS
 {
     TAKErr code(TE_Ok);
+    TE_TRACE_SPAN("FDB::queryFeaturesCount");
     Lock lock(mutex_);
     code = lock.status;
     TE_CHECKRETURN_CODE(code);
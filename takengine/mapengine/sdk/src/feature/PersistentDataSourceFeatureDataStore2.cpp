@@ -2910,33 +2910,21 @@ TAKErr PersistentDataSourceFeatureDataStore2::Index::setFeatureSetCatalogId(cons
 /**************************************************************************/
 // CatalogDatabase
 
-TAKErr PersistentDataSourceFeatureDataStore2::Index::validateCatalogNoSync(CatalogCursor &result) NOTHROWS
+TAKErr PersistentDataSourceFeatureDataStore2::Index::prevalidateCatalogRowNoSync(bool *value, CatalogCursor &result) NOTHROWS
 {
-    TAKErr code(TE_Ok);
-
-    // validate catalog table
-    code = CatalogDatabase2::validateCatalogNoSync(result);
-    TE_CHECKRETURN_CODE(code);
-
-    // check for any content in the featuresets table that may be present but
-    // somehow orphaned
-    code = this->onCatalogEntryRemoved(-1, false);
+    TAKErr code;
+    int syncVersion;
+    code = result.getSyncVersion(&syncVersion);
     TE_CHECKRETURN_CODE(code);
-
+    *value = (syncVersion != 0);
     return code;
 }
 
-TAKErr PersistentDataSourceFeatureDataStore2::Index::validateCatalogRowNoSync(bool *value, CatalogCursor &result) NOTHROWS
+TAKErr PersistentDataSourceFeatureDataStore2::Index::onCatalogValidated() NOTHROWS
 {
-    TAKErr code;
-    int syncVersion;
-    code = result.getSyncVersion(&syncVersion);
-    TE_CHECKRETURN_CODE(code);
-    if (syncVersion == 0) {
-        *value = false;
-        return TE_Ok;
-    }
-    return CatalogDatabase2::validateCatalogRowNoSync(value, result);
+    // check for any content in the featuresets table that may be present but
+    // somehow orphaned
+    return this->onCatalogEntryRemoved(-1, false);
 }
 
 
@@ -191,8 +191,8 @@ namespace TAK {
                 /**************************************************************************/
                 // CatalogDatabase
             protected :
-                virtual Util::TAKErr validateCatalogNoSync(CatalogCursor &result) NOTHROWS;
-                virtual Util::TAKErr validateCatalogRowNoSync(bool *value, CatalogCursor &result) NOTHROWS;
+                virtual Util::TAKErr prevalidateCatalogRowNoSync(bool *value, CatalogCursor &result) NOTHROWS;
+                virtual Util::TAKErr onCatalogValidated() NOTHROWS;
                 virtual Util::TAKErr checkDatabaseVersion(bool *value) NOTHROWS;
                 virtual Util::TAKErr setDatabaseVersion() NOTHROWS;
                 virtual Util::TAKErr dropTables() NOTHROWS;
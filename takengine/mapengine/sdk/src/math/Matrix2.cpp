@@ -1,8 +1,28 @@
 #include "math/Matrix2.h"
 
 #include <cmath>
+#include <cstring>
 #include "util/Error.h"
 
+// Define TE_MATRIX2_NO_SIMD to force the scalar kernels. Every SIMD kernel
+// performs the same IEEE operations in the same order as its scalar
+// counterpart, so results are bit-identical either way (provided the compiler
+// is not permitted to contract the scalar code into fused multiply-adds).
+#if !defined(TE_MATRIX2_NO_SIMD)
+#if defined(__AVX__)
+#define TE_MATRIX2_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TE_MATRIX2_SSE2 1
+#endif
+#endif
+
+#if defined(TE_MATRIX2_AVX)
+#include <immintrin.h>
+#elif defined(TE_MATRIX2_SSE2)
+#include <emmintrin.h>
+#endif
+
 using namespace TAK::Engine::Util;
 using namespace TAK::Engine::Math;
 
@@ -26,139 +46,98 @@ namespace // unnamed namespace
 
     bool isEquivalentToZero(const double n);
 
+    // 4x4 kernels over column-major arrays; see Matrix2::mx
+
+    /** r = a * b. 'r' may be the same array as 'a' or 'b'. */
+    void multiply4x4(double *r, const double *a, const double *b) NOTHROWS;
+    /** 'r' may be the same array as 'a'. Returns false if 'a' is singular. */
+    bool invert4x4(double *r, const double *a) NOTHROWS;
+    /** Returns false, leaving 'dst' unmodified, if w == 0 */
+    bool transform4x4(double *dstX, double *dstY, double *dstZ, const double *m, const double x, const double y, const double z) NOTHROWS;
+    /** Transforms points [off, off+count). Returns false if any had w == 0. */
+    bool transformSoA4x4(double *dstX, double *dstY, double *dstZ, const double *m, const double *srcX, const double *srcY, const double *srcZ, const size_t off, const size_t count) NOTHROWS;
+
 } // end unnamed namespace
 
 
-Matrix2::Matrix2() NOTHROWS :
-    m00(1), m01(0), m02(0), m03(0),
-    m10(0), m11(1), m12(0), m13(0),
-    m20(0), m21(0), m22(1), m23(0),
-    m30(0), m31(0), m32(0), m33(1)
-{}
+Matrix2::Matrix2() NOTHROWS
+{
+    setToIdentity();
+}
 
 Matrix2::Matrix2(double mx00, double mx01, double mx02, double mx03,
     double mx10, double mx11, double mx12, double mx13,
     double mx20, double mx21, double mx22, double mx23,
-    double mx30, double mx31, double mx32, double mx33) NOTHROWS :
-
-    m00(mx00), m01(mx01), m02(mx02), m03(mx03),
-    m10(mx10), m11(mx11), m12(mx12), m13(mx13),
-    m20(mx20), m21(mx21), m22(mx22), m23(mx23),
-    m30(mx30), m31(mx31), m32(mx32), m33(mx33)
-{}
+    double mx30, double mx31, double mx32, double mx33) NOTHROWS
+{
+    mx[0] = mx00; mx[4] = mx01; mx[8] = mx02;  mx[12] = mx03;
+    mx[1] = mx10; mx[5] = mx11; mx[9] = mx12;  mx[13] = mx13;
+    mx[2] = mx20; mx[6] = mx21; mx[10] = mx22; mx[14] = mx23;
+    mx[3] = mx30; mx[7] = mx31; mx[11] = mx32; mx[15] = mx33;
+}
 
 Matrix2::~Matrix2() NOTHROWS
 {}
 
 TAKErr Matrix2::transform(Point2<double> *dst, const Point2<double> &src) const NOTHROWS
 {
-    const double dstX = src.x * m00 + src.y * m01 + src.z * m02 + m03;
-    const double dstY = src.x * m10 + src.y * m11 + src.z * m12 + m13;
-    const double dstZ = src.x * m20 + src.y * m21 + src.z * m22 + m23;
-    const double dstW = src.x * m30 + src.y * m31 + src.z * m32 + m33;
-    if (dstW == 0)
+    if (!transform4x4(&dst->x, &dst->y, &dst->z, mx, src.x, src.y, src.z))
         return TE_Err;
-
-    dst->x = (dstX / dstW);
-    dst->y = (dstY / dstW);
-    dst->z = (dstZ / dstW);
     return TE_Ok;
 }
 
-TAKErr Matrix2::createInverse(Matrix2 *t) const NOTHROWS//const throw (NonInvertibleTransformException)
-{
-    const double determinant = (m00*m11*m22*m33) + (m00*m12*m23*m31) + (m00*m13*m21*m32)
-        + (m01*m10*m23*m32) + (m01*m12*m20*m33) + (m01*m13*m22*m30)
-        + (m02*m10*m21*m33) + (m02*m11*m23*m30) + (m02*m13*m20*m31)
-        + (m03*m10*m22*m31) + (m03*m11*m20*m32) + (m03*m12*m21*m30)
-        - (m00*m11*m23*m32) - (m00*m12*m21*m33) - (m00*m13*m22*m31)
-        - (m01*m10*m22*m33) - (m01*m12*m23*m30) - (m01*m13*m20*m32)
-        - (m02*m10*m23*m31) - (m02*m11*m20*m33) - (m02*m13*m21*m30)
-        - (m03*m10*m21*m32) - (m03*m11*m22*m30) - (m03*m12*m20*m31);
-
-    if (determinant == 0.0)
-        return TAKErr::TE_Err;
-       // throw NonInvertibleTransformException(
-       //     "The determinant for the transform is 0.");
-
-    const double recipDet = 1.0 / determinant;
-
-    t->m00 = recipDet * ((m11*m22*m33) + (m12*m23*m31) + (m13*m21*m32) - (m11*m23*m32) - (m12*m21*m33) - (m13*m22*m31));
-    t->m01 = recipDet * ((m01*m23*m32) + (m02*m21*m33) + (m03*m22*m31) - (m01*m22*m33) - (m02*m23*m31) - (m03*m21*m32));
-    t->m02 = recipDet * ((m01*m12*m33) + (m02*m13*m31) + (m03*m11*m32) - (m01*m13*m32) - (m02*m11*m33) - (m03*m12*m31));
-    t->m03 = recipDet * ((m01*m13*m22) + (m02*m11*m23) + (m03*m12*m21) - (m01*m12*m23) - (m02*m13*m21) - (m03*m11*m22));
-    t->m10 = recipDet * ((m10*m23*m32) + (m12*m20*m33) + (m13*m22*m30) - (m10*m22*m33) - (m12*m23*m30) - (m13*m20*m32));
-    t->m11 = recipDet * ((m00*m22*m33) + (m02*m23*m30) + (m03*m20*m32) - (m00*m23*m32) - (m02*m20*m33) - (m03*m22*m30));
-    t->m12 = recipDet * ((m00*m13*m32) + (m02*m10*m33) + (m03*m12*m30) - (m00*m12*m33) - (m02*m13*m30) - (m03*m10*m32));
-    t->m13 = recipDet * ((m00*m12*m23) + (m02*m13*m20) + (m03*m10*m22) - (m00*m13*m22) - (m02*m10*m23) - (m03*m12*m20));
-    t->m20 = recipDet * ((m10*m21*m33) + (m11*m23*m30) + (m13*m20*m31) - (m10*m23*m31) - (m11*m20*m33) - (m13*m21*m30));
-    t->m21 = recipDet * ((m00*m23*m31) + (m01*m20*m33) + (m03*m21*m30) - (m00*m21*m33) - (m01*m23*m30) - (m03*m20*m31));
-    t->m22 = recipDet * ((m00*m11*m33) + (m01*m13*m30) + (m03*m10*m31) - (m00*m13*m31) - (m01*m10*m33) - (m03*m11*m30));
-    t->m23 = recipDet * ((m00*m13*m21) + (m01*m10*m23) + (m03*m11*m20) - (m00*m11*m23) - (m01*m13*m20) - (m03*m10*m21));
-    t->m30 = recipDet * ((m10*m22*m31) + (m11*m20*m32) + (m12*m21*m30) - (m10*m21*m32) - (m11*m22*m30) - (m12*m20*m31));
-    t->m31 = recipDet * ((m00*m21*m32) + (m01*m22*m30) + (m02*m20*m31) - (m00*m22*m31) - (m01*m20*m32) - (m02*m21*m30));
-    t->m32 = recipDet * ((m00*m12*m31) + (m01*m10*m32) + (m02*m11*m30) - (m00*m11*m32) - (m01*m12*m30) - (m02*m10*m31));
-    t->m33 = recipDet * ((m00*m11*m22) + (m01*m12*m20) + (m02*m10*m21) - (m00*m12*m21) - (m01*m10*m22) - (m02*m11*m20));
-    return TAKErr::TE_Ok;
+TAKErr Matrix2::transform(Point2<double> *dst, const Point2<double> *src, const size_t count) const NOTHROWS
+{
+    if (!count)
+        return TE_Ok;
+    if (!dst || !src)
+        return TE_InvalidArg;
+
+    bool ok = true;
+    for (size_t i = 0u; i < count; i++)
+        ok &= transform4x4(&dst[i].x, &dst[i].y, &dst[i].z, mx, src[i].x, src[i].y, src[i].z);
+    return ok ? TE_Ok : TE_Err;
+}
+
+TAKErr Matrix2::transform(double *dstX, double *dstY, double *dstZ, const double *srcX, const double *srcY, const double *srcZ, const size_t count) const NOTHROWS
+{
+    if (!count)
+        return TE_Ok;
+    if (!dstX || !dstY || !srcX || !srcY)
+        return TE_InvalidArg;
+
+    return transformSoA4x4(dstX, dstY, dstZ, mx, srcX, srcY, srcZ, 0u, count) ? TE_Ok : TE_Err;
+}
+
+TAKErr Matrix2::createInverse(Matrix2 *t) const NOTHROWS
+{
+    if (!invert4x4(t->mx, mx))
+        return TE_Err;
+    return TE_Ok;
 }
 
 void Matrix2::concatenate(const Matrix2 &t) NOTHROWS
 {
-    concatenateImpl(t.m00, t.m01, t.m02, t.m03,
-        t.m10, t.m11, t.m12, t.m13,
-        t.m20, t.m21, t.m22, t.m23,
-        t.m30, t.m31, t.m32, t.m33);
+    multiply4x4(mx, mx, t.mx);
 }
 
 void Matrix2::preConcatenate(const Matrix2 &t) NOTHROWS
 {
-    Matrix2 tCopy(t);
-    tCopy.concatenate(*this);
-    set(tCopy);
+    multiply4x4(mx, t.mx, mx);
 }
 
 void Matrix2::set(const Matrix2 &t) NOTHROWS
 {
-    m00 = t.m00;
-    m01 = t.m01;
-    m02 = t.m02;
-    m03 = t.m03;
-    m10 = t.m10;
-    m11 = t.m11;
-    m12 = t.m12;
-    m13 = t.m13;
-    m20 = t.m20;
-    m21 = t.m21;
-    m22 = t.m22;
-    m23 = t.m23;
-    m30 = t.m30;
-    m31 = t.m31;
-    m32 = t.m32;
-    m33 = t.m33;
+    memcpy(mx, t.mx, sizeof(mx));
 }
 
 TAKErr Matrix2::set(const size_t row, const size_t col, const double v) NOTHROWS
 {
-    switch ((row * 4) + col) {
-    case 0:  m00 = v; break;
-    case 1:  m01 = v; break;
-    case 2:  m02 = v; break;
-    case 3:  m03 = v; break;
-    case 4:  m10 = v; break;
-    case 5:  m11 = v; break;
-    case 6:  m12 = v; break;
-    case 7:  m13 = v; break;
-    case 8:  m20 = v; break;
-    case 9:  m21 = v; break;
-    case 10: m22 = v; break;
-    case 11: m23 = v; break;
-    case 12: m30 = v; break;
-    case 13: m31 = v; break;
-    case 14: m32 = v; break;
-    case 15: m33 = v; break;
-    default: return TAKErr::TE_Err;
-    }
-    return TAKErr::TE_Ok;
+    const size_t idx = (row * 4) + col;
+    if (idx > 15u)
+        return TE_Err;
+    mx[(idx % 4) * 4 + (idx / 4)] = v;
+    return TE_Ok;
 }
 
 TAKErr Matrix2::get(double *matrix, const MatrixOrder order) const NOTHROWS
@@ -167,69 +146,29 @@ TAKErr Matrix2::get(double *matrix, const MatrixOrder order) const NOTHROWS
         return TE_InvalidArg;
     switch (order) {
     case ROW_MAJOR:
-        matrix[0] = m00;
-        matrix[1] = m01;
-        matrix[2] = m02;
-        matrix[3] = m03;
-        matrix[4] = m10;
-        matrix[5] = m11;
-        matrix[6] = m12;
-        matrix[7] = m13;
-        matrix[8] = m20;
-        matrix[9] = m21;
-        matrix[10] = m22;
-        matrix[11] = m23;
-        matrix[12] = m30;
-        matrix[13] = m31;
-        matrix[14] = m32;
-        matrix[15] = m33;
+        for (size_t row = 0u; row < 4u; row++) {
+            matrix[row * 4] = mx[row];
+            matrix[row * 4 + 1] = mx[4 + row];
+            matrix[row * 4 + 2] = mx[8 + row];
+            matrix[row * 4 + 3] = mx[12 + row];
+        }
         break;
     case COLUMN_MAJOR:
-        matrix[0] = m00;
-        matrix[1] = m10;
-        matrix[2] = m20;
-        matrix[3] = m30;
-        matrix[4] = m01;
-        matrix[5] = m11;
-        matrix[6] = m21;
-        matrix[7] = m31;
-        matrix[8] = m02;
-        matrix[9] = m12;
-        matrix[10] = m22;
-        matrix[11] = m32;
-        matrix[12] = m03;
-        matrix[13] = m13;
-        matrix[14] = m23;
-        matrix[15] = m33;
+        memcpy(matrix, mx, sizeof(mx));
         break;
     default:
-       return TAKErr::TE_InvalidArg;
+       return TE_InvalidArg;
     }
-    return TAKErr::TE_Ok;
+    return TE_Ok;
 }
 
 TAKErr Matrix2::get(double *v, const size_t row, const size_t col) const NOTHROWS
 {
-    switch ((row * 4) + col) {
-    case 0:  *v = m00; break;
-    case 1:  *v = m01; break;
-    case 2:  *v = m02; break;
-    case 3:  *v = m03; break;
-    case 4:  *v = m10; break;
-    case 5:  *v = m11; break;
-    case 6:  *v = m12; break;
-    case 7:  *v = m13; break;
-    case 8:  *v = m20; break;
-    case 9:  *v = m21; break;
-    case 10: *v = m22; break;
-    case 11: *v = m23; break;
-    case 12: *v = m30; break;
-    case 13: *v = m31; break;
-    case 14: *v = m32; break;
-    case 15: *v = m33; break;
-    default: return TAKErr::TE_Err;
-    }
-    return TAKErr::TE_Ok;
+    const size_t idx = (row * 4) + col;
+    if (idx > 15u)
+        return TE_Err;
+    *v = mx[(idx % 4) * 4 + (idx / 4)];
+    return TE_Ok;
 }
 
 void Matrix2::translate(const double tx, const double ty, const double tz) NOTHROWS
@@ -257,25 +196,11 @@ TAKErr Matrix2::rotate(const double theta, const double anchorx, const double an
 
 TAKErr Matrix2::rotate(const double theta, const double axisX, const double axisY, const double axisZ) NOTHROWS
 {
-    const double sinTheta = sin(theta);
-    const double cosTheta = cos(theta);
-
-    const double mag = sqrt((axisX*axisX) + (axisY*axisY) + (axisZ*axisZ));
-
-    if (mag == 0)
-        return TE_Err;
-
-    const double nX = axisX / mag;
-    const double nY = axisY / mag;
-    const double nZ = axisZ / mag;
-
-    const double oneMinusCos = 1 - cosTheta;
-
-    concatenateImpl(nX*nX*(oneMinusCos)+cosTheta, nY*nX*(oneMinusCos)-axisZ*sinTheta, nZ*nX*(oneMinusCos)+axisY*sinTheta, 0,
-        nX*nY*(oneMinusCos)+axisZ*sinTheta, nY*nY*(oneMinusCos)+cosTheta, nZ*nY*(oneMinusCos)-axisX*sinTheta, 0,
-        nX*nZ*(oneMinusCos)-axisY*sinTheta, nY*nZ*(oneMinusCos)+axisX*sinTheta, nZ*nZ*(oneMinusCos)+cosTheta, 0,
-        0, 0, 0, 1);
-    return TE_Ok;
+    Matrix2 r;
+    TAKErr code = r.setToRotate(theta, axisX, axisY, axisZ);
+    TE_CHECKRETURN_CODE(code);
+    concatenate(r);
+    return code;
 }
 
 TAKErr Matrix2::rotate(const double theta, const double anchorX, const double anchorY, const double anchorZ, const double axisX, const double axisY, const double axisZ) NOTHROWS
@@ -304,18 +229,22 @@ void Matrix2::scale(const double scaleX, const double scaleY, const double scale
 
 void Matrix2::setToIdentity() NOTHROWS
 {
-    m00 = 1; m01 = 0; m02 = 0; m03 = 0;
-    m10 = 0; m11 = 1; m12 = 0; m13 = 0;
-    m20 = 0; m21 = 0; m22 = 1; m23 = 0;
-    m30 = 0; m31 = 0; m32 = 0; m33 = 1;
+    static const double identity[16] =
+    {
+        1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1,
+    };
+    memcpy(mx, identity, sizeof(mx));
 }
 
 void Matrix2::setToTranslate(const double tx, const double ty, const double tz) NOTHROWS
 {
-    m00 = 1; m01 = 0; m02 = 0; m03 = tx;
-    m10 = 0; m11 = 1; m12 = 0; m13 = ty;
-    m20 = 0; m21 = 0; m22 = 1; m23 = tz;
-    m30 = 0; m31 = 0; m32 = 0; m33 = 1;
+    setToIdentity();
+    mx[12] = tx;
+    mx[13] = ty;
+    mx[14] = tz;
 }
 
 TAKErr Matrix2::setToRotate(const double theta) NOTHROWS
@@ -339,22 +268,26 @@ TAKErr Matrix2::setToRotate(const double theta, const double axisX, const double
 
     const double oneMinusCos = 1 - cosTheta;
 
-    m00 = nX*nX*(oneMinusCos)+cosTheta;
-    m01 = nY*nX*(oneMinusCos)-axisZ*sinTheta;
-    m02 = nZ*nX*(oneMinusCos)+axisY*sinTheta;
-    m03 = 0;
-    m10 = nX*nY*(oneMinusCos)+axisZ*sinTheta;
-    m11 = nY*nY*(oneMinusCos)+cosTheta;
-    m12 = nZ*nY*(oneMinusCos)-axisX*sinTheta;
-    m13 = 0;
-    m20 = nX*nZ*(oneMinusCos)-axisY*sinTheta;
-    m21 = nY*nZ*(oneMinusCos)+axisX*sinTheta;
-    m22 = nZ*nZ*(oneMinusCos)+cosTheta;
-    m23 = 0;
-    m30 = 0;
-    m31 = 0;
-    m32 = 0;
-    m33 = 1;
+    // column 0
+    mx[0] = nX*nX*(oneMinusCos)+cosTheta;
+    mx[1] = nX*nY*(oneMinusCos)+axisZ*sinTheta;
+    mx[2] = nX*nZ*(oneMinusCos)-axisY*sinTheta;
+    mx[3] = 0;
+    // column 1
+    mx[4] = nY*nX*(oneMinusCos)-axisZ*sinTheta;
+    mx[5] = nY*nY*(oneMinusCos)+cosTheta;
+    mx[6] = nY*nZ*(oneMinusCos)+axisX*sinTheta;
+    mx[7] = 0;
+    // column 2
+    mx[8] = nZ*nX*(oneMinusCos)+axisY*sinTheta;
+    mx[9] = nZ*nY*(oneMinusCos)-axisX*sinTheta;
+    mx[10] = nZ*nZ*(oneMinusCos)+cosTheta;
+    mx[11] = 0;
+    // column 3
+    mx[12] = 0;
+    mx[13] = 0;
+    mx[14] = 0;
+    mx[15] = 1;
     return TE_Ok;
 }
 
@@ -375,42 +308,18 @@ void Matrix2::setToScale(const double scale) NOTHROWS
 
 void Matrix2::setToScale(const double scaleX, const double scaleY, const double scaleZ) NOTHROWS
 {
-    m00 = scaleX;
-    m01 = 0;
-    m02 = 0;
-    m03 = 0;
-    m10 = 0;
-    m11 = scaleY;
-    m12 = 0;
-    m13 = 0;
-    m20 = 0;
-    m21 = 0;
-    m22 = scaleZ;
-    m23 = 0;
-    m30 = 0;
-    m31 = 0;
-    m32 = 0;
-    m33 = 1;
+    setToIdentity();
+    mx[0] = scaleX;
+    mx[5] = scaleY;
+    mx[10] = scaleZ;
 }
 
 bool Matrix2::operator==(const Matrix2 &other) const NOTHROWS
 {
-    return this->m00 == other.m00 &&
-           this->m01 == other.m01 &&
-           this->m02 == other.m02 &&
-           this->m03 == other.m03 &&
-           this->m10 == other.m10 &&
-           this->m11 == other.m11 &&
-           this->m12 == other.m12 &&
-           this->m13 == other.m13 &&
-           this->m20 == other.m20 &&
-           this->m21 == other.m21 &&
-           this->m22 == other.m22 &&
-           this->m23 == other.m23 &&
-           this->m30 == other.m30 &&
-           this->m31 == other.m31 &&
-           this->m32 == other.m32 &&
-           this->m33 == other.m33;
+    for (size_t i = 0u; i < 16u; i++)
+        if (this->mx[i] != other.mx[i])
+            return false;
+    return true;
 }
 
 void Matrix2::concatenateImpl(const double tm00, const double tm01, const double tm02, const double tm03,
@@ -418,39 +327,11 @@ void Matrix2::concatenateImpl(const double tm00, const double tm01, const double
     const double tm20, const double tm21, const double tm22, const double tm23,
     const double tm30, const double tm31, const double tm32, const double tm33) NOTHROWS
 {
-    const double rm00 = m00*tm00 + m01*tm10 + m02*tm20 + m03*tm30;
-    const double rm01 = m00*tm01 + m01*tm11 + m02*tm21 + m03*tm31;
-    const double rm02 = m00*tm02 + m01*tm12 + m02*tm22 + m03*tm32;
-    const double rm03 = m00*tm03 + m01*tm13 + m02*tm23 + m03*tm33;
-    const double rm10 = m10*tm00 + m11*tm10 + m12*tm20 + m13*tm30;
-    const double rm11 = m10*tm01 + m11*tm11 + m12*tm21 + m13*tm31;
-    const double rm12 = m10*tm02 + m11*tm12 + m12*tm22 + m13*tm32;
-    const double rm13 = m10*tm03 + m11*tm13 + m12*tm23 + m13*tm33;
-    const double rm20 = m20*tm00 + m21*tm10 + m22*tm20 + m23*tm30;
-    const double rm21 = m20*tm01 + m21*tm11 + m22*tm21 + m23*tm31;
-    const double rm22 = m20*tm02 + m21*tm12 + m22*tm22 + m23*tm32;
-    const double rm23 = m20*tm03 + m21*tm13 + m22*tm23 + m23*tm33;
-    const double rm30 = m30*tm00 + m31*tm10 + m32*tm20 + m33*tm30;
-    const double rm31 = m30*tm01 + m31*tm11 + m32*tm21 + m33*tm31;
-    const double rm32 = m30*tm02 + m31*tm12 + m32*tm22 + m33*tm32;
-    const double rm33 = m30*tm03 + m31*tm13 + m32*tm23 + m33*tm33;
-
-    m00 = rm00;
-    m01 = rm01;
-    m02 = rm02;
-    m03 = rm03;
-    m10 = rm10;
-    m11 = rm11;
-    m12 = rm12;
-    m13 = rm13;
-    m20 = rm20;
-    m21 = rm21;
-    m22 = rm22;
-    m23 = rm23;
-    m30 = rm30;
-    m31 = rm31;
-    m32 = rm32;
-    m33 = rm33;
+    const Matrix2 t(tm00, tm01, tm02, tm03,
+        tm10, tm11, tm12, tm13,
+        tm20, tm21, tm22, tm23,
+        tm30, tm31, tm32, tm33);
+    multiply4x4(mx, mx, t.mx);
 }
 
 TAKErr TAK::Engine::Math::Matrix2_mapQuads(Matrix2 *xform, const Point2<double> &src1, const Point2<double> &src2, const Point2<double> &src3, const Point2<double> &src4,
@@ -688,4 +569,261 @@ namespace // unnamed namespace
         return ((n < 1e-13) && (n > -1e-13));
     }
 
+    void multiply4x4(double *r, const double *a, const double *b) NOTHROWS
+    {
+        // column j of r is the columns of a weighted by column j of b. All
+        // of a is loaded up front and column j of b is consumed before
+        // column j of r is written, so r may alias either input
+#if defined(TE_MATRIX2_AVX)
+        const __m256d a0 = _mm256_loadu_pd(a);
+        const __m256d a1 = _mm256_loadu_pd(a + 4);
+        const __m256d a2 = _mm256_loadu_pd(a + 8);
+        const __m256d a3 = _mm256_loadu_pd(a + 12);
+        for (size_t j = 0u; j < 16u; j += 4u) {
+            __m256d c = _mm256_mul_pd(a0, _mm256_set1_pd(b[j]));
+            c = _mm256_add_pd(c, _mm256_mul_pd(a1, _mm256_set1_pd(b[j + 1])));
+            c = _mm256_add_pd(c, _mm256_mul_pd(a2, _mm256_set1_pd(b[j + 2])));
+            c = _mm256_add_pd(c, _mm256_mul_pd(a3, _mm256_set1_pd(b[j + 3])));
+            _mm256_storeu_pd(r + j, c);
+        }
+#elif defined(TE_MATRIX2_SSE2)
+        const __m128d a0l = _mm_loadu_pd(a);
+        const __m128d a0h = _mm_loadu_pd(a + 2);
+        const __m128d a1l = _mm_loadu_pd(a + 4);
+        const __m128d a1h = _mm_loadu_pd(a + 6);
+        const __m128d a2l = _mm_loadu_pd(a + 8);
+        const __m128d a2h = _mm_loadu_pd(a + 10);
+        const __m128d a3l = _mm_loadu_pd(a + 12);
+        const __m128d a3h = _mm_loadu_pd(a + 14);
+        for (size_t j = 0u; j < 16u; j += 4u) {
+            const __m128d b0 = _mm_set1_pd(b[j]);
+            const __m128d b1 = _mm_set1_pd(b[j + 1]);
+            const __m128d b2 = _mm_set1_pd(b[j + 2]);
+            const __m128d b3 = _mm_set1_pd(b[j + 3]);
+            __m128d cl = _mm_mul_pd(a0l, b0);
+            __m128d ch = _mm_mul_pd(a0h, b0);
+            cl = _mm_add_pd(cl, _mm_mul_pd(a1l, b1));
+            ch = _mm_add_pd(ch, _mm_mul_pd(a1h, b1));
+            cl = _mm_add_pd(cl, _mm_mul_pd(a2l, b2));
+            ch = _mm_add_pd(ch, _mm_mul_pd(a2h, b2));
+            cl = _mm_add_pd(cl, _mm_mul_pd(a3l, b3));
+            ch = _mm_add_pd(ch, _mm_mul_pd(a3h, b3));
+            _mm_storeu_pd(r + j, cl);
+            _mm_storeu_pd(r + j + 2, ch);
+        }
+#else
+        double t[16];
+        for (size_t j = 0u; j < 16u; j += 4u) {
+            for (size_t i = 0u; i < 4u; i++)
+                t[j + i] = a[i] * b[j] + a[4 + i] * b[j + 1] + a[8 + i] * b[j + 2] + a[12 + i] * b[j + 3];
+        }
+        memcpy(r, t, sizeof(t));
+#endif
+    }
+
+#if !defined(TE_MATRIX2_SSE2)
+    inline double cofactor(const double p, const double q, const double r, const double x, const double y, const double z) NOTHROWS
+    {
+        return (p*x - q*y) + r*z;
+    }
+#else
+    inline __m128d cofactor(const __m128d p, const __m128d q, const __m128d r, const double x, const double y, const double z) NOTHROWS
+    {
+        return _mm_add_pd(_mm_sub_pd(_mm_mul_pd(p, _mm_set1_pd(x)), _mm_mul_pd(q, _mm_set1_pd(y))), _mm_mul_pd(r, _mm_set1_pd(z)));
+    }
+#endif
+
+    bool invert4x4(double *r, const double *a) NOTHROWS
+    {
+        // Adjugate from the 2x2 minors of the top and bottom row pairs. Written
+        // as if 'a' were row-major; since inverse(transpose(A)) equals
+        // transpose(inverse(A)) this is equally correct for column-major.
+        const double s0 = a[0]*a[5] - a[4]*a[1];
+        const double s1 = a[0]*a[6] - a[4]*a[2];
+        const double s2 = a[0]*a[7] - a[4]*a[3];
+        const double s3 = a[1]*a[6] - a[5]*a[2];
+        const double s4 = a[1]*a[7] - a[5]*a[3];
+        const double s5 = a[2]*a[7] - a[6]*a[3];
+        const double c5 = a[10]*a[15] - a[14]*a[11];
+        const double c4 = a[9]*a[15] - a[13]*a[11];
+        const double c3 = a[9]*a[14] - a[13]*a[10];
+        const double c2 = a[8]*a[15] - a[12]*a[11];
+        const double c1 = a[8]*a[14] - a[12]*a[10];
+        const double c0 = a[8]*a[13] - a[12]*a[9];
+
+        const double det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+        if (det == 0.0)
+            return false;
+        const double invDet = 1.0 / det;
+
+#if defined(TE_MATRIX2_SSE2)
+        // lane pairs (a[4+k], a[k]) and (a[12+k], a[8+k])
+        const __m128d r0l = _mm_loadu_pd(a);
+        const __m128d r0h = _mm_loadu_pd(a + 2);
+        const __m128d r1l = _mm_loadu_pd(a + 4);
+        const __m128d r1h = _mm_loadu_pd(a + 6);
+        const __m128d r2l = _mm_loadu_pd(a + 8);
+        const __m128d r2h = _mm_loadu_pd(a + 10);
+        const __m128d r3l = _mm_loadu_pd(a + 12);
+        const __m128d r3h = _mm_loadu_pd(a + 14);
+        const __m128d l0 = _mm_unpacklo_pd(r1l, r0l);
+        const __m128d l1 = _mm_unpackhi_pd(r1l, r0l);
+        const __m128d l2 = _mm_unpacklo_pd(r1h, r0h);
+        const __m128d l3 = _mm_unpackhi_pd(r1h, r0h);
+        const __m128d h0 = _mm_unpacklo_pd(r3l, r2l);
+        const __m128d h1 = _mm_unpackhi_pd(r3l, r2l);
+        const __m128d h2 = _mm_unpacklo_pd(r3h, r2h);
+        const __m128d h3 = _mm_unpackhi_pd(r3h, r2h);
+
+        const __m128d negHi = _mm_set_pd(-0.0, 0.0);
+        const __m128d negLo = _mm_set_pd(0.0, -0.0);
+        const __m128d vInvDet = _mm_set1_pd(invDet);
+        _mm_storeu_pd(r, _mm_mul_pd(_mm_xor_pd(cofactor(l1, l2, l3, c5, c4, c3), negHi), vInvDet));
+        _mm_storeu_pd(r + 2, _mm_mul_pd(_mm_xor_pd(cofactor(h1, h2, h3, s5, s4, s3), negHi), vInvDet));
+        _mm_storeu_pd(r + 4, _mm_mul_pd(_mm_xor_pd(cofactor(l0, l2, l3, c5, c2, c1), negLo), vInvDet));
+        _mm_storeu_pd(r + 6, _mm_mul_pd(_mm_xor_pd(cofactor(h0, h2, h3, s5, s2, s1), negLo), vInvDet));
+        _mm_storeu_pd(r + 8, _mm_mul_pd(_mm_xor_pd(cofactor(l0, l1, l3, c4, c2, c0), negHi), vInvDet));
+        _mm_storeu_pd(r + 10, _mm_mul_pd(_mm_xor_pd(cofactor(h0, h1, h3, s4, s2, s0), negHi), vInvDet));
+        _mm_storeu_pd(r + 12, _mm_mul_pd(_mm_xor_pd(cofactor(l0, l1, l2, c3, c1, c0), negLo), vInvDet));
+        _mm_storeu_pd(r + 14, _mm_mul_pd(_mm_xor_pd(cofactor(h0, h1, h2, s3, s1, s0), negLo), vInvDet));
+#else
+        double t[16];
+        t[0] = cofactor(a[5], a[6], a[7], c5, c4, c3) * invDet;
+        t[1] = -cofactor(a[1], a[2], a[3], c5, c4, c3) * invDet;
+        t[2] = cofactor(a[13], a[14], a[15], s5, s4, s3) * invDet;
+        t[3] = -cofactor(a[9], a[10], a[11], s5, s4, s3) * invDet;
+        t[4] = -cofactor(a[4], a[6], a[7], c5, c2, c1) * invDet;
+        t[5] = cofactor(a[0], a[2], a[3], c5, c2, c1) * invDet;
+        t[6] = -cofactor(a[12], a[14], a[15], s5, s2, s1) * invDet;
+        t[7] = cofactor(a[8], a[10], a[11], s5, s2, s1) * invDet;
+        t[8] = cofactor(a[4], a[5], a[7], c4, c2, c0) * invDet;
+        t[9] = -cofactor(a[0], a[1], a[3], c4, c2, c0) * invDet;
+        t[10] = cofactor(a[12], a[13], a[15], s4, s2, s0) * invDet;
+        t[11] = -cofactor(a[8], a[9], a[11], s4, s2, s0) * invDet;
+        t[12] = -cofactor(a[4], a[5], a[6], c3, c1, c0) * invDet;
+        t[13] = cofactor(a[0], a[1], a[2], c3, c1, c0) * invDet;
+        t[14] = -cofactor(a[12], a[13], a[14], s3, s1, s0) * invDet;
+        t[15] = cofactor(a[8], a[9], a[10], s3, s1, s0) * invDet;
+        memcpy(r, t, sizeof(t));
+#endif
+        return true;
+    }
+
+    bool transform4x4(double *dstX, double *dstY, double *dstZ, const double *m, const double x, const double y, const double z) NOTHROWS
+    {
+#if defined(TE_MATRIX2_AVX)
+        __m256d v = _mm256_mul_pd(_mm256_loadu_pd(m), _mm256_set1_pd(x));
+        v = _mm256_add_pd(v, _mm256_mul_pd(_mm256_loadu_pd(m + 4), _mm256_set1_pd(y)));
+        v = _mm256_add_pd(v, _mm256_mul_pd(_mm256_loadu_pd(m + 8), _mm256_set1_pd(z)));
+        v = _mm256_add_pd(v, _mm256_loadu_pd(m + 12));
+        double xyzw[4];
+        _mm256_storeu_pd(xyzw, v);
+        if (xyzw[3] == 0)
+            return false;
+        _mm256_storeu_pd(xyzw, _mm256_div_pd(v, _mm256_set1_pd(xyzw[3])));
+        *dstX = xyzw[0];
+        *dstY = xyzw[1];
+        *dstZ = xyzw[2];
+#elif defined(TE_MATRIX2_SSE2)
+        const __m128d vx = _mm_set1_pd(x);
+        const __m128d vy = _mm_set1_pd(y);
+        const __m128d vz = _mm_set1_pd(z);
+        __m128d xy = _mm_mul_pd(_mm_loadu_pd(m), vx);
+        __m128d zw = _mm_mul_pd(_mm_loadu_pd(m + 2), vx);
+        xy = _mm_add_pd(xy, _mm_mul_pd(_mm_loadu_pd(m + 4), vy));
+        zw = _mm_add_pd(zw, _mm_mul_pd(_mm_loadu_pd(m + 6), vy));
+        xy = _mm_add_pd(xy, _mm_mul_pd(_mm_loadu_pd(m + 8), vz));
+        zw = _mm_add_pd(zw, _mm_mul_pd(_mm_loadu_pd(m + 10), vz));
+        xy = _mm_add_pd(xy, _mm_loadu_pd(m + 12));
+        zw = _mm_add_pd(zw, _mm_loadu_pd(m + 14));
+        const __m128d w = _mm_unpackhi_pd(zw, zw);
+        if (_mm_cvtsd_f64(w) == 0)
+            return false;
+        xy = _mm_div_pd(xy, w);
+        _mm_storel_pd(dstX, xy);
+        _mm_storeh_pd(dstY, xy);
+        _mm_storel_pd(dstZ, _mm_div_sd(zw, w));
+#else
+        const double dstW = x * m[3] + y * m[7] + z * m[11] + m[15];
+        if (dstW == 0)
+            return false;
+        const double tx = x * m[0] + y * m[4] + z * m[8] + m[12];
+        const double ty = x * m[1] + y * m[5] + z * m[9] + m[13];
+        const double tz = x * m[2] + y * m[6] + z * m[10] + m[14];
+        *dstX = tx / dstW;
+        *dstY = ty / dstW;
+        *dstZ = tz / dstW;
+#endif
+        return true;
+    }
+
+    bool transformSoA4x4(double *dstX, double *dstY, double *dstZ, const double *m, const double *srcX, const double *srcY, const double *srcZ, const size_t off, const size_t count) NOTHROWS
+    {
+        bool ok = true;
+        size_t i = off;
+        const size_t end = off + count;
+#if defined(TE_MATRIX2_AVX) || defined(TE_MATRIX2_SSE2)
+#if defined(TE_MATRIX2_AVX)
+#define TE_MATRIX2_LANES 4u
+        typedef __m256d vec;
+#define TE_MATRIX2_SET1 _mm256_set1_pd
+#define TE_MATRIX2_LOAD _mm256_loadu_pd
+#define TE_MATRIX2_STORE _mm256_storeu_pd
+#define TE_MATRIX2_ADD _mm256_add_pd
+#define TE_MATRIX2_MUL _mm256_mul_pd
+#define TE_MATRIX2_DIV _mm256_div_pd
+#define TE_MATRIX2_ANYZERO(v) _mm256_movemask_pd(_mm256_cmp_pd((v), _mm256_setzero_pd(), _CMP_EQ_OQ))
+#else
+#define TE_MATRIX2_LANES 2u
+        typedef __m128d vec;
+#define TE_MATRIX2_SET1 _mm_set1_pd
+#define TE_MATRIX2_LOAD _mm_loadu_pd
+#define TE_MATRIX2_STORE _mm_storeu_pd
+#define TE_MATRIX2_ADD _mm_add_pd
+#define TE_MATRIX2_MUL _mm_mul_pd
+#define TE_MATRIX2_DIV _mm_div_pd
+#define TE_MATRIX2_ANYZERO(v) _mm_movemask_pd(_mm_cmpeq_pd((v), _mm_setzero_pd()))
+#endif
+        vec e[16];
+        for (size_t k = 0u; k < 16u; k++)
+            e[k] = TE_MATRIX2_SET1(m[k]);
+        const vec zero = TE_MATRIX2_SET1(0.0);
+        for (; i + TE_MATRIX2_LANES <= end; i += TE_MATRIX2_LANES) {
+            const vec x = TE_MATRIX2_LOAD(srcX + i);
+            const vec y = TE_MATRIX2_LOAD(srcY + i);
+            const vec z = srcZ ? TE_MATRIX2_LOAD(srcZ + i) : zero;
+            const vec w = TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_MUL(x, e[3]), TE_MATRIX2_MUL(y, e[7])), TE_MATRIX2_MUL(z, e[11])), e[15]);
+            if (TE_MATRIX2_ANYZERO(w)) {
+                // rare; let the per point path sort out which ones fail
+                for (size_t k = i; k < i + TE_MATRIX2_LANES; k++) {
+                    double scratch;
+                    ok &= transform4x4(dstX + k, dstY + k, dstZ ? dstZ + k : &scratch, m, srcX[k], srcY[k], srcZ ? srcZ[k] : 0.0);
+                }
+                continue;
+            }
+            const vec tx = TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_MUL(x, e[0]), TE_MATRIX2_MUL(y, e[4])), TE_MATRIX2_MUL(z, e[8])), e[12]);
+            const vec ty = TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_MUL(x, e[1]), TE_MATRIX2_MUL(y, e[5])), TE_MATRIX2_MUL(z, e[9])), e[13]);
+            TE_MATRIX2_STORE(dstX + i, TE_MATRIX2_DIV(tx, w));
+            TE_MATRIX2_STORE(dstY + i, TE_MATRIX2_DIV(ty, w));
+            if (dstZ) {
+                const vec tz = TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_ADD(TE_MATRIX2_MUL(x, e[2]), TE_MATRIX2_MUL(y, e[6])), TE_MATRIX2_MUL(z, e[10])), e[14]);
+                TE_MATRIX2_STORE(dstZ + i, TE_MATRIX2_DIV(tz, w));
+            }
+        }
+#undef TE_MATRIX2_LANES
+#undef TE_MATRIX2_SET1
+#undef TE_MATRIX2_LOAD
+#undef TE_MATRIX2_STORE
+#undef TE_MATRIX2_ADD
+#undef TE_MATRIX2_MUL
+#undef TE_MATRIX2_DIV
+#undef TE_MATRIX2_ANYZERO
+#endif
+        for (; i < end; i++) {
+            double scratch;
+            ok &= transform4x4(dstX + i, dstY + i, dstZ ? dstZ + i : &scratch, m, srcX[i], srcY[i], srcZ ? srcZ[i] : 0.0);
+        }
+        return ok;
+    }
+
 }; // end unnamed namespace
@@ -28,6 +28,22 @@ namespace TAK
                 ~Matrix2() NOTHROWS;
             public:
                 TAK::Engine::Util::TAKErr transform(TAK::Engine::Math::Point2<double> *dst, const TAK::Engine::Math::Point2<double> &src) const NOTHROWS;
+                /**
+                 * Transforms 'count' points. 'dst' may be the same array as 'src'.
+                 *
+                 * @return  TE_Ok, or TE_Err if any point transformed to w == 0; such
+                 *          points are left unmodified in 'dst', all others are transformed
+                 */
+                TAK::Engine::Util::TAKErr transform(TAK::Engine::Math::Point2<double> *dst, const TAK::Engine::Math::Point2<double> *src, const size_t count) const NOTHROWS;
+                /**
+                 * Transforms 'count' points stored as separate coordinate arrays. Any
+                 * destination array may be the same as the corresponding source array.
+                 * 'srcZ' may be NULL for z = 0; 'dstZ' may be NULL if z is not wanted.
+                 *
+                 * @return  TE_Ok, or TE_Err if any point transformed to w == 0; such
+                 *          points are left unmodified in the destination arrays
+                 */
+                TAK::Engine::Util::TAKErr transform(double *dstX, double *dstY, double *dstZ, const double *srcX, const double *srcY, const double *srcZ, const size_t count) const NOTHROWS;
                 TAK::Engine::Util::TAKErr createInverse(Matrix2 *t) const NOTHROWS;
                 void concatenate(const Matrix2 &t) NOTHROWS;
                 void preConcatenate(const Matrix2 &t) NOTHROWS;
@@ -64,22 +80,11 @@ namespace TAK
                     const double tm20, const double tm21, const double tm22, const double tm23,
                     const double tm30, const double tm31, const double tm32, const double tm33) NOTHROWS;
             private:
-                double m00;
-                double m01;
-                double m02;
-                double m03;
-                double m10;
-                double m11;
-                double m12;
-                double m13;
-                double m20;
-                double m21;
-                double m22;
-                double m23;
-                double m30;
-                double m31;
-                double m32;
-                double m33;
+                /**
+                 * Elements in column-major order (element at row r, column c is
+                 * mx[c*4+r]) so columns load directly into SIMD registers.
+                 */
+                alignas(16) double mx[16];
             };
 
             typedef std::unique_ptr<Matrix2, void(*)(const Matrix2 *)> Matrix2Ptr;
@@ -0,0 +1,776 @@
+#include "raster/mosaic/ATAKMosaicDatabase3.h"
+
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <sstream>
+#include <vector>
+
+#include "db/BindArgument.h"
+#include "db/Query.h"
+#include "db/WhereClauseBuilder2.h"
+#include "feature/Envelope2.h"
+#include "feature/GeometryFactory.h"
+#include "feature/Polygon2.h"
+#include "port/STLListAdapter.h"
+#include "port/STLVectorAdapter.h"
+#include "raster/mosaic/MultiplexingMosaicDatabaseCursor2.h"
+#include "thread/Lock.h"
+#include "util/Logging2.h"
+#include "util/Memory.h"
+
+using namespace TAK::Engine::Raster::Mosaic;
+
+using namespace TAK::Engine::Core;
+using namespace TAK::Engine::DB;
+using namespace TAK::Engine::Feature;
+using namespace TAK::Engine::Port;
+using namespace TAK::Engine::Thread;
+using namespace TAK::Engine::Util;
+
+#define TABLE_MOSAIC_DATA "mosaicdata"
+#define TABLE_COVERAGE "coverage"
+#define TYPE_AGGREGATE_COVERAGE "<null>"
+#define INDEX_DB_FILENAME "index.sqlite"
+
+namespace
+{
+    // column order of FRAME_COLUMNS
+    enum FrameColumn
+    {
+        COL_ID,
+        COL_PATH,
+        COL_TYPE,
+        COL_MIN_LAT,
+        COL_MIN_LON,
+        COL_MAX_LAT,
+        COL_MAX_LON,
+        COL_UL_LAT,
+        COL_UL_LON,
+        COL_UR_LAT,
+        COL_UR_LON,
+        COL_LR_LAT,
+        COL_LR_LON,
+        COL_LL_LAT,
+        COL_LL_LON,
+        COL_MIN_GSD,
+        COL_MAX_GSD,
+        COL_WIDTH,
+        COL_HEIGHT,
+        COL_SRID,
+        COL_PRECISION,
+    };
+
+    const char * const FRAME_COLUMNS =
+        "id, path, type, minlat, minlon, maxlat, maxlon, "
+        "ullat, ullon, urlat, urlon, lrlat, lrlon, lllat, lllon, "
+        "mingsd, maxgsd, width, height, srid, precision";
+
+    class FrameCursor : public MosaicDatabase2::Cursor
+    {
+    public :
+        FrameCursor(const std::shared_ptr<Database2> &database, QueryPtr &&query) NOTHROWS;
+        ~FrameCursor() NOTHROWS override;
+    public :
+        TAKErr getUpperLeft(GeoPoint2 *value) NOTHROWS override;
+        TAKErr getUpperRight(GeoPoint2 *value) NOTHROWS override;
+        TAKErr getLowerRight(GeoPoint2 *value) NOTHROWS override;
+        TAKErr getLowerLeft(GeoPoint2 *value) NOTHROWS override;
+        TAKErr getMinLat(double *value) NOTHROWS override;
+        TAKErr getMinLon(double *value) NOTHROWS override;
+        TAKErr getMaxLat(double *value) NOTHROWS override;
+        TAKErr getMaxLon(double *value) NOTHROWS override;
+        TAKErr getPath(const char **value) NOTHROWS override;
+        TAKErr getType(const char **value) NOTHROWS override;
+        TAKErr getMinGSD(double *value) NOTHROWS override;
+        TAKErr getMaxGSD(double *value) NOTHROWS override;
+        TAKErr getWidth(int *value) NOTHROWS override;
+        TAKErr getHeight(int *value) NOTHROWS override;
+        TAKErr getId(int *value) NOTHROWS override;
+        TAKErr getSrid(int *value) NOTHROWS override;
+        TAKErr isPrecisionImagery(bool *value) NOTHROWS override;
+    public :
+        TAKErr moveToNext() NOTHROWS override;
+    private :
+        TAKErr getPoint(GeoPoint2 *value, const std::size_t latCol, const std::size_t lonCol) NOTHROWS;
+    private :
+        // declared first so that the query is finalized before the database
+        // may be released
+        std::shared_ptr<Database2> database;
+        QueryPtr query;
+    };
+
+    TAKErr appendFilter(WhereClauseBuilder2 &where, const MosaicDatabase2::FrameFilter &filter, const bool spatialIndex) NOTHROWS;
+    TAKErr appendSpatialIndexFilter(WhereClauseBuilder2 &where, const double minX, const double minY, const double maxX, const double maxY) NOTHROWS;
+    bool acceptsType(Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>> *filters, const char *type) NOTHROWS;
+}
+
+ATAKMosaicDatabase3::ATAKMosaicDatabase3() NOTHROWS :
+    indexDatabase(nullptr, nullptr)
+{}
+
+ATAKMosaicDatabase3::~ATAKMosaicDatabase3() NOTHROWS
+{
+    if (this->indexDatabase.get())
+        this->close();
+}
+
+const char *ATAKMosaicDatabase3::getType() NOTHROWS
+{
+    return "atak3";
+}
+
+TAKErr ATAKMosaicDatabase3::open(const char *path) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!path)
+        return TE_InvalidArg;
+
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (this->indexDatabase.get())
+        return TE_IllegalState;
+
+    std::ostringstream indexPath;
+    indexPath << path << Platform_pathSep() << INDEX_DB_FILENAME;
+
+    DatabasePtr database(nullptr, nullptr);
+    code = Databases_openDatabase(database, indexPath.str().c_str(), true);
+    TE_CHECKRETURN_CODE(code);
+
+    std::map<std::string, TypeDb> dbs;
+    std::map<std::string, std::shared_ptr<const Coverage>> covs;
+
+    double minLat = NAN;
+    double minLon = NAN;
+    double maxLat = NAN;
+    double maxLon = NAN;
+    double minGsd = NAN;
+    double maxGsd = NAN;
+
+    {
+        QueryPtr result(nullptr, nullptr);
+        code = database->query(result, "SELECT type, minlat, minlon, maxlat, maxlon, mingsd, maxgsd, path, coverageblob FROM " TABLE_COVERAGE);
+        TE_CHECKRETURN_CODE(code);
+
+        do {
+            code = result->moveToNext();
+            TE_CHECKBREAK_CODE(code);
+
+            Geometry2Ptr_const geom(nullptr, nullptr);
+
+            const uint8_t *blob;
+            std::size_t blobLen;
+            code = result->getBlob(&blob, &blobLen, 8u);
+            TE_CHECKBREAK_CODE(code);
+            if (blob) {
+                Geometry2Ptr parsed(nullptr, nullptr);
+                code = GeometryFactory_fromSpatiaLiteBlob(parsed, blob, blobLen);
+                TE_CHECKBREAK_CODE(code);
+                geom = std::move(parsed);
+            } else {
+                double covMinLat;
+                code = result->getDouble(&covMinLat, 1u);
+                TE_CHECKBREAK_CODE(code);
+                double covMinLon;
+                code = result->getDouble(&covMinLon, 2u);
+                TE_CHECKBREAK_CODE(code);
+                double covMaxLat;
+                code = result->getDouble(&covMaxLat, 3u);
+                TE_CHECKBREAK_CODE(code);
+                double covMaxLon;
+                code = result->getDouble(&covMaxLon, 4u);
+                TE_CHECKBREAK_CODE(code);
+
+                code = Polygon2_fromEnvelope(geom, Envelope2(covMinLon, covMinLat, covMaxLon, covMaxLat));
+                TE_CHECKBREAK_CODE(code);
+            }
+
+            double covMinGsd;
+            code = result->getDouble(&covMinGsd, 5u);
+            TE_CHECKBREAK_CODE(code);
+            double covMaxGsd;
+            code = result->getDouble(&covMaxGsd, 6u);
+            TE_CHECKBREAK_CODE(code);
+
+            Envelope2 mbb;
+            code = geom->getEnvelope(&mbb);
+            TE_CHECKBREAK_CODE(code);
+
+            if (isnan(minLat) || mbb.minY < minLat) minLat = mbb.minY;
+            if (isnan(minLon) || mbb.minX < minLon) minLon = mbb.minX;
+            if (isnan(maxLat) || mbb.maxY > maxLat) maxLat = mbb.maxY;
+            if (isnan(maxLon) || mbb.maxX > maxLon) maxLon = mbb.maxX;
+            // a lesser GSD value is a higher resolution
+            if (isnan(minGsd) || covMinGsd > minGsd) minGsd = covMinGsd;
+            if (isnan(maxGsd) || covMaxGsd < maxGsd) maxGsd = covMaxGsd;
+
+            const char *type;
+            code = result->getString(&type, 0u);
+            TE_CHECKBREAK_CODE(code);
+            if (!type)
+                continue;
+
+            covs[type] = std::shared_ptr<const Coverage>(new Coverage(std::move(geom), covMinGsd, covMaxGsd));
+
+            const char *typeDbPath;
+            code = result->getString(&typeDbPath, 7u);
+            TE_CHECKBREAK_CODE(code);
+            if (typeDbPath) {
+                DatabasePtr typeDb(nullptr, nullptr);
+                if (Databases_openDatabase(typeDb, typeDbPath, true) != TE_Ok) {
+                    Logger_log(TELL_Error, "ATAKMosaicDatabase3: failed to open type database %s", typeDbPath);
+                    continue;
+                }
+
+                TypeDb entry;
+                entry.spatialIndex = false;
+                {
+                    std::vector<Port::String> tableNames;
+                    STLVectorAdapter<Port::String> tableNamesV(tableNames);
+                    code = Databases_getTableNames(tableNamesV, *typeDb);
+                    TE_CHECKBREAK_CODE(code);
+
+                    Port::String spatialIndexTable("idx_" TABLE_MOSAIC_DATA "_coverageblob");
+                    code = tableNamesV.contains(&entry.spatialIndex, spatialIndexTable);
+                    TE_CHECKBREAK_CODE(code);
+                }
+                entry.database = std::shared_ptr<Database2>(std::move(typeDb));
+                dbs[type] = entry;
+            }
+        } while (true);
+        if (code == TE_Done)
+            code = TE_Ok;
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    std::map<std::string, std::shared_ptr<const Coverage>>::iterator aggregate;
+    aggregate = covs.find(TYPE_AGGREGATE_COVERAGE);
+    if (aggregate != covs.end()) {
+        this->coverage = aggregate->second;
+        covs.erase(aggregate);
+    } else if (!isnan(minLat)) {
+        Geometry2Ptr_const geom(nullptr, nullptr);
+        code = Polygon2_fromEnvelope(geom, Envelope2(minLon, minLat, maxLon, maxLat));
+        TE_CHECKRETURN_CODE(code);
+        this->coverage = std::shared_ptr<const Coverage>(new Coverage(std::move(geom), minGsd, maxGsd));
+    } else {
+        this->coverage.reset();
+    }
+
+    this->indexDatabase = std::move(database);
+    this->typeDbs = std::move(dbs);
+    this->coverages = std::move(covs);
+
+    return code;
+}
+
+TAKErr ATAKMosaicDatabase3::close() NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (!this->indexDatabase.get())
+        return TE_IllegalState;
+
+    // type databases are released once no open cursor references them
+    this->typeDbs.clear();
+    this->coverages.clear();
+    this->coverage.reset();
+    this->indexDatabase.reset();
+
+    return code;
+}
+
+TAKErr ATAKMosaicDatabase3::getCoverage(std::shared_ptr<const Coverage> &value) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (!this->indexDatabase.get())
+        return TE_IllegalState;
+    value = this->coverage;
+    return code;
+}
+
+TAKErr ATAKMosaicDatabase3::getCoverages(Collection<std::pair<Port::String, std::shared_ptr<const Coverage>>> &value) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (!this->indexDatabase.get())
+        return TE_IllegalState;
+
+    std::map<std::string, std::shared_ptr<const Coverage>>::iterator it;
+    for (it = this->coverages.begin(); it != this->coverages.end(); it++) {
+        code = value.add(std::make_pair(Port::String(it->first.c_str()), it->second));
+        TE_CHECKBREAK_CODE(code);
+    }
+    return code;
+}
+
+TAKErr ATAKMosaicDatabase3::getCoverage(std::shared_ptr<const Coverage> &value, const char *type) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!type)
+        return TE_InvalidArg;
+
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (!this->indexDatabase.get())
+        return TE_IllegalState;
+
+    std::map<std::string, std::shared_ptr<const Coverage>>::iterator entry;
+    entry = this->coverages.find(type);
+    if (entry == this->coverages.end())
+        return TE_InvalidArg;
+    value = entry->second;
+    return code;
+}
+
+bool ATAKMosaicDatabase3::isNativeFilter(const FrameFilter &filter) NOTHROWS
+{
+    switch (filter.kind) {
+    case FrameFilter::GsdRange :
+    case FrameFilter::Type :
+    case FrameFilter::PathPrefix :
+    case FrameFilter::Bounds :
+        return true;
+    default :
+        return false;
+    }
+}
+
+TAKErr ATAKMosaicDatabase3::queryImpl(CursorPtr &value, const QueryParameters &params) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    Lock lock(this->mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    if (!this->indexDatabase.get())
+        return TE_IllegalState;
+
+    // select the type databases; each holds the frames of a single type, so
+    // the types requested by the parameters and filters are resolved here
+    // rather than per row
+    std::vector<const TypeDb *> queryDbs;
+    std::map<std::string, TypeDb>::iterator typeDb;
+    for (typeDb = this->typeDbs.begin(); typeDb != this->typeDbs.end(); typeDb++) {
+        if (params.types.get()) {
+            Port::String type(typeDb->first.c_str());
+            bool requested;
+            code = params.types->contains(&requested, type);
+            TE_CHECKBREAK_CODE(code);
+            if (!requested)
+                continue;
+        }
+        if (!acceptsType(params.filters.get(), typeDb->first.c_str()))
+            continue;
+        queryDbs.push_back(&typeDb->second);
+    }
+    TE_CHECKRETURN_CODE(code);
+
+    Envelope2 roi;
+    if (params.spatialFilter.get()) {
+        code = params.spatialFilter->getEnvelope(&roi);
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    // the multiplexing cursor merges its inputs in ascending maximum GSD
+    // order; a single type database may be returned in the requested order
+    const bool multiplex = (queryDbs.size() != 1u);
+    const char *orderBy;
+    if (multiplex) {
+        orderBy = "maxgsd ASC, path ASC";
+    } else {
+        switch (params.order) {
+        case QueryParameters::MaxGsdAsc :
+            orderBy = "maxgsd ASC, type ASC";
+            break;
+        case QueryParameters::MinGsdAsc :
+            orderBy = "mingsd ASC, type ASC";
+            break;
+        case QueryParameters::MinGsdDesc :
+            orderBy = "mingsd DESC, type DESC";
+            break;
+        case QueryParameters::MaxGsdDesc :
+        default :
+            orderBy = "maxgsd DESC, type DESC";
+            break;
+        }
+    }
+
+    std::unique_ptr<MultiplexingMosaicDatabaseCursor2> multiplexed;
+    if (multiplex)
+        multiplexed.reset(new MultiplexingMosaicDatabaseCursor2());
+
+    for (std::size_t i = 0u; i < queryDbs.size(); i++) {
+        const TypeDb &db = *queryDbs[i];
+
+        WhereClauseBuilder2 where;
+        if (params.path) {
+            where.beginCondition();
+            where.append("path = ?");
+            BindArgument arg(params.path.get());
+            arg.own();
+            where.addArg(arg);
+        }
+        if (!isnan(params.minGsd)) {
+            where.beginCondition();
+            where.append((params.minGsdCompare == QueryParameters::MinimumGsd) ? "mingsd <= ?" : "maxgsd <= ?");
+            where.addArg(params.minGsd);
+        }
+        if (!isnan(params.maxGsd)) {
+            where.beginCondition();
+            where.append((params.maxGsdCompare == QueryParameters::MinimumGsd) ? "mingsd >= ?" : "maxgsd >= ?");
+            where.addArg(params.maxGsd);
+        }
+        if (params.srid > 0) {
+            where.beginCondition();
+            where.append("srid = ?");
+            where.addArg(params.srid);
+        }
+        if (params.imagery != QueryParameters::AllImagery) {
+            where.beginCondition();
+            where.append("precision = ?");
+            where.addArg((params.imagery == QueryParameters::PreciseImagery) ? 1 : 0);
+        }
+        if (params.spatialFilter.get()) {
+            if (db.spatialIndex) {
+                code = appendSpatialIndexFilter(where, roi.minX, roi.minY, roi.maxX, roi.maxY);
+                TE_CHECKBREAK_CODE(code);
+            } else {
+                where.beginCondition();
+                where.append("maxlat >= ? AND minlat <= ? AND maxlon >= ? AND minlon <= ?");
+                where.addArg(roi.minY);
+                where.addArg(roi.maxY);
+                where.addArg(roi.minX);
+                where.addArg(roi.maxX);
+            }
+        }
+        if (params.filters.get() && !params.filters->empty()) {
+            Collection<std::shared_ptr<FrameFilter>>::IteratorPtr iter(nullptr, nullptr);
+            code = params.filters->iterator(iter);
+            TE_CHECKBREAK_CODE(code);
+            do {
+                std::shared_ptr<FrameFilter> filter;
+                code = iter->get(filter);
+                TE_CHECKBREAK_CODE(code);
+                if (filter.get()) {
+                    code = appendFilter(where, *filter, db.spatialIndex);
+                    TE_CHECKBREAK_CODE(code);
+                }
+                code = iter->next();
+                TE_CHECKBREAK_CODE(code);
+            } while (true);
+            if (code == TE_Done)
+                code = TE_Ok;
+            TE_CHECKBREAK_CODE(code);
+        }
+
+        std::ostringstream sql;
+        sql << "SELECT " << FRAME_COLUMNS << " FROM " TABLE_MOSAIC_DATA;
+
+        std::list<BindArgument> args;
+        const char *selection;
+        code = where.getSelection(&selection);
+        TE_CHECKBREAK_CODE(code);
+        if (selection) {
+            sql << " WHERE " << selection;
+            STLListAdapter<BindArgument> argsAdapter(args);
+            code = where.getBindArgs(argsAdapter);
+            TE_CHECKBREAK_CODE(code);
+        }
+        sql << " ORDER BY " << orderBy;
+
+        QueryPtr result(nullptr, nullptr);
+        STLListAdapter<BindArgument> argsAdapter(args);
+        code = BindArgument::query(result, *db.database, sql.str().c_str(), argsAdapter);
+        TE_CHECKBREAK_CODE(code);
+
+        CursorPtr cursor(new FrameCursor(db.database, std::move(result)), Memory_deleter_const<MosaicDatabase2::Cursor, FrameCursor>);
+        if (multiplex) {
+            code = multiplexed->add(std::move(cursor));
+            TE_CHECKBREAK_CODE(code);
+        } else {
+            value = std::move(cursor);
+        }
+    }
+    TE_CHECKRETURN_CODE(code);
+
+    if (multiplex)
+        value = CursorPtr(multiplexed.release(), Memory_deleter_const<MosaicDatabase2::Cursor, MultiplexingMosaicDatabaseCursor2>);
+
+    return code;
+}
+
+namespace
+{
+    FrameCursor::FrameCursor(const std::shared_ptr<Database2> &database_, QueryPtr &&query_) NOTHROWS :
+        database(database_),
+        query(std::move(query_))
+    {}
+
+    FrameCursor::~FrameCursor() NOTHROWS
+    {}
+
+    TAKErr FrameCursor::getPoint(GeoPoint2 *value, const std::size_t latCol, const std::size_t lonCol) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        double lat;
+        code = this->query->getDouble(&lat, latCol);
+        TE_CHECKRETURN_CODE(code);
+        double lon;
+        code = this->query->getDouble(&lon, lonCol);
+        TE_CHECKRETURN_CODE(code);
+        *value = GeoPoint2(lat, lon);
+        return code;
+    }
+
+    TAKErr FrameCursor::getUpperLeft(GeoPoint2 *value) NOTHROWS
+    {
+        return this->getPoint(value, COL_UL_LAT, COL_UL_LON);
+    }
+
+    TAKErr FrameCursor::getUpperRight(GeoPoint2 *value) NOTHROWS
+    {
+        return this->getPoint(value, COL_UR_LAT, COL_UR_LON);
+    }
+
+    TAKErr FrameCursor::getLowerRight(GeoPoint2 *value) NOTHROWS
+    {
+        return this->getPoint(value, COL_LR_LAT, COL_LR_LON);
+    }
+
+    TAKErr FrameCursor::getLowerLeft(GeoPoint2 *value) NOTHROWS
+    {
+        return this->getPoint(value, COL_LL_LAT, COL_LL_LON);
+    }
+
+    TAKErr FrameCursor::getMinLat(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MIN_LAT);
+    }
+
+    TAKErr FrameCursor::getMinLon(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MIN_LON);
+    }
+
+    TAKErr FrameCursor::getMaxLat(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MAX_LAT);
+    }
+
+    TAKErr FrameCursor::getMaxLon(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MAX_LON);
+    }
+
+    TAKErr FrameCursor::getPath(const char **value) NOTHROWS
+    {
+        return this->query->getString(value, COL_PATH);
+    }
+
+    TAKErr FrameCursor::getType(const char **value) NOTHROWS
+    {
+        return this->query->getString(value, COL_TYPE);
+    }
+
+    TAKErr FrameCursor::getMinGSD(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MIN_GSD);
+    }
+
+    TAKErr FrameCursor::getMaxGSD(double *value) NOTHROWS
+    {
+        return this->query->getDouble(value, COL_MAX_GSD);
+    }
+
+    TAKErr FrameCursor::getWidth(int *value) NOTHROWS
+    {
+        return this->query->getInt(value, COL_WIDTH);
+    }
+
+    TAKErr FrameCursor::getHeight(int *value) NOTHROWS
+    {
+        return this->query->getInt(value, COL_HEIGHT);
+    }
+
+    TAKErr FrameCursor::getId(int *value) NOTHROWS
+    {
+        return this->query->getInt(value, COL_ID);
+    }
+
+    TAKErr FrameCursor::getSrid(int *value) NOTHROWS
+    {
+        return this->query->getInt(value, COL_SRID);
+    }
+
+    TAKErr FrameCursor::isPrecisionImagery(bool *value) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        int precision;
+        code = this->query->getInt(&precision, COL_PRECISION);
+        TE_CHECKRETURN_CODE(code);
+        *value = (precision != 0);
+        return code;
+    }
+
+    TAKErr FrameCursor::moveToNext() NOTHROWS
+    {
+        return this->query->moveToNext();
+    }
+
+    TAKErr appendFilter(WhereClauseBuilder2 &where, const MosaicDatabase2::FrameFilter &filter, const bool spatialIndex) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+
+        // each predicate must select exactly the rows FrameFilter::accept
+        // accepts; NULL values are rejected by SQL comparison as they are
+        // by accept
+        where.beginCondition();
+        switch (filter.kind) {
+        case MosaicDatabase2::FrameFilter::GsdRange :
+        {
+            const char *col = (filter.gsdCompare == MosaicDatabase2::QueryParameters::MinimumGsd) ? "mingsd" : "maxgsd";
+            std::ostringstream predicate;
+            if (isnan(filter.gsdLow) && isnan(filter.gsdHigh)) {
+                predicate << col << " IS NOT NULL";
+            } else if (isnan(filter.gsdHigh)) {
+                predicate << col << " >= ?";
+                where.addArg(filter.gsdLow);
+            } else if (isnan(filter.gsdLow)) {
+                predicate << col << " <= ?";
+                where.addArg(filter.gsdHigh);
+            } else {
+                predicate << col << " >= ? AND " << col << " <= ?";
+                where.addArg(filter.gsdLow);
+                where.addArg(filter.gsdHigh);
+            }
+            where.append(predicate.str().c_str());
+            break;
+        }
+        case MosaicDatabase2::FrameFilter::Type :
+        {
+            if (filter.types.empty()) {
+                where.append(filter.exclude ? "type IS NOT NULL" : "0");
+                break;
+            }
+            // exact matches; WhereClauseBuilder2::appendIn would treat '%'
+            // in a type name as a wildcard
+            std::ostringstream predicate;
+            predicate << (filter.exclude ? "type NOT IN (?" : "type IN (?");
+            for (std::size_t i = 1u; i < filter.types.size(); i++)
+                predicate << ", ?";
+            predicate << ")";
+            where.append(predicate.str().c_str());
+            for (std::size_t i = 0u; i < filter.types.size(); i++) {
+                BindArgument arg(filter.types[i].get());
+                arg.own();
+                where.addArg(arg);
+            }
+            break;
+        }
+        case MosaicDatabase2::FrameFilter::PathPrefix :
+        {
+            // express the prefix as a range so that an index on path may be
+            // used; the upper bound is the least string greater than every
+            // string with the prefix
+            std::string lower(filter.pathPrefix.get());
+            std::string upper(lower);
+            while (!upper.empty() && static_cast<unsigned char>(upper[upper.length() - 1u]) == 0xFFu)
+                upper.erase(upper.length() - 1u);
+            if (!upper.empty())
+                upper[upper.length() - 1u] = static_cast<char>(static_cast<unsigned char>(upper[upper.length() - 1u]) + 1u);
+
+            BindArgument lowerArg(lower.c_str());
+            lowerArg.own();
+            if (upper.empty()) {
+                where.append("path >= ?");
+                where.addArg(lowerArg);
+            } else {
+                BindArgument upperArg(upper.c_str());
+                upperArg.own();
+                where.append("path >= ? AND path < ?");
+                where.addArg(lowerArg);
+                where.addArg(upperArg);
+            }
+            break;
+        }
+        case MosaicDatabase2::FrameFilter::Bounds :
+        {
+            where.append("maxlat >= ? AND minlat <= ? AND maxlon >= ? AND minlon <= ?");
+            where.addArg(filter.minLat);
+            where.addArg(filter.maxLat);
+            where.addArg(filter.minLon);
+            where.addArg(filter.maxLon);
+            // narrow to the index candidates first; a frame's coverage is the
+            // quadrilateral its bounds are computed from, so the index MBR
+            // is the frame bounds and no frame is lost
+            if (spatialIndex) {
+                code = appendSpatialIndexFilter(where, filter.minLon, filter.minLat, filter.maxLon, filter.maxLat);
+                TE_CHECKRETURN_CODE(code);
+            }
+            break;
+        }
+        default :
+            return TE_InvalidArg;
+        }
+
+        return code;
+    }
+
+    TAKErr appendSpatialIndexFilter(WhereClauseBuilder2 &where, const double minX, const double minY, const double maxX, const double maxY) NOTHROWS
+    {
+        where.beginCondition();
+        where.append("ROWID IN (SELECT ROWID FROM SpatialIndex WHERE f_table_name = \'" TABLE_MOSAIC_DATA "\' AND search_frame = BuildMbr(?, ?, ?, ?, 4326))");
+        where.addArg(minX);
+        where.addArg(minY);
+        where.addArg(maxX);
+        where.addArg(maxY);
+        return TE_Ok;
+    }
+
+    bool acceptsType(Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>> *filters, const char *type) NOTHROWS
+    {
+        if (!filters || filters->empty())
+            return true;
+
+        TAKErr code(TE_Ok);
+        Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>>::IteratorPtr iter(nullptr, nullptr);
+        code = filters->iterator(iter);
+        if (code != TE_Ok)
+            return true;
+        do {
+            std::shared_ptr<MosaicDatabase2::FrameFilter> filter;
+            code = iter->get(filter);
+            TE_CHECKBREAK_CODE(code);
+            if (filter.get() && filter->kind == MosaicDatabase2::FrameFilter::Type) {
+                bool matched = false;
+                for (std::size_t i = 0u; i < filter->types.size(); i++) {
+                    if (strcmp(type, filter->types[i]) == 0) {
+                        matched = true;
+                        break;
+                    }
+                }
+                if (matched == filter->exclude)
+                    return false;
+            }
+            code = iter->next();
+            TE_CHECKBREAK_CODE(code);
+        } while (true);
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef TAK_ENGINE_RASTER_MOSAIC_ATAKMOSAICDATABASE3_H_INCLUDED
+#define TAK_ENGINE_RASTER_MOSAIC_ATAKMOSAICDATABASE3_H_INCLUDED
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "db/Database2.h"
+#include "raster/mosaic/MosaicDatabase2.h"
+#include "thread/Mutex.h"
+
+namespace TAK {
+    namespace Engine {
+        namespace Raster {
+            namespace Mosaic {
+                /**
+                 * Read access to the <code>atak3</code> mosaic database
+                 * format. The database is a directory containing an index,
+                 * <code>index.sqlite</code>, that records the coverage of
+                 * each imagery type and the path to a per-type SpatiaLite
+                 * database holding its frames.
+                 *
+                 * <P>All <code>FrameFilter</code> kinds are evaluated
+                 * natively. They are compiled into the SQL issued against
+                 * each type database, and type filters additionally skip
+                 * type databases that cannot match.
+                 */
+                class ENGINE_API ATAKMosaicDatabase3 : public MosaicDatabase2
+                {
+                private :
+                    struct TypeDb
+                    {
+                        /** shared with the cursors querying it, which may outlive <code>close</code> */
+                        std::shared_ptr<DB::Database2> database;
+                        /** <code>true</code> if the frame coverages have a SpatiaLite spatial index */
+                        bool spatialIndex;
+                    };
+                public :
+                    ATAKMosaicDatabase3() NOTHROWS;
+                    ~ATAKMosaicDatabase3() NOTHROWS override;
+                public :
+                    const char *getType() NOTHROWS override;
+                    /**
+                     * Opens the database.
+                     *
+                     * @param path  The mosaic database directory
+                     */
+                    Util::TAKErr open(const char *path) NOTHROWS override;
+                    Util::TAKErr close() NOTHROWS override;
+                    Util::TAKErr getCoverage(std::shared_ptr<const Coverage> &value) NOTHROWS override;
+                    Util::TAKErr getCoverages(Port::Collection<std::pair<Port::String, std::shared_ptr<const Coverage>>> &coverages) NOTHROWS override;
+                    Util::TAKErr getCoverage(std::shared_ptr<const Coverage> &value, const char *type) NOTHROWS override;
+                    bool isNativeFilter(const FrameFilter &filter) NOTHROWS override;
+                protected :
+                    Util::TAKErr queryImpl(CursorPtr &value, const QueryParameters &params) NOTHROWS override;
+                private :
+                    Thread::Mutex mutex;
+                    DB::DatabasePtr indexDatabase;
+                    std::map<std::string, TypeDb> typeDbs;
+                    std::map<std::string, std::shared_ptr<const Coverage>> coverages;
+                    std::shared_ptr<const Coverage> coverage;
+                };
+            }
+        }
+    }
+}
+
+#endif
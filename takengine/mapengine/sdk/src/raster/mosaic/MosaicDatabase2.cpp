@@ -1,8 +1,13 @@
 #include "raster/mosaic/MosaicDatabase2.h"
 
+#include <cmath>
+#include <cstring>
+
 #include "port/Collections.h"
 #include "port/STLSetAdapter.h"
+#include "port/STLVectorAdapter.h"
 #include "port/String.h"
+#include "raster/mosaic/FilterMosaicDatabaseCursor2.h"
 #include "util/Memory.h"
 
 using namespace TAK::Engine;
@@ -13,6 +18,9 @@ using namespace TAK::Engine::Util;
 
 namespace
 {
+    typedef std::unique_ptr<Port::Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>>, void(*)(const Port::Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>> *)> FrameFiltersPtr;
+    typedef std::unique_ptr<Port::Collection<std::shared_ptr<Filter<MosaicDatabase2::Cursor &>>>, void(*)(const Port::Collection<std::shared_ptr<Filter<MosaicDatabase2::Cursor &>>> *)> FiltersPtr;
+
     double min(double a, double b, double c, double d)
     {
         double     v = a;
@@ -35,6 +43,63 @@ namespace
 MosaicDatabase2::~MosaicDatabase2() NOTHROWS
 {}
 
+TAKErr MosaicDatabase2::query(CursorPtr &value, const QueryParameters &params) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!params.filters.get() || params.filters->empty())
+        return queryImpl(value, params);
+
+    // partition the filters into those the database evaluates and those that
+    // must be applied to its results
+    std::vector<std::shared_ptr<FrameFilter>> nativeFilters;
+    FiltersPtr fallback(new Port::STLVectorAdapter<std::shared_ptr<Filter<Cursor &>>>(), Memory_deleter_const<Port::Collection<std::shared_ptr<Filter<Cursor &>>>, Port::STLVectorAdapter<std::shared_ptr<Filter<Cursor &>>>>);
+    {
+        Port::Collection<std::shared_ptr<FrameFilter>>::IteratorPtr iter(nullptr, nullptr);
+        code = params.filters->iterator(iter);
+        TE_CHECKRETURN_CODE(code);
+        do {
+            std::shared_ptr<FrameFilter> filter;
+            code = iter->get(filter);
+            TE_CHECKBREAK_CODE(code);
+            if (filter.get()) {
+                if (this->isNativeFilter(*filter))
+                    nativeFilters.push_back(filter);
+                else
+                    code = fallback->add(filter);
+                TE_CHECKBREAK_CODE(code);
+            }
+            code = iter->next();
+            TE_CHECKBREAK_CODE(code);
+        } while (true);
+        if (code == TE_Done)
+            code = TE_Ok;
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    if (fallback->empty())
+        return queryImpl(value, params);
+
+    QueryParameters nativeParams(params);
+    nativeParams.filters.reset();
+    if (!nativeFilters.empty()) {
+        Port::STLVectorAdapter<std::shared_ptr<FrameFilter>> nativeFiltersAdapter(nativeFilters);
+        nativeParams.filters = FrameFiltersPtr(new Port::STLVectorAdapter<std::shared_ptr<FrameFilter>>(), Memory_deleter_const<Port::Collection<std::shared_ptr<FrameFilter>>, Port::STLVectorAdapter<std::shared_ptr<FrameFilter>>>);
+        code = Port::Collections_addAll(*nativeParams.filters, nativeFiltersAdapter);
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    CursorPtr result(nullptr, nullptr);
+    code = queryImpl(result, nativeParams);
+    TE_CHECKRETURN_CODE(code);
+
+    return FilterMosaicDatabaseCursor2_filter(value, std::move(result), std::move(fallback));
+}
+
+bool MosaicDatabase2::isNativeFilter(const FrameFilter &) NOTHROWS
+{
+    return false;
+}
+
 /**************************************************************************/
 // MosaicDatabase2::QueryParameters
 
@@ -48,7 +113,8 @@ MosaicDatabase2::QueryParameters::QueryParameters() NOTHROWS :
     imagery(QueryParameters::AllImagery),
     minGsdCompare(MaximumGsd),
     maxGsdCompare(MaximumGsd),
-    order(MaxGsdDesc)
+    order(MaxGsdDesc),
+    filters(nullptr, nullptr)
 {}
         
 MosaicDatabase2::QueryParameters::QueryParameters(const QueryParameters &other) NOTHROWS :
@@ -61,7 +127,8 @@ MosaicDatabase2::QueryParameters::QueryParameters(const QueryParameters &other)
     imagery(other.imagery),
     minGsdCompare(other.minGsdCompare),
     maxGsdCompare(other.maxGsdCompare),
-    order(other.order)
+    order(other.order),
+    filters(nullptr, nullptr)
 {
     if (other.spatialFilter.get()) {
         TAKErr code(TE_Ok);
@@ -75,6 +142,11 @@ MosaicDatabase2::QueryParameters::QueryParameters(const QueryParameters &other)
         types = TAK_UNIQUE_PTR(Port::Set<Port::String>)(new Port::STLSetAdapter<Port::String, Port::StringLess>(), Util::Memory_deleter_const<Port::Set<Port::String>, Port::STLSetAdapter<Port::String, Port::StringLess>>);
         Port::Collections_addAll(*types, *other.types);
     }
+
+    if (other.filters.get()) {
+        filters = FrameFiltersPtr(new Port::STLVectorAdapter<std::shared_ptr<FrameFilter>>(), Util::Memory_deleter_const<Port::Collection<std::shared_ptr<FrameFilter>>, Port::STLVectorAdapter<std::shared_ptr<FrameFilter>>>);
+        Port::Collections_addAll(*filters, *other.filters);
+    }
 }
 
 MosaicDatabase2::QueryParameters::~QueryParameters() NOTHROWS
@@ -252,3 +324,146 @@ MosaicDatabase2::Coverage::Coverage(Geometry2Ptr_const &&geometry_, const double
     minGSD(minGSD_),
     maxGSD(maxGSD_)
 {}
+
+/**************************************************************************/
+// MosaicDatabase2::FrameFilter
+
+MosaicDatabase2::FrameFilter::FrameFilter(const Kind kind_) NOTHROWS :
+    kind(kind_),
+    gsdCompare(QueryParameters::MaximumGsd),
+    gsdLow(NAN),
+    gsdHigh(NAN),
+    exclude(false),
+    minLat(NAN),
+    minLon(NAN),
+    maxLat(NAN),
+    maxLon(NAN)
+{}
+
+MosaicDatabase2::FrameFilter::~FrameFilter() NOTHROWS
+{}
+
+bool MosaicDatabase2::FrameFilter::accept(Cursor &row) NOTHROWS
+{
+    // mirrors the SQL a database would compile the filter into: a row
+    // without the compared value is rejected
+    TAKErr code(TE_Ok);
+    switch (kind) {
+    case GsdRange :
+    {
+        double gsd;
+        if (gsdCompare == QueryParameters::MinimumGsd)
+            code = row.getMinGSD(&gsd);
+        else
+            code = row.getMaxGSD(&gsd);
+        if (code != TE_Ok || isnan(gsd))
+            return false;
+        if (!isnan(gsdLow) && gsd < gsdLow)
+            return false;
+        if (!isnan(gsdHigh) && gsd > gsdHigh)
+            return false;
+        return true;
+    }
+    case Type :
+    {
+        const char *type;
+        code = row.getType(&type);
+        if (code != TE_Ok || !type)
+            return false;
+        bool matched = false;
+        for (std::size_t i = 0u; i < types.size(); i++) {
+            if (strcmp(type, types[i]) == 0) {
+                matched = true;
+                break;
+            }
+        }
+        return (matched != exclude);
+    }
+    case PathPrefix :
+    {
+        const char *path;
+        code = row.getPath(&path);
+        if (code != TE_Ok || !path)
+            return false;
+        return (strncmp(path, pathPrefix, strlen(pathPrefix)) == 0);
+    }
+    case Bounds :
+    {
+        double frameMinLat;
+        double frameMinLon;
+        double frameMaxLat;
+        double frameMaxLon;
+        if (row.getMinLat(&frameMinLat) != TE_Ok ||
+            row.getMinLon(&frameMinLon) != TE_Ok ||
+            row.getMaxLat(&frameMaxLat) != TE_Ok ||
+            row.getMaxLon(&frameMaxLon) != TE_Ok) {
+
+            return false;
+        }
+        return (frameMaxLat >= minLat && frameMinLat <= maxLat && frameMaxLon >= minLon && frameMinLon <= maxLon);
+    }
+    default :
+        return false;
+    }
+}
+
+TAKErr TAK::Engine::Raster::Mosaic::MosaicDatabase2_createGsdFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const MosaicDatabase2::QueryParameters::GsdCompare compare, const double low, const double high) NOTHROWS
+{
+    if (!isnan(low) && !isnan(high) && low > high)
+        return TE_InvalidArg;
+    value = std::make_shared<MosaicDatabase2::FrameFilter>(MosaicDatabase2::FrameFilter::GsdRange);
+    value->gsdCompare = compare;
+    value->gsdLow = low;
+    value->gsdHigh = high;
+    return TE_Ok;
+}
+
+TAKErr TAK::Engine::Raster::Mosaic::MosaicDatabase2_createTypeFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, Port::Collection<Port::String> &types, const bool exclude) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    std::shared_ptr<MosaicDatabase2::FrameFilter> filter(std::make_shared<MosaicDatabase2::FrameFilter>(MosaicDatabase2::FrameFilter::Type));
+    filter->exclude = exclude;
+    if (!types.empty()) {
+        Port::Collection<Port::String>::IteratorPtr iter(nullptr, nullptr);
+        code = types.iterator(iter);
+        TE_CHECKRETURN_CODE(code);
+        do {
+            Port::String type;
+            code = iter->get(type);
+            TE_CHECKBREAK_CODE(code);
+            if (!type)
+                return TE_InvalidArg;
+            filter->types.push_back(type);
+            code = iter->next();
+            TE_CHECKBREAK_CODE(code);
+        } while (true);
+        if (code == TE_Done)
+            code = TE_Ok;
+        TE_CHECKRETURN_CODE(code);
+    }
+    value = filter;
+    return code;
+}
+
+TAKErr TAK::Engine::Raster::Mosaic::MosaicDatabase2_createPathPrefixFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const char *prefix) NOTHROWS
+{
+    if (!prefix)
+        return TE_InvalidArg;
+    value = std::make_shared<MosaicDatabase2::FrameFilter>(MosaicDatabase2::FrameFilter::PathPrefix);
+    value->pathPrefix = prefix;
+    return TE_Ok;
+}
+
+TAKErr TAK::Engine::Raster::Mosaic::MosaicDatabase2_createBoundsFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const double minLat, const double minLon, const double maxLat, const double maxLon) NOTHROWS
+{
+    if (isnan(minLat) || isnan(minLon) || isnan(maxLat) || isnan(maxLon))
+        return TE_InvalidArg;
+    if (minLat > maxLat || minLon > maxLon)
+        return TE_InvalidArg;
+    value = std::make_shared<MosaicDatabase2::FrameFilter>(MosaicDatabase2::FrameFilter::Bounds);
+    value->minLat = minLat;
+    value->minLon = minLon;
+    value->maxLat = maxLat;
+    value->maxLon = maxLon;
+    return TE_Ok;
+}
@@ -1,14 +1,18 @@
 #ifndef TAK_ENGINE_RASTER_MOSAIC_MOSAICDATABASE2_H_INCLUDED
 #define TAK_ENGINE_RASTER_MOSAIC_MOSAICDATABASE2_H_INCLUDED
 
+#include <vector>
+
 #include "core/GeoPoint2.h"
 #include "db/RowIterator.h"
 #include "feature/Geometry2.h"
+#include "port/Collection.h"
 #include "port/Platform.h"
 #include "port/Set.h"
 #include "port/String.h"
 #include "raster/ImageInfo.h"
 #include "util/Error.h"
+#include "util/Filter.h"
 #include "util/NonCopyable.h"
 
 namespace TAK {
@@ -22,6 +26,7 @@ namespace TAK {
                     class ENGINE_API Cursor;
                     class ENGINE_API Frame;
                     class ENGINE_API Coverage;
+                    class ENGINE_API FrameFilter;
                 public :
                     typedef std::unique_ptr<Cursor, void(*)(const Cursor *)> CursorPtr;
                     typedef std::unique_ptr<Frame, void(*)(const Frame *)> FramePtr;
@@ -37,7 +42,28 @@ namespace TAK {
                     virtual Util::TAKErr getCoverage(std::shared_ptr<const Coverage> &value) NOTHROWS = 0;
                     virtual Util::TAKErr getCoverages(Port::Collection<std::pair<Port::String, std::shared_ptr<const Coverage>>> &coverages) NOTHROWS = 0;
                     virtual Util::TAKErr getCoverage(std::shared_ptr<const Coverage> &value, const char *type) NOTHROWS = 0;
-                    virtual Util::TAKErr query(CursorPtr &value, const QueryParameters &params) NOTHROWS = 0;
+                    /**
+                     * Queries the database. Any of <code>params.filters</code>
+                     * that the database does not evaluate natively are
+                     * applied to the rows it returns.
+                     */
+                    Util::TAKErr query(CursorPtr &value, const QueryParameters &params) NOTHROWS;
+                    /**
+                     * Returns <code>true</code> if the database evaluates the
+                     * specified filter as part of its query, e.g. by
+                     * compiling it into an indexed SQL predicate, rather than
+                     * producing rows that the filter would reject. The default
+                     * implementation returns <code>false</code>.
+                     */
+                    virtual bool isNativeFilter(const FrameFilter &filter) NOTHROWS;
+                protected :
+                    /**
+                     * Queries the database. <code>params.filters</code> only
+                     * contains filters for which <code>isNativeFilter</code>
+                     * returned <code>true</code>, and the implementation must
+                     * apply all of them.
+                     */
+                    virtual Util::TAKErr queryImpl(CursorPtr &value, const QueryParameters &params) NOTHROWS = 0;
                 };
 
                 typedef std::unique_ptr<MosaicDatabase2, void(*)(const MosaicDatabase2 *)> MosaicDatabase2Ptr;
@@ -80,8 +106,87 @@ namespace TAK {
                     GsdCompare minGsdCompare;
                     GsdCompare maxGsdCompare;
                     Order order;
+                    /**
+                     * Additional frame predicates; a frame is returned only if
+                     * it is accepted by all filters.
+                     */
+                    std::unique_ptr<Port::Collection<std::shared_ptr<FrameFilter>>, void(*)(const Port::Collection<std::shared_ptr<FrameFilter>> *)> filters;
+                };
+
+                /**
+                 * A declarative predicate over the frames of a mosaic
+                 * database. Unlike an arbitrary <code>Util::Filter</code>, the
+                 * descriptor may be inspected by a database and compiled into
+                 * its own query; <code>accept</code> evaluates it against a
+                 * row for databases that cannot.
+                 *
+                 * <P>Instances are created via the
+                 * <code>MosaicDatabase2_create*Filter</code> functions and
+                 * should not be modified once added to a query.
+                 */
+                class ENGINE_API MosaicDatabase2::FrameFilter : public Util::Filter<Cursor &>
+                {
+                public :
+                    enum Kind
+                    {
+                        /** accepts frames whose GSD is within <code>[gsdLow, gsdHigh]</code> */
+                        GsdRange,
+                        /** accepts frames whose type is in <code>types</code>, or not if <code>exclude</code> is set */
+                        Type,
+                        /** accepts frames whose path starts with <code>pathPrefix</code> */
+                        PathPrefix,
+                        /** accepts frames whose bounds intersect the rectangle */
+                        Bounds,
+                    };
+                public :
+                    FrameFilter(const Kind kind) NOTHROWS;
+                    ~FrameFilter() NOTHROWS override;
+                public :
+                    bool accept(Cursor &row) NOTHROWS override;
+                public :
+                    Kind kind;
+                    /** the frame GSD compared by <code>GsdRange</code> */
+                    QueryParameters::GsdCompare gsdCompare;
+                    /** inclusive bounds on the GSD value, <code>NAN</code> if unbounded */
+                    double gsdLow;
+                    double gsdHigh;
+                    std::vector<Port::String> types;
+                    bool exclude;
+                    Port::String pathPrefix;
+                    /** the rectangle for <code>Bounds</code>, in degrees */
+                    double minLat;
+                    double minLon;
+                    double maxLat;
+                    double maxLon;
                 };
 
+                /**
+                 * Creates a filter accepting frames whose GSD is within the
+                 * specified range. Note that a lesser GSD value is a higher
+                 * resolution.
+                 *
+                 * @param compare   The frame GSD that is compared
+                 * @param low       The least accepted GSD, <code>NAN</code> if unbounded
+                 * @param high      The greatest accepted GSD, <code>NAN</code> if unbounded
+                 */
+                ENGINE_API Util::TAKErr MosaicDatabase2_createGsdFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const MosaicDatabase2::QueryParameters::GsdCompare compare, const double low, const double high) NOTHROWS;
+                /**
+                 * Creates a filter accepting frames of the specified types,
+                 * or, if <code>exclude</code> is <code>true</code>, frames of
+                 * any other type.
+                 */
+                ENGINE_API Util::TAKErr MosaicDatabase2_createTypeFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, Port::Collection<Port::String> &types, const bool exclude) NOTHROWS;
+                /**
+                 * Creates a filter accepting frames whose path starts with the
+                 * specified prefix, e.g. the frames below a directory.
+                 */
+                ENGINE_API Util::TAKErr MosaicDatabase2_createPathPrefixFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const char *prefix) NOTHROWS;
+                /**
+                 * Creates a filter accepting frames whose bounds intersect the
+                 * specified rectangle.
+                 */
+                ENGINE_API Util::TAKErr MosaicDatabase2_createBoundsFilter(std::shared_ptr<MosaicDatabase2::FrameFilter> &value, const double minLat, const double minLon, const double maxLat, const double maxLon) NOTHROWS;
+
                 class ENGINE_API MosaicDatabase2::Cursor : public virtual DB::RowIterator
                 {
                 protected :
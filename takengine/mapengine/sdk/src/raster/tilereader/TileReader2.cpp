@@ -6,6 +6,7 @@
 #include "thread/Lock.h"
 
 #include "util/Memory.h"
+#include "util/Tracing.h"
 
 using namespace TAK::Engine::Raster::TileReader;
 
@@ -269,6 +270,8 @@ TAKErr TileReader2::fill(ReadRequest &request) NOTHROWS
 {
     TAKErr code(TE_Ok);
 
+    TE_TRACE_SPAN("TileReader2::fill");
+
     {
         Thread::LockPtr lock(nullptr, nullptr);
         TAK::Engine::Thread::Lock_create(lock, readLock);
@@ -623,6 +626,7 @@ TileReader2::AsynchronousIO *TAK::Engine::Raster::TileReader::TileReader2_getMas
 void TileReader2::ReadRequest_run(TileReader2 *reader, void *opaque)
 {
     TAKErr code(TE_Ok);
+    TE_TRACE_SPAN("TileReader2::ReadRequest_run");
     auto *request = static_cast<ReadRequest *>(opaque);
 
     Thread::LockPtr lock(nullptr, nullptr);
@@ -276,7 +276,7 @@ namespace atakmap
 
         GLES20FixedPipeline::GLES20FixedPipeline() : current(nullptr), curAttribs(),
             texCoordPointer(), vertexPointer(), colorPointer(),
-            activeTextureUnit(GL_TEXTURE0), tex2DEnabled(false)
+            activeTextureUnit(GL_TEXTURE0), tex2DEnabled(false), lineWidth(1.0f), currentProgram(0u)
         {
 #ifdef MSVC
             // XXX - 
@@ -526,7 +526,16 @@ namespace atakmap
 
         void GLES20FixedPipeline::glLineWidth(float w)
         { 
-            ::glLineWidth(w * atakmap::core::AtakMapView::DENSITY);
+            lineWidth = w * atakmap::core::AtakMapView::DENSITY;
+            ::glLineWidth(lineWidth);
+        }
+
+        void GLES20FixedPipeline::glUseProgram(unsigned int program)
+        {
+            if (program == currentProgram)
+                return;
+            currentProgram = program;
+            ::glUseProgram(program);
         }
 
         void GLES20FixedPipeline::pushAllAttribs()
@@ -563,9 +572,7 @@ namespace atakmap
                 case GL_LINE_STRIP :
                 case GL_LINE_LOOP:
                 {
-                    float width;
-                    glGetFloatv(GL_LINE_WIDTH, &width);
-
+                    const float width = lineWidth;
                     if (width > 1) {
                         GLLinesEmulation::emulateLineDrawArrays(mode, first, count, this, width, vertexPointer.enabled ? &vertexPointer : nullptr, texCoordPointer.enabled ? &texCoordPointer : nullptr);
                         break;
@@ -596,9 +603,7 @@ namespace atakmap
 				case GL_LINE_STRIP:
 				case GL_LINE_LOOP:
 				{
-					float width;
-					glGetFloatv(GL_LINE_WIDTH, &width);
-
+					const float width = lineWidth;
 					if (width > 1) {
 						GLLinesEmulation::emulateLineDrawElements(mode, count, type, indices, this, width, vertexPointer.enabled ? &vertexPointer : nullptr, texCoordPointer.enabled ? &texCoordPointer : nullptr);
 						break;
@@ -627,320 +632,269 @@ namespace atakmap
 
         void GLES20FixedPipeline::drawGenericVectorImpl(int mode, int first, int count, bool useColorPtr)
         {
-            int aColorPointerHandle = 0;
-            int programHandle = getGenericVectorProgram(vertexPointer.size, useColorPtr);
+            Program *program = getGenericVectorProgram(vertexPointer.size, useColorPtr);
+            if (!program)
+                return;
 
-            int prevProgram;
-            glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
-            glUseProgram(programHandle);
+            bindProgram(*program);
 
             float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
             readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
+            program->uniformMatrix4fv(program->uProjection, program->projection, p);
             CHECKERRS();
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
             readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            program->uniformMatrix4fv(program->uModelView, program->modelView, p);
             CHECKERRS();
             
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            glEnableVertexAttribArray(aVertexCoordsHandle);
+            glEnableVertexAttribArray(program->aVertexCoords);
 
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
 
             if (!useColorPtr) {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
+                program->uniform4f(program->uColor, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
             } else {
-                aColorPointerHandle = glGetAttribLocation(programHandle, "aColorPointer");
-                glEnableVertexAttribArray(aColorPointerHandle);
+                glEnableVertexAttribArray(program->aColorPointer);
 
-                setVertexAttribPointer(aColorPointerHandle, &colorPointer, true);
+                setVertexAttribPointer(program->aColorPointer, &colorPointer, true);
             }
 
             ::glDrawArrays(mode, first, count);
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
+            glDisableVertexAttribArray(program->aVertexCoords);
             if (useColorPtr)
-                glDisableVertexAttribArray(aColorPointerHandle);
-            glUseProgram(prevProgram);
+                glDisableVertexAttribArray(program->aColorPointer);
+
+            restoreProgram(*program);
         }
 
 
         void GLES20FixedPipeline::drawGenericVectorImpl(int mode, int count, int type, const void *indices, bool useColorPtr) {
-            int aColorPointerHandle = 0;
-            int programHandle = getGenericVectorProgram(vertexPointer.size, false);
-            int prevProgram;
-            glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
-            glUseProgram(programHandle);
+            Program *program = getGenericVectorProgram(vertexPointer.size, false);
+            if (!program)
+                return;
+
+            bindProgram(*program);
 
             float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
             readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
+            program->uniformMatrix4fv(program->uProjection, program->projection, p);
             CHECKERRS();
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
             readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            program->uniformMatrix4fv(program->uModelView, program->modelView, p);
             CHECKERRS();
 
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            glEnableVertexAttribArray(aVertexCoordsHandle);
+            glEnableVertexAttribArray(program->aVertexCoords);
 
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
 
             if (!useColorPtr) {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
+                program->uniform4f(program->uColor, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
             } else {
-                aColorPointerHandle = glGetAttribLocation(programHandle, "aColorPointer");
-                glEnableVertexAttribArray(aColorPointerHandle);
+                glEnableVertexAttribArray(program->aColorPointer);
 
-                setVertexAttribPointer(aColorPointerHandle, &colorPointer, true);
+                setVertexAttribPointer(program->aColorPointer, &colorPointer, true);
             }
             CHECKERRS();
 
             ::glDrawElements(mode, count, type, indices);
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
+            glDisableVertexAttribArray(program->aVertexCoords);
             if (useColorPtr)
-                glDisableVertexAttribArray(aColorPointerHandle);
-            glUseProgram(prevProgram);
+                glDisableVertexAttribArray(program->aColorPointer);
 
+            restoreProgram(*program);
         }
 
 
         void GLES20FixedPipeline::drawBoundTexture(int mode, int textureUnit, int first, int count)
         {
             bool colorize = (curAttribs.r != 1.0f || curAttribs.g != 1.0f || curAttribs.b != 1.0f || curAttribs.a != 1.0f);
-            int programHandle = getGenericTextureProgram(vertexPointer.size, texCoordPointer.size,
-                                                         colorize);
+            Program *program = getGenericTextureProgram(vertexPointer.size, texCoordPointer.size,
+                                                        colorize);
             CHECKERRS();
-            int prevProgram;
-            glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
-            glUseProgram(programHandle);
+            if (!program)
+                return;
 
-            CHECKERRS();
+            bindProgram(*program);
 
-            float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
-            readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
             CHECKERRS();
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
-            readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            bindTextureUniforms(*program, textureUnit, colorize);
             CHECKERRS();
 
-            int uTexMatrixHandle = glGetUniformLocation(programHandle, "uTexMatrix");
-            readMatrix(MatrixMode::MM_GL_TEXTURE, p);
-            glUniformMatrix4fv(uTexMatrixHandle, 1, false, p);
-            CHECKERRS();
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
 
-            int uTextureHandle = glGetUniformLocation(programHandle, "uTexture");
-            glUniform1i(uTextureHandle, textureUnit);
+            glEnableVertexAttribArray(program->aVertexCoords);
             CHECKERRS();
 
-            if (colorize) {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
-            }
-            CHECKERRS();
-
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            int aTextureCoordsHandle = glGetAttribLocation(programHandle, "aTextureCoords");
-            CHECKERRS();
-
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
-
-            glEnableVertexAttribArray(aVertexCoordsHandle);
-            CHECKERRS();
-
-            setVertexAttribPointer(aTextureCoordsHandle, &texCoordPointer, false);
-            glEnableVertexAttribArray(aTextureCoordsHandle);
+            setVertexAttribPointer(program->aTextureCoords, &texCoordPointer, false);
+            glEnableVertexAttribArray(program->aTextureCoords);
             CHECKERRS();
 
             ::glDrawArrays(mode, first, count);
             CHECKERRS();
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
-            glDisableVertexAttribArray(aTextureCoordsHandle);
+            glDisableVertexAttribArray(program->aVertexCoords);
+            glDisableVertexAttribArray(program->aTextureCoords);
             CHECKERRS();
-            glUseProgram(prevProgram);
+
+            restoreProgram(*program);
         }
 
         void GLES20FixedPipeline::drawBoundTexture(int mode, int textureUnit, int count, int type, const void *indices)
         {
             bool colorize = (curAttribs.r != 1.0f || curAttribs.g != 1.0f || curAttribs.b != 1.0f || curAttribs.a != 1.0f);
-            int programHandle = getGenericTextureProgram(vertexPointer.size, texCoordPointer.size, colorize);
-            glUseProgram(programHandle);
+            Program *program = getGenericTextureProgram(vertexPointer.size, texCoordPointer.size, colorize);
+            if (!program)
+                return;
 
-            float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
-            readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
-            CHECKERRS();
+            bindProgram(*program);
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
-            readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            bindTextureUniforms(*program, textureUnit, colorize);
             CHECKERRS();
 
-            int uTexMatrixHandle = glGetUniformLocation(programHandle, "uTexMatrix");
-            readMatrix(MatrixMode::MM_GL_TEXTURE, p);
-            glUniformMatrix4fv(uTexMatrixHandle, 1, false, p);
-            CHECKERRS();
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
 
-            int uTextureHandle = glGetUniformLocation(programHandle, "uTexture");
-            glUniform1i(uTextureHandle, textureUnit);
-            CHECKERRS();
+            glEnableVertexAttribArray(program->aVertexCoords);
 
-            if (colorize) {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
-            }
-            CHECKERRS();
-
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            int aTextureCoordsHandle = glGetAttribLocation(programHandle, "aTextureCoords");
-
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
-
-            glEnableVertexAttribArray(aVertexCoordsHandle);
-
-            setVertexAttribPointer(aTextureCoordsHandle, &texCoordPointer, false);
-            glEnableVertexAttribArray(aTextureCoordsHandle);
+            setVertexAttribPointer(program->aTextureCoords, &texCoordPointer, false);
+            glEnableVertexAttribArray(program->aTextureCoords);
 
             ::glDrawElements(mode, count, type, indices);
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
-            glDisableVertexAttribArray(aTextureCoordsHandle);
+            glDisableVertexAttribArray(program->aVertexCoords);
+            glDisableVertexAttribArray(program->aTextureCoords);
+
+            restoreProgram(*program);
         }
 
         void GLES20FixedPipeline::drawPoints(int textureUnit, int first, int count)
         {
-            int programHandle = getGenericPointProgram(vertexPointer.size, texCoordPointer.enabled);
+            Program *program = getGenericPointProgram(vertexPointer.size, texCoordPointer.enabled);
             CHECKERRS();
-            int prevProgram;
-            
-            glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
-            
-            glUseProgram(programHandle);
+            if (!program)
+                return;
+
+            bindProgram(*program);
 
             CHECKERRS();
 
-            float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
-            readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
+            bindPointUniforms(*program, textureUnit);
+
             CHECKERRS();
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
-            readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
             CHECKERRS();
 
             if (texCoordPointer.enabled) {
-                int uTexMatrixHandle = glGetUniformLocation(programHandle, "uTexMatrix");
-                readMatrix(MatrixMode::MM_GL_TEXTURE, p);
-                glUniformMatrix4fv(uTexMatrixHandle, 1, false, p);
+                // XXX - legacy comment: Texture coords aren't needed for GL_POINTS
+                setVertexAttribPointer(program->aTextureCoords, &texCoordPointer, false);
+                glEnableVertexAttribArray(program->aTextureCoords);
                 CHECKERRS();
+            }
 
-                int uTextureHandle = glGetUniformLocation(programHandle, "uTexture");
-                glUniform1i(uTextureHandle, textureUnit);
-                CHECKERRS();
-            } else {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
+            ::glDrawArrays(GL_POINTS, first, count);
+            CHECKERRS();
+
+            glDisableVertexAttribArray(program->aVertexCoords);
+            if (texCoordPointer.enabled) {
+                glDisableVertexAttribArray(program->aTextureCoords);
             }
             CHECKERRS();
 
-            int aPointSizeHandle = glGetUniformLocation(programHandle, "aPointSize");
-            glUniform1f(aPointSizeHandle, curAttribs.pointSize);
+            restoreProgram(*program);
+        }
 
-            CHECKERRS();
+        void GLES20FixedPipeline::drawPoints(int textureUnit, int count, int type, const void *indices)
+        {
+            Program *program = getGenericPointProgram(vertexPointer.size, texCoordPointer.enabled);
+            if (!program)
+                return;
 
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
-            CHECKERRS();
+            bindProgram(*program);
+
+            bindPointUniforms(*program, textureUnit);
+
+            setVertexAttribPointer(program->aVertexCoords, &vertexPointer, false);
+            glEnableVertexAttribArray(program->aVertexCoords);
 
-            int aTextureCoordsHandle = 0;
             if (texCoordPointer.enabled) {
-                // XXX - legacy comment: Texture coords aren't needed for GL_POINTS
-                aTextureCoordsHandle = glGetAttribLocation(programHandle, "aTextureCoords");
-                setVertexAttribPointer(aTextureCoordsHandle, &texCoordPointer, false);
-                glEnableVertexAttribArray(aTextureCoordsHandle);
-                CHECKERRS();
+                setVertexAttribPointer(program->aTextureCoords, &texCoordPointer, false);
+                glEnableVertexAttribArray(program->aTextureCoords);
             }
 
-            ::glDrawArrays(GL_POINTS, first, count);
-            CHECKERRS();
+            ::glDrawElements(GL_POINTS, count, type, indices);
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
+            glDisableVertexAttribArray(program->aVertexCoords);
             if (texCoordPointer.enabled) {
-                glDisableVertexAttribArray(aTextureCoordsHandle);
+                glDisableVertexAttribArray(program->aTextureCoords);
             }
-            glUseProgram(prevProgram);
-            CHECKERRS();
+
+            restoreProgram(*program);
         }
 
-        void GLES20FixedPipeline::drawPoints(int textureUnit, int count, int type, const void *indices)
+        void GLES20FixedPipeline::bindProgram(const Program &program)
         {
-            int programHandle = getGenericPointProgram(vertexPointer.size, texCoordPointer.enabled);
-            glUseProgram(programHandle);
+            if (program.program != static_cast<int>(currentProgram))
+                ::glUseProgram(program.program);
+        }
 
+        void GLES20FixedPipeline::restoreProgram(const Program &program)
+        {
+            if (program.program != static_cast<int>(currentProgram))
+                ::glUseProgram(currentProgram);
+        }
+
+        void GLES20FixedPipeline::bindTextureUniforms(Program &program, int textureUnit, bool colorize)
+        {
             float p[16];
-            int uProjectionHandle = glGetUniformLocation(programHandle, "uProjection");
             readMatrix(MatrixMode::MM_GL_PROJECTION, p);
-            glUniformMatrix4fv(uProjectionHandle, 1, false, p);
+            program.uniformMatrix4fv(program.uProjection, program.projection, p);
             CHECKERRS();
 
-            int uModelViewHandle = glGetUniformLocation(programHandle, "uModelView");
             readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
-            glUniformMatrix4fv(uModelViewHandle, 1, false, p);
+            program.uniformMatrix4fv(program.uModelView, program.modelView, p);
             CHECKERRS();
 
-            if (texCoordPointer.enabled) {
-                int uTexMatrixHandle = glGetUniformLocation(programHandle, "uTexMatrix");
-                readMatrix(MatrixMode::MM_GL_TEXTURE, p);
-                glUniformMatrix4fv(uTexMatrixHandle, 1, false, p);
-                CHECKERRS();
-                int uTextureHandle = glGetUniformLocation(programHandle, "uTexture");
-                glUniform1i(uTextureHandle, textureUnit);
-                CHECKERRS();
-            } else {
-                int uColorHandle = glGetUniformLocation(programHandle, "uColor");
-                glUniform4f(uColorHandle, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
-            }
+            readMatrix(MatrixMode::MM_GL_TEXTURE, p);
+            program.uniformMatrix4fv(program.uTexMatrix, program.texMatrix, p);
             CHECKERRS();
 
-            int aPointSizeHandle = glGetUniformLocation(programHandle, "aPointSize");
-            glUniform1f(aPointSizeHandle, curAttribs.pointSize);
+            program.uniform1i(program.uTexture, textureUnit);
+            CHECKERRS();
 
-            int aVertexCoordsHandle = glGetAttribLocation(programHandle, "aVertexCoords");
-            setVertexAttribPointer(aVertexCoordsHandle, &vertexPointer, false);
-            glEnableVertexAttribArray(aVertexCoordsHandle);
+            if (colorize)
+                program.uniform4f(program.uColor, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
+        }
 
-            int aTextureCoordsHandle = 0;
-            if (texCoordPointer.enabled) {
-                aTextureCoordsHandle = glGetAttribLocation(programHandle, "aTextureCoords");
-                setVertexAttribPointer(aTextureCoordsHandle, &texCoordPointer, false);
-                glEnableVertexAttribArray(aTextureCoordsHandle);
-            }
+        void GLES20FixedPipeline::bindPointUniforms(Program &program, int textureUnit)
+        {
+            float p[16];
+            readMatrix(MatrixMode::MM_GL_PROJECTION, p);
+            program.uniformMatrix4fv(program.uProjection, program.projection, p);
+            CHECKERRS();
 
-            ::glDrawElements(GL_POINTS, count, type, indices);
+            readMatrix(MatrixMode::MM_GL_MODELVIEW, p);
+            program.uniformMatrix4fv(program.uModelView, program.modelView, p);
+            CHECKERRS();
 
-            glDisableVertexAttribArray(aVertexCoordsHandle);
             if (texCoordPointer.enabled) {
-                glDisableVertexAttribArray(aTextureCoordsHandle);
+                readMatrix(MatrixMode::MM_GL_TEXTURE, p);
+                program.uniformMatrix4fv(program.uTexMatrix, program.texMatrix, p);
+                CHECKERRS();
+
+                program.uniform1i(program.uTexture, textureUnit);
+                CHECKERRS();
+            } else {
+                program.uniform4f(program.uColor, curAttribs.r, curAttribs.g, curAttribs.b, curAttribs.a);
             }
-        }
+            CHECKERRS();
 
-        int GLES20FixedPipeline::getGenericVectorProgram(int size, bool colorize)
+            program.uniform1f(program.uPointSize, curAttribs.pointSize);
+        }
+        Program *GLES20FixedPipeline::getGenericVectorProgram(int size, bool colorize)
         {
             int colorFlags = colorize ? 0x00 : 0x01;
             int programFlags = colorFlags | (size << 1);
@@ -957,7 +911,7 @@ namespace atakmap
                         vertShaderSource = COLOR_POINTER_VECTOR_3D_VERT_SHADER_SRC;
                         break;
                     default:
-                        return GL_FALSE;
+                        return nullptr;
                     }
                     fragShaderSource = COLOR_POINTER_VECTOR_FRAG_SHADER_SRC;
                 } else {
@@ -969,21 +923,21 @@ namespace atakmap
                         vertShaderSource = VECTOR_3D_VERT_SHADER_SRC;
                         break;
                     default:
-                        return GL_FALSE;
+                        return nullptr;
                     }
                     fragShaderSource = GENERIC_VECTOR_FRAG_SHADER_SRC;
                 }
                 p = new Program();
                 if (p->create(vertShaderSource, fragShaderSource) == GL_FALSE) {
                     delete p;
-                    return GL_FALSE;
+                    return nullptr;
                 }
                 vectorPrograms[programFlags] = p;
             }
-            return p->program;
+            return p;
         }
 
-        int GLES20FixedPipeline::getGenericPointProgram(int size, bool textured)
+        Program *GLES20FixedPipeline::getGenericPointProgram(int size, bool textured)
         {
             int texturedFlag = textured ? 0x01 : 0x00;
             int programFlags = (size << 1) | texturedFlag;
@@ -1000,7 +954,7 @@ namespace atakmap
                         vertShaderSource = TEXTURE_POINT_3D_VERT_SHADER_SRC;
                         break;
                     default:
-                        return GL_FALSE;
+                        return nullptr;
                     }
                     fragShaderSource = TEXTURED_POINT_FRAG_SHADER_SRC;
                 }
@@ -1013,24 +967,24 @@ namespace atakmap
                         vertShaderSource = POINT_3D_VERT_SHADER_SRC;
                         break;
                     default:
-                        return GL_FALSE;
+                        return nullptr;
                     }
                     fragShaderSource = POINT_FRAG_SHADER_SRC;
                 }
                 p = new Program();
                 if (p->create(vertShaderSource, fragShaderSource) == GL_FALSE) {
                     delete p;
-                    return GL_FALSE;
+                    return nullptr;
                 }
                 pointPrograms[programFlags] = p;
             }
-            return p->program;
+            return p;
         }
 
-        int GLES20FixedPipeline::getGenericTextureProgram(int vSize, int tcSize, bool colorize)
+        Program *GLES20FixedPipeline::getGenericTextureProgram(int vSize, int tcSize, bool colorize)
         {
             if ((tcSize != 4 && tcSize != 2) || vSize < 0 || vSize > 3)
-                return GL_FALSE;
+                return nullptr;
             int colorFlag = colorize ? 0x01 : 0x00;
             int programFlags = colorFlag | (0 << 1) | (vSize << 2) | (tcSize << 4);
             Program *p = texturePrograms[programFlags];
@@ -1044,7 +998,7 @@ namespace atakmap
                     vertShaderSource = (tcSize == 4) ? TEXTURE_3D_VERT_SHADER_SRC_PROJ : TEXTURE_3D_VERT_SHADER_SRC;
                     break;
                 default:
-                    return GL_FALSE;
+                    return nullptr;
                 }
                 const char *fragShaderSource;
                 if (colorize)
@@ -1057,11 +1011,11 @@ namespace atakmap
                 p = new Program();
                 if (p->create(vertShaderSource, fragShaderSource) == GL_FALSE) {
                     delete p;
-                    return GL_FALSE;
+                    return nullptr;
                 }
                 texturePrograms[programFlags] = p;
             }
-            return p->program;
+            return p;
         }
 
 
@@ -1104,8 +1058,11 @@ namespace atakmap
             delete [] matrices;
         }
 
-        Program::Program() : program(GL_FALSE), vertShader(GL_FALSE), fragShader(GL_FALSE)
+        Program::Program() : program(GL_FALSE), vertShader(GL_FALSE), fragShader(GL_FALSE),
+            uProjection(-1), uModelView(-1), uTexMatrix(-1), uTexture(-1), uColor(-1), uPointSize(-1),
+            aVertexCoords(-1), aTextureCoords(-1), aColorPointer(-1)
         {
+            invalidateUniforms();
         }
         Program::~Program()
         {
@@ -1131,9 +1088,81 @@ namespace atakmap
                 fragShader = vertShader = GL_FALSE;
                 return false;
             }
+            resolveLocations();
+            invalidateUniforms();
             return true;
         }
 
+        void Program::uniformMatrix4fv(int location, float *cached, const float *value)
+        {
+            if (location < 0)
+                return;
+            // compare by value, not bitwise, so that invalidated elements
+            // never match
+            std::size_t i = 0u;
+            while (i < 16u && cached[i] == value[i])
+                i++;
+            if (i == 16u)
+                return;
+            memcpy(cached, value, 16u*sizeof(float));
+            glUniformMatrix4fv(location, 1, false, value);
+        }
+
+        void Program::uniform4f(int location, float r, float g, float b, float a)
+        {
+            if (location < 0 || (color[0] == r && color[1] == g && color[2] == b && color[3] == a))
+                return;
+            color[0] = r;
+            color[1] = g;
+            color[2] = b;
+            color[3] = a;
+            glUniform4f(location, r, g, b, a);
+        }
+
+        void Program::uniform1f(int location, float value)
+        {
+            if (location < 0 || pointSize == value)
+                return;
+            pointSize = value;
+            glUniform1f(location, value);
+        }
+
+        void Program::uniform1i(int location, int value)
+        {
+            if (location < 0 || textureUnit == value)
+                return;
+            textureUnit = value;
+            glUniform1i(location, value);
+        }
+
+        void Program::resolveLocations()
+        {
+            uProjection = glGetUniformLocation(program, "uProjection");
+            uModelView = glGetUniformLocation(program, "uModelView");
+            uTexMatrix = glGetUniformLocation(program, "uTexMatrix");
+            uTexture = glGetUniformLocation(program, "uTexture");
+            uColor = glGetUniformLocation(program, "uColor");
+            uPointSize = glGetUniformLocation(program, "aPointSize");
+            aVertexCoords = glGetAttribLocation(program, "aVertexCoords");
+            aTextureCoords = glGetAttribLocation(program, "aTextureCoords");
+            aColorPointer = glGetAttribLocation(program, "aColorPointer");
+        }
+
+        void Program::invalidateUniforms()
+        {
+            // NAN compares unequal to every value, including NAN, so the next
+            // upload of each float value is never skipped
+            for (std::size_t i = 0u; i < 16u; i++) {
+                projection[i] = NAN;
+                modelView[i] = NAN;
+                texMatrix[i] = NAN;
+            }
+            for (std::size_t i = 0u; i < 4u; i++)
+                color[i] = NAN;
+            pointSize = NAN;
+            textureUnit = -1;
+        }
+
         int Program::loadShader(const char *src, int type)
         {
             using namespace atakmap::util;
@@ -1212,6 +1241,9 @@ namespace atakmap
                 glDeleteShader(fragShader);
                 program = vertShader = fragShader = GL_FALSE;
             }
+            uProjection = uModelView = uTexMatrix = uTexture = uColor = uPointSize = -1;
+            aVertexCoords = aTextureCoords = aColorPointer = -1;
+            invalidateUniforms();
         }
 
         FPGLSettings::FPGLSettings() : r(1), g(1), b(1), a(1), pointSize(1) {
@@ -49,16 +49,47 @@ namespace atakmap
             int vertShader;
             int fragShader;
 
+            // uniform and attribute locations, resolved once on create; -1 if
+            // the program does not declare the variable
+            int uProjection;
+            int uModelView;
+            int uTexMatrix;
+            int uTexture;
+            int uColor;
+            int uPointSize;
+            int aVertexCoords;
+            int aTextureCoords;
+            int aColorPointer;
+
+            // the values last uploaded to the program's uniforms. Uniform
+            // values are per program object, so these can only go stale if
+            // the program is modified outside of this class.
+            float projection[16];
+            float modelView[16];
+            float texMatrix[16];
+            float color[4];
+            float pointSize;
+            int textureUnit;
+
             Program();
             ~Program();
             bool create(const char *vertSrc, const char *fragSrc);
             void destroy();
 
+            // upload the value to the uniform at the location if it differs
+            // from the value last uploaded; the program must be current
+            void uniformMatrix4fv(int location, float *cached, const float *value);
+            void uniform4f(int location, float r, float g, float b, float a);
+            void uniform1f(int location, float value);
+            void uniform1i(int location, int value);
+
             static int loadShader(const char *src, int type);
             static int createProgram(int vertShader, int fragShader);
 
         private:
             int createProgram();
+            void resolveLocations();
+            void invalidateUniforms();
         };
 
         struct FPGLSettings {
@@ -123,6 +154,14 @@ namespace atakmap
             float getPointSize();
             void glPointSize(float size);
             void glLineWidth(float w);
+            /**
+             * Binds the program and records it as the program to be
+             * restored after each draw issued through the pipeline. Engine
+             * code must bind its programs through this method rather than
+             * calling glUseProgram directly. Binding the program already
+             * bound is a no-op.
+             */
+            void glUseProgram(unsigned int program);
 
             // Equiv to glPushAttrib(GL_ALL_ATTRIB_BITS)
             void pushAllAttribs();
@@ -148,10 +187,17 @@ namespace atakmap
             void drawPoints(int textureUnit, int first, int count);
             void drawPoints(int textureUnit, int count, int type, const void *indices);
 
+            // bind the program for a draw, and restore the caller's program
+            // after it; neither binds if the caller's program is the same
+            void bindProgram(const Program &program);
+            void restoreProgram(const Program &program);
 
-            int getGenericVectorProgram(int size, bool colorize);
-            int getGenericTextureProgram(int size, int tsize, bool colorize);
-            int getGenericPointProgram(int size, bool textured);
+            void bindTextureUniforms(Program &program, int textureUnit, bool colorize);
+            void bindPointUniforms(Program &program, int textureUnit);
+
+            Program *getGenericVectorProgram(int size, bool colorize);
+            Program *getGenericTextureProgram(int size, int tsize, bool colorize);
+            Program *getGenericPointProgram(int size, bool textured);
 
             MatrixStack *modelView;
             MatrixStack *projection;
@@ -174,6 +220,11 @@ namespace atakmap
 
             bool tex2DEnabled;
 
+            // the line width last set through glLineWidth, in pixels
+            float lineWidth;
+            // the program last bound through glUseProgram
+            unsigned int currentProgram;
+
             friend class GLLinesEmulation;
         };
     }
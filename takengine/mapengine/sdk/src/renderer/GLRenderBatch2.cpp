@@ -427,7 +427,7 @@ TAKErr GLRenderBatch2::flush() NOTHROWS
         else
             program = textured ? &texturedProgram3d : &untexturedProgram3d;
 
-        glUseProgram(program->handle);
+        GLES20FixedPipeline::getInstance()->glUseProgram(program->handle);
 
         // if hardware rendering,
         if (!hasBits(this->batchHints, GLRenderBatch2::SoftwareTransforms)) {
@@ -2083,7 +2083,7 @@ TAKErr GLRenderBatch2::batchProgramInit(batch_render_program_t *program, const b
     TE_CHECKRETURN_CODE(code);
 
     program->handle = p.program;
-    glUseProgram(p.program);
+    GLES20FixedPipeline::getInstance()->glUseProgram(p.program);
 
     program->uProjectionHandle = glGetUniformLocation(program->handle, "uProjection");
     program->uModelViewHandle = glGetUniformLocation(program->handle, "uModelView");
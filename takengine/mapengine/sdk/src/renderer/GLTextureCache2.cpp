@@ -1,6 +1,7 @@
 #include "renderer/GLTextureCache2.h"
 
 #include <cmath>
+#include <limits>
 
 using namespace TAK::Engine::Renderer;
 
@@ -11,13 +12,16 @@ GLTextureCache2::GLTextureCache2(const std::size_t maxSize_) NOTHROWS :
     tail(nullptr),
     maxSize(maxSize_),
     size(0u),
-    count(0u)
+    count(0u),
+    trimTarget(std::numeric_limits<std::size_t>::max()),
+    budget("GLTextureCache2", maxSize_, requestTrim, this)
 {}
 
 GLTextureCache2::~GLTextureCache2()
 {
     // clear the map and clean up allocations, but do NOT release GL resources
     nodeMap.clear();
+    idMap.clear();
     while (head != nullptr) {
         BidirectionalNode *n = head;
 
@@ -53,16 +57,21 @@ TAKErr GLTextureCache2::deleteEntry(const char *key) NOTHROWS
 
 TAKErr GLTextureCache2::remove(GLTextureCache2::EntryPtr &val, const char *key) NOTHROWS
 {
-    TAKErr code;
-
-    code = TE_Ok;
-
     auto entry = nodeMap.find(key);
     if (entry == nodeMap.end())
         return TE_InvalidArg;
 
     BidirectionalNode *node = entry->second;
     nodeMap.erase(entry);
+    return removeNode(val, node);
+}
+
+TAKErr GLTextureCache2::removeNode(GLTextureCache2::EntryPtr &val, BidirectionalNode *node) NOTHROWS
+{
+    TAKErr code;
+
+    code = TE_Ok;
+
     val = std::move(node->value);
 
     if (node->prev != nullptr) {
@@ -90,6 +99,7 @@ TAKErr GLTextureCache2::remove(GLTextureCache2::EntryPtr &val, const char *key)
         code = sizeOf(&texSize, *val->texture);
         TE_CHECKRETURN_CODE(code);
         size -= texSize + val->opaqueSize;
+        budget.setBytes(size);
     }
 
     return code;
@@ -114,8 +124,70 @@ TAKErr GLTextureCache2::put(const char *key, EntryPtr &&value) NOTHROWS
     }
 
     std::unique_ptr<BidirectionalNode> nodePtr(new BidirectionalNode(tail, key, std::move(value)));
-    BidirectionalNode *node = nodePtr.get();
-    nodeMap.insert(std::pair<std::string, BidirectionalNode *>(key, nodePtr.release()));
+    nodeMap.insert(std::pair<std::string, BidirectionalNode *>(key, nodePtr.get()));
+    return insertNode(std::move(nodePtr), texSize);
+}
+
+TAKErr GLTextureCache2::get(const GLTextureCache2::Entry **value, const uint64_t key) const NOTHROWS
+{
+    auto entry = idMap.find(key);
+    if (entry == idMap.end())
+        return TE_InvalidArg;
+
+    *value = entry->second->value.get();
+    return TE_Ok;
+}
+
+TAKErr GLTextureCache2::deleteEntry(const uint64_t key) NOTHROWS
+{
+    TAKErr code;
+    GLTextureCache2::EntryPtr entry(nullptr, nullptr);
+    code = this->remove(entry, key);
+    TE_CHECKRETURN_CODE(code);
+    if (entry->texture.get())
+        entry->texture->release();
+    return code;
+}
+
+TAKErr GLTextureCache2::remove(GLTextureCache2::EntryPtr &val, const uint64_t key) NOTHROWS
+{
+    auto entry = idMap.find(key);
+    if (entry == idMap.end())
+        return TE_InvalidArg;
+
+    BidirectionalNode *node = entry->second;
+    idMap.erase(entry);
+    return removeNode(val, node);
+}
+
+TAKErr GLTextureCache2::put(const uint64_t key, EntryPtr &&value) NOTHROWS
+{
+    TAKErr code;
+
+    // if there is already an entry we will replace it
+    if (this->idMap.find(key) != this->idMap.end()) {
+        code = deleteEntry(key);
+        if (code == TE_InvalidArg)
+            code = TE_Ok;
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    std::size_t texSize = 0u;
+    if (value->texture.get()) {
+        code = sizeOf(&texSize, *value->texture);
+        TE_CHECKRETURN_CODE(code);
+    }
+
+    std::unique_ptr<BidirectionalNode> nodePtr(new BidirectionalNode(tail, key, std::move(value)));
+    idMap.insert(std::pair<uint64_t, BidirectionalNode *>(key, nodePtr.get()));
+    return insertNode(std::move(nodePtr), texSize);
+}
+
+TAKErr GLTextureCache2::insertNode(std::unique_ptr<BidirectionalNode> &&nodePtr, const std::size_t texSize) NOTHROWS
+{
+    TAKErr code;
+
+    BidirectionalNode *node = nodePtr.release();
     if (head == nullptr)
         head = node;
     tail = node;
@@ -132,6 +204,7 @@ TAKErr GLTextureCache2::put(const char *key, EntryPtr &&value) NOTHROWS
 TAKErr GLTextureCache2::clear() NOTHROWS
 {
     nodeMap.clear();
+    idMap.clear();
     while (head != nullptr) {
         BidirectionalNode *n = head;
 
@@ -143,18 +216,31 @@ TAKErr GLTextureCache2::clear() NOTHROWS
     }
     tail = nullptr;
     size = 0u;
+    budget.setBytes(size);
 
     return TE_Ok;
 }
 
+TAKErr GLTextureCache2::applyPendingTrim() NOTHROWS
+{
+    if (trimTarget.load() == std::numeric_limits<std::size_t>::max())
+        return TE_Ok;
+    return trimToSize();
+}
+
 TAKErr GLTextureCache2::trimToSize() NOTHROWS
 {
     TAKErr code;
 
     code = TE_Ok;
 
+    // apply any outstanding request to trim below the configured size
+    std::size_t limit = trimTarget.exchange(std::numeric_limits<std::size_t>::max());
+    if (limit > maxSize)
+        limit = maxSize;
+
     std::size_t releasedSize;
-    while (size > maxSize && nodeMap.size() > 1) {
+    while (size > limit && count > 1u) {
         BidirectionalNode *n = head;
         if (n->value->texture.get()) {
             code = sizeOf(&releasedSize, *n->value->texture);
@@ -163,7 +249,10 @@ TAKErr GLTextureCache2::trimToSize() NOTHROWS
         } else {
             releasedSize = n->value->opaqueSize;
         }
-        nodeMap.erase(head->key);
+        if (head->hasId)
+            idMap.erase(head->id);
+        else
+            nodeMap.erase(head->key);
         head = head->next;
         head->prev = nullptr;
         count--;
@@ -172,11 +261,22 @@ TAKErr GLTextureCache2::trimToSize() NOTHROWS
         delete n;
         size -= releasedSize;
     }
+    budget.setBytes(size);
     TE_CHECKRETURN_CODE(code);
 
     return code;
 }
 
+TAKErr GLTextureCache2::requestTrim(void *opaque, const std::size_t targetBytes) NOTHROWS
+{
+    // GL resources may only be released on the owning thread
+    GLTextureCache2 &cache = *static_cast<GLTextureCache2 *>(opaque);
+    std::size_t current = cache.trimTarget.load();
+    while (targetBytes < current && !cache.trimTarget.compare_exchange_weak(current, targetBytes))
+        ;
+    return TE_Ok;
+}
+
 TAKErr GLTextureCache2::sizeOf(std::size_t *value, const GLTexture2 &texture) NOTHROWS
 {
     int bytesPerPixel;
@@ -215,6 +315,20 @@ GLTextureCache2::BidirectionalNode::BidirectionalNode(BidirectionalNode *prev_,
     prev(prev_),
     next(nullptr),
     key(key_),
+    id(0u),
+    hasId(false),
+    value(std::move(value_))
+{
+    if (prev != nullptr)
+        prev->next = this;
+}
+
+GLTextureCache2::BidirectionalNode::BidirectionalNode(BidirectionalNode *prev_, const uint64_t id_, EntryPtr &&value_) NOTHROWS :
+    prev(prev_),
+    next(nullptr),
+    key(),
+    id(id_),
+    hasId(true),
     value(std::move(value_))
 {
     if (prev != nullptr)
@@ -1,14 +1,17 @@
 #ifndef TAK_ENGINE_RENDERER_GLTEXTURECACHE2_H_INCLUDED
 #define TAK_ENGINE_RENDERER_GLTEXTURECACHE2_H_INCLUDED
 
+#include <atomic>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include "renderer/GL.h"
 
 #include "port/Platform.h"
 #include "renderer/GLTexture2.h"
 #include "renderer/Bitmap2.h"
+#include "util/MemoryAccounting.h"
 
 namespace TAK {
     namespace Engine {
@@ -31,17 +34,44 @@ namespace TAK {
                 Util::TAKErr put(const char *key, EntryPtr &&value) NOTHROWS;
                 Util::TAKErr clear() NOTHROWS;
                 Util::TAKErr deleteEntry(const char *key) NOTHROWS;
+
+                /**
+                 * Integer keyed variants of get, remove, put and deleteEntry. Integer keys
+                 * are a separate namespace from string keys; entries of both share the
+                 * same size budget and eviction order.
+                 */
+                Util::TAKErr get(const Entry **value, const uint64_t key) const NOTHROWS;
+                Util::TAKErr remove(EntryPtr &value, const uint64_t key) NOTHROWS;
+                Util::TAKErr put(const uint64_t key, EntryPtr &&value) NOTHROWS;
+                Util::TAKErr deleteEntry(const uint64_t key) NOTHROWS;
+
+                /**
+                 * Applies any outstanding request from memory accounting to
+                 * trim the cache. Must be invoked on the owning thread; the
+                 * map view invokes it once per frame.
+                 */
+                Util::TAKErr applyPendingTrim() NOTHROWS;
             public :
                 static Util::TAKErr sizeOf(std::size_t *value, const GLTexture2 &texture) NOTHROWS;
             private:
                 Util::TAKErr trimToSize() NOTHROWS;
+                Util::TAKErr insertNode(std::unique_ptr<BidirectionalNode> &&node, const std::size_t texSize) NOTHROWS;
+                Util::TAKErr removeNode(EntryPtr &value, BidirectionalNode *node) NOTHROWS;
+                static Util::TAKErr requestTrim(void *opaque, const std::size_t targetBytes) NOTHROWS;
             private :
                 std::map<std::string, BidirectionalNode *> nodeMap;
+                std::unordered_map<uint64_t, BidirectionalNode *> idMap;
                 BidirectionalNode *head;
                 BidirectionalNode *tail;
                 std::size_t maxSize;
                 std::size_t size;
                 std::size_t count;
+                /**
+                 * size requested by memory accounting; applied on the owning
+                 * thread by the next frame or insert
+                 */
+                std::atomic<std::size_t> trimTarget;
+                Util::MemoryBudget budget;
             };
 
             struct GLTextureCache2::BidirectionalNode
@@ -49,9 +79,12 @@ namespace TAK {
                 BidirectionalNode *prev;
                 BidirectionalNode *next;
                 std::string key;
+                uint64_t id;
+                bool hasId;
                 GLTextureCache2::EntryPtr value;
 
                 BidirectionalNode(BidirectionalNode *prev, std::string key, EntryPtr &&value) NOTHROWS;
+                BidirectionalNode(BidirectionalNode *prev, const uint64_t id, EntryPtr &&value) NOTHROWS;
             };
 
             struct ENGINE_API GLTextureCache2::Entry
@@ -42,4 +42,28 @@ TAKErr TAK::Engine::Renderer::GLWorkers_doGLThreadWork() NOTHROWS {
 		return TE_Err;
 	worker->doAnyWork(INT64_MAX);
 	return TE_Ok;
-}
\ No newline at end of file
+}
+
+SharedWorkerPtr TAK::Engine::Renderer::GLWorkers_glThread(int priority, int64_t estimatedCostMicros) NOTHROWS {
+	SharedWorkerPtr worker;
+	if (Worker_createPrioritized(worker, globalGLThreadWorker(), priority, estimatedCostMicros) != TE_Ok)
+		return globalGLThreadWorker();
+	return worker;
+}
+
+TAKErr TAK::Engine::Renderer::GLWorkers_doGLThreadWork(int64_t microsecondBudget) NOTHROWS {
+	std::shared_ptr<ControlWorker> worker = globalGLThreadWorker();
+	if (!worker)
+		return TE_Err;
+	TAKErr code = worker->doBudgetedWork(microsecondBudget);
+	if (code == TE_Done)
+		return TE_Ok;
+	return code;
+}
+
+TAKErr TAK::Engine::Renderer::GLWorkers_getGLThreadStats(ControlWorkerStats &stats) NOTHROWS {
+	std::shared_ptr<ControlWorker> worker = globalGLThreadWorker();
+	if (!worker)
+		return TE_Err;
+	return worker->getStats(stats);
+}
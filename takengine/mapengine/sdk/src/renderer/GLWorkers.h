@@ -21,8 +21,30 @@ namespace TAK {
 
 			ENGINE_API TAK::Engine::Util::SharedWorkerPtr GLWorkers_glThread() NOTHROWS;
 
+			/**
+			 * Worker for GL thread work with a priority and estimated cost, for use with budgeted GL thread work.
+			 * Higher priority work is done first.
+			 *
+			 * @param priority the priority of the work; GLWorkers_glThread() uses 0
+			 * @param estimatedCostMicros the estimated time to do each unit of work in microseconds, 0 if unknown
+			 */
+			ENGINE_API TAK::Engine::Util::SharedWorkerPtr GLWorkers_glThread(int priority, int64_t estimatedCostMicros) NOTHROWS;
+
 			ENGINE_API TAK::Engine::Util::TAKErr GLWorkers_doGLThreadWork() NOTHROWS;
 
+			/**
+			 * Do GL thread work until none remains or the per-frame budget is used up. Work that does not fit is
+			 * deferred to the next call.
+			 *
+			 * @return TE_Ok when all work was done, TE_TimedOut when work was deferred
+			 */
+			ENGINE_API TAK::Engine::Util::TAKErr GLWorkers_doGLThreadWork(int64_t microsecondBudget) NOTHROWS;
+
+			/**
+			 * Get the accounting for budgeted GL thread work.
+			 */
+			ENGINE_API TAK::Engine::Util::TAKErr GLWorkers_getGLThreadStats(TAK::Engine::Util::ControlWorkerStats &stats) NOTHROWS;
+
 
 		}
 	}
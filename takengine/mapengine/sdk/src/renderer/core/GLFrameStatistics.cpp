@@ -0,0 +1,139 @@
+#include "renderer/core/GLFrameStatistics.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace TAK::Engine::Renderer::Core;
+
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    int64_t systimeNanos() NOTHROWS
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int64_t percentile(const std::vector<int64_t> &sorted, const std::size_t p) NOTHROWS
+    {
+        // nearest-rank
+        std::size_t rank = (sorted.size()*p + 99u) / 100u;
+        if (rank)
+            rank--;
+        return sorted[rank];
+    }
+}
+
+GLFrameStatistics::Summary::Summary() NOTHROWS :
+    frames(0u),
+    minimumNanos(0LL),
+    p50Nanos(0LL),
+    p90Nanos(0LL),
+    p99Nanos(0LL),
+    maximumNanos(0LL),
+    meanNanos(0.0),
+    meanRenderPasses(0.0),
+    meanLayerDraws(0.0),
+    meanTerrainTiles(0.0)
+{}
+
+GLFrameStatistics::GLFrameStatistics(const std::size_t window_) NOTHROWS :
+    window(window_ ? window_ : 1u),
+    next(0u),
+    current(),
+    frameStart(0LL)
+{
+    current.nanos = 0LL;
+    current.renderPasses = 0u;
+    current.layerDraws = 0u;
+    current.terrainTiles = 0u;
+}
+GLFrameStatistics::~GLFrameStatistics() NOTHROWS
+{}
+
+void GLFrameStatistics::beginFrame() NOTHROWS
+{
+    current.renderPasses = 0u;
+    current.layerDraws = 0u;
+    current.terrainTiles = 0u;
+    frameStart = systimeNanos();
+}
+void GLFrameStatistics::endFrame() NOTHROWS
+{
+    current.nanos = systimeNanos() - frameStart;
+    if (frames.size() < window) {
+        try {
+            frames.push_back(current);
+        } catch (...) {
+            // the frame is not recorded
+        }
+    } else {
+        frames[next] = current;
+        next = (next + 1u) % window;
+    }
+}
+void GLFrameStatistics::renderPassDrawn() NOTHROWS
+{
+    current.renderPasses++;
+}
+void GLFrameStatistics::layerDrawn() NOTHROWS
+{
+    current.layerDraws++;
+}
+void GLFrameStatistics::setTerrainTiles(const std::size_t count) NOTHROWS
+{
+    current.terrainTiles = count;
+}
+TAKErr GLFrameStatistics::getSummary(Summary *value) const NOTHROWS
+{
+    if (!value)
+        return TE_InvalidArg;
+    if (frames.empty())
+        return TE_Done;
+
+    std::vector<int64_t> nanos;
+    try {
+        nanos.reserve(frames.size());
+    } catch (...) {
+        return TE_OutOfMemory;
+    }
+
+    Summary summary;
+    double totalNanos = 0.0;
+    double renderPasses = 0.0;
+    double layerDraws = 0.0;
+    double terrainTiles = 0.0;
+    for (auto it = frames.begin(); it != frames.end(); it++) {
+        nanos.push_back(it->nanos);
+        totalNanos += (double)it->nanos;
+        renderPasses += (double)it->renderPasses;
+        layerDraws += (double)it->layerDraws;
+        terrainTiles += (double)it->terrainTiles;
+    }
+    std::sort(nanos.begin(), nanos.end());
+
+    const double n = (double)frames.size();
+    summary.frames = frames.size();
+    summary.minimumNanos = nanos.front();
+    summary.p50Nanos = percentile(nanos, 50u);
+    summary.p90Nanos = percentile(nanos, 90u);
+    summary.p99Nanos = percentile(nanos, 99u);
+    summary.maximumNanos = nanos.back();
+    summary.meanNanos = totalNanos / n;
+    summary.meanRenderPasses = renderPasses / n;
+    summary.meanLayerDraws = layerDraws / n;
+    summary.meanTerrainTiles = terrainTiles / n;
+
+    *value = summary;
+    return TE_Ok;
+}
+void GLFrameStatistics::reset() NOTHROWS
+{
+    frames.clear();
+    next = 0u;
+}
+void GLFrameStatistics::setWindow(const std::size_t window_) NOTHROWS
+{
+    window = window_ ? window_ : 1u;
+    reset();
+}
@@ -0,0 +1,100 @@
+#ifndef TAK_ENGINE_RENDERER_CORE_GLFRAMESTATISTICS_H_INCLUDED
+#define TAK_ENGINE_RENDERER_CORE_GLFRAMESTATISTICS_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "port/Platform.h"
+#include "util/Error.h"
+
+namespace TAK
+{
+    namespace Engine
+    {
+        namespace Renderer
+        {
+            namespace Core
+            {
+                /**
+                 * Records the CPU cost of the most recent frames rendered by
+                 * a map view, along with the amount of work done per frame,
+                 * so that frame-time regressions may be measured by a driver
+                 * replaying a scripted camera path.
+                 *
+                 * <P>Frame time is the time spent on the render thread
+                 * issuing the frame; GPU execution is not included.
+                 *
+                 * <P>Not thread-safe; should only be accessed on the render
+                 * thread.
+                 */
+                class ENGINE_API GLFrameStatistics
+                {
+                public :
+                    struct ENGINE_API Summary
+                    {
+                        Summary() NOTHROWS;
+
+                        /** the number of frames summarized */
+                        std::size_t frames;
+                        /** frame times, in nanoseconds */
+                        int64_t minimumNanos;
+                        int64_t p50Nanos;
+                        int64_t p90Nanos;
+                        int64_t p99Nanos;
+                        int64_t maximumNanos;
+                        double meanNanos;
+                        /** mean per-frame counts */
+                        double meanRenderPasses;
+                        double meanLayerDraws;
+                        double meanTerrainTiles;
+                    };
+                private :
+                    struct Frame
+                    {
+                        int64_t nanos;
+                        std::size_t renderPasses;
+                        std::size_t layerDraws;
+                        std::size_t terrainTiles;
+                    };
+                public :
+                    /**
+                     * @param window    The number of most recent frames retained
+                     */
+                    GLFrameStatistics(const std::size_t window = 256u) NOTHROWS;
+                    ~GLFrameStatistics() NOTHROWS;
+                public :
+                    void beginFrame() NOTHROWS;
+                    void endFrame() NOTHROWS;
+                    /** records a render pass of the current frame */
+                    void renderPassDrawn() NOTHROWS;
+                    /** records a draw of a layer or basemap in the current frame */
+                    void layerDrawn() NOTHROWS;
+                    /** records the number of terrain tiles in the current frame */
+                    void setTerrainTiles(const std::size_t count) NOTHROWS;
+                    /**
+                     * Summarizes the retained frames. Returns
+                     * <code>TE_Done</code> if no frames have been recorded.
+                     */
+                    Util::TAKErr getSummary(Summary *value) const NOTHROWS;
+                    /** discards all recorded frames */
+                    void reset() NOTHROWS;
+                    /**
+                     * Sets the number of most recent frames retained. All
+                     * recorded frames are discarded.
+                     */
+                    void setWindow(const std::size_t window) NOTHROWS;
+                private :
+                    std::vector<Frame> frames;
+                    std::size_t window;
+                    /** the index of the next frame to be overwritten, once the window is full */
+                    std::size_t next;
+                    Frame current;
+                    int64_t frameStart;
+                };
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,6 @@
+#include "renderer/core/GLMapBatchable2.h"
+
+using namespace TAK::Engine::Renderer::Core;
+
+GLMapBatchable2::~GLMapBatchable2() NOTHROWS
+{}
@@ -0,0 +1,31 @@
+#ifndef TAK_ENGINE_RENDERER_GLMAPBATCHABLE2_H_INCLUDED
+#define TAK_ENGINE_RENDERER_GLMAPBATCHABLE2_H_INCLUDED
+
+#include "port/Platform.h"
+#include "util/Error.h"
+
+namespace TAK
+{
+    namespace Engine
+    {
+        namespace Renderer
+        {
+            class ENGINE_API GLRenderBatch2;
+
+            namespace Core
+            {
+                class ENGINE_API GLMapView2;
+
+                class ENGINE_API GLMapBatchable2
+                {
+                protected :
+                    virtual ~GLMapBatchable2() NOTHROWS = 0;
+                public:
+                    virtual Util::TAKErr batch(const GLMapView2& view, const int renderPass, GLRenderBatch2 &batch) NOTHROWS = 0;
+                };
+            }
+        }
+    }
+}
+
+#endif
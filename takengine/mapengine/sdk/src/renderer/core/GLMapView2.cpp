@@ -33,11 +33,13 @@
 #include "renderer/core/GLOffscreenVertex.h"
 #include "renderer/core/GLLayerFactory2.h"
 #include "renderer/core/GLLabelManager.h"
+#include "renderer/core/GLMapRenderGlobals.h"
 #include "renderer/elevation/ElMgrTerrainRenderService.h"
 #include "util/ConfigOptions.h"
 #include "util/Memory.h"
 #include "util/MathUtils.h"
 #include "util/Distance.h"
+#include "util/Tracing.h"
 
 using namespace TAK::Engine::Renderer::Core;
 
@@ -64,6 +66,8 @@ using namespace atakmap::renderer;
 
 #define DEFAULT_TILT_SKEW_OFFSET 1.2
 #define DEFAULT_TILT_SKEW_MULT 4.0
+// microseconds of GL thread work per frame, 0 for no limit
+#define DEFAULT_GL_THREAD_WORK_BUDGET 8000
 
 #if 0
 #define LLA2ECEF_FN_SRC \
@@ -390,7 +394,7 @@ namespace {
         TE_CHECKRETURN_CODE(code);
 
         value->base.handle = program.program;
-        glUseProgram(value->base.handle);
+        GLES20FixedPipeline::getInstance()->glUseProgram(value->base.handle);
         // vertex shader handles
         value->base.uMVP = glGetUniformLocation(value->base.handle, "uMVP");
         value->uModelViewOffscreen = glGetUniformLocation(value->base.handle, "uModelViewOffscreen");
@@ -560,6 +564,7 @@ GLMapView2::GLMapView2(RenderContext &ctx, AtakMapView &aview,
     suspendMeshFetch(false),
     tiltSkewOffset(DEFAULT_TILT_SKEW_OFFSET),
     tiltSkewMult(DEFAULT_TILT_SKEW_MULT),
+    glThreadWorkBudget(DEFAULT_GL_THREAD_WORK_BUDGET),
     displayDpi(aview.getDisplayDpi()),
     continuousScrollEnabled(aview.isContinuousScrollEnabled()),
     hardwareTransformResolutionThreshold(1.0),
@@ -658,6 +663,7 @@ TAKErr GLMapView2::start() NOTHROWS
 
     this->tiltSkewOffset = ConfigOptions_getDoubleOptionOrDefault("glmapview.tilt-skew-offset", DEFAULT_TILT_SKEW_OFFSET);
     this->tiltSkewMult = ConfigOptions_getDoubleOptionOrDefault("glmapview.tilt-skew-mult", DEFAULT_TILT_SKEW_MULT);
+    this->glThreadWorkBudget = ConfigOptions_getIntOptionOrDefault("glmapview.gl-thread-work-budget", DEFAULT_GL_THREAD_WORK_BUDGET);
 
     return TE_Ok;
 }
@@ -1383,18 +1389,33 @@ TAKErr GLMapView2::inverse(float *value, const size_t dstSize, const float *src,
 
 void GLMapView2::render() NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::render");
+
+    this->frameStatistics.beginFrame();
+
     const int64_t tick = Platform_systime_millis();
     if (this->animationLastTick)
         this->animationDelta = tick - this->animationLastTick;
     this->animationLastTick = tick;
     this->renderPump++;
 
+    // release textures if memory accounting requested a trim since the
+    // last frame
+    GLTextureCache2 *textureCache;
+    if (GLMapRenderGlobals_getTextureCache2(&textureCache, this->context) == TE_Ok)
+        textureCache->applyPendingTrim();
+
     this->prepareScene();
     this->drawRenderables();
+
+    this->frameStatistics.setTerrainTiles(this->offscreen.get() ? this->offscreen->terrainTiles.size() : 0u);
+    this->frameStatistics.endFrame();
 }
 
 void GLMapView2::prepareScene() NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::prepareScene");
+
     if (animate()) {
         drawVersion++;
         if (offscreen.get())
@@ -1424,7 +1445,13 @@ void GLMapView2::prepareScene() NOTHROWS
     }
 
 	GLWorkers_doResourceLoadingWork(30);
-    GLWorkers_doGLThreadWork();
+    if (this->glThreadWorkBudget > 0) {
+        // deferred work is picked up by the next frame
+        if (GLWorkers_doGLThreadWork(this->glThreadWorkBudget) == TE_TimedOut)
+            context.requestRefresh();
+    } else {
+        GLWorkers_doGLThreadWork();
+    }
 }
 
 int GLMapView2::getTerrainVersion() const NOTHROWS
@@ -1458,6 +1485,8 @@ TAKErr GLMapView2::visitTerrainTiles(TAKErr(*visitor)(void *opaque, const std::s
 
 void GLMapView2::drawRenderables() NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::drawRenderables");
+
     GLint range[2];
     GLint prec;
     glGetShaderPrecisionFormat(GL_VERTEX_SHADER, GL_MEDIUM_FLOAT, range, &prec);
@@ -1829,6 +1858,10 @@ void GLMapView2::drawRenderables() NOTHROWS
 
 void GLMapView2::drawRenderables(const GLMapView2::State &renderState) NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::renderPass");
+
+    this->frameStatistics.renderPassDrawn();
+
     // save the current view state
     State viewState;
     State_save(&viewState, *this);
@@ -1849,16 +1882,20 @@ void GLMapView2::drawRenderables(const GLMapView2::State &renderState) NOTHROWS
 
     // render the basemap and layers. this will always include the surface
     // pass and may also include the sprites pass
-    if (renderState.basemap && this->basemap.get())
+    if (renderState.basemap && this->basemap.get()) {
         this->basemap->draw(*this, renderState.renderPass);
+        this->frameStatistics.layerDrawn();
+    }
 
     std::list<std::shared_ptr<GLLayer2>>::iterator it;
     for (it = this->renderables.begin(); it != this->renderables.end(); it++) {
 #ifdef MSVC
         GLES20FixedPipeline::getInstance()->glMatrixMode(GLES20FixedPipeline::MatrixMode::MM_GL_MODELVIEW);
 #endif
-        if ((*it)->getRenderPass()&renderState.renderPass)
+        if ((*it)->getRenderPass()&renderState.renderPass) {
             (*it)->draw(*this, renderState.renderPass);
+            this->frameStatistics.layerDrawn();
+        }
     }
 
     // debug draw bounds if requested
@@ -1882,6 +1919,8 @@ void GLMapView2::drawRenderables(const GLMapView2::State &renderState) NOTHROWS
 
 void GLMapView2::drawTerrainTiles(const GLTexture2 &tex, const std::size_t drawSurfaceWidth, const std::size_t drawSurfaceHeight) NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::drawTerrainTiles");
+
     // XXX - select shader
     OffscreenShaders *shaders;
     Matrix2 localFrame[MAX_LOCAL_TRANSFORMS];
@@ -1940,7 +1979,7 @@ void GLMapView2::drawTerrainTiles(const GLTexture2 &tex, const std::size_t drawS
         (this->drawMapResolution <= shaders->md_threshold) ?
             shaders->md : shaders->lo;
 
-    glUseProgram(shader.base.handle);
+    GLES20FixedPipeline::getInstance()->glUseProgram(shader.base.handle);
     int activeTexture[1];
     glGetIntegerv(GL_ACTIVE_TEXTURE, activeTexture);
     glBindTexture(GL_TEXTURE_2D, tex.getTexId());
@@ -2002,11 +2041,13 @@ void GLMapView2::drawTerrainTiles(const GLTexture2 &tex, const std::size_t drawS
     }
     glDisable(GL_BLEND);
 
-    glUseProgram(0);
+    GLES20FixedPipeline::getInstance()->glUseProgram(0);
 }
 
 void GLMapView2::drawTerrainMeshes() NOTHROWS
 {
+    TE_TRACE_SPAN("GLMapView2::drawTerrainMeshes");
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -2068,7 +2109,7 @@ void GLMapView2::drawTerrainMeshes() NOTHROWS
         (this->drawMapResolution <= shaders->md_threshold) ?
             shaders->md : shaders->lo;
 
-    glUseProgram(shader.base.handle);
+    GLES20FixedPipeline::getInstance()->glUseProgram(shader.base.handle);
     int activeTexture[1];
     glGetIntegerv(GL_ACTIVE_TEXTURE, activeTexture);
     glBindTexture(GL_TEXTURE_2D, this->offscreen->whitePixel->getTexId());
@@ -2131,7 +2172,7 @@ void GLMapView2::drawTerrainMeshes() NOTHROWS
         State_restore(this, stack);
     }
 
-    glUseProgram(0);
+    GLES20FixedPipeline::getInstance()->glUseProgram(0);
 }
 
 void GLMapView2::drawTerrainMesh(const ElevationChunk::Data &tile) NOTHROWS
@@ -2426,6 +2467,11 @@ bool GLMapView2::animate() NOTHROWS
     return true;
 }
 
+GLFrameStatistics &GLMapView2::getFrameStatistics() NOTHROWS
+{
+    return this->frameStatistics;
+}
+
 TAKErr GLMapView2::getTerrainMeshElevation(double *value, const double latitude, const double longitude_) const NOTHROWS
 {
     TAKErr code(TE_InvalidArg);
@@ -3195,7 +3241,7 @@ namespace
         glDepthFunc(GL_ALWAYS);
 
         GLES20FixedPipeline::getInstance()->glColor4f(1, 0, 0, 1);
-        glLineWidth(8);
+        GLES20FixedPipeline::getInstance()->glLineWidth(8);
         GLES20FixedPipeline::getInstance()->glEnableClientState(GLES20FixedPipeline::ClientState::CS_GL_VERTEX_ARRAY);
         GLES20FixedPipeline::getInstance()->glVertexPointer(2, GL_FLOAT, 0, bb);
         GLES20FixedPipeline::getInstance()->glDrawArrays(GL_LINE_STRIP, 0, 7);
@@ -3218,7 +3264,7 @@ namespace
         bb[9] = scratchF.y;
 
         GLES20FixedPipeline::getInstance()->glColor4f(0, 0, 1, 1);
-        glLineWidth(8);
+        GLES20FixedPipeline::getInstance()->glLineWidth(8);
         GLES20FixedPipeline::getInstance()->glEnableClientState(GLES20FixedPipeline::ClientState::CS_GL_VERTEX_ARRAY);
         GLES20FixedPipeline::getInstance()->glVertexPointer(2, GL_FLOAT, 0, bb);
         GLES20FixedPipeline::getInstance()->glDrawArrays(GL_LINE_STRIP, 0, 5);
@@ -3243,7 +3289,7 @@ namespace
         bb[9] = scratchF.y;
 
         GLES20FixedPipeline::getInstance()->glColor4f(0, 1, 0, 1);
-        glLineWidth(8);
+        GLES20FixedPipeline::getInstance()->glLineWidth(8);
         GLES20FixedPipeline::getInstance()->glEnableClientState(GLES20FixedPipeline::ClientState::CS_GL_VERTEX_ARRAY);
         GLES20FixedPipeline::getInstance()->glVertexPointer(2, GL_FLOAT, 0, bb);
         GLES20FixedPipeline::getInstance()->glDrawArrays(GL_LINE_STRIP, 0, 5);
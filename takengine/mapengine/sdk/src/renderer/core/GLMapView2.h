@@ -21,6 +21,7 @@
 #include "util/Error.h"
 #include "renderer/GLTexture2.h"
 #include "renderer/core/GLAntiMeridianHelper.h"
+#include "renderer/core/GLFrameStatistics.h"
 #include "renderer/elevation/TerrainTile.h"
 #include "thread/RWMutex.h"
 
@@ -168,6 +169,12 @@ namespace TAK
                     GLLabelManager* getLabelManager() const NOTHROWS;
                     void render() NOTHROWS;
                     Util::TAKErr getTerrainMeshElevation(double *value, const double latitude, const double longitude) const NOTHROWS;
+                    /**
+                     * Returns the timing and workload of the most recently
+                     * rendered frames. Should only be accessed on the render
+                     * thread.
+                     */
+                    GLFrameStatistics &getFrameStatistics() NOTHROWS;
 #ifdef __ANDROID__
                     Elevation::TerrainRenderService &getTerrainRenderService() NOTHROWS;
 #endif
@@ -344,6 +351,8 @@ namespace TAK
                     bool suspendMeshFetch;
                     double tiltSkewOffset;
                     double tiltSkewMult;
+                    int64_t glThreadWorkBudget;
+                    GLFrameStatistics frameStatistics;
 #ifdef __ANDROID__
                 public :
 #endif
@@ -22,6 +22,7 @@
 #include "renderer/Skirt.h"
 #include "thread/Lock.h"
 #include "thread/Mutex.h"
+#include "util/Tracing.h"
 
 using namespace TAK::Engine::Renderer::Elevation;
 
@@ -890,6 +891,8 @@ namespace
     {
         TAKErr code(TE_Ok);
 
+        TE_TRACE_SPAN("ElMgrTerrainRenderService::fetch");
+
         if(fetchEl) {
 #ifndef _MSC_VER
             double *pts = els+(numPostsLat * numPostsLng);
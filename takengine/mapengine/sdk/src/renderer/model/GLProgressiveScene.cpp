@@ -60,6 +60,19 @@ namespace
 #endif
     }
 
+    // GL thread work is drained under a frame budget. A new draw state
+    // replaces what is on screen, so it goes ahead of other work; the scene
+    // load results only update the indicator and install the scene.
+    SharedWorkerPtr drawStateWorker() NOTHROWS {
+        static SharedWorkerPtr inst(GLWorkers_glThread(1, 0LL));
+        return inst;
+    }
+
+    SharedWorkerPtr sceneLoadedWorker() NOTHROWS {
+        static SharedWorkerPtr inst(GLWorkers_glThread(-1, 0LL));
+        return inst;
+    }
+
     class MeshBufferTextureLoader : public MaterialManager::TextureLoader {
     public:
         MeshBufferTextureLoader(const std::shared_ptr<const Mesh> &mesh) NOTHROWS;
@@ -444,10 +457,10 @@ void GLProgressiveScene::draw(const GLMapView2 &view, const int renderPass) NOTH
             sceneState->pendingScene = Task_begin(sceneLoadWorker(), loadScene, sceneState->info);
             sceneState->pendingScene
                 .thenOn(GeneralWorkers_cpu(), calculateSceneBoundsWGS84, sceneState->info)
-                .thenOn(GLWorkers_glThread(), updateIndicatorBounds, this->sceneState);
+                .thenOn(sceneLoadedWorker(), updateIndicatorBounds, this->sceneState);
             sceneState->pendingScene
-                .trapOn(GLWorkers_glThread(), setSceneLoadError, this->sceneState)
-                .thenOn(GLWorkers_glThread(), setScene, this->sceneState);
+                .trapOn(sceneLoadedWorker(), setSceneLoadError, this->sceneState)
+                .thenOn(sceneLoadedWorker(), setScene, this->sceneState);
         }
     } else if (sceneState->scene && (renderPass & GLMapView2::Sprites) != 0) {
         if (sceneState->pendingDrawState && wildyOffDrawState(view, this->drawViewState.sceneModel)) {
@@ -459,7 +472,7 @@ void GLProgressiveScene::draw(const GLMapView2 &view, const int renderPass) NOTH
             drawViewState.sceneModel = view.scene;
             drawViewState.displayResolution = view.drawMapResolution;
             sceneState->pendingDrawState = Task_begin(GeneralWorkers_cpu(), buildDrawState, this->sceneState, this->drawViewState, &sceneState->scene->getRootNode());
-            sceneState->pendingDrawState.thenOn(GLWorkers_glThread(), setDrawState, this->sceneState);
+            sceneState->pendingDrawState.thenOn(drawStateWorker(), setDrawState, this->sceneState);
         }
     }
 
@@ -0,0 +1,35 @@
+#include "renderer/raster/tilematrix/GLResidentTileIndex.h"
+
+using namespace TAK::Engine::Renderer::Raster::TileMatrix;
+
+GLResidentTileIndex::GLResidentTileIndex() NOTHROWS : tiles(), lookups(0u) {}
+
+GLResidentTileIndex::~GLResidentTileIndex() NOTHROWS {}
+
+void GLResidentTileIndex::insert(int zoom, int tileX, int tileY, GLTile *tile) NOTHROWS {
+    try {
+        tiles[key(zoom, tileX, tileY)] = tile;
+    } catch (...) {
+        // the tile is simply not available as a fallback
+    }
+}
+
+void GLResidentTileIndex::erase(int zoom, int tileX, int tileY, const GLTile *tile) NOTHROWS {
+    auto entry = tiles.find(key(zoom, tileX, tileY));
+    if (entry != tiles.end() && entry->second == tile) tiles.erase(entry);
+}
+
+GLTile *GLResidentTileIndex::find(int zoom, int tileX, int tileY) const NOTHROWS {
+    lookups++;
+    auto entry = tiles.find(key(zoom, tileX, tileY));
+    return (entry != tiles.end()) ? entry->second : nullptr;
+}
+
+std::size_t GLResidentTileIndex::size() const NOTHROWS { return tiles.size(); }
+
+std::size_t GLResidentTileIndex::getLookupCount() const NOTHROWS { return lookups; }
+
+uint64_t GLResidentTileIndex::key(int zoom, int tileX, int tileY) NOTHROWS {
+    // zoom | x | y ; 6 bits of zoom leaves 29 bits for each index
+    return ((uint64_t)(zoom & 0x3F) << 58) | ((uint64_t)(tileX & 0x1FFFFFFF) << 29) | (uint64_t)(tileY & 0x1FFFFFFF);
+}
@@ -0,0 +1,71 @@
+#ifndef TAK_ENGINE_RENDERER_TILEMATRIX_GLRESIDENTTILEINDEX_H_INCLUDED
+#define TAK_ENGINE_RENDERER_TILEMATRIX_GLRESIDENTTILEINDEX_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "port/Platform.h"
+
+namespace TAK {
+    namespace Engine {
+        namespace Renderer {
+            namespace Raster {
+                namespace TileMatrix {
+
+                    class GLTile;
+
+                    /**
+                     * Index of the tiles of a Tiled Map Layer that currently hold a texture,
+                     * keyed on (zoom, x, y). Tiles register themselves when they acquire a
+                     * texture and unregister when they give it up, so that a tile that is still
+                     * loading can find the nearest ancestor to draw in its place with one lookup
+                     * per zoom level, without registering with that ancestor.
+                     *
+                     * <P>Only accessed on the render thread.
+                     *
+                     * @author Developer
+                     *
+                     */
+                    class GLResidentTileIndex {
+                      private:
+                        std::unordered_map<uint64_t, GLTile *> tiles;
+                        mutable std::size_t lookups;
+
+                      public:
+                        GLResidentTileIndex() NOTHROWS;
+                        ~GLResidentTileIndex() NOTHROWS;
+
+                        /**
+                         * Marks the tile as resident.
+                         */
+                        void insert(int zoom, int tileX, int tileY, GLTile *tile) NOTHROWS;
+
+                        /**
+                         * Marks the tile as no longer resident. Has no effect if
+                         * <code>tile</code> is not the tile registered at the position.
+                         */
+                        void erase(int zoom, int tileX, int tileY, const GLTile *tile) NOTHROWS;
+
+                        /**
+                         * Returns the resident tile at the position, <code>nullptr</code> if none.
+                         */
+                        GLTile *find(int zoom, int tileX, int tileY) const NOTHROWS;
+
+                        std::size_t size() const NOTHROWS;
+
+                        /**
+                         * Returns the number of calls to <code>find</code> since construction.
+                         */
+                        std::size_t getLookupCount() const NOTHROWS;
+
+                      private:
+                        static uint64_t key(int zoom, int tileX, int tileY) NOTHROWS;
+                    };
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -5,16 +5,23 @@
 #include "math/Rectangle.h"
 #include "math/Utils.h"
 #include "renderer/GLES20FixedPipeline.h"
-#include "renderer/GLText2.h"
+#include "renderer/GLRenderBatch2.h"
 #include "util/MathUtils.h"
 #include "util/Logging2.h"
 
-#include <list>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 using namespace TAK::Engine::Renderer::Raster::TileMatrix;
 
+namespace {
+    // packed texture key layout, high to low: source | zoom | x | y
+    const int TEXTURE_ID_SOURCE_BITS = 12;
+    const int TEXTURE_ID_ZOOM_BITS = 6;
+    const int TEXTURE_ID_INDEX_BITS = 23;
+}
+
 GLTile::GLTile(GLTiledLayerCore *core, GLTilePatch *patch, int tileX, int tileY)
     : texturePtr(nullptr, TAK::Engine::Util::Memory_deleter_const<GLTexture2>),
       proj2uv(),
@@ -32,9 +39,14 @@ GLTile::GLTile(GLTiledLayerCore *core, GLTilePatch *patch, int tileX, int tileY)
       tileX(tileX),
       tileY(tileY),
       tileZ(patch->getParent()->info.level),
+      textureId(0u),
+      hasTextureId(false),
       textureKey(),
-      borrowers(),
-      tileVersion(-1) {
+      tileVersion(-1),
+      fallbackMesh(nullptr),
+      fallbackZ(-1),
+      fallbackX(-1),
+      fallbackY(-1) {
     Feature::Envelope2 tileBounds;
     TAK::Engine::Raster::TileMatrix::TileMatrix_getTileBounds(&tileBounds, *(core->matrix), tileZ, tileX, tileY);
     projMinX = tileBounds.minX;
@@ -42,7 +54,9 @@ GLTile::GLTile(GLTiledLayerCore *core, GLTilePatch *patch, int tileX, int tileY)
     projMaxX = tileBounds.maxX;
     projMaxY = tileBounds.maxY;
 
-    textureKey = getTileTextureKey(*core, tileZ, tileX, tileY);
+    hasTextureId = getTileTextureId(&textureId, *core, tileZ, tileX, tileY);
+    if (!hasTextureId)
+        textureKey = getTileTextureKey(*core, tileZ, tileX, tileY);
 
     // XXX - better way to do this
     GLTexture2 scratchTex(patch->getParent()->info.tileWidth, patch->getParent()->info.tileHeight, 0, 0);
@@ -61,118 +75,20 @@ GLTile::GLTile(GLTiledLayerCore *core, GLTilePatch *patch, int tileX, int tileY)
 }
 
 GLTile::~GLTile() NOTHROWS {
-    unborrow();
+    core->residentTiles.erase(tileZ, tileX, tileY, this);
+    delete fallbackMesh;
     delete mesh;
 }
 
-bool GLTile::hasBorrowers() { return !borrowers.empty(); }
-
 bool GLTile::hasTexture() { return texturePtr.get() != nullptr; }
 
-void GLTile::tryBorrow() {
-    typedef atakmap::math::Rectangle<double> RectD;
-
-    // the candidates we will try to borrow from
-    std::set<std::shared_ptr<GLTile>> candidates;
-
-    // a list of the "holes" that need to be filled via texture borrowing
-    std::list<RectD> holes;
-
-    // seed with the bounds of this tile
-    holes.push_back(RectD(projMinX, projMinY, projMaxX - projMinX, projMaxY - projMinY));
-
-    // a list of "bits" left over from holes that we have subtracted the
-    // intersection with a candidate from
-    std::list<RectD> bits;
-
-    // the remainders of subtracting a candidates bounds from a hole
-    RectD remainders[4];
-
-    // we will start borrowing from the previous zoom level
-    GLZoomLevel *borrowLvl = patch->getParent()->previous;
-
-    // while there are holes to be filled and we have a level to gather
-    // candidates from, search for textures to borrow
-    while (!holes.empty() && borrowLvl != nullptr) {
-        // discover all tiles in the level that intersect this tile's bounds
-        borrowLvl->getTiles(&candidates, projMinX, projMinY, projMaxX, projMaxY);
-
-        std::set<std::shared_ptr<GLTile>>::iterator iter;
-        for (iter = candidates.begin(); iter != candidates.end(); iter++) {
-            std::shared_ptr<GLTile> candidate = *iter;
-
-            // ensure we can borrow from the tile
-            if (candidate->state == UNRESOLVABLE) continue;
-
-            bits.clear();
-
-            auto holesIter = holes.begin();
-            while (holesIter != holes.end()) {
-                RectD hole = *holesIter;
-                auto curHolesIter = holesIter;
-                holesIter++;
-
-                if (RectD::intersects(hole.x, hole.y, hole.x + hole.width, hole.y + hole.height, candidate->projMinX, candidate->projMinY,
-                                      candidate->projMaxX, candidate->projMaxY)) {
-                    // compute the intersection
-                    const double isectMinX = atakmap::math::max(hole.x, candidate->projMinX);
-                    const double isectMinY = atakmap::math::max(hole.y, candidate->projMinY);
-                    const double isectMaxX = atakmap::math::min(hole.x + hole.width, candidate->projMaxX);
-                    const double isectMaxY = atakmap::math::min(hole.y + hole.height, candidate->projMaxY);
-
-                    // if the intersection is less than a pixel in either
-                    // dimension, ignore it
-                    if ((isectMaxX - isectMinX) <= candidate->patch->getParent()->info.pixelSizeX ||
-                        (isectMaxY - isectMinY) < candidate->patch->getParent()->info.pixelSizeY)
-                        continue;
-
-                    // subtract the coverage of the candidate tile from the
-                    // hole. each remainder will become a new hole.
-                    int num = RectD::subtract(hole.x, hole.y, hole.x + hole.width, hole.y + hole.height, candidate->projMinX,
-                                              candidate->projMinY, candidate->projMaxX, candidate->projMaxY, remainders);
-                    for (int i = 0; i < num; i++) {
-                        // ignore any remainders less than a pixel in either
-                        // dimension
-                        if (remainders[i].width <= candidate->patch->getParent()->info.pixelSizeX ||
-                            remainders[i].height <= candidate->patch->getParent()->info.pixelSizeY)
-                            continue;
-                        bits.push_back(remainders[i]);
-                    }
-
-                    // add a borrow record for the intersection
-                    borrowRecords.insert(new BorrowRecord(this, candidate, isectMinX, isectMinY, isectMaxX, isectMaxY));
-
-                    // remove the old hole
-                    holes.erase(curHolesIter);
-                }
-            }
-
-            // add all the remainders
-            holes.insert(holes.end(), bits.begin(), bits.end());
-        }
-
-        // clear the candidates list for the current level and move to the
-        // previous level
-        candidates.clear();
-        borrowLvl = borrowLvl->previous;
-    }
-}
-
-void GLTile::unborrow() {
-    std::set<BorrowRecord *>::iterator iter;
-    for (iter = borrowRecords.begin(); iter != borrowRecords.end(); ++iter) {
-        BorrowRecord *record = *iter;
-        delete record;
-    }
-    borrowRecords.clear();
-}
-
 bool GLTile::checkForCachedTexture() {
     if (core->textureCache == nullptr) return false;
     GLTextureCache2::EntryPtr entry(nullptr, nullptr);
-    Util::TAKErr err = core->textureCache->remove(entry, textureKey.c_str());
+    Util::TAKErr err = hasTextureId ? core->textureCache->remove(entry, textureId) : core->textureCache->remove(entry, textureKey.c_str());
     if (err != Util::TE_Ok) return false;
     texturePtr = std::move(entry->texture);
+    core->residentTiles.insert(tileZ, tileX, tileY, this);
     textureCoordsPtr = std::move(entry->textureCoordinates);
     vertexCoordsPtr = std::move(entry->vertexCoordinates);
     vertexCount = entry->numVertices;
@@ -200,8 +116,6 @@ bool GLTile::renderCommon(const TAK::Engine::Renderer::Core::GLMapView2 &view, i
             core->bitmapLoader->loadBitmapTask(pendingTextureTask, "REMOTE");
 
             this->state = State::RESOLVING;
-
-            tryBorrow();
             continue;
         } else if (this->state == State::RESOLVING) {
             // check if loading is completed, transition to RESOLVED or
@@ -217,6 +131,7 @@ bool GLTile::renderCommon(const TAK::Engine::Renderer::Core::GLMapView2 &view, i
 
                         texturePtr.reset(new GLTexture2(static_cast<int>(bitmap->getWidth()), static_cast<int>(bitmap->getHeight()), bitmap->getFormat()));
                         texturePtr->load(*bitmap);
+                        core->residentTiles.insert(tileZ, tileX, tileY, this);
                         tileVersion = pendingTextureContext->tileDrawVersion;
 
                         float u0 = 0.0f;
@@ -240,7 +155,9 @@ bool GLTile::renderCommon(const TAK::Engine::Renderer::Core::GLMapView2 &view, i
                         vertexCoordsPtr.reset(buf);
                         vertexCount = 4;
 
-                        unborrow();
+                        // the fallback is no longer needed
+                        delete fallbackMesh;
+                        fallbackMesh = nullptr;
 
                         this->state = State::RESOLVED;
                     } else {
@@ -387,64 +304,13 @@ void GLTile::debugDraw(const TAK::Engine::Renderer::Core::GLMapView2 &view) {
     fixedPipe->glDrawArrays(GL_LINE_LOOP, 0, 4);
     fixedPipe->glDisableClientState(atakmap::renderer::GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
 
-    pointD.x = (projMinX + projMaxX) / 2.0;
-    pointD.y = (projMinY + projMaxY) / 2.0;
-    pointD.z = 0.0;
-    core->proj->inverse(&geo, pointD);
-    view.forward(&pointF, geo);
-    fixedPipe->glPushMatrix();
-    fixedPipe->glTranslatef(pointF.x + 5, pointF.y + 20, 0.0f);
-
-    TextFormat2Ptr txtfmt(nullptr, nullptr);
-    TextFormat2_createDefaultSystemTextFormat(txtfmt, 14);
-    GLText2 txt(std::move(txtfmt));
-
-    std::stringstream ss;
-    ss << "tile " << tileZ << "," << tileX << "," << tileY;
-    std::string s = ss.str();
-    txt.draw(s.c_str(), 0.0f, 1.0f, 0.0f, 1.0f);
-
-    fixedPipe->glPopMatrix();
+    // XXX - label with the tile index once GLText2 is ported
 }
 
 void GLTile::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, const int renderPass) NOTHROWS {
     if (!renderCommon(view, renderPass)) {
         if (TAK::Engine::Util::MathUtils_hasBits(renderPass, getRenderPass())) {
-            do {
-                bool rebuildBorrowList = false;
-                std::set<BorrowRecord *>::iterator iter;
-                for (iter = borrowRecords.begin(); iter != borrowRecords.end(); ++iter) {
-                    BorrowRecord *record = *iter;
-                    if (!record->from->hasTexture()) {
-                        if (record->from->state != State::UNRESOLVABLE) {
-                            // check for a cached texture, and kick off a
-                            // tile load if necessary
-                            if (!record->from->checkForCachedTexture() &&
-                                (state == State::UNRESOLVABLE && record->from->state == State::UNRESOLVED)) {
-                                record->from->renderCommon(view, renderPass);
-                            }
-                        } else {
-                            // if the tile we are borrowing from is
-                            // unresolvable, we need to rebuild the list
-                            rebuildBorrowList = true;
-                            break;
-                        }
-                        if (!record->from->hasTexture()) continue;
-                    }
-
-                    record->mesh->drawMesh(view, record->from->texturePtr->getTexId(), core->r, core->g, core->b, core->a);
-                }
-                if (rebuildBorrowList) {
-                    // rebuild the list and loop through again
-                    unborrow();
-                    tryBorrow();
-                } else {
-                    // list is current; all borrowed textures have been
-                    // drawn
-                    break;
-                }
-            } while (true);
-
+            drawFallback(view);
             if (core->debugDraw) debugDraw(view);
         }
         return;
@@ -457,13 +323,17 @@ void GLTile::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, const int
 
 void GLTile::release() NOTHROWS {
     if (hasTexture()) {
+        core->residentTiles.erase(tileZ, tileX, tileY, this);
         if (core->textureCache != nullptr) {
             int *i = new int(tileVersion);
             GLTextureCache2::Entry::OpaquePtr opaque(i, Util::Memory_void_deleter_const<int>);
             GLTextureCache2::EntryPtr entry(new GLTextureCache2::Entry(std::move(texturePtr), std::move(textureCoordsPtr),
                                                                        std::move(vertexCoordsPtr), vertexCount, 0, std::move(opaque)),
                                             Util::Memory_deleter_const<GLTextureCache2::Entry>);
-            core->textureCache->put(textureKey.c_str(), std::move(entry));
+            if (hasTextureId)
+                core->textureCache->put(textureId, std::move(entry));
+            else
+                core->textureCache->put(textureKey.c_str(), std::move(entry));
         } else {
             texturePtr->release();
             texturePtr.reset();
@@ -486,7 +356,8 @@ void GLTile::release() NOTHROWS {
 
     mesh->release();
 
-    unborrow();
+    delete fallbackMesh;
+    fallbackMesh = nullptr;
 }
 
 int GLTile::getRenderPass() NOTHROWS { return Core::GLMapView2::Surface; }
@@ -511,6 +382,95 @@ std::string GLTile::getTileTextureKey(const GLTiledLayerCore &core, int zoom, in
     return ss.str();
 }
 
+bool GLTile::getTileTextureId(uint64_t *value, const GLTiledLayerCore &core, int zoom, int tileX, int tileY) {
+    if (core.clientSourceId >= (1u << TEXTURE_ID_SOURCE_BITS)) return false;
+    if (zoom < 0 || zoom >= (1 << TEXTURE_ID_ZOOM_BITS)) return false;
+    if (tileX < 0 || tileX >= (1 << TEXTURE_ID_INDEX_BITS)) return false;
+    if (tileY < 0 || tileY >= (1 << TEXTURE_ID_INDEX_BITS)) return false;
+
+    *value = ((uint64_t)core.clientSourceId << (TEXTURE_ID_ZOOM_BITS + 2 * TEXTURE_ID_INDEX_BITS)) |
+             ((uint64_t)zoom << (2 * TEXTURE_ID_INDEX_BITS)) |
+             ((uint64_t)tileX << TEXTURE_ID_INDEX_BITS) |
+             (uint64_t)tileY;
+    return true;
+}
+
+const TAK::Engine::Renderer::GLTexture2 *GLTile::getCachedTexture(const GLTiledLayerCore &core, int zoom, int tileX, int tileY) {
+    if (core.textureCache == nullptr) return nullptr;
+    const GLTextureCache2::Entry *cacheEnt;
+    uint64_t id;
+    Util::TAKErr code;
+    if (getTileTextureId(&id, core, zoom, tileX, tileY)) {
+        code = core.textureCache->get(&cacheEnt, id);
+    } else {
+        const std::string key = getTileTextureKey(core, zoom, tileX, tileY);
+        code = core.textureCache->get(&cacheEnt, key.c_str());
+    }
+    return (code == Util::TE_Ok) ? cacheEnt->texture.get() : nullptr;
+}
+
+bool GLTile::drawFallback(const TAK::Engine::Renderer::Core::GLMapView2 &view) {
+    const double centerX = (projMinX + projMaxX) / 2.0;
+    const double centerY = (projMinY + projMaxY) / 2.0;
+
+    // walk up the zoom levels to the nearest ancestor with a texture. An ancestor that is still
+    // live is found through the resident index, one that has gone out of use through the
+    // texture cache; either way this tile is never registered with the ancestor.
+    for (GLZoomLevel *lvl = patch->getParent()->previous; lvl != nullptr; lvl = lvl->previous) {
+        Math::Point2<double> index;
+        TAK::Engine::Raster::TileMatrix::TileMatrix_getTileIndex(&index, core->matrix->getOriginX(), core->matrix->getOriginY(),
+                                                                 lvl->info, centerX, centerY);
+        const int ancestorX = static_cast<int>(index.x);
+        const int ancestorY = static_cast<int>(index.y);
+
+        const GLTexture2 *texture;
+        GLTile *ancestor = core->residentTiles.find(lvl->info.level, ancestorX, ancestorY);
+        if (ancestor != nullptr)
+            texture = ancestor->texturePtr.get();
+        else
+            texture = getCachedTexture(*core, lvl->info.level, ancestorX, ancestorY);
+        if (texture == nullptr) continue;
+
+        if (fallbackMesh == nullptr || fallbackZ != lvl->info.level || fallbackX != ancestorX || fallbackY != ancestorY) {
+            Feature::Envelope2 ancestorBounds;
+            TAK::Engine::Raster::TileMatrix::TileMatrix_getTileBounds(&ancestorBounds, *(core->matrix), lvl->info.level, ancestorX,
+                                                                      ancestorY);
+
+            // the region of this tile covered by the ancestor
+            const double minX = atakmap::math::max(projMinX, ancestorBounds.minX);
+            const double minY = atakmap::math::max(projMinY, ancestorBounds.minY);
+            const double maxX = atakmap::math::min(projMaxX, ancestorBounds.maxX);
+            const double maxY = atakmap::math::min(projMaxY, ancestorBounds.maxY);
+            if (minX >= maxX || minY >= maxY) continue;
+
+            // texture coordinates of the region within the ancestor texture
+            const double texU = (double)lvl->info.tileWidth / (double)texture->getTexWidth();
+            const double texV = (double)lvl->info.tileHeight / (double)texture->getTexHeight();
+            const double ancestorWidth = ancestorBounds.maxX - ancestorBounds.minX;
+            const double ancestorHeight = ancestorBounds.maxY - ancestorBounds.minY;
+            const auto u0 = (float)(texU * (minX - ancestorBounds.minX) / ancestorWidth);
+            const auto v0 = (float)(texV * (ancestorBounds.maxY - maxY) / ancestorHeight);
+            const auto u1 = (float)(texU * (maxX - ancestorBounds.minX) / ancestorWidth);
+            const auto v1 = (float)(texV * (ancestorBounds.maxY - minY) / ancestorHeight);
+
+            Math::Matrix2 img2uv;
+            Math::Matrix2_mapQuads(&img2uv, minX, maxY, maxX, maxY, maxX, minY, minX, minY, u0, v0, u1, v0, u1, v1, u0, v1);
+
+            delete fallbackMesh;
+            fallbackMesh = new GLTileMesh(Math::Point2<double>(minX, maxY), Math::Point2<double>(maxX, maxY),
+                                          Math::Point2<double>(maxX, minY), Math::Point2<double>(minX, minY), img2uv, core->proj2geo,
+                                          patch->getParent()->tileMeshSubdivisions);
+            fallbackZ = lvl->info.level;
+            fallbackX = ancestorX;
+            fallbackY = ancestorY;
+        }
+
+        fallbackMesh->drawMesh(view, texture->getTexId(), core->r, core->g, core->b, core->a);
+        return true;
+    }
+    return false;
+}
+
 GLTile::BitmapLoadContext::BitmapLoadContext(bool refreshOnComplete, std::shared_ptr<TAK::Engine::Raster::TileMatrix::TileMatrix> &matrix,
                                              const TAK::Engine::Renderer::Core::GLMapView2 &view, int tileX, int tileY, int tileZ,
                                              int tileDrawVersion)
@@ -544,7 +504,7 @@ std::shared_ptr<TAK::Engine::Renderer::Bitmap2> GLTile::BitmapLoadContext::load(
             ctx->view.getRenderContext().requestRefresh();
 
         if (err != TAK::Engine::Util::TE_Ok)
-            throw std::exception("Error loading tile bitmap");
+            throw std::runtime_error("Error loading tile bitmap");
     }
     // Clean up
     delete ctxPtr;
@@ -552,37 +512,3 @@ std::shared_ptr<TAK::Engine::Renderer::Bitmap2> GLTile::BitmapLoadContext::load(
     std::shared_ptr<TAK::Engine::Renderer::Bitmap2> result(std::move(bitmap));
     return result;
 }
-
-GLTile::BorrowRecord::BorrowRecord(GLTile *owner, const std::shared_ptr<GLTile> &from, double borrowMinX, double borrowMinY,
-                                   double borrowMaxX, double borrowMaxY)
-    : owner(owner), from(from), projMinX(borrowMinX), projMinY(borrowMinY), projMaxX(borrowMaxX), projMaxY(borrowMaxY), mesh(nullptr) {
-    if (!from->hasTexture()) from->checkForCachedTexture();
-
-    Math::Point2<double> p(0, 0);
-
-    p.x = projMinX;
-    p.y = projMaxY;
-    from->proj2uv.transform(&p, p);
-    const auto u0 = (float)p.x;
-    const auto v0 = (float)p.y;
-    p.x = projMaxX;
-    p.y = projMinY;
-    from->proj2uv.transform(&p, p);
-    const auto u1 = (float)p.x;
-    const auto v1 = (float)p.y;
-
-    Math::Matrix2 img2uv;
-    Math::Matrix2_mapQuads(&img2uv, projMinX, projMaxY, projMaxX, projMaxY, projMaxX, projMinY, projMinX, projMinY, u0, v0, u1, v0, u1, v1,
-                           u0, v1);
-
-    mesh = new GLTileMesh(Math::Point2<double>(projMinX, projMaxY), Math::Point2<double>(projMaxX, projMaxY),
-                          Math::Point2<double>(projMaxX, projMinY), Math::Point2<double>(projMinX, projMinY), img2uv, owner->core->proj2geo,
-                          owner->patch->getParent()->tileMeshSubdivisions);
-
-    from->borrowers.insert(owner);
-}
-
-GLTile::BorrowRecord::~BorrowRecord() {
-    from->borrowers.erase(owner);
-    delete mesh;
-}
@@ -53,28 +53,6 @@ namespace TAK {
                             static std::shared_ptr<Bitmap2> load(void *opaque);
                         };
 
-                        struct BorrowRecord 
-                        {
-                             /** the GLTile we belong to */
-                             GLTile *const owner;
-                             /** the texture being borrowed from */
-                             std::shared_ptr<GLTile> from;
-                             /** the minimum x-coordinate of the borrowed region */
-                             const double projMinX;
-                             /** the minimum y-coordinate of the borrowed region */
-                             const double projMinY;
-                             /** the maximum x-coordinate of the borrowed region */
-                             const double projMaxX;
-                             /** the maximum y-coordinate of the borrowed region */
-                             const double projMaxY;
-                             /** the texture mesh */
-                             GLTileMesh *mesh;
-
-                            BorrowRecord(GLTile *owner, const std::shared_ptr<GLTile> &from, double borrowMinX, double borrowMinY, double borrowMaxX, double borrowMaxY);
-                            ~BorrowRecord();
-
-                        };
-
                         GLTexture2Ptr texturePtr;
                         Math::Matrix2 proj2uv;
                         double projMinX;
@@ -99,12 +77,21 @@ namespace TAK {
                         const int tileY;
                         const int tileZ;
     
+                        /** the packed texture cache key, valid when hasTextureId is true */
+                        uint64_t textureId;
+                        bool hasTextureId;
+                        /** the texture cache key for tiles outside the packable range */
                         std::string textureKey;
     
-                        std::set<GLTile *> borrowers;
-                        std::set<BorrowRecord *> borrowRecords;
                         int tileVersion;
 
+                        /** mesh for the region of the ancestor texture drawn while loading */
+                        GLTileMesh *fallbackMesh;
+                        /** the ancestor tile that fallbackMesh was built for */
+                        int fallbackZ;
+                        int fallbackX;
+                        int fallbackY;
+
                     public:
                         /**
                          * Creates a new tile renderer.
@@ -126,15 +113,6 @@ namespace TAK {
                         virtual ~GLTile() NOTHROWS;
 
 
-                        /**
-                         * Returns <code>true</code> if any tiles are borrowing this tile's
-                         * texture.
-                         *  
-                         * @return  <code>true</code> if any tiles are borrowing this tile's
-                         *          texture, <code>false</code> otherwise.
-                         */
-                        bool hasBorrowers();
-
                         /**
                          * Returns true if this tile has a non-null texture
                          */
@@ -163,17 +141,31 @@ namespace TAK {
 
                         static std::string getTileTextureKey(const GLTiledLayerCore &core, int zoom, int tileX, int tileY);
 
+                        /**
+                         * Packs the layer source, zoom level and tile index into a 64-bit
+                         * texture cache key.
+                         *
+                         * @return  <code>true</code> on success, <code>false</code> if the tile is
+                         *          outside of the packable range, in which case
+                         *          getTileTextureKey should be used
+                         */
+                        static bool getTileTextureId(uint64_t *value, const GLTiledLayerCore &core, int zoom, int tileX, int tileY);
+
                     private:
 
                         /**
-                         * Tries to borrow textures from other tiles.
+                         * Draws the nearest ancestor tile that has a texture, either live or
+                         * cached, in place of this tile.
+                         *
+                         * @return  <code>true</code> if an ancestor was drawn
                          */
-                        void tryBorrow();
+                        bool drawFallback(const Renderer::Core::GLMapView2 &view);
 
                         /**
-                         * Stops borrow textures from all other tiles.
+                         * Returns the texture of the specified tile if it is held by the
+                         * layer's texture cache, <code>nullptr</code> otherwise.
                          */
-                        void unborrow();
+                        static const GLTexture2 *getCachedTexture(const GLTiledLayerCore &core, int zoom, int tileX, int tileY);
     
                         bool checkForCachedTexture();
                         bool renderCommon(const Renderer::Core::GLMapView2 &view, int renderPass);
@@ -4,12 +4,8 @@
 #include "math/Rectangle.h"
 #include "math/Utils.h"
 #include "renderer/GLES20FixedPipeline.h"
-#include "renderer/GLText2.h"
 #include "util/MathUtils.h"
 
-#include <sstream>
-#include <string>
-
 using namespace TAK::Engine::Renderer::Raster::TileMatrix;
 
 GLTilePatch::GLTilePatch(GLTiledLayerCore *core, GLZoomLevel *parent, int gridOffsetX, int gridOffsetY, int gridColumns, int gridRows)
@@ -122,15 +118,14 @@ TAK::Engine::Util::TAKErr GLTilePatch::batch(const TAK::Engine::Renderer::Core::
         }
     }
 
-    // release any tiles that do not intersect the AOI and are not being
-    // borrowed from
+    // release any tiles that do not intersect the AOI
     for (int row = gridOffsetY; row < (gridOffsetY + gridRows); row++) {
         if (row >= minTileDrawRow && row <= maxTileDrawRow) continue;
         for (int col = gridOffsetX; col < (gridOffsetX + gridColumns); col++) {
             if (row >= minTileDrawCol && col <= maxTileDrawCol) continue;
 
             int idx = ((row - gridOffsetY) * gridColumns) + (col - gridOffsetX);
-            if (tiles_[idx].get() != nullptr && !tiles_[idx]->hasBorrowers()) tiles_[idx]->release();
+            if (tiles_[idx].get() != nullptr) tiles_[idx]->release();
         }
     }
     return TAK::Engine::Util::TAKErr::TE_Ok;
@@ -189,15 +184,14 @@ void GLTilePatch::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, cons
         }
     }
 
-    // release any tiles that do not intersect the AOI and are not being
-    // borrowed from
+    // release any tiles that do not intersect the AOI
     for (int row = gridOffsetY; row < (gridOffsetY + gridRows); row++) {
         if (row >= minTileDrawRow && row <= maxTileDrawRow) continue;
         for (int col = gridOffsetX; col < (gridOffsetX + gridColumns); col++) {
             if (row >= minTileDrawCol && col <= maxTileDrawCol) continue;
 
             int idx = ((row - gridOffsetY) * gridColumns) + (col - gridOffsetX);
-            if (tiles_[idx].get() != nullptr && !tiles_[idx]->hasBorrowers()) tiles_[idx]->release();
+            if (tiles_[idx].get() != nullptr) tiles_[idx]->release();
         }
     }
 }
@@ -233,32 +227,19 @@ void GLTilePatch::debugDraw(const TAK::Engine::Renderer::Core::GLMapView2 &view)
     fixedPipe->glDrawArrays(GL_LINE_LOOP, 0, 4);
     fixedPipe->glDisableClientState(atakmap::renderer::GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
 
-    scratchG = TAK::Engine::Core::GeoPoint2(patchMaxLat, patchMinLng);
-    view.forward(&scratchF, scratchG);
-    fixedPipe->glPushMatrix();
-    fixedPipe->glTranslatef(scratchF.x + 5, scratchF.y - 40, 0.0f);
-
-    TextFormat2Ptr txtfmt(nullptr, nullptr);
-    TextFormat2_createDefaultSystemTextFormat(txtfmt, 14);
-    GLText2 txt(std::move(txtfmt));
-    std::stringstream ss;
-    ss << "patch " << parent_->info.level << "," << gridOffsetX << "," << gridOffsetY;
-    std::string s = ss.str();
-    txt.draw(s.c_str(), 1.0f, 0.0f, 0.0f, 1.0f);
-    fixedPipe->glPopMatrix();
+    // XXX - label with the patch grid offset once GLText2 is ported
 }
 
 bool GLTilePatch::release(bool unusedOnly) {
-    bool cleared = true;
+    // tiles draw their ancestors through the layer's resident index and texture cache rather
+    // than holding on to them, so every tile is unused once the patch is not drawn
     for (int i = 0; i < num_tiles_; i++) {
-        if (tiles_[i].get() != nullptr && (!unusedOnly || !tiles_[i]->hasBorrowers())) {
+        if (tiles_[i].get() != nullptr) {
             tiles_[i]->release();
             tiles_[i].reset();
-        } else if (tiles_[i].get() != nullptr) {
-            cleared = false;
         }
     }
-    return cleared;
+    return true;
 }
 
 void GLTilePatch::release() NOTHROWS { release(false); }
@@ -268,38 +249,6 @@ int GLTilePatch::getRenderPass() NOTHROWS { return Core::GLMapView2::Surface; }
 void GLTilePatch::start() NOTHROWS {}
 void GLTilePatch::stop() NOTHROWS {}
 
-void GLTilePatch::getTiles(std::set<std::shared_ptr<GLTile>> *tiles, double minX, double minY, double maxX, double maxY) {
-    double lodProjTileWidth = parent_->info.pixelSizeX * parent_->info.tileWidth;
-    double lodProjTileHeight = parent_->info.pixelSizeY * parent_->info.tileHeight;
-
-    // calculate tiles in view
-    int minTileDrawCol = (int)((minX - core_->matrix->getOriginX()) / lodProjTileWidth);
-    int minTileDrawRow = (int)((core_->matrix->getOriginY() - maxY) / lodProjTileHeight);
-    int maxTileDrawCol = (int)((maxX - core_->matrix->getOriginX()) / lodProjTileWidth);
-    int maxTileDrawRow = (int)((core_->matrix->getOriginY() - minY) / lodProjTileHeight);
-
-    for (int row = minTileDrawRow; row <= maxTileDrawRow; row++) {
-        if (row < gridOffsetY || row >= (gridOffsetY + gridRows)) continue;
-        for (int col = minTileDrawCol; col <= maxTileDrawCol; col++) {
-            if (col < gridOffsetX || col >= (gridOffsetX + gridColumns)) continue;
-
-            int idx = ((row - gridOffsetY) * gridColumns) + (col - gridOffsetX);
-            if (this->tiles_[idx].get() == nullptr) {
-                // XXX - check if texture is cached
-                std::string textureKey = GLTile::getTileTextureKey(*core_, parent_->info.level, col, row);
-                const GLTextureCache2::Entry *cacheEnt;
-                if (core_->textureCache->get(&cacheEnt, textureKey.c_str()) == TAK::Engine::Util::TE_Ok) {
-                    // init tile
-                    this->tiles_[idx] = std::make_shared<GLTile>(core_, this, col, row);
-                    tiles->insert(this->tiles_[idx]);
-                }
-            } else if (this->tiles_[idx]->hasTexture()) {
-                tiles->insert(this->tiles_[idx]);
-            }
-        }
-    }
-}
-
 const GLZoomLevel *GLTilePatch::getParent() {
     return parent_;
 }
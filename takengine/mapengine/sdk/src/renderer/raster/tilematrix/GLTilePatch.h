@@ -93,8 +93,6 @@ namespace TAK {
 
                         void debugDraw(const Renderer::Core::GLMapView2 &view);
                         bool release(bool unusedOnly);
-
-                        void getTiles(std::set<std::shared_ptr<GLTile>> *tiles, double minX, double minY, double maxX, double maxY);
                         const GLZoomLevel *getParent();
                     };
                 }
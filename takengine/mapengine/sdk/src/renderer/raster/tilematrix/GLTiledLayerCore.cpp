@@ -5,6 +5,11 @@
 #include "core/ProjectionFactory2.h"
 #include "core/ProjectionFactory3.h"
 #include "math/Utils.h"
+#include "thread/Lock.h"
+#include "thread/Mutex.h"
+
+#include <map>
+#include <string>
 
 using namespace TAK::Engine::Renderer::Raster::TileMatrix;
 
@@ -26,6 +31,20 @@ namespace {
         return value;
     }
 
+    uint32_t getClientSourceId(const char *uri) {
+        static TAK::Engine::Thread::Mutex mutex;
+        static std::map<std::string, uint32_t> ids;
+
+        TAK::Engine::Thread::Lock lock(mutex);
+        const std::string key(uri ? uri : "");
+        auto entry = ids.find(key);
+        if (entry != ids.end())
+            return entry->second;
+        const uint32_t id = static_cast<uint32_t>(ids.size());
+        ids[key] = id;
+        return id;
+    }
+
     class ProjectionDatasetProjection2 : public atakmap::raster::DatasetProjection {
         GLTiledLayerCore *core;
 
@@ -58,7 +77,7 @@ namespace {
 
 GLTiledLayerCore::GLTiledLayerCore(const std::shared_ptr<TAK::Engine::Raster::TileMatrix::TileMatrix> &matrix, const char *uri)
     : 
-      clientSourceUri(uri), proj(nullptr, nullptr), 
+      clientSourceUri(uri), clientSourceId(getClientSourceId(uri)), proj(nullptr, nullptr), 
       debugDraw(false), textureCache(nullptr), bitmapLoader(nullptr), r(1.0f), g(1.0f),
       b(1.0f), a(1.0f), fullExtentMinLat(0), fullExtentMinLng(0), fullExtentMaxLat(0),
       fullExtentMaxLng(0),
@@ -7,6 +7,7 @@
 #include "feature/Envelope2.h"
 #include "renderer/GLTextureCache2.h"
 #include "renderer/AsyncBitmapLoader2.h"
+#include "renderer/raster/tilematrix/GLResidentTileIndex.h"
 
 namespace TAK {
     namespace Engine {
@@ -30,6 +31,12 @@ namespace TAK {
                          */
                         const char * const clientSourceUri;
 
+                        /**
+                         * A process-wide identifier for the base URL of the layer, used to
+                         * build integer tile texture cache keys.
+                         */
+                        const uint32_t clientSourceId;
+
                         /**
                          * The {@link Projection} of the layer
                          */
@@ -112,6 +119,11 @@ namespace TAK {
 
                         int tileDrawVersion;
 
+                        /**
+                         * The tiles of the layer that currently hold a texture.
+                         */
+                        GLResidentTileIndex residentTiles;
+
                        private:
                         int64_t lastRefresh;
 
@@ -93,9 +93,6 @@ TAK::Engine::Util::TAKErr GLZoomLevel::batch(const TAK::Engine::Renderer::Core::
     maxPatch.x /= patchCols;
     maxPatch.y /= patchRows;
                 
-    std::map<int, GLTilePatch *> releasable(patches);
-
-    std::map<int, GLTilePatch *>::iterator iter;
     for (int patchY = static_cast<int>(minPatch.y); patchY <= maxPatch.y; patchY++) {
         if(patchY < patchesGridOffsetY || patchY >= (patchesGridOffsetY+numPatchesY))
             continue;
@@ -104,7 +101,7 @@ TAK::Engine::Util::TAKErr GLZoomLevel::batch(const TAK::Engine::Renderer::Core::
                 continue;
                 
             int idx = ((patchY-patchesGridOffsetY)*numPatchesX) + (patchX-patchesGridOffsetX);
-            iter = patches.find(idx);
+            auto iter = patches.find(idx);
             GLTilePatch *patch;
             if (iter == patches.end()) {
                 patch = new GLTilePatch(core,
@@ -123,12 +120,7 @@ TAK::Engine::Util::TAKErr GLZoomLevel::batch(const TAK::Engine::Renderer::Core::
     }
         
     // release any patches not in view
-    for (iter = releasable.begin(); iter != releasable.end(); ++iter) {
-        if (iter->second->release(false)) {
-            delete iter->second;
-            patches.erase(iter->first);
-        }
-    }
+    releaseOutside(static_cast<int>(minPatch.x), static_cast<int>(minPatch.y), static_cast<int>(maxPatch.x), static_cast<int>(maxPatch.y));
     return TAK::Engine::Util::TE_Ok;
 }
 
@@ -182,9 +174,6 @@ void GLZoomLevel::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, cons
     maxPatch.x /= patchCols;
     maxPatch.y /= patchRows;
 
-    std::map<int, GLTilePatch *> releasable(patches);
-
-    std::map<int, GLTilePatch *>::iterator iter;
     for(int patchY = static_cast<int>(minPatch.y); patchY <= maxPatch.y; patchY++) {
         if(patchY < patchesGridOffsetY || patchY >= (patchesGridOffsetY+numPatchesY))
             continue;
@@ -194,7 +183,7 @@ void GLZoomLevel::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, cons
                 
             int idx = ((patchY-patchesGridOffsetY)*numPatchesX) + (patchX-patchesGridOffsetX); 
             GLTilePatch *patch;
-            iter = patches.find(idx);
+            auto iter = patches.find(idx);
             if(iter == patches.end()) {
                 // XXX - should clamp number of patches against full extent?
                 patch = new GLTilePatch(core,
@@ -205,7 +194,6 @@ void GLZoomLevel::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, cons
                 patches[idx] = patch;
             } else {
                 patch = iter->second;
-                releasable.erase(iter->first);
             }
 
             patch->draw(view, renderPass);
@@ -213,12 +201,7 @@ void GLZoomLevel::draw(const TAK::Engine::Renderer::Core::GLMapView2 &view, cons
     }
         
     // release any patches not in view
-    for (iter = releasable.begin(); iter != releasable.end();  ++iter) {
-        if (iter->second->release(false)) {
-            delete iter->second;
-            patches.erase(iter->first);
-        }
-    }
+    releaseOutside(static_cast<int>(minPatch.x), static_cast<int>(minPatch.y), static_cast<int>(maxPatch.x), static_cast<int>(maxPatch.y));
 }
 
 void GLZoomLevel::release() NOTHROWS { release(false); }
@@ -229,55 +212,27 @@ void GLZoomLevel::start() NOTHROWS {}
 void GLZoomLevel::stop() NOTHROWS {}
 
 
-void GLZoomLevel::getTiles(std::set<std::shared_ptr<GLTile>> *tiles, double minX, double minY, double maxX, double maxY) {
-    // calculate tiles in view
-    Math::Point2<double> minPatch;
-    TAK::Engine::Raster::TileMatrix::TileMatrix_getTileIndex(&minPatch, 
-                                                    core->matrix->getOriginX(),
-                                                    core->matrix->getOriginY(),
-                                                    info,
-                                                    minX,
-                                                    maxY);
-    minPatch.x /= patchCols;
-    minPatch.y /= patchRows;
-    Math::Point2<double> maxPatch;
-    TAK::Engine::Raster::TileMatrix::TileMatrix_getTileIndex(&maxPatch, 
-                                                    core->matrix->getOriginX(),
-                                                    core->matrix->getOriginY(),
-                                                    info,
-                                                    maxX,
-                                                    minY);
-    maxPatch.x /= patchCols;
-    maxPatch.y /= patchRows;
-                
-    for (int patchY = static_cast<int>(minPatch.y); patchY <= maxPatch.y; patchY++) {
-        if(patchY < patchesGridOffsetY || patchY >= (patchesGridOffsetY+numPatchesY))
+void GLZoomLevel::releaseOutside(int minPatchX, int minPatchY, int maxPatchX, int maxPatchY) {
+    // the patch grid position is recovered from the key, no per-frame copy of the patch map is needed
+    auto iter = patches.begin();
+    while (iter != patches.end()) {
+        auto curIter = iter;
+        ++iter;
+
+        const int patchX = (curIter->first % numPatchesX) + patchesGridOffsetX;
+        const int patchY = (curIter->first / numPatchesX) + patchesGridOffsetY;
+        if (patchX >= minPatchX && patchX <= maxPatchX && patchY >= minPatchY && patchY <= maxPatchY)
             continue;
-        for(int patchX = static_cast<int>(minPatch.x); patchX <= maxPatch.x; patchX++) {
-            if(patchX < patchesGridOffsetX || patchX >= (patchesGridOffsetX+numPatchesX))
-                continue;
-                
-            int idx = ((patchY-patchesGridOffsetY)*numPatchesX) + (patchX-patchesGridOffsetX); 
-            GLTilePatch *patch = nullptr;
-            auto iter = patches.find(idx);
-            if (iter == patches.end()) {
-                patch = new GLTilePatch(core,
-                        this,
-                        patchX*patchCols,
-                        patchY*patchRows,
-                        patchCols, patchRows);
-                patches[idx] = patch;
-            } else {
-                patch = iter->second;
-            }
-            if(patch != nullptr)
-                patch->getTiles(tiles, minX, minY, maxX, maxY);
+
+        if (curIter->second->release(false)) {
+            delete curIter->second;
+            patches.erase(curIter);
         }
     }
 }
 
 bool GLZoomLevel::release(bool unusedOnly) {
-    std::map<int, GLTilePatch *>::iterator iter;
+    std::unordered_map<int, GLTilePatch *>::iterator iter;
     if (!unusedOnly) {
         for (iter = patches.begin(); iter != patches.end(); ++iter) {
             iter->second->release();
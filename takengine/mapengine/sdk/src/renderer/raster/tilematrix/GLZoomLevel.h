@@ -8,6 +8,7 @@
 #include "renderer/core/GLMapRenderable2.h"
 #include "renderer/core/GLMapBatchable2.h"
 
+#include <unordered_map>
 
 
 namespace TAK {
@@ -31,7 +32,7 @@ namespace TAK {
                       private:
 
                         GLTiledLayerCore *core;
-                        std::map<int, GLTilePatch *> patches;
+                        std::unordered_map<int, GLTilePatch *> patches;
 
                         int patchRows;
                         int patchCols;
@@ -75,19 +76,13 @@ namespace TAK {
                         /*********************************************************************/
                         // Our own public methods
 
+                        bool release(bool unusedOnly);
+
+                      private:
                         /**
-                         * Obtains all patches that intersect the specified region that either have
-                         * live tiles intersecting the region or have tiles whose textures are
-                         * cached intersecting the region.
-                         * 
-                         * @param patches
-                         * @param minX
-                         * @param minY
-                         * @param maxX
-                         * @param maxY
+                         * Releases the patches outside of the specified patch grid region.
                          */
-                        void getTiles(std::set<std::shared_ptr<GLTile>> *tiles, double minX, double minY, double maxX, double maxY);
-                        bool release(bool unusedOnly);
+                        void releaseOutside(int minPatchX, int minPatchY, int maxPatchX, int maxPatchY);
 
                     };
                 }
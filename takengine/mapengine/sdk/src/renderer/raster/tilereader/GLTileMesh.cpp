@@ -1,7 +1,6 @@
 #include "renderer/raster/tilereader/GLTileMesh.h"
 #include "renderer/GLTexture2.h"
 #include "renderer/GLES20FixedPipeline.h"
-#include "renderer/map/GLMapView.h"
 #include "math/Utils.h"
 #include "util/MathUtils.h"
 #include "util/ConfigOptions.h"
@@ -331,10 +330,10 @@ int GLTileMesh::estimateSubdivisions(double ulLat, double ulLng, double lrLat, d
     const int maxGridSize = getConfigOption("glquadtilenode2.maximum-grid-size", 32);
 
     const int subsX = Util::MathUtils_clamp(
-        Util::MathUtils_nextPowerOf2((int)ceil((ulLat - lrLat) / atakmap::renderer::map::GLMapView::recommendedGridSampleDistance)),
+        Util::MathUtils_nextPowerOf2((int)ceil((ulLat - lrLat) / Core::GLMapView2::getRecommendedGridSampleDistance())),
                                         minGridSize, maxGridSize);
     const int subsY = Util::MathUtils_clamp(
-        Util::MathUtils_nextPowerOf2((int)ceil((lrLng - ulLng) / atakmap::renderer::map::GLMapView::recommendedGridSampleDistance)),
+        Util::MathUtils_nextPowerOf2((int)ceil((lrLng - ulLng) / Core::GLMapView2::getRecommendedGridSampleDistance())),
                                         minGridSize, maxGridSize);
 
     return atakmap::math::max(subsX, subsY);
@@ -386,10 +385,10 @@ int GLTileMesh::estimateSubdivisions(double x, double y, double width, double he
     const int maxGridSize = getConfigOption("glquadtilenode2.maximum-grid-size", 32);
 
     const int subsX = Util::MathUtils_clamp(
-        Util::MathUtils_nextPowerOf2((int)ceil((maxLat - minLat) / atakmap::renderer::map::GLMapView::recommendedGridSampleDistance)),
+        Util::MathUtils_nextPowerOf2((int)ceil((maxLat - minLat) / Core::GLMapView2::getRecommendedGridSampleDistance())),
         minGridSize, maxGridSize);
     const int subsY = Util::MathUtils_clamp(
-        Util::MathUtils_nextPowerOf2((int)ceil((maxLng - minLng) / atakmap::renderer::map::GLMapView::recommendedGridSampleDistance)),
+        Util::MathUtils_nextPowerOf2((int)ceil((maxLng - minLng) / Core::GLMapView2::getRecommendedGridSampleDistance())),
         minGridSize, maxGridSize);
 
     return atakmap::math::max(subsX, subsY);
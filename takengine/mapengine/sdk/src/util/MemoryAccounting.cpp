@@ -0,0 +1,153 @@
+#include "util/MemoryAccounting.h"
+
+#include <set>
+
+#include "thread/Lock.h"
+#include "thread/Mutex.h"
+
+using namespace TAK::Engine::Util;
+
+using namespace TAK::Engine::Thread;
+
+namespace
+{
+    Mutex &mutex() NOTHROWS
+    {
+        static Mutex m;
+        return m;
+    }
+    std::set<MemoryBudget *> &budgets() NOTHROWS
+    {
+        static std::set<MemoryBudget *> b;
+        return b;
+    }
+}
+
+MemoryBudget::MemoryBudget(const char *tag_, const std::size_t limit_, TAKErr(*trim_)(void *opaque, const std::size_t targetBytes) NOTHROWS, void *opaque_) NOTHROWS :
+    tag(tag_ ? tag_ : ""),
+    bytes(0u),
+    highWater(0u),
+    limit(limit_),
+    trimCallback(trim_),
+    trimOpaque(opaque_)
+{
+    Lock lock(mutex());
+    if (lock.status != TE_Ok)
+        return;
+    try {
+        budgets().insert(this);
+    } catch (...) {
+        // the budget is not reported
+    }
+}
+MemoryBudget::~MemoryBudget() NOTHROWS
+{
+    Lock lock(mutex());
+    if (lock.status != TE_Ok)
+        return;
+    budgets().erase(this);
+}
+void MemoryBudget::allocated(const std::size_t n) NOTHROWS
+{
+    updateHighWater(bytes.fetch_add(n, std::memory_order_relaxed) + n);
+}
+void MemoryBudget::released(const std::size_t n) NOTHROWS
+{
+    bytes.fetch_sub(n, std::memory_order_relaxed);
+}
+void MemoryBudget::setBytes(const std::size_t n) NOTHROWS
+{
+    bytes.store(n, std::memory_order_relaxed);
+    updateHighWater(n);
+}
+void MemoryBudget::setLimit(const std::size_t n) NOTHROWS
+{
+    limit.store(n, std::memory_order_relaxed);
+}
+std::size_t MemoryBudget::getBytes() const NOTHROWS
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+std::size_t MemoryBudget::getHighWater() const NOTHROWS
+{
+    return highWater.load(std::memory_order_relaxed);
+}
+void MemoryBudget::resetHighWater() NOTHROWS
+{
+    highWater.store(bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+void MemoryBudget::getUsage(MemoryUsage *value) const NOTHROWS
+{
+    value->tag = tag;
+    value->bytes = bytes.load(std::memory_order_relaxed);
+    value->highWater = highWater.load(std::memory_order_relaxed);
+    value->limit = limit.load(std::memory_order_relaxed);
+    value->trimmable = !!trimCallback;
+}
+TAKErr MemoryBudget::requestTrim(const std::size_t targetBytes) NOTHROWS
+{
+    if (!trimCallback)
+        return TE_Unsupported;
+    return trimCallback(trimOpaque, targetBytes);
+}
+void MemoryBudget::updateHighWater(const std::size_t n) NOTHROWS
+{
+    std::size_t hw = highWater.load(std::memory_order_relaxed);
+    while (n > hw && !highWater.compare_exchange_weak(hw, n, std::memory_order_relaxed))
+        ;
+}
+
+TAKErr TAK::Engine::Util::MemoryAccounting_visitUsage(TAKErr(*visitor)(void *opaque, const MemoryUsage &usage) NOTHROWS, void *opaque) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!visitor)
+        return TE_InvalidArg;
+
+    Lock lock(mutex());
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    std::set<MemoryBudget *> &b = budgets();
+    for (auto it = b.begin(); it != b.end(); it++) {
+        MemoryUsage usage;
+        (*it)->getUsage(&usage);
+        code = visitor(opaque, usage);
+        TE_CHECKBREAK_CODE(code);
+    }
+    if (code == TE_Done)
+        code = TE_Ok;
+    return code;
+}
+std::size_t TAK::Engine::Util::MemoryAccounting_getTotalBytes() NOTHROWS
+{
+    Lock lock(mutex());
+    if (lock.status != TE_Ok)
+        return 0u;
+
+    std::size_t total = 0u;
+    std::set<MemoryBudget *> &b = budgets();
+    for (auto it = b.begin(); it != b.end(); it++)
+        total += (*it)->getBytes();
+    return total;
+}
+TAKErr TAK::Engine::Util::MemoryAccounting_trim(const double fraction) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (fraction < 0.0 || fraction > 1.0)
+        return TE_InvalidArg;
+
+    Lock lock(mutex());
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+
+    std::set<MemoryBudget *> &b = budgets();
+    for (auto it = b.begin(); it != b.end(); it++) {
+        MemoryBudget &budget = **it;
+        const std::size_t target = static_cast<std::size_t>(static_cast<double>(budget.getBytes()) * fraction);
+        // a failure to trim one budget should not prevent the others from trimming
+        const TAKErr trimCode = budget.requestTrim(target);
+        if (trimCode != TE_Ok && trimCode != TE_Unsupported)
+            code = trimCode;
+    }
+    return code;
+}
@@ -0,0 +1,115 @@
+#ifndef TAK_ENGINE_UTIL_MEMORYACCOUNTING_H_INCLUDED
+#define TAK_ENGINE_UTIL_MEMORYACCOUNTING_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+
+#include "port/Platform.h"
+#include "util/Error.h"
+
+namespace TAK {
+    namespace Engine {
+        namespace Util {
+            /**
+             * A snapshot of the memory held by a single budget.
+             */
+            struct ENGINE_API MemoryUsage
+            {
+                /** the tag the budget was registered with */
+                const char *tag;
+                /** the bytes currently held */
+                std::size_t bytes;
+                /** the most bytes held at any one time since the budget was created or last reset */
+                std::size_t highWater;
+                /** the configured limit, <code>0</code> if unlimited */
+                std::size_t limit;
+                /** <code>true</code> if the owner can release memory on request */
+                bool trimmable;
+            };
+
+            /**
+             * Tracks the memory held by one instance of an engine subsystem,
+             * such as a cache. The budget is registered with the global
+             * accounting for its lifetime, and its usage may be queried via
+             * <code>MemoryAccounting_visitUsage</code>.
+             *
+             * <P>The owner reports its usage, either as deltas via
+             * <code>allocated</code> and <code>released</code> or as an
+             * absolute value via <code>setBytes</code>. Reporting is
+             * lock-free.
+             *
+             * <P>An owner that can release memory on request supplies a trim
+             * callback. The callback is invoked from the thread calling
+             * <code>MemoryAccounting_trim</code> while the accounting lock is
+             * held; it must be thread-safe and must not create or destroy any
+             * budget. Owners that may only release memory on a specific
+             * thread should record the target and trim on that thread.
+             */
+            class ENGINE_API MemoryBudget
+            {
+            public :
+                /**
+                 * @param tag       Names the subsystem; must have static
+                 *                  storage duration
+                 * @param limit     The configured limit, <code>0</code> if
+                 *                  unlimited. For reporting only.
+                 * @param trim      If non-<code>nullptr</code>, invoked to
+                 *                  request that the owner reduce its usage
+                 *                  to at most the specified number of bytes
+                 * @param opaque    Passed to <code>trim</code>
+                 */
+                MemoryBudget(const char *tag, const std::size_t limit = 0u, TAKErr(*trim)(void *opaque, const std::size_t targetBytes) NOTHROWS = nullptr, void *opaque = nullptr) NOTHROWS;
+                ~MemoryBudget() NOTHROWS;
+            private :
+                MemoryBudget(const MemoryBudget &) = delete;
+                MemoryBudget &operator=(const MemoryBudget &) = delete;
+            public :
+                void allocated(const std::size_t bytes) NOTHROWS;
+                void released(const std::size_t bytes) NOTHROWS;
+                void setBytes(const std::size_t bytes) NOTHROWS;
+                void setLimit(const std::size_t limit) NOTHROWS;
+                std::size_t getBytes() const NOTHROWS;
+                std::size_t getHighWater() const NOTHROWS;
+                /** resets the high-water mark to the current usage */
+                void resetHighWater() NOTHROWS;
+                void getUsage(MemoryUsage *value) const NOTHROWS;
+                /**
+                 * Requests that the owner reduce its usage to at most the
+                 * specified number of bytes. Returns
+                 * <code>TE_Unsupported</code> if the budget is not trimmable.
+                 */
+                TAKErr requestTrim(const std::size_t targetBytes) NOTHROWS;
+            private :
+                void updateHighWater(const std::size_t bytes) NOTHROWS;
+            private :
+                const char *tag;
+                std::atomic<std::size_t> bytes;
+                std::atomic<std::size_t> highWater;
+                std::atomic<std::size_t> limit;
+                TAKErr(*trimCallback)(void *opaque, const std::size_t targetBytes) NOTHROWS;
+                void *trimOpaque;
+            };
+
+            /**
+             * Visits the usage of every registered budget.
+             */
+            ENGINE_API TAKErr MemoryAccounting_visitUsage(TAKErr(*visitor)(void *opaque, const MemoryUsage &usage) NOTHROWS, void *opaque) NOTHROWS;
+            /**
+             * Returns the sum of the bytes currently held by all registered
+             * budgets.
+             */
+            ENGINE_API std::size_t MemoryAccounting_getTotalBytes() NOTHROWS;
+            /**
+             * Requests that every trimmable budget reduce its usage to the
+             * specified fraction of its current usage. Intended to be invoked
+             * in response to memory pressure reported by the platform.
+             *
+             * @param fraction  The fraction of current usage to retain, in
+             *                  the range <code>[0, 1]</code>
+             */
+            ENGINE_API TAKErr MemoryAccounting_trim(const double fraction) NOTHROWS;
+        }
+    }
+}
+
+#endif
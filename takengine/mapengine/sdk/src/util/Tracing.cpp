@@ -0,0 +1,287 @@
+#include "util/Tracing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "thread/Lock.h"
+#include "thread/Mutex.h"
+
+using namespace TAK::Engine::Util;
+
+using namespace TAK::Engine::Thread;
+
+#define TRACE_BUFFER_CAPACITY 4096u
+
+namespace
+{
+    /**
+     * Ring buffer of the spans recorded by a single thread. Only the owning
+     * thread writes; readers bound the range they copy by 'head' before and
+     * after copying.
+     */
+    struct ThreadBuffer
+    {
+        ThreadBuffer() NOTHROWS;
+
+        TraceEvent events[TRACE_BUFFER_CAPACITY];
+        /** the number of spans ever written to the buffer */
+        std::atomic<uint64_t> head;
+        /** spans before this index have been cleared */
+        std::atomic<uint64_t> tail;
+        /** the number of spans currently open on the owning thread */
+        uint32_t depth;
+        uint32_t threadId;
+        /** true while a live thread owns the buffer */
+        bool owned;
+    };
+
+    /**
+     * Releases the thread's buffer for reuse by another thread when the
+     * thread exits.
+     */
+    struct ThreadBufferRef
+    {
+        ThreadBufferRef() NOTHROWS;
+        ~ThreadBufferRef() NOTHROWS;
+
+        ThreadBuffer *buffer;
+    };
+
+    Mutex &mutex() NOTHROWS
+    {
+        static Mutex m;
+        return m;
+    }
+    std::vector<std::unique_ptr<ThreadBuffer>> &buffers() NOTHROWS
+    {
+        static std::vector<std::unique_ptr<ThreadBuffer>> b;
+        return b;
+    }
+
+    ThreadBuffer *threadBuffer() NOTHROWS;
+    int64_t systimeNanos() NOTHROWS;
+    void appendJsonString(std::string &json, const char *s) NOTHROWS;
+    TAKErr appendChromeTraceEvent(void *opaque, const TraceEvent &event) NOTHROWS;
+
+    thread_local ThreadBufferRef currentThread;
+}
+
+std::atomic<bool> TAK::Engine::Util::Impl::tracingEnabled(false);
+
+void TraceSpan::begin() NOTHROWS
+{
+    ThreadBuffer *buffer = threadBuffer();
+    if (!buffer) {
+        this->active = false;
+        return;
+    }
+    this->depth = buffer->depth++;
+    this->beginNanos = systimeNanos();
+}
+void TraceSpan::end() NOTHROWS
+{
+    const int64_t endNanos = systimeNanos();
+    ThreadBuffer *buffer = currentThread.buffer;
+
+    buffer->depth--;
+
+    const uint64_t idx = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer->events[idx % TRACE_BUFFER_CAPACITY];
+    event.name = this->name;
+    event.threadId = buffer->threadId;
+    event.depth = this->depth;
+    event.beginNanos = this->beginNanos;
+    event.endNanos = endNanos;
+    buffer->head.store(idx + 1u, std::memory_order_release);
+}
+
+void TAK::Engine::Util::Tracing_setEnabled(const bool enabled) NOTHROWS
+{
+    Impl::tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+bool TAK::Engine::Util::Tracing_isEnabled() NOTHROWS
+{
+    return Impl::tracingEnabled.load(std::memory_order_relaxed);
+}
+void TAK::Engine::Util::Tracing_clear() NOTHROWS
+{
+    Lock lock(mutex());
+    if (lock.status != TE_Ok)
+        return;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> &b = buffers();
+    for (auto it = b.begin(); it != b.end(); it++)
+        (*it)->tail.store((*it)->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+TAKErr TAK::Engine::Util::Tracing_visitEvents(TAKErr(*visitor)(void *opaque, const TraceEvent &event) NOTHROWS, void *opaque) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!visitor)
+        return TE_InvalidArg;
+
+    // copy the buffers out under the lock, visit without it so that the
+    // visitor may itself record spans
+    std::vector<TraceEvent> events;
+    {
+        Lock lock(mutex());
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+
+        std::vector<std::unique_ptr<ThreadBuffer>> &b = buffers();
+        for (auto it = b.begin(); it != b.end(); it++) {
+            const ThreadBuffer &buffer = **it;
+            const uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+            const uint64_t head = buffer.head.load(std::memory_order_acquire);
+            uint64_t first = (head > TRACE_BUFFER_CAPACITY) ? (head - TRACE_BUFFER_CAPACITY) : 0u;
+            if (first < tail)
+                first = tail;
+
+            const std::size_t copied = events.size();
+            for (uint64_t i = first; i < head; i++)
+                events.push_back(buffer.events[i % TRACE_BUFFER_CAPACITY]);
+
+            // the owner may have wrapped around while the events were copied.
+            // The span at 'after' may be partially written over the slot of
+            // 'after - capacity', so that span and everything before it is
+            // suspect.
+            const uint64_t after = buffer.head.load(std::memory_order_acquire);
+            const uint64_t valid = (after + 1u > TRACE_BUFFER_CAPACITY) ? (after + 1u - TRACE_BUFFER_CAPACITY) : 0u;
+            if (valid > first) {
+                const std::size_t skip = static_cast<std::size_t>(std::min(valid, head) - first);
+                events.erase(events.begin() + copied, events.begin() + copied + skip);
+            }
+        }
+    }
+
+    for (auto it = events.begin(); it != events.end(); it++) {
+        code = visitor(opaque, *it);
+        TE_CHECKBREAK_CODE(code);
+    }
+    if (code == TE_Done)
+        code = TE_Ok;
+    return code;
+}
+TAKErr TAK::Engine::Util::Tracing_exportChromeTrace(DataOutput2 &sink) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+
+    std::string json("{\"traceEvents\":[");
+    code = Tracing_visitEvents(appendChromeTraceEvent, &json);
+    TE_CHECKRETURN_CODE(code);
+    // drop the trailing separator
+    if (json[json.length() - 1u] == ',')
+        json.resize(json.length() - 1u);
+    json += "],\"displayTimeUnit\":\"ns\"}";
+
+    return sink.write(reinterpret_cast<const uint8_t *>(json.c_str()), json.length());
+}
+
+namespace
+{
+    ThreadBuffer::ThreadBuffer() NOTHROWS :
+        head(0u),
+        tail(0u),
+        depth(0u),
+        threadId(0u),
+        owned(false)
+    {}
+
+    ThreadBufferRef::ThreadBufferRef() NOTHROWS :
+        buffer(nullptr)
+    {}
+    ThreadBufferRef::~ThreadBufferRef() NOTHROWS
+    {
+        if (!buffer)
+            return;
+        Lock lock(mutex());
+        if (lock.status != TE_Ok)
+            return;
+        buffer->owned = false;
+        buffer = nullptr;
+    }
+
+    ThreadBuffer *threadBuffer() NOTHROWS
+    {
+        if (currentThread.buffer)
+            return currentThread.buffer;
+
+        static uint32_t nextThreadId = 1u;
+
+        Lock lock(mutex());
+        if (lock.status != TE_Ok)
+            return nullptr;
+
+        // adopt the buffer of a thread that has exited, if any. The buffer
+        // keeps the spans of the previous owner, which carry its id.
+        ThreadBuffer *buffer = nullptr;
+        std::vector<std::unique_ptr<ThreadBuffer>> &b = buffers();
+        for (auto it = b.begin(); it != b.end(); it++) {
+            if (!(*it)->owned) {
+                buffer = it->get();
+                break;
+            }
+        }
+        if (!buffer) {
+            std::unique_ptr<ThreadBuffer> created(new(std::nothrow) ThreadBuffer());
+            if (!created.get())
+                return nullptr;
+            buffer = created.get();
+            try {
+                b.push_back(std::move(created));
+            } catch (...) {
+                return nullptr;
+            }
+        }
+        buffer->owned = true;
+        buffer->depth = 0u;
+        buffer->threadId = nextThreadId++;
+
+        currentThread.buffer = buffer;
+        return buffer;
+    }
+
+    int64_t systimeNanos() NOTHROWS
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void appendJsonString(std::string &json, const char *s) NOTHROWS
+    {
+        json += '"';
+        for (const char *c = s ? s : ""; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                json += '\\';
+                json += *c;
+            } else if ((unsigned char)*c < 0x20u) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(unsigned char)*c);
+                json += escaped;
+            } else {
+                json += *c;
+            }
+        }
+        json += '"';
+    }
+
+    TAKErr appendChromeTraceEvent(void *opaque, const TraceEvent &event) NOTHROWS
+    {
+        std::string &json = *static_cast<std::string *>(opaque);
+
+        // complete ("X") events; timestamps are in microseconds
+        char fields[160];
+        snprintf(fields, sizeof(fields), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}},",
+            event.threadId,
+            (double)event.beginNanos / 1000.0,
+            (double)(event.endNanos - event.beginNanos) / 1000.0,
+            event.depth);
+
+        json += "{\"name\":";
+        appendJsonString(json, event.name);
+        json += fields;
+        return TE_Ok;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef TAK_ENGINE_UTIL_TRACING_H_INCLUDED
+#define TAK_ENGINE_UTIL_TRACING_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+
+#include "port/Platform.h"
+#include "util/DataOutput2.h"
+#include "util/Error.h"
+
+namespace TAK {
+    namespace Engine {
+        namespace Util {
+            /**
+             * A completed span, as recorded by a TraceSpan.
+             */
+            struct ENGINE_API TraceEvent
+            {
+                /** the name of the span; must have static storage duration */
+                const char *name;
+                /** engine assigned identifier for the thread that recorded the span */
+                uint32_t threadId;
+                /** the number of spans that were open on the thread when the span began */
+                uint32_t depth;
+                /** monotonic timestamps, in nanoseconds */
+                int64_t beginNanos;
+                int64_t endNanos;
+            };
+
+            /**
+             * Times the enclosing scope. The span is recorded to the calling
+             * thread's trace buffer when the object goes out of scope if
+             * tracing was enabled when it was constructed. When tracing is
+             * disabled, construction and destruction cost a single relaxed
+             * atomic load.
+             *
+             * <P>Each thread records into its own fixed-size ring buffer;
+             * recording takes no locks. Once a buffer is full, the oldest
+             * spans are overwritten.
+             */
+            class ENGINE_API TraceSpan
+            {
+            public :
+                /**
+                 * @param name  The name of the span. Only the pointer is
+                 *              retained, so this should be a string literal.
+                 */
+                explicit TraceSpan(const char *name) NOTHROWS;
+                ~TraceSpan() NOTHROWS;
+            private :
+                TraceSpan(const TraceSpan &) = delete;
+                TraceSpan &operator=(const TraceSpan &) = delete;
+            private :
+                void begin() NOTHROWS;
+                void end() NOTHROWS;
+            private :
+                const char *name;
+                int64_t beginNanos;
+                uint32_t depth;
+                bool active;
+            };
+
+            ENGINE_API void Tracing_setEnabled(const bool enabled) NOTHROWS;
+            ENGINE_API bool Tracing_isEnabled() NOTHROWS;
+            /**
+             * Discards all recorded spans.
+             */
+            ENGINE_API void Tracing_clear() NOTHROWS;
+            /**
+             * Visits the spans currently held in the trace buffers of all
+             * threads, one thread at a time. Other threads may continue to
+             * record while the buffers are read; any span that may have been
+             * overwritten while it was read is skipped.
+             */
+            ENGINE_API TAKErr Tracing_visitEvents(TAKErr(*visitor)(void *opaque, const TraceEvent &event) NOTHROWS, void *opaque) NOTHROWS;
+            /**
+             * Writes the recorded spans as Chrome trace-event JSON, suitable
+             * for chrome://tracing or Perfetto.
+             */
+            ENGINE_API TAKErr Tracing_exportChromeTrace(DataOutput2 &sink) NOTHROWS;
+
+            namespace Impl {
+                ENGINE_API extern std::atomic<bool> tracingEnabled;
+            }
+
+            inline TraceSpan::TraceSpan(const char *name_) NOTHROWS :
+                name(name_),
+                beginNanos(0LL),
+                depth(0u),
+                active(Impl::tracingEnabled.load(std::memory_order_relaxed))
+            {
+                if (active)
+                    begin();
+            }
+            inline TraceSpan::~TraceSpan() NOTHROWS
+            {
+                if (active)
+                    end();
+            }
+        }
+    }
+}
+
+#define TE_TRACE_SPAN_CONCAT_IMPL(a, b) a##b
+#define TE_TRACE_SPAN_CONCAT(a, b) TE_TRACE_SPAN_CONCAT_IMPL(a, b)
+/** times the remainder of the enclosing scope under the specified name */
+#define TE_TRACE_SPAN(name) \
+    TAK::Engine::Util::TraceSpan TE_TRACE_SPAN_CONCAT(te_trace_span_, __LINE__)(name)
+
+#endif
@@ -1,7 +1,10 @@
 
-//#include <chrono>
+#include <chrono>
+#include <functional>
+#include <map>
 #include "thread/Thread.h"
 #include "util/Work.h"
+#include "util/Tracing.h"
 #include "port/Platform.h"
 
 using namespace TAK::Engine::Util;
@@ -20,6 +23,7 @@ TAKErr Work::signalWork() NOTHROWS {
 	MonitorLockPtr lockPtr(nullptr, nullptr);
 	TAKErr code = beginWorking(lockPtr);
 	if (code == TE_Ok) {
+		TE_TRACE_SPAN("Work::signalWork");
 		TAKErr resCode = this->onSignalWork(lockPtr);
 		if (!lockPtr.get())
 			MonitorLock_create(lockPtr, this->monitor_);
@@ -199,6 +203,11 @@ ControlWorker::~ControlWorker() NOTHROWS
 { }
 
 namespace {
+	int64_t systimeMicros() NOTHROWS {
+		using namespace std::chrono;
+		return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
 	class ControlQueue {
 	public:
 		struct Stats {
@@ -206,20 +215,40 @@ namespace {
 			size_t threadCount;
 		};
 
+		struct QueuedWork {
+			std::shared_ptr<Work> work;
+			int64_t estimatedCostMicros;
+			int64_t queuedMicros;
+		};
+
 		ControlQueue() NOTHROWS;
 		~ControlQueue() NOTHROWS;
 		TAKErr queueWork(const std::shared_ptr<Work> &work, Stats *optStats = nullptr) NOTHROWS;
+		TAKErr queueWork(const std::shared_ptr<Work> &work, int priority, int64_t estimatedCostMicros, Stats *optStats = nullptr) NOTHROWS;
 		TAKErr awaitWork(std::shared_ptr<Work> &workPtr, int64_t milliLimit) NOTHROWS;
 		TAKErr takeWork(std::shared_ptr<Work> &workPtr) NOTHROWS;
+		/**
+		 * Take the next work if its estimated cost fits in costLimitMicros.
+		 *
+		 * @return TE_Ok when taken, TE_Done when empty, TE_TimedOut when the next work does not fit
+		 */
+		TAKErr takeWork(QueuedWork &entry, int64_t costLimitMicros) NOTHROWS;
+		TAKErr getBacklog(std::size_t &count, int64_t &estimatedCostMicros) NOTHROWS;
 		TAKErr interrupt() NOTHROWS;
 		TAKErr cap() NOTHROWS;
 		TAKErr capAndInterrupt() NOTHROWS;
 		TAKErr attachThread() NOTHROWS;
 		TAKErr detachThread() NOTHROWS;
 
+	private:
+		void popWork(QueuedWork &entry) NOTHROWS;
+
 	private:
 		Monitor monitor;
-		std::deque<std::shared_ptr<Work>> workQueue;
+		// keyed on priority, highest first; FIFO within a priority
+		std::map<int, std::deque<QueuedWork>, std::greater<int>> workQueue;
+		std::size_t queuedCount;
+		int64_t queuedCostMicros;
 		Stats stats;
 		bool interrupted;
 		bool capped;
@@ -233,11 +262,30 @@ namespace {
 		TAKErr scheduleWork(std::shared_ptr<Work> work) NOTHROWS override;
 		TAKErr doAnyWork(int64_t millisecondLimit) NOTHROWS override;
 		TAKErr doAllWork(int64_t millisecondLimit) NOTHROWS override;
+		TAKErr schedulePrioritizedWork(std::shared_ptr<Work> work, int priority, int64_t estimatedCostMicros) NOTHROWS override;
+		TAKErr doBudgetedWork(int64_t microsecondBudget) NOTHROWS override;
+		TAKErr getStats(ControlWorkerStats &stats) NOTHROWS override;
 
 		ENGINE_API TAKErr interrupt() NOTHROWS override;
 
 	private:
 		std::shared_ptr<ControlQueue> controlQueue;
+		Monitor statsMonitor;
+		ControlWorkerStats stats;
+		// end of the last budgeted call; work queued before it was deferred
+		int64_t lastBudgetedEndMicros;
+	};
+
+	class PrioritizedWorker : public Worker {
+	public:
+		PrioritizedWorker(const std::shared_ptr<ControlWorker> &controlWorker, int priority, int64_t estimatedCostMicros) NOTHROWS;
+		~PrioritizedWorker() NOTHROWS override;
+		TAKErr scheduleWork(std::shared_ptr<Work> work) NOTHROWS override;
+
+	private:
+		std::shared_ptr<ControlWorker> controlWorker;
+		int priority;
+		int64_t estimatedCostMicros;
 	};
 
 	class ThreadWorker : public Worker {
@@ -295,7 +343,9 @@ namespace {
 	//
 
 	ControlQueue::ControlQueue() NOTHROWS
-		: stats{ 0, 0 },
+		: queuedCount(0u),
+		queuedCostMicros(0LL),
+		stats{ 0, 0 },
 	    interrupted(false),
 		capped(false)
 	{}
@@ -304,6 +354,12 @@ namespace {
 	{ }
 
 	TAKErr ControlQueue::queueWork(const std::shared_ptr<Work> &work, Stats *optStats) NOTHROWS {
+		return queueWork(work, 0, 0LL, optStats);
+	}
+
+	TAKErr ControlQueue::queueWork(const std::shared_ptr<Work> &work, int priority, int64_t estimatedCostMicros, Stats *optStats) NOTHROWS {
+		const int64_t queuedMicros = systimeMicros();
+
 		MonitorLockPtr lockPtr(nullptr, nullptr);
 		TAKErr code(MonitorLock_create(lockPtr, this->monitor));
 		TE_CHECKRETURN_CODE(code);
@@ -311,11 +367,17 @@ namespace {
 		if (this->capped)
 			return TE_Done;
 
+		if (estimatedCostMicros < 0LL)
+			estimatedCostMicros = 0LL;
+
 		TE_BEGIN_TRAP() {
-			workQueue.push_back(std::move(work));
+			workQueue[priority].push_back(QueuedWork{ work, estimatedCostMicros, queuedMicros });
 		} TE_END_TRAP(code);
 		TE_CHECKRETURN_CODE(code);
 
+		queuedCount++;
+		queuedCostMicros += estimatedCostMicros;
+
 		if (optStats)
 			*optStats = stats;
 
@@ -337,7 +399,7 @@ namespace {
 				return TE_Interrupted;
 			}
 
-			while (workQueue.size() == 0) {
+			while (queuedCount == 0) {
 
 				if (this->capped) {
 					return TE_Done;
@@ -357,8 +419,9 @@ namespace {
 				}
 			}
 
-			workPtr = workQueue.front();
-			workQueue.pop_front();
+			QueuedWork entry;
+			popWork(entry);
+			workPtr = std::move(entry.work);
 		}
 
 		return TE_Ok;
@@ -372,15 +435,56 @@ namespace {
 		if (this->interrupted)
 			return TE_Interrupted;
 
-		if (workQueue.size() == 0)
+		if (queuedCount == 0)
 			return TE_Done;
 
-		workPtr = workQueue.front();
-		workQueue.pop_front();
+		QueuedWork entry;
+		popWork(entry);
+		workPtr = std::move(entry.work);
 
 		return TE_Ok;
 	}
 
+	TAKErr ControlQueue::takeWork(QueuedWork &entry, int64_t costLimitMicros) NOTHROWS {
+		MonitorLockPtr lockPtr(nullptr, nullptr);
+		TAKErr code(MonitorLock_create(lockPtr, this->monitor));
+		TE_CHECKRETURN_CODE(code);
+
+		if (this->interrupted)
+			return TE_Interrupted;
+
+		if (queuedCount == 0)
+			return TE_Done;
+
+		// never skip ahead of the next work, that would break priority and FIFO order
+		if (workQueue.begin()->second.front().estimatedCostMicros > costLimitMicros)
+			return TE_TimedOut;
+
+		popWork(entry);
+		return TE_Ok;
+	}
+
+	TAKErr ControlQueue::getBacklog(std::size_t &count, int64_t &estimatedCostMicros) NOTHROWS {
+		MonitorLockPtr lockPtr(nullptr, nullptr);
+		TAKErr code(MonitorLock_create(lockPtr, this->monitor));
+		TE_CHECKRETURN_CODE(code);
+
+		count = queuedCount;
+		estimatedCostMicros = queuedCostMicros;
+		return TE_Ok;
+	}
+
+	void ControlQueue::popWork(QueuedWork &entry) NOTHROWS {
+		auto level = workQueue.begin();
+		entry = std::move(level->second.front());
+		level->second.pop_front();
+		if (level->second.empty())
+			workQueue.erase(level);
+
+		queuedCount--;
+		queuedCostMicros -= entry.estimatedCostMicros;
+	}
+
 	TAKErr ControlQueue::interrupt() NOTHROWS {
 		MonitorLockPtr lockPtr(nullptr, nullptr);
 		TAKErr code(MonitorLock_create(lockPtr, this->monitor));
@@ -433,7 +537,9 @@ namespace {
 	//
 
 	ControlWorkerImpl::ControlWorkerImpl(const std::shared_ptr<ControlQueue> &controlQueue) NOTHROWS
-		: controlQueue(controlQueue)
+		: controlQueue(controlQueue),
+		stats{ 0u, 0u, 0u, 0u, 0LL, 0u, 0LL, 0LL, 0LL },
+		lastBudgetedEndMicros(INT64_MIN)
 	{}
 
 	ControlWorkerImpl::~ControlWorkerImpl() NOTHROWS
@@ -485,8 +591,107 @@ namespace {
 		return TE_TimedOut;
 	}
 
+	TAKErr ControlWorkerImpl::schedulePrioritizedWork(std::shared_ptr<Work> work, int priority, int64_t estimatedCostMicros) NOTHROWS {
+		return controlQueue->queueWork(work, priority, estimatedCostMicros);
+	}
+
+	TAKErr ControlWorkerImpl::doBudgetedWork(int64_t microsecondBudget) NOTHROWS {
+
+		const int64_t start = systimeMicros();
+		const int64_t deferredBefore = lastBudgetedEndMicros;
+
+		std::size_t workDone = 0u;
+		std::size_t deferredWorkDone = 0u;
+		int64_t deferredLatency = 0LL;
+		int64_t maxDeferredLatency = 0LL;
+
+		TAKErr code;
+		int64_t remaining = microsecondBudget;
+		while (true) {
+			ControlQueue::QueuedWork entry;
+			// the first unit of work is always done so that expensive work makes progress
+			code = this->controlQueue->takeWork(entry, workDone ? remaining : INT64_MAX);
+			if (code != TE_Ok)
+				break;
+
+			const int64_t begin = systimeMicros();
+			if (entry.queuedMicros < deferredBefore) {
+				const int64_t latency = begin - entry.queuedMicros;
+				deferredWorkDone++;
+				deferredLatency += latency;
+				if (latency > maxDeferredLatency)
+					maxDeferredLatency = latency;
+			}
+
+			entry.work->signalWork();
+			workDone++;
+
+			remaining = microsecondBudget - (systimeMicros() - start);
+			if (remaining <= 0LL) {
+				code = TE_TimedOut;
+				break;
+			}
+		}
+
+		const int64_t end = systimeMicros();
+		lastBudgetedEndMicros = end;
+
+		std::size_t backlog = 0u;
+		int64_t backlogCost = 0LL;
+		this->controlQueue->getBacklog(backlog, backlogCost);
+		if (code == TE_TimedOut && !backlog)
+			code = TE_Done;
+
+		{
+			MonitorLockPtr lockPtr(nullptr, nullptr);
+			TAKErr lockCode(MonitorLock_create(lockPtr, this->statsMonitor));
+			TE_CHECKRETURN_CODE(lockCode);
+
+			stats.budgetedCalls++;
+			if (backlog)
+				stats.deferringCalls++;
+			stats.workDone += workDone;
+			stats.workDeferred += backlog;
+			stats.deferredCostMicros += backlogCost;
+			stats.deferredWorkDone += deferredWorkDone;
+			stats.deferredLatencyMicros += deferredLatency;
+			if (maxDeferredLatency > stats.maxDeferredLatencyMicros)
+				stats.maxDeferredLatencyMicros = maxDeferredLatency;
+			if ((end - start) > stats.maxCallMicros)
+				stats.maxCallMicros = (end - start);
+		}
+
+		return code;
+	}
+
+	TAKErr ControlWorkerImpl::getStats(ControlWorkerStats &value) NOTHROWS {
+		MonitorLockPtr lockPtr(nullptr, nullptr);
+		TAKErr code(MonitorLock_create(lockPtr, this->statsMonitor));
+		TE_CHECKRETURN_CODE(code);
+
+		value = stats;
+		return TE_Ok;
+	}
+
 	TAKErr ControlWorkerImpl::interrupt() NOTHROWS {
 		return controlQueue->interrupt();
+	}
+
+	//
+	// PrioritizedWorker
+	//
+
+	PrioritizedWorker::PrioritizedWorker(const std::shared_ptr<ControlWorker> &controlWorker, int priority, int64_t estimatedCostMicros) NOTHROWS
+		: controlWorker(controlWorker),
+		priority(priority),
+		estimatedCostMicros(estimatedCostMicros)
+	{}
+
+	PrioritizedWorker::~PrioritizedWorker() NOTHROWS
+	{ }
+
+	TAKErr PrioritizedWorker::scheduleWork(std::shared_ptr<Work> work) NOTHROWS {
+		return controlWorker->schedulePrioritizedWork(work, priority, estimatedCostMicros);
 	}
 
 	//
@@ -635,6 +840,13 @@ TAKErr TAK::Engine::Util::Worker_createControlWorker(std::shared_ptr<ControlWork
 	return TE_Ok;
 }
 
+TAKErr TAK::Engine::Util::Worker_createPrioritized(SharedWorkerPtr &worker, const std::shared_ptr<ControlWorker> &controlWorker, int priority, int64_t estimatedCostMicros) NOTHROWS {
+	if (!controlWorker)
+		return TE_InvalidArg;
+	worker = std::make_shared<PrioritizedWorker>(controlWorker, priority, estimatedCostMicros);
+	return TE_Ok;
+}
+
 TAKErr TAK::Engine::Util::Worker_createThreadPool(SharedWorkerPtr &worker, size_t minThreadCount, size_t maxThreadCount, int64_t keepAliveMillis) NOTHROWS {
 	std::shared_ptr<ControlQueue> controlQueue(new ControlQueue());
 	std::shared_ptr<ThreadPoolWorker> threadWorker;
@@ -181,13 +181,65 @@ namespace TAK {
 				ENGINE_API virtual TAKErr scheduleWork(std::shared_ptr<Work> work) NOTHROWS = 0;
 			};
 
+			/**
+			 * Accounting for budgeted work done by a ControlWorker. Times are in microseconds.
+			 */
+			struct ControlWorkerStats {
+				/** number of calls to doBudgetedWork */
+				std::size_t budgetedCalls;
+				/** number of budgeted calls that left work queued */
+				std::size_t deferringCalls;
+				/** units of work done by budgeted calls */
+				std::size_t workDone;
+				/** units of work left queued at the end of budgeted calls; work deferred over N calls counts N times */
+				std::size_t workDeferred;
+				/** sum of the estimated cost of work left queued at the end of budgeted calls */
+				int64_t deferredCostMicros;
+				/** units of previously deferred work that have since been done */
+				std::size_t deferredWorkDone;
+				/** sum of the time previously deferred work waited between being scheduled and being done */
+				int64_t deferredLatencyMicros;
+				/** longest time any previously deferred work waited */
+				int64_t maxDeferredLatencyMicros;
+				/** longest single budgeted call */
+				int64_t maxCallMicros;
+			};
+
 			/**
 			 * A special Worker that may be externally controlled.
+			 *
+			 * <p>Work is done highest priority first, and in the order it was scheduled within a priority.
+			 * Work scheduled through scheduleWork has priority 0 and an unknown (0) cost.</p>
 			 */
 			class ControlWorker : public Worker {
 			public:
 				ENGINE_API virtual ~ControlWorker() NOTHROWS;
 
+				/**
+				 * Schedule the work with a priority and an estimated cost.
+				 *
+				 * @param work the work to be scheduled
+				 * @param priority the priority; higher priority work is done first
+				 * @param estimatedCostMicros the estimated time to do the work in microseconds, 0 if unknown
+				 */
+				ENGINE_API virtual TAKErr schedulePrioritizedWork(std::shared_ptr<Work> work, int priority, int64_t estimatedCostMicros) NOTHROWS = 0;
+
+				/**
+				 * Do work until no work exists or microsecondBudget is used up. Work whose estimated cost exceeds
+				 * what is left of the budget is deferred to the next call, along with all work behind it. The first
+				 * unit of work is always done, so expensive work cannot be deferred indefinitely.
+				 *
+				 * @return TE_Done when no work remains
+				 *         TE_TimedOut when work was deferred
+				 *         TE_Interrupted when the worker was interrupted
+				 */
+				ENGINE_API virtual TAKErr doBudgetedWork(int64_t microsecondBudget) NOTHROWS = 0;
+
+				/**
+				 * Get the accounting for budgeted work done so far.
+				 */
+				ENGINE_API virtual TAKErr getStats(ControlWorkerStats &stats) NOTHROWS = 0;
+
 				/**
 				 * Do work until no work exists or millisecondsLimit is met or exceeded.
 				 */
@@ -242,6 +294,19 @@ namespace TAK {
 			 */
 			ENGINE_API TAKErr Worker_createControlWorker(std::shared_ptr<ControlWorker> &controlWorker) NOTHROWS;
 
+			/**
+			 * Create a worker that schedules all of its work on a ControlWorker with a fixed priority and estimated
+			 * cost. Useful where only a plain Worker can be supplied (i.e. Task::thenOn).
+			 *
+			 * @param worker OUT the resulting worker
+			 * @param controlWorker the ControlWorker that does the work
+			 * @param priority the priority of the work
+			 * @param estimatedCostMicros the estimated time to do each unit of work in microseconds, 0 if unknown
+			 *
+			 * @return TE_Ok on success
+			 */
+			ENGINE_API TAKErr Worker_createPrioritized(SharedWorkerPtr &worker, const std::shared_ptr<ControlWorker> &controlWorker, int priority, int64_t estimatedCostMicros) NOTHROWS;
+
 			/**
 			 * A thread-pool based worker that can "flex" up and down based on need. It is best to
 			 * use this for tasks that block and wait on things (like IO), or very short lived non-taxing
@@ -0,0 +1,408 @@
+// Catalog validation benchmark.
+//
+// Writes one small file per catalog entry (50k by default) into a temporary
+// directory, catalogs them with a currency that records each file's size and
+// modification time, removes a fraction of the files and then validates the
+// catalog, which must remove exactly the entries whose files are gone.
+//
+// Each catalog is validated twice, from a freshly built catalog each time:
+//     serial      the whole catalog is walked and each invalid entry deleted
+//                 while the catalog is locked, as validateCatalog did before
+//                 the currency checks were moved off the lock
+//     parallel    CatalogDatabase2::validateCatalog
+// While validation runs, a probe thread repeatedly calls validateCatalogPath
+// for an entry that stays valid.  Each call takes the catalog lock, so the
+// longest probe call bounds the longest time validation held the lock, and
+// the mean shows the cost of a call when the lock is free.
+//
+// The benchmark exits non-zero if validation fails or leaves the wrong
+// number of entries.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "currency/CatalogDatabase2.h"
+#include "currency/Currency2.h"
+#include "currency/CurrencyRegistry2.h"
+#include "db/Database2.h"
+#include "thread/Lock.h"
+
+using namespace TAK::Engine::Currency;
+using namespace TAK::Engine::DB;
+using namespace TAK::Engine::Thread;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    const std::size_t FILES_PER_DIR = 500u;
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        const char *parentDir;
+        std::size_t numEntries;
+        std::size_t removePercent;
+        bool keep;
+    };
+
+    /**
+     * Records the size and modification time of the file; the entry is valid
+     * while both are unchanged.
+     */
+    class StatCurrency : public CatalogCurrency2
+    {
+    public :
+        StatCurrency() NOTHROWS;
+        ~StatCurrency() NOTHROWS override;
+    public :
+        const char *getName() const NOTHROWS override;
+        int getAppVersion() const NOTHROWS override;
+        TAKErr getAppData(AppDataPtr &data, const char *file) const NOTHROWS override;
+        TAKErr isValidApp(bool *value, const char *f, const int appVersion, const AppData &data) const NOTHROWS override;
+    };
+
+    class BenchCatalog : public CatalogDatabase2
+    {
+    public :
+        BenchCatalog(CatalogCurrencyRegistry2 &registry) NOTHROWS;
+        ~BenchCatalog() NOTHROWS override;
+    public :
+        /** adds an entry for each file, in one transaction */
+        TAKErr populate(const std::vector<std::string> &files, CatalogCurrency2 &currency) NOTHROWS;
+        /** validates the whole catalog with the catalog locked throughout */
+        TAKErr validateCatalogSerial() NOTHROWS;
+        TAKErr getEntryCount(std::size_t *value) NOTHROWS;
+    };
+
+    struct Result
+    {
+        double validateMillis;
+        std::size_t probes;
+        double maxWaitMillis;
+        double meanWaitMillis;
+        std::size_t remaining;
+    };
+
+    TAKErr run(Result *value, const Options &opts, const std::string &dir, const std::vector<std::string> &files, const bool serial) NOTHROWS;
+    TAKErr writeFiles(const std::vector<std::string> &files) NOTHROWS;
+    bool isRemoved(const Options &opts, const std::size_t index) NOTHROWS;
+    void cleanup(const std::string &dir, const std::vector<std::string> &files) NOTHROWS;
+    void appDataDeleter(const CatalogCurrency2::AppData *data);
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-o") && hasValue) {
+            opts.parentDir = argv[++i];
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.numEntries = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-x") && hasValue) {
+            opts.removePercent = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-k")) {
+            opts.keep = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    // the probe needs an entry that stays valid
+    if (opts.numEntries < 2u || opts.removePercent >= 100u) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string dir(opts.parentDir);
+    dir += "/catalogbench.XXXXXX";
+    std::vector<char> dirTemplate(dir.begin(), dir.end());
+    dirTemplate.push_back('\0');
+    if (!mkdtemp(dirTemplate.data())) {
+        fprintf(stderr, "Failed to create a temporary directory in %s\n", opts.parentDir);
+        return 1;
+    }
+    dir = dirTemplate.data();
+
+    std::vector<std::string> files;
+    files.reserve(opts.numEntries);
+    for (std::size_t i = 0u; i < opts.numEntries; i++) {
+        std::ostringstream path;
+        path << dir << "/" << (i / FILES_PER_DIR);
+        if (!(i % FILES_PER_DIR))
+            mkdir(path.str().c_str(), 0755);
+        path << "/" << i << ".dat";
+        files.push_back(path.str());
+    }
+
+    std::size_t numRemoved = 0u;
+    for (std::size_t i = 0u; i < files.size(); i++)
+        if (isRemoved(opts, i))
+            numRemoved++;
+
+    printf("%u entries, %u files removed, in %s\n\n", (unsigned)opts.numEntries, (unsigned)numRemoved, dir.c_str());
+    printf("mode        validate ms   probes  max wait ms  mean wait ms  remaining\n");
+
+    bool ok = true;
+    for (int i = 0; i < 2; i++) {
+        const bool serial = !i;
+        Result result;
+        const TAKErr code = run(&result, opts, dir, files, serial);
+        if (code != TE_Ok) {
+            fprintf(stderr, "%s validation failed\n", serial ? "serial" : "parallel");
+            ok = false;
+            break;
+        }
+        printf("%-10s %12.1f %8u %12.2f %13.3f %10u\n",
+               serial ? "serial" : "parallel",
+               result.validateMillis, (unsigned)result.probes, result.maxWaitMillis, result.meanWaitMillis,
+               (unsigned)result.remaining);
+        if (result.remaining != opts.numEntries - numRemoved) {
+            fprintf(stderr, "%s validation left %u entries, expected %u\n", serial ? "serial" : "parallel",
+                    (unsigned)result.remaining, (unsigned)(opts.numEntries - numRemoved));
+            ok = false;
+        }
+    }
+
+    if (opts.keep)
+        printf("\nkept %s\n", dir.c_str());
+    else
+        cleanup(dir, files);
+    return ok ? 0 : 1;
+}
+
+namespace
+{
+    Options::Options() NOTHROWS :
+#ifdef __ANDROID__
+        parentDir("/data/local/tmp"),
+#else
+        parentDir("/tmp"),
+#endif
+        numEntries(50000u),
+        removePercent(10u),
+        keep(false)
+    {}
+
+    StatCurrency::StatCurrency() NOTHROWS
+    {}
+    StatCurrency::~StatCurrency() NOTHROWS
+    {}
+    const char *StatCurrency::getName() const NOTHROWS
+    {
+        return "catalogbench";
+    }
+    int StatCurrency::getAppVersion() const NOTHROWS
+    {
+        return 1;
+    }
+    TAKErr StatCurrency::getAppData(AppDataPtr &data, const char *file) const NOTHROWS
+    {
+        struct stat info;
+        if (!file || stat(file, &info))
+            return TE_IO;
+        const int64_t stamp[2] = { static_cast<int64_t>(info.st_size), static_cast<int64_t>(info.st_mtime) };
+        auto *blob = new uint8_t[sizeof(stamp)];
+        memcpy(blob, stamp, sizeof(stamp));
+        data = AppDataPtr(new AppData{ blob, sizeof(stamp) }, appDataDeleter);
+        return TE_Ok;
+    }
+    TAKErr StatCurrency::isValidApp(bool *value, const char *f, const int appVersion, const AppData &data) const NOTHROWS
+    {
+        if (!value)
+            return TE_InvalidArg;
+        *value = false;
+        int64_t stamp[2];
+        if (appVersion != getAppVersion() || data.length != sizeof(stamp))
+            return TE_Ok;
+        memcpy(stamp, data.value, sizeof(stamp));
+
+        struct stat info;
+        if (!f || stat(f, &info))
+            return TE_Ok;
+        *value = (stamp[0] == static_cast<int64_t>(info.st_size) && stamp[1] == static_cast<int64_t>(info.st_mtime));
+        return TE_Ok;
+    }
+
+    BenchCatalog::BenchCatalog(CatalogCurrencyRegistry2 &registry) NOTHROWS :
+        CatalogDatabase2(registry)
+    {}
+    BenchCatalog::~BenchCatalog() NOTHROWS
+    {}
+    TAKErr BenchCatalog::populate(const std::vector<std::string> &files, CatalogCurrency2 &currency) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        Lock lock(mutex);
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+
+        Database2::Transaction transaction(*this->database);
+        if (!transaction.isValid())
+            return TE_Err;
+        for (std::size_t i = 0u; i < files.size(); i++) {
+            int64_t rowId;
+            code = this->addCatalogEntryNoSync(&rowId, files[i].c_str(), currency);
+            TE_CHECKBREAK_CODE(code);
+        }
+        TE_CHECKRETURN_CODE(code);
+        return this->database->setTransactionSuccessful();
+    }
+    TAKErr BenchCatalog::validateCatalogSerial() NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        Lock lock(mutex);
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+
+        CatalogCursorPtr result(nullptr, nullptr);
+        code = this->queryCatalog(result);
+        TE_CHECKRETURN_CODE(code);
+        return this->validateCatalogNoSync(*result);
+    }
+    TAKErr BenchCatalog::getEntryCount(std::size_t *value) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        CatalogCursorPtr result(nullptr, nullptr);
+        code = this->queryCatalog(result);
+        TE_CHECKRETURN_CODE(code);
+        *value = 0u;
+        do {
+            code = result->moveToNext();
+            TE_CHECKBREAK_CODE(code);
+            (*value)++;
+        } while (true);
+        if (code == TE_Done)
+            code = TE_Ok;
+        return code;
+    }
+
+    TAKErr run(Result *value, const Options &opts, const std::string &dir, const std::vector<std::string> &files, const bool serial) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+
+        // every file is present and every entry valid until the removal
+        code = writeFiles(files);
+        TE_CHECKRETURN_CODE(code);
+
+        const std::string catalogPath(dir + "/catalog.sqlite");
+        remove(catalogPath.c_str());
+
+        StatCurrency currency;
+        CatalogCurrencyRegistry2 registry;
+        registry.registerCurrency(&currency);
+
+        BenchCatalog catalog(registry);
+        code = catalog.open(catalogPath.c_str());
+        TE_CHECKRETURN_CODE(code);
+        code = catalog.populate(files, currency);
+        TE_CHECKRETURN_CODE(code);
+
+        std::string probePath;
+        for (std::size_t i = 0u; i < files.size(); i++) {
+            if (isRemoved(opts, i))
+                remove(files[i].c_str());
+            else if (probePath.empty())
+                probePath = files[i];
+        }
+
+        std::atomic<bool> done(false);
+        std::size_t probes = 0u;
+        double maxWaitNanos = 0.0;
+        double sumWaitNanos = 0.0;
+        std::thread probe([&]()
+        {
+            while (!done) {
+                const auto start = std::chrono::high_resolution_clock::now();
+                catalog.validateCatalogPath(probePath.c_str());
+                const auto end = std::chrono::high_resolution_clock::now();
+                const double nanos = std::chrono::duration<double, std::nano>(end - start).count();
+                maxWaitNanos = std::max(maxWaitNanos, nanos);
+                sumWaitNanos += nanos;
+                probes++;
+            }
+        });
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        if (serial)
+            code = catalog.validateCatalogSerial();
+        else
+            code = catalog.validateCatalog();
+        const auto end = std::chrono::high_resolution_clock::now();
+        done = true;
+        probe.join();
+        TE_CHECKRETURN_CODE(code);
+
+        value->validateMillis = std::chrono::duration<double, std::milli>(end - start).count();
+        value->probes = probes;
+        value->maxWaitMillis = maxWaitNanos / 1e6;
+        value->meanWaitMillis = probes ? (sumWaitNanos / static_cast<double>(probes)) / 1e6 : 0.0;
+        return catalog.getEntryCount(&value->remaining);
+    }
+
+    TAKErr writeFiles(const std::vector<std::string> &files) NOTHROWS
+    {
+        for (std::size_t i = 0u; i < files.size(); i++) {
+            FILE *f = fopen(files[i].c_str(), "wb");
+            if (!f)
+                return TE_IO;
+            fprintf(f, "%u\n", (unsigned)i);
+            fclose(f);
+        }
+        return TE_Ok;
+    }
+
+    bool isRemoved(const Options &opts, const std::size_t index) NOTHROWS
+    {
+        // spread the removed files evenly over the catalog
+        return ((index * opts.removePercent) % 100u) + opts.removePercent >= 100u;
+    }
+
+    void cleanup(const std::string &dir, const std::vector<std::string> &files) NOTHROWS
+    {
+        for (std::size_t i = 0u; i < files.size(); i++)
+            remove(files[i].c_str());
+        for (std::size_t i = 0u; i < files.size(); i += FILES_PER_DIR) {
+            std::ostringstream path;
+            path << dir << "/" << (i / FILES_PER_DIR);
+            rmdir(path.str().c_str());
+        }
+        remove((dir + "/catalog.sqlite").c_str());
+        remove((dir + "/catalog.sqlite-journal").c_str());
+        rmdir(dir.c_str());
+    }
+
+    void appDataDeleter(const CatalogCurrency2::AppData *data)
+    {
+        delete[] data->value;
+        delete data;
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -o <dir>      directory in which to create the temporary directory (default /data/local/tmp,\n");
+        printf("                  /tmp off Android)\n");
+        printf("    -n <count>    catalog entries (default 50000)\n");
+        printf("    -x <percent>  percentage of the files removed before validation (default 10)\n");
+        printf("    -k            keep the temporary directory\n");
+        printf("    -h            print this message\n");
+    }
+}
@@ -0,0 +1,411 @@
+// Elevation source registry contention benchmark.
+//
+// Attaches a set of synthetic elevation sources, each covering a one degree
+// cell, and runs query threads that repeatedly ask ElevationSourceManager
+// for the sources intersecting a random region, as elevation queries with a
+// spatial filter do.  Each configuration is run without and with churn:
+// two writer threads that concurrently attach and detach a small pool of
+// further sources and change their bounds, at a fixed interval.
+//
+// For each run it reports the query throughput and latency, sampled on
+// every query, and the latency of the attach and detach calls.  After each
+// run every churn source must be subscribed to content changes exactly when
+// it is attached, and the registry must hold the expected sources; the
+// benchmark exits non-zero otherwise.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elevation/ElevationSource.h"
+#include "elevation/ElevationSourceManager.h"
+#include "feature/Envelope2.h"
+#include "port/STLVectorAdapter.h"
+#include "thread/Lock.h"
+#include "thread/Mutex.h"
+
+using namespace TAK::Engine::Elevation;
+using namespace TAK::Engine::Feature;
+using namespace TAK::Engine::Port;
+using namespace TAK::Engine::Thread;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    const std::size_t NUM_CHURN_SOURCES = 4u;
+    const std::size_t NUM_WRITERS = 2u;
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        std::vector<std::size_t> threads;
+        std::size_t numSources;
+        std::size_t durationMillis;
+        std::size_t churnMillis;
+        double regionDegrees;
+    };
+
+    /**
+     * A source with fixed bounds that produces no data. The bounds may be
+     * changed, which notifies the listeners after the source's lock is
+     * released, as the listeners read the bounds back.
+     */
+    class SyntheticSource : public ElevationSource
+    {
+    public :
+        SyntheticSource(const char *name, const Envelope2 &bounds) NOTHROWS;
+        ~SyntheticSource() NOTHROWS override;
+    public :
+        const char *getName() const NOTHROWS override;
+        TAKErr query(ElevationChunkCursorPtr &value, const QueryParameters &params) NOTHROWS override;
+        Envelope2 getBounds() const NOTHROWS override;
+        TAKErr addOnContentChangedListener(OnContentChangedListener *l) NOTHROWS override;
+        TAKErr removeOnContentChangedListener(OnContentChangedListener *l) NOTHROWS override;
+    public :
+        void setBounds(const Envelope2 &bounds) NOTHROWS;
+        std::size_t getListenerCount() const NOTHROWS;
+    private :
+        std::string name;
+        Envelope2 bounds;
+        std::set<OnContentChangedListener *> listeners;
+        mutable Mutex mutex;
+    };
+
+    struct Result
+    {
+        std::size_t queries;
+        double queriesPerSecond;
+        double meanMicros;
+        double p99Micros;
+        double maxMicros;
+        std::size_t writes;
+        double meanWriteMicros;
+        double maxWriteMicros;
+    };
+
+    bool run(Result *value, const Options &opts, const std::size_t numThreads, const bool churn,
+             std::vector<std::shared_ptr<SyntheticSource>> &churnSources) NOTHROWS;
+    Envelope2 cellBounds(const std::size_t index) NOTHROWS;
+    bool parseThreads(std::vector<std::size_t> &value, const char *arg) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-t") && hasValue) {
+            if (!parseThreads(opts.threads, argv[++i])) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(arg, "-s") && hasValue) {
+            opts.numSources = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-d") && hasValue) {
+            opts.durationMillis = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-c") && hasValue) {
+            opts.churnMillis = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-r") && hasValue) {
+            opts.regionDegrees = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.numSources || !opts.durationMillis || !opts.churnMillis || opts.regionDegrees <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // the fixed sources, laid out over one degree cells
+    std::vector<std::shared_ptr<SyntheticSource>> sources;
+    for (std::size_t i = 0u; i < opts.numSources; i++) {
+        std::ostringstream name;
+        name << "elevationbench." << i;
+        sources.push_back(std::make_shared<SyntheticSource>(name.str().c_str(), cellBounds(i)));
+        if (ElevationSourceManager_attach(sources.back()) != TE_Ok) {
+            fprintf(stderr, "Failed to attach %s\n", name.str().c_str());
+            return 1;
+        }
+    }
+    std::vector<std::shared_ptr<SyntheticSource>> churnSources;
+    for (std::size_t i = 0u; i < NUM_CHURN_SOURCES; i++) {
+        std::ostringstream name;
+        name << "elevationbench.churn." << i;
+        churnSources.push_back(std::make_shared<SyntheticSource>(name.str().c_str(), cellBounds(i * 7u)));
+    }
+
+    printf("%u sources, %.1f degree query regions, %u ms per run, churn every %u ms on %u writer threads\n\n",
+           (unsigned)opts.numSources, opts.regionDegrees, (unsigned)opts.durationMillis, (unsigned)opts.churnMillis,
+           (unsigned)NUM_WRITERS);
+    printf("threads churn   queries/s   mean us    p99 us    max us   writes  mean write us  max write us\n");
+
+    bool ok = true;
+    for (std::size_t i = 0u; i < opts.threads.size(); i++) {
+        for (int c = 0; c < 2; c++) {
+            const bool churn = !!c;
+            Result result;
+            if (!run(&result, opts, opts.threads[i], churn, churnSources))
+                ok = false;
+            printf("%7u %5s %11.0f %9.2f %9.2f %9.1f %8u %14.1f %13.1f\n",
+                   (unsigned)opts.threads[i], churn ? "yes" : "no",
+                   result.queriesPerSecond, result.meanMicros, result.p99Micros, result.maxMicros,
+                   (unsigned)result.writes, result.meanWriteMicros, result.maxWriteMicros);
+        }
+    }
+
+    for (std::size_t i = 0u; i < sources.size(); i++)
+        ElevationSourceManager_detach(*sources[i]);
+    return ok ? 0 : 1;
+}
+
+namespace
+{
+    Options::Options() NOTHROWS :
+        numSources(500u),
+        durationMillis(2000u),
+        churnMillis(5u),
+        regionDegrees(2.0)
+    {
+        threads.push_back(1u);
+        threads.push_back(2u);
+        threads.push_back(4u);
+        threads.push_back(8u);
+    }
+
+    SyntheticSource::SyntheticSource(const char *name_, const Envelope2 &bounds_) NOTHROWS :
+        name(name_),
+        bounds(bounds_)
+    {}
+    SyntheticSource::~SyntheticSource() NOTHROWS
+    {}
+    const char *SyntheticSource::getName() const NOTHROWS
+    {
+        return name.c_str();
+    }
+    TAKErr SyntheticSource::query(ElevationChunkCursorPtr &, const QueryParameters &) NOTHROWS
+    {
+        return TE_Unsupported;
+    }
+    Envelope2 SyntheticSource::getBounds() const NOTHROWS
+    {
+        Lock lock(mutex);
+        return bounds;
+    }
+    TAKErr SyntheticSource::addOnContentChangedListener(OnContentChangedListener *l) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        Lock lock(mutex);
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+        listeners.insert(l);
+        return code;
+    }
+    TAKErr SyntheticSource::removeOnContentChangedListener(OnContentChangedListener *l) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        Lock lock(mutex);
+        code = lock.status;
+        TE_CHECKRETURN_CODE(code);
+        listeners.erase(l);
+        return code;
+    }
+    void SyntheticSource::setBounds(const Envelope2 &bounds_) NOTHROWS
+    {
+        std::set<OnContentChangedListener *> notify;
+        {
+            Lock lock(mutex);
+            bounds = bounds_;
+            notify = listeners;
+        }
+        for (auto it = notify.begin(); it != notify.end(); it++)
+            (*it)->onContentChanged(*this);
+    }
+    std::size_t SyntheticSource::getListenerCount() const NOTHROWS
+    {
+        Lock lock(mutex);
+        return listeners.size();
+    }
+
+    bool run(Result *value, const Options &opts, const std::size_t numThreads, const bool churn,
+             std::vector<std::shared_ptr<SyntheticSource>> &churnSources) NOTHROWS
+    {
+        std::atomic<bool> done(false);
+        std::atomic<std::size_t> failures(0u);
+
+        std::vector<std::vector<double>> latencies(numThreads);
+        std::vector<std::thread> queryThreads;
+        for (std::size_t t = 0u; t < numThreads; t++) {
+            latencies[t].reserve(1u << 20u);
+            queryThreads.push_back(std::thread([&, t]()
+            {
+                std::mt19937 rng(static_cast<uint32_t>(t + 1u));
+                std::uniform_real_distribution<double> lon(-180.0, 180.0 - opts.regionDegrees);
+                std::uniform_real_distribution<double> lat(-90.0, 90.0 - opts.regionDegrees);
+                std::vector<std::shared_ptr<ElevationSource>> found;
+                while (!done) {
+                    const double x = lon(rng);
+                    const double y = lat(rng);
+                    const Envelope2 region(x, y, 0.0, x + opts.regionDegrees, y + opts.regionDegrees, 0.0);
+                    found.clear();
+                    STLVectorAdapter<std::shared_ptr<ElevationSource>> foundAdapter(found);
+
+                    const auto start = std::chrono::high_resolution_clock::now();
+                    const TAKErr code = ElevationSourceManager_getSources(foundAdapter, region);
+                    const auto end = std::chrono::high_resolution_clock::now();
+
+                    if (code != TE_Ok)
+                        failures++;
+                    latencies[t].push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                }
+            }));
+        }
+
+        std::vector<std::vector<double>> writeLatencies(NUM_WRITERS);
+        std::vector<std::thread> writeThreads;
+        if (churn) {
+            for (std::size_t w = 0u; w < NUM_WRITERS; w++) {
+                writeThreads.push_back(std::thread([&, w]()
+                {
+                    std::mt19937 rng(static_cast<uint32_t>(1000u + w));
+                    std::uniform_int_distribution<std::size_t> pick(0u, churnSources.size() - 1u);
+                    std::uniform_int_distribution<std::size_t> op(0u, 3u);
+                    std::uniform_int_distribution<std::size_t> cell(0u, 64800u - 1u);
+                    while (!done) {
+                        const std::shared_ptr<SyntheticSource> &source = churnSources[pick(rng)];
+                        const std::size_t o = op(rng);
+                        if (o == 3u) {
+                            // not timed; the manager republishes under its lock
+                            source->setBounds(cellBounds(cell(rng)));
+                        } else {
+                            // both writers pick from the same pool, so an
+                            // attach and a detach of one source may race
+                            const auto start = std::chrono::high_resolution_clock::now();
+                            if (o & 1u)
+                                ElevationSourceManager_attach(source);
+                            else
+                                ElevationSourceManager_detach(*source);
+                            const auto end = std::chrono::high_resolution_clock::now();
+                            writeLatencies[w].push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(opts.churnMillis));
+                    }
+                }));
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(opts.durationMillis));
+        done = true;
+        for (std::size_t t = 0u; t < queryThreads.size(); t++)
+            queryThreads[t].join();
+        for (std::size_t w = 0u; w < writeThreads.size(); w++)
+            writeThreads[w].join();
+
+        std::vector<double> all;
+        for (std::size_t t = 0u; t < latencies.size(); t++)
+            all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        std::vector<double> writes;
+        for (std::size_t w = 0u; w < writeLatencies.size(); w++)
+            writes.insert(writes.end(), writeLatencies[w].begin(), writeLatencies[w].end());
+
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < all.size(); i++)
+            sum += all[i];
+        std::sort(all.begin(), all.end());
+        value->queries = all.size();
+        value->queriesPerSecond = static_cast<double>(all.size()) / (static_cast<double>(opts.durationMillis) / 1000.0);
+        value->meanMicros = all.empty() ? 0.0 : sum / static_cast<double>(all.size());
+        value->p99Micros = all.empty() ? 0.0 : all[(all.size() * 99u) / 100u];
+        value->maxMicros = all.empty() ? 0.0 : all.back();
+
+        double writeSum = 0.0;
+        for (std::size_t i = 0u; i < writes.size(); i++)
+            writeSum += writes[i];
+        value->writes = writes.size();
+        value->meanWriteMicros = writes.empty() ? 0.0 : writeSum / static_cast<double>(writes.size());
+        value->maxWriteMicros = writes.empty() ? 0.0 : *std::max_element(writes.begin(), writes.end());
+
+        bool ok = true;
+        if (failures) {
+            fprintf(stderr, "%u source queries failed\n", (unsigned)failures);
+            ok = false;
+        }
+
+        // each churn source must be subscribed exactly while it is attached.
+        // Detach them for the next run.
+        for (std::size_t i = 0u; i < churnSources.size(); i++) {
+            std::shared_ptr<ElevationSource> found;
+            const bool attached = (ElevationSourceManager_findSource(found, churnSources[i]->getName()) == TE_Ok);
+            if (churnSources[i]->getListenerCount() != (attached ? 1u : 0u)) {
+                fprintf(stderr, "%s is %s with %u content listeners\n", churnSources[i]->getName(),
+                        attached ? "attached" : "detached", (unsigned)churnSources[i]->getListenerCount());
+                ok = false;
+            }
+            if (attached)
+                ElevationSourceManager_detach(*churnSources[i]);
+        }
+        std::vector<std::shared_ptr<ElevationSource>> registered;
+        STLVectorAdapter<std::shared_ptr<ElevationSource>> registeredAdapter(registered);
+        ElevationSourceManager_getSources(registeredAdapter);
+        if (registered.size() != opts.numSources) {
+            fprintf(stderr, "%u sources attached, expected %u\n", (unsigned)registered.size(), (unsigned)opts.numSources);
+            ok = false;
+        }
+        return ok;
+    }
+
+    Envelope2 cellBounds(const std::size_t index) NOTHROWS
+    {
+        // one degree cells, row major from the south west corner
+        const std::size_t cell = index % 64800u;
+        const double x = -180.0 + static_cast<double>(cell % 360u);
+        const double y = -90.0 + static_cast<double>(cell / 360u);
+        return Envelope2(x, y, 0.0, x + 1.0, y + 1.0, 0.0);
+    }
+
+    bool parseThreads(std::vector<std::size_t> &value, const char *arg) NOTHROWS
+    {
+        value.clear();
+        const char *s = arg;
+        while (*s) {
+            char *end;
+            const long n = strtol(s, &end, 10);
+            if (end == s || n <= 0)
+                return false;
+            value.push_back(static_cast<std::size_t>(n));
+            s = end;
+            if (*s == ',')
+                s++;
+            else if (*s)
+                return false;
+        }
+        return !value.empty();
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -t <list>     comma separated query thread counts (default 1,2,4,8)\n");
+        printf("    -s <count>    attached sources (default 500)\n");
+        printf("    -d <ms>       duration of each run (default 2000)\n");
+        printf("    -c <ms>       interval between writes on each writer thread (default 5)\n");
+        printf("    -r <degrees>  width and height of the query regions (default 2)\n");
+        printf("    -h            print this message\n");
+    }
+}
@@ -0,0 +1,552 @@
+// Headless frame benchmark for GLMapView2.
+//
+// Renders a synthetic dataset along a scripted camera path and reports
+// frame-time percentiles, the per-frame workload recorded by
+// GLFrameStatistics and the GL calls issued.  GL is provided by the
+// recording backend (test/gl/RecordingGL), which counts calls and does no
+// rendering, so the benchmark needs no GPU or display and measures only the
+// CPU cost of issuing each frame.
+//
+// Camera paths are text, one keyframe per line:
+//     <frames> <latitude> <longitude> <resolution m/px> <rotation deg> <tilt deg>
+// The first keyframe is the starting pose and its frame count is ignored.
+// Each following keyframe is reached over <frames> frames; position,
+// rotation and tilt are interpolated linearly and resolution geometrically.
+// Lines starting with '#' are comments.  Several paths are built in (-p).
+//
+// The dataset is a deterministic set of random-walk polylines and points
+// around the first keyframe, drawn as the basemap through the fixed
+// function pipeline.  Polylines wider than one pixel go through the line
+// emulation.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/AtakMapController.h"
+#include "core/AtakMapView.h"
+#include "core/GeoPoint.h"
+#include "renderer/GL.h"
+#include "renderer/GLES20FixedPipeline.h"
+#include "renderer/core/GLFrameStatistics.h"
+#include "renderer/core/GLMapRenderable2.h"
+#include "renderer/core/GLMapView2.h"
+#include "util/DataOutput2.h"
+#include "util/Memory.h"
+#include "util/Tracing.h"
+
+#include "HeadlessRenderContext.h"
+#include "RecordingGL.h"
+
+using namespace TAK::Engine::Core;
+using namespace TAK::Engine::Renderer::Core;
+using namespace TAK::Engine::Tests;
+using namespace TAK::Engine::Util;
+
+using namespace atakmap::renderer;
+
+namespace
+{
+    struct Keyframe
+    {
+        std::size_t frames;
+        double latitude;
+        double longitude;
+        double resolution;
+        double rotation;
+        double tilt;
+    };
+
+    struct BuiltinPath
+    {
+        const char *name;
+        const char *description;
+        const char *keyframes;
+    };
+
+    const BuiltinPath BUILTIN_PATHS[] =
+    {
+        { "zoom", "zoom from 10 km/px to 1 m/px and back out",
+            "0 34.05 -118.25 10000 0 0\n"
+            "240 34.05 -118.25 1 0 0\n"
+            "240 34.05 -118.25 10000 0 0\n" },
+        { "pan", "pan west to east at 20 m/px",
+            "0 34.05 -118.75 20 0 0\n"
+            "480 34.05 -117.75 20 0 0\n" },
+        { "orbit", "orbit the center at 5 m/px, tilted 45 degrees",
+            "0 34.05 -118.25 5 0 45\n"
+            "480 34.05 -118.25 5 360 45\n" },
+        { "flight", "zoom in, pan and orbit tilted, then zoom back out",
+            "0 34.05 -118.75 2000 0 0\n"
+            "120 34.05 -118.75 10 0 0\n"
+            "240 34.05 -118.25 10 90 30\n"
+            "240 34.20 -118.00 5 270 60\n"
+            "120 34.05 -118.25 2000 360 0\n" },
+    };
+
+    /**
+     * Random-walk polylines and points in a square around a center point.
+     * The same seed always produces the same dataset.
+     */
+    class SyntheticDataset : public GLMapRenderable2
+    {
+    private :
+        struct Feature
+        {
+            std::size_t offset;
+            std::size_t count;
+            double minLat;
+            double minLng;
+            double maxLat;
+            double maxLng;
+            float r;
+            float g;
+            float b;
+            float lineWidth;
+        };
+    public :
+        /**
+         * @param extent                The half-width of the dataset's square, in degrees
+         * @param numFeatures           The number of features; one in ten is a point
+         * @param verticesPerFeature    The number of vertices in each polyline
+         */
+        SyntheticDataset(const double latitude, const double longitude, const double extent, const std::size_t numFeatures, const std::size_t verticesPerFeature, const uint32_t seed) NOTHROWS;
+        ~SyntheticDataset() NOTHROWS override;
+    public :
+        void draw(const GLMapView2 &view, const int renderPass) NOTHROWS override;
+        void release() NOTHROWS override;
+        int getRenderPass() NOTHROWS override;
+        void start() NOTHROWS override;
+        void stop() NOTHROWS override;
+    private :
+        std::vector<Feature> lines;
+        std::vector<double> lineCoords;
+        std::vector<double> points;
+        std::vector<double> visiblePoints;
+        std::vector<float> vertices;
+    };
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        const char *pathName;
+        const char *pathFile;
+        std::size_t repeat;
+        std::size_t warmup;
+        std::size_t width;
+        std::size_t height;
+        double dpi;
+        std::size_t numFeatures;
+        std::size_t verticesPerFeature;
+        double extent;
+        uint32_t seed;
+        const char *traceFile;
+    };
+
+    TAKErr parsePath(std::vector<Keyframe> &path, std::istream &in) NOTHROWS;
+    void interpolate(Keyframe *value, const Keyframe &a, const Keyframe &b, const double t) NOTHROWS;
+    void setCamera(atakmap::core::AtakMapView &view, const Keyframe &pose) NOTHROWS;
+    TAKErr collectCallCount(void *opaque, const char *fn, const std::size_t count) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-p") && hasValue) {
+            opts.pathName = argv[++i];
+        } else if (!strcmp(arg, "-f") && hasValue) {
+            opts.pathFile = argv[++i];
+        } else if (!strcmp(arg, "-r") && hasValue) {
+            opts.repeat = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-w") && hasValue) {
+            opts.warmup = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-W") && hasValue) {
+            opts.width = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-H") && hasValue) {
+            opts.height = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-d") && hasValue) {
+            opts.dpi = atof(argv[++i]);
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.numFeatures = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-v") && hasValue) {
+            opts.verticesPerFeature = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-e") && hasValue) {
+            opts.extent = atof(argv[++i]);
+        } else if (!strcmp(arg, "-s") && hasValue) {
+            opts.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "-t") && hasValue) {
+            opts.traceFile = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.repeat || !opts.width || !opts.height || opts.dpi <= 0.0 || opts.verticesPerFeature < 2u || opts.extent <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // load the camera path
+    std::vector<Keyframe> path;
+    TAKErr code(TE_Ok);
+    if (opts.pathFile) {
+        std::ifstream in(opts.pathFile);
+        if (!in) {
+            fprintf(stderr, "Failed to open camera path %s\n", opts.pathFile);
+            return 1;
+        }
+        code = parsePath(path, in);
+    } else {
+        const BuiltinPath *builtin = nullptr;
+        for (std::size_t i = 0u; i < sizeof(BUILTIN_PATHS) / sizeof(BUILTIN_PATHS[0]); i++) {
+            if (!strcmp(BUILTIN_PATHS[i].name, opts.pathName))
+                builtin = &BUILTIN_PATHS[i];
+        }
+        if (!builtin) {
+            fprintf(stderr, "Unknown camera path %s\n", opts.pathName);
+            return 1;
+        }
+        std::istringstream in(builtin->keyframes);
+        code = parsePath(path, in);
+    }
+    if (code != TE_Ok || path.size() < 2u) {
+        fprintf(stderr, "Camera path must have at least two keyframes\n");
+        return 1;
+    }
+
+    std::size_t pathFrames = 0u;
+    for (std::size_t i = 1u; i < path.size(); i++)
+        pathFrames += path[i].frames;
+    const std::size_t measuredFrames = pathFrames * opts.repeat;
+
+    // set up the view. The benchmark's thread is the render thread.
+    HeadlessRenderSurface surface(opts.width, opts.height, opts.dpi);
+    HeadlessRenderContext context(surface);
+
+    atakmap::core::AtakMapView view(static_cast<float>(opts.width), static_cast<float>(opts.height), opts.dpi);
+    setCamera(view, path[0]);
+
+    GLMapView2 glview(context, view, 0, 0, static_cast<int>(opts.width), static_cast<int>(opts.height));
+    code = glview.start();
+    if (code != TE_Ok) {
+        fprintf(stderr, "Failed to start the map view\n");
+        return 1;
+    }
+    glview.setBaseMap(GLMapRenderable2Ptr(
+        new SyntheticDataset(path[0].latitude, path[0].longitude, opts.extent, opts.numFeatures, opts.verticesPerFeature, opts.seed),
+        Memory_deleter_const<GLMapRenderable2, SyntheticDataset>));
+
+    // warm up at the starting pose, so that shaders, offscreen surfaces and
+    // the first terrain tiles are not measured
+    for (std::size_t i = 0u; i < opts.warmup; i++) {
+        context.pump();
+        glview.render();
+    }
+
+    GLFrameStatistics &stats = glview.getFrameStatistics();
+    stats.setWindow(measuredFrames);
+    RecordingGL_reset();
+    if (opts.traceFile) {
+        Tracing_clear();
+        Tracing_setEnabled(true);
+    }
+
+    GLCounters maxFrame;
+    memset(&maxFrame, 0, sizeof(maxFrame));
+    for (std::size_t r = 0u; r < opts.repeat; r++) {
+        for (std::size_t k = 1u; k < path.size(); k++) {
+            for (std::size_t f = 1u; f <= path[k].frames; f++) {
+                Keyframe pose;
+                interpolate(&pose, path[k - 1u], path[k], static_cast<double>(f) / static_cast<double>(path[k].frames));
+                setCamera(view, pose);
+
+                GLCounters before;
+                RecordingGL_getCounters(&before);
+
+                context.pump();
+                glview.render();
+
+                GLCounters after;
+                RecordingGL_getCounters(&after);
+                maxFrame.calls = std::max(maxFrame.calls, after.calls - before.calls);
+                maxFrame.drawCalls = std::max(maxFrame.drawCalls, after.drawCalls - before.drawCalls);
+                maxFrame.vertices = std::max(maxFrame.vertices, after.vertices - before.vertices);
+            }
+        }
+    }
+
+    Tracing_setEnabled(false);
+
+    // report
+    GLFrameStatistics::Summary summary;
+    if (stats.getSummary(&summary) != TE_Ok) {
+        fprintf(stderr, "No frames were recorded\n");
+        return 1;
+    }
+    GLCounters totals;
+    RecordingGL_getCounters(&totals);
+    const double n = static_cast<double>(summary.frames);
+
+    printf("path:        %s, %u keyframes, %u frames x %u (%u warm-up frames)\n",
+           opts.pathFile ? opts.pathFile : opts.pathName,
+           (unsigned)path.size(), (unsigned)pathFrames, (unsigned)opts.repeat, (unsigned)opts.warmup);
+    printf("surface:     %ux%u at %.0f dpi\n", (unsigned)opts.width, (unsigned)opts.height, opts.dpi);
+    printf("dataset:     %u features, %u vertices per polyline, extent %.3f deg, seed %u\n",
+           (unsigned)opts.numFeatures, (unsigned)opts.verticesPerFeature, opts.extent, (unsigned)opts.seed);
+    printf("\n");
+    printf("frame time (ms, %u frames)\n", (unsigned)summary.frames);
+    printf("    min %.3f  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f  mean %.3f\n",
+           summary.minimumNanos / 1e6, summary.p50Nanos / 1e6, summary.p90Nanos / 1e6,
+           summary.p99Nanos / 1e6, summary.maximumNanos / 1e6, summary.meanNanos / 1e6);
+    printf("workload per frame (mean)\n");
+    printf("    render passes %.2f  layer draws %.2f  terrain tiles %.2f\n",
+           summary.meanRenderPasses, summary.meanLayerDraws, summary.meanTerrainTiles);
+    printf("GL per frame                mean        max\n");
+    printf("    calls           %12.1f %10u\n", totals.calls / n, (unsigned)maxFrame.calls);
+    printf("    draw calls      %12.1f %10u\n", totals.drawCalls / n, (unsigned)maxFrame.drawCalls);
+    printf("    vertices        %12.1f %10u\n", totals.vertices / n, (unsigned)maxFrame.vertices);
+    printf("    program binds   %12.1f\n", totals.programBinds / n);
+    printf("    texture binds   %12.1f\n", totals.textureBinds / n);
+    printf("    upload bytes    %12.1f\n", totals.textureUploadBytes / n);
+    printf("    live textures   %12u (at end)\n", (unsigned)totals.liveTextures);
+
+    std::vector<std::pair<std::size_t, const char *>> calls;
+    RecordingGL_visitCallCounts(collectCallCount, &calls);
+    std::sort(calls.begin(), calls.end(), [](const std::pair<std::size_t, const char *> &a, const std::pair<std::size_t, const char *> &b)
+    {
+        return a.first > b.first;
+    });
+    printf("GL calls by function        total  per frame\n");
+    for (auto it = calls.begin(); it != calls.end(); it++)
+        printf("    %-28s %10u %10.1f\n", it->second, (unsigned)it->first, it->first / n);
+
+    if (opts.traceFile) {
+        FileOutput2 trace;
+        code = trace.open(opts.traceFile);
+        if (code == TE_Ok)
+            code = Tracing_exportChromeTrace(trace);
+        trace.close();
+        if (code != TE_Ok)
+            fprintf(stderr, "Failed to write trace %s\n", opts.traceFile);
+    }
+
+    glview.stop();
+    return 0;
+}
+
+namespace
+{
+    SyntheticDataset::SyntheticDataset(const double latitude, const double longitude, const double extent, const std::size_t numFeatures, const std::size_t verticesPerFeature, const uint32_t seed) NOTHROWS
+    {
+        // use the raw generator output; the standard distributions are not
+        // required to produce the same values on every platform
+        std::mt19937 rng(seed);
+        auto uniform = [&rng]() { return static_cast<double>(rng()) / 4294967296.0; };
+
+        const double step = extent / 100.0;
+        try {
+            for (std::size_t i = 0u; i < numFeatures; i++) {
+                double lat = latitude + (uniform()*2.0 - 1.0) * extent;
+                double lng = longitude + (uniform()*2.0 - 1.0) * extent;
+                if (i % 10u == 0u) {
+                    points.push_back(lng);
+                    points.push_back(lat);
+                    continue;
+                }
+
+                Feature feature;
+                feature.offset = lineCoords.size() / 2u;
+                feature.count = verticesPerFeature;
+                feature.minLat = feature.maxLat = lat;
+                feature.minLng = feature.maxLng = lng;
+                for (std::size_t j = 0u; j < verticesPerFeature; j++) {
+                    lineCoords.push_back(lng);
+                    lineCoords.push_back(lat);
+                    feature.minLat = std::min(feature.minLat, lat);
+                    feature.maxLat = std::max(feature.maxLat, lat);
+                    feature.minLng = std::min(feature.minLng, lng);
+                    feature.maxLng = std::max(feature.maxLng, lng);
+                    lat += (uniform()*2.0 - 1.0) * step;
+                    lng += (uniform()*2.0 - 1.0) * step;
+                }
+                feature.r = static_cast<float>(uniform());
+                feature.g = static_cast<float>(uniform());
+                feature.b = static_cast<float>(uniform());
+                // one in five polylines is wide
+                feature.lineWidth = (i % 5u == 0u) ? 3.0f : 1.0f;
+                lines.push_back(feature);
+            }
+            vertices.resize(std::max(verticesPerFeature, points.size() / 2u) * 2u);
+            visiblePoints.reserve(points.size());
+        } catch (...) {
+            lines.clear();
+            points.clear();
+        }
+    }
+    SyntheticDataset::~SyntheticDataset() NOTHROWS
+    {}
+    void SyntheticDataset::draw(const GLMapView2 &view, const int renderPass) NOTHROWS
+    {
+        const bool surface = !!(renderPass & GLMapView2::Surface);
+        const bool sprites = !!(renderPass & GLMapView2::Sprites);
+        if (!surface && !sprites)
+            return;
+
+        GLES20FixedPipeline *fixedPipe = GLES20FixedPipeline::getInstance();
+        fixedPipe->glEnableClientState(GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
+
+        // the dataset does not cross the anti-meridian
+        if (surface) {
+            for (auto it = lines.begin(); it != lines.end(); it++) {
+                const Feature &feature = *it;
+                if (feature.maxLat < view.southBound || feature.minLat > view.northBound ||
+                    feature.maxLng < view.westBound || feature.minLng > view.eastBound) {
+
+                    continue;
+                }
+                if (view.forward(&vertices[0], 2u, &lineCoords[feature.offset * 2u], 2u, feature.count) != TE_Ok)
+                    continue;
+                fixedPipe->glColor4f(feature.r, feature.g, feature.b, 1.0f);
+                fixedPipe->glLineWidth(feature.lineWidth);
+                fixedPipe->glVertexPointer(2, GL_FLOAT, 0, &vertices[0]);
+                fixedPipe->glDrawArrays(GL_LINE_STRIP, 0, static_cast<int>(feature.count));
+            }
+            fixedPipe->glLineWidth(1.0f);
+        }
+
+        if (sprites) {
+            visiblePoints.clear();
+            for (std::size_t i = 0u; i < points.size(); i += 2u) {
+                const double lng = points[i];
+                const double lat = points[i + 1u];
+                if (lat < view.southBound || lat > view.northBound || lng < view.westBound || lng > view.eastBound)
+                    continue;
+                visiblePoints.push_back(lng);
+                visiblePoints.push_back(lat);
+            }
+            const std::size_t count = visiblePoints.size() / 2u;
+            if (count && view.forward(&vertices[0], 2u, &visiblePoints[0], 2u, count) == TE_Ok) {
+                fixedPipe->glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                fixedPipe->glPointSize(8.0f);
+                fixedPipe->glVertexPointer(2, GL_FLOAT, 0, &vertices[0]);
+                fixedPipe->glDrawArrays(GL_POINTS, 0, static_cast<int>(count));
+            }
+        }
+
+        fixedPipe->glDisableClientState(GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
+    }
+    void SyntheticDataset::release() NOTHROWS
+    {}
+    int SyntheticDataset::getRenderPass() NOTHROWS
+    {
+        return GLMapView2::Surface | GLMapView2::Sprites;
+    }
+    void SyntheticDataset::start() NOTHROWS
+    {}
+    void SyntheticDataset::stop() NOTHROWS
+    {}
+
+    Options::Options() NOTHROWS :
+        pathName("flight"),
+        pathFile(nullptr),
+        repeat(1u),
+        warmup(30u),
+        width(1920u),
+        height(1080u),
+        dpi(240.0),
+        numFeatures(10000u),
+        verticesPerFeature(64u),
+        extent(0.5),
+        seed(1u),
+        traceFile(nullptr)
+    {}
+
+    TAKErr parsePath(std::vector<Keyframe> &path, std::istream &in) NOTHROWS
+    {
+        try {
+            std::string line;
+            while (std::getline(in, line)) {
+                const std::size_t start = line.find_first_not_of(" \t\r");
+                if (start == std::string::npos || line[start] == '#')
+                    continue;
+                std::istringstream fields(line);
+                Keyframe keyframe;
+                if (!(fields >> keyframe.frames >> keyframe.latitude >> keyframe.longitude >> keyframe.resolution >> keyframe.rotation >> keyframe.tilt))
+                    return TE_InvalidArg;
+                if (keyframe.resolution <= 0.0)
+                    return TE_InvalidArg;
+                // the first keyframe is only a pose
+                if (!path.empty() && !keyframe.frames)
+                    return TE_InvalidArg;
+                path.push_back(keyframe);
+            }
+        } catch (...) {
+            return TE_Err;
+        }
+        return TE_Ok;
+    }
+    void interpolate(Keyframe *value, const Keyframe &a, const Keyframe &b, const double t) NOTHROWS
+    {
+        value->frames = 0u;
+        value->latitude = a.latitude + (b.latitude - a.latitude) * t;
+        value->longitude = a.longitude + (b.longitude - a.longitude) * t;
+        value->resolution = a.resolution * pow(b.resolution / a.resolution, t);
+        value->rotation = a.rotation + (b.rotation - a.rotation) * t;
+        value->tilt = a.tilt + (b.tilt - a.tilt) * t;
+    }
+    void setCamera(atakmap::core::AtakMapView &view, const Keyframe &pose) NOTHROWS
+    {
+        atakmap::core::GeoPoint center(pose.latitude, pose.longitude);
+        const double rotation = fmod(pose.rotation, 360.0);
+        atakmap::core::AtakMapController *controller = view.getController();
+        controller->panZoomRotateTo(&center, view.mapResolutionAsMapScale(pose.resolution), rotation, false);
+        controller->tiltTo(pose.tilt, false);
+    }
+    TAKErr collectCallCount(void *opaque, const char *fn, const std::size_t count) NOTHROWS
+    {
+        auto &calls = *static_cast<std::vector<std::pair<std::size_t, const char *>> *>(opaque);
+        try {
+            calls.push_back(std::make_pair(count, fn));
+        } catch (...) {
+            return TE_OutOfMemory;
+        }
+        return TE_Ok;
+    }
+    void usage(const char *argv0) NOTHROWS
+    {
+        fprintf(stderr,
+                "Usage: %s [options]\n"
+                "  -p <name>    built-in camera path (default flight)\n"
+                "  -f <file>    camera path file, overrides -p\n"
+                "  -r <count>   times to run the path (default 1)\n"
+                "  -w <count>   warm-up frames at the first keyframe (default 30)\n"
+                "  -W <pixels>  surface width (default 1920)\n"
+                "  -H <pixels>  surface height (default 1080)\n"
+                "  -d <dpi>     display dpi (default 240)\n"
+                "  -n <count>   dataset features (default 10000)\n"
+                "  -v <count>   vertices per polyline (default 64)\n"
+                "  -e <degrees> dataset half-width around the first keyframe (default 0.5)\n"
+                "  -s <seed>    dataset seed (default 1)\n"
+                "  -t <file>    write a Chrome trace of the measured frames\n"
+                "Built-in paths:\n",
+                argv0);
+        for (std::size_t i = 0u; i < sizeof(BUILTIN_PATHS) / sizeof(BUILTIN_PATHS[0]); i++)
+            fprintf(stderr, "  %-8s %s\n", BUILTIN_PATHS[i].name, BUILTIN_PATHS[i].description);
+    }
+}
@@ -0,0 +1,122 @@
+#include "HeadlessRenderContext.h"
+
+#include "thread/Lock.h"
+
+using namespace TAK::Engine::Tests;
+
+using namespace TAK::Engine::Core;
+using namespace TAK::Engine::Thread;
+using namespace TAK::Engine::Util;
+
+HeadlessRenderSurface::HeadlessRenderSurface(const std::size_t width_, const std::size_t height_, const double dpi_) NOTHROWS :
+    width(width_),
+    height(height_),
+    dpi(dpi_)
+{}
+HeadlessRenderSurface::~HeadlessRenderSurface() NOTHROWS
+{}
+double HeadlessRenderSurface::getDpi() const NOTHROWS
+{
+    return dpi;
+}
+std::size_t HeadlessRenderSurface::getWidth() const NOTHROWS
+{
+    return width;
+}
+std::size_t HeadlessRenderSurface::getHeight() const NOTHROWS
+{
+    return height;
+}
+void HeadlessRenderSurface::addOnSizeChangedListener(OnSizeChangedListener *) NOTHROWS
+{}
+void HeadlessRenderSurface::removeOnSizedChangedListener(const OnSizeChangedListener &) NOTHROWS
+{}
+
+HeadlessRenderContext::HeadlessRenderContext(RenderSurface &surface_) NOTHROWS :
+    surface(surface_),
+    renderThread(std::this_thread::get_id()),
+    frameRate(0.0f),
+    continuousRender(true)
+{}
+HeadlessRenderContext::~HeadlessRenderContext() NOTHROWS
+{}
+bool HeadlessRenderContext::isRenderThread() const NOTHROWS
+{
+    return std::this_thread::get_id() == renderThread;
+}
+TAKErr HeadlessRenderContext::queueEvent(void(*runnable)(void *) NOTHROWS, std::unique_ptr<void, void(*)(const void *)> &&opaque) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!runnable)
+        return TE_InvalidArg;
+    Lock lock(mutex);
+    code = lock.status;
+    TE_CHECKRETURN_CODE(code);
+    try {
+        Event event{ runnable, std::move(opaque) };
+        events.push_back(std::move(event));
+    } catch (...) {
+        return TE_OutOfMemory;
+    }
+    return code;
+}
+void HeadlessRenderContext::requestRefresh() NOTHROWS
+{}
+TAKErr HeadlessRenderContext::setFrameRate(const float rate) NOTHROWS
+{
+    frameRate = rate;
+    return TE_Ok;
+}
+float HeadlessRenderContext::getFrameRate() const NOTHROWS
+{
+    return frameRate;
+}
+void HeadlessRenderContext::setContinuousRenderEnabled(const bool enabled) NOTHROWS
+{
+    continuousRender = enabled;
+}
+bool HeadlessRenderContext::isContinuousRenderEnabled() NOTHROWS
+{
+    return continuousRender;
+}
+bool HeadlessRenderContext::supportsChildContext() const NOTHROWS
+{
+    return false;
+}
+TAKErr HeadlessRenderContext::createChildContext(std::unique_ptr<RenderContext, void(*)(const RenderContext *)> &) NOTHROWS
+{
+    return TE_Unsupported;
+}
+bool HeadlessRenderContext::isAttached() const NOTHROWS
+{
+    return true;
+}
+bool HeadlessRenderContext::attach() NOTHROWS
+{
+    return isRenderThread();
+}
+bool HeadlessRenderContext::detach() NOTHROWS
+{
+    return false;
+}
+bool HeadlessRenderContext::isMainContext() const NOTHROWS
+{
+    return true;
+}
+RenderSurface *HeadlessRenderContext::getRenderSurface() const NOTHROWS
+{
+    return &surface;
+}
+void HeadlessRenderContext::pump() NOTHROWS
+{
+    std::vector<Event> pending;
+    {
+        Lock lock(mutex);
+        if (lock.status != TE_Ok)
+            return;
+        pending.swap(events);
+    }
+    // events may queue further events; those run on the next pump
+    for (auto it = pending.begin(); it != pending.end(); it++)
+        it->runnable(it->opaque.get());
+}
@@ -0,0 +1,86 @@
+#ifndef TAK_ENGINE_TESTS_HEADLESSRENDERCONTEXT_H_INCLUDED
+#define TAK_ENGINE_TESTS_HEADLESSRENDERCONTEXT_H_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/RenderContext.h"
+#include "core/RenderSurface.h"
+#include "port/Platform.h"
+#include "thread/Mutex.h"
+#include "util/Error.h"
+
+/**
+ * A render surface and context with no window system behind them, for
+ * driving GLMapView2 against the recording GL backend.
+ */
+namespace TAK {
+    namespace Engine {
+        namespace Tests {
+            /** A surface of fixed size and density. */
+            class HeadlessRenderSurface : public Core::RenderSurface
+            {
+            public :
+                HeadlessRenderSurface(const std::size_t width, const std::size_t height, const double dpi) NOTHROWS;
+                ~HeadlessRenderSurface() NOTHROWS override;
+            public :
+                double getDpi() const NOTHROWS override;
+                std::size_t getWidth() const NOTHROWS override;
+                std::size_t getHeight() const NOTHROWS override;
+                // the surface is never resized
+                void addOnSizeChangedListener(OnSizeChangedListener *l) NOTHROWS override;
+                void removeOnSizedChangedListener(const OnSizeChangedListener &l) NOTHROWS override;
+            private :
+                std::size_t width;
+                std::size_t height;
+                double dpi;
+            };
+
+            /**
+             * A main context for the thread that creates it. Queued events are run
+             * when the caller pumps the context, before each frame.
+             */
+            class HeadlessRenderContext : public Core::RenderContext
+            {
+            public :
+                HeadlessRenderContext(Core::RenderSurface &surface) NOTHROWS;
+                ~HeadlessRenderContext() NOTHROWS override;
+            public :
+                bool isRenderThread() const NOTHROWS override;
+                Util::TAKErr queueEvent(void(*runnable)(void *) NOTHROWS, std::unique_ptr<void, void(*)(const void *)> &&opaque) NOTHROWS override;
+                void requestRefresh() NOTHROWS override;
+                Util::TAKErr setFrameRate(const float rate) NOTHROWS override;
+                float getFrameRate() const NOTHROWS override;
+                void setContinuousRenderEnabled(const bool enabled) NOTHROWS override;
+                bool isContinuousRenderEnabled() NOTHROWS override;
+                bool supportsChildContext() const NOTHROWS override;
+                Util::TAKErr createChildContext(std::unique_ptr<Core::RenderContext, void(*)(const Core::RenderContext *)> &value) NOTHROWS override;
+                bool isAttached() const NOTHROWS override;
+                bool attach() NOTHROWS override;
+                bool detach() NOTHROWS override;
+                bool isMainContext() const NOTHROWS override;
+                Core::RenderSurface *getRenderSurface() const NOTHROWS override;
+            public :
+                /** runs the events queued before the call */
+                void pump() NOTHROWS;
+            private :
+                struct Event
+                {
+                    void(*runnable)(void *);
+                    std::unique_ptr<void, void(*)(const void *)> opaque;
+                };
+            private :
+                Core::RenderSurface &surface;
+                std::thread::id renderThread;
+                Thread::Mutex mutex;
+                std::vector<Event> events;
+                float frameRate;
+                bool continuousRender;
+            };
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,737 @@
+#include "RecordingGL.h"
+
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+
+#include "renderer/GL.h"
+
+using namespace TAK::Engine::Tests;
+
+using namespace TAK::Engine::Util;
+
+// the GL entry points implemented by the backend
+#define RECORDINGGL_FUNCTIONS(X) \
+    X(glActiveTexture) \
+    X(glAttachShader) \
+    X(glBindFramebuffer) \
+    X(glBindRenderbuffer) \
+    X(glBindTexture) \
+    X(glBlendFunc) \
+    X(glBlendFuncSeparate) \
+    X(glCheckFramebufferStatus) \
+    X(glClear) \
+    X(glClearColor) \
+    X(glClearDepthf) \
+    X(glColorMask) \
+    X(glCompileShader) \
+    X(glCompressedTexImage2D) \
+    X(glCreateProgram) \
+    X(glCreateShader) \
+    X(glCullFace) \
+    X(glDeleteFramebuffers) \
+    X(glDeleteProgram) \
+    X(glDeleteRenderbuffers) \
+    X(glDeleteShader) \
+    X(glDeleteTextures) \
+    X(glDepthFunc) \
+    X(glDepthMask) \
+    X(glDepthRangef) \
+    X(glDisable) \
+    X(glDisableVertexAttribArray) \
+    X(glDrawArrays) \
+    X(glDrawElements) \
+    X(glEnable) \
+    X(glEnableVertexAttribArray) \
+    X(glFramebufferRenderbuffer) \
+    X(glFramebufferTexture2D) \
+    X(glFrontFace) \
+    X(glGenFramebuffers) \
+    X(glGenRenderbuffers) \
+    X(glGenTextures) \
+    X(glGenerateMipmap) \
+    X(glGetAttribLocation) \
+    X(glGetBooleanv) \
+    X(glGetError) \
+    X(glGetFloatv) \
+    X(glGetIntegerv) \
+    X(glGetProgramInfoLog) \
+    X(glGetProgramiv) \
+    X(glGetShaderInfoLog) \
+    X(glGetShaderPrecisionFormat) \
+    X(glGetShaderiv) \
+    X(glGetUniformLocation) \
+    X(glIsEnabled) \
+    X(glLineWidth) \
+    X(glLinkProgram) \
+    X(glRenderbufferStorage) \
+    X(glShaderSource) \
+    X(glTexImage2D) \
+    X(glTexParameterf) \
+    X(glTexParameteri) \
+    X(glTexSubImage2D) \
+    X(glUniform1f) \
+    X(glUniform1i) \
+    X(glUniform4f) \
+    X(glUniformMatrix4fv) \
+    X(glUseProgram) \
+    X(glVertexAttribPointer) \
+    X(glViewport)
+
+namespace
+{
+#define RECORDINGGL_ENUM(fn) FN_##fn,
+    enum Function
+    {
+        RECORDINGGL_FUNCTIONS(RECORDINGGL_ENUM)
+        NUM_FUNCTIONS
+    };
+#undef RECORDINGGL_ENUM
+
+#define RECORDINGGL_NAME(fn) #fn,
+    const char *FUNCTION_NAMES[NUM_FUNCTIONS] =
+    {
+        RECORDINGGL_FUNCTIONS(RECORDINGGL_NAME)
+    };
+#undef RECORDINGGL_NAME
+
+#define MAX_TEXTURE_UNITS 32u
+
+    struct State
+    {
+        State() NOTHROWS;
+
+        std::size_t callCounts[NUM_FUNCTIONS];
+        GLCounters counters;
+
+        GLuint nextName;
+        std::set<GLuint> textures;
+        std::map<std::pair<GLuint, std::string>, GLint> locations;
+        std::map<GLuint, GLint> nextLocation;
+        std::set<GLenum> enabled;
+
+        GLuint program;
+        GLenum activeTexture;
+        GLuint boundTextures[MAX_TEXTURE_UNITS];
+        GLuint framebuffer;
+        GLuint renderbuffer;
+        GLint viewport[4];
+        GLfloat lineWidth;
+        GLfloat clearColor[4];
+        GLfloat depthRange[2];
+        GLboolean depthMask;
+        GLboolean colorMask[4];
+        GLenum depthFunc;
+        GLenum blendSrcRgb;
+        GLenum blendDstRgb;
+        GLenum blendSrcAlpha;
+        GLenum blendDstAlpha;
+    };
+
+    State &state() NOTHROWS
+    {
+        static State s;
+        return s;
+    }
+
+    void record(const Function fn) NOTHROWS
+    {
+        State &s = state();
+        s.callCounts[fn]++;
+        s.counters.calls++;
+    }
+
+    std::size_t bytesPerPixel(const GLenum format, const GLenum type) NOTHROWS
+    {
+        switch (type) {
+            case GL_UNSIGNED_SHORT_5_6_5 :
+            case GL_UNSIGNED_SHORT_4_4_4_4 :
+            case GL_UNSIGNED_SHORT_5_5_5_1 :
+                return 2u;
+            default :
+                break;
+        }
+        switch (format) {
+            case GL_ALPHA :
+            case GL_LUMINANCE :
+                return 1u;
+            case GL_LUMINANCE_ALPHA :
+                return 2u;
+            case GL_RGB :
+                return 3u;
+            default :
+                return 4u;
+        }
+    }
+
+    GLuint unitIndex(const GLenum unit) NOTHROWS
+    {
+        const GLuint idx = unit - GL_TEXTURE0;
+        return (idx < MAX_TEXTURE_UNITS) ? idx : 0u;
+    }
+}
+
+void TAK::Engine::Tests::RecordingGL_reset() NOTHROWS
+{
+    State &s = state();
+    memset(s.callCounts, 0, sizeof(s.callCounts));
+    const std::size_t liveTextures = s.counters.liveTextures;
+    memset(&s.counters, 0, sizeof(s.counters));
+    s.counters.liveTextures = liveTextures;
+}
+void TAK::Engine::Tests::RecordingGL_getCounters(GLCounters *value) NOTHROWS
+{
+    *value = state().counters;
+}
+std::size_t TAK::Engine::Tests::RecordingGL_getCallCount(const char *fn) NOTHROWS
+{
+    if (!fn)
+        return 0u;
+    for (std::size_t i = 0u; i < NUM_FUNCTIONS; i++) {
+        if (!strcmp(FUNCTION_NAMES[i], fn))
+            return state().callCounts[i];
+    }
+    return 0u;
+}
+TAKErr TAK::Engine::Tests::RecordingGL_visitCallCounts(TAKErr(*visitor)(void *opaque, const char *fn, const std::size_t count) NOTHROWS, void *opaque) NOTHROWS
+{
+    TAKErr code(TE_Ok);
+    if (!visitor)
+        return TE_InvalidArg;
+    const State &s = state();
+    for (std::size_t i = 0u; i < NUM_FUNCTIONS; i++) {
+        if (!s.callCounts[i])
+            continue;
+        code = visitor(opaque, FUNCTION_NAMES[i], s.callCounts[i]);
+        TE_CHECKBREAK_CODE(code);
+    }
+    if (code == TE_Done)
+        code = TE_Ok;
+    return code;
+}
+
+namespace
+{
+    State::State() NOTHROWS :
+        counters(),
+        nextName(1u),
+        program(0u),
+        activeTexture(GL_TEXTURE0),
+        framebuffer(0u),
+        renderbuffer(0u),
+        lineWidth(1.0f),
+        depthMask(GL_TRUE),
+        depthFunc(GL_LESS),
+        blendSrcRgb(GL_ONE),
+        blendDstRgb(GL_ZERO),
+        blendSrcAlpha(GL_ONE),
+        blendDstAlpha(GL_ZERO)
+    {
+        memset(callCounts, 0, sizeof(callCounts));
+        memset(&counters, 0, sizeof(counters));
+        memset(boundTextures, 0, sizeof(boundTextures));
+        memset(viewport, 0, sizeof(viewport));
+        memset(clearColor, 0, sizeof(clearColor));
+        depthRange[0] = 0.0f;
+        depthRange[1] = 1.0f;
+        for (std::size_t i = 0u; i < 4u; i++)
+            colorMask[i] = GL_TRUE;
+        enabled.insert(GL_DITHER);
+    }
+}
+
+// GL entry points
+
+GL_APICALL void GL_APIENTRY glActiveTexture(GLenum texture)
+{
+    record(FN_glActiveTexture);
+    state().activeTexture = texture;
+}
+GL_APICALL void GL_APIENTRY glAttachShader(GLuint program, GLuint shader)
+{
+    record(FN_glAttachShader);
+}
+GL_APICALL void GL_APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    record(FN_glBindFramebuffer);
+    state().framebuffer = framebuffer;
+}
+GL_APICALL void GL_APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    record(FN_glBindRenderbuffer);
+    state().renderbuffer = renderbuffer;
+}
+GL_APICALL void GL_APIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    record(FN_glBindTexture);
+    State &s = state();
+    s.counters.textureBinds++;
+    s.boundTextures[unitIndex(s.activeTexture)] = texture;
+}
+GL_APICALL void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    record(FN_glBlendFunc);
+    State &s = state();
+    s.blendSrcRgb = s.blendSrcAlpha = sfactor;
+    s.blendDstRgb = s.blendDstAlpha = dfactor;
+}
+GL_APICALL void GL_APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha)
+{
+    record(FN_glBlendFuncSeparate);
+    State &s = state();
+    s.blendSrcRgb = sfactorRGB;
+    s.blendDstRgb = dfactorRGB;
+    s.blendSrcAlpha = sfactorAlpha;
+    s.blendDstAlpha = dfactorAlpha;
+}
+GL_APICALL GLenum GL_APIENTRY glCheckFramebufferStatus(GLenum target)
+{
+    record(FN_glCheckFramebufferStatus);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+GL_APICALL void GL_APIENTRY glClear(GLbitfield mask)
+{
+    record(FN_glClear);
+}
+GL_APICALL void GL_APIENTRY glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    record(FN_glClearColor);
+    State &s = state();
+    s.clearColor[0] = red;
+    s.clearColor[1] = green;
+    s.clearColor[2] = blue;
+    s.clearColor[3] = alpha;
+}
+GL_APICALL void GL_APIENTRY glClearDepthf(GLfloat d)
+{
+    record(FN_glClearDepthf);
+}
+GL_APICALL void GL_APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    record(FN_glColorMask);
+    State &s = state();
+    s.colorMask[0] = red;
+    s.colorMask[1] = green;
+    s.colorMask[2] = blue;
+    s.colorMask[3] = alpha;
+}
+GL_APICALL void GL_APIENTRY glCompileShader(GLuint shader)
+{
+    record(FN_glCompileShader);
+}
+GL_APICALL void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data)
+{
+    record(FN_glCompressedTexImage2D);
+    if (imageSize > 0)
+        state().counters.textureUploadBytes += static_cast<std::size_t>(imageSize);
+}
+GL_APICALL GLuint GL_APIENTRY glCreateProgram(void)
+{
+    record(FN_glCreateProgram);
+    return state().nextName++;
+}
+GL_APICALL GLuint GL_APIENTRY glCreateShader(GLenum type)
+{
+    record(FN_glCreateShader);
+    return state().nextName++;
+}
+GL_APICALL void GL_APIENTRY glCullFace(GLenum mode)
+{
+    record(FN_glCullFace);
+}
+GL_APICALL void GL_APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+{
+    record(FN_glDeleteFramebuffers);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++) {
+        if (framebuffers[i] == s.framebuffer)
+            s.framebuffer = 0u;
+    }
+}
+GL_APICALL void GL_APIENTRY glDeleteProgram(GLuint program)
+{
+    record(FN_glDeleteProgram);
+}
+GL_APICALL void GL_APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
+{
+    record(FN_glDeleteRenderbuffers);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++) {
+        if (renderbuffers[i] == s.renderbuffer)
+            s.renderbuffer = 0u;
+    }
+}
+GL_APICALL void GL_APIENTRY glDeleteShader(GLuint shader)
+{
+    record(FN_glDeleteShader);
+}
+GL_APICALL void GL_APIENTRY glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+    record(FN_glDeleteTextures);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++) {
+        if (s.textures.erase(textures[i]))
+            s.counters.liveTextures--;
+        for (std::size_t j = 0u; j < MAX_TEXTURE_UNITS; j++) {
+            if (s.boundTextures[j] == textures[i])
+                s.boundTextures[j] = 0u;
+        }
+    }
+}
+GL_APICALL void GL_APIENTRY glDepthFunc(GLenum func)
+{
+    record(FN_glDepthFunc);
+    state().depthFunc = func;
+}
+GL_APICALL void GL_APIENTRY glDepthMask(GLboolean flag)
+{
+    record(FN_glDepthMask);
+    state().depthMask = flag;
+}
+GL_APICALL void GL_APIENTRY glDepthRangef(GLfloat n, GLfloat f)
+{
+    record(FN_glDepthRangef);
+    State &s = state();
+    s.depthRange[0] = n;
+    s.depthRange[1] = f;
+}
+GL_APICALL void GL_APIENTRY glDisable(GLenum cap)
+{
+    record(FN_glDisable);
+    state().enabled.erase(cap);
+}
+GL_APICALL void GL_APIENTRY glDisableVertexAttribArray(GLuint index)
+{
+    record(FN_glDisableVertexAttribArray);
+}
+GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    record(FN_glDrawArrays);
+    State &s = state();
+    s.counters.drawCalls++;
+    if (count > 0)
+        s.counters.vertices += static_cast<std::size_t>(count);
+}
+GL_APICALL void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+{
+    record(FN_glDrawElements);
+    State &s = state();
+    s.counters.drawCalls++;
+    if (count > 0)
+        s.counters.vertices += static_cast<std::size_t>(count);
+}
+GL_APICALL void GL_APIENTRY glEnable(GLenum cap)
+{
+    record(FN_glEnable);
+    state().enabled.insert(cap);
+}
+GL_APICALL void GL_APIENTRY glEnableVertexAttribArray(GLuint index)
+{
+    record(FN_glEnableVertexAttribArray);
+}
+GL_APICALL void GL_APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    record(FN_glFramebufferRenderbuffer);
+}
+GL_APICALL void GL_APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    record(FN_glFramebufferTexture2D);
+}
+GL_APICALL void GL_APIENTRY glFrontFace(GLenum mode)
+{
+    record(FN_glFrontFace);
+}
+GL_APICALL void GL_APIENTRY glGenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+    record(FN_glGenFramebuffers);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++)
+        framebuffers[i] = s.nextName++;
+}
+GL_APICALL void GL_APIENTRY glGenRenderbuffers(GLsizei n, GLuint *renderbuffers)
+{
+    record(FN_glGenRenderbuffers);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++)
+        renderbuffers[i] = s.nextName++;
+}
+GL_APICALL void GL_APIENTRY glGenTextures(GLsizei n, GLuint *textures)
+{
+    record(FN_glGenTextures);
+    State &s = state();
+    for (GLsizei i = 0; i < n; i++) {
+        textures[i] = s.nextName++;
+        s.textures.insert(textures[i]);
+        s.counters.liveTextures++;
+    }
+}
+GL_APICALL void GL_APIENTRY glGenerateMipmap(GLenum target)
+{
+    record(FN_glGenerateMipmap);
+}
+GL_APICALL GLint GL_APIENTRY glGetAttribLocation(GLuint program, const GLchar *name)
+{
+    record(FN_glGetAttribLocation);
+    State &s = state();
+    const std::pair<GLuint, std::string> key(program, std::string("a:") + name);
+    auto entry = s.locations.find(key);
+    if (entry != s.locations.end())
+        return entry->second;
+    const GLint location = s.nextLocation[program]++;
+    s.locations[key] = location;
+    return location;
+}
+GL_APICALL void GL_APIENTRY glGetBooleanv(GLenum pname, GLboolean *data)
+{
+    record(FN_glGetBooleanv);
+    const State &s = state();
+    switch (pname) {
+        case GL_DEPTH_WRITEMASK :
+            data[0] = s.depthMask;
+            break;
+        case GL_COLOR_WRITEMASK :
+            for (std::size_t i = 0u; i < 4u; i++)
+                data[i] = s.colorMask[i];
+            break;
+        default :
+            data[0] = (s.enabled.find(pname) != s.enabled.end()) ? GL_TRUE : GL_FALSE;
+            break;
+    }
+}
+GL_APICALL GLenum GL_APIENTRY glGetError(void)
+{
+    record(FN_glGetError);
+    return GL_NO_ERROR;
+}
+GL_APICALL void GL_APIENTRY glGetFloatv(GLenum pname, GLfloat *data)
+{
+    record(FN_glGetFloatv);
+    const State &s = state();
+    switch (pname) {
+        case GL_LINE_WIDTH :
+            data[0] = s.lineWidth;
+            break;
+        case GL_ALIASED_LINE_WIDTH_RANGE :
+        case GL_ALIASED_POINT_SIZE_RANGE :
+            data[0] = 1.0f;
+            data[1] = 64.0f;
+            break;
+        case GL_COLOR_CLEAR_VALUE :
+            memcpy(data, s.clearColor, sizeof(s.clearColor));
+            break;
+        case GL_DEPTH_RANGE :
+            memcpy(data, s.depthRange, sizeof(s.depthRange));
+            break;
+        default :
+            data[0] = 0.0f;
+            break;
+    }
+}
+GL_APICALL void GL_APIENTRY glGetIntegerv(GLenum pname, GLint *data)
+{
+    record(FN_glGetIntegerv);
+    const State &s = state();
+    switch (pname) {
+        case GL_CURRENT_PROGRAM :
+            data[0] = static_cast<GLint>(s.program);
+            break;
+        case GL_ACTIVE_TEXTURE :
+            data[0] = static_cast<GLint>(s.activeTexture);
+            break;
+        case GL_TEXTURE_BINDING_2D :
+            data[0] = static_cast<GLint>(s.boundTextures[unitIndex(s.activeTexture)]);
+            break;
+        case GL_FRAMEBUFFER_BINDING :
+            data[0] = static_cast<GLint>(s.framebuffer);
+            break;
+        case GL_RENDERBUFFER_BINDING :
+            data[0] = static_cast<GLint>(s.renderbuffer);
+            break;
+        case GL_VIEWPORT :
+            memcpy(data, s.viewport, sizeof(s.viewport));
+            break;
+        case GL_DEPTH_FUNC :
+            data[0] = static_cast<GLint>(s.depthFunc);
+            break;
+        case GL_BLEND_SRC_RGB :
+            data[0] = static_cast<GLint>(s.blendSrcRgb);
+            break;
+        case GL_BLEND_DST_RGB :
+            data[0] = static_cast<GLint>(s.blendDstRgb);
+            break;
+        case GL_BLEND_SRC_ALPHA :
+            data[0] = static_cast<GLint>(s.blendSrcAlpha);
+            break;
+        case GL_BLEND_DST_ALPHA :
+            data[0] = static_cast<GLint>(s.blendDstAlpha);
+            break;
+        case GL_MAX_TEXTURE_SIZE :
+        case GL_MAX_RENDERBUFFER_SIZE :
+            data[0] = 4096;
+            break;
+        case GL_MAX_VIEWPORT_DIMS :
+            data[0] = 4096;
+            data[1] = 4096;
+            break;
+        case GL_MAX_TEXTURE_IMAGE_UNITS :
+        case GL_MAX_VERTEX_ATTRIBS :
+            data[0] = 16;
+            break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS :
+            data[0] = static_cast<GLint>(MAX_TEXTURE_UNITS);
+            break;
+        case GL_DEPTH_BITS :
+            data[0] = 24;
+            break;
+        case GL_RED_BITS :
+        case GL_GREEN_BITS :
+        case GL_BLUE_BITS :
+        case GL_ALPHA_BITS :
+            data[0] = 8;
+            break;
+        default :
+            data[0] = 0;
+            break;
+    }
+}
+GL_APICALL void GL_APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    record(FN_glGetProgramInfoLog);
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = '\0';
+}
+GL_APICALL void GL_APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+    record(FN_glGetProgramiv);
+    switch (pname) {
+        case GL_LINK_STATUS :
+        case GL_VALIDATE_STATUS :
+            params[0] = GL_TRUE;
+            break;
+        default :
+            params[0] = 0;
+            break;
+    }
+}
+GL_APICALL void GL_APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+    record(FN_glGetShaderInfoLog);
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = '\0';
+}
+GL_APICALL void GL_APIENTRY glGetShaderPrecisionFormat(GLenum shadertype, GLenum precisiontype, GLint *range, GLint *precision)
+{
+    record(FN_glGetShaderPrecisionFormat);
+    // IEEE single precision
+    range[0] = 127;
+    range[1] = 127;
+    *precision = 23;
+}
+GL_APICALL void GL_APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+    record(FN_glGetShaderiv);
+    switch (pname) {
+        case GL_COMPILE_STATUS :
+            params[0] = GL_TRUE;
+            break;
+        default :
+            params[0] = 0;
+            break;
+    }
+}
+GL_APICALL GLint GL_APIENTRY glGetUniformLocation(GLuint program, const GLchar *name)
+{
+    record(FN_glGetUniformLocation);
+    State &s = state();
+    const std::pair<GLuint, std::string> key(program, std::string("u:") + name);
+    auto entry = s.locations.find(key);
+    if (entry != s.locations.end())
+        return entry->second;
+    const GLint location = s.nextLocation[program]++;
+    s.locations[key] = location;
+    return location;
+}
+GL_APICALL GLboolean GL_APIENTRY glIsEnabled(GLenum cap)
+{
+    record(FN_glIsEnabled);
+    const State &s = state();
+    return (s.enabled.find(cap) != s.enabled.end()) ? GL_TRUE : GL_FALSE;
+}
+GL_APICALL void GL_APIENTRY glLineWidth(GLfloat width)
+{
+    record(FN_glLineWidth);
+    state().lineWidth = width;
+}
+GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
+{
+    record(FN_glLinkProgram);
+}
+GL_APICALL void GL_APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    record(FN_glRenderbufferStorage);
+}
+GL_APICALL void GL_APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length)
+{
+    record(FN_glShaderSource);
+}
+GL_APICALL void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels)
+{
+    record(FN_glTexImage2D);
+    if (pixels && width > 0 && height > 0)
+        state().counters.textureUploadBytes += static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * bytesPerPixel(format, type);
+}
+GL_APICALL void GL_APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    record(FN_glTexParameterf);
+}
+GL_APICALL void GL_APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    record(FN_glTexParameteri);
+}
+GL_APICALL void GL_APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+{
+    record(FN_glTexSubImage2D);
+    if (pixels && width > 0 && height > 0)
+        state().counters.textureUploadBytes += static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * bytesPerPixel(format, type);
+}
+GL_APICALL void GL_APIENTRY glUniform1f(GLint location, GLfloat v0)
+{
+    record(FN_glUniform1f);
+}
+GL_APICALL void GL_APIENTRY glUniform1i(GLint location, GLint v0)
+{
+    record(FN_glUniform1i);
+}
+GL_APICALL void GL_APIENTRY glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    record(FN_glUniform4f);
+}
+GL_APICALL void GL_APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+{
+    record(FN_glUniformMatrix4fv);
+}
+GL_APICALL void GL_APIENTRY glUseProgram(GLuint program)
+{
+    record(FN_glUseProgram);
+    State &s = state();
+    s.counters.programBinds++;
+    s.program = program;
+}
+GL_APICALL void GL_APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer)
+{
+    record(FN_glVertexAttribPointer);
+}
+GL_APICALL void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    record(FN_glViewport);
+    State &s = state();
+    s.viewport[0] = x;
+    s.viewport[1] = y;
+    s.viewport[2] = width;
+    s.viewport[3] = height;
+}
@@ -0,0 +1,66 @@
+#ifndef TAK_ENGINE_TESTS_RECORDINGGL_H_INCLUDED
+#define TAK_ENGINE_TESTS_RECORDINGGL_H_INCLUDED
+
+#include <cstddef>
+
+#include "port/Platform.h"
+#include "util/Error.h"
+
+/**
+ * The recording GL backend implements the OpenGL ES entry points
+ * that the engine calls without a GPU. Each call is counted and
+ * does no rendering. The backend tracks only the state that the
+ * engine reads back: bindings, enables, the viewport, object
+ * names and shader locations. Shaders always compile, programs
+ * always link and framebuffers are always complete.
+ *
+ * <P>Linked in place of the platform GL library, it lets the
+ * renderer run headless, so that its CPU cost and the GL work it
+ * issues may be measured on any host.
+ *
+ * <P>Not thread-safe. Like a real context, it must only be used
+ * on a single thread.
+ */
+namespace TAK {
+    namespace Engine {
+        namespace Tests {
+            /**
+             * Totals recorded by the recording GL backend since the last
+             * reset.
+             */
+            struct GLCounters
+            {
+                /** the number of GL calls of any kind */
+                std::size_t calls;
+                /** the number of glDrawArrays and glDrawElements calls */
+                std::size_t drawCalls;
+                /** the number of vertices (or indices) submitted for drawing */
+                std::size_t vertices;
+                /** the number of glUseProgram calls */
+                std::size_t programBinds;
+                /** the number of glBindTexture calls */
+                std::size_t textureBinds;
+                /** the number of pixel bytes passed to the texture upload calls */
+                std::size_t textureUploadBytes;
+                /** the number of texture names currently allocated */
+                std::size_t liveTextures;
+            };
+
+            /** zeroes all counters but <code>liveTextures</code>; GL state and object names are retained */
+            void RecordingGL_reset() NOTHROWS;
+            void RecordingGL_getCounters(GLCounters *value) NOTHROWS;
+            /**
+             * Returns the number of calls made to the named GL function, or
+             * <code>0</code> if the backend does not implement it.
+             */
+            std::size_t RecordingGL_getCallCount(const char *fn) NOTHROWS;
+            /**
+             * Visits the call count of each GL function that has been called
+             * at least once since the last reset.
+             */
+            Util::TAKErr RecordingGL_visitCallCounts(Util::TAKErr(*visitor)(void *opaque, const char *fn, const std::size_t count) NOTHROWS, void *opaque) NOTHROWS;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "Matrix2Reference.h"
+
+#include <cstring>
+
+namespace
+{
+    double cofactor(const double p, const double q, const double r, const double x, const double y, const double z) NOTHROWS
+    {
+        return (p*x - q*y) + r*z;
+    }
+}
+
+void TAK::Engine::Tests::Matrix2Reference_legacyConcatenate(double *r, const double *a, const double *b) NOTHROWS
+{
+    double t[16];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++)
+            t[i*4+j] = a[i*4]*b[j] + a[i*4+1]*b[4+j] + a[i*4+2]*b[8+j] + a[i*4+3]*b[12+j];
+    }
+    memcpy(r, t, sizeof(t));
+}
+
+bool TAK::Engine::Tests::Matrix2Reference_legacyTransform(double *dst, const double *m, const double x, const double y, const double z) NOTHROWS
+{
+    const double dstX = x * m[0] + y * m[1] + z * m[2] + m[3];
+    const double dstY = x * m[4] + y * m[5] + z * m[6] + m[7];
+    const double dstZ = x * m[8] + y * m[9] + z * m[10] + m[11];
+    const double dstW = x * m[12] + y * m[13] + z * m[14] + m[15];
+    if (dstW == 0)
+        return false;
+    dst[0] = (dstX / dstW);
+    dst[1] = (dstY / dstW);
+    dst[2] = (dstZ / dstW);
+    return true;
+}
+
+bool TAK::Engine::Tests::Matrix2Reference_legacyInverse(double *r, const double *a) NOTHROWS
+{
+    const double m00 = a[0], m01 = a[1], m02 = a[2], m03 = a[3];
+    const double m10 = a[4], m11 = a[5], m12 = a[6], m13 = a[7];
+    const double m20 = a[8], m21 = a[9], m22 = a[10], m23 = a[11];
+    const double m30 = a[12], m31 = a[13], m32 = a[14], m33 = a[15];
+
+    const double determinant = (m00*m11*m22*m33) + (m00*m12*m23*m31) + (m00*m13*m21*m32)
+        + (m01*m10*m23*m32) + (m01*m12*m20*m33) + (m01*m13*m22*m30)
+        + (m02*m10*m21*m33) + (m02*m11*m23*m30) + (m02*m13*m20*m31)
+        + (m03*m10*m22*m31) + (m03*m11*m20*m32) + (m03*m12*m21*m30)
+        - (m00*m11*m23*m32) - (m00*m12*m21*m33) - (m00*m13*m22*m31)
+        - (m01*m10*m22*m33) - (m01*m12*m23*m30) - (m01*m13*m20*m32)
+        - (m02*m10*m23*m31) - (m02*m11*m20*m33) - (m02*m13*m21*m30)
+        - (m03*m10*m21*m32) - (m03*m11*m22*m30) - (m03*m12*m20*m31);
+    if (determinant == 0.0)
+        return false;
+
+    const double recipDet = 1.0 / determinant;
+    r[0] = recipDet * ((m11*m22*m33) + (m12*m23*m31) + (m13*m21*m32) - (m11*m23*m32) - (m12*m21*m33) - (m13*m22*m31));
+    r[1] = recipDet * ((m01*m23*m32) + (m02*m21*m33) + (m03*m22*m31) - (m01*m22*m33) - (m02*m23*m31) - (m03*m21*m32));
+    r[2] = recipDet * ((m01*m12*m33) + (m02*m13*m31) + (m03*m11*m32) - (m01*m13*m32) - (m02*m11*m33) - (m03*m12*m31));
+    r[3] = recipDet * ((m01*m13*m22) + (m02*m11*m23) + (m03*m12*m21) - (m01*m12*m23) - (m02*m13*m21) - (m03*m11*m22));
+    r[4] = recipDet * ((m10*m23*m32) + (m12*m20*m33) + (m13*m22*m30) - (m10*m22*m33) - (m12*m23*m30) - (m13*m20*m32));
+    r[5] = recipDet * ((m00*m22*m33) + (m02*m23*m30) + (m03*m20*m32) - (m00*m23*m32) - (m02*m20*m33) - (m03*m22*m30));
+    r[6] = recipDet * ((m00*m13*m32) + (m02*m10*m33) + (m03*m12*m30) - (m00*m12*m33) - (m02*m13*m30) - (m03*m10*m32));
+    r[7] = recipDet * ((m00*m12*m23) + (m02*m13*m20) + (m03*m10*m22) - (m00*m13*m22) - (m02*m10*m23) - (m03*m12*m20));
+    r[8] = recipDet * ((m10*m21*m33) + (m11*m23*m30) + (m13*m20*m31) - (m10*m23*m31) - (m11*m20*m33) - (m13*m21*m30));
+    r[9] = recipDet * ((m00*m23*m31) + (m01*m20*m33) + (m03*m21*m30) - (m00*m21*m33) - (m01*m23*m30) - (m03*m20*m31));
+    r[10] = recipDet * ((m00*m11*m33) + (m01*m13*m30) + (m03*m10*m31) - (m00*m13*m31) - (m01*m10*m33) - (m03*m11*m30));
+    r[11] = recipDet * ((m00*m13*m21) + (m01*m10*m23) + (m03*m11*m20) - (m00*m11*m23) - (m01*m13*m20) - (m03*m10*m21));
+    r[12] = recipDet * ((m10*m22*m31) + (m11*m20*m32) + (m12*m21*m30) - (m10*m21*m32) - (m11*m22*m30) - (m12*m20*m31));
+    r[13] = recipDet * ((m00*m21*m32) + (m01*m22*m30) + (m02*m20*m31) - (m00*m22*m31) - (m01*m20*m32) - (m02*m21*m30));
+    r[14] = recipDet * ((m00*m12*m31) + (m01*m10*m32) + (m02*m11*m30) - (m00*m11*m32) - (m01*m12*m30) - (m02*m10*m31));
+    r[15] = recipDet * ((m00*m11*m22) + (m01*m12*m20) + (m02*m10*m21) - (m00*m12*m21) - (m01*m10*m22) - (m02*m11*m20));
+    return true;
+}
+
+bool TAK::Engine::Tests::Matrix2Reference_adjugateInverse(double *r, const double *a) NOTHROWS
+{
+    const double s0 = a[0]*a[5] - a[4]*a[1];
+    const double s1 = a[0]*a[6] - a[4]*a[2];
+    const double s2 = a[0]*a[7] - a[4]*a[3];
+    const double s3 = a[1]*a[6] - a[5]*a[2];
+    const double s4 = a[1]*a[7] - a[5]*a[3];
+    const double s5 = a[2]*a[7] - a[6]*a[3];
+    const double c5 = a[10]*a[15] - a[14]*a[11];
+    const double c4 = a[9]*a[15] - a[13]*a[11];
+    const double c3 = a[9]*a[14] - a[13]*a[10];
+    const double c2 = a[8]*a[15] - a[12]*a[11];
+    const double c1 = a[8]*a[14] - a[12]*a[10];
+    const double c0 = a[8]*a[13] - a[12]*a[9];
+
+    const double det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    if (det == 0.0)
+        return false;
+    const double invDet = 1.0 / det;
+
+    r[0] = cofactor(a[5], a[6], a[7], c5, c4, c3) * invDet;
+    r[1] = -cofactor(a[1], a[2], a[3], c5, c4, c3) * invDet;
+    r[2] = cofactor(a[13], a[14], a[15], s5, s4, s3) * invDet;
+    r[3] = -cofactor(a[9], a[10], a[11], s5, s4, s3) * invDet;
+    r[4] = -cofactor(a[4], a[6], a[7], c5, c2, c1) * invDet;
+    r[5] = cofactor(a[0], a[2], a[3], c5, c2, c1) * invDet;
+    r[6] = -cofactor(a[12], a[14], a[15], s5, s2, s1) * invDet;
+    r[7] = cofactor(a[8], a[10], a[11], s5, s2, s1) * invDet;
+    r[8] = cofactor(a[4], a[5], a[7], c4, c2, c0) * invDet;
+    r[9] = -cofactor(a[0], a[1], a[3], c4, c2, c0) * invDet;
+    r[10] = cofactor(a[12], a[13], a[15], s4, s2, s0) * invDet;
+    r[11] = -cofactor(a[8], a[9], a[11], s4, s2, s0) * invDet;
+    r[12] = -cofactor(a[4], a[5], a[6], c3, c1, c0) * invDet;
+    r[13] = cofactor(a[0], a[1], a[2], c3, c1, c0) * invDet;
+    r[14] = -cofactor(a[12], a[13], a[14], s3, s1, s0) * invDet;
+    r[15] = cofactor(a[8], a[9], a[10], s3, s1, s0) * invDet;
+    return true;
+}
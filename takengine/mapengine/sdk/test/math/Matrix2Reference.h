@@ -0,0 +1,42 @@
+#ifndef TAK_ENGINE_TESTS_MATRIX2REFERENCE_H_INCLUDED
+#define TAK_ENGINE_TESTS_MATRIX2REFERENCE_H_INCLUDED
+
+#include "port/Platform.h"
+
+/**
+ * Reference 4x4 matrix operations for the Matrix2 test and benchmark.
+ *
+ * <P>The functions named <code>legacy</code> are the Matrix2 implementation
+ * prior to the column-major SIMD kernels, with the named members replaced by
+ * a row-major array (element at row r, column c is m[r*4+c]). The IEEE
+ * operations are unchanged, so the current multiply and transform are
+ * expected to match them bit for bit.
+ *
+ * <P><code>adjugateInverse</code> is the scalar form of the current inverse.
+ * The current inverse is expected to match it bit for bit with any kernel;
+ * it is expected to match <code>legacyInverse</code> only within rounding.
+ */
+namespace TAK {
+    namespace Engine {
+        namespace Tests {
+            /** r = a * b, row-major. 'r' may alias 'a' or 'b'. */
+            void Matrix2Reference_legacyConcatenate(double *r, const double *a, const double *b) NOTHROWS;
+
+            /** Returns false, leaving 'dst' unmodified, if w == 0 */
+            bool Matrix2Reference_legacyTransform(double *dst, const double *m, const double x, const double y, const double z) NOTHROWS;
+
+            /** Returns false if 'a' is singular. 'r' may not alias 'a'. */
+            bool Matrix2Reference_legacyInverse(double *r, const double *a) NOTHROWS;
+
+            /**
+             * Scalar adjugate inverse from the 2x2 minors of the row pairs, in
+             * the operation order of the Matrix2 kernels. Layout agnostic, as
+             * inverse(transpose(A)) is transpose(inverse(A)). Returns false if
+             * 'a' is singular. 'r' may not alias 'a'.
+             */
+            bool Matrix2Reference_adjugateInverse(double *r, const double *a) NOTHROWS;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,306 @@
+// Matrix2 microbenchmark.
+//
+// Times the Matrix2 point transforms, multiply and inverse against the
+// implementation that preceded the SIMD kernels (test/math/Matrix2Reference.h)
+// over the same random matrices and points, and reports nanoseconds per
+// operation.  Point transforms are timed one at a time, through the bulk
+// interleaved overload and through the bulk coordinate array overload.
+//
+// Each measurement is the best of the repeated runs, to reduce the effect of
+// scheduling noise.  Results are accumulated into a checksum that is printed
+// so the compiler cannot discard the work.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "math/Matrix2.h"
+
+#include "Matrix2Reference.h"
+
+using namespace TAK::Engine::Math;
+using namespace TAK::Engine::Tests;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        std::size_t numPoints;
+        std::size_t numMatrices;
+        std::size_t repeat;
+        uint32_t seed;
+    };
+
+    struct Data
+    {
+        std::vector<double> rowMajor;
+        std::vector<Matrix2> matrices;
+        std::vector<Point2<double>> points;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+    };
+
+    typedef double(*Kernel)(Data &data);
+
+    const char *kernelName() NOTHROWS;
+    void generate(Data &data, const Options &opts) NOTHROWS;
+    double measure(double *checksum, Kernel kernel, Data &data, const std::size_t repeat) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+
+    double legacyTransform(Data &data);
+    double transform(Data &data);
+    double transformBulk(Data &data);
+    double transformSoA(Data &data);
+    double legacyConcatenate(Data &data);
+    double concatenate(Data &data);
+    double legacyInverse(Data &data);
+    double inverse(Data &data);
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.numPoints = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-m") && hasValue) {
+            opts.numMatrices = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-r") && hasValue) {
+            opts.repeat = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-s") && hasValue) {
+            opts.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.numPoints || !opts.numMatrices || !opts.repeat) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Data data;
+    generate(data, opts);
+
+    struct Case
+    {
+        const char *name;
+        Kernel legacy;
+        Kernel current;
+        std::size_t ops;
+    };
+    const Case cases[] =
+    {
+        { "transform", legacyTransform, transform, opts.numPoints },
+        { "transform (bulk)", legacyTransform, transformBulk, opts.numPoints },
+        { "transform (x/y/z)", legacyTransform, transformSoA, opts.numPoints },
+        { "concatenate", legacyConcatenate, concatenate, opts.numMatrices },
+        { "inverse", legacyInverse, inverse, opts.numMatrices },
+    };
+
+    printf("kernel %s, %u points, %u matrices, best of %u runs\n\n", kernelName(), (unsigned)opts.numPoints, (unsigned)opts.numMatrices, (unsigned)opts.repeat);
+    printf("operation              previous ns/op   current ns/op   speedup\n");
+    double checksum = 0.0;
+    for (std::size_t i = 0u; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const double legacyNs = measure(&checksum, cases[i].legacy, data, opts.repeat) / cases[i].ops;
+        const double currentNs = measure(&checksum, cases[i].current, data, opts.repeat) / cases[i].ops;
+        printf("%-20s %16.2f %15.2f %8.2fx\n", cases[i].name, legacyNs, currentNs, legacyNs / currentNs);
+    }
+    printf("\nchecksum %g\n", checksum);
+    return 0;
+}
+
+namespace
+{
+    Options::Options() NOTHROWS :
+        numPoints(1000000u),
+        numMatrices(100000u),
+        repeat(5u),
+        seed(1u)
+    {}
+
+    void generate(Data &data, const Options &opts) NOTHROWS
+    {
+        std::mt19937 rng(opts.seed);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        std::uniform_real_distribution<double> translation(-1e6, 1e6);
+
+        data.rowMajor.resize(opts.numMatrices*16u);
+        data.matrices.reserve(opts.numMatrices);
+        for (std::size_t i = 0u; i < opts.numMatrices; i++) {
+            double *m = &data.rowMajor[i*16u];
+            for (std::size_t r = 0u; r < 3u; r++) {
+                for (std::size_t c = 0u; c < 3u; c++)
+                    m[r*4u+c] = unit(rng) + ((r == c) ? 2.0 : 0.0);
+                m[r*4u+3u] = translation(rng);
+            }
+            m[12] = unit(rng) * 1e-3;
+            m[13] = unit(rng) * 1e-3;
+            m[14] = unit(rng) * 1e-3;
+            m[15] = 1.0 + unit(rng) * 0.5;
+            data.matrices.push_back(Matrix2(m[0], m[1], m[2], m[3],
+                                            m[4], m[5], m[6], m[7],
+                                            m[8], m[9], m[10], m[11],
+                                            m[12], m[13], m[14], m[15]));
+        }
+
+        data.points.resize(opts.numPoints);
+        data.x.resize(opts.numPoints);
+        data.y.resize(opts.numPoints);
+        data.z.resize(opts.numPoints);
+        for (std::size_t i = 0u; i < opts.numPoints; i++) {
+            data.points[i] = Point2<double>(translation(rng), translation(rng), translation(rng));
+            data.x[i] = data.points[i].x;
+            data.y[i] = data.points[i].y;
+            data.z[i] = data.points[i].z;
+        }
+    }
+
+    double measure(double *checksum, Kernel kernel, Data &data, const std::size_t repeat) NOTHROWS
+    {
+        double best = 0.0;
+        for (std::size_t i = 0u; i < repeat; i++) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            *checksum += kernel(data);
+            const auto end = std::chrono::high_resolution_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if (!i || ns < best)
+                best = ns;
+        }
+        return best;
+    }
+
+    // the point transforms all use the first matrix, as a renderer would
+    // transform a batch of vertices by a single scene transform
+
+    double legacyTransform(Data &data)
+    {
+        const double *m = &data.rowMajor[0];
+        double sum = 0.0;
+        double xyz[3];
+        for (std::size_t i = 0u; i < data.points.size(); i++) {
+            Matrix2Reference_legacyTransform(xyz, m, data.points[i].x, data.points[i].y, data.points[i].z);
+            sum += xyz[0];
+        }
+        return sum;
+    }
+
+    double transform(Data &data)
+    {
+        const Matrix2 &m = data.matrices[0];
+        double sum = 0.0;
+        Point2<double> xyz;
+        for (std::size_t i = 0u; i < data.points.size(); i++) {
+            m.transform(&xyz, data.points[i]);
+            sum += xyz.x;
+        }
+        return sum;
+    }
+
+    double transformBulk(Data &data)
+    {
+        // per call, so that the result of one run is not the input to the next
+        static std::vector<Point2<double>> dst;
+        dst.resize(data.points.size());
+        data.matrices[0].transform(dst.data(), data.points.data(), data.points.size());
+        return dst.back().x;
+    }
+
+    double transformSoA(Data &data)
+    {
+        static std::vector<double> x, y, z;
+        x.resize(data.x.size());
+        y.resize(data.y.size());
+        z.resize(data.z.size());
+        data.matrices[0].transform(x.data(), y.data(), z.data(), data.x.data(), data.y.data(), data.z.data(), data.x.size());
+        return x.back();
+    }
+
+    double legacyConcatenate(Data &data)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < data.matrices.size(); i++) {
+            // copied first, as Matrix2::concatenate modifies the matrix
+            double t[16];
+            memcpy(t, &data.rowMajor[0], sizeof(t));
+            Matrix2Reference_legacyConcatenate(t, t, &data.rowMajor[i*16u]);
+            sum += t[3];
+        }
+        return sum;
+    }
+
+    double concatenate(Data &data)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < data.matrices.size(); i++) {
+            Matrix2 t(data.matrices[0]);
+            t.concatenate(data.matrices[i]);
+            double v;
+            t.get(&v, 0u, 3u);
+            sum += v;
+        }
+        return sum;
+    }
+
+    double legacyInverse(Data &data)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < data.matrices.size(); i++) {
+            double inv[16];
+            if (Matrix2Reference_legacyInverse(inv, &data.rowMajor[i*16u]))
+                sum += inv[0];
+        }
+        return sum;
+    }
+
+    double inverse(Data &data)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < data.matrices.size(); i++) {
+            Matrix2 inv;
+            if (data.matrices[i].createInverse(&inv) == TE_Ok) {
+                double v;
+                inv.get(&v, 0u, 0u);
+                sum += v;
+            }
+        }
+        return sum;
+    }
+
+    const char *kernelName() NOTHROWS
+    {
+        // mirrors the selection in Matrix2.cpp
+#if defined(TE_MATRIX2_NO_SIMD)
+        return "scalar";
+#elif defined(__AVX__)
+        return "AVX";
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -n <count>   number of points to transform (default 1000000)\n");
+        printf("    -m <count>   number of matrices to multiply and invert (default 100000)\n");
+        printf("    -r <count>   runs per operation; the best is reported (default 5)\n");
+        printf("    -s <seed>    random seed (default 1)\n");
+        printf("    -h           print this message\n");
+    }
+}
@@ -0,0 +1,571 @@
+// Mosaic query filter benchmark.
+//
+// Generates an atak3 mosaic database of synthetic frames and runs selective
+// queries against it twice: once with the query filters compiled into the
+// database's SQL (native), and once with the database producing every row
+// that the other query parameters select and FilterMosaicDatabaseCursor2
+// rejecting the rows the filters do not accept (fallback).  For each query
+// it reports the rows the database produced, the rows discarded by the
+// fallback filter and the mean time to iterate the result.
+//
+// The two runs must return the same rows; the benchmark exits non-zero if
+// they do not.
+//
+// Frames are laid out on a grid, one per 0.01 degree cell, and assigned
+// round-robin to the types.  Each type's frames are in their own database,
+// as the atak3 builder writes them.  The GSD of each frame is drawn from a
+// fixed set of levels with a small jitter; paths group consecutive frames
+// into 100 directories per type.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "db/Database2.h"
+#include "db/Statement2.h"
+#include "port/STLVectorAdapter.h"
+#include "raster/mosaic/ATAKMosaicDatabase3.h"
+#include "raster/mosaic/FilterMosaicDatabaseCursor2.h"
+#include "util/Memory.h"
+
+using namespace TAK::Engine::DB;
+using namespace TAK::Engine::Port;
+using namespace TAK::Engine::Raster::Mosaic;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    const double GSD_LEVELS[] = { 0.5, 1.0, 2.0, 5.0, 10.0, 30.0, 60.0, 120.0 };
+
+    /** counts the rows produced by the cursor it wraps */
+    class CountingCursor : public FilterMosaicDatabaseCursor2
+    {
+    public :
+        CountingCursor(MosaicDatabase2::CursorPtr &&impl, std::size_t &count) NOTHROWS;
+        ~CountingCursor() NOTHROWS override;
+    public :
+        TAKErr moveToNext() NOTHROWS override;
+    private :
+        std::size_t &count;
+    };
+
+    /**
+     * Forwards queries to another database, counting the rows it produces.
+     * With <code>native</code> unset, no filter is evaluated natively and
+     * MosaicDatabase2::query applies all of them to the counted rows.
+     */
+    class CountingDatabase : public MosaicDatabase2
+    {
+    public :
+        CountingDatabase(MosaicDatabase2 &impl, const bool native) NOTHROWS;
+        ~CountingDatabase() NOTHROWS override;
+    public :
+        const char *getType() NOTHROWS override;
+        TAKErr open(const char *path) NOTHROWS override;
+        TAKErr close() NOTHROWS override;
+        TAKErr getCoverage(std::shared_ptr<const Coverage> &value) NOTHROWS override;
+        TAKErr getCoverages(Collection<std::pair<String, std::shared_ptr<const Coverage>>> &coverages) NOTHROWS override;
+        TAKErr getCoverage(std::shared_ptr<const Coverage> &value, const char *type) NOTHROWS override;
+        bool isNativeFilter(const FrameFilter &filter) NOTHROWS override;
+    protected :
+        TAKErr queryImpl(CursorPtr &value, const QueryParameters &params) NOTHROWS override;
+    public :
+        std::size_t produced;
+    private :
+        MosaicDatabase2 &impl;
+        bool native;
+    };
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        const char *dir;
+        std::size_t numFrames;
+        std::size_t numTypes;
+        std::size_t repeat;
+        uint32_t seed;
+        bool generate;
+    };
+
+    struct Scenario
+    {
+        const char *name;
+        std::vector<std::shared_ptr<MosaicDatabase2::FrameFilter>> filters;
+    };
+
+    struct Result
+    {
+        std::size_t returned;
+        std::size_t produced;
+        double meanMillis;
+    };
+
+    TAKErr generate(const Options &opts) NOTHROWS;
+    TAKErr createScenarios(std::vector<Scenario> &value, const Options &opts) NOTHROWS;
+    TAKErr run(Result *value, MosaicDatabase2 &database, const Scenario &scenario, const bool native, const std::size_t repeat) NOTHROWS;
+    std::string typeName(const std::size_t type) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-o") && hasValue) {
+            opts.dir = argv[++i];
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.numFrames = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-T") && hasValue) {
+            opts.numTypes = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-r") && hasValue) {
+            opts.repeat = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-s") && hasValue) {
+            opts.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "-k")) {
+            opts.generate = false;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.numFrames || !opts.numTypes || !opts.repeat) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    TAKErr code(TE_Ok);
+    if (opts.generate) {
+        printf("generating %u frames of %u types in %s\n", (unsigned)opts.numFrames, (unsigned)opts.numTypes, opts.dir);
+        code = generate(opts);
+        if (code != TE_Ok) {
+            fprintf(stderr, "Failed to generate the mosaic database\n");
+            return 1;
+        }
+    }
+
+    ATAKMosaicDatabase3 database;
+    code = database.open(opts.dir);
+    if (code != TE_Ok) {
+        fprintf(stderr, "Failed to open the mosaic database %s\n", opts.dir);
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    code = createScenarios(scenarios, opts);
+    if (code != TE_Ok) {
+        fprintf(stderr, "Failed to create the query filters\n");
+        return 1;
+    }
+
+    printf("%u frames, %u types, %u runs per query\n\n", (unsigned)opts.numFrames, (unsigned)opts.numTypes, (unsigned)opts.repeat);
+    printf("                           native                          fallback\n");
+    printf("query        returned    produced  discarded    ms        produced  discarded    ms\n");
+
+    bool mismatch = false;
+    for (std::size_t i = 0u; i < scenarios.size(); i++) {
+        Result native;
+        code = run(&native, database, scenarios[i], true, opts.repeat);
+        if (code != TE_Ok)
+            break;
+        Result fallback;
+        code = run(&fallback, database, scenarios[i], false, opts.repeat);
+        if (code != TE_Ok)
+            break;
+
+        printf("%-10s %10u  %10u %10u %8.2f    %10u %10u %8.2f\n",
+               scenarios[i].name,
+               (unsigned)native.returned,
+               (unsigned)native.produced, (unsigned)(native.produced - native.returned), native.meanMillis,
+               (unsigned)fallback.produced, (unsigned)(fallback.produced - fallback.returned), fallback.meanMillis);
+        if (native.returned != fallback.returned) {
+            fprintf(stderr, "%s: native query returned %u rows, fallback %u\n",
+                    scenarios[i].name, (unsigned)native.returned, (unsigned)fallback.returned);
+            mismatch = true;
+        }
+    }
+    database.close();
+
+    if (code != TE_Ok) {
+        fprintf(stderr, "Query failed\n");
+        return 1;
+    }
+    return mismatch ? 1 : 0;
+}
+
+namespace
+{
+    CountingCursor::CountingCursor(MosaicDatabase2::CursorPtr &&impl_, std::size_t &count_) NOTHROWS :
+        FilterMosaicDatabaseCursor2(std::move(impl_)),
+        count(count_)
+    {}
+
+    CountingCursor::~CountingCursor() NOTHROWS
+    {}
+
+    TAKErr CountingCursor::moveToNext() NOTHROWS
+    {
+        TAKErr code = this->impl->moveToNext();
+        if (code == TE_Ok)
+            this->count++;
+        return code;
+    }
+
+    CountingDatabase::CountingDatabase(MosaicDatabase2 &impl_, const bool native_) NOTHROWS :
+        produced(0u),
+        impl(impl_),
+        native(native_)
+    {}
+
+    CountingDatabase::~CountingDatabase() NOTHROWS
+    {}
+
+    const char *CountingDatabase::getType() NOTHROWS
+    {
+        return this->impl.getType();
+    }
+
+    TAKErr CountingDatabase::open(const char *path) NOTHROWS
+    {
+        return this->impl.open(path);
+    }
+
+    TAKErr CountingDatabase::close() NOTHROWS
+    {
+        return this->impl.close();
+    }
+
+    TAKErr CountingDatabase::getCoverage(std::shared_ptr<const Coverage> &value) NOTHROWS
+    {
+        return this->impl.getCoverage(value);
+    }
+
+    TAKErr CountingDatabase::getCoverages(Collection<std::pair<String, std::shared_ptr<const Coverage>>> &coverages) NOTHROWS
+    {
+        return this->impl.getCoverages(coverages);
+    }
+
+    TAKErr CountingDatabase::getCoverage(std::shared_ptr<const Coverage> &value, const char *type) NOTHROWS
+    {
+        return this->impl.getCoverage(value, type);
+    }
+
+    bool CountingDatabase::isNativeFilter(const FrameFilter &filter) NOTHROWS
+    {
+        return this->native && this->impl.isNativeFilter(filter);
+    }
+
+    TAKErr CountingDatabase::queryImpl(CursorPtr &value, const QueryParameters &params) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        CursorPtr result(nullptr, nullptr);
+        code = this->impl.query(result, params);
+        TE_CHECKRETURN_CODE(code);
+        value = CursorPtr(new CountingCursor(std::move(result), this->produced), Memory_deleter_const<MosaicDatabase2::Cursor, CountingCursor>);
+        return code;
+    }
+
+    Options::Options() NOTHROWS :
+        dir("mosaicbench.atak3"),
+        numFrames(100000u),
+        numTypes(4u),
+        repeat(5u),
+        seed(1u),
+        generate(true)
+    {}
+
+    TAKErr generate(const Options &opts) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+
+        mkdir(opts.dir, 0755);
+
+        const std::size_t columns = static_cast<std::size_t>(ceil(sqrt(static_cast<double>(opts.numFrames))));
+        const double cellSize = 0.01;
+        const double originLat = 34.0;
+        const double originLon = -118.5;
+        const std::size_t framesPerDir = std::max<std::size_t>(opts.numFrames / (opts.numTypes * 100u), 1u);
+        const std::size_t numLevels = sizeof(GSD_LEVELS) / sizeof(GSD_LEVELS[0]);
+
+        std::mt19937 rng(opts.seed);
+        std::uniform_int_distribution<std::size_t> levelDist(0u, numLevels - 1u);
+        std::uniform_real_distribution<double> jitterDist(0.0, 0.1);
+
+        std::ostringstream indexPath;
+        indexPath << opts.dir << "/index.sqlite";
+        remove(indexPath.str().c_str());
+
+        DatabasePtr index(nullptr, nullptr);
+        code = Databases_openDatabase(index, indexPath.str().c_str(), false);
+        TE_CHECKRETURN_CODE(code);
+        code = index->execute("CREATE TABLE coverage (type TEXT PRIMARYKEY, minlat REAL, minlon REAL, maxlat REAL, maxlon REAL, mingsd REAL, maxgsd REAL, path TEXT, coverageblob BLOB)", nullptr, 0u);
+        TE_CHECKRETURN_CODE(code);
+
+        for (std::size_t t = 0u; t < opts.numTypes; t++) {
+            const std::string type(typeName(t));
+            std::ostringstream typePath;
+            typePath << opts.dir << "/" << t;
+            remove(typePath.str().c_str());
+
+            DatabasePtr typeDb(nullptr, nullptr);
+            code = Databases_openDatabase(typeDb, typePath.str().c_str(), false);
+            TE_CHECKBREAK_CODE(code);
+            code = typeDb->execute("CREATE TABLE mosaicdata (id INTEGER PRIMARYKEY, type TEXT, path TEXT, "
+                                   "minlat REAL, minlon REAL, maxlat REAL, maxlon REAL, "
+                                   "ullat REAL, ullon REAL, urlat REAL, urlon REAL, lrlat REAL, lrlon REAL, lllat REAL, lllon REAL, "
+                                   "mingsd REAL, maxgsd REAL, srid INTEGER, precision INTEGER, width INTEGER, height INTEGER, coverageblob BLOB)", nullptr, 0u);
+            TE_CHECKBREAK_CODE(code);
+
+            StatementPtr insert(nullptr, nullptr);
+            code = typeDb->compileStatement(insert, "INSERT INTO mosaicdata (id, type, path, minlat, minlon, maxlat, maxlon, "
+                                                    "ullat, ullon, urlat, urlon, lrlat, lrlon, lllat, lllon, "
+                                                    "mingsd, maxgsd, srid, precision, width, height) "
+                                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+            TE_CHECKBREAK_CODE(code);
+
+            double minLat = NAN;
+            double minLon = NAN;
+            double maxLat = NAN;
+            double maxLon = NAN;
+            double minGsd = NAN;
+            double maxGsd = NAN;
+
+            code = typeDb->beginTransaction();
+            TE_CHECKBREAK_CODE(code);
+            std::size_t typeFrames = 0u;
+            for (std::size_t i = t; i < opts.numFrames; i += opts.numTypes) {
+                const double frameMinLat = originLat + static_cast<double>(i / columns) * cellSize;
+                const double frameMinLon = originLon + static_cast<double>(i % columns) * cellSize;
+                const double frameMaxLat = frameMinLat + cellSize;
+                const double frameMaxLon = frameMinLon + cellSize;
+                const double frameMaxGsd = GSD_LEVELS[levelDist(rng)] * (1.0 + jitterDist(rng));
+                const double frameMinGsd = frameMaxGsd * 16.0;
+
+                std::ostringstream path;
+                path << "/imagery/" << type << "/";
+                path.width(2);
+                path.fill('0');
+                path << (typeFrames / framesPerDir) % 100u;
+                path.width(0);
+                path << "/frame" << i << ".ntf";
+
+                std::size_t idx = 1u;
+                code = insert->clearBindings();
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindInt(idx++, static_cast<int32_t>(i));
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindString(idx++, type.c_str());
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindString(idx++, path.str().c_str());
+                TE_CHECKBREAK_CODE(code);
+                const double values[] =
+                {
+                    frameMinLat, frameMinLon, frameMaxLat, frameMaxLon,
+                    frameMaxLat, frameMinLon, frameMaxLat, frameMaxLon,
+                    frameMinLat, frameMaxLon, frameMinLat, frameMinLon,
+                    frameMinGsd, frameMaxGsd,
+                };
+                for (std::size_t v = 0u; v < sizeof(values) / sizeof(values[0]); v++) {
+                    code = insert->bindDouble(idx++, values[v]);
+                    TE_CHECKBREAK_CODE(code);
+                }
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindInt(idx++, 4326);
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindInt(idx++, 1);
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindInt(idx++, 1024);
+                TE_CHECKBREAK_CODE(code);
+                code = insert->bindInt(idx++, 1024);
+                TE_CHECKBREAK_CODE(code);
+                code = insert->execute();
+                TE_CHECKBREAK_CODE(code);
+
+                if (isnan(minLat) || frameMinLat < minLat) minLat = frameMinLat;
+                if (isnan(minLon) || frameMinLon < minLon) minLon = frameMinLon;
+                if (isnan(maxLat) || frameMaxLat > maxLat) maxLat = frameMaxLat;
+                if (isnan(maxLon) || frameMaxLon > maxLon) maxLon = frameMaxLon;
+                if (isnan(minGsd) || frameMinGsd > minGsd) minGsd = frameMinGsd;
+                if (isnan(maxGsd) || frameMaxGsd < maxGsd) maxGsd = frameMaxGsd;
+                typeFrames++;
+            }
+            if (code == TE_Ok)
+                typeDb->setTransactionSuccessful();
+            typeDb->endTransaction();
+            TE_CHECKBREAK_CODE(code);
+            insert.reset();
+
+            StatementPtr coverage(nullptr, nullptr);
+            code = index->compileStatement(coverage, "INSERT INTO coverage (type, minlat, minlon, maxlat, maxlon, mingsd, maxgsd, path) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindString(1u, type.c_str());
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(2u, minLat);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(3u, minLon);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(4u, maxLat);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(5u, maxLon);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(6u, minGsd);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindDouble(7u, maxGsd);
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->bindString(8u, typePath.str().c_str());
+            TE_CHECKBREAK_CODE(code);
+            code = coverage->execute();
+            TE_CHECKBREAK_CODE(code);
+        }
+
+        return code;
+    }
+
+    TAKErr createScenarios(std::vector<Scenario> &value, const Options &opts) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+
+        const std::size_t columns = static_cast<std::size_t>(ceil(sqrt(static_cast<double>(opts.numFrames))));
+        const double extent = static_cast<double>(columns) * 0.01;
+        // a tenth of the extent on each side, about 1% of the frames
+        const double roiMinLat = 34.0 + extent * 0.45;
+        const double roiMinLon = -118.5 + extent * 0.45;
+        const double roiMaxLat = roiMinLat + extent * 0.1;
+        const double roiMaxLon = roiMinLon + extent * 0.1;
+
+        std::shared_ptr<MosaicDatabase2::FrameFilter> gsd;
+        code = MosaicDatabase2_createGsdFilter(gsd, MosaicDatabase2::QueryParameters::MaximumGsd, 1.0, 1.02);
+        TE_CHECKRETURN_CODE(code);
+
+        std::shared_ptr<MosaicDatabase2::FrameFilter> type;
+        {
+            std::vector<String> types;
+            types.push_back(typeName(0u).c_str());
+            STLVectorAdapter<String> typesAdapter(types);
+            code = MosaicDatabase2_createTypeFilter(type, typesAdapter, false);
+            TE_CHECKRETURN_CODE(code);
+        }
+
+        std::shared_ptr<MosaicDatabase2::FrameFilter> path;
+        {
+            std::ostringstream prefix;
+            prefix << "/imagery/" << typeName(opts.numTypes > 1u ? 1u : 0u) << "/07/";
+            code = MosaicDatabase2_createPathPrefixFilter(path, prefix.str().c_str());
+            TE_CHECKRETURN_CODE(code);
+        }
+
+        std::shared_ptr<MosaicDatabase2::FrameFilter> bounds;
+        code = MosaicDatabase2_createBoundsFilter(bounds, roiMinLat, roiMinLon, roiMaxLat, roiMaxLon);
+        TE_CHECKRETURN_CODE(code);
+
+        std::shared_ptr<MosaicDatabase2::FrameFilter> coarse;
+        code = MosaicDatabase2_createGsdFilter(coarse, MosaicDatabase2::QueryParameters::MaximumGsd, 30.0, NAN);
+        TE_CHECKRETURN_CODE(code);
+
+        Scenario scenario;
+
+        scenario.name = "gsd";
+        scenario.filters.assign(1u, gsd);
+        value.push_back(scenario);
+
+        scenario.name = "type";
+        scenario.filters.assign(1u, type);
+        value.push_back(scenario);
+
+        scenario.name = "path";
+        scenario.filters.assign(1u, path);
+        value.push_back(scenario);
+
+        scenario.name = "bounds";
+        scenario.filters.assign(1u, bounds);
+        value.push_back(scenario);
+
+        scenario.name = "combined";
+        scenario.filters.clear();
+        scenario.filters.push_back(bounds);
+        scenario.filters.push_back(coarse);
+        scenario.filters.push_back(type);
+        value.push_back(scenario);
+
+        return code;
+    }
+
+    TAKErr run(Result *value, MosaicDatabase2 &database, const Scenario &scenario, const bool native, const std::size_t repeat) NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+
+        CountingDatabase counting(database, native);
+
+        MosaicDatabase2::QueryParameters params;
+        params.filters = std::unique_ptr<Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>>, void(*)(const Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>> *)>(
+            new STLVectorAdapter<std::shared_ptr<MosaicDatabase2::FrameFilter>>(),
+            Memory_deleter_const<Collection<std::shared_ptr<MosaicDatabase2::FrameFilter>>, STLVectorAdapter<std::shared_ptr<MosaicDatabase2::FrameFilter>>>);
+        for (std::size_t i = 0u; i < scenario.filters.size(); i++) {
+            code = params.filters->add(scenario.filters[i]);
+            TE_CHECKRETURN_CODE(code);
+        }
+
+        std::size_t returned = 0u;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0u; r < repeat; r++) {
+            MosaicDatabase2::CursorPtr result(nullptr, nullptr);
+            code = counting.query(result, params);
+            TE_CHECKBREAK_CODE(code);
+
+            returned = 0u;
+            do {
+                code = result->moveToNext();
+                TE_CHECKBREAK_CODE(code);
+                // read the columns a renderer would, so that both runs do
+                // the same work per returned row
+                MosaicDatabase2::FramePtr_const frame(nullptr, nullptr);
+                code = MosaicDatabase2::Frame::createFrame(frame, *result);
+                TE_CHECKBREAK_CODE(code);
+                returned++;
+            } while (true);
+            if (code == TE_Done)
+                code = TE_Ok;
+            TE_CHECKBREAK_CODE(code);
+        }
+        TE_CHECKRETURN_CODE(code);
+        const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+        value->returned = returned;
+        value->produced = counting.produced / repeat;
+        value->meanMillis = std::chrono::duration<double, std::milli>(elapsed).count() / static_cast<double>(repeat);
+        return code;
+    }
+
+    std::string typeName(const std::size_t type) NOTHROWS
+    {
+        std::ostringstream name;
+        name << "type" << type;
+        return name.str();
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -o <dir>     mosaic database directory (default mosaicbench.atak3)\n");
+        printf("    -n <count>   number of frames (default 100000)\n");
+        printf("    -T <count>   number of imagery types (default 4)\n");
+        printf("    -r <count>   runs of each query (default 5)\n");
+        printf("    -s <seed>    dataset random seed (default 1)\n");
+        printf("    -k           keep and query an existing database in <dir>\n");
+        printf("    -h           show this help\n");
+    }
+}
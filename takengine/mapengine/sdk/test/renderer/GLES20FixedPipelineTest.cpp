@@ -0,0 +1,302 @@
+// Tests for renderer/GLES20FixedPipeline.
+//
+// Checks that the draw paths issue no GL state queries, that uniform
+// uploads and program binds that would not change GL state are skipped,
+// and that the program bound by the caller is bound again after each draw.
+// GL is provided by the recording backend (test/gl/RecordingGL), so no GPU
+// is required.
+//
+// Exits with a non-zero status on failure.
+
+#include <cmath>
+#include <cstdio>
+
+#include "renderer/GL.h"
+#include "renderer/GLES20FixedPipeline.h"
+
+#include "RecordingGL.h"
+
+using namespace atakmap::renderer;
+using namespace TAK::Engine::Tests;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+namespace
+{
+    int failures = 0;
+
+    // program names that the caller binds; the recording backend does not
+    // validate them, and they are well above any name it allocates here
+    const unsigned int CALLER_PROGRAM = 1000u;
+    const unsigned int OTHER_CALLER_PROGRAM = 1001u;
+
+    enum DrawPath
+    {
+        DP_Lines,
+        DP_LinesElements,
+        DP_ColorArray,
+        DP_Texture,
+        DP_TextureElements,
+        DP_Points,
+        DP_PointsElements,
+        DP_TexturedPoints,
+        NUM_DRAW_PATHS,
+    };
+
+    const char *DRAW_PATH_NAMES[NUM_DRAW_PATHS] =
+    {
+        "lines",
+        "lines (elements)",
+        "color array",
+        "texture",
+        "texture (elements)",
+        "points",
+        "points (elements)",
+        "textured points",
+    };
+
+    void draw(const DrawPath path) NOTHROWS;
+    GLint getCurrentProgram() NOTHROWS;
+
+    void testFirstMatrixUploadNotSkipped() NOTHROWS;
+    void testNoQueriesInDrawPaths() NOTHROWS;
+    void testRedundantUniformUploadsSkipped() NOTHROWS;
+    void testRedundantProgramBindsSkipped() NOTHROWS;
+    void testCallerProgramRestored() NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+    pipeline->glMatrixMode(GLES20FixedPipeline::MM_GL_PROJECTION);
+    pipeline->glOrthof(0.0f, 512.0f, 0.0f, 512.0f, 1.0f, -1.0f);
+    pipeline->glMatrixMode(GLES20FixedPipeline::MM_GL_MODELVIEW);
+    pipeline->glLoadIdentity();
+
+    // must run first, while none of the programs have been created
+    testFirstMatrixUploadNotSkipped();
+    testNoQueriesInDrawPaths();
+    testRedundantUniformUploadsSkipped();
+    testRedundantProgramBindsSkipped();
+    testCallerProgramRestored();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+namespace
+{
+    void testFirstMatrixUploadNotSkipped() NOTHROWS
+    {
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+
+        // the cached values start out as NaN. A model-view of canonical NaN
+        // is bitwise equal to them, but must still be uploaded on the first
+        // draw with the program.
+        float nan[16];
+        for (std::size_t i = 0u; i < 16u; i++)
+            nan[i] = NAN;
+        pipeline->glPushMatrix();
+        pipeline->glLoadMatrixf(nan);
+
+        RecordingGL_reset();
+        draw(DP_Lines);
+        // projection and model-view
+        CHECK(RecordingGL_getCallCount("glUniformMatrix4fv") == 2u);
+
+        pipeline->glPopMatrix();
+    }
+
+    void testNoQueriesInDrawPaths() NOTHROWS
+    {
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+        pipeline->glLineWidth(4.0f);
+
+        // the first pass creates any programs not yet used, resolving their
+        // locations; the second draws with the cached programs
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 0; i < NUM_DRAW_PATHS; i++) {
+                RecordingGL_reset();
+                draw(static_cast<DrawPath>(i));
+
+                GLCounters counters;
+                RecordingGL_getCounters(&counters);
+                if (counters.drawCalls != 1u)
+                    fprintf(stderr, "%s: %u draw calls\n", DRAW_PATH_NAMES[i], (unsigned)counters.drawCalls);
+                CHECK(counters.drawCalls == 1u);
+                CHECK(RecordingGL_getCallCount("glGetIntegerv") == 0u);
+                CHECK(RecordingGL_getCallCount("glGetFloatv") == 0u);
+                CHECK(RecordingGL_getCallCount("glGetBooleanv") == 0u);
+                if (pass) {
+                    CHECK(RecordingGL_getCallCount("glGetUniformLocation") == 0u);
+                    CHECK(RecordingGL_getCallCount("glGetAttribLocation") == 0u);
+                    CHECK(RecordingGL_getCallCount("glCreateProgram") == 0u);
+                }
+            }
+        }
+
+        pipeline->glLineWidth(1.0f);
+    }
+
+    void testRedundantUniformUploadsSkipped() NOTHROWS
+    {
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+
+        for (int i = 0; i < NUM_DRAW_PATHS; i++) {
+            const DrawPath path = static_cast<DrawPath>(i);
+            draw(path);
+
+            // nothing changed since the last draw with the program
+            RecordingGL_reset();
+            draw(path);
+            CHECK(RecordingGL_getCallCount("glUniformMatrix4fv") == 0u);
+            CHECK(RecordingGL_getCallCount("glUniform4f") == 0u);
+            CHECK(RecordingGL_getCallCount("glUniform1f") == 0u);
+            CHECK(RecordingGL_getCallCount("glUniform1i") == 0u);
+        }
+
+        // only the changed uniform is uploaded
+        draw(DP_Lines);
+        pipeline->glPushMatrix();
+        pipeline->glTranslatef(16.0f, 16.0f, 0.0f);
+        RecordingGL_reset();
+        draw(DP_Lines);
+        CHECK(RecordingGL_getCallCount("glUniformMatrix4fv") == 1u);
+        CHECK(RecordingGL_getCallCount("glUniform4f") == 0u);
+        pipeline->glPopMatrix();
+
+        // back to the previous model-view
+        RecordingGL_reset();
+        draw(DP_Lines);
+        CHECK(RecordingGL_getCallCount("glUniformMatrix4fv") == 1u);
+
+        pipeline->glColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+        RecordingGL_reset();
+        draw(DP_Lines);
+        CHECK(RecordingGL_getCallCount("glUniformMatrix4fv") == 0u);
+        CHECK(RecordingGL_getCallCount("glUniform4f") == 1u);
+        pipeline->glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+        pipeline->glPointSize(8.0f);
+        RecordingGL_reset();
+        draw(DP_Points);
+        CHECK(RecordingGL_getCallCount("glUniform1f") == 1u);
+        pipeline->glPointSize(1.0f);
+    }
+
+    void testRedundantProgramBindsSkipped() NOTHROWS
+    {
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+
+        GLCounters counters;
+
+        pipeline->glUseProgram(CALLER_PROGRAM);
+        RecordingGL_reset();
+        pipeline->glUseProgram(CALLER_PROGRAM);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.programBinds == 0u);
+
+        pipeline->glUseProgram(OTHER_CALLER_PROGRAM);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.programBinds == 1u);
+
+        // a draw binds its own program, then the caller's
+        for (int i = 0; i < NUM_DRAW_PATHS; i++) {
+            RecordingGL_reset();
+            draw(static_cast<DrawPath>(i));
+            RecordingGL_getCounters(&counters);
+            CHECK(counters.programBinds == 2u);
+        }
+
+        pipeline->glUseProgram(0u);
+    }
+
+    void testCallerProgramRestored() NOTHROWS
+    {
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+
+        const unsigned int programs[3] = { 0u, CALLER_PROGRAM, OTHER_CALLER_PROGRAM };
+        for (std::size_t p = 0u; p < 3u; p++) {
+            pipeline->glUseProgram(programs[p]);
+            for (int i = 0; i < NUM_DRAW_PATHS; i++) {
+                draw(static_cast<DrawPath>(i));
+                const GLint current = getCurrentProgram();
+                if (current != static_cast<GLint>(programs[p]))
+                    fprintf(stderr, "%s: program %d bound after the draw, expected %u\n", DRAW_PATH_NAMES[i], current, programs[p]);
+                CHECK(current == static_cast<GLint>(programs[p]));
+            }
+        }
+
+        pipeline->glUseProgram(0u);
+    }
+
+    void draw(const DrawPath path) NOTHROWS
+    {
+        static const float vertices[8] = { 0.0f, 0.0f, 256.0f, 0.0f, 256.0f, 256.0f, 0.0f, 256.0f };
+        static const float texCoords[8] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+        static const float colors[16] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+        static const unsigned short indices[6] = { 0u, 1u, 2u, 0u, 2u, 3u };
+
+        GLES20FixedPipeline *pipeline = GLES20FixedPipeline::getInstance();
+        pipeline->glEnableClientState(GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
+        pipeline->glVertexPointer(2, GL_FLOAT, 0, vertices);
+        switch (path) {
+            case DP_ColorArray :
+                pipeline->glEnableClientState(GLES20FixedPipeline::CS_GL_COLOR_ARRAY);
+                pipeline->glColorPointer(4, GL_FLOAT, 0, colors);
+                break;
+            case DP_Texture :
+            case DP_TextureElements :
+            case DP_TexturedPoints :
+                pipeline->glEnableClientState(GLES20FixedPipeline::CS_GL_TEXTURE_COORD_ARRAY);
+                pipeline->glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+                break;
+            default :
+                break;
+        }
+
+        switch (path) {
+            case DP_Lines :
+                pipeline->glDrawArrays(GL_LINE_STRIP, 0, 4);
+                break;
+            case DP_LinesElements :
+                pipeline->glDrawElements(GL_LINES, 6, GL_UNSIGNED_SHORT, indices);
+                break;
+            case DP_ColorArray :
+            case DP_Texture :
+                pipeline->glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+                break;
+            case DP_TextureElements :
+                pipeline->glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
+                break;
+            case DP_Points :
+            case DP_TexturedPoints :
+                pipeline->glDrawArrays(GL_POINTS, 0, 4);
+                break;
+            case DP_PointsElements :
+                pipeline->glDrawElements(GL_POINTS, 6, GL_UNSIGNED_SHORT, indices);
+                break;
+            default :
+                break;
+        }
+
+        pipeline->glDisableClientState(GLES20FixedPipeline::CS_GL_VERTEX_ARRAY);
+        pipeline->glDisableClientState(GLES20FixedPipeline::CS_GL_COLOR_ARRAY);
+        pipeline->glDisableClientState(GLES20FixedPipeline::CS_GL_TEXTURE_COORD_ARRAY);
+    }
+
+    GLint getCurrentProgram() NOTHROWS
+    {
+        GLint program = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+        return program;
+    }
+}
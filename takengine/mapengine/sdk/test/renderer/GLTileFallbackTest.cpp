@@ -0,0 +1,492 @@
+// Tests for the tile-matrix loading fallback, GLTile::drawFallback and
+// GLResidentTileIndex.
+//
+// Replays sequences of tile loads, failed loads and unloads across the
+// levels of a synthetic Web Mercator tile matrix. For each sequence the
+// deepest level is drawn with its tiles unavailable, and the resident index
+// lookups and GL draw calls issued by the fallbacks are counted. Each tile
+// that is not loaded costs one lookup per level walked up to its nearest
+// ancestor with a texture, resident or cached, and draws that ancestor
+// once; with no ancestor it costs one lookup per level and draws nothing.
+// The time per fallback is reported.
+//
+// GL is provided by the recording backend (test/gl/RecordingGL), so no GPU
+// is required. Tiles are blank bitmaps loaded on a single loader thread.
+//
+// Exits with a non-zero status on failure.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "core/AtakMapController.h"
+#include "core/AtakMapView.h"
+#include "core/GeoPoint.h"
+#include "feature/Envelope2.h"
+#include "port/Collection.h"
+#include "port/STLVectorAdapter.h"
+#include "raster/tilematrix/TileMatrix.h"
+#include "renderer/AsyncBitmapLoader2.h"
+#include "renderer/Bitmap2.h"
+#include "renderer/GLTextureCache2.h"
+#include "renderer/core/GLMapView2.h"
+#include "renderer/raster/tilematrix/GLTiledLayerCore.h"
+#include "renderer/raster/tilematrix/GLZoomLevel.h"
+#include "util/FutureTask.h"
+#include "util/Memory.h"
+
+#include "HeadlessRenderContext.h"
+#include "RecordingGL.h"
+
+using namespace TAK::Engine::Feature;
+using namespace TAK::Engine::Port;
+using namespace TAK::Engine::Raster::TileMatrix;
+using namespace TAK::Engine::Renderer;
+using namespace TAK::Engine::Renderer::Core;
+using namespace TAK::Engine::Renderer::Raster::TileMatrix;
+using namespace TAK::Engine::Tests;
+using namespace TAK::Engine::Util;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+namespace
+{
+    int failures = 0;
+
+    // half the width of the Web Mercator plane, in meters
+    const double MERCATOR_EXTENT = 20037508.342789244;
+    const int TILE_SIZE = 256;
+    // the level drawn; its ancestors are levels 0 through 3
+    const int DRAW_ZOOM = 4;
+    const std::size_t SURFACE_SIZE = 512u;
+    const std::size_t COST_FRAMES = 200u;
+
+    /**
+     * A quadtree over the full Web Mercator extent. Tiles on available
+     * levels are blank bitmaps; tiles on unavailable levels fail to load.
+     */
+    class SyntheticTileMatrix : public TileMatrix
+    {
+    public :
+        SyntheticTileMatrix(const int maxZoom) NOTHROWS;
+        ~SyntheticTileMatrix() NOTHROWS override;
+    public :
+        const char *getName() const NOTHROWS override;
+        int getSRID() const NOTHROWS override;
+        TAKErr getZoomLevel(Collection<ZoomLevel> &value) const NOTHROWS override;
+        double getOriginX() const NOTHROWS override;
+        double getOriginY() const NOTHROWS override;
+        TAKErr getTile(BitmapPtr &result, const std::size_t zoom, const std::size_t x, const std::size_t y) NOTHROWS override;
+        TAKErr getTileData(std::unique_ptr<const uint8_t, void(*)(const uint8_t *)> &value, std::size_t *len,
+                           const std::size_t zoom, const std::size_t x, const std::size_t y) NOTHROWS override;
+        TAKErr getBounds(Envelope2 *value) const NOTHROWS override;
+    public :
+        void setAvailable(const int zoom, const bool available) NOTHROWS;
+    private :
+        std::vector<ZoomLevel> levels;
+        // bit per level
+        std::atomic<unsigned> unavailable;
+    };
+
+    struct FrameCounts
+    {
+        std::size_t lookups;
+        std::size_t drawCalls;
+        double nanos;
+    };
+
+    /**
+     * A tile-matrix layer with a renderer for each level, 0 through
+     * DRAW_ZOOM, and a camera fixed at the resolution of DRAW_ZOOM. The
+     * caller's thread is the render thread.
+     */
+    class Simulation
+    {
+    public :
+        Simulation() NOTHROWS;
+        ~Simulation() NOTHROWS;
+    public :
+        bool isValid() const NOTHROWS;
+        void setAvailable(const int zoom, const bool available) NOTHROWS;
+        /** draws the level once, counting the lookups and draw calls issued */
+        void draw(FrameCounts *value, const int zoom) NOTHROWS;
+        /** draws the level, waits for the loads it requested, then draws it again to take up the results */
+        void load(const int zoom) NOTHROWS;
+        /** releases the level's tiles into the texture cache */
+        void release(const int zoom) NOTHROWS;
+        void clearCache() NOTHROWS;
+        /** marks every tile as out of date, so that it is loaded again on its next draw */
+        void refresh() NOTHROWS;
+        std::size_t getResidentCount() const NOTHROWS;
+        /**
+         * Loads the level, returning the draw calls issued to draw it, then
+         * releases it and clears the texture cache.
+         */
+        std::size_t countTiles(const int zoom) NOTHROWS;
+    private :
+        void awaitLoads() NOTHROWS;
+    private :
+        HeadlessRenderSurface surface;
+        HeadlessRenderContext context;
+        atakmap::core::AtakMapView view;
+        GLMapView2 glview;
+        bool started;
+        std::shared_ptr<SyntheticTileMatrix> matrix;
+        GLTextureCache2 textureCache;
+        AsyncBitmapLoader2 bitmapLoader;
+        GLTiledLayerCore core;
+        std::vector<std::unique_ptr<GLZoomLevel>> levels;
+    };
+
+    std::shared_ptr<Bitmap2> sentinel(void *opaque);
+
+    void testResolvedTilesSkipFallback() NOTHROWS;
+    void testFallbackToNearestAncestor() NOTHROWS;
+    void testReplayLoadUnload() NOTHROWS;
+    void testFallbackCost() NOTHROWS;
+    void measureFallbacks(Simulation &sim, const std::size_t tiles, const int ancestor, const char *ancestorState) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    testResolvedTilesSkipFallback();
+    testFallbackToNearestAncestor();
+    testReplayLoadUnload();
+    testFallbackCost();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+namespace
+{
+    void testResolvedTilesSkipFallback() NOTHROWS
+    {
+        Simulation sim;
+        CHECK(sim.isValid());
+        if (!sim.isValid())
+            return;
+
+        sim.load(DRAW_ZOOM);
+        FrameCounts frame;
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls > 0u);
+        CHECK(frame.lookups == 0u);
+        CHECK(sim.getResidentCount() == frame.drawCalls);
+    }
+
+    void testFallbackToNearestAncestor() NOTHROWS
+    {
+        Simulation sim;
+        CHECK(sim.isValid());
+        if (!sim.isValid())
+            return;
+        const std::size_t tiles = sim.countTiles(DRAW_ZOOM);
+        CHECK(tiles > 0u);
+
+        // every ancestor level is resident; only the parent is looked up
+        for (int z = 0; z < DRAW_ZOOM; z++)
+            sim.load(z);
+        sim.setAvailable(DRAW_ZOOM, false);
+        sim.load(DRAW_ZOOM);
+
+        FrameCounts frame;
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == tiles);
+    }
+
+    void testReplayLoadUnload() NOTHROWS
+    {
+        Simulation sim;
+        CHECK(sim.isValid());
+        if (!sim.isValid())
+            return;
+        const std::size_t tiles = sim.countTiles(DRAW_ZOOM);
+        CHECK(tiles > 0u);
+
+        FrameCounts frame;
+
+        // levels 2 and 3 resident, the drawn level fails to load
+        sim.load(2);
+        sim.load(3);
+        sim.setAvailable(DRAW_ZOOM, false);
+        sim.load(DRAW_ZOOM);
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == tiles);
+
+        // level 3 unloaded to the cache; it is missed in the index and
+        // found in the cache
+        sim.release(3);
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == tiles);
+
+        // level 3 evicted; level 2 is still resident
+        sim.clearCache();
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == 2u * tiles);
+
+        // level 2 unloaded to the cache
+        sim.release(2);
+        CHECK(sim.getResidentCount() == 0u);
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == 2u * tiles);
+
+        // nothing loaded; every level is walked and nothing is drawn
+        sim.clearCache();
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == 0u);
+        CHECK(frame.lookups == static_cast<std::size_t>(DRAW_ZOOM) * tiles);
+
+        // level 3 reloads
+        sim.load(3);
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == tiles);
+
+        // the drawn level becomes available and replaces its fallbacks
+        sim.setAvailable(DRAW_ZOOM, true);
+        sim.refresh();
+        sim.load(DRAW_ZOOM);
+        sim.draw(&frame, DRAW_ZOOM);
+        CHECK(frame.drawCalls == tiles);
+        CHECK(frame.lookups == 0u);
+    }
+
+    void testFallbackCost() NOTHROWS
+    {
+        Simulation sim;
+        CHECK(sim.isValid());
+        if (!sim.isValid())
+            return;
+        const std::size_t tiles = sim.countTiles(DRAW_ZOOM);
+        CHECK(tiles > 0u);
+
+        // the nearest ancestor is three levels up, resident and then cached
+        const int ancestor = DRAW_ZOOM - 3;
+        sim.setAvailable(DRAW_ZOOM, false);
+        sim.load(ancestor);
+        sim.load(DRAW_ZOOM);
+        measureFallbacks(sim, tiles, ancestor, "resident");
+        sim.release(ancestor);
+        measureFallbacks(sim, tiles, ancestor, "cached");
+    }
+
+    void measureFallbacks(Simulation &sim, const std::size_t tiles, const int ancestor, const char *ancestorState) NOTHROWS
+    {
+        const std::size_t depth = static_cast<std::size_t>(DRAW_ZOOM - ancestor);
+        std::size_t lookups = 0u;
+        std::size_t drawCalls = 0u;
+        double nanos = 0.0;
+        for (std::size_t f = 0u; f < COST_FRAMES; f++) {
+            FrameCounts frame;
+            sim.draw(&frame, DRAW_ZOOM);
+            lookups += frame.lookups;
+            drawCalls += frame.drawCalls;
+            nanos += frame.nanos;
+        }
+        const std::size_t fallbacks = tiles * COST_FRAMES;
+        CHECK(drawCalls == fallbacks);
+        CHECK(lookups == depth * fallbacks);
+        printf("fallback %u levels up to a %s ancestor: %.2f lookups, %.0f ns per tile\n", (unsigned)depth, ancestorState,
+               static_cast<double>(lookups) / static_cast<double>(fallbacks), nanos / static_cast<double>(fallbacks));
+    }
+
+    SyntheticTileMatrix::SyntheticTileMatrix(const int maxZoom) NOTHROWS :
+        unavailable(0u)
+    {
+        for (int i = 0; i <= maxZoom; i++) {
+            ZoomLevel level;
+            level.level = i;
+            level.pixelSizeX = (2.0 * MERCATOR_EXTENT) / (static_cast<double>(1 << i) * TILE_SIZE);
+            level.pixelSizeY = level.pixelSizeX;
+            level.resolution = level.pixelSizeX;
+            level.tileWidth = TILE_SIZE;
+            level.tileHeight = TILE_SIZE;
+            levels.push_back(level);
+        }
+    }
+    SyntheticTileMatrix::~SyntheticTileMatrix() NOTHROWS
+    {}
+    const char *SyntheticTileMatrix::getName() const NOTHROWS
+    {
+        return "GLTileFallbackTest";
+    }
+    int SyntheticTileMatrix::getSRID() const NOTHROWS
+    {
+        return 3857;
+    }
+    TAKErr SyntheticTileMatrix::getZoomLevel(Collection<ZoomLevel> &value) const NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        for (auto it = levels.begin(); it != levels.end(); it++) {
+            code = value.add(*it);
+            TE_CHECKBREAK_CODE(code);
+        }
+        return code;
+    }
+    double SyntheticTileMatrix::getOriginX() const NOTHROWS
+    {
+        return -MERCATOR_EXTENT;
+    }
+    double SyntheticTileMatrix::getOriginY() const NOTHROWS
+    {
+        return MERCATOR_EXTENT;
+    }
+    TAKErr SyntheticTileMatrix::getTile(BitmapPtr &result, const std::size_t zoom, const std::size_t, const std::size_t) NOTHROWS
+    {
+        if (zoom >= levels.size())
+            return TE_InvalidArg;
+        if (unavailable & (1u << zoom))
+            return TE_IO;
+        result = BitmapPtr(new Bitmap2(TILE_SIZE, TILE_SIZE, Bitmap2::RGB565), Memory_deleter_const<Bitmap2>);
+        return TE_Ok;
+    }
+    TAKErr SyntheticTileMatrix::getTileData(std::unique_ptr<const uint8_t, void(*)(const uint8_t *)> &, std::size_t *,
+                                            const std::size_t, const std::size_t, const std::size_t) NOTHROWS
+    {
+        return TE_Unsupported;
+    }
+    TAKErr SyntheticTileMatrix::getBounds(Envelope2 *value) const NOTHROWS
+    {
+        if (!value)
+            return TE_InvalidArg;
+        *value = Envelope2(-MERCATOR_EXTENT, -MERCATOR_EXTENT, MERCATOR_EXTENT, MERCATOR_EXTENT);
+        return TE_Ok;
+    }
+    void SyntheticTileMatrix::setAvailable(const int zoom, const bool available) NOTHROWS
+    {
+        if (available)
+            unavailable &= ~(1u << zoom);
+        else
+            unavailable |= (1u << zoom);
+    }
+
+    Simulation::Simulation() NOTHROWS :
+        surface(SURFACE_SIZE, SURFACE_SIZE, 96.0),
+        context(surface),
+        view(static_cast<float>(SURFACE_SIZE), static_cast<float>(SURFACE_SIZE), 96.0),
+        glview(context, view, 0, 0, static_cast<int>(SURFACE_SIZE), static_cast<int>(SURFACE_SIZE)),
+        started(false),
+        matrix(new SyntheticTileMatrix(DRAW_ZOOM)),
+        textureCache(16u * 1024u * 1024u),
+        // one loader thread, so that loads complete in the order requested
+        bitmapLoader(1u),
+        core(matrix, "GLTileFallbackTest://synthetic")
+    {
+        started = (glview.start() == TE_Ok);
+        core.textureCache = &textureCache;
+        core.bitmapLoader = &bitmapLoader;
+
+        std::vector<TileMatrix::ZoomLevel> lods;
+        STLVectorAdapter<TileMatrix::ZoomLevel> lodsAdapter(lods);
+        matrix->getZoomLevel(lodsAdapter);
+        GLZoomLevel *previous = nullptr;
+        for (std::size_t i = 0u; i < lods.size(); i++) {
+            levels.push_back(std::unique_ptr<GLZoomLevel>(new GLZoomLevel(previous, &core, lods[i])));
+            previous = levels.back().get();
+        }
+
+        // away from the antimeridian, so that each mesh is drawn once
+        atakmap::core::GeoPoint center(34.05, -118.25);
+        view.getController()->panZoomRotateTo(&center, view.mapResolutionAsMapScale(lods[DRAW_ZOOM].resolution), 0.0, false);
+    }
+    Simulation::~Simulation() NOTHROWS
+    {
+        for (std::size_t i = 0u; i < levels.size(); i++)
+            levels[i]->release();
+        awaitLoads();
+        levels.clear();
+        if (started)
+            glview.stop();
+    }
+    bool Simulation::isValid() const NOTHROWS
+    {
+        return started;
+    }
+    void Simulation::setAvailable(const int zoom, const bool available) NOTHROWS
+    {
+        matrix->setAvailable(zoom, available);
+    }
+    void Simulation::draw(FrameCounts *value, const int zoom) NOTHROWS
+    {
+        context.pump();
+        glview.render();
+
+        GLCounters before;
+        RecordingGL_getCounters(&before);
+        const std::size_t lookups = core.residentTiles.getLookupCount();
+        const auto start = std::chrono::high_resolution_clock::now();
+        levels[zoom]->draw(glview, GLMapView2::Surface);
+        const auto end = std::chrono::high_resolution_clock::now();
+        GLCounters after;
+        RecordingGL_getCounters(&after);
+
+        if (!value)
+            return;
+        value->lookups = core.residentTiles.getLookupCount() - lookups;
+        value->drawCalls = after.drawCalls - before.drawCalls;
+        value->nanos = std::chrono::duration<double, std::nano>(end - start).count();
+    }
+    void Simulation::load(const int zoom) NOTHROWS
+    {
+        draw(nullptr, zoom);
+        awaitLoads();
+        draw(nullptr, zoom);
+    }
+    void Simulation::release(const int zoom) NOTHROWS
+    {
+        levels[zoom]->release();
+    }
+    void Simulation::clearCache() NOTHROWS
+    {
+        textureCache.clear();
+    }
+    void Simulation::refresh() NOTHROWS
+    {
+        core.requestRefresh();
+    }
+    std::size_t Simulation::getResidentCount() const NOTHROWS
+    {
+        return core.residentTiles.size();
+    }
+    std::size_t Simulation::countTiles(const int zoom) NOTHROWS
+    {
+        load(zoom);
+        FrameCounts frame;
+        draw(&frame, zoom);
+        release(zoom);
+        clearCache();
+        return frame.drawCalls;
+    }
+    void Simulation::awaitLoads() NOTHROWS
+    {
+        // the loader runs the queue in order on its one thread, so the
+        // sentinel completes after every load requested before it
+        AsyncBitmapLoader2::Task task(new atakmap::util::FutureTask<std::shared_ptr<Bitmap2>>(sentinel, nullptr));
+        if (bitmapLoader.loadBitmapTask(task, "REMOTE") != TE_Ok)
+            return;
+        try {
+            task->getFuture().get();
+        } catch (...) {}
+    }
+
+    std::shared_ptr<Bitmap2> sentinel(void *)
+    {
+        return std::shared_ptr<Bitmap2>();
+    }
+}
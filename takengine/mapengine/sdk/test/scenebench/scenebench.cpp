@@ -0,0 +1,285 @@
+// MapSceneModel2 benchmark.
+//
+// Times scene model construction, set() and copies, and forward and inverse
+// over a grid of points covering the viewport, for the planar (4326) and
+// globe (4978) projections and for each camera mode.  Points are mapped one
+// at a time and through the bulk overloads; the largest difference between
+// the two is reported, and the benchmark exits non-zero if it exceeds
+// TOLERANCE or if the two disagree on which points fail.
+//
+// Each measurement is the best of the repeated runs, to reduce the effect of
+// scheduling noise.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "core/GeoPoint2.h"
+#include "core/MapSceneModel2.h"
+#include "math/Point2.h"
+
+using namespace TAK::Engine::Core;
+using namespace TAK::Engine::Math;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    // degrees for inverse, pixels for forward
+    const double TOLERANCE = 1e-9;
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        std::size_t width;
+        std::size_t height;
+        std::size_t numPoints;
+        std::size_t numModels;
+        std::size_t repeat;
+        double tilt;
+    };
+
+    struct Scene
+    {
+        int srid;
+        MapCamera2::Mode mode;
+        double tilt;
+    };
+
+    struct Timing
+    {
+        double constructNs;
+        double setNs;
+        double copyNs;
+        double forwardNs;
+        double forwardBulkNs;
+        double inverseNs;
+        double inverseBulkNs;
+        double forwardDeviation;
+        double inverseDeviation;
+        std::size_t forwardFailed;
+        std::size_t inverseFailed;
+        bool failuresAgree;
+    };
+
+    template<class Fn>
+    double measure(Fn fn, const std::size_t repeat) NOTHROWS;
+    void run(Timing *value, const Scene &scene, const Options &opts) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.numPoints = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-m") && hasValue) {
+            opts.numModels = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-r") && hasValue) {
+            opts.repeat = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-t") && hasValue) {
+            opts.tilt = atof(argv[++i]);
+        } else if (!strcmp(arg, "-W") && hasValue) {
+            opts.width = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-H") && hasValue) {
+            opts.height = static_cast<std::size_t>(atol(argv[++i]));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.numPoints || !opts.numModels || !opts.repeat || !opts.width || !opts.height) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const Scene scenes[] =
+    {
+        { 4326, MapCamera2::Scale, 0.0 },
+        { 4326, MapCamera2::Perspective, opts.tilt },
+        { 4978, MapCamera2::Scale, 0.0 },
+        { 4978, MapCamera2::Perspective, opts.tilt },
+    };
+
+    printf("%ux%u viewport, %u points, %u models, best of %u runs\n\n",
+           (unsigned)opts.width, (unsigned)opts.height, (unsigned)opts.numPoints, (unsigned)opts.numModels, (unsigned)opts.repeat);
+    printf("                        ns per model              ns per point (single / bulk)\n");
+    printf("scene               construct    set   copy      forward          inverse         failed\n");
+
+    const MapCamera2::Mode defaultMode = MapSceneModel2_getCameraMode();
+    bool ok = true;
+    for (std::size_t i = 0u; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        MapSceneModel2_setCameraMode(scenes[i].mode);
+        Timing t;
+        run(&t, scenes[i], opts);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%d %s", scenes[i].srid, (scenes[i].mode == MapCamera2::Scale) ? "scale" : "persp");
+        printf("%-17s %9.0f %6.0f %6.0f   %6.1f / %6.1f   %6.1f / %6.1f   %6u\n",
+               name, t.constructNs, t.setNs, t.copyNs,
+               t.forwardNs, t.forwardBulkNs, t.inverseNs, t.inverseBulkNs,
+               (unsigned)t.inverseFailed);
+
+        if (!t.failuresAgree || t.forwardDeviation > TOLERANCE || t.inverseDeviation > TOLERANCE) {
+            fprintf(stderr, "%s: bulk results differ from single point results (forward %g px, inverse %g deg, failures %s)\n",
+                    name, t.forwardDeviation, t.inverseDeviation, t.failuresAgree ? "agree" : "differ");
+            ok = false;
+        }
+    }
+    MapSceneModel2_setCameraMode(defaultMode);
+
+    return ok ? 0 : 1;
+}
+
+namespace
+{
+    Options::Options() NOTHROWS :
+        width(1920u),
+        height(1080u),
+        numPoints(100000u),
+        numModels(20000u),
+        repeat(3u),
+        tilt(45.0)
+    {}
+
+    template<class Fn>
+    double measure(Fn fn, const std::size_t repeat) NOTHROWS
+    {
+        double best = 0.0;
+        for (std::size_t i = 0u; i < repeat; i++) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            const auto end = std::chrono::high_resolution_clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            if (!i || ns < best)
+                best = ns;
+        }
+        return best;
+    }
+
+    void run(Timing *value, const Scene &scene, const Options &opts) NOTHROWS
+    {
+        const GeoPoint2 focus(34.05, -118.25);
+        const double dpi = 240.0;
+        const double resolution = 10.0;
+        const float focusX = static_cast<float>(opts.width) / 2.0f;
+        const float focusY = static_cast<float>(opts.height) / 2.0f;
+
+        // construction and set, panning and rotating slightly per model so
+        // that no two are identical
+        std::vector<MapSceneModel2> models(opts.numModels);
+        value->constructNs = measure([&]() {
+            for (std::size_t i = 0u; i < opts.numModels; i++) {
+                MapSceneModel2 sm(dpi, opts.width, opts.height, scene.srid,
+                                  GeoPoint2(focus.latitude, focus.longitude + i * 1e-6),
+                                  focusX, focusY, static_cast<double>(i % 360u), scene.tilt, resolution);
+                models[i] = sm;
+            }
+        }, opts.repeat) / opts.numModels;
+        value->setNs = measure([&]() {
+            for (std::size_t i = 0u; i < opts.numModels; i++)
+                models[i].set(dpi, opts.width, opts.height, scene.srid,
+                              GeoPoint2(focus.latitude + i * 1e-6, focus.longitude),
+                              focusX, focusY, static_cast<double>(i % 360u), scene.tilt, resolution);
+        }, opts.repeat) / opts.numModels;
+        // the construction time above includes one copy per model
+        value->copyNs = measure([&]() {
+            for (std::size_t i = 1u; i < opts.numModels; i++)
+                models[i - 1u] = models[i];
+        }, opts.repeat) / (opts.numModels - 1u);
+        value->constructNs -= value->copyNs;
+
+        const MapSceneModel2 sm(dpi, opts.width, opts.height, scene.srid, focus, focusX, focusY, 0.0, scene.tilt, resolution);
+
+        // an even grid over the viewport
+        std::vector<Point2<float>> screen;
+        screen.reserve(opts.numPoints);
+        const std::size_t cols = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(opts.numPoints) * opts.width / opts.height)));
+        for (std::size_t i = 0u; i < opts.numPoints; i++) {
+            const std::size_t col = i % cols;
+            const std::size_t row = i / cols;
+            const std::size_t rows = (opts.numPoints + cols - 1u) / cols;
+            screen.push_back(Point2<float>(static_cast<float>((col + 0.5) * opts.width / cols),
+                                           static_cast<float>((row + 0.5) * opts.height / rows)));
+        }
+
+        std::vector<GeoPoint2> single(opts.numPoints);
+        std::vector<GeoPoint2> bulk(opts.numPoints);
+        value->inverseNs = measure([&]() {
+            for (std::size_t i = 0u; i < opts.numPoints; i++) {
+                if (sm.inverse(&single[i], screen[i], true) != TE_Ok)
+                    single[i] = GeoPoint2(NAN, NAN);
+            }
+        }, opts.repeat) / opts.numPoints;
+        value->inverseBulkNs = measure([&]() {
+            sm.inverse(bulk.data(), screen.data(), opts.numPoints, true);
+        }, opts.repeat) / opts.numPoints;
+
+        value->inverseDeviation = 0.0;
+        value->inverseFailed = 0u;
+        value->failuresAgree = true;
+        std::vector<GeoPoint2> geos;
+        geos.reserve(opts.numPoints);
+        for (std::size_t i = 0u; i < opts.numPoints; i++) {
+            const bool singleFailed = isnan(single[i].latitude);
+            const bool bulkFailed = isnan(bulk[i].latitude);
+            if (singleFailed != bulkFailed)
+                value->failuresAgree = false;
+            if (singleFailed) {
+                value->inverseFailed++;
+                continue;
+            }
+            if (bulkFailed)
+                continue;
+            value->inverseDeviation = std::max(value->inverseDeviation, fabs(single[i].latitude - bulk[i].latitude));
+            value->inverseDeviation = std::max(value->inverseDeviation, fabs(single[i].longitude - bulk[i].longitude));
+            geos.push_back(single[i]);
+        }
+
+        // forward the points that inverted successfully
+        std::vector<Point2<double>> fwdSingle(geos.size());
+        std::vector<Point2<double>> fwdBulk(geos.size());
+        value->forwardNs = measure([&]() {
+            for (std::size_t i = 0u; i < geos.size(); i++)
+                sm.forward(&fwdSingle[i], geos[i]);
+        }, opts.repeat) / std::max(geos.size(), (std::size_t)1u);
+        value->forwardBulkNs = measure([&]() {
+            sm.forward(fwdBulk.data(), geos.data(), geos.size());
+        }, opts.repeat) / std::max(geos.size(), (std::size_t)1u);
+
+        value->forwardDeviation = 0.0;
+        value->forwardFailed = 0u;
+        for (std::size_t i = 0u; i < geos.size(); i++) {
+            if (isnan(fwdBulk[i].x)) {
+                value->forwardFailed++;
+                continue;
+            }
+            value->forwardDeviation = std::max(value->forwardDeviation, fabs(fwdSingle[i].x - fwdBulk[i].x));
+            value->forwardDeviation = std::max(value->forwardDeviation, fabs(fwdSingle[i].y - fwdBulk[i].y));
+        }
+        if (value->forwardFailed)
+            value->failuresAgree = false;
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -W <pixels>  viewport width (default 1920)\n");
+        printf("    -H <pixels>  viewport height (default 1080)\n");
+        printf("    -n <count>   points to forward and inverse (default 100000)\n");
+        printf("    -m <count>   models to construct, set and copy (default 20000)\n");
+        printf("    -t <degrees> tilt of the perspective scenes (default 45)\n");
+        printf("    -r <count>   runs per measurement; the best is reported (default 3)\n");
+        printf("    -h           print this message\n");
+    }
+}
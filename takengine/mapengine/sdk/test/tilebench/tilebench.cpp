@@ -0,0 +1,447 @@
+// Tile-matrix enumeration benchmark.
+//
+// Pans a full screen east across a synthetic Web Mercator tile matrix at
+// several zoom levels and times GLZoomLevel::draw for each frame.  Each draw
+// finds the patches and tiles in view, resolves tile textures from the
+// layer's texture cache or requests them from the bitmap loader, draws the
+// loaded tiles and draws the nearest loaded ancestor in place of each tile
+// that is still loading.  GLMapView2 is rendered before each frame to update
+// the view, outside of the timed region.
+//
+// Each zoom runs the pan twice.  The cold pass starts with nothing loaded
+// or cached, so tiles load while the pass runs.  The pan is then repeated,
+// untimed, until it requests no more tiles, and the warm pass measures the
+// steady state in which every tile is either resident or cached.
+//
+// GL is provided by the recording backend (test/gl/RecordingGL), which
+// counts calls and does no rendering, so frame times are the CPU cost of
+// enumerating and issuing the tiles.  Tiles are blank bitmaps produced on
+// the loader threads.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/AtakMapController.h"
+#include "core/AtakMapView.h"
+#include "core/GeoPoint.h"
+#include "feature/Envelope2.h"
+#include "port/Collection.h"
+#include "port/STLVectorAdapter.h"
+#include "raster/tilematrix/TileMatrix.h"
+#include "renderer/AsyncBitmapLoader2.h"
+#include "renderer/Bitmap2.h"
+#include "renderer/GLTextureCache2.h"
+#include "renderer/core/GLMapView2.h"
+#include "renderer/raster/tilematrix/GLTiledLayerCore.h"
+#include "renderer/raster/tilematrix/GLZoomLevel.h"
+#include "util/Memory.h"
+
+#include "HeadlessRenderContext.h"
+#include "RecordingGL.h"
+
+using namespace TAK::Engine::Feature;
+using namespace TAK::Engine::Port;
+using namespace TAK::Engine::Raster::TileMatrix;
+using namespace TAK::Engine::Renderer;
+using namespace TAK::Engine::Renderer::Core;
+using namespace TAK::Engine::Renderer::Raster::TileMatrix;
+using namespace TAK::Engine::Tests;
+using namespace TAK::Engine::Util;
+
+namespace
+{
+    // half the width of the Web Mercator plane, in meters
+    const double MERCATOR_EXTENT = 20037508.342789244;
+    const int TILE_SIZE = 256;
+    const int MAX_ZOOM = 22;
+    // the pan is repeated at most this many times to load the warm pass
+    const std::size_t MAX_SETTLE_PASSES = 20u;
+
+    struct Options
+    {
+        Options() NOTHROWS;
+
+        std::vector<int> zooms;
+        std::size_t frames;
+        std::size_t tiles;
+        std::size_t loaderThreads;
+        std::size_t cacheMegabytes;
+        std::size_t width;
+        std::size_t height;
+        double dpi;
+        double latitude;
+        double longitude;
+    };
+
+    /**
+     * A quadtree over the full Web Mercator extent. Every tile exists and is
+     * a blank bitmap; the tiles served are counted.
+     */
+    class SyntheticTileMatrix : public TileMatrix
+    {
+    public :
+        SyntheticTileMatrix(const int maxZoom) NOTHROWS;
+        ~SyntheticTileMatrix() NOTHROWS override;
+    public :
+        const char *getName() const NOTHROWS override;
+        int getSRID() const NOTHROWS override;
+        TAKErr getZoomLevel(Collection<ZoomLevel> &value) const NOTHROWS override;
+        double getOriginX() const NOTHROWS override;
+        double getOriginY() const NOTHROWS override;
+        TAKErr getTile(BitmapPtr &result, const std::size_t zoom, const std::size_t x, const std::size_t y) NOTHROWS override;
+        TAKErr getTileData(std::unique_ptr<const uint8_t, void(*)(const uint8_t *)> &value, std::size_t *len,
+                           const std::size_t zoom, const std::size_t x, const std::size_t y) NOTHROWS override;
+        TAKErr getBounds(Envelope2 *value) const NOTHROWS override;
+    public :
+        /** returns the number of tiles served so far */
+        std::size_t getServed() const NOTHROWS;
+    private :
+        std::vector<ZoomLevel> levels;
+        std::atomic<std::size_t> served;
+    };
+
+    struct PassStats
+    {
+        double meanNanos;
+        double p50Nanos;
+        double maxNanos;
+        double drawCalls;
+        std::size_t loads;
+    };
+
+    struct Pan
+    {
+        double latitude;
+        double startLongitude;
+        double degrees;
+        double resolution;
+    };
+
+    void runPass(PassStats *value, GLZoomLevel &level, HeadlessRenderContext &context, GLMapView2 &glview, atakmap::core::AtakMapView &view,
+                 const Pan &pan, const std::size_t frames) NOTHROWS;
+    std::size_t awaitLoads(const SyntheticTileMatrix &matrix) NOTHROWS;
+    void setCamera(atakmap::core::AtakMapView &view, const double latitude, const double longitude, const double resolution) NOTHROWS;
+    bool parseZooms(std::vector<int> &value, const char *arg) NOTHROWS;
+    void usage(const char *argv0) NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (!strcmp(arg, "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else if (!strcmp(arg, "-z") && hasValue) {
+            if (!parseZooms(opts.zooms, argv[++i])) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(arg, "-n") && hasValue) {
+            opts.frames = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-p") && hasValue) {
+            opts.tiles = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-l") && hasValue) {
+            opts.loaderThreads = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-c") && hasValue) {
+            opts.cacheMegabytes = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-W") && hasValue) {
+            opts.width = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-H") && hasValue) {
+            opts.height = static_cast<std::size_t>(atol(argv[++i]));
+        } else if (!strcmp(arg, "-d") && hasValue) {
+            opts.dpi = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!opts.frames || !opts.loaderThreads || !opts.width || !opts.height || opts.dpi <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // set up the view. The benchmark's thread is the render thread.
+    HeadlessRenderSurface surface(opts.width, opts.height, opts.dpi);
+    HeadlessRenderContext context(surface);
+
+    atakmap::core::AtakMapView view(static_cast<float>(opts.width), static_cast<float>(opts.height), opts.dpi);
+    GLMapView2 glview(context, view, 0, 0, static_cast<int>(opts.width), static_cast<int>(opts.height));
+    if (glview.start() != TE_Ok) {
+        fprintf(stderr, "Failed to start the map view\n");
+        return 1;
+    }
+
+    // the layer, with a zoom level renderer for every level up to the
+    // deepest one measured, so that loading tiles may draw their ancestors
+    const int maxZoom = *std::max_element(opts.zooms.begin(), opts.zooms.end());
+    std::shared_ptr<SyntheticTileMatrix> matrix(new SyntheticTileMatrix(maxZoom));
+    GLTextureCache2 textureCache(opts.cacheMegabytes * 1024u * 1024u);
+    AsyncBitmapLoader2 bitmapLoader(opts.loaderThreads);
+    GLTiledLayerCore core(matrix, "tilebench://synthetic");
+    core.textureCache = &textureCache;
+    core.bitmapLoader = &bitmapLoader;
+
+    std::vector<std::unique_ptr<GLZoomLevel>> levels;
+    {
+        std::vector<TileMatrix::ZoomLevel> lods;
+        STLVectorAdapter<TileMatrix::ZoomLevel> lodsAdapter(lods);
+        matrix->getZoomLevel(lodsAdapter);
+        GLZoomLevel *previous = nullptr;
+        for (std::size_t i = 0u; i < lods.size(); i++) {
+            levels.push_back(std::unique_ptr<GLZoomLevel>(new GLZoomLevel(previous, &core, lods[i])));
+            previous = levels.back().get();
+        }
+    }
+
+    printf("surface %ux%u at %.0f dpi, pan %u tiles east over %u frames, %u loader threads, %u MB texture cache\n\n",
+           (unsigned)opts.width, (unsigned)opts.height, opts.dpi, (unsigned)opts.tiles, (unsigned)opts.frames,
+           (unsigned)opts.loaderThreads, (unsigned)opts.cacheMegabytes);
+    printf("                  cold (tiles loading)                      warm (tiles resident or cached)\n");
+    printf("zoom  m/px     mean ms  p50 ms  max ms  draws  loads     mean ms  p50 ms  max ms  draws  loads\n");
+
+    bool ok = true;
+    for (std::size_t i = 0u; i < opts.zooms.size(); i++) {
+        const int z = opts.zooms[i];
+        GLZoomLevel &level = *levels[z];
+
+        Pan pan;
+        pan.latitude = opts.latitude;
+        pan.startLongitude = opts.longitude;
+        // a tile spans 360/2^z degrees of longitude. Pans of more than 300
+        // degrees are clamped, so that no view is seen twice.
+        pan.degrees = std::min(static_cast<double>(opts.tiles) * 360.0 / static_cast<double>(1 << z), 300.0);
+        pan.resolution = level.info.resolution;
+
+        // start with nothing resident or cached
+        for (std::size_t j = 0u; j < levels.size(); j++)
+            levels[j]->release();
+        textureCache.clear();
+        std::size_t served = awaitLoads(*matrix);
+
+        PassStats cold;
+        runPass(&cold, level, context, glview, view, pan, opts.frames);
+        std::size_t loaded = awaitLoads(*matrix);
+        cold.loads = loaded - served;
+        served = loaded;
+
+        bool settled = false;
+        for (std::size_t j = 0u; j < MAX_SETTLE_PASSES && !settled; j++) {
+            runPass(nullptr, level, context, glview, view, pan, opts.frames);
+            loaded = awaitLoads(*matrix);
+            settled = (loaded == served);
+            served = loaded;
+        }
+
+        PassStats warm;
+        runPass(&warm, level, context, glview, view, pan, opts.frames);
+        warm.loads = awaitLoads(*matrix) - served;
+
+        printf("%4d %9.2f  %7.3f %7.3f %7.3f %6.1f %6u     %7.3f %7.3f %7.3f %6.1f %6u\n",
+               z, level.info.resolution,
+               cold.meanNanos / 1e6, cold.p50Nanos / 1e6, cold.maxNanos / 1e6, cold.drawCalls, (unsigned)cold.loads,
+               warm.meanNanos / 1e6, warm.p50Nanos / 1e6, warm.maxNanos / 1e6, warm.drawCalls, (unsigned)warm.loads);
+        if (!settled) {
+            fprintf(stderr, "zoom %d: tiles were still loading after %u passes\n", z, (unsigned)MAX_SETTLE_PASSES);
+            ok = false;
+        }
+    }
+
+    for (std::size_t i = 0u; i < levels.size(); i++)
+        levels[i]->release();
+    levels.clear();
+    glview.stop();
+    return ok ? 0 : 1;
+}
+
+namespace
+{
+    Options::Options() NOTHROWS :
+        frames(240u),
+        tiles(32u),
+        loaderThreads(4u),
+        cacheMegabytes(256u),
+        width(1920u),
+        height(1080u),
+        dpi(240.0),
+        latitude(34.05),
+        longitude(-118.25)
+    {
+        zooms.push_back(6);
+        zooms.push_back(10);
+        zooms.push_back(14);
+        zooms.push_back(18);
+    }
+
+    SyntheticTileMatrix::SyntheticTileMatrix(const int maxZoom) NOTHROWS :
+        served(0u)
+    {
+        for (int i = 0; i <= maxZoom; i++) {
+            ZoomLevel level;
+            level.level = i;
+            level.pixelSizeX = (2.0 * MERCATOR_EXTENT) / (static_cast<double>(1 << i) * TILE_SIZE);
+            level.pixelSizeY = level.pixelSizeX;
+            level.resolution = level.pixelSizeX;
+            level.tileWidth = TILE_SIZE;
+            level.tileHeight = TILE_SIZE;
+            levels.push_back(level);
+        }
+    }
+    SyntheticTileMatrix::~SyntheticTileMatrix() NOTHROWS
+    {}
+    const char *SyntheticTileMatrix::getName() const NOTHROWS
+    {
+        return "tilebench";
+    }
+    int SyntheticTileMatrix::getSRID() const NOTHROWS
+    {
+        return 3857;
+    }
+    TAKErr SyntheticTileMatrix::getZoomLevel(Collection<ZoomLevel> &value) const NOTHROWS
+    {
+        TAKErr code(TE_Ok);
+        for (auto it = levels.begin(); it != levels.end(); it++) {
+            code = value.add(*it);
+            TE_CHECKBREAK_CODE(code);
+        }
+        return code;
+    }
+    double SyntheticTileMatrix::getOriginX() const NOTHROWS
+    {
+        return -MERCATOR_EXTENT;
+    }
+    double SyntheticTileMatrix::getOriginY() const NOTHROWS
+    {
+        return MERCATOR_EXTENT;
+    }
+    TAKErr SyntheticTileMatrix::getTile(BitmapPtr &result, const std::size_t zoom, const std::size_t, const std::size_t) NOTHROWS
+    {
+        if (zoom >= levels.size())
+            return TE_InvalidArg;
+        result = BitmapPtr(new Bitmap2(TILE_SIZE, TILE_SIZE, Bitmap2::RGB565), Memory_deleter_const<Bitmap2>);
+        served++;
+        return TE_Ok;
+    }
+    TAKErr SyntheticTileMatrix::getTileData(std::unique_ptr<const uint8_t, void(*)(const uint8_t *)> &, std::size_t *,
+                                            const std::size_t, const std::size_t, const std::size_t) NOTHROWS
+    {
+        return TE_Unsupported;
+    }
+    TAKErr SyntheticTileMatrix::getBounds(Envelope2 *value) const NOTHROWS
+    {
+        if (!value)
+            return TE_InvalidArg;
+        *value = Envelope2(-MERCATOR_EXTENT, -MERCATOR_EXTENT, MERCATOR_EXTENT, MERCATOR_EXTENT);
+        return TE_Ok;
+    }
+    std::size_t SyntheticTileMatrix::getServed() const NOTHROWS
+    {
+        return served;
+    }
+
+    void runPass(PassStats *value, GLZoomLevel &level, HeadlessRenderContext &context, GLMapView2 &glview, atakmap::core::AtakMapView &view,
+                 const Pan &pan, const std::size_t frames) NOTHROWS
+    {
+        std::vector<double> nanos;
+        nanos.reserve(frames);
+        std::size_t drawCalls = 0u;
+        for (std::size_t f = 0u; f < frames; f++) {
+            double longitude = pan.startLongitude + pan.degrees * static_cast<double>(f) / static_cast<double>(frames);
+            if (longitude >= 180.0)
+                longitude -= 360.0;
+            setCamera(view, pan.latitude, longitude, pan.resolution);
+            context.pump();
+            glview.render();
+
+            GLCounters before;
+            RecordingGL_getCounters(&before);
+            const auto start = std::chrono::high_resolution_clock::now();
+            level.draw(glview, GLMapView2::Surface);
+            const auto end = std::chrono::high_resolution_clock::now();
+            GLCounters after;
+            RecordingGL_getCounters(&after);
+
+            nanos.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            drawCalls += after.drawCalls - before.drawCalls;
+        }
+        if (!value)
+            return;
+
+        double sum = 0.0;
+        for (std::size_t i = 0u; i < nanos.size(); i++)
+            sum += nanos[i];
+        value->meanNanos = sum / static_cast<double>(frames);
+        value->drawCalls = static_cast<double>(drawCalls) / static_cast<double>(frames);
+        std::sort(nanos.begin(), nanos.end());
+        value->p50Nanos = nanos[nanos.size() / 2u];
+        value->maxNanos = nanos.back();
+        value->loads = 0u;
+    }
+
+    std::size_t awaitLoads(const SyntheticTileMatrix &matrix) NOTHROWS
+    {
+        // the loader is taken to be idle once no tile has been served for
+        // 100ms
+        std::size_t served = matrix.getServed();
+        for (int idle = 0; idle < 5;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            const std::size_t s = matrix.getServed();
+            if (s == served) {
+                idle++;
+            } else {
+                served = s;
+                idle = 0;
+            }
+        }
+        return served;
+    }
+
+    void setCamera(atakmap::core::AtakMapView &view, const double latitude, const double longitude, const double resolution) NOTHROWS
+    {
+        atakmap::core::GeoPoint center(latitude, longitude);
+        atakmap::core::AtakMapController *controller = view.getController();
+        controller->panZoomRotateTo(&center, view.mapResolutionAsMapScale(resolution), 0.0, false);
+    }
+
+    bool parseZooms(std::vector<int> &value, const char *arg) NOTHROWS
+    {
+        value.clear();
+        const char *s = arg;
+        while (*s) {
+            char *end;
+            const long z = strtol(s, &end, 10);
+            if (end == s || z < 0 || z > MAX_ZOOM)
+                return false;
+            value.push_back(static_cast<int>(z));
+            s = end;
+            if (*s == ',')
+                s++;
+            else if (*s)
+                return false;
+        }
+        return !value.empty();
+    }
+
+    void usage(const char *argv0) NOTHROWS
+    {
+        printf("Usage: %s [options]\n", argv0);
+        printf("    -z <list>    comma separated zoom levels to pan at, 0 to %d (default 6,10,14,18)\n", MAX_ZOOM);
+        printf("    -n <count>   frames per pan (default 240)\n");
+        printf("    -p <count>   tiles to pan east per pan, up to 300 degrees (default 32)\n");
+        printf("    -l <count>   bitmap loader threads (default 4)\n");
+        printf("    -c <MB>      texture cache size (default 256)\n");
+        printf("    -W <pixels>  surface width (default 1920)\n");
+        printf("    -H <pixels>  surface height (default 1080)\n");
+        printf("    -d <dpi>     display dpi (default 240)\n");
+        printf("    -h           print this message\n");
+    }
+}
@@ -0,0 +1,269 @@
+// Tests for util/MemoryAccounting and its GLTextureCache2 client.
+//
+// Checks that budget counters match the memory actually allocated by a
+// synthetic workload, and that a trim request releases textures held by
+// GLTextureCache2 once applied on the owning thread. GL is provided by the
+// recording backend (test/gl/RecordingGL), so no GPU is required.
+//
+// Exits with a non-zero status on failure.
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "renderer/GLTexture2.h"
+#include "renderer/GLTextureCache2.h"
+#include "util/Memory.h"
+#include "util/MemoryAccounting.h"
+
+#include "RecordingGL.h"
+
+using namespace TAK::Engine::Renderer;
+using namespace TAK::Engine::Tests;
+using namespace TAK::Engine::Util;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+namespace
+{
+    int failures = 0;
+
+    struct TagQuery
+    {
+        const char *tag;
+        std::size_t matches;
+        MemoryUsage usage;
+    };
+
+    TAKErr findTag(void *opaque, const MemoryUsage &usage) NOTHROWS;
+    bool getUsage(MemoryUsage *value, const char *tag) NOTHROWS;
+
+    void testBudgetCountersMatchWorkload() NOTHROWS;
+    void testBudgetTrimCallback() NOTHROWS;
+    void testTextureCacheAccounting() NOTHROWS;
+    void testTextureCacheTrim() NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    testBudgetCountersMatchWorkload();
+    testBudgetTrimCallback();
+    testTextureCacheAccounting();
+    testTextureCacheTrim();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+namespace
+{
+    void testBudgetCountersMatchWorkload() NOTHROWS
+    {
+        MemoryBudget budget("test.workload", 1024u*1024u);
+        const std::size_t baseline = MemoryAccounting_getTotalBytes();
+
+        // allocate and free buffers of random sizes, reporting each as the
+        // owner would, and track the actual bytes held alongside
+        std::mt19937 rng(7u);
+        std::vector<std::vector<uint8_t>> buffers;
+        std::size_t held = 0u;
+        std::size_t peak = 0u;
+        for (std::size_t i = 0u; i < 4096u; i++) {
+            if (buffers.empty() || rng() % 3u) {
+                const std::size_t n = 1u + rng() % 4096u;
+                buffers.push_back(std::vector<uint8_t>(n));
+                budget.allocated(buffers.back().size());
+                held += buffers.back().size();
+            } else {
+                const std::size_t idx = rng() % buffers.size();
+                budget.released(buffers[idx].size());
+                held -= buffers[idx].size();
+                buffers.erase(buffers.begin() + idx);
+            }
+            if (held > peak)
+                peak = held;
+            if (budget.getBytes() != held)
+                break;
+        }
+
+        CHECK(budget.getBytes() == held);
+        CHECK(budget.getHighWater() == peak);
+        CHECK(MemoryAccounting_getTotalBytes() == baseline + held);
+
+        MemoryUsage usage;
+        CHECK(getUsage(&usage, "test.workload"));
+        CHECK(usage.bytes == held);
+        CHECK(usage.highWater == peak);
+        CHECK(usage.limit == 1024u*1024u);
+        CHECK(!usage.trimmable);
+
+        budget.resetHighWater();
+        CHECK(budget.getHighWater() == held);
+
+        while (!buffers.empty()) {
+            budget.released(buffers.back().size());
+            buffers.pop_back();
+        }
+        CHECK(budget.getBytes() == 0u);
+        CHECK(MemoryAccounting_getTotalBytes() == baseline);
+    }
+
+    void testBudgetTrimCallback() NOTHROWS
+    {
+        struct Owner
+        {
+            std::vector<uint8_t> data;
+            MemoryBudget *budget;
+
+            static TAKErr trim(void *opaque, const std::size_t targetBytes) NOTHROWS
+            {
+                Owner &owner = *static_cast<Owner *>(opaque);
+                if (owner.data.size() > targetBytes) {
+                    owner.data.resize(targetBytes);
+                    owner.data.shrink_to_fit();
+                    owner.budget->setBytes(owner.data.size());
+                }
+                return TE_Ok;
+            }
+        };
+
+        Owner owner;
+        MemoryBudget budget("test.trimmable", 0u, Owner::trim, &owner);
+        owner.budget = &budget;
+        owner.data.resize(10000u);
+        budget.setBytes(owner.data.size());
+
+        MemoryBudget untrimmable("test.untrimmable");
+        untrimmable.setBytes(5000u);
+        CHECK(untrimmable.requestTrim(0u) == TE_Unsupported);
+
+        CHECK(MemoryAccounting_trim(0.25) == TE_Ok);
+        CHECK(owner.data.size() == 2500u);
+        CHECK(budget.getBytes() == 2500u);
+        CHECK(budget.getHighWater() == 10000u);
+        CHECK(untrimmable.getBytes() == 5000u);
+
+        MemoryUsage usage;
+        CHECK(getUsage(&usage, "test.trimmable"));
+        CHECK(usage.trimmable);
+        CHECK(usage.bytes == 2500u);
+    }
+
+    void testTextureCacheAccounting() NOTHROWS
+    {
+        GLCounters counters;
+        RecordingGL_getCounters(&counters);
+        const std::size_t liveTextures = counters.liveTextures;
+
+        const std::size_t maxSize = 64u*64u*4u*8u;
+        GLTextureCache2 cache(maxSize);
+
+        std::size_t expected = 0u;
+        for (std::size_t i = 0u; i < 8u; i++) {
+            GLTexture2Ptr texture(new GLTexture2(64u, 64u, GL_RGBA, GL_UNSIGNED_BYTE), Memory_deleter_const<GLTexture2>);
+            texture->init();
+            std::size_t texSize;
+            CHECK(GLTextureCache2::sizeOf(&texSize, *texture) == TE_Ok);
+            expected += texSize;
+            cache.put(std::to_string(i).c_str(), GLTextureCache2::EntryPtr(new GLTextureCache2::Entry(std::move(texture)), Memory_deleter_const<GLTextureCache2::Entry>));
+        }
+
+        MemoryUsage usage;
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == expected);
+        CHECK(usage.limit == maxSize);
+        CHECK(usage.trimmable);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.liveTextures == liveTextures + 8u);
+
+        // exceeding the configured size evicts the oldest entry
+        GLTexture2Ptr texture(new GLTexture2(64u, 64u, GL_RGBA, GL_UNSIGNED_BYTE), Memory_deleter_const<GLTexture2>);
+        texture->init();
+        cache.put("overflow", GLTextureCache2::EntryPtr(new GLTextureCache2::Entry(std::move(texture)), Memory_deleter_const<GLTextureCache2::Entry>));
+        const GLTextureCache2::Entry *entry;
+        CHECK(cache.get(&entry, "0") != TE_Ok);
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == expected);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.liveTextures == liveTextures + 8u);
+
+        cache.clear();
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == 0u);
+        CHECK(usage.highWater == expected);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.liveTextures == liveTextures);
+    }
+
+    void testTextureCacheTrim() NOTHROWS
+    {
+        GLCounters counters;
+        RecordingGL_getCounters(&counters);
+        const std::size_t liveTextures = counters.liveTextures;
+
+        GLTextureCache2 cache(16u*1024u*1024u);
+        std::size_t texSize = 0u;
+        for (std::size_t i = 0u; i < 16u; i++) {
+            GLTexture2Ptr texture(new GLTexture2(128u, 128u, GL_RGBA, GL_UNSIGNED_BYTE), Memory_deleter_const<GLTexture2>);
+            texture->init();
+            CHECK(GLTextureCache2::sizeOf(&texSize, *texture) == TE_Ok);
+            cache.put(static_cast<uint64_t>(i), GLTextureCache2::EntryPtr(new GLTextureCache2::Entry(std::move(texture)), Memory_deleter_const<GLTextureCache2::Entry>));
+        }
+
+        // the request is recorded; GL resources are untouched until the
+        // owning thread applies it
+        CHECK(MemoryAccounting_trim(0.25) == TE_Ok);
+        MemoryUsage usage;
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == 16u*texSize);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.liveTextures == liveTextures + 16u);
+
+        CHECK(cache.applyPendingTrim() == TE_Ok);
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == 4u*texSize);
+        RecordingGL_getCounters(&counters);
+        CHECK(counters.liveTextures == liveTextures + 4u);
+
+        // the most recently used entries are retained
+        const GLTextureCache2::Entry *entry;
+        CHECK(cache.get(&entry, static_cast<uint64_t>(11u)) != TE_Ok);
+        CHECK(cache.get(&entry, static_cast<uint64_t>(12u)) == TE_Ok);
+        CHECK(cache.get(&entry, static_cast<uint64_t>(15u)) == TE_Ok);
+
+        // with nothing outstanding, applying is a no-op
+        CHECK(cache.applyPendingTrim() == TE_Ok);
+        CHECK(getUsage(&usage, "GLTextureCache2"));
+        CHECK(usage.bytes == 4u*texSize);
+        cache.clear();
+    }
+
+    TAKErr findTag(void *opaque, const MemoryUsage &usage) NOTHROWS
+    {
+        TagQuery &query = *static_cast<TagQuery *>(opaque);
+        if (!strcmp(usage.tag, query.tag)) {
+            query.usage = usage;
+            query.matches++;
+        }
+        return TE_Ok;
+    }
+    bool getUsage(MemoryUsage *value, const char *tag) NOTHROWS
+    {
+        TagQuery query;
+        query.tag = tag;
+        query.matches = 0u;
+        if (MemoryAccounting_visitUsage(findTag, &query) != TE_Ok || query.matches != 1u)
+            return false;
+        *value = query.usage;
+        return true;
+    }
+}
@@ -0,0 +1,456 @@
+// Tests for util/Tracing.
+//
+// Checks that nested TE_TRACE_SPANs are recorded in the order they end,
+// with depths and intervals that nest as the scopes do, on each thread;
+// that nothing is recorded while tracing is disabled, and that a disabled
+// span costs no more than MAX_DISABLED_SPAN_NANOS; and that the Chrome
+// trace export is well-formed JSON holding every recorded span.
+//
+// Exits with a non-zero status on failure.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/DataOutput2.h"
+#include "util/Tracing.h"
+
+using namespace TAK::Engine::Util;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+namespace
+{
+    int failures = 0;
+
+    // the budget for constructing and destroying a span while tracing is
+    // disabled, a single relaxed atomic load, with headroom for slow devices
+    const double MAX_DISABLED_SPAN_NANOS = 20.0;
+    const std::size_t NUM_TIMED_SPANS = 10000000u;
+
+    const char *OUTER = "test.outer";
+    const char *FIRST = "test.first";
+    const char *LEAF = "test.leaf";
+    const char *SECOND = "test.second";
+    // exercises the escaping of the export
+    const char *ESCAPED = "test.\"quoted\" \\ \t\x01";
+
+    TAKErr collectEvent(void *opaque, const TraceEvent &event) NOTHROWS;
+    std::vector<TraceEvent> getEvents() NOTHROWS;
+    void recordNested() NOTHROWS;
+    void checkNested(const std::vector<TraceEvent> &events, const uint32_t threadId) NOTHROWS;
+    double timeSpans() NOTHROWS;
+
+    // minimal JSON syntax checker; each returns false on malformed input
+    bool parseValue(const char *&s) NOTHROWS;
+    bool parseObject(const char *&s) NOTHROWS;
+    bool parseArray(const char *&s) NOTHROWS;
+    bool parseString(const char *&s) NOTHROWS;
+    bool parseNumber(const char *&s) NOTHROWS;
+    bool parseLiteral(const char *&s, const char *literal) NOTHROWS;
+    void skipWhitespace(const char *&s) NOTHROWS;
+
+    void testNestedSpans() NOTHROWS;
+    void testNestedSpansPerThread() NOTHROWS;
+    void testEnabledAtConstruction() NOTHROWS;
+    void testDisabledRecordsNothing() NOTHROWS;
+    void testDisabledCost() NOTHROWS;
+    void testChromeTraceExport() NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    testNestedSpans();
+    testNestedSpansPerThread();
+    testEnabledAtConstruction();
+    testDisabledRecordsNothing();
+    testDisabledCost();
+    testChromeTraceExport();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+namespace
+{
+    void testNestedSpans() NOTHROWS
+    {
+        Tracing_setEnabled(true);
+        Tracing_clear();
+        recordNested();
+        Tracing_setEnabled(false);
+
+        const std::vector<TraceEvent> events(getEvents());
+        CHECK(events.size() == 4u);
+        if (events.size() == 4u)
+            checkNested(events, events[0].threadId);
+        Tracing_clear();
+    }
+
+    void testNestedSpansPerThread() NOTHROWS
+    {
+        Tracing_setEnabled(true);
+        Tracing_clear();
+        {
+            TE_TRACE_SPAN(OUTER);
+            std::thread worker(recordNested);
+            worker.join();
+        }
+        Tracing_setEnabled(false);
+
+        // the worker's spans are its own and start at depth 0, even though
+        // a span was open on the main thread throughout
+        const std::vector<TraceEvent> events(getEvents());
+        CHECK(events.size() == 5u);
+        uint32_t mainThread = 0u;
+        uint32_t workerThread = 0u;
+        std::vector<TraceEvent> workerEvents;
+        for (std::size_t i = 0u; i < events.size(); i++) {
+            if (events[i].name == LEAF)
+                workerThread = events[i].threadId;
+        }
+        for (std::size_t i = 0u; i < events.size(); i++) {
+            if (events[i].threadId == workerThread)
+                workerEvents.push_back(events[i]);
+            else
+                mainThread = events[i].threadId;
+        }
+        CHECK(mainThread != workerThread);
+        CHECK(workerEvents.size() == 4u);
+        if (workerEvents.size() == 4u)
+            checkNested(workerEvents, workerThread);
+        Tracing_clear();
+    }
+
+    void testEnabledAtConstruction() NOTHROWS
+    {
+        Tracing_clear();
+
+        // recorded, as tracing was enabled when the span began
+        Tracing_setEnabled(true);
+        {
+            TE_TRACE_SPAN(FIRST);
+            Tracing_setEnabled(false);
+        }
+        // not recorded, as tracing was disabled when the span began
+        {
+            TE_TRACE_SPAN(SECOND);
+            Tracing_setEnabled(true);
+        }
+        Tracing_setEnabled(false);
+
+        const std::vector<TraceEvent> events(getEvents());
+        CHECK(events.size() == 1u);
+        if (!events.empty())
+            CHECK(events[0].name == FIRST);
+        Tracing_clear();
+    }
+
+    void testDisabledRecordsNothing() NOTHROWS
+    {
+        Tracing_setEnabled(false);
+        Tracing_clear();
+        for (std::size_t i = 0u; i < 10000u; i++)
+            recordNested();
+        std::thread worker(recordNested);
+        worker.join();
+
+        CHECK(getEvents().empty());
+    }
+
+    void testDisabledCost() NOTHROWS
+    {
+        Tracing_setEnabled(false);
+        Tracing_clear();
+
+        // best of several trials, to discount preemption
+        double best = timeSpans();
+        for (int i = 0; i < 4; i++) {
+            const double trial = timeSpans();
+            if (trial < best)
+                best = trial;
+        }
+        printf("disabled span: %.2f ns (limit %.2f ns)\n", best, MAX_DISABLED_SPAN_NANOS);
+        CHECK(best <= MAX_DISABLED_SPAN_NANOS);
+        CHECK(getEvents().empty());
+    }
+
+    void testChromeTraceExport() NOTHROWS
+    {
+        // an empty trace is still valid
+        {
+            Tracing_clear();
+            DynamicOutput sink;
+            CHECK(sink.open(64u) == TE_Ok);
+            CHECK(Tracing_exportChromeTrace(sink) == TE_Ok);
+            const uint8_t *buf = nullptr;
+            std::size_t len = 0u;
+            CHECK(sink.get(&buf, &len) == TE_Ok);
+            const std::string json(reinterpret_cast<const char *>(buf), len);
+            const char *s = json.c_str();
+            CHECK(parseValue(s));
+            skipWhitespace(s);
+            CHECK(!*s);
+        }
+
+        Tracing_setEnabled(true);
+        Tracing_clear();
+        recordNested();
+        {
+            TE_TRACE_SPAN(ESCAPED);
+        }
+        std::thread worker(recordNested);
+        worker.join();
+        Tracing_setEnabled(false);
+
+        const std::size_t numEvents = getEvents().size();
+        CHECK(numEvents == 9u);
+
+        DynamicOutput sink;
+        CHECK(sink.open(1024u) == TE_Ok);
+        CHECK(Tracing_exportChromeTrace(sink) == TE_Ok);
+        const uint8_t *buf = nullptr;
+        std::size_t len = 0u;
+        CHECK(sink.get(&buf, &len) == TE_Ok);
+        const std::string json(reinterpret_cast<const char *>(buf), len);
+
+        const char *s = json.c_str();
+        const bool valid = parseValue(s);
+        skipWhitespace(s);
+        if (!valid || *s)
+            fprintf(stderr, "malformed trace at offset %u: %s\n", (unsigned)(s - json.c_str()), json.c_str());
+        CHECK(valid);
+        CHECK(!*s);
+
+        // one complete event per span, in the traceEvents array
+        CHECK(!strncmp(json.c_str(), "{\"traceEvents\":[", 16u));
+        std::size_t complete = 0u;
+        for (std::size_t at = json.find("\"ph\":\"X\""); at != std::string::npos; at = json.find("\"ph\":\"X\"", at + 1u))
+            complete++;
+        CHECK(complete == numEvents);
+        CHECK(json.find("\"name\":\"test.\\\"quoted\\\" \\\\ \\u0009\\u0001\"") != std::string::npos);
+        Tracing_clear();
+    }
+
+    TAKErr collectEvent(void *opaque, const TraceEvent &event) NOTHROWS
+    {
+        static_cast<std::vector<TraceEvent> *>(opaque)->push_back(event);
+        return TE_Ok;
+    }
+
+    std::vector<TraceEvent> getEvents() NOTHROWS
+    {
+        std::vector<TraceEvent> events;
+        CHECK(Tracing_visitEvents(collectEvent, &events) == TE_Ok);
+        return events;
+    }
+
+    void recordNested() NOTHROWS
+    {
+        TE_TRACE_SPAN(OUTER);
+        {
+            TE_TRACE_SPAN(FIRST);
+            {
+                TE_TRACE_SPAN(LEAF);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        {
+            TE_TRACE_SPAN(SECOND);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void checkNested(const std::vector<TraceEvent> &events, const uint32_t threadId) NOTHROWS
+    {
+        // spans are recorded as they end: innermost first, siblings in order
+        const TraceEvent &leaf = events[0];
+        const TraceEvent &first = events[1];
+        const TraceEvent &second = events[2];
+        const TraceEvent &outer = events[3];
+        CHECK(leaf.name == LEAF);
+        CHECK(first.name == FIRST);
+        CHECK(second.name == SECOND);
+        CHECK(outer.name == OUTER);
+
+        for (std::size_t i = 0u; i < 4u; i++) {
+            CHECK(events[i].threadId == threadId);
+            CHECK(events[i].beginNanos <= events[i].endNanos);
+        }
+
+        CHECK(outer.depth == 0u);
+        CHECK(first.depth == 1u);
+        CHECK(second.depth == 1u);
+        CHECK(leaf.depth == 2u);
+
+        // children lie within their parents, siblings do not overlap
+        CHECK(first.beginNanos >= outer.beginNanos && first.endNanos <= outer.endNanos);
+        CHECK(second.beginNanos >= outer.beginNanos && second.endNanos <= outer.endNanos);
+        CHECK(leaf.beginNanos >= first.beginNanos && leaf.endNanos <= first.endNanos);
+        CHECK(first.endNanos <= second.beginNanos);
+        // the sleeps are timed
+        CHECK(leaf.endNanos - leaf.beginNanos >= 100000LL);
+        CHECK(second.endNanos - second.beginNanos >= 100000LL);
+    }
+
+    double timeSpans() NOTHROWS
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0u; i < NUM_TIMED_SPANS; i++) {
+            TE_TRACE_SPAN(LEAF);
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(NUM_TIMED_SPANS);
+    }
+
+    bool parseValue(const char *&s) NOTHROWS
+    {
+        skipWhitespace(s);
+        switch (*s) {
+            case '{' :
+                return parseObject(s);
+            case '[' :
+                return parseArray(s);
+            case '"' :
+                return parseString(s);
+            case 't' :
+                return parseLiteral(s, "true");
+            case 'f' :
+                return parseLiteral(s, "false");
+            case 'n' :
+                return parseLiteral(s, "null");
+            default :
+                return parseNumber(s);
+        }
+    }
+
+    bool parseObject(const char *&s) NOTHROWS
+    {
+        s++;
+        skipWhitespace(s);
+        if (*s == '}') {
+            s++;
+            return true;
+        }
+        while (true) {
+            skipWhitespace(s);
+            if (*s != '"' || !parseString(s))
+                return false;
+            skipWhitespace(s);
+            if (*s++ != ':')
+                return false;
+            if (!parseValue(s))
+                return false;
+            skipWhitespace(s);
+            if (*s == '}') {
+                s++;
+                return true;
+            }
+            if (*s++ != ',')
+                return false;
+        }
+    }
+
+    bool parseArray(const char *&s) NOTHROWS
+    {
+        s++;
+        skipWhitespace(s);
+        if (*s == ']') {
+            s++;
+            return true;
+        }
+        while (true) {
+            if (!parseValue(s))
+                return false;
+            skipWhitespace(s);
+            if (*s == ']') {
+                s++;
+                return true;
+            }
+            if (*s++ != ',')
+                return false;
+        }
+    }
+
+    bool parseString(const char *&s) NOTHROWS
+    {
+        s++;
+        while (*s != '"') {
+            const unsigned char c = static_cast<unsigned char>(*s++);
+            if (c < 0x20u)
+                return false;
+            if (c != '\\')
+                continue;
+            const char escape = *s++;
+            if (escape == 'u') {
+                for (int i = 0; i < 4; i++) {
+                    const char h = *s++;
+                    if (!((h >= '0' && h <= '9') || (h >= 'a' && h <= 'f') || (h >= 'A' && h <= 'F')))
+                        return false;
+                }
+            } else if (!strchr("\"\\/bfnrt", escape) || !escape) {
+                return false;
+            }
+        }
+        s++;
+        return true;
+    }
+
+    bool parseNumber(const char *&s) NOTHROWS
+    {
+        const char *start = s;
+        if (*s == '-')
+            s++;
+        if (*s == '0') {
+            s++;
+        } else if (*s >= '1' && *s <= '9') {
+            while (*s >= '0' && *s <= '9')
+                s++;
+        } else {
+            return false;
+        }
+        if (*s == '.') {
+            s++;
+            if (!(*s >= '0' && *s <= '9'))
+                return false;
+            while (*s >= '0' && *s <= '9')
+                s++;
+        }
+        if (*s == 'e' || *s == 'E') {
+            s++;
+            if (*s == '+' || *s == '-')
+                s++;
+            if (!(*s >= '0' && *s <= '9'))
+                return false;
+            while (*s >= '0' && *s <= '9')
+                s++;
+        }
+        return s > start;
+    }
+
+    bool parseLiteral(const char *&s, const char *literal) NOTHROWS
+    {
+        const std::size_t len = strlen(literal);
+        if (strncmp(s, literal, len))
+            return false;
+        s += len;
+        return true;
+    }
+
+    void skipWhitespace(const char *&s) NOTHROWS
+    {
+        while (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r')
+            s++;
+    }
+}
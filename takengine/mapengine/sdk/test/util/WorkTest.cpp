@@ -0,0 +1,387 @@
+// Tests for budgeted, prioritized work on util/Work ControlWorker and its
+// GLWorkers GL thread client.
+//
+// Submits synthetic work that spins for a known time and checks that each
+// budgeted call stays within its budget, that work is done highest priority
+// first and FIFO within a priority, including across calls that defer work,
+// and that the deferred counts, costs and latencies reported by the worker
+// match what the test observed.
+//
+// Exits with a non-zero status on failure.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "renderer/GLWorkers.h"
+#include "util/Work.h"
+
+using namespace TAK::Engine::Renderer;
+using namespace TAK::Engine::Thread;
+using namespace TAK::Engine::Util;
+
+#define CHECK(cond) \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    }
+
+namespace
+{
+    int failures = 0;
+
+    // allowance for timer resolution and scheduling noise when comparing
+    // against a budget or against latencies observed by the test
+    const int64_t SLACK_MICROS = 1000LL;
+
+    int64_t nowMicros() NOTHROWS;
+
+    class SyntheticWork : public Work
+    {
+    public:
+        SyntheticWork(std::vector<int> &log, const int id, const int64_t costMicros) NOTHROWS;
+    protected:
+        TAKErr onSignalWork(MonitorLockPtr &lockPtr) NOTHROWS override;
+    public:
+        const int id;
+        const int64_t costMicros;
+        int64_t scheduledMicros;
+        int64_t signaledMicros;
+        int64_t finishedMicros;
+    private:
+        std::vector<int> &log;
+    };
+
+    typedef std::vector<std::shared_ptr<SyntheticWork>> WorkList;
+
+    void schedule(WorkList &list, std::vector<int> &log, ControlWorker &worker, const int id, const int priority, const int64_t costMicros) NOTHROWS;
+
+    void testBudgetIsRespected() NOTHROWS;
+    void testExpensiveWorkIsNotStarved() NOTHROWS;
+    void testPriorityThenFifoOrder() NOTHROWS;
+    void testFifoAcrossDeferral() NOTHROWS;
+    void testDeferredStats() NOTHROWS;
+    void testGLThreadWork() NOTHROWS;
+}
+
+int main(int argc, char **argv)
+{
+    testBudgetIsRespected();
+    testExpensiveWorkIsNotStarved();
+    testPriorityThenFifoOrder();
+    testFifoAcrossDeferral();
+    testDeferredStats();
+    testGLThreadWork();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+namespace
+{
+    void testBudgetIsRespected() NOTHROWS
+    {
+        std::shared_ptr<ControlWorker> worker;
+        CHECK(Worker_createControlWorker(worker) == TE_Ok);
+        if (!worker)
+            return;
+
+        // 30 units of 700us against a 2ms budget. Work whose estimate no
+        // longer fits what is left of the budget is deferred, so at most 2
+        // units are done per call, not 3 overrunning the budget by 100us.
+        const int64_t cost = 700LL;
+        const int64_t budget = 2000LL;
+        WorkList list;
+        std::vector<int> log;
+        for (int i = 0; i < 30; i++)
+            schedule(list, log, *worker, i, 0, cost);
+
+        std::size_t calls = 0u;
+        std::size_t done = 0u;
+        int64_t maxElapsed = 0LL;
+        TAKErr code = TE_TimedOut;
+        while (code == TE_TimedOut && calls < 100u) {
+            const int64_t start = nowMicros();
+            code = worker->doBudgetedWork(budget);
+            const int64_t elapsed = nowMicros() - start;
+            calls++;
+            if (elapsed > maxElapsed)
+                maxElapsed = elapsed;
+
+            const std::size_t doneInCall = log.size() - done;
+            CHECK(doneInCall >= 1u);
+            CHECK(doneInCall <= static_cast<std::size_t>(budget / cost));
+
+            // the work itself running longer than its cost, i.e. when the
+            // thread is preempted, is not the worker exceeding the budget
+            int64_t overrun = 0LL;
+            for (std::size_t i = done; i < log.size(); i++) {
+                const SyntheticWork &work = *list[log[i]];
+                overrun += std::max<int64_t>(work.finishedMicros - work.signaledMicros - work.costMicros, 0LL);
+            }
+            CHECK(elapsed - overrun <= budget + SLACK_MICROS);
+            done = log.size();
+        }
+        CHECK(code == TE_Done);
+        CHECK(log.size() == 30u);
+        CHECK(calls >= 15u);
+
+        ControlWorkerStats stats;
+        CHECK(worker->getStats(stats) == TE_Ok);
+        CHECK(stats.budgetedCalls == calls);
+        CHECK(stats.deferringCalls == calls - 1u);
+        CHECK(stats.workDone == 30u);
+        CHECK(stats.maxCallMicros <= maxElapsed);
+    }
+
+    void testExpensiveWorkIsNotStarved() NOTHROWS
+    {
+        std::shared_ptr<ControlWorker> worker;
+        CHECK(Worker_createControlWorker(worker) == TE_Ok);
+        if (!worker)
+            return;
+
+        // estimates larger than the whole budget are still done, one per call
+        WorkList list;
+        std::vector<int> log;
+        schedule(list, log, *worker, 0, 0, 5000LL);
+        schedule(list, log, *worker, 1, 0, 5000LL);
+
+        CHECK(worker->doBudgetedWork(1000LL) == TE_TimedOut);
+        CHECK(log.size() == 1u);
+        CHECK(worker->doBudgetedWork(1000LL) == TE_Done);
+        CHECK(log.size() == 2u);
+        CHECK(worker->doBudgetedWork(1000LL) == TE_Done);
+        CHECK(log.size() == 2u);
+    }
+
+    void testPriorityThenFifoOrder() NOTHROWS
+    {
+        std::shared_ptr<ControlWorker> worker;
+        CHECK(Worker_createControlWorker(worker) == TE_Ok);
+        if (!worker)
+            return;
+
+        // ids encode priority * 100 + sequence; plain scheduleWork is priority 0
+        WorkList list;
+        std::vector<int> log;
+        const int priorities[] = { 0, 2, -1, 1, 2, 0, -1, 1, 0, 2 };
+        int sequence[4] = { 0, 0, 0, 0 };
+        for (std::size_t i = 0u; i < sizeof(priorities) / sizeof(priorities[0]); i++) {
+            const int p = priorities[i];
+            const int id = p * 100 + sequence[p + 1]++;
+            if (p == 0) {
+                std::shared_ptr<SyntheticWork> work(new SyntheticWork(log, id, 0LL));
+                work->scheduledMicros = nowMicros();
+                CHECK(worker->scheduleWork(work) == TE_Ok);
+                list.push_back(work);
+            } else {
+                schedule(list, log, *worker, id, p, 0LL);
+            }
+        }
+
+        CHECK(worker->doBudgetedWork(INT64_MAX) == TE_Done);
+
+        const int expected[] = { 200, 201, 202, 100, 101, 0, 1, 2, -100, -99 };
+        CHECK(log.size() == sizeof(expected) / sizeof(expected[0]));
+        for (std::size_t i = 0u; i < log.size() && i < sizeof(expected) / sizeof(expected[0]); i++)
+            CHECK(log[i] == expected[i]);
+    }
+
+    void testFifoAcrossDeferral() NOTHROWS
+    {
+        std::shared_ptr<ControlWorker> worker;
+        CHECK(Worker_createControlWorker(worker) == TE_Ok);
+        if (!worker)
+            return;
+
+        WorkList list;
+        std::vector<int> log;
+        for (int i = 0; i < 6; i++)
+            schedule(list, log, *worker, i, 0, 400LL);
+
+        // part of the queue is done, then more work arrives at the same and at
+        // a higher priority; the higher priority work overtakes the deferred
+        // work, which keeps its order ahead of the newly scheduled work
+        CHECK(worker->doBudgetedWork(1000LL) == TE_TimedOut);
+        const std::size_t first = log.size();
+        CHECK(first >= 1u && first < 6u);
+        schedule(list, log, *worker, 6, 0, 400LL);
+        schedule(list, log, *worker, 100, 1, 400LL);
+        schedule(list, log, *worker, 7, 0, 400LL);
+
+        TAKErr code = TE_TimedOut;
+        for (std::size_t calls = 0u; code == TE_TimedOut && calls < 100u; calls++)
+            code = worker->doBudgetedWork(1000LL);
+        CHECK(code == TE_Done);
+
+        CHECK(log.size() == 9u);
+        if (log.size() == 9u) {
+            CHECK(log[first] == 100);
+            int expect = 0;
+            for (std::size_t i = 0u; i < log.size(); i++) {
+                if (log[i] == 100)
+                    continue;
+                CHECK(log[i] == expect);
+                expect++;
+            }
+        }
+    }
+
+    void testDeferredStats() NOTHROWS
+    {
+        std::shared_ptr<ControlWorker> worker;
+        CHECK(Worker_createControlWorker(worker) == TE_Ok);
+        if (!worker)
+            return;
+
+        // nothing is scheduled between calls, so the backlog after each call
+        // and the work counted as previously deferred are known exactly
+        const int64_t cost = 300LL;
+        const int64_t budget = 1000LL;
+        WorkList list;
+        std::vector<int> log;
+        for (int i = 0; i < 20; i++)
+            schedule(list, log, *worker, i, 0, cost);
+
+        std::size_t calls = 0u;
+        std::size_t deferringCalls = 0u;
+        std::size_t expectedDeferred = 0u;
+        std::size_t doneInFirstCall = 0u;
+        TAKErr code = TE_TimedOut;
+        while (code == TE_TimedOut && calls < 100u) {
+            code = worker->doBudgetedWork(budget);
+            calls++;
+            if (calls == 1u)
+                doneInFirstCall = log.size();
+            const std::size_t backlog = list.size() - log.size();
+            if (backlog)
+                deferringCalls++;
+            expectedDeferred += backlog;
+        }
+        CHECK(code == TE_Done);
+        CHECK(log.size() == 20u);
+
+        // latency as the test saw it, from scheduling until the work started
+        int64_t observedLatency = 0LL;
+        int64_t observedMax = 0LL;
+        for (std::size_t i = 0u; i < list.size(); i++) {
+            if (std::find(log.begin(), log.begin() + doneInFirstCall, list[i]->id) != log.begin() + doneInFirstCall)
+                continue;
+            const int64_t latency = list[i]->signaledMicros - list[i]->scheduledMicros;
+            observedLatency += latency;
+            if (latency > observedMax)
+                observedMax = latency;
+        }
+        const std::size_t deferredDone = list.size() - doneInFirstCall;
+
+        ControlWorkerStats stats;
+        CHECK(worker->getStats(stats) == TE_Ok);
+        CHECK(stats.budgetedCalls == calls);
+        CHECK(stats.deferringCalls == deferringCalls);
+        CHECK(stats.workDone == list.size());
+        CHECK(stats.workDeferred == expectedDeferred);
+        CHECK(stats.deferredCostMicros == static_cast<int64_t>(expectedDeferred) * cost);
+        CHECK(stats.deferredWorkDone == deferredDone);
+
+        // the worker measures from just after scheduling until just before
+        // signaling, so it may only report less than the test observed
+        CHECK(stats.deferredLatencyMicros <= observedLatency);
+        CHECK(stats.deferredLatencyMicros >= observedLatency - static_cast<int64_t>(deferredDone) * SLACK_MICROS);
+        CHECK(stats.maxDeferredLatencyMicros <= observedMax);
+        CHECK(stats.maxDeferredLatencyMicros >= observedMax - SLACK_MICROS);
+    }
+
+    void testGLThreadWork() NOTHROWS
+    {
+        // the GL thread worker is global; start from whatever it has recorded
+        ControlWorkerStats before;
+        CHECK(GLWorkers_getGLThreadStats(before) == TE_Ok);
+
+        SharedWorkerPtr high = GLWorkers_glThread(1, 600LL);
+        SharedWorkerPtr low = GLWorkers_glThread(-1, 600LL);
+        SharedWorkerPtr plain = GLWorkers_glThread();
+
+        WorkList list;
+        std::vector<int> log;
+        const struct { Worker *worker; int id; int64_t cost; } items[] =
+        {
+            { low.get(), -100, 600LL }, { plain.get(), 0, 0LL }, { high.get(), 100, 600LL },
+            { low.get(), -99, 600LL }, { plain.get(), 1, 0LL }, { high.get(), 101, 600LL },
+        };
+        for (std::size_t i = 0u; i < sizeof(items) / sizeof(items[0]); i++) {
+            std::shared_ptr<SyntheticWork> work(new SyntheticWork(log, items[i].id, items[i].cost));
+            work->scheduledMicros = nowMicros();
+            CHECK(items[i].worker->scheduleWork(work) == TE_Ok);
+            list.push_back(work);
+        }
+
+        // plain work has an unknown (0) cost and so always fits; only the
+        // prioritized work can be deferred on its estimate
+        std::size_t calls = 0u;
+        TAKErr code = TE_TimedOut;
+        while (code == TE_TimedOut && calls < 100u) {
+            code = GLWorkers_doGLThreadWork(1500LL);
+            calls++;
+        }
+        CHECK(code == TE_Ok);
+        CHECK(calls >= 2u);
+
+        const int expected[] = { 100, 101, 0, 1, -100, -99 };
+        CHECK(log.size() == sizeof(expected) / sizeof(expected[0]));
+        for (std::size_t i = 0u; i < log.size() && i < sizeof(expected) / sizeof(expected[0]); i++)
+            CHECK(log[i] == expected[i]);
+
+        ControlWorkerStats after;
+        CHECK(GLWorkers_getGLThreadStats(after) == TE_Ok);
+        CHECK(after.budgetedCalls - before.budgetedCalls == calls);
+        CHECK(after.deferringCalls - before.deferringCalls == calls - 1u);
+        CHECK(after.workDone - before.workDone == list.size());
+
+        // the unbudgeted drain is unchanged
+        std::shared_ptr<SyntheticWork> work(new SyntheticWork(log, 2, 0LL));
+        CHECK(plain->scheduleWork(work) == TE_Ok);
+        CHECK(GLWorkers_doGLThreadWork() == TE_Ok);
+        CHECK(log.size() == 7u && log.back() == 2);
+    }
+
+    void schedule(WorkList &list, std::vector<int> &log, ControlWorker &worker, const int id, const int priority, const int64_t costMicros) NOTHROWS
+    {
+        std::shared_ptr<SyntheticWork> work(new SyntheticWork(log, id, costMicros));
+        work->scheduledMicros = nowMicros();
+        CHECK(worker.schedulePrioritizedWork(work, priority, costMicros) == TE_Ok);
+        list.push_back(work);
+    }
+
+    int64_t nowMicros() NOTHROWS
+    {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    SyntheticWork::SyntheticWork(std::vector<int> &log_, const int id_, const int64_t costMicros_) NOTHROWS :
+        id(id_),
+        costMicros(costMicros_),
+        scheduledMicros(0LL),
+        signaledMicros(0LL),
+        finishedMicros(0LL),
+        log(log_)
+    {}
+
+    TAKErr SyntheticWork::onSignalWork(MonitorLockPtr &lockPtr) NOTHROWS
+    {
+        signaledMicros = nowMicros();
+        log.push_back(id);
+        // spin rather than sleep, so the cost is spent on the calling thread
+        do {
+            finishedMicros = nowMicros();
+        } while (finishedMicros - signaledMicros < costMicros);
+        return TE_Ok;
+    }
+}